@@ -28,6 +28,7 @@
 #include <inttypes.h>
 #include <pthread.h>
 #include <pwd.h>
+#include <sched.h>
 #include <signal.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -60,6 +61,7 @@
  */
 const struct srplg_ds_s *sr_internal_ds_plugins[] = {
     &srpds_json,    /**< default */
+    &srpds_shm,
 };
 
 /**
@@ -206,6 +208,64 @@ sr_ly_ext_data_clb(const struct lysc_ext_instance *ext, void *user_data, void **
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Free module data returned by the import callback.
+ */
+static void
+sr_ly_module_imp_data_free_cb(void *module_data, void *UNUSED(user_data))
+{
+    free(module_data);
+}
+
+/**
+ * @brief Import module libyang callback.
+ *
+ * Modules and submodules with a known revision are read directly from their files in the YANG modules directory,
+ * which avoids scanning the whole directory for each one of them when loading many modules.
+ */
+static LY_ERR
+sr_ly_module_imp_cb(const char *mod_name, const char *mod_rev, const char *submod_name, const char *submod_rev,
+        void *UNUSED(user_data), LYS_INFORMAT *format, const char **module_data, ly_module_imp_data_free_clb *free_module_data)
+{
+    sr_error_info_t *err_info = NULL;
+    char *path = NULL;
+    LY_ERR r = LY_SUCCESS;
+
+    if (submod_name) {
+        mod_name = submod_name;
+        mod_rev = submod_rev;
+    }
+    if (!mod_rev) {
+        /* the latest revision is needed, let libyang search the directory */
+        return LY_ENOTFOUND;
+    }
+
+    /* get the exact file path */
+    if ((err_info = sr_path_yang_file(mod_name, mod_rev, &path))) {
+        sr_errinfo_free(&err_info);
+        return LY_EMEM;
+    }
+    if (access(path, R_OK)) {
+        /* not installed by sysrepo */
+        r = LY_ENOTFOUND;
+        goto cleanup;
+    }
+
+    /* read schema file contents */
+    if ((err_info = sr_file_read(path, (char **)module_data))) {
+        sr_errinfo_free(&err_info);
+        r = LY_ESYS;
+        goto cleanup;
+    }
+
+    *format = LYS_IN_YANG;
+    *free_module_data = sr_ly_module_imp_data_free_cb;
+
+cleanup:
+    free(path);
+    return r;
+}
+
 sr_error_info_t *
 sr_ly_ctx_init(sr_conn_ctx_t *conn, struct ly_ctx **ly_ctx)
 {
@@ -233,6 +293,9 @@ sr_ly_ctx_init(sr_conn_ctx_t *conn, struct ly_ctx **ly_ctx)
         goto cleanup;
     }
 
+    /* load the installed modules directly from their files */
+    ly_ctx_set_module_imp_clb(*ly_ctx, sr_ly_module_imp_cb, NULL);
+
     /* load just the internal datastores modules and the "sysrepo" module */
     if (lys_parse_mem(*ly_ctx, ietf_datastores_yang, LYS_IN_YANG, NULL)) {
         sr_errinfo_new_ly(&err_info, *ly_ctx, NULL);
@@ -1116,13 +1179,7 @@ sr_module_get_impl_inv_imports(const struct lys_module *ly_mod, struct ly_set *m
     return err_info;
 }
 
-/**
- * @brief Get global SHM prefix prepended to all SHM files.
- *
- * @param[out] prefix SHM prefix to use.
- * @return err_info, NULL on success.
- */
-static sr_error_info_t *
+sr_error_info_t *
 sr_shm_prefix(const char **prefix)
 {
     sr_error_info_t *err_info = NULL;
@@ -1247,6 +1304,63 @@ sr_path_sub_data_shm(const char *mod_name, const char *suffix1, int64_t suffix2,
     return err_info;
 }
 
+sr_error_info_t *
+sr_path_run_snapshot_shm(const char *mod_name, char **path)
+{
+    sr_error_info_t *err_info = NULL;
+    const char *prefix;
+
+    err_info = sr_shm_prefix(&prefix);
+    if (err_info) {
+        return err_info;
+    }
+
+    if (asprintf(path, "%s/%srun_%s", SR_SHM_DIR, prefix, mod_name) == -1) {
+        SR_ERRINFO_MEM(&err_info);
+        *path = NULL;
+    }
+
+    return err_info;
+}
+
+sr_error_info_t *
+sr_path_replay_ring_shm(const char *mod_name, char **path)
+{
+    sr_error_info_t *err_info = NULL;
+    const char *prefix;
+
+    err_info = sr_shm_prefix(&prefix);
+    if (err_info) {
+        return err_info;
+    }
+
+    if (asprintf(path, "%s/%sreplay_%s", SR_SHM_DIR, prefix, mod_name) == -1) {
+        SR_ERRINFO_MEM(&err_info);
+        *path = NULL;
+    }
+
+    return err_info;
+}
+
+sr_error_info_t *
+sr_path_oper_poll_shm(const char *mod_name, const char *xpath, char **path)
+{
+    sr_error_info_t *err_info = NULL;
+    const char *prefix;
+
+    err_info = sr_shm_prefix(&prefix);
+    if (err_info) {
+        return err_info;
+    }
+
+    if (asprintf(path, "%s/%spoll_%s.%08x", SR_SHM_DIR, prefix, mod_name, sr_str_hash(xpath, 0)) == -1) {
+        SR_ERRINFO_MEM(&err_info);
+        *path = NULL;
+    }
+
+    return err_info;
+}
+
 sr_error_info_t *
 sr_path_evpipe(uint32_t evpipe_num, char **path)
 {
@@ -1564,11 +1678,110 @@ sr_time_sub_ms(const struct timespec *ts1, const struct timespec *ts2)
     return (result.tv_sec * 1000) + (result.tv_nsec / 1000000);
 }
 
+uint32_t
+sr_time_sub_us(const struct timespec *ts1, const struct timespec *ts2)
+{
+    struct timespec result;
+
+    result = sr_time_sub(ts1, ts2);
+    if ((result.tv_sec == 0) && (result.tv_nsec == -1)) {
+        return 0;
+    } else if (result.tv_sec >= UINT32_MAX / 1000000) {
+        return UINT32_MAX;
+    }
+    return (result.tv_sec * 1000000) + (result.tv_nsec / 1000);
+}
+
+void
+sr_atomic_max_update(ATOMIC_T *max, uint32_t value)
+{
+    uint_fast32_t cur;
+    int result;
+
+    /* may be updated concurrently */
+    cur = ATOMIC_LOAD_RELAXED(*max);
+    while (value > cur) {
+        ATOMIC_COMPARE_EXCHANGE_RELAXED(*max, cur, value, result);
+        if (result) {
+            break;
+        }
+    }
+}
+
+void
+sr_latency_stats_add(sr_latency_stats_t *stats, uint32_t usec)
+{
+    uint32_t i, bound;
+
+    ATOMIC_INC_RELAXED(stats->count);
+    ATOMIC_ADD_RELAXED(stats->sum_usec, usec);
+    sr_atomic_max_update(&stats->max_usec, usec);
+
+    /* find the histogram bucket */
+    bound = 100;
+    for (i = 0; i < SR_LATENCY_BUCKET_COUNT - 1; ++i) {
+        if (usec < bound) {
+            break;
+        }
+        bound *= 10;
+    }
+    ATOMIC_INC_RELAXED(stats->buckets[i]);
+}
+
+/** SHM mapping options, parsed from ::SR_SHM_MAP_ENV */
+#define SR_SHM_MAP_HUGEPAGE 0x01    /**< use transparent huge pages */
+#define SR_SHM_MAP_PREFAULT 0x02    /**< populate the mapping */
+#define SR_SHM_MAP_LOCK 0x04        /**< lock the mapping in memory */
+#define SR_SHM_MAP_PARSED 0x80      /**< options were parsed */
+
+/**
+ * @brief Get the options of mapping large SHM segments, parsed only once.
+ *
+ * @return Bitmask of SHM mapping options.
+ */
+static uint32_t
+sr_shm_map_opts(void)
+{
+    static ATOMIC_T opts_cache = 0;
+    const char *env, *ptr;
+    uint32_t opts;
+    size_t len;
+
+    if ((opts = ATOMIC_LOAD_RELAXED(opts_cache))) {
+        return opts;
+    }
+
+    opts = SR_SHM_MAP_PARSED;
+    env = getenv(SR_SHM_MAP_ENV);
+    for (ptr = env; ptr && *ptr; ptr += len) {
+        if (*ptr == ',') {
+            len = 1;
+            continue;
+        }
+
+        len = strcspn(ptr, ",");
+        if ((len == 8) && !strncmp(ptr, "hugepage", len)) {
+            opts |= SR_SHM_MAP_HUGEPAGE;
+        } else if ((len == 8) && !strncmp(ptr, "prefault", len)) {
+            opts |= SR_SHM_MAP_PREFAULT;
+        } else if ((len == 4) && !strncmp(ptr, "lock", len)) {
+            opts |= SR_SHM_MAP_LOCK;
+        } else {
+            SR_LOG_WRN("Unknown %s option \"%.*s\".", SR_SHM_MAP_ENV, (int)len, ptr);
+        }
+    }
+
+    ATOMIC_STORE_RELAXED(opts_cache, opts);
+    return opts;
+}
+
 sr_error_info_t *
 sr_shm_remap(sr_shm_t *shm, size_t new_shm_size)
 {
     sr_error_info_t *err_info = NULL;
     size_t shm_file_size = 0;
+    uint32_t map_opts = 0;
+    int flags = MAP_SHARED;
 
     /* read the new shm size if not set */
     if (!new_shm_size && (err_info = sr_file_get_size(shm->fd, &shm_file_size))) {
@@ -1593,14 +1806,33 @@ sr_shm_remap(sr_shm_t *shm, size_t new_shm_size)
 
     shm->size = new_shm_size ? new_shm_size : shm_file_size;
 
+    if (shm->size >= SR_SHM_MAP_LARGE_SIZE) {
+        map_opts = sr_shm_map_opts();
+    }
+#ifdef MAP_POPULATE
+    if (map_opts & SR_SHM_MAP_PREFAULT) {
+        flags |= MAP_POPULATE;
+    }
+#endif
+
     /* map */
-    shm->addr = mmap(NULL, shm->size, PROT_READ | PROT_WRITE, MAP_SHARED, shm->fd, 0);
+    shm->addr = mmap(NULL, shm->size, PROT_READ | PROT_WRITE, flags, shm->fd, 0);
     if (shm->addr == MAP_FAILED) {
         shm->addr = NULL;
         sr_errinfo_new(&err_info, SR_ERR_NO_MEMORY, "Failed to map shared memory (%s).", strerror(errno));
         return err_info;
     }
 
+    /* the mapping is usable even if these fail */
+#ifdef MADV_HUGEPAGE
+    if ((map_opts & SR_SHM_MAP_HUGEPAGE) && madvise(shm->addr, shm->size, MADV_HUGEPAGE)) {
+        SR_LOG_DBG("Using huge pages for shared memory failed (%s).", strerror(errno));
+    }
+#endif
+    if ((map_opts & SR_SHM_MAP_LOCK) && mlock(shm->addr, shm->size)) {
+        SR_LOG_WRN("Locking shared memory failed (%s).", strerror(errno));
+    }
+
     return NULL;
 }
 
@@ -1618,126 +1850,149 @@ sr_shm_clear(sr_shm_t *shm)
     shm->size = 0;
 }
 
+/**
+ * @brief Get the size class of an ext SHM memory hole.
+ *
+ * Class i holds holes of size <SR_SHM_MEM_ALIGN * 2^i, SR_SHM_MEM_ALIGN * 2^(i + 1)), the last class all the larger ones.
+ *
+ * @param[in] size Hole size.
+ * @return Hole size class.
+ */
+static uint32_t
+sr_ext_hole_class(uint32_t size)
+{
+    uint32_t cls = 0;
+
+    size /= SR_SHM_MEM_ALIGN;
+    while ((size >>= 1) && (cls < SR_EXT_HOLE_CLASS_COUNT - 1)) {
+        ++cls;
+    }
+
+    return cls;
+}
+
 sr_ext_hole_t *
 sr_ext_hole_next(sr_ext_hole_t *last, sr_ext_shm_t *ext_shm)
 {
-    if (!last) {
-        if (!ext_shm->first_hole_off) {
-            return NULL;
+    uint32_t cls;
+
+    if (last && last->next_hole_off) {
+        /* next hole of the same class */
+        return (sr_ext_hole_t *)(((char *)ext_shm) + last->next_hole_off);
+    }
+
+    /* first hole of the next non-empty class */
+    for (cls = last ? sr_ext_hole_class(last->size) + 1 : 0; cls < SR_EXT_HOLE_CLASS_COUNT; ++cls) {
+        if (ext_shm->first_hole_off[cls]) {
+            return (sr_ext_hole_t *)(((char *)ext_shm) + ext_shm->first_hole_off[cls]);
         }
-        return (sr_ext_hole_t *)(((char *)ext_shm) + ext_shm->first_hole_off);
-    } else if (!last->next_hole_off) {
-        return NULL;
     }
 
-    return (sr_ext_hole_t *)(((char *)ext_shm) + last->next_hole_off);
+    return NULL;
 }
 
 sr_ext_hole_t *
 sr_ext_hole_find(sr_ext_shm_t *ext_shm, uint32_t off, uint32_t min_size)
 {
     sr_ext_hole_t *hole;
-
-    for (hole = sr_ext_hole_next(NULL, ext_shm); hole; hole = sr_ext_hole_next(hole, ext_shm)) {
-        if (off) {
-            if (((char *)hole - (char *)ext_shm == off) && (hole->size >= min_size)) {
-                return hole;
-            }
-            if ((char *)hole - (char *)ext_shm > off) {
-                /* foo large offset, it cannot be found anymore */
-                break;
+    uint32_t cls, min_cls, hole_off;
+
+    min_cls = sr_ext_hole_class(min_size);
+
+    if (off) {
+        /* the hole cannot be in a class of smaller holes */
+        for (cls = min_cls; cls < SR_EXT_HOLE_CLASS_COUNT; ++cls) {
+            for (hole_off = ext_shm->first_hole_off[cls]; hole_off; hole_off = hole->next_hole_off) {
+                hole = (sr_ext_hole_t *)(((char *)ext_shm) + hole_off);
+                if (hole_off == off) {
+                    /* there can be only a single hole on an offset */
+                    return (hole->size >= min_size) ? hole : NULL;
+                }
+                if (hole_off > off) {
+                    /* too large offset, it cannot be found in this class anymore */
+                    break;
+                }
             }
-        } else if (hole->size >= min_size) {
+        }
+        return NULL;
+    }
+
+    /* first fit in the class of the size, holes may be smaller than required */
+    for (hole_off = ext_shm->first_hole_off[min_cls]; hole_off; hole_off = hole->next_hole_off) {
+        hole = (sr_ext_hole_t *)(((char *)ext_shm) + hole_off);
+        if (hole->size >= min_size) {
             return hole;
         }
     }
 
+    /* any hole of a larger class is large enough */
+    for (cls = min_cls + 1; cls < SR_EXT_HOLE_CLASS_COUNT; ++cls) {
+        if (ext_shm->first_hole_off[cls]) {
+            return (sr_ext_hole_t *)(((char *)ext_shm) + ext_shm->first_hole_off[cls]);
+        }
+    }
+
     return NULL;
 }
 
 void
 sr_ext_hole_del(sr_ext_shm_t *ext_shm, sr_ext_hole_t *hole)
 {
-    sr_ext_hole_t *h, *prev = NULL;
+    uint32_t *next_off, off;
 
-    for (h = sr_ext_hole_next(NULL, ext_shm); h; h = sr_ext_hole_next(h, ext_shm)) {
-        if (h == hole) {
-            /* found the hole */
-            break;
-        }
+    off = (char *)hole - (char *)ext_shm;
 
-        prev = h;
-    }
-    assert(h);
+    /* find the hole in its class */
+    for (next_off = &ext_shm->first_hole_off[sr_ext_hole_class(hole->size)]; *next_off && (*next_off != off);
+            next_off = &((sr_ext_hole_t *)(((char *)ext_shm) + *next_off))->next_hole_off) {}
+    assert(*next_off);
 
-    /* fíx offsets */
-    if (prev) {
-        prev->next_hole_off = hole->next_hole_off;
-    } else {
-        ext_shm->first_hole_off = hole->next_hole_off;
-    }
+    /* fix offsets */
+    *next_off = hole->next_hole_off;
 }
 
 void
 sr_ext_hole_add(sr_ext_shm_t *ext_shm, uint32_t off, uint32_t size)
 {
-    sr_ext_hole_t *next, *prev = NULL, *hole;
-    int con_prev = 0, con_next = 0;
+    sr_ext_hole_t *iter, *prev = NULL, *next = NULL, *hole;
+    uint32_t *next_off, iter_off;
 
     if (!size) {
         /* nothing to do */
         return;
     }
 
-    for (next = sr_ext_hole_next(NULL, ext_shm); next; next = sr_ext_hole_next(next, ext_shm)) {
-        if ((char *)next - (char *)ext_shm > off) {
-            /* found the next hole */
-            break;
+    /* find the holes adjacent to the new one, there can be at most one on each side */
+    for (iter = sr_ext_hole_next(NULL, ext_shm); iter && (!prev || !next); iter = sr_ext_hole_next(iter, ext_shm)) {
+        iter_off = (char *)iter - (char *)ext_shm;
+        if (iter_off + iter->size == off) {
+            prev = iter;
+        } else if (iter_off == off + size) {
+            next = iter;
         }
-
-        prev = next;
     }
 
-    if (prev && (((char *)prev - (char *)ext_shm) + prev->size == off)) {
-        /* connecting with prev */
-        con_prev = 1;
+    if (prev) {
+        /* prev + hole */
+        sr_ext_hole_del(ext_shm, prev);
+        off = (char *)prev - (char *)ext_shm;
+        size += prev->size;
     }
-    if (next && (off + size == (char *)next - (char *)ext_shm)) {
-        /* connecting with next */
-        con_next = 1;
+    if (next) {
+        /* hole + next */
+        sr_ext_hole_del(ext_shm, next);
+        size += next->size;
     }
 
+    /* find the place in its class, holes are ordered by their offset */
+    for (next_off = &ext_shm->first_hole_off[sr_ext_hole_class(size)]; *next_off && (*next_off < off);
+            next_off = &((sr_ext_hole_t *)(((char *)ext_shm) + *next_off))->next_hole_off) {}
+
+    /* (prev) -> hole -> (next) */
     hole = (sr_ext_hole_t *)((char *)ext_shm + off);
-    if (con_prev && con_next) {
-        /* prev + hole + next */
-        prev->size += size + next->size;
-        prev->next_hole_off = next->next_hole_off;
-    } else if (con_prev) {
-        /* prev + hole -> (next) */
-        prev->size += size;
-    } else if (con_next) {
-        /* (prev) -> hole + next */
-        if (prev) {
-            prev->next_hole_off = off;
-        } else {
-            ext_shm->first_hole_off = off;
-        }
-        hole->size = size + next->size;
-        hole->next_hole_off = next->next_hole_off;
-    } else {
-        /* (prev) -> hole -> (next) */
-        if (prev) {
-            prev->next_hole_off = off;
-        } else {
-            ext_shm->first_hole_off = off;
-        }
-        hole->size = size;
-        if (next) {
-            hole->next_hole_off = (char *)next - (char *)ext_shm;
-        } else {
-            hole->next_hole_off = 0;
-        }
-    }
+    hole->size = size;
+    hole->next_hole_off = *next_off;
+    *next_off = off;
 }
 
 off_t
@@ -2290,85 +2545,422 @@ sr_munlock(pthread_mutex_t *lock)
 }
 
 sr_error_info_t *
-sr_rwlock_init(sr_rwlock_t *rwlock, int shared)
+sr_thread_attr_dup(const sr_thread_attr_t *attr, sr_thread_attr_t **dup)
 {
     sr_error_info_t *err_info = NULL;
+    int *cpus;
 
-    if ((err_info = sr_mutex_init(&rwlock->mutex, shared))) {
-        return err_info;
+    *dup = calloc(1, sizeof **dup);
+    SR_CHECK_MEM_RET(!*dup, err_info);
+
+    (*dup)->sched_policy = attr->sched_policy;
+    (*dup)->sched_priority = attr->sched_priority;
+    (*dup)->stack_size = attr->stack_size;
+
+    if (attr->cpu_count) {
+        cpus = malloc(attr->cpu_count * sizeof *cpus);
+        SR_CHECK_MEM_GOTO(!cpus, err_info, cleanup);
+        memcpy(cpus, attr->cpus, attr->cpu_count * sizeof *cpus);
+        (*dup)->cpus = cpus;
+        (*dup)->cpu_count = attr->cpu_count;
     }
-    if ((err_info = sr_cond_init(&rwlock->cond, shared, shared))) {
-        pthread_mutex_destroy(&rwlock->mutex);
-        return err_info;
+    if (attr->name) {
+        (*dup)->name = strdup(attr->name);
+        SR_CHECK_MEM_GOTO(!(*dup)->name, err_info, cleanup);
     }
 
-    if ((err_info = _sr_mutex_init(&rwlock->r_mutex, shared, 0))) {
-        pthread_mutex_destroy(&rwlock->mutex);
-        sr_cond_destroy(&rwlock->cond);
-        return err_info;
+cleanup:
+    if (err_info) {
+        sr_thread_attr_free(*dup);
+        *dup = NULL;
     }
-    memset(rwlock->readers, 0, sizeof rwlock->readers);
-    rwlock->upgr = 0;
-    rwlock->writer = 0;
-
-    return NULL;
+    return err_info;
 }
 
 void
-sr_rwlock_destroy(sr_rwlock_t *rwlock)
+sr_thread_attr_free(sr_thread_attr_t *attr)
 {
-    pthread_mutex_destroy(&rwlock->mutex);
-    sr_cond_destroy(&rwlock->cond);
-    pthread_mutex_destroy(&rwlock->r_mutex);
+    if (!attr) {
+        return;
+    }
+
+    free((int *)attr->cpus);
+    free((char *)attr->name);
+    free(attr);
 }
 
 /**
- * @brief Add a reader CID to a rwlock.
+ * @brief Prepare the CPU set of thread attributes.
  *
- * @param[in] rwlock Lock to add a reader to.
- * @param[in] cid Owner CID.
+ * @param[in] attr Thread attributes with some CPUs.
+ * @param[out] cpuset CPU set to fill.
+ * @return err_info, NULL on success.
  */
-static void
-sr_rwlock_reader_add(sr_rwlock_t *rwlock, sr_cid_t cid)
+static sr_error_info_t *
+sr_thread_attr_cpuset(const sr_thread_attr_t *attr, cpu_set_t *cpuset)
 {
     sr_error_info_t *err_info = NULL;
-    int ret;
     uint32_t i;
 
-    /* READ MUTEX LOCK */
-    ret = pthread_mutex_lock(&rwlock->r_mutex);
-    if (ret) {
-        SR_ERRINFO_INT(&err_info);
-        sr_errinfo_free(&err_info);
-    }
-
-    /* find this connection or first free item */
-    for (i = 0; (i < SR_RWLOCK_READ_LIMIT) && rwlock->readers[i] && (rwlock->readers[i] != cid); ++i) {}
-    if (i == SR_RWLOCK_READ_LIMIT) {
-        sr_errinfo_new(&err_info, SR_ERR_INTERNAL, "Concurrent reader limit %d reached!", SR_RWLOCK_READ_LIMIT);
-        sr_errinfo_free(&err_info);
-        goto unlock;
-    }
-
-    if (!rwlock->readers[i]) {
-        /* first connection reader, assign owner cid */
-        rwlock->readers[i] = cid;
-        rwlock->read_count[i] = 1;
-    } else {
-        /* recursive read lock on the connection */
-        if (rwlock->read_count[i] == UINT8_MAX) {
-            sr_errinfo_new(&err_info, SR_ERR_INTERNAL, "Recursive reader limit %" PRIu8 " reached!", UINT8_MAX);
-            sr_errinfo_free(&err_info);
-            goto unlock;
+#ifdef SR_HAVE_PTHREAD_SETAFFINITY_NP
+    CPU_ZERO(cpuset);
+    for (i = 0; i < attr->cpu_count; ++i) {
+        if ((attr->cpus[i] < 0) || (attr->cpus[i] >= CPU_SETSIZE)) {
+            sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Invalid thread CPU %d.", attr->cpus[i]);
+            return err_info;
         }
-        ++rwlock->read_count[i];
+        CPU_SET(attr->cpus[i], cpuset);
     }
+#else
+    (void)attr;
+    (void)cpuset;
+    (void)i;
+    sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED, "Thread CPU affinity is not supported.");
+#endif
 
-unlock:
-    if (!ret) {
-        /* READ MUTEX UNLOCK */
-        pthread_mutex_unlock(&rwlock->r_mutex);
-    }
+    return err_info;
+}
+
+/**
+ * @brief Set the name of a thread.
+ *
+ * @param[in] tid Thread ID.
+ * @param[in] name Thread name, truncated if too long.
+ */
+static void
+sr_thread_name_set(pthread_t tid, const char *name)
+{
+#ifdef SR_HAVE_PTHREAD_SETNAME_NP
+    char buf[16];
+    size_t len;
+    int r;
+
+    /* the name can have at most 15 characters */
+    len = strlen(name);
+    if (len > sizeof buf - 1) {
+        len = sizeof buf - 1;
+    }
+    memcpy(buf, name, len);
+    buf[len] = '\0';
+
+    if ((r = pthread_setname_np(tid, buf))) {
+        SR_LOG_WRN("Setting thread name \"%s\" failed (%s).", buf, strerror(r));
+    }
+#else
+    (void)tid;
+    (void)name;
+#endif
+}
+
+sr_error_info_t *
+sr_thread_create(pthread_t *tid, const sr_thread_attr_t *attr, void *(*start_routine)(void *), void *arg)
+{
+    sr_error_info_t *err_info = NULL;
+    pthread_attr_t pattr;
+    struct sched_param sparam;
+    cpu_set_t cpuset;
+    int r;
+
+    if (!attr) {
+        if ((r = pthread_create(tid, NULL, start_routine, arg))) {
+            sr_errinfo_new(&err_info, SR_ERR_INTERNAL, "Creating a new thread failed (%s).", strerror(r));
+        }
+        return err_info;
+    }
+
+    /* check the CPUs before creating the thread */
+    if (attr->cpu_count && (err_info = sr_thread_attr_cpuset(attr, &cpuset))) {
+        return err_info;
+    }
+
+    if ((r = pthread_attr_init(&pattr))) {
+        sr_errinfo_new(&err_info, SR_ERR_INTERNAL, "Initializing thread attributes failed (%s).", strerror(r));
+        return err_info;
+    }
+
+    if (attr->stack_size && (r = pthread_attr_setstacksize(&pattr, attr->stack_size))) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Setting thread stack size %zu failed (%s).", attr->stack_size,
+                strerror(r));
+        goto cleanup;
+    }
+
+    if (attr->sched_policy > -1) {
+        sparam.sched_priority = attr->sched_priority;
+        if ((r = pthread_attr_setinheritsched(&pattr, PTHREAD_EXPLICIT_SCHED)) ||
+                (r = pthread_attr_setschedpolicy(&pattr, attr->sched_policy)) ||
+                (r = pthread_attr_setschedparam(&pattr, &sparam))) {
+            sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Setting thread scheduling policy %d with priority %d failed (%s).",
+                    attr->sched_policy, attr->sched_priority, strerror(r));
+            goto cleanup;
+        }
+    }
+
+    if ((r = pthread_create(tid, &pattr, start_routine, arg))) {
+        sr_errinfo_new(&err_info, SR_ERR_INTERNAL, "Creating a new thread failed (%s).", strerror(r));
+        goto cleanup;
+    }
+
+    /* the thread is running, failures are not fatal anymore */
+#ifdef SR_HAVE_PTHREAD_SETAFFINITY_NP
+    if (attr->cpu_count && (r = pthread_setaffinity_np(*tid, sizeof cpuset, &cpuset))) {
+        SR_LOG_WRN("Setting thread CPU affinity failed (%s).", strerror(r));
+    }
+#endif
+    if (attr->name) {
+        sr_thread_name_set(*tid, attr->name);
+    }
+
+cleanup:
+    pthread_attr_destroy(&pattr);
+    return err_info;
+}
+
+sr_error_info_t *
+sr_conn_thread_create(sr_conn_ctx_t *conn, sr_thread_type_t type, pthread_t *tid, void *(*start_routine)(void *),
+        void *arg)
+{
+    sr_error_info_t *err_info = NULL;
+
+    /* THREAD ATTR LOCK */
+    pthread_mutex_lock(&conn->thread_attr_lock);
+
+    err_info = sr_thread_create(tid, conn->thread_attr[type], start_routine, arg);
+
+    /* THREAD ATTR UNLOCK */
+    pthread_mutex_unlock(&conn->thread_attr_lock);
+
+    return err_info;
+}
+
+sr_error_info_t *
+sr_thread_attr_apply(pthread_t tid, const sr_thread_attr_t *attr)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sched_param sparam;
+    cpu_set_t cpuset;
+    int r;
+
+    if (attr->cpu_count) {
+        if ((err_info = sr_thread_attr_cpuset(attr, &cpuset))) {
+            return err_info;
+        }
+#ifdef SR_HAVE_PTHREAD_SETAFFINITY_NP
+        if ((r = pthread_setaffinity_np(tid, sizeof cpuset, &cpuset))) {
+            sr_errinfo_new(&err_info, SR_ERR_SYS, "Setting thread CPU affinity failed (%s).", strerror(r));
+            return err_info;
+        }
+#endif
+    }
+
+    if (attr->sched_policy > -1) {
+        sparam.sched_priority = attr->sched_priority;
+        if ((r = pthread_setschedparam(tid, attr->sched_policy, &sparam))) {
+            sr_errinfo_new(&err_info, SR_ERR_SYS, "Setting thread scheduling policy %d with priority %d failed (%s).",
+                    attr->sched_policy, attr->sched_priority, strerror(r));
+            return err_info;
+        }
+    }
+
+    if (attr->name) {
+        sr_thread_name_set(tid, attr->name);
+    }
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_rwlock_init(sr_rwlock_t *rwlock, int shared)
+{
+    sr_error_info_t *err_info = NULL;
+
+    if ((err_info = sr_mutex_init(&rwlock->mutex, shared))) {
+        return err_info;
+    }
+    if ((err_info = sr_cond_init(&rwlock->cond, shared, shared))) {
+        pthread_mutex_destroy(&rwlock->mutex);
+        return err_info;
+    }
+
+    if ((err_info = _sr_mutex_init(&rwlock->r_mutex, shared, 0))) {
+        pthread_mutex_destroy(&rwlock->mutex);
+        sr_cond_destroy(&rwlock->cond);
+        return err_info;
+    }
+    memset(rwlock->readers, 0, sizeof rwlock->readers);
+    rwlock->upgr = 0;
+    rwlock->writer = 0;
+    memset(rwlock->upgr_wait, 0, sizeof rwlock->upgr_wait);
+    memset(rwlock->upgr_wait_prio, 0, sizeof rwlock->upgr_wait_prio);
+    memset(&rwlock->read_ts, 0, sizeof rwlock->read_ts);
+    memset(&rwlock->write_ts, 0, sizeof rwlock->write_ts);
+    memset(rwlock->stats, 0, sizeof rwlock->stats);
+
+    return NULL;
+}
+
+/**
+ * @brief Learn whether this process collects lock statistics.
+ *
+ * @return Whether the statistics are collected.
+ */
+static int
+sr_rwlock_stats_enabled(void)
+{
+    static ATOMIC_T enabled = 0;
+    uint_fast32_t val;
+    const char *env;
+
+    /* 0 - not learned yet, 1 - disabled, 2 - enabled */
+    val = ATOMIC_LOAD_RELAXED(enabled);
+    if (!val) {
+        env = getenv(SR_LOCK_STATS_ENV);
+        val = (env && strcmp(env, "0")) ? 2 : 1;
+        ATOMIC_STORE_RELAXED(enabled, val);
+    }
+
+    return val == 2;
+}
+
+/**
+ * @brief Get current time for lock statistics.
+ *
+ * @param[out] ts Current time, zeroed if the statistics are not collected.
+ */
+static void
+sr_rwlock_stats_time(struct timespec *ts)
+{
+    if (sr_rwlock_stats_enabled()) {
+        sr_timeouttime_get(ts, 0);
+    } else {
+        memset(ts, 0, sizeof *ts);
+    }
+}
+
+/**
+ * @brief Update lock statistics after a lock was acquired.
+ *
+ * @param[in] rwlock Acquired lock.
+ * @param[in] mode Acquired lock mode.
+ * @param[in] start Time the lock started to be acquired, zeroed if not measured.
+ * @param[in] waited Whether the lock had to wait for the lock to be released.
+ */
+static void
+sr_rwlock_stats_lock(sr_rwlock_t *rwlock, sr_lock_mode_t mode, const struct timespec *start, int waited)
+{
+    sr_rwlock_stats_t *stats;
+    struct timespec now;
+    uint32_t usec;
+    int write = ((mode == SR_LOCK_WRITE) || (mode == SR_LOCK_WRITE_URGE));
+
+    if (SR_TS_IS_ZERO(*start)) {
+        return;
+    }
+    stats = &rwlock->stats[write];
+
+    sr_timeouttime_get(&now, 0);
+    usec = sr_time_sub_us(&now, start);
+
+    ATOMIC_INC_RELAXED(stats->lock_count);
+    if (waited) {
+        ATOMIC_INC_RELAXED(stats->wait_count);
+    }
+    ATOMIC_ADD_RELAXED(stats->wait_usec, usec);
+    sr_atomic_max_update(&stats->wait_max_usec, usec);
+
+    if (write) {
+        /* held by us */
+        rwlock->write_ts = now;
+    }
+}
+
+/**
+ * @brief Update lock statistics after a lock was released.
+ *
+ * @param[in] rwlock Released lock.
+ * @param[in] write Whether a WRITE lock or the last READ lock was released.
+ * @param[in,out] lock_ts Time the lock was acquired, zeroed if not measured, is zeroed.
+ */
+static void
+sr_rwlock_stats_unlock(sr_rwlock_t *rwlock, int write, struct timespec *lock_ts)
+{
+    sr_rwlock_stats_t *stats = &rwlock->stats[write];
+    struct timespec now;
+    uint32_t usec;
+
+    if (SR_TS_IS_ZERO(*lock_ts)) {
+        return;
+    }
+
+    sr_rwlock_stats_time(&now);
+    if (!SR_TS_IS_ZERO(now)) {
+        usec = sr_time_sub_us(&now, lock_ts);
+        ATOMIC_ADD_RELAXED(stats->hold_usec, usec);
+        sr_atomic_max_update(&stats->hold_max_usec, usec);
+    }
+
+    memset(lock_ts, 0, sizeof *lock_ts);
+}
+
+void
+sr_rwlock_destroy(sr_rwlock_t *rwlock)
+{
+    pthread_mutex_destroy(&rwlock->mutex);
+    sr_cond_destroy(&rwlock->cond);
+    pthread_mutex_destroy(&rwlock->r_mutex);
+}
+
+/**
+ * @brief Add a reader CID to a rwlock.
+ *
+ * @param[in] rwlock Lock to add a reader to.
+ * @param[in] cid Owner CID.
+ */
+static void
+sr_rwlock_reader_add(sr_rwlock_t *rwlock, sr_cid_t cid)
+{
+    sr_error_info_t *err_info = NULL;
+    int ret;
+    uint32_t i;
+
+    /* READ MUTEX LOCK */
+    ret = pthread_mutex_lock(&rwlock->r_mutex);
+    if (ret) {
+        SR_ERRINFO_INT(&err_info);
+        sr_errinfo_free(&err_info);
+    }
+
+    /* find this connection or first free item */
+    for (i = 0; (i < SR_RWLOCK_READ_LIMIT) && rwlock->readers[i] && (rwlock->readers[i] != cid); ++i) {}
+    if (i == SR_RWLOCK_READ_LIMIT) {
+        sr_errinfo_new(&err_info, SR_ERR_INTERNAL, "Concurrent reader limit %d reached!", SR_RWLOCK_READ_LIMIT);
+        sr_errinfo_free(&err_info);
+        goto unlock;
+    }
+
+    if (!rwlock->readers[i]) {
+        if (!i) {
+            /* first reader, lock statistics */
+            sr_rwlock_stats_time(&rwlock->read_ts);
+        }
+
+        /* first connection reader, assign owner cid */
+        rwlock->readers[i] = cid;
+        rwlock->read_count[i] = 1;
+    } else {
+        /* recursive read lock on the connection */
+        if (rwlock->read_count[i] == UINT8_MAX) {
+            sr_errinfo_new(&err_info, SR_ERR_INTERNAL, "Recursive reader limit %" PRIu8 " reached!", UINT8_MAX);
+            sr_errinfo_free(&err_info);
+            goto unlock;
+        }
+        ++rwlock->read_count[i];
+    }
+
+unlock:
+    if (!ret) {
+        /* READ MUTEX UNLOCK */
+        pthread_mutex_unlock(&rwlock->r_mutex);
+    }
 }
 
 /**
@@ -2380,6 +2972,8 @@ unlock:
 static void
 sr_rwlock_reader_del_(sr_rwlock_t *rwlock, uint32_t i)
 {
+    uint32_t last;
+
     /* decrease recursive read lock count */
     assert(rwlock->read_count[i]);
     --rwlock->read_count[i];
@@ -2389,16 +2983,19 @@ sr_rwlock_reader_del_(sr_rwlock_t *rwlock, uint32_t i)
         return;
     }
 
-    /* move all the following CIDs so that there are no holes */
-    while ((i < (SR_RWLOCK_READ_LIMIT - 1)) && rwlock->readers[i + 1]) {
-        rwlock->readers[i] = rwlock->readers[i + 1];
-        rwlock->read_count[i] = rwlock->read_count[i + 1];
-        ++i;
-    }
+    /* find the last CID */
+    for (last = i; (last < (SR_RWLOCK_READ_LIMIT - 1)) && rwlock->readers[last + 1]; ++last) {}
 
-    /* remove the last CID */
-    rwlock->readers[i] = 0;
-    rwlock->read_count[i] = 0;
+    /* move it to the removed one so that there are no holes */
+    rwlock->readers[i] = rwlock->readers[last];
+    rwlock->read_count[i] = rwlock->read_count[last];
+    rwlock->readers[last] = 0;
+    rwlock->read_count[last] = 0;
+
+    if (!rwlock->readers[0]) {
+        /* last reader, lock statistics */
+        sr_rwlock_stats_unlock(rwlock, 0, &rwlock->read_ts);
+    }
 }
 
 /**
@@ -2496,6 +3093,9 @@ sr_rwlock_recover(sr_rwlock_t *rwlock, const char *func, sr_lock_recover_cb cb,
         }
     }
 
+    /* read-upgr waiters, a dead one would delay all the waiters with a lower priority */
+    sr_rwlock_upgr_prio_wait(rwlock, 0, func);
+
     /* write */
     if (rwlock->writer) {
         if (!sr_conn_is_alive(rwlock->writer)) {
@@ -2511,15 +3111,95 @@ sr_rwlock_recover(sr_rwlock_t *rwlock, const char *func, sr_lock_recover_cb cb,
     }
 }
 
-sr_error_info_t *
-sr_sub_rwlock(sr_rwlock_t *rwlock, struct timespec *timeout_abs, sr_lock_mode_t mode, sr_cid_t cid, const char *func,
-        sr_lock_recover_cb cb, void *cb_data, int has_mutex)
+/**
+ * @brief Add a READ-UPGR lock waiter with a priority to a rwlock.
+ * Mutex must be held!
+ *
+ * @param[in] rwlock RW lock to add the waiter to.
+ * @param[in] prio Priority of the waiter.
+ * @param[in] cid Waiter CID.
+ * @return Index of the added waiter, ::SR_RWLOCK_READ_LIMIT if not added.
+ */
+static uint32_t
+sr_rwlock_upgr_wait_add(sr_rwlock_t *rwlock, uint32_t prio, sr_cid_t cid)
+{
+    uint32_t i;
+
+    if (!prio) {
+        /* waiters with the default priority never delay other waiters */
+        return SR_RWLOCK_READ_LIMIT;
+    }
+
+    /* find first free item, if there is none the waiter will not delay waiters with lower priorities */
+    for (i = 0; (i < SR_RWLOCK_READ_LIMIT) && rwlock->upgr_wait[i]; ++i) {}
+    if (i < SR_RWLOCK_READ_LIMIT) {
+        rwlock->upgr_wait[i] = cid;
+        rwlock->upgr_wait_prio[i] = prio;
+    }
+
+    return i;
+}
+
+/**
+ * @brief Learn whether there are any READ-UPGR lock waiters with a higher priority. Dead waiters are removed.
+ * Mutex must be held!
+ *
+ * @param[in] rwlock RW lock to examine.
+ * @param[in] prio Priority of the waiter.
+ * @param[in] func Lock caller function.
+ * @return Whether there are waiters with a priority higher than @p prio.
+ */
+static int
+sr_rwlock_upgr_prio_wait(sr_rwlock_t *rwlock, uint32_t prio, const char *func)
+{
+    uint32_t i;
+    int wait = 0;
+
+    for (i = 0; i < SR_RWLOCK_READ_LIMIT; ++i) {
+        if (!rwlock->upgr_wait[i] || (rwlock->upgr_wait_prio[i] <= prio)) {
+            continue;
+        }
+
+        if (!sr_conn_is_alive(rwlock->upgr_wait[i])) {
+            /* remove the dead waiter */
+            SR_LOG_WRN("Recovered a read-upgr-lock waiter of CID %" PRIu32 " (%s).", rwlock->upgr_wait[i], func);
+            rwlock->upgr_wait[i] = 0;
+            continue;
+        }
+
+        wait = 1;
+    }
+
+    return wait;
+}
+
+/**
+ * @brief Lock a sysrepo RW lock with a priority of READ-UPGR locks. On failure, the lock is not changed in any way.
+ *
+ * @param[in] rwlock RW lock to lock.
+ * @param[in] timeout_abs Absolute timeout for locking.
+ * @param[in] mode Lock mode to set.
+ * @param[in] prio Priority of a READ-UPGR lock.
+ * @param[in] cid Lock owner connection ID.
+ * @param[in] func Name of the calling function for logging.
+ * @param[in] cb Optional callback called when recovering locks. When calling it, WRITE lock is always held.
+ * @param[in] cb_data Arbitrary user data for @p cb.
+ * @param[in] has_mutex Set if the lock mutex is already held.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_rwlock_lock(sr_rwlock_t *rwlock, struct timespec *timeout_abs, sr_lock_mode_t mode, uint32_t prio, sr_cid_t cid,
+        const char *func, sr_lock_recover_cb cb, void *cb_data, int has_mutex)
 {
     sr_error_info_t *err_info = NULL;
-    int ret = 0, wr_urged;
+    struct timespec start;
+    int ret = 0, wr_urged, waited = 0;
+    uint32_t upgr_wait_idx;
 
     assert(mode && timeout_abs && cid);
 
+    sr_rwlock_stats_time(&start);
+
     if (!has_mutex) {
         /* MUTEX LOCK */
         ret = pthread_mutex_clocklock(&rwlock->mutex, COMPAT_CLOCK_ID, timeout_abs);
@@ -2548,6 +3228,7 @@ sr_sub_rwlock(sr_rwlock_t *rwlock, struct timespec *timeout_abs, sr_lock_mode_t
         ret = 0;
         while (!ret && (rwlock->readers[0] || rwlock->writer)) {
             /* COND WAIT */
+            waited = 1;
             ret = sr_cond_clockwait(&rwlock->cond, &rwlock->mutex, COMPAT_CLOCK_ID, timeout_abs);
         }
         if (ret == ETIMEDOUT) {
@@ -2586,6 +3267,7 @@ sr_sub_rwlock(sr_rwlock_t *rwlock, struct timespec *timeout_abs, sr_lock_mode_t
             }
 
             /* COND WAIT */
+            waited = 1;
             ret = sr_cond_clockwait(&rwlock->cond, &rwlock->mutex, COMPAT_CLOCK_ID, timeout_abs);
         }
         if (ret == ETIMEDOUT) {
@@ -2620,14 +3302,20 @@ sr_sub_rwlock(sr_rwlock_t *rwlock, struct timespec *timeout_abs, sr_lock_mode_t
             sr_rwlock_recover(rwlock, func, cb, cb_data);
         }
 
-        /* wait until there is no read-upgr lock */
+        /* wait until there is no read-upgr lock and no waiter with a higher priority */
+        upgr_wait_idx = sr_rwlock_upgr_wait_add(rwlock, prio, cid);
         ret = 0;
-        while (!ret && (rwlock->upgr || rwlock->writer)) {
+        while (!ret && (rwlock->upgr || rwlock->writer || sr_rwlock_upgr_prio_wait(rwlock, prio, func))) {
             /* COND WAIT */
+            waited = 1;
             ret = sr_cond_clockwait(&rwlock->cond, &rwlock->mutex, COMPAT_CLOCK_ID, timeout_abs);
         }
+        if (upgr_wait_idx < SR_RWLOCK_READ_LIMIT) {
+            rwlock->upgr_wait[upgr_wait_idx] = 0;
+        }
         if (ret == ETIMEDOUT) {
-            /* recover the lock again, the owner may have died while processing */
+            /* recover the lock again, the owner may have died while processing, waiters with a higher priority
+             * may have died as well so they are ignored now */
             sr_rwlock_recover(rwlock, func, cb, cb_data);
             if (!rwlock->upgr && !rwlock->writer) {
                 /* recovered */
@@ -2635,6 +3323,10 @@ sr_sub_rwlock(sr_rwlock_t *rwlock, struct timespec *timeout_abs, sr_lock_mode_t
             }
         }
         if (ret) {
+            if (prio) {
+                /* waiters with a lower priority may have been waiting for this one */
+                sr_cond_broadcast(&rwlock->cond);
+            }
             goto error_cond_unlock;
         }
 
@@ -2658,6 +3350,7 @@ sr_sub_rwlock(sr_rwlock_t *rwlock, struct timespec *timeout_abs, sr_lock_mode_t
         ret = 0;
         while (!ret && rwlock->writer) {
             /* COND WAIT */
+            waited = 1;
             ret = sr_cond_clockwait(&rwlock->cond, &rwlock->mutex, COMPAT_CLOCK_ID, timeout_abs);
         }
         if (ret == ETIMEDOUT) {
@@ -2679,6 +3372,7 @@ sr_sub_rwlock(sr_rwlock_t *rwlock, struct timespec *timeout_abs, sr_lock_mode_t
         pthread_mutex_unlock(&rwlock->mutex);
     }
 
+    sr_rwlock_stats_lock(rwlock, mode, &start, waited);
     return NULL;
 
 error_cond_unlock:
@@ -2692,14 +3386,35 @@ error_cond_unlock:
 }
 
 sr_error_info_t *
-sr_rwlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid, const char *func,
+sr_sub_rwlock(sr_rwlock_t *rwlock, struct timespec *timeout_abs, sr_lock_mode_t mode, sr_cid_t cid, const char *func,
+        sr_lock_recover_cb cb, void *cb_data, int has_mutex)
+{
+    return sr_rwlock_lock(rwlock, timeout_abs, mode, 0, cid, func, cb, cb_data, has_mutex);
+}
+
+sr_error_info_t *
+sr_rwlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid, const char *func,
         sr_lock_recover_cb cb, void *cb_data)
 {
+    return sr_rwlock_prio(rwlock, timeout_ms, mode, 0, cid, func, cb, cb_data);
+}
+
+sr_error_info_t *
+sr_rwlock_prio(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, uint32_t prio, sr_cid_t cid,
+        const char *func, sr_lock_recover_cb cb, void *cb_data)
+{
+    sr_error_info_t *err_info;
     struct timespec timeout_abs;
 
+    assert(prio <= SR_COMMIT_PRIO_MAX);
+
     sr_timeouttime_get(&timeout_abs, timeout_ms);
 
-    return sr_sub_rwlock(rwlock, &timeout_abs, mode, cid, func, cb, cb_data, 0);
+    SR_TRACE(rwlock_request, rwlock, mode, cid, func);
+    err_info = sr_rwlock_lock(rwlock, &timeout_abs, mode, prio, cid, func, cb, cb_data, 0);
+    SR_TRACE(rwlock_acquire, rwlock, mode, cid, err_info ? 0 : 1);
+
+    return err_info;
 }
 
 sr_error_info_t *
@@ -2707,8 +3422,8 @@ sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
         sr_lock_recover_cb cb, void *cb_data)
 {
     sr_error_info_t *err_info = NULL;
-    struct timespec timeout_abs;
-    int ret, wr_urged;
+    struct timespec timeout_abs, start;
+    int ret, wr_urged, waited = 0;
 
     assert(mode && cid);
     assert(((mode != SR_LOCK_WRITE) && (mode != SR_LOCK_WRITE_URGE)) || (timeout_ms > 0));
@@ -2718,6 +3433,7 @@ sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
          * upgrade from upgradeable read-lock to write-lock
          */
         sr_timeouttime_get(&timeout_abs, timeout_ms);
+        sr_rwlock_stats_time(&start);
 
         /* MUTEX LOCK */
         ret = pthread_mutex_clocklock(&rwlock->mutex, COMPAT_CLOCK_ID, &timeout_abs);
@@ -2745,6 +3461,7 @@ sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
         ret = 0;
         while (!ret && (rwlock->readers[1] || (rwlock->read_count[0] > 1) || rwlock->writer)) {
             /* COND WAIT */
+            waited = 1;
             ret = sr_cond_clockwait(&rwlock->cond, &rwlock->mutex, COMPAT_CLOCK_ID, &timeout_abs);
         }
         if (ret == ETIMEDOUT) {
@@ -2768,6 +3485,7 @@ sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
         rwlock->writer = cid;
 
         /* simply keep the lock */
+        sr_rwlock_stats_lock(rwlock, mode, &start, waited);
         return NULL;
 
     } else if (mode == SR_LOCK_WRITE_URGE) {
@@ -2775,6 +3493,7 @@ sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
          * upgrade from upgradeable read-lock to write-lock, urged
          */
         sr_timeouttime_get(&timeout_abs, timeout_ms);
+        sr_rwlock_stats_time(&start);
 
         /* MUTEX LOCK */
         ret = pthread_mutex_clocklock(&rwlock->mutex, COMPAT_CLOCK_ID, &timeout_abs);
@@ -2812,6 +3531,7 @@ sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
             }
 
             /* COND WAIT */
+            waited = 1;
             ret = sr_cond_clockwait(&rwlock->cond, &rwlock->mutex, COMPAT_CLOCK_ID, &timeout_abs);
         }
         if (ret == ETIMEDOUT) {
@@ -2842,6 +3562,7 @@ sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
         }
 
         /* simply keep the lock */
+        sr_rwlock_stats_lock(rwlock, mode, &start, waited);
         return NULL;
     }
 
@@ -2853,6 +3574,7 @@ sr_rwrelock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
     assert(!rwlock->readers[0] && !rwlock->upgr && (rwlock->writer == cid));
 
     /* remove writer flag */
+    sr_rwlock_stats_unlock(rwlock, 1, &rwlock->write_ts);
     rwlock->writer = 0;
 
     if (mode == SR_LOCK_READ_UPGR) {
@@ -2881,11 +3603,14 @@ sr_rwunlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t c
 
     assert(mode && cid);
 
+    SR_TRACE(rwlock_release, rwlock, mode, cid, func);
+
     if ((mode == SR_LOCK_WRITE) || (mode == SR_LOCK_WRITE_URGE)) {
         /* we are unlocking a write lock, there can be no readers */
         assert(!rwlock->readers[0] && !rwlock->upgr && (rwlock->writer == cid));
 
         /* remove the writer flag */
+        sr_rwlock_stats_unlock(rwlock, 1, &rwlock->write_ts);
         rwlock->writer = 0;
     } else {
         sr_timeouttime_get(&timeout_ts, timeout_ms);
@@ -2951,13 +3676,45 @@ sr_conn_ext_data_update(sr_conn_ctx_t *conn)
 {
     sr_error_info_t *err_info = NULL;
     const struct lys_module *ly_mod;
+    sr_mod_t *shm_mod;
     struct sr_mod_info_s mi;
     struct lyd_node *yl_data = NULL, *new_ext_data = NULL;
-    uint32_t content_id;
+    uint32_t content_id, run_data_ver, oper_data_ver;
+    int versioned, current;
 
     /* init mod info for cleanup */
     SR_MODINFO_INIT(mi, conn, SR_DS_OPERATIONAL, SR_DS_RUNNING);
 
+    /* learn the current versions of the data, before they are loaded */
+    shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), "ietf-yang-schema-mount");
+    SR_CHECK_INT_GOTO(!shm_mod, err_info, cleanup);
+    content_id = SR_CONN_MAIN_SHM(conn)->content_id;
+    run_data_ver = ATOMIC_LOAD_RELAXED(shm_mod->run_data_ver);
+    oper_data_ver = ATOMIC_LOAD_RELAXED(shm_mod->oper_data_ver);
+
+    /* operational data provided by subscribers may change anytime */
+    versioned = shm_mod->oper_get_sub_count ? 0 : 1;
+
+    if (versioned) {
+        /* LY EXT DATA READ LOCK */
+        if ((err_info = sr_rwlock(&conn->ly_ext_data_lock, SR_CONN_EXT_DATA_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid,
+                __func__, NULL, NULL))) {
+            goto cleanup;
+        }
+
+        current = conn->ly_ext_data_ver.valid && (conn->ly_ext_data_ver.content_id == content_id) &&
+                (conn->ly_ext_data_ver.run_data_ver == run_data_ver) &&
+                (conn->ly_ext_data_ver.oper_data_ver == oper_data_ver);
+
+        /* LY EXT DATA UNLOCK */
+        sr_rwunlock(&conn->ly_ext_data_lock, SR_CONN_EXT_DATA_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+
+        if (current) {
+            /* the schema-mount data have not changed */
+            goto cleanup;
+        }
+    }
+
     /* manually get ietf-yang-schema-mount operational data but avoid recursive call of this function */
     ly_mod = ly_ctx_get_module_implemented(conn->ly_ctx, "ietf-yang-schema-mount");
     assert(ly_mod);
@@ -2977,7 +3734,6 @@ sr_conn_ext_data_update(sr_conn_ctx_t *conn)
         }
 
         /* get ietf-yang-library operational data */
-        content_id = SR_CONN_MAIN_SHM(conn)->content_id;
         if (ly_ctx_get_yanglib_data(conn->ly_ctx, &yl_data, "%" PRIu32, content_id)) {
             sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
             goto cleanup;
@@ -3002,6 +3758,10 @@ sr_conn_ext_data_update(sr_conn_ctx_t *conn)
     lyd_free_siblings(conn->ly_ext_data);
     conn->ly_ext_data = new_ext_data;
     new_ext_data = NULL;
+    conn->ly_ext_data_ver.valid = versioned;
+    conn->ly_ext_data_ver.content_id = content_id;
+    conn->ly_ext_data_ver.run_data_ver = run_data_ver;
+    conn->ly_ext_data_ver.oper_data_ver = oper_data_ver;
 
     /* LY EXT DATA UNLOCK */
     sr_rwunlock(&conn->ly_ext_data_lock, SR_CONN_EXT_DATA_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__);
@@ -3087,6 +3847,9 @@ sr_conn_oper_cache_del(sr_conn_ctx_t *conn, uint32_t sub_id)
     }
     assert(cache);
 
+    /* remove any shared data of the cache */
+    sr_oper_poll_shm_remove(cache->module_name, cache->path, conn->cid);
+
     /* free members */
     free(cache->module_name);
     free(cache->path);
@@ -3126,9 +3889,10 @@ sr_conn_ext_data_replace(sr_conn_ctx_t *conn, struct lyd_node *new_ext_data)
     err_info = sr_rwlock(&conn->ly_ext_data_lock, SR_CONN_EXT_DATA_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__,
             NULL, NULL);
 
-    /* replace LY ext data */
+    /* replace LY ext data, they were generated for the previous context */
     lyd_free_siblings(conn->ly_ext_data);
     conn->ly_ext_data = new_ext_data;
+    conn->ly_ext_data_ver.valid = 0;
 
     if (!err_info) {
         /* LY EXT DATA UNLOCK */
@@ -3137,15 +3901,389 @@ sr_conn_ext_data_replace(sr_conn_ctx_t *conn, struct lyd_node *new_ext_data)
     sr_errinfo_free(&err_info);
 }
 
+void
+sr_run_snapshot_store(const struct lys_module *ly_mod, const struct srplg_ds_s *ds_plg, uint32_t content_id,
+        uint32_t run_data_ver, const struct lyd_node *mod_data)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_run_snapshot_shm_t hdr;
+    struct ly_out *out = NULL;
+    struct stat st;
+    char *path = NULL, *tmp_path = NULL, *lyb = NULL, *owner = NULL, *group = NULL;
+    mode_t perm;
+    uid_t uid = -1;
+    gid_t gid = -1;
+    int fd = -1, rc;
+
+    if ((err_info = sr_path_run_snapshot_shm(ly_mod->name, &path))) {
+        goto cleanup;
+    }
+    if (asprintf(&tmp_path, "%s.%ld", path, (long)getpid()) == -1) {
+        SR_ERRINFO_MEM(&err_info);
+        tmp_path = NULL;
+        goto cleanup;
+    }
+
+    /* print the data */
+    if (mod_data) {
+        if (ly_out_new_memory(&lyb, 0, &out)) {
+            SR_ERRINFO_MEM(&err_info);
+            goto cleanup;
+        }
+        if (lyd_print_all(out, mod_data, LYD_LYB, LYD_PRINT_WITHSIBLINGS)) {
+            sr_errinfo_new_ly(&err_info, ly_mod->ctx, NULL);
+            goto cleanup;
+        }
+    }
+
+    /* the snapshot can be read by anyone allowed to read the data */
+    if ((rc = ds_plg->access_get_cb(ly_mod, SR_DS_RUNNING, &owner, &group, &perm))) {
+        SR_ERRINFO_DSPLUGIN(&err_info, rc, "access_get", ds_plg->name, ly_mod->name);
+        goto cleanup;
+    }
+    if (owner && (err_info = sr_get_pwd(&uid, &owner))) {
+        goto cleanup;
+    }
+    if (group && (err_info = sr_get_gid(group, &gid))) {
+        goto cleanup;
+    }
+
+    /* write a temporary file so that readers never see incomplete data and any user can replace it */
+    fd = sr_open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, perm);
+    if (fd == -1) {
+        sr_errinfo_new(&err_info, SR_ERR_SYS, "Failed to open \"%s\" (%s).", tmp_path, strerror(errno));
+        goto cleanup;
+    }
+
+    /* use the owner of the data, only a privileged process can change it, otherwise the permissions apply */
+    if (fstat(fd, &st) == -1) {
+        SR_ERRINFO_SYSERRNO(&err_info, "fstat");
+        goto cleanup;
+    }
+    if ((((uid != (uid_t)-1) && (st.st_uid != uid)) || ((gid != (gid_t)-1) && (st.st_gid != gid))) &&
+            (fchown(fd, uid, gid) == -1) && (errno != EPERM)) {
+        SR_ERRINFO_SYSERRNO(&err_info, "fchown");
+        goto cleanup;
+    }
+
+    /* write the header and the data */
+    hdr.content_id = content_id;
+    hdr.run_data_ver = run_data_ver;
+    hdr.data_len = out ? ly_out_printed(out) : 0;
+    if ((write(fd, &hdr, sizeof hdr) != sizeof hdr) ||
+            (hdr.data_len && (write(fd, lyb, hdr.data_len) != (ssize_t)hdr.data_len))) {
+        SR_ERRINFO_SYSERRNO(&err_info, "write");
+        goto cleanup;
+    }
+
+    /* replace any previous snapshot */
+    if (rename(tmp_path, path) == -1) {
+        SR_ERRINFO_SYSERRNO(&err_info, "rename");
+        goto cleanup;
+    }
+
+cleanup:
+    if (fd > -1) {
+        close(fd);
+    }
+    if (err_info) {
+        /* make sure no incomplete snapshot is left, a previous one is outdated */
+        if (tmp_path) {
+            unlink(tmp_path);
+        }
+        if (path) {
+            unlink(path);
+        }
+        sr_errinfo_free(&err_info);
+        SR_LOG_WRN("Failed to store running data snapshot of module \"%s\".", ly_mod->name);
+    }
+    ly_out_free(out, NULL, 0);
+    free(lyb);
+    free(owner);
+    free(group);
+    free(path);
+    free(tmp_path);
+}
+
+int
+sr_run_snapshot_load(const struct lys_module *ly_mod, uint32_t content_id, uint32_t run_data_ver,
+        struct lyd_node **data)
+{
+    sr_error_info_t *err_info = NULL;
+    const sr_run_snapshot_shm_t *hdr;
+    struct lyd_node *mod_data = NULL;
+    char *path = NULL;
+    void *addr = MAP_FAILED;
+    size_t size = 0;
+    int fd = -1, loaded = 0;
+
+    if ((err_info = sr_path_run_snapshot_shm(ly_mod->name, &path))) {
+        goto cleanup;
+    }
+
+    /* there may be no snapshot or we may not be allowed to read it */
+    fd = sr_open(path, O_RDONLY, 0);
+    if (fd == -1) {
+        goto cleanup;
+    }
+    if ((err_info = sr_file_get_size(fd, &size))) {
+        goto cleanup;
+    }
+    if (size < sizeof *hdr) {
+        goto cleanup;
+    }
+
+    /* map the snapshot */
+    addr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        SR_ERRINFO_SYSERRNO(&err_info, "mmap");
+        goto cleanup;
+    }
+    hdr = addr;
+
+    /* check that it is current */
+    if ((hdr->content_id != content_id) || (hdr->run_data_ver != run_data_ver) ||
+            (hdr->data_len != size - sizeof *hdr)) {
+        goto cleanup;
+    }
+
+    /* parse the data directly from the SHM */
+    if (hdr->data_len && lyd_parse_data_mem(ly_mod->ctx, (char *)(hdr + 1), LYD_LYB,
+            LYD_PARSE_ONLY | LYD_PARSE_STRICT | LYD_PARSE_ORDERED, 0, &mod_data)) {
+        sr_errinfo_new_ly(&err_info, ly_mod->ctx, NULL);
+        goto cleanup;
+    }
+    if (mod_data) {
+        lyd_insert_sibling(*data, mod_data, data);
+    }
+    loaded = 1;
+
+cleanup:
+    if (addr != MAP_FAILED) {
+        munmap(addr, size);
+    }
+    if (fd > -1) {
+        close(fd);
+    }
+    if (err_info) {
+        /* fall back to the DS plugin */
+        sr_errinfo_free(&err_info);
+        SR_LOG_WRN("Failed to load running data snapshot of module \"%s\".", ly_mod->name);
+    }
+    free(path);
+    return loaded;
+}
+
+void
+sr_run_snapshot_remove(const char *mod_name)
+{
+    sr_error_info_t *err_info = NULL;
+    char *path;
+
+    if ((err_info = sr_path_run_snapshot_shm(mod_name, &path))) {
+        sr_errinfo_free(&err_info);
+        return;
+    }
+
+    if (unlink(path) && (errno != ENOENT)) {
+        SR_LOG_WRN("Failed to remove running data snapshot \"%s\" (%s).", path, strerror(errno));
+    }
+    free(path);
+}
+
+void
+sr_oper_poll_shm_store(const struct lys_module *ly_mod, const struct srplg_ds_s *ds_plg, const char *xpath,
+        sr_cid_t cid, uint32_t content_id, uint32_t valid_ms, const struct timespec *timestamp,
+        const struct lyd_node *data)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_oper_poll_shm_t hdr;
+    struct ly_out *out = NULL;
+    char *path = NULL, *tmp_path = NULL, *lyb = NULL;
+    mode_t perm;
+    int fd = -1, rc;
+
+    if ((err_info = sr_path_oper_poll_shm(ly_mod->name, xpath, &path))) {
+        goto cleanup;
+    }
+    if (asprintf(&tmp_path, "%s.%" PRIu32, path, cid) == -1) {
+        SR_ERRINFO_MEM(&err_info);
+        tmp_path = NULL;
+        goto cleanup;
+    }
+
+    /* print the data */
+    if (data) {
+        if (ly_out_new_memory(&lyb, 0, &out)) {
+            SR_ERRINFO_MEM(&err_info);
+            goto cleanup;
+        }
+        if (lyd_print_all(out, data, LYD_LYB, LYD_PRINT_WITHSIBLINGS)) {
+            sr_errinfo_new_ly(&err_info, ly_mod->ctx, NULL);
+            goto cleanup;
+        }
+    }
+
+    /* the data can be read by anyone allowed to read the operational data */
+    if ((rc = ds_plg->access_get_cb(ly_mod, SR_DS_OPERATIONAL, NULL, NULL, &perm))) {
+        SR_ERRINFO_DSPLUGIN(&err_info, rc, "access_get", ds_plg->name, ly_mod->name);
+        goto cleanup;
+    }
+
+    /* write a temporary file so that readers never see incomplete data */
+    fd = sr_open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, perm);
+    if (fd == -1) {
+        sr_errinfo_new(&err_info, SR_ERR_SYS, "Failed to open \"%s\" (%s).", tmp_path, strerror(errno));
+        goto cleanup;
+    }
+
+    /* write the header and the data */
+    memset(&hdr, 0, sizeof hdr);
+    hdr.content_id = content_id;
+    hdr.cid = cid;
+    hdr.valid_ms = valid_ms;
+    hdr.timestamp = *timestamp;
+    hdr.data_len = out ? ly_out_printed(out) : 0;
+    if ((write(fd, &hdr, sizeof hdr) != sizeof hdr) ||
+            (hdr.data_len && (write(fd, lyb, hdr.data_len) != (ssize_t)hdr.data_len))) {
+        SR_ERRINFO_SYSERRNO(&err_info, "write");
+        goto cleanup;
+    }
+
+    /* replace the previous data */
+    if (rename(tmp_path, path) == -1) {
+        SR_ERRINFO_SYSERRNO(&err_info, "rename");
+        goto cleanup;
+    }
+
+cleanup:
+    if (fd > -1) {
+        close(fd);
+    }
+    if (err_info) {
+        if (tmp_path) {
+            unlink(tmp_path);
+        }
+        sr_errinfo_free(&err_info);
+        SR_LOG_WRN("Failed to store shared \"%s\" oper poll cache data.", xpath);
+    }
+    ly_out_free(out, NULL, 0);
+    free(lyb);
+    free(path);
+    free(tmp_path);
+}
+
+int
+sr_oper_poll_shm_load(const struct lys_module *ly_mod, const char *xpath, uint32_t content_id,
+        struct lyd_node **data, struct timespec *timestamp)
+{
+    sr_error_info_t *err_info = NULL;
+    const sr_oper_poll_shm_t *hdr;
+    struct timespec cur_ts, timeout_ts;
+    char *path = NULL;
+    void *addr = MAP_FAILED;
+    size_t size = 0;
+    int fd = -1, loaded = 0;
+
+    *data = NULL;
+
+    if ((err_info = sr_path_oper_poll_shm(ly_mod->name, xpath, &path))) {
+        goto cleanup;
+    }
+
+    /* there may be no shared data or we may not be allowed to read them */
+    fd = sr_open(path, O_RDONLY, 0);
+    if (fd == -1) {
+        goto cleanup;
+    }
+    if ((err_info = sr_file_get_size(fd, &size))) {
+        goto cleanup;
+    }
+    if (size < sizeof *hdr) {
+        goto cleanup;
+    }
+
+    /* map the data */
+    addr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        SR_ERRINFO_SYSERRNO(&err_info, "mmap");
+        goto cleanup;
+    }
+    hdr = addr;
+
+    /* check that they can be used */
+    if ((hdr->content_id != content_id) || (hdr->data_len != size - sizeof *hdr)) {
+        goto cleanup;
+    }
+    sr_realtime_get(&cur_ts);
+    timeout_ts = sr_time_ts_add(&hdr->timestamp, hdr->valid_ms);
+    if (sr_time_cmp(&timeout_ts, &cur_ts) <= 0) {
+        /* expired */
+        goto cleanup;
+    }
+
+    /* parse the data directly from the SHM */
+    if (hdr->data_len && lyd_parse_data_mem(ly_mod->ctx, (char *)(hdr + 1), LYD_LYB,
+            LYD_PARSE_ONLY | LYD_PARSE_STRICT | LYD_PARSE_ORDERED, 0, data)) {
+        sr_errinfo_new_ly(&err_info, ly_mod->ctx, NULL);
+        goto cleanup;
+    }
+    if (timestamp) {
+        *timestamp = hdr->timestamp;
+    }
+    loaded = 1;
+
+cleanup:
+    if (addr != MAP_FAILED) {
+        munmap(addr, size);
+    }
+    if (fd > -1) {
+        close(fd);
+    }
+    if (err_info) {
+        /* get the data from the subscription */
+        sr_errinfo_free(&err_info);
+        SR_LOG_WRN("Failed to load shared \"%s\" oper poll cache data.", xpath);
+    }
+    free(path);
+    return loaded;
+}
+
+void
+sr_oper_poll_shm_remove(const char *mod_name, const char *xpath, sr_cid_t cid)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_oper_poll_shm_t hdr;
+    char *path;
+    int fd;
+
+    if ((err_info = sr_path_oper_poll_shm(mod_name, xpath, &path))) {
+        sr_errinfo_free(&err_info);
+        return;
+    }
+
+    /* remove only the data stored by this connection, another one may be maintaining them now */
+    fd = sr_open(path, O_RDONLY, 0);
+    if (fd == -1) {
+        goto cleanup;
+    }
+    if ((read(fd, &hdr, sizeof hdr) == sizeof hdr) && (hdr.cid == cid) && unlink(path) && (errno != ENOENT)) {
+        SR_LOG_WRN("Failed to remove shared oper poll cache data \"%s\" (%s).", path, strerror(errno));
+    }
+    close(fd);
+
+cleanup:
+    free(path);
+}
+
 sr_error_info_t *
 sr_conn_run_cache_update(sr_conn_ctx_t *conn, const struct sr_mod_info_s *mod_info, sr_lock_mode_t has_lock)
 {
     sr_error_info_t *err_info = NULL, *tmp_err;
     struct sr_mod_info_mod_s *mod;
     struct sr_run_cache_s *cmod;
-    struct timespec mtime;
     struct lyd_node *mod_data;
-    uint32_t i, j;
+    uint32_t i, idx, mod_count, run_data_ver;
     void *mem;
     int r;
 
@@ -3154,50 +4292,16 @@ sr_conn_run_cache_update(sr_conn_ctx_t *conn, const struct sr_mod_info_s *mod_in
     for (i = 0; i < mod_info->mod_count; ++i) {
         mod = &mod_info->mods[i];
 
-        /* find the cache mod */
-        cmod = NULL;
-        for (j = 0; j < conn->run_cache_mod_count; ++j) {
-            if (mod->ly_mod == conn->run_cache_mods[j].mod) {
-                cmod = &conn->run_cache_mods[j];
-                break;
-            }
-        }
-
-        if (!cmod) {
-            if (has_lock != SR_LOCK_WRITE) {
-                /* CACHE READ UNLOCK */
-                sr_rwunlock(&conn->run_cache_lock, SR_CONN_RUN_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
-                has_lock = SR_LOCK_NONE;
+        /* get the index of the cache mod */
+        idx = mod->shm_mod - SR_SHM_MOD_IDX(conn->mod_shm.addr, 0);
 
-                /* CACHE WRITE LOCK */
-                if ((err_info = sr_rwlock(&conn->run_cache_lock, SR_CONN_RUN_CACHE_LOCK_TIMEOUT, SR_LOCK_WRITE_URGE,
-                        conn->cid, __func__, NULL, NULL))) {
-                    goto cleanup;
-                }
-                has_lock = SR_LOCK_WRITE;
-            }
-
-            /* add the module into the cache */
-            mem = realloc(conn->run_cache_mods, (conn->run_cache_mod_count + 1) * sizeof *conn->run_cache_mods);
-            SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
-            conn->run_cache_mods = mem;
+        /* get the current version of module running data, before the data are loaded */
+        run_data_ver = ATOMIC_LOAD_RELAXED(mod->shm_mod->run_data_ver);
 
-            cmod = &conn->run_cache_mods[j];
-            cmod->mod = mod->ly_mod;
-            memset(&cmod->ts, 0, sizeof cmod->ts);
-
-            ++conn->run_cache_mod_count;
-        }
-
-        /* get last_modif timestamp of module running data */
-        if ((r = mod->ds_plg[SR_DS_RUNNING]->last_modif_cb(mod->ly_mod, SR_DS_RUNNING, &mtime))) {
-            SR_ERRINFO_DSPLUGIN(&err_info, r, "last_modif", mod->ds_plg[SR_DS_RUNNING]->name, mod->ly_mod->name);
-            goto cleanup;
-        }
-
-        /* check whether the data are current */
-        if (sr_time_cmp(&cmod->ts, &mtime) >= 0) {
-            continue;
+        /* check whether the data are cached and current */
+        if ((idx < conn->run_cache_mod_count) && (conn->run_cache_mods[idx].mod == mod->ly_mod) &&
+                (conn->run_cache_mods[idx].run_data_ver == run_data_ver)) {
+            continue;
         }
 
         if (has_lock != SR_LOCK_WRITE) {
@@ -3211,116 +4315,1033 @@ sr_conn_run_cache_update(sr_conn_ctx_t *conn, const struct sr_mod_info_s *mod_in
                 goto cleanup;
             }
             has_lock = SR_LOCK_WRITE;
+        }
+
+        if (idx >= conn->run_cache_mod_count) {
+            /* enlarge the cache for all the modules */
+            mod_count = SR_CONN_MOD_SHM(conn)->mod_count;
+            assert(idx < mod_count);
+            mem = realloc(conn->run_cache_mods, mod_count * sizeof *conn->run_cache_mods);
+            SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+            conn->run_cache_mods = mem;
+            memset(conn->run_cache_mods + conn->run_cache_mod_count, 0,
+                    (mod_count - conn->run_cache_mod_count) * sizeof *conn->run_cache_mods);
+            conn->run_cache_mod_count = mod_count;
+        }
+        cmod = &conn->run_cache_mods[idx];
+
+        if (cmod->mod) {
+            if ((cmod->mod == mod->ly_mod) && (cmod->run_data_ver == run_data_ver)) {
+                /* updated meanwhile */
+                continue;
+            }
+
+            /* remove old data */
+            mod_data = sr_module_data_unlink(&conn->run_cache_data, cmod->mod);
+            lyd_free_siblings(mod_data);
+            cmod->mod = NULL;
+        }
+
+        /* replace with loaded current data, from the shared snapshot if possible */
+        if (SR_RUN_SHM_SNAPSHOT && sr_run_snapshot_load(mod->ly_mod, conn->content_id, run_data_ver,
+                &conn->run_cache_data)) {
+            /* loaded */
+        } else if ((r = sr_ds_plugin_load(mod->shm_mod, mod->ds_plg[SR_DS_RUNNING], mod->ly_mod, SR_DS_RUNNING, NULL, 0,
+                &mod_data))) {
+            SR_ERRINFO_DSPLUGIN(&err_info, r, "load", mod->ds_plg[SR_DS_RUNNING]->name, mod->ly_mod->name);
+            goto cleanup;
+        } else if (mod_data) {
+            lyd_insert_sibling(conn->run_cache_data, mod_data, &conn->run_cache_data);
+        }
+
+        /* update the version, be defensive and use the version we got before loading the data */
+        cmod->mod = mod->ly_mod;
+        cmod->run_data_ver = run_data_ver;
+        ++conn->run_cache_gen;
+    }
+
+cleanup:
+    if (has_lock == SR_LOCK_WRITE) {
+        /* CACHE READ RELOCK */
+        if ((tmp_err = sr_rwrelock(&conn->run_cache_lock, SR_CONN_RUN_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid,
+                __func__, NULL, NULL))) {
+            sr_errinfo_merge(&err_info, tmp_err);
+        }
+    } else if (has_lock == SR_LOCK_NONE) {
+        /* CACHE READ LOCK */
+        if ((tmp_err = sr_rwlock(&conn->run_cache_lock, SR_CONN_RUN_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid,
+                __func__, NULL, NULL))) {
+            sr_errinfo_merge(&err_info, tmp_err);
+        }
+    }
+    return err_info;
+}
+
+void
+sr_conn_run_cache_flush(sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+
+    if (!(conn->opts & SR_CONN_CACHE_RUNNING)) {
+        return;
+    }
+    /* context will be destroyed, free the cache */
+
+    /* CACHE WRITE LOCK */
+    err_info = sr_rwlock(&conn->run_cache_lock, SR_CONN_RUN_CACHE_LOCK_TIMEOUT, SR_LOCK_WRITE_URGE, conn->cid, __func__,
+            NULL, NULL);
+
+    /* nothing else to do but continue on error */
+
+    /* free the connection cache */
+    lyd_free_siblings(conn->run_cache_data);
+    conn->run_cache_data = NULL;
+    ++conn->run_cache_gen;
+    free(conn->run_cache_mods);
+    conn->run_cache_mods = NULL;
+    conn->run_cache_mod_count = 0;
+
+    if (!err_info) {
+        /* CACHE WRITE UNLOCK */
+        sr_rwunlock(&conn->run_cache_lock, SR_CONN_RUN_CACHE_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__);
+    }
+
+    sr_errinfo_free(&err_info);
+}
+
+/**
+ * @brief Flush all cached oper data of a connection.
+ *
+ * @param[in] conn Connection to use.
+ */
+static void
+sr_conn_oper_cache_flush(sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+    struct sr_oper_poll_cache_s *cache;
+
+    /* CONN OPER CACHE READ LOCK */
+    if ((err_info = sr_rwlock(&conn->oper_cache_lock, SR_CONN_OPER_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid,
+            __func__, NULL, NULL))) {
+        /* should never happen */
+        sr_errinfo_free(&err_info);
+    }
+
+    for (i = 0; i < conn->oper_cache_count; ++i) {
+        cache = &conn->oper_caches[i];
+
+        /* CACHE DATA WRITE LOCK */
+        if ((err_info = sr_rwlock(&cache->data_lock, SR_CONN_OPER_CACHE_DATA_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid,
+                __func__, NULL, NULL))) {
+            /* should never happen */
+            sr_errinfo_free(&err_info);
+        }
+
+        /* flush data */
+        lyd_free_siblings(cache->data);
+        cache->data = NULL;
+        memset(&cache->timestamp, 0, sizeof cache->timestamp);
+
+        /* CACHE DATA UNLOCK */
+        sr_rwunlock(&cache->data_lock, SR_CONN_OPER_CACHE_DATA_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__);
+    }
+
+    /* CONN OPER CACHE UNLOCK */
+    sr_rwunlock(&conn->oper_cache_lock, SR_CONN_OPER_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+}
+
+void
+sr_conn_oper_push_cache_flush(sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+
+    if (!(conn->opts & SR_CONN_CACHE_OPER_PUSH)) {
+        return;
+    }
+    /* context will be destroyed, free the cache */
+
+    /* CACHE LOCK */
+    err_info = sr_mlock(&conn->oper_push_cache_lock, SR_CONN_OPER_PUSH_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL);
+
+    /* nothing else to do but continue on error */
+
+    /* free the connection cache */
+    for (i = 0; i < conn->oper_push_cache_mod_count; ++i) {
+        lyd_free_siblings(conn->oper_push_cache_mods[i].edit);
+        free(conn->oper_push_cache_mods[i].cids);
+    }
+    free(conn->oper_push_cache_mods);
+    conn->oper_push_cache_mods = NULL;
+    conn->oper_push_cache_mod_count = 0;
+
+    if (!err_info) {
+        /* CACHE UNLOCK */
+        sr_munlock(&conn->oper_push_cache_lock);
+    }
+
+    sr_errinfo_free(&err_info);
+}
+
+void
+sr_conn_oper_view_flush(sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+
+    if (!(conn->opts & SR_CONN_CACHE_OPER_VIEW)) {
+        return;
+    }
+    /* context will be destroyed, free the cache */
+
+    /* CACHE LOCK */
+    err_info = sr_mlock(&conn->oper_view_lock, SR_CONN_OPER_VIEW_LOCK_TIMEOUT, __func__, NULL, NULL);
+
+    /* nothing else to do but continue on error */
+
+    /* free the connection cache */
+    for (i = 0; i < conn->oper_view_mod_count; ++i) {
+        lyd_free_siblings(conn->oper_view_mods[i].data);
+        free(conn->oper_view_mods[i].cids);
+    }
+    free(conn->oper_view_mods);
+    conn->oper_view_mods = NULL;
+    conn->oper_view_mod_count = 0;
+
+    if (!err_info) {
+        /* CACHE UNLOCK */
+        sr_munlock(&conn->oper_view_lock);
+    }
+
+    sr_errinfo_free(&err_info);
+}
+
+/**
+ * @brief Free members of a cached change event diff.
+ *
+ * @param[in] cache Cached diff to free.
+ */
+static void
+sr_conn_change_diff_cache_free(struct sr_change_diff_cache_s *cache)
+{
+    free(cache->module_name);
+    free(cache->diff_lyb);
+    lyd_free_siblings(cache->diff);
+}
+
+void
+sr_conn_change_diff_cache_take(sr_conn_ctx_t *conn, const char *mod_name, sr_datastore_t ds, uint32_t request_id,
+        const char *diff_lyb, uint32_t diff_lyb_len, struct lyd_node **diff, char **cache_lyb)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_change_diff_cache_s *cache;
+    uint32_t i;
+
+    *diff = NULL;
+    *cache_lyb = NULL;
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->change_diff_cache_lock, SR_CONN_CHANGE_DIFF_CACHE_LOCK_TIMEOUT, __func__, NULL,
+            NULL))) {
+        /* just parse the diff */
+        sr_errinfo_free(&err_info);
+        return;
+    }
+
+    for (i = 0; i < conn->change_diff_cache_count; ++i) {
+        cache = &conn->change_diff_cache[i];
+        if ((cache->ds != ds) || strcmp(cache->module_name, mod_name)) {
+            continue;
+        }
+
+        if ((cache->request_id == request_id) && (cache->diff_lyb_len == diff_lyb_len) &&
+                !memcmp(cache->diff_lyb, diff_lyb, diff_lyb_len)) {
+            /* the same diff, take it */
+            *diff = cache->diff;
+            *cache_lyb = cache->diff_lyb;
+            cache->diff = NULL;
+            cache->diff_lyb = NULL;
+        }
+
+        /* the cached diff is not needed anymore in any case, replace it with the last */
+        sr_conn_change_diff_cache_free(cache);
+        if (i < conn->change_diff_cache_count - 1) {
+            memcpy(cache, &conn->change_diff_cache[conn->change_diff_cache_count - 1], sizeof *cache);
+        }
+        --conn->change_diff_cache_count;
+        if (!conn->change_diff_cache_count) {
+            free(conn->change_diff_cache);
+            conn->change_diff_cache = NULL;
+        }
+        break;
+    }
+
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->change_diff_cache_lock);
+}
+
+void
+sr_conn_change_diff_cache_store(sr_conn_ctx_t *conn, const char *mod_name, sr_datastore_t ds, uint32_t request_id,
+        char *diff_lyb, uint32_t diff_lyb_len, struct lyd_node *diff)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_change_diff_cache_s *cache = NULL;
+    char *name = NULL;
+    void *mem;
+    uint32_t i;
+
+    if (!diff || (LYD_CTX(diff) != conn->ly_ctx)) {
+        /* nothing to cache */
+        goto cleanup;
+    }
+
+    name = strdup(mod_name);
+    SR_CHECK_MEM_GOTO(!name, err_info, cleanup);
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->change_diff_cache_lock, SR_CONN_CHANGE_DIFF_CACHE_LOCK_TIMEOUT, __func__, NULL,
+            NULL))) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < conn->change_diff_cache_count; ++i) {
+        if ((conn->change_diff_cache[i].ds == ds) && !strcmp(conn->change_diff_cache[i].module_name, mod_name)) {
+            /* replace the cached diff of another subscription */
+            cache = &conn->change_diff_cache[i];
+            sr_conn_change_diff_cache_free(cache);
+            cache->module_name = NULL;
+            cache->diff_lyb = NULL;
+            cache->diff = NULL;
+            break;
+        }
+    }
+
+    if (!cache) {
+        /* new cached diff */
+        mem = realloc(conn->change_diff_cache, (conn->change_diff_cache_count + 1) * sizeof *conn->change_diff_cache);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup_unlock);
+        conn->change_diff_cache = mem;
+        cache = &conn->change_diff_cache[conn->change_diff_cache_count];
+        memset(cache, 0, sizeof *cache);
+        ++conn->change_diff_cache_count;
+    }
+
+    /* fill the cache */
+    cache->module_name = name;
+    name = NULL;
+    cache->ds = ds;
+    cache->request_id = request_id;
+    cache->diff_lyb = diff_lyb;
+    cache->diff_lyb_len = diff_lyb_len;
+    cache->diff = diff;
+    diff_lyb = NULL;
+    diff = NULL;
+
+cleanup_unlock:
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->change_diff_cache_lock);
+
+cleanup:
+    free(name);
+    free(diff_lyb);
+    lyd_free_siblings(diff);
+    sr_errinfo_free(&err_info);
+}
+
+void
+sr_conn_change_diff_cache_flush(sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+
+    /* context will be destroyed, free the cache */
+
+    /* CACHE LOCK */
+    err_info = sr_mlock(&conn->change_diff_cache_lock, SR_CONN_CHANGE_DIFF_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL);
+
+    /* nothing else to do but continue on error */
+
+    /* free the connection cache */
+    for (i = 0; i < conn->change_diff_cache_count; ++i) {
+        sr_conn_change_diff_cache_free(&conn->change_diff_cache[i]);
+    }
+    free(conn->change_diff_cache);
+    conn->change_diff_cache = NULL;
+    conn->change_diff_cache_count = 0;
+
+    if (!err_info) {
+        /* CACHE UNLOCK */
+        sr_munlock(&conn->change_diff_cache_lock);
+    }
+
+    sr_errinfo_free(&err_info);
+}
+
+/**
+ * @brief Free members of a shared read-only get result.
+ *
+ * @param[in] cache Cached result to free.
+ */
+static void
+sr_conn_ro_data_cache_free(struct sr_ro_data_cache_s *cache)
+{
+    uint32_t i;
+
+    free(cache->xpath);
+    free(cache->nacm_user);
+    for (i = 0; i <= LYD_LYB; ++i) {
+        free(cache->printed[i].str);
+    }
+    if (cache->data) {
+        lyd_free_all(cache->data->tree);
+        free(cache->data);
+    }
+}
+
+/**
+ * @brief Learn whether a shared read-only get result is still valid.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] cache Cached result.
+ * @param[in] nacm_gen Current NACM configuration generation.
+ * @return Whether the result can still be shared.
+ */
+static int
+sr_conn_ro_data_cache_valid(sr_conn_ctx_t *conn, const struct sr_ro_data_cache_s *cache, uint32_t nacm_gen)
+{
+    if (cache->run_cache_gen != conn->run_cache_gen) {
+        /* created from older running data */
+        return 0;
+    }
+
+    if (cache->nacm_user && (cache->nacm_gen != nacm_gen)) {
+        /* filtered with an older NACM configuration */
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Remove all the unused shared read-only get results that are no longer valid.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] nacm_gen Current NACM configuration generation.
+ */
+static void
+sr_conn_ro_data_cache_prune(sr_conn_ctx_t *conn, uint32_t nacm_gen)
+{
+    struct sr_ro_data_cache_s *cache;
+    uint32_t i = 0;
+
+    while (i < conn->ro_data_cache_count) {
+        cache = &conn->ro_data_cache[i];
+        if (cache->refcount || sr_conn_ro_data_cache_valid(conn, cache, nacm_gen)) {
+            ++i;
+            continue;
+        }
+
+        /* replace it with the last */
+        sr_conn_ro_data_cache_free(cache);
+        if (i < conn->ro_data_cache_count - 1) {
+            memcpy(cache, &conn->ro_data_cache[conn->ro_data_cache_count - 1], sizeof *cache);
+        }
+        --conn->ro_data_cache_count;
+    }
+}
+
+sr_data_t *
+sr_conn_ro_data_cache_get(sr_conn_ctx_t *conn, const char *xpath, const char *nacm_user, uint32_t nacm_gen,
+        uint32_t max_depth, uint32_t opts)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_ro_data_cache_s *cache;
+    sr_data_t *data = NULL;
+    uint32_t i;
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->ro_data_cache_lock, SR_CONN_RO_DATA_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL))) {
+        /* just get the data */
+        sr_errinfo_free(&err_info);
+        return NULL;
+    }
+
+    sr_conn_ro_data_cache_prune(conn, nacm_gen);
+
+    for (i = 0; i < conn->ro_data_cache_count; ++i) {
+        cache = &conn->ro_data_cache[i];
+        if (sr_conn_ro_data_cache_valid(conn, cache, nacm_gen) && (cache->max_depth == max_depth) &&
+                (cache->opts == opts) && !strcmp(cache->xpath, xpath) && ((!cache->nacm_user && !nacm_user) ||
+                (cache->nacm_user && nacm_user && !strcmp(cache->nacm_user, nacm_user)))) {
+            /* the same result, share it */
+            ++cache->refcount;
+            data = cache->data;
+            break;
+        }
+    }
+
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->ro_data_cache_lock);
+
+    return data;
+}
+
+void
+sr_conn_ro_data_cache_store(sr_conn_ctx_t *conn, const char *xpath, const char *nacm_user, uint32_t nacm_gen,
+        uint32_t max_depth, uint32_t opts, sr_data_t *data)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_ro_data_cache_s *cache;
+    void *mem;
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->ro_data_cache_lock, SR_CONN_RO_DATA_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL))) {
+        goto cleanup;
+    }
+
+    sr_conn_ro_data_cache_prune(conn, nacm_gen);
+
+    if (conn->ro_data_cache_count == SR_CONN_RO_DATA_CACHE_SIZE) {
+        /* cache full, the result will not be shared */
+        goto cleanup_unlock;
+    }
+
+    /* new cached result */
+    mem = realloc(conn->ro_data_cache, (conn->ro_data_cache_count + 1) * sizeof *conn->ro_data_cache);
+    SR_CHECK_MEM_GOTO(!mem, err_info, cleanup_unlock);
+    conn->ro_data_cache = mem;
+    cache = &conn->ro_data_cache[conn->ro_data_cache_count];
+    memset(cache, 0, sizeof *cache);
+
+    cache->xpath = strdup(xpath);
+    SR_CHECK_MEM_GOTO(!cache->xpath, err_info, cleanup_unlock);
+    if (nacm_user) {
+        cache->nacm_user = strdup(nacm_user);
+        if (!cache->nacm_user) {
+            free(cache->xpath);
+            SR_ERRINFO_MEM(&err_info);
+            goto cleanup_unlock;
+        }
+    }
+    cache->max_depth = max_depth;
+    cache->opts = opts;
+    cache->run_cache_gen = conn->run_cache_gen;
+    cache->nacm_gen = nacm_gen;
+    cache->data = data;
+    cache->refcount = 1;
+    ++conn->ro_data_cache_count;
+
+cleanup_unlock:
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->ro_data_cache_lock);
+
+cleanup:
+    sr_errinfo_free(&err_info);
+}
+
+int
+sr_conn_ro_data_cache_release(sr_conn_ctx_t *conn, const sr_data_t *data)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+    int shared = 0;
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->ro_data_cache_lock, SR_CONN_RO_DATA_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL))) {
+        /* the data may be leaked but freeing shared data would be worse */
+        sr_errinfo_free(&err_info);
+        return 1;
+    }
+
+    for (i = 0; i < conn->ro_data_cache_count; ++i) {
+        if (conn->ro_data_cache[i].data == data) {
+            assert(conn->ro_data_cache[i].refcount);
+            --conn->ro_data_cache[i].refcount;
+            shared = 1;
+            break;
+        }
+    }
+
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->ro_data_cache_lock);
+
+    return shared;
+}
+
+int
+sr_conn_ro_data_cache_printed_get(sr_conn_ctx_t *conn, const sr_data_t *data, LYD_FORMAT format, uint32_t print_opts,
+        char **str, size_t *len)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_ro_data_cache_s *cache;
+    uint32_t i;
+    int found = 0;
+
+    *str = NULL;
+    *len = 0;
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->ro_data_cache_lock, SR_CONN_RO_DATA_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL))) {
+        /* just print the data */
+        sr_errinfo_free(&err_info);
+        return 0;
+    }
+
+    for (i = 0; i < conn->ro_data_cache_count; ++i) {
+        cache = &conn->ro_data_cache[i];
+        if (cache->data != data) {
+            continue;
+        }
+
+        if (cache->printed[format].str && (cache->printed[format].print_opts == print_opts)) {
+            /* copy the printed result, print the data on failure */
+            *str = malloc(cache->printed[format].len + 1);
+            if (*str) {
+                memcpy(*str, cache->printed[format].str, cache->printed[format].len + 1);
+                *len = cache->printed[format].len;
+                found = 1;
+            }
+        }
+        break;
+    }
+
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->ro_data_cache_lock);
+
+    return found;
+}
+
+void
+sr_conn_ro_data_cache_printed_store(sr_conn_ctx_t *conn, const sr_data_t *data, LYD_FORMAT format, uint32_t print_opts,
+        const char *str, size_t len)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_ro_data_cache_s *cache;
+    uint32_t i;
+    char *mem;
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->ro_data_cache_lock, SR_CONN_RO_DATA_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL))) {
+        sr_errinfo_free(&err_info);
+        return;
+    }
+
+    for (i = 0; i < conn->ro_data_cache_count; ++i) {
+        cache = &conn->ro_data_cache[i];
+        if (cache->data != data) {
+            continue;
+        }
+
+        /* keep the printed result, replacing any printed with other options */
+        mem = malloc(len + 1);
+        if (mem) {
+            memcpy(mem, str, len);
+            mem[len] = '\0';
+            free(cache->printed[format].str);
+            cache->printed[format].print_opts = print_opts;
+            cache->printed[format].str = mem;
+            cache->printed[format].len = len;
+        }
+        break;
+    }
+
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->ro_data_cache_lock);
+}
+
+void
+sr_conn_ro_data_cache_flush(sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+
+    /* context will be destroyed, free the cache */
+
+    /* CACHE LOCK */
+    err_info = sr_mlock(&conn->ro_data_cache_lock, SR_CONN_RO_DATA_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL);
+
+    /* nothing else to do but continue on error */
+
+    for (i = 0; i < conn->ro_data_cache_count; ++i) {
+        /* nobody can be holding the results with the context being destroyed */
+        assert(!conn->ro_data_cache[i].refcount);
+        sr_conn_ro_data_cache_free(&conn->ro_data_cache[i]);
+    }
+    free(conn->ro_data_cache);
+    conn->ro_data_cache = NULL;
+    conn->ro_data_cache_count = 0;
+
+    if (!err_info) {
+        /* CACHE UNLOCK */
+        sr_munlock(&conn->ro_data_cache_lock);
+    }
+
+    sr_errinfo_free(&err_info);
+}
+
+int
+sr_conn_xpath_mods_cache_get(sr_conn_ctx_t *conn, const char *xpath, sr_datastore_t ds,
+        const struct lys_module ***ly_mods, uint32_t *ly_mod_count)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_xpath_mods_cache_s *cache;
+    uint32_t i, hash;
+    int found = 0;
+
+    *ly_mods = NULL;
+    *ly_mod_count = 0;
+
+    hash = sr_str_hash(xpath, 0);
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->xpath_mods_cache_lock, SR_CONN_XPATH_MODS_CACHE_LOCK_TIMEOUT, __func__, NULL,
+            NULL))) {
+        /* just collect the modules */
+        sr_errinfo_free(&err_info);
+        return 0;
+    }
+
+    for (i = 0; i < conn->xpath_mods_cache_count; ++i) {
+        cache = &conn->xpath_mods_cache[i];
+        if ((cache->hash != hash) || (cache->ds != ds) || (cache->content_id != conn->content_id) ||
+                strcmp(cache->xpath, xpath)) {
+            continue;
+        }
+
+        if (cache->ly_mod_count) {
+            *ly_mods = malloc(cache->ly_mod_count * sizeof **ly_mods);
+            if (!*ly_mods) {
+                /* just collect the modules */
+                break;
+            }
+            memcpy(*ly_mods, cache->ly_mods, cache->ly_mod_count * sizeof **ly_mods);
+            *ly_mod_count = cache->ly_mod_count;
+        }
+        found = 1;
+        break;
+    }
+
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->xpath_mods_cache_lock);
+
+    return found;
+}
+
+void
+sr_conn_xpath_mods_cache_store(sr_conn_ctx_t *conn, const char *xpath, sr_datastore_t ds,
+        const struct lys_module **ly_mods, uint32_t ly_mod_count)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_xpath_mods_cache_s *cache;
+    char *xp = NULL;
+    void *mem;
+
+    xp = strdup(xpath);
+    SR_CHECK_MEM_GOTO(!xp, err_info, cleanup);
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->xpath_mods_cache_lock, SR_CONN_XPATH_MODS_CACHE_LOCK_TIMEOUT, __func__, NULL,
+            NULL))) {
+        goto cleanup;
+    }
+
+    if (conn->xpath_mods_cache_count < SR_CONN_XPATH_MODS_CACHE_SIZE) {
+        /* new cached XPath */
+        mem = realloc(conn->xpath_mods_cache, (conn->xpath_mods_cache_count + 1) * sizeof *conn->xpath_mods_cache);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup_unlock);
+        conn->xpath_mods_cache = mem;
+        cache = &conn->xpath_mods_cache[conn->xpath_mods_cache_count];
+        ++conn->xpath_mods_cache_count;
+    } else {
+        /* replace the oldest cached XPath */
+        cache = &conn->xpath_mods_cache[conn->xpath_mods_cache_next];
+        conn->xpath_mods_cache_next = (conn->xpath_mods_cache_next + 1) % SR_CONN_XPATH_MODS_CACHE_SIZE;
+        free(cache->xpath);
+        free(cache->ly_mods);
+    }
+
+    /* fill the cache */
+    cache->xpath = xp;
+    xp = NULL;
+    cache->hash = sr_str_hash(xpath, 0);
+    cache->ds = ds;
+    cache->content_id = conn->content_id;
+    cache->ly_mods = ly_mods;
+    cache->ly_mod_count = ly_mod_count;
+    ly_mods = NULL;
+
+cleanup_unlock:
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->xpath_mods_cache_lock);
+
+cleanup:
+    free(xp);
+    free(ly_mods);
+    sr_errinfo_free(&err_info);
+}
+
+void
+sr_conn_xpath_mods_cache_flush(sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+
+    /* context will be destroyed, free the cache */
+
+    /* CACHE LOCK */
+    err_info = sr_mlock(&conn->xpath_mods_cache_lock, SR_CONN_XPATH_MODS_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL);
+
+    /* nothing else to do but continue on error */
+
+    for (i = 0; i < conn->xpath_mods_cache_count; ++i) {
+        free(conn->xpath_mods_cache[i].xpath);
+        free(conn->xpath_mods_cache[i].ly_mods);
+    }
+    free(conn->xpath_mods_cache);
+    conn->xpath_mods_cache = NULL;
+    conn->xpath_mods_cache_count = 0;
+    conn->xpath_mods_cache_next = 0;
+
+    if (!err_info) {
+        /* CACHE UNLOCK */
+        sr_munlock(&conn->xpath_mods_cache_lock);
+    }
+
+    sr_errinfo_free(&err_info);
+}
+
+/**
+ * @brief Free members of cached instance-identifier targets.
+ *
+ * @param[in] cache Cached targets to free.
+ */
+static void
+sr_conn_instid_cache_free(struct sr_instid_cache_s *cache)
+{
+    uint32_t i;
+
+    free(cache->source_path);
+    for (i = 0; i < cache->target_count; ++i) {
+        free(cache->targets[i].xpath);
+    }
+    free(cache->targets);
+}
+
+int
+sr_conn_instid_cache_get(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, const char *source_path,
+        uint32_t run_data_ver, struct sr_mod_info_s *mod_info, sr_error_info_t **err_info)
+{
+    sr_error_info_t *lock_err = NULL;
+    struct sr_instid_cache_s *cache;
+    uint32_t i, j;
+    int found = 0;
+
+    /* CACHE LOCK */
+    if ((lock_err = sr_mlock(&conn->instid_cache_lock, SR_CONN_INSTID_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL))) {
+        /* just collect the targets */
+        sr_errinfo_free(&lock_err);
+        return 0;
+    }
+
+    for (i = 0; i < conn->instid_cache_count; ++i) {
+        cache = &conn->instid_cache[i];
+        if ((cache->ly_mod != ly_mod) || (cache->run_data_ver != run_data_ver) || strcmp(cache->source_path, source_path)) {
+            continue;
+        }
+
+        /* add all the targets */
+        for (j = 0; j < cache->target_count; ++j) {
+            if ((*err_info = sr_modinfo_add(cache->targets[j].ly_mod, cache->targets[j].xpath, 1, 0, mod_info))) {
+                break;
+            }
+        }
+        found = 1;
+        break;
+    }
+
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->instid_cache_lock);
+
+    return found;
+}
+
+void
+sr_conn_instid_cache_store(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, const char *source_path,
+        uint32_t run_data_ver, struct sr_instid_cache_target_s *targets, uint32_t target_count)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_instid_cache_s *cache = NULL;
+    char *path = NULL;
+    void *mem;
+    uint32_t i;
 
-            /* update cmod, there may have been modules added (realloc) but not removed */
-            cmod = &conn->run_cache_mods[j];
-        }
+    path = strdup(source_path);
+    SR_CHECK_MEM_GOTO(!path, err_info, cleanup);
 
-        /* remove old data */
-        mod_data = sr_module_data_unlink(&conn->run_cache_data, cmod->mod);
-        lyd_free_siblings(mod_data);
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->instid_cache_lock, SR_CONN_INSTID_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL))) {
+        goto cleanup;
+    }
 
-        /* replace with loaded current data */
-        if ((r = mod->ds_plg[SR_DS_RUNNING]->load_cb(mod->ly_mod, SR_DS_RUNNING, NULL, 0, &mod_data))) {
-            SR_ERRINFO_DSPLUGIN(&err_info, r, "load", mod->ds_plg[SR_DS_RUNNING]->name, mod->ly_mod->name);
-            goto cleanup;
-        }
-        if (mod_data) {
-            lyd_insert_sibling(conn->run_cache_data, mod_data, &conn->run_cache_data);
+    for (i = 0; i < conn->instid_cache_count; ++i) {
+        if ((conn->instid_cache[i].ly_mod == ly_mod) && !strcmp(conn->instid_cache[i].source_path, source_path)) {
+            /* replace the targets of another data version */
+            cache = &conn->instid_cache[i];
+            sr_conn_instid_cache_free(cache);
+            break;
         }
+    }
 
-        /* update the timestamp, be defensive and use the last_modif timestamp we got before */
-        cmod->ts = mtime;
+    if (!cache) {
+        /* new cached targets */
+        mem = realloc(conn->instid_cache, (conn->instid_cache_count + 1) * sizeof *conn->instid_cache);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup_unlock);
+        conn->instid_cache = mem;
+        cache = &conn->instid_cache[conn->instid_cache_count];
+        ++conn->instid_cache_count;
     }
 
+    /* fill the cache */
+    cache->ly_mod = ly_mod;
+    cache->source_path = path;
+    path = NULL;
+    cache->run_data_ver = run_data_ver;
+    cache->targets = targets;
+    cache->target_count = target_count;
+    targets = NULL;
+
+cleanup_unlock:
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->instid_cache_lock);
+
 cleanup:
-    if (has_lock == SR_LOCK_WRITE) {
-        /* CACHE READ RELOCK */
-        if ((tmp_err = sr_rwrelock(&conn->run_cache_lock, SR_CONN_RUN_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid,
-                __func__, NULL, NULL))) {
-            sr_errinfo_merge(&err_info, tmp_err);
-        }
-    } else if (has_lock == SR_LOCK_NONE) {
-        /* CACHE READ LOCK */
-        if ((tmp_err = sr_rwlock(&conn->run_cache_lock, SR_CONN_RUN_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid,
-                __func__, NULL, NULL))) {
-            sr_errinfo_merge(&err_info, tmp_err);
+    free(path);
+    if (targets) {
+        for (i = 0; i < target_count; ++i) {
+            free(targets[i].xpath);
         }
+        free(targets);
     }
-    return err_info;
+    sr_errinfo_free(&err_info);
 }
 
 void
-sr_conn_run_cache_flush(sr_conn_ctx_t *conn)
+sr_conn_instid_cache_update(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, const struct lyd_node *mod_diff,
+        uint32_t prev_run_data_ver, uint32_t run_data_ver)
 {
     sr_error_info_t *err_info = NULL;
+    struct sr_instid_cache_s *cache;
+    uint32_t i;
 
-    if (!(conn->opts & SR_CONN_CACHE_RUNNING)) {
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->instid_cache_lock, SR_CONN_INSTID_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL))) {
+        /* the targets will not be found for the new data version */
+        sr_errinfo_free(&err_info);
         return;
     }
+
+    i = 0;
+    while (i < conn->instid_cache_count) {
+        cache = &conn->instid_cache[i];
+        if (cache->ly_mod != ly_mod) {
+            ++i;
+            continue;
+        }
+
+        if ((cache->run_data_ver == prev_run_data_ver) && !sr_instid_diff_changed(mod_diff, cache->source_path)) {
+            /* the instance-identifiers were not changed, the targets are still valid */
+            cache->run_data_ver = run_data_ver;
+            ++i;
+            continue;
+        }
+
+        /* outdated, replace with the last */
+        sr_conn_instid_cache_free(cache);
+        if (i < conn->instid_cache_count - 1) {
+            memcpy(cache, &conn->instid_cache[conn->instid_cache_count - 1], sizeof *cache);
+        }
+        --conn->instid_cache_count;
+        if (!conn->instid_cache_count) {
+            free(conn->instid_cache);
+            conn->instid_cache = NULL;
+        }
+    }
+
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->instid_cache_lock);
+}
+
+void
+sr_conn_instid_cache_flush(sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+
     /* context will be destroyed, free the cache */
 
-    /* CACHE WRITE LOCK */
-    err_info = sr_rwlock(&conn->run_cache_lock, SR_CONN_RUN_CACHE_LOCK_TIMEOUT, SR_LOCK_WRITE_URGE, conn->cid, __func__,
-            NULL, NULL);
+    /* CACHE LOCK */
+    err_info = sr_mlock(&conn->instid_cache_lock, SR_CONN_INSTID_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL);
 
     /* nothing else to do but continue on error */
 
-    /* free the connection cache */
-    lyd_free_siblings(conn->run_cache_data);
-    conn->run_cache_data = NULL;
-    free(conn->run_cache_mods);
-    conn->run_cache_mods = NULL;
-    conn->run_cache_mod_count = 0;
+    for (i = 0; i < conn->instid_cache_count; ++i) {
+        sr_conn_instid_cache_free(&conn->instid_cache[i]);
+    }
+    free(conn->instid_cache);
+    conn->instid_cache = NULL;
+    conn->instid_cache_count = 0;
 
     if (!err_info) {
-        /* CACHE WRITE UNLOCK */
-        sr_rwunlock(&conn->run_cache_lock, SR_CONN_RUN_CACHE_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__);
+        /* CACHE UNLOCK */
+        sr_munlock(&conn->instid_cache_lock);
     }
 
     sr_errinfo_free(&err_info);
 }
 
-/**
- * @brief Flush all cached oper data of a connection.
- *
- * @param[in] conn Connection to use.
- */
-static void
-sr_conn_oper_cache_flush(sr_conn_ctx_t *conn)
+int
+sr_instid_diff_changed(const struct lyd_node *diff, const char *source_path)
 {
-    sr_error_info_t *err_info = NULL;
-    uint32_t i;
-    struct sr_oper_poll_cache_s *cache;
+    struct ly_set *set;
+    int changed;
 
-    /* CONN OPER CACHE READ LOCK */
-    if ((err_info = sr_rwlock(&conn->oper_cache_lock, SR_CONN_OPER_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid,
-            __func__, NULL, NULL))) {
-        /* should never happen */
-        sr_errinfo_free(&err_info);
+    if (!diff) {
+        return 0;
     }
 
-    for (i = 0; i < conn->oper_cache_count; ++i) {
-        cache = &conn->oper_caches[i];
+    /* the diff includes all the created, deleted, and modified nodes */
+    if (lyd_find_xpath(diff, source_path, &set)) {
+        return 1;
+    }
+    changed = set->count ? 1 : 0;
+    ly_set_free(set, NULL);
 
-        /* CACHE DATA WRITE LOCK */
-        if ((err_info = sr_rwlock(&cache->data_lock, SR_CONN_OPER_CACHE_DATA_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid,
-                __func__, NULL, NULL))) {
-            /* should never happen */
-            sr_errinfo_free(&err_info);
-        }
+    return changed;
+}
 
-        /* flush data */
-        lyd_free_siblings(cache->data);
-        cache->data = NULL;
-        memset(&cache->timestamp, 0, sizeof cache->timestamp);
+void
+sr_conn_yanglib_cache_flush(sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
 
-        /* CACHE DATA UNLOCK */
-        sr_rwunlock(&cache->data_lock, SR_CONN_OPER_CACHE_DATA_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__);
+    /* context will be destroyed, free the cache */
+
+    /* CACHE LOCK */
+    err_info = sr_mlock(&conn->yanglib_cache_lock, SR_CONN_YANGLIB_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL);
+
+    /* nothing else to do but continue on error */
+
+    lyd_free_siblings(conn->yanglib_cache);
+    conn->yanglib_cache = NULL;
+    conn->yanglib_cache_cid = 0;
+
+    if (!err_info) {
+        /* CACHE UNLOCK */
+        sr_munlock(&conn->yanglib_cache_lock);
     }
 
-    /* CONN OPER CACHE UNLOCK */
-    sr_rwunlock(&conn->oper_cache_lock, SR_CONN_OPER_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+    sr_errinfo_free(&err_info);
 }
 
 void
@@ -3343,7 +5364,14 @@ sr_conn_ctx_switch(sr_conn_ctx_t *conn, struct ly_ctx **new_ctx, struct ly_ctx *
     /* replace/flush caches before context destroy */
     sr_conn_ext_data_replace(conn, new_ext_data);
     sr_conn_run_cache_flush(conn);
+    sr_conn_oper_push_cache_flush(conn);
+    sr_conn_oper_view_flush(conn);
     sr_conn_oper_cache_flush(conn);
+    sr_conn_change_diff_cache_flush(conn);
+    sr_conn_yanglib_cache_flush(conn);
+    sr_conn_ro_data_cache_flush(conn);
+    sr_conn_xpath_mods_cache_flush(conn);
+    sr_conn_instid_cache_flush(conn);
 
     /* update content ID */
     conn->content_id = SR_CONN_MAIN_SHM(conn)->content_id;
@@ -3856,8 +5884,30 @@ sr_ev2api(sr_sub_event_t ev)
     return 0;
 }
 
-sr_error_info_t *
-sr_val_ly2sr(const struct lyd_node *node, sr_val_t *sr_val)
+/**
+ * @brief Get a string value for a sysrepo value.
+ *
+ * @param[in] str String to use.
+ * @param[in] dup Whether to duplicate @p str.
+ * @return String value, NULL on memory allocation error.
+ */
+static char *
+sr_val_ly2sr_str(const char *str, int dup)
+{
+    return dup ? strdup(str) : (char *)str;
+}
+
+/**
+ * @brief Transform a libyang node into sysrepo value.
+ *
+ * @param[in] node libyang node to transform.
+ * @param[in] dup Whether to generate the xpath and origin and duplicate the string values. If not set, the string
+ * values point to the libyang canonical values except for anyxml/anydata values, which are always allocated.
+ * @param[out] sr_val sysrepo value.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_val_ly2sr_(const struct lyd_node *node, int dup, sr_val_t *sr_val)
 {
     sr_error_info_t *err_info = NULL;
     char *ptr, *origin;
@@ -3866,8 +5916,12 @@ sr_val_ly2sr(const struct lyd_node *node, sr_val_t *sr_val)
     struct lyd_node_any *any;
     struct lyd_node *tree;
 
-    sr_val->xpath = lyd_path(node, LYD_PATH_STD, NULL, 0);
-    SR_CHECK_MEM_GOTO(!sr_val->xpath, err_info, error);
+    if (dup) {
+        sr_val->xpath = lyd_path(node, LYD_PATH_STD, NULL, 0);
+        SR_CHECK_MEM_GOTO(!sr_val->xpath, err_info, error);
+    } else {
+        sr_val->xpath = NULL;
+    }
 
     sr_val->dflt = node->flags & LYD_DEFAULT ? 1 : 0;
 
@@ -3880,12 +5934,12 @@ store_value:
         switch (val->realtype->basetype) {
         case LY_TYPE_BINARY:
             sr_val->type = SR_BINARY_T;
-            sr_val->data.binary_val = strdup(lyd_value_get_canonical(LYD_CTX(node), val));
+            sr_val->data.binary_val = sr_val_ly2sr_str(lyd_value_get_canonical(LYD_CTX(node), val), dup);
             SR_CHECK_MEM_GOTO(!sr_val->data.binary_val, err_info, error);
             break;
         case LY_TYPE_BITS:
             sr_val->type = SR_BITS_T;
-            sr_val->data.bits_val = strdup(lyd_value_get_canonical(LYD_CTX(node), val));
+            sr_val->data.bits_val = sr_val_ly2sr_str(lyd_value_get_canonical(LYD_CTX(node), val), dup);
             SR_CHECK_MEM_GOTO(!sr_val->data.bits_val, err_info, error);
             break;
         case LY_TYPE_BOOL:
@@ -3907,17 +5961,17 @@ store_value:
             break;
         case LY_TYPE_ENUM:
             sr_val->type = SR_ENUM_T;
-            sr_val->data.enum_val = strdup(lyd_value_get_canonical(LYD_CTX(node), val));
+            sr_val->data.enum_val = sr_val_ly2sr_str(lyd_value_get_canonical(LYD_CTX(node), val), dup);
             SR_CHECK_MEM_GOTO(!sr_val->data.enum_val, err_info, error);
             break;
         case LY_TYPE_IDENT:
             sr_val->type = SR_IDENTITYREF_T;
-            sr_val->data.identityref_val = strdup(lyd_value_get_canonical(LYD_CTX(node), val));
+            sr_val->data.identityref_val = sr_val_ly2sr_str(lyd_value_get_canonical(LYD_CTX(node), val), dup);
             SR_CHECK_MEM_GOTO(!sr_val->data.identityref_val, err_info, error);
             break;
         case LY_TYPE_INST:
             sr_val->type = SR_INSTANCEID_T;
-            sr_val->data.instanceid_val = strdup(lyd_value_get_canonical(LYD_CTX(node), val));
+            sr_val->data.instanceid_val = sr_val_ly2sr_str(lyd_value_get_canonical(LYD_CTX(node), val), dup);
             SR_CHECK_MEM_GOTO(!sr_val->data.instanceid_val, err_info, error);
             break;
         case LY_TYPE_INT8:
@@ -3938,7 +5992,7 @@ store_value:
             break;
         case LY_TYPE_STRING:
             sr_val->type = SR_STRING_T;
-            sr_val->data.string_val = strdup(lyd_value_get_canonical(LYD_CTX(node), val));
+            sr_val->data.string_val = sr_val_ly2sr_str(lyd_value_get_canonical(LYD_CTX(node), val), dup);
             SR_CHECK_MEM_GOTO(!sr_val->data.string_val, err_info, error);
             break;
         case LY_TYPE_UINT8:
@@ -4021,15 +6075,270 @@ store_value:
         return err_info;
     }
 
-    /* origin */
-    sr_edit_diff_get_origin(node, &origin, NULL);
-    sr_val->origin = origin;
+    /* origin */
+    if (dup) {
+        sr_edit_diff_get_origin(node, &origin, NULL);
+        sr_val->origin = origin;
+    } else {
+        sr_val->origin = NULL;
+    }
+
+    return NULL;
+
+error:
+    free(sr_val->xpath);
+    return err_info;
+}
+
+sr_error_info_t *
+sr_val_ly2sr(const struct lyd_node *node, sr_val_t *sr_val)
+{
+    return sr_val_ly2sr_(node, 1, sr_val);
+}
+
+sr_error_info_t *
+sr_val_ly2sr_data(const struct lyd_node *node, sr_val_t *sr_val)
+{
+    assert(!(node->schema->nodetype & LYS_ANYDATA));
+
+    return sr_val_ly2sr_(node, 0, sr_val);
+}
+
+int
+sr_val_type_is_str(sr_val_type_t type)
+{
+    switch (type) {
+    case SR_BINARY_T:
+    case SR_BITS_T:
+    case SR_ENUM_T:
+    case SR_IDENTITYREF_T:
+    case SR_INSTANCEID_T:
+    case SR_STRING_T:
+    case SR_ANYXML_T:
+    case SR_ANYDATA_T:
+        return 1;
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Make sure there is enough free space in a values memory block.
+ *
+ * @param[in,out] block Memory block, may be reallocated.
+ * @param[in,out] size Size of @p block.
+ * @param[in] used Used bytes of @p block.
+ * @param[in] len Required free bytes.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_vals_block_reserve(char **block, size_t *size, size_t used, size_t len)
+{
+    sr_error_info_t *err_info = NULL;
+    size_t new_size;
+    char *mem;
+
+    if (used + len <= *size) {
+        return NULL;
+    }
+
+    for (new_size = *size * 2; new_size < used + len; new_size *= 2) {}
+    mem = realloc(*block, new_size);
+    SR_CHECK_MEM_RET(!mem, err_info);
+    *block = mem;
+    *size = new_size;
+
+    return NULL;
+}
+
+/**
+ * @brief Append a string into a values memory block.
+ *
+ * @param[in,out] block Memory block, may be reallocated.
+ * @param[in,out] size Size of @p block.
+ * @param[in,out] used Used bytes of @p block.
+ * @param[in] str String to append, NULL for none.
+ * @param[out] off Offset of the string in @p block stored in a pointer, NULL if @p str is NULL.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_vals_block_add_str(char **block, size_t *size, size_t *used, const char *str, char **off)
+{
+    sr_error_info_t *err_info = NULL;
+    size_t len;
+
+    if (!str) {
+        *off = NULL;
+        return NULL;
+    }
+
+    len = strlen(str) + 1;
+    if ((err_info = sr_vals_block_reserve(block, size, *used, len))) {
+        return err_info;
+    }
+
+    memcpy(*block + *used, str, len);
+    *off = (char *)(uintptr_t)*used;
+    *used += len;
+    return NULL;
+}
+
+/**
+ * @brief Header of a values memory block created by ::sr_vals_ly2sr_block(), precedes the values array.
+ */
+struct sr_vals_block_hdr {
+    uint64_t check;     /**< ::SR_VALS_BLOCK_MAGIC XOR-ed with the address of the values array. */
+    uint64_t count;     /**< Count of the values. */
+};
+
+/** magic number identifying a values memory block */
+#define SR_VALS_BLOCK_MAGIC 0x73726276616c73ULL
+
+/** values array of a values memory block */
+#define SR_VALS_BLOCK_VALS(block) ((sr_val_t *)((char *)(block) + sizeof(struct sr_vals_block_hdr)))
+
+sr_error_info_t *
+sr_vals_ly2sr_block(const struct ly_set *set, sr_val_t **values, size_t *value_cnt)
+{
+    sr_error_info_t *err_info = NULL;
+    char *block = NULL, *str, *origin, *off;
+    struct sr_vals_block_hdr *hdr;
+    size_t size, used, len;
+    sr_val_t *val;
+    uint32_t i;
+
+    *values = NULL;
+    *value_cnt = 0;
+
+    if (!set->count) {
+        return NULL;
+    }
+
+    /* header, the values array, and all the strings, pointers store offsets until the block stops moving */
+    used = sizeof(struct sr_vals_block_hdr) + set->count * sizeof **values;
+    size = used + set->count * SR_VALS_BLOCK_STR_LEN;
+    block = malloc(size);
+    SR_CHECK_MEM_RET(!block, err_info);
+
+    for (i = 0; i < set->count; ++i) {
+        val = &SR_VALS_BLOCK_VALS(block)[i];
+
+        /* value without any strings of its own */
+        if ((err_info = sr_val_ly2sr_(set->dnodes[i], 0, val))) {
+            goto cleanup;
+        }
+        str = NULL;
+        if (sr_val_type_is_str(val->type)) {
+            str = val->data.string_val;
+            val->data.string_val = NULL;
+        }
+
+        /* xpath, printed directly into the block if it fits */
+        if ((err_info = sr_vals_block_reserve(&block, &size, used, SR_VALS_BLOCK_STR_LEN))) {
+            goto cleanup_str;
+        }
+        val = &SR_VALS_BLOCK_VALS(block)[i];
+        if (lyd_path(set->dnodes[i], LYD_PATH_STD, block + used, size - used)) {
+            val->xpath = (char *)(uintptr_t)used;
+            used += strlen(block + used) + 1;
+        } else {
+            /* too long */
+            origin = lyd_path(set->dnodes[i], LYD_PATH_STD, NULL, 0);
+            SR_CHECK_MEM_GOTO(!origin, err_info, cleanup_str);
+            len = strlen(origin) + 1;
+            err_info = sr_vals_block_reserve(&block, &size, used, len);
+            if (!err_info) {
+                memcpy(block + used, origin, len);
+                SR_VALS_BLOCK_VALS(block)[i].xpath = (char *)(uintptr_t)used;
+                used += len;
+            }
+            free(origin);
+            if (err_info) {
+                goto cleanup_str;
+            }
+        }
+
+        /* string value */
+        if ((err_info = sr_vals_block_add_str(&block, &size, &used, str, &off))) {
+            goto cleanup_str;
+        }
+        val = &SR_VALS_BLOCK_VALS(block)[i];
+        if (sr_val_type_is_str(val->type)) {
+            val->data.string_val = off;
+        }
+        if ((val->type == SR_ANYXML_T) || (val->type == SR_ANYDATA_T)) {
+            /* printed */
+            free(str);
+        }
+        str = NULL;
+
+        /* origin */
+        sr_edit_diff_get_origin(set->dnodes[i], &origin, NULL);
+        err_info = sr_vals_block_add_str(&block, &size, &used, origin, &off);
+        free(origin);
+        if (err_info) {
+            goto cleanup;
+        }
+        SR_VALS_BLOCK_VALS(block)[i].origin = off;
+    }
+
+    /* the block does not move anymore, turn the offsets into pointers */
+    for (i = 0; i < set->count; ++i) {
+        val = &SR_VALS_BLOCK_VALS(block)[i];
+        val->xpath = block + (uintptr_t)val->xpath;
+        if (val->origin) {
+            val->origin = block + (uintptr_t)val->origin;
+        }
+        if (sr_val_type_is_str(val->type) && val->data.string_val) {
+            val->data.string_val = block + (uintptr_t)val->data.string_val;
+        }
+    }
+
+    /* mark the block so that it is recognized when freed */
+    hdr = (struct sr_vals_block_hdr *)block;
+    hdr->check = SR_VALS_BLOCK_MAGIC ^ (uintptr_t)SR_VALS_BLOCK_VALS(block);
+    hdr->count = set->count;
+
+    *values = SR_VALS_BLOCK_VALS(block);
+    *value_cnt = set->count;
+    block = NULL;
+    goto cleanup;
+
+cleanup_str:
+    if ((SR_VALS_BLOCK_VALS(block)[i].type == SR_ANYXML_T) || (SR_VALS_BLOCK_VALS(block)[i].type == SR_ANYDATA_T)) {
+        free(str);
+    }
+
+cleanup:
+    free(block);
+    return err_info;
+}
+
+int
+sr_vals_is_block(const sr_val_t *values, size_t count)
+{
+    const struct sr_vals_block_hdr *hdr;
+
+    /* the first string of a block follows the values array, checked before reading the header which would be
+     * out of bounds for an ordinary array */
+    if (!count || (values[0].xpath != (char *)(values + count))) {
+        return 0;
+    }
+
+    hdr = (const struct sr_vals_block_hdr *)((const char *)values - sizeof *hdr);
+    return (hdr->check == (SR_VALS_BLOCK_MAGIC ^ (uintptr_t)values)) && (hdr->count == count);
+}
 
-    return NULL;
+void
+sr_vals_block_free(sr_val_t *values)
+{
+    struct sr_vals_block_hdr *hdr;
 
-error:
-    free(sr_val->xpath);
-    return err_info;
+    hdr = (struct sr_vals_block_hdr *)((char *)values - sizeof *hdr);
+    hdr->check = 0;
+    free(hdr);
 }
 
 char *
@@ -4675,6 +6984,90 @@ error:
     return err_info;
 }
 
+int
+sr_xpath_is_instance(const struct ly_ctx *ly_ctx, const char *xpath)
+{
+    const struct lys_module *ly_mod = NULL;
+    const struct lysc_node *snode = NULL, *key;
+    const char *ptr, *mod, *name, *val_end;
+    int mod_len, len;
+
+    for (ptr = xpath; ptr[0]; ) {
+        if (ptr[0] != '/') {
+            return 0;
+        }
+
+        /* node */
+        ptr = sr_xpath_next_qname(ptr + 1, &mod, &mod_len, &name, &len);
+        if (!len || ((len == 1) && (name[0] == '*'))) {
+            return 0;
+        }
+        if (mod) {
+            ly_mod = ly_ctx_get_module_implemented2(ly_ctx, mod, mod_len);
+        }
+        if (!ly_mod) {
+            return 0;
+        }
+        snode = lys_find_child(snode, ly_mod, name, len, LYS_CONTAINER | LYS_LIST, 0);
+        if (!snode) {
+            return 0;
+        }
+
+        if (snode->nodetype == LYS_CONTAINER) {
+            if (ptr[0] == '[') {
+                return 0;
+            }
+            continue;
+        }
+
+        /* list, all the keys with literal values */
+        for (key = lysc_node_child(snode); key && lysc_is_key(key); key = key->next) {
+            if (ptr[0] != '[') {
+                return 0;
+            }
+            ptr = sr_xpath_next_qname(ptr + 1, NULL, NULL, &name, &len);
+            if (strncmp(key->name, name, len) || key->name[len] || (ptr[0] != '=')) {
+                return 0;
+            }
+            if ((ptr[1] != '\'') && (ptr[1] != '\"')) {
+                return 0;
+            }
+            val_end = strchr(ptr + 2, ptr[1]);
+            if (!val_end || (val_end[1] != ']')) {
+                return 0;
+            }
+            ptr = val_end + 2;
+        }
+        if ((key == lysc_node_child(snode)) || (ptr[0] == '[')) {
+            /* keyless list or other predicates */
+            return 0;
+        }
+    }
+
+    return snode ? 1 : 0;
+}
+
+int
+sr_xpath_is_plain_path(const char *xpath)
+{
+    const char *ptr, *name;
+    int len;
+
+    for (ptr = xpath; ptr[0]; ) {
+        if (ptr[0] != '/') {
+            return 0;
+        }
+
+        /* node, no "..", ".", or "*" */
+        ptr = sr_xpath_next_qname(ptr + 1, NULL, NULL, &name, &len);
+        if (!len || (name[0] == '.') || (name[0] == '*')) {
+            return 0;
+        }
+    }
+
+    return (ptr != xpath) ? 1 : 0;
+}
+
 char *
 sr_xpath_first_node_with_predicates(const char *xpath)
 {
@@ -5112,6 +7505,226 @@ sr_xpath_atoms_free(sr_xp_atoms_t *xp_atoms)
     free(xp_atoms);
 }
 
+sr_error_info_t *
+sr_xpath_get_sub_atoms(const char *xpath, char **atoms, size_t *atoms_len)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_xp_atoms_t *xp_atoms = NULL;
+    size_t len;
+    uint32_t i;
+    char *ptr;
+
+    *atoms = NULL;
+    *atoms_len = 0;
+
+    /* get text atoms */
+    if ((err_info = sr_xpath_get_text_atoms(xpath, &xp_atoms)) || !xp_atoms) {
+        goto cleanup;
+    }
+    if (xp_atoms->union_count != 1) {
+        /* unions are not expected */
+        goto cleanup;
+    }
+
+    /* learn the length */
+    len = 1;
+    for (i = 0; i < xp_atoms->unions[0].atom_count; ++i) {
+        len += strlen(xp_atoms->unions[0].atoms[i]) + 1;
+    }
+
+    /* serialize the atoms */
+    *atoms = malloc(len);
+    SR_CHECK_MEM_GOTO(!*atoms, err_info, cleanup);
+    ptr = *atoms;
+    for (i = 0; i < xp_atoms->unions[0].atom_count; ++i) {
+        strcpy(ptr, xp_atoms->unions[0].atoms[i]);
+        ptr += strlen(ptr) + 1;
+    }
+    ptr[0] = '\0';
+    *atoms_len = len;
+
+cleanup:
+    sr_xpath_atoms_free(xp_atoms);
+    return err_info;
+}
+
+size_t
+sr_xpath_sub_atoms_len(const char *atoms)
+{
+    const char *ptr;
+
+    for (ptr = atoms; ptr[0]; ptr += strlen(ptr) + 1) {}
+
+    return (ptr - atoms) + 1;
+}
+
+sr_error_info_t *
+sr_xpath_filter_compile(const char *xpath, sr_xpath_filter_t *filter)
+{
+    sr_error_info_t *err_info = NULL;
+    const char *ptr, *mod, *name, *prev_mod = NULL;
+    int mod_len, len;
+    uint32_t count = 0;
+    char *buf;
+
+    memset(filter, 0, sizeof *filter);
+
+    if (!xpath || (xpath[0] != '/')) {
+        /* not a simple path */
+        return NULL;
+    }
+
+    /* check the whole path consists only of qualified node names */
+    ptr = xpath;
+    while (ptr[0] == '/') {
+        ptr = sr_xpath_next_qname(ptr + 1, &mod, &mod_len, &name, &len);
+        if (!len || (!isalpha(name[0]) && (name[0] != '_')) || (!count && !mod)) {
+            /* special node, missing node name, or missing module of a top-level node */
+            return NULL;
+        }
+        ++count;
+    }
+    if (ptr[0]) {
+        /* predicates or other expressions */
+        return NULL;
+    }
+
+    /* all the names fit into the XPath length */
+    filter->buf = strdup(xpath);
+    SR_CHECK_MEM_GOTO(!filter->buf, err_info, cleanup);
+    filter->steps = malloc(count * sizeof *filter->steps);
+    SR_CHECK_MEM_GOTO(!filter->steps, err_info, cleanup);
+
+    ptr = xpath;
+    buf = filter->buf;
+    while (ptr[0] == '/') {
+        ptr = sr_xpath_next_qname(ptr + 1, &mod, &mod_len, &name, &len);
+
+        /* module name, inherited from the parent if not specified */
+        if (mod) {
+            memcpy(buf, mod, mod_len);
+            buf[mod_len] = '\0';
+            prev_mod = buf;
+            buf += mod_len + 1;
+        }
+        filter->steps[filter->step_count].mod_name = prev_mod;
+
+        /* node name */
+        memcpy(buf, name, len);
+        buf[len] = '\0';
+        filter->steps[filter->step_count].name = buf;
+        buf += len + 1;
+
+        ++filter->step_count;
+    }
+
+cleanup:
+    if (err_info) {
+        sr_xpath_filter_clear(filter);
+    }
+    return err_info;
+}
+
+void
+sr_xpath_filter_clear(sr_xpath_filter_t *filter)
+{
+    free(filter->buf);
+    free(filter->steps);
+    memset(filter, 0, sizeof *filter);
+}
+
+/**
+ * @brief Collect all the data nodes matching compiled filter steps.
+ *
+ * @param[in] filter Compiled filter.
+ * @param[in] step Index of the step to match.
+ * @param[in] first First sibling of the nodes to match.
+ * @param[in,out] set Set of matching nodes.
+ * @param[out] opaq Set if an opaque node was found and the filter cannot be used.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_xpath_filter_find_r(const sr_xpath_filter_t *filter, uint32_t step, const struct lyd_node *first, struct ly_set *set,
+        int *opaq)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lyd_node *node;
+
+    LY_LIST_FOR(first, node) {
+        if (!node->schema) {
+            *opaq = 1;
+            return NULL;
+        }
+
+        if (strcmp(node->schema->name, filter->steps[step].name) ||
+                strcmp(node->schema->module->name, filter->steps[step].mod_name)) {
+            continue;
+        }
+
+        if (step == filter->step_count - 1) {
+            /* match */
+            if (ly_set_add(set, (void *)node, 1, NULL)) {
+                sr_errinfo_new_ly(&err_info, LYD_CTX(node), NULL);
+                return err_info;
+            }
+        } else if ((err_info = sr_xpath_filter_find_r(filter, step + 1, lyd_child(node), set, opaq))) {
+            return err_info;
+        }
+        if (*opaq) {
+            return NULL;
+        }
+    }
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_xpath_filter_find(const sr_xpath_filter_t *filter, const char *xpath, const struct lyd_node *tree, struct ly_set **set)
+{
+    sr_error_info_t *err_info = NULL;
+    int opaq = 0;
+
+    assert(tree);
+
+    *set = NULL;
+
+    if (filter && filter->steps) {
+        /* start from the first top-level sibling */
+        while (tree->parent) {
+            tree = lyd_parent(tree);
+        }
+        tree = lyd_first_sibling(tree);
+
+        if (ly_set_new(set)) {
+            sr_errinfo_new_ly(&err_info, LYD_CTX(tree), NULL);
+            return err_info;
+        }
+        if ((err_info = sr_xpath_filter_find_r(filter, 0, tree, *set, &opaq))) {
+            goto cleanup;
+        }
+        if (!opaq) {
+            /* done */
+            goto cleanup;
+        }
+
+        /* evaluate the XPath, the data include opaque nodes */
+        ly_set_free(*set, NULL);
+        *set = NULL;
+    }
+
+    if (lyd_find_xpath(tree, xpath, set)) {
+        sr_errinfo_new_ly(&err_info, LYD_CTX(tree), NULL);
+        goto cleanup;
+    }
+
+cleanup:
+    if (err_info) {
+        ly_set_free(*set, NULL);
+        *set = NULL;
+    }
+    return err_info;
+}
+
 struct lys_module *
 sr_ly_atom_is_foreign(const struct lysc_node *atom, const struct lysc_node *top_node)
 {
@@ -5251,9 +7864,74 @@ sr_module_data_unlink(struct lyd_node **data, const struct lys_module *ly_mod)
     return mod_data;
 }
 
+/**
+ * @brief Learn whether this process collects datastore plugin statistics.
+ *
+ * @return Whether the statistics are collected.
+ */
+static int
+sr_ds_stats_enabled(void)
+{
+    static ATOMIC_T enabled = 0;
+    uint_fast32_t val;
+    const char *env;
+
+    /* 0 - not learned yet, 1 - disabled, 2 - enabled */
+    val = ATOMIC_LOAD_RELAXED(enabled);
+    if (!val) {
+        env = getenv(SR_DS_STATS_ENV);
+        val = (env && strcmp(env, "0")) ? 2 : 1;
+        ATOMIC_STORE_RELAXED(enabled, val);
+    }
+
+    return val == 2;
+}
+
+int
+sr_ds_plugin_load(sr_mod_t *shm_mod, const struct srplg_ds_s *ds_plg, const struct lys_module *ly_mod, sr_datastore_t ds,
+        const char **xpaths, uint32_t xpath_count, struct lyd_node **mod_data)
+{
+    struct timespec start, end;
+    int rc;
+
+    SR_TRACE(ds_load_start, ds_plg->name, ly_mod->name, ds);
+    sr_timeouttime_get(&start, 0);
+
+    rc = ds_plg->load_cb(ly_mod, ds, xpaths, xpath_count, mod_data);
+
+    sr_timeouttime_get(&end, 0);
+    SR_TRACE(ds_load_end, ds_plg->name, ly_mod->name, ds, rc);
+    if (shm_mod && sr_ds_stats_enabled()) {
+        sr_latency_stats_add(&shm_mod->ds_stats[ds].load, sr_time_sub_us(&end, &start));
+    }
+
+    return rc;
+}
+
+int
+sr_ds_plugin_store(sr_mod_t *shm_mod, const struct srplg_ds_s *ds_plg, const struct lys_module *ly_mod, sr_datastore_t ds,
+        const struct lyd_node *mod_diff, const struct lyd_node *mod_data)
+{
+    struct timespec start, end;
+    int rc;
+
+    SR_TRACE(ds_store_start, ds_plg->name, ly_mod->name, ds);
+    sr_timeouttime_get(&start, 0);
+
+    rc = ds_plg->store_cb(ly_mod, ds, mod_diff, mod_data);
+
+    sr_timeouttime_get(&end, 0);
+    SR_TRACE(ds_store_end, ds_plg->name, ly_mod->name, ds, rc);
+    if (shm_mod && sr_ds_stats_enabled()) {
+        sr_latency_stats_add(&shm_mod->ds_stats[ds].store, sr_time_sub_us(&end, &start));
+    }
+
+    return rc;
+}
+
 sr_error_info_t *
-sr_module_file_data_append(const struct lys_module *ly_mod, const struct srplg_ds_s *ds_plg[], sr_datastore_t ds,
-        const char **xpaths, uint32_t xpath_count, struct lyd_node **data)
+sr_module_file_data_append(sr_mod_t *shm_mod, const struct lys_module *ly_mod, const struct srplg_ds_s *ds_plg[],
+        sr_datastore_t ds, const char **xpaths, uint32_t xpath_count, struct lyd_node **data)
 {
     sr_error_info_t *err_info = NULL;
     struct lyd_node *mod_data;
@@ -5272,7 +7950,7 @@ sr_module_file_data_append(const struct lys_module *ly_mod, const struct srplg_d
     }
 
     /* get the data */
-    if ((rc = ds_plg[ds]->load_cb(ly_mod, ds, xpaths, xpath_count, &mod_data))) {
+    if ((rc = sr_ds_plugin_load(shm_mod, ds_plg[ds], ly_mod, ds, xpaths, xpath_count, &mod_data))) {
         SR_ERRINFO_DSPLUGIN(&err_info, rc, "load", ds_plg[ds]->name, ly_mod->name);
         return err_info;
     }
@@ -5286,45 +7964,175 @@ sr_module_file_data_append(const struct lys_module *ly_mod, const struct srplg_d
 }
 
 sr_error_info_t *
-sr_module_file_oper_data_load(struct sr_mod_info_mod_s *mod, struct lyd_node **edit)
+sr_oper_edit_owners(struct lyd_node *edit, sr_cid_t **cids, uint32_t *cid_count)
 {
     sr_error_info_t *err_info = NULL;
     struct lyd_node *root, *elem;
     struct lyd_meta *meta;
-    sr_cid_t dead_cid = 0;
+    uint32_t i;
+    void *mem;
+
+    *cids = NULL;
+    *cid_count = 0;
+
+    LY_LIST_FOR(edit, root) {
+        LYD_TREE_DFS_BEGIN(root, elem) {
+            meta = lyd_find_meta(elem->meta, NULL, "sysrepo:cid");
+            if (meta) {
+                for (i = 0; (i < *cid_count) && ((*cids)[i] != meta->value.uint32); ++i) {}
+                if (i == *cid_count) {
+                    /* new owner */
+                    mem = realloc(*cids, (*cid_count + 1) * sizeof **cids);
+                    SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+                    *cids = mem;
+                    (*cids)[*cid_count] = meta->value.uint32;
+                    ++(*cid_count);
+                }
+            }
+            LYD_TREE_DFS_END(root, elem);
+        }
+    }
+
+cleanup:
+    if (err_info) {
+        free(*cids);
+        *cids = NULL;
+        *cid_count = 0;
+    }
+    return err_info;
+}
+
+/**
+ * @brief Remove edit of all the dead owner connections from a stored operational edit.
+ *
+ * @param[in] ly_mod Module of the edit.
+ * @param[in,out] edit Stored operational edit.
+ * @param[in,out] cids Owner CIDs of @p edit, dead ones are removed.
+ * @param[in,out] cid_count Count of @p cids.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_oper_edit_trim_dead(const struct lys_module *ly_mod, struct lyd_node **edit, sr_cid_t *cids, uint32_t *cid_count)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i = 0;
+
+    while (i < *cid_count) {
+        if (sr_conn_is_alive(cids[i])) {
+            ++i;
+            continue;
+        }
+
+        /* this connection is dead, remove its stored edit, it never changes owners of the other nodes */
+        SR_LOG_INF("Recovering module \"%s\" stored operational data of CID %" PRIu32 ".", ly_mod->name, cids[i]);
+        if ((err_info = sr_edit_oper_del(edit, cids[i], NULL, NULL))) {
+            return err_info;
+        }
+
+        --(*cid_count);
+        cids[i] = cids[*cid_count];
+    }
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_module_file_oper_data_load(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod, struct lyd_node **edit)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_oper_push_cache_s *cmod;
+    sr_cid_t *cids = NULL;
+    uint32_t idx, mod_count, cid_count, oper_data_ver;
+    void *mem;
     int rc;
 
     assert(!*edit);
 
-    /* load the operational data (edit) */
-    if ((rc = mod->ds_plg[SR_DS_OPERATIONAL]->load_cb(mod->ly_mod, SR_DS_OPERATIONAL, NULL, 0, edit))) {
-        SR_ERRINFO_DSPLUGIN(&err_info, rc, "load", mod->ds_plg[SR_DS_OPERATIONAL]->name, mod->ly_mod->name);
-        return err_info;
-    }
+    if (!(conn->opts & SR_CONN_CACHE_OPER_PUSH)) {
+        /* load the operational data (edit) */
+        if ((rc = sr_ds_plugin_load(mod->shm_mod, mod->ds_plg[SR_DS_OPERATIONAL], mod->ly_mod, SR_DS_OPERATIONAL, NULL, 0,
+                edit))) {
+            SR_ERRINFO_DSPLUGIN(&err_info, rc, "load", mod->ds_plg[SR_DS_OPERATIONAL]->name, mod->ly_mod->name);
+            return err_info;
+        }
 
-trim_retry:
-    if (dead_cid) {
-        /* this connection is dead, remove its stored edit */
-        SR_LOG_INF("Recovering module \"%s\" stored operational data of CID %" PRIu32 ".", mod->ly_mod->name, dead_cid);
-        if ((err_info = sr_edit_oper_del(edit, dead_cid, NULL, NULL))) {
+        /* find all the owners and remove edit belonging to the dead ones, if any */
+        if ((err_info = sr_oper_edit_owners(*edit, &cids, &cid_count))) {
             return err_info;
         }
+        err_info = sr_oper_edit_trim_dead(mod->ly_mod, edit, cids, &cid_count);
+        free(cids);
+        return err_info;
     }
 
-    /* find edit belonging to a dead connection, if any */
-    LY_LIST_FOR(*edit, root) {
-        LYD_TREE_DFS_BEGIN(root, elem) {
-            meta = lyd_find_meta(elem->meta, NULL, "sysrepo:cid");
-            if (meta && !sr_conn_is_alive(meta->value.uint32)) {
-                dead_cid = meta->value.uint32;
+    /* get the index of the cache mod */
+    idx = mod->shm_mod - SR_SHM_MOD_IDX(conn->mod_shm.addr, 0);
 
-                /* retry the whole check until there are no dead connections */
-                goto trim_retry;
-            }
-            LYD_TREE_DFS_END(root, elem);
+    /* get the current version of module stored operational data, before the data are loaded */
+    oper_data_ver = ATOMIC_LOAD_RELAXED(mod->shm_mod->oper_data_ver);
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->oper_push_cache_lock, SR_CONN_OPER_PUSH_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL))) {
+        return err_info;
+    }
+
+    if (idx >= conn->oper_push_cache_mod_count) {
+        /* enlarge the cache for all the modules */
+        mod_count = SR_CONN_MOD_SHM(conn)->mod_count;
+        assert(idx < mod_count);
+        mem = realloc(conn->oper_push_cache_mods, mod_count * sizeof *conn->oper_push_cache_mods);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup_unlock);
+        conn->oper_push_cache_mods = mem;
+        memset(conn->oper_push_cache_mods + conn->oper_push_cache_mod_count, 0,
+                (mod_count - conn->oper_push_cache_mod_count) * sizeof *conn->oper_push_cache_mods);
+        conn->oper_push_cache_mod_count = mod_count;
+    }
+    cmod = &conn->oper_push_cache_mods[idx];
+
+    if ((cmod->mod != mod->ly_mod) || (cmod->oper_data_ver != oper_data_ver)) {
+        /* remove old edit */
+        lyd_free_siblings(cmod->edit);
+        free(cmod->cids);
+        memset(cmod, 0, sizeof *cmod);
+
+        /* load the current edit and learn its owners */
+        if ((rc = sr_ds_plugin_load(mod->shm_mod, mod->ds_plg[SR_DS_OPERATIONAL], mod->ly_mod, SR_DS_OPERATIONAL, NULL, 0,
+                &cmod->edit))) {
+            SR_ERRINFO_DSPLUGIN(&err_info, rc, "load", mod->ds_plg[SR_DS_OPERATIONAL]->name, mod->ly_mod->name);
+            goto cleanup_unlock;
+        }
+        if ((err_info = sr_oper_edit_owners(cmod->edit, &cmod->cids, &cmod->cid_count))) {
+            goto cleanup_unlock;
         }
+
+        /* use the version we got before loading the edit */
+        cmod->mod = mod->ly_mod;
+        cmod->oper_data_ver = oper_data_ver;
     }
 
+    /* drop the edit of the dead owners from the cache, it is done only once for each of them */
+    if ((err_info = sr_oper_edit_trim_dead(mod->ly_mod, &cmod->edit, cmod->cids, &cmod->cid_count))) {
+        goto cleanup_unlock;
+    }
+
+    /* return a copy of the cached edit */
+    if (cmod->edit && lyd_dup_siblings(cmod->edit, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, edit)) {
+        sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, NULL);
+        goto cleanup_unlock;
+    }
+
+cleanup_unlock:
+    if (err_info && (idx < conn->oper_push_cache_mod_count)) {
+        /* the cached edit may be incomplete */
+        cmod = &conn->oper_push_cache_mods[idx];
+        lyd_free_siblings(cmod->edit);
+        free(cmod->cids);
+        memset(cmod, 0, sizeof *cmod);
+    }
+
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->oper_push_cache_lock);
+
     return err_info;
 }
 
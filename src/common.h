@@ -24,6 +24,10 @@
 #include "shm_types.h"
 #include "sysrepo_types.h"
 
+#ifdef SR_TRACEPOINTS
+# include <sys/sdt.h>
+#endif
+
 struct lysp_submodule;
 struct sr_ds_handle;
 struct sr_mod_info_s;
@@ -31,6 +35,16 @@ struct sr_mod_info_mod_s;
 struct srplg_ds_s;
 struct srplg_ntf_s;
 
+/**
+ * @brief Static tracepoint (USDT probe) of the "sysrepo" provider, compiled-out unless
+ * sysrepo is built with tracepoints, when @p probe can be attached to by bpftrace or perf.
+ */
+#ifdef SR_TRACEPOINTS
+# define SR_TRACE(probe, ...) STAP_PROBEV(sysrepo, probe, __VA_ARGS__)
+#else
+# define SR_TRACE(probe, ...)
+#endif
+
 /** macro for mutex align check */
 #define SR_MUTEX_ALIGN_CHECK(mutex) ((uintptr_t)mutex % sizeof(void *))
 
@@ -61,24 +75,82 @@ struct srplg_ntf_s;
 /** all ext SHM item sizes will be aligned to this number; also represents the allocation unit (B) */
 #define SR_SHM_MEM_ALIGN 8
 
+/** minimal size of a subscription data SHM, it is always resized to a power of 2 multiple of this size (B) */
+#define SR_SUB_DATA_SHM_MIN_SIZE 4096
+
+/** SHM segments at least this large are mapped with the options of ::SR_SHM_MAP_ENV (B) */
+#define SR_SHM_MAP_LARGE_SIZE (2 * 1024 * 1024)
+
+/** number of the most recent notifications of a module kept in its replay ring SHM */
+#define SR_REPLAY_RING_SIZE 128
+
+/** size of a replay ring SHM slot, larger notifications are never kept in the ring (B) */
+#define SR_REPLAY_RING_SLOT_SIZE 2048
+
+/** subscription data SHM is shrunk only if its size is at least this many times bigger than required */
+#define SR_SUB_DATA_SHM_SHRINK_RATIO 8
+
 /** timeout for locking subscription structure lock, should be enough for a single ::sr_process_events() call (ms) */
 #define SR_SUBSCR_LOCK_TIMEOUT 30000
 
+/** default number of worker threads of the shared connection event loop */
+#define SR_EVLOOP_DFLT_WORKER_COUNT 2
+
+/** number of worker threads sending asynchronous RPCs/actions of a connection */
+#define SR_RPC_ASYNC_WORKER_COUNT 4
+
+/** subscription worker task types */
+#define SR_SUB_TASK_CHANGE 1
+#define SR_SUB_TASK_OPER_GET 2
+#define SR_SUB_TASK_RPC 3
+
+/** subscription worker task states, a task queued while it is running is processed again */
+#define SR_SUB_TASK_QUEUED 0x01
+#define SR_SUB_TASK_RUNNING 0x02
+
+/** kinds of events written into an event pipe by the notifier so that only those subscriptions are processed,
+ * an event pipe byte with no kind set (::SR_EVPIPE_EV_ANY) means all of them */
+#define SR_EVPIPE_EV_ANY 0x00
+#define SR_EVPIPE_EV_CHANGE 0x01
+#define SR_EVPIPE_EV_OPER_GET 0x02
+#define SR_EVPIPE_EV_RPC 0x04
+#define SR_EVPIPE_EV_NOTIF 0x08
+#define SR_EVPIPE_EV_OPER_POLL 0x10
+#define SR_EVPIPE_EV_ALL 0xFF
+
 /** timeout for locking context; should be enough for changing it (ms) */
 #define SR_CONTEXT_LOCK_TIMEOUT 10000
 
 /** timeout for locking notification buffer lock, used when adding (including dup)/removing notifications (ms) */
 #define SR_NOTIF_BUF_LOCK_TIMEOUT 500
 
+/** timeout for locking commit buffer of a session; maximum time the buffered edits are accessed (ms) */
+#define SR_COMMIT_BUF_LOCK_TIMEOUT 500
+
+/** timeout for locking asynchronous RPC/action request queue of a connection (ms) */
+#define SR_RPC_ASYNC_LOCK_TIMEOUT 500
+
 /** timeout for locking subscription SHM; maximum time an event handling should take (ms) */
 #define SR_SUBSHM_LOCK_TIMEOUT 10000
 
+/** default size of the ring of notifications in notification sub data SHM, grows only for larger notifications */
+#define SR_NOTIF_RING_SIZE 262144
+
+/** interval of rechecking the notification ring and its subscriptions while waiting for the subscribers (ms) */
+#define SR_NOTIF_RING_WAIT_STEP 10
+
 /** timeout for locking ext SHM lock; time that truncating, writing into SHM but even recovering may take (ms) */
 #define SR_EXT_LOCK_TIMEOUT 500
 
 /** timeout for locking the local connection list; maximum time the list can be accessed (ms) */
 #define SR_CONN_LIST_LOCK_TIMEOUT 100
 
+/** number of recent foreign connection liveness check results remembered by a process */
+#define SR_CONN_ALIVE_CACHE_SIZE 64
+
+/** validity of a remembered foreign connection liveness check result (ms) */
+#define SR_CONN_ALIVE_CACHE_TIMEOUT 50
+
 /** timeout for locking connection remap lock; maximum time it can be continuously read/written to (ms) */
 #define SR_CONN_REMAP_LOCK_TIMEOUT 10000
 
@@ -91,6 +163,36 @@ struct srplg_ntf_s;
 /** timeout for write-locking connection subscription oper cache data (ms) */
 #define SR_CONN_OPER_CACHE_DATA_LOCK_TIMEOUT 1000
 
+/** timeout for locking connection stored operational data cache, held while the data are loaded (ms) */
+#define SR_CONN_OPER_PUSH_CACHE_LOCK_TIMEOUT 5000
+
+/** timeout for locking the operational view cache of a connection (ms) */
+#define SR_CONN_OPER_VIEW_LOCK_TIMEOUT 5000
+
+/** timeout for locking connection change event diff cache, held only while the cache is accessed (ms) */
+#define SR_CONN_CHANGE_DIFF_CACHE_LOCK_TIMEOUT 100
+
+/** timeout for locking connection replay ring cache, held only while the cache is accessed (ms) */
+#define SR_CONN_REPLAY_RING_CACHE_LOCK_TIMEOUT 100
+
+/** timeout for locking connection yang-library data cache, held while the data are generated (ms) */
+#define SR_CONN_YANGLIB_CACHE_LOCK_TIMEOUT 1000
+
+/** timeout for locking connection read-only data cache, held only while the cache is accessed (ms) */
+#define SR_CONN_RO_DATA_CACHE_LOCK_TIMEOUT 100
+
+/** maximum number of read-only get results cached in a connection */
+#define SR_CONN_RO_DATA_CACHE_SIZE 16
+
+/** timeout for locking connection XPath modules cache, held only while the cache is accessed (ms) */
+#define SR_CONN_XPATH_MODS_CACHE_LOCK_TIMEOUT 100
+
+/** maximum number of XPaths with their required modules cached in a connection */
+#define SR_CONN_XPATH_MODS_CACHE_SIZE 512
+
+/** timeout for locking connection instance-identifier dependency cache, held only while the cache is accessed (ms) */
+#define SR_CONN_INSTID_CACHE_LOCK_TIMEOUT 100
+
 /** timeout for accessing stored connection ext data (duplication) (ms) */
 #define SR_CONN_EXT_DATA_LOCK_TIMEOUT 100
 
@@ -100,9 +202,6 @@ struct srplg_ntf_s;
 /** timeout for locking DS lock mutex of a module; is held only when accessing the DS lock information (ms) */
 #define SR_DS_LOCK_MUTEX_TIMEOUT 100
 
-/** timeout step when waiting for a DS lock (ms) */
-#define SR_DS_LOCK_TIMEOUT_STEP 50
-
 /** timeout for locking SHM module/RPC subscriptions; maxmum time full event processing may take (ms) */
 #define SR_SHMEXT_SUB_LOCK_TIMEOUT 15000
 
@@ -112,6 +211,10 @@ struct srplg_ntf_s;
 /** default timeout for operational subscription callback (ms) */
 #define SR_OPER_CB_TIMEOUT 5000
 
+/** maximum time operational poll cached data are refreshed in advance, before they become invalid, is limited to
+ * a quarter of their validity period (ms) */
+#define SR_OPER_POLL_PREFETCH_TIMEOUT 500
+
 /** default timeout for RPC/action subscription callback (ms) */
 #define SR_RPC_CB_TIMEOUT 2000
 
@@ -133,9 +236,24 @@ struct srplg_ntf_s;
 /** permissions of all event pipes (only owner read, anyone else write */
 #define SR_EVPIPE_PERM 00622
 
+/** maximum number of event pipes kept opened for writing by a process */
+#define SR_EVPIPE_CACHE_SIZE 64
+
+/** number of messages in the asynchronous logging ring, must be a power of 2 */
+#define SR_LOG_ASYNC_RING_SIZE 4096
+
+/** maximum time the asynchronous logging writer thread waits before checking for new messages (ms) */
+#define SR_LOG_ASYNC_WAIT_MS 100
+
 /** initial length of message buffer (B) */
 #define SR_MSG_LEN_START 128
 
+/** expected length of strings of a single value stored in a values memory block (B), only a size hint */
+#define SR_VALS_BLOCK_STR_LEN 128
+
+/** suffix of the LYB cache file stored next to the startup "sysrepo" module data */
+#define SR_LYDMODS_LYB_SUFFIX ".lyb"
+
 /** default operational origin for operational data (push/pull) */
 #define SR_OPER_ORIGIN "ietf-origin:unknown"
 
@@ -415,6 +533,14 @@ sr_error_info_t *sr_path_mod_shm(char **path);
  */
 sr_error_info_t *sr_path_ext_shm(char **path);
 
+/**
+ * @brief Get global SHM prefix prepended to all SHM files.
+ *
+ * @param[out] prefix SHM prefix to use.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shm_prefix(const char **prefix);
+
 /**
  * @brief Get the path to a subscription SHM.
  *
@@ -437,6 +563,34 @@ sr_error_info_t *sr_path_sub_shm(const char *mod_name, const char *suffix1, int6
  */
 sr_error_info_t *sr_path_sub_data_shm(const char *mod_name, const char *suffix1, int64_t suffix2, char **path);
 
+/**
+ * @brief Get the path to a running data snapshot SHM.
+ *
+ * @param[in] mod_name Module name.
+ * @param[out] path Created path.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_path_run_snapshot_shm(const char *mod_name, char **path);
+
+/**
+ * @brief Get the path to a replay ring SHM.
+ *
+ * @param[in] mod_name Module name.
+ * @param[out] path Created path.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_path_replay_ring_shm(const char *mod_name, char **path);
+
+/**
+ * @brief Get the path to a shared operational poll cache SHM.
+ *
+ * @param[in] mod_name Module name.
+ * @param[in] xpath Oper poll subscription XPath.
+ * @param[out] path Created path.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_path_oper_poll_shm(const char *mod_name, const char *xpath, char **path);
+
 /**
  * @brief Get the path to an event pipe.
  *
@@ -561,6 +715,32 @@ struct timespec sr_time_sub(const struct timespec *ts1, const struct timespec *t
  */
 int sr_time_sub_ms(const struct timespec *ts1, const struct timespec *ts2);
 
+/**
+ * @brief Subtract a timespec from another in microseconds.
+ *
+ * @param[in] ts1 First timespec to be subtracted from.
+ * @param[in] ts2 Second timespec to subtract.
+ * @return Result of @p ts1 - @p ts2, at most UINT32_MAX.
+ * @return 0 microseconds if @p ts1 < @p ts2.
+ */
+uint32_t sr_time_sub_us(const struct timespec *ts1, const struct timespec *ts2);
+
+/**
+ * @brief Atomically update a maximum, if a value is larger.
+ *
+ * @param[in,out] max Maximum to update.
+ * @param[in] value Value to use.
+ */
+void sr_atomic_max_update(ATOMIC_T *max, uint32_t value);
+
+/**
+ * @brief Add a duration into latency statistics.
+ *
+ * @param[in] stats Statistics to update.
+ * @param[in] usec Duration in usec.
+ */
+void sr_latency_stats_add(sr_latency_stats_t *stats, uint32_t usec);
+
 /**
  * @brief Remap and possibly resize a SHM. Needs WRITE lock for resizing,
  * otherwise READ lock is fine.
@@ -579,7 +759,7 @@ sr_error_info_t *sr_shm_remap(sr_shm_t *shm, size_t new_shm_size);
 void sr_shm_clear(sr_shm_t *shm);
 
 /**
- * @brief Get the next ext SHM memory hole.
+ * @brief Get the next ext SHM memory hole. Holes are returned by their size class and then by their offset.
  *
  * @param[in] last Last returned hole, NULL on first call.
  * @param[in] ext_shm Ext SHM.
@@ -590,6 +770,8 @@ sr_ext_hole_t *sr_ext_hole_next(sr_ext_hole_t *last, sr_ext_shm_t *ext_shm);
 /**
  * @brief Find an existing hole.
  *
+ * Without @p off, the first fitting hole of the size class of @p min_size or any hole of a larger class is returned.
+ *
  * @param[in] ext_shm Ext SHM.
  * @param[in] off Optional offset of the hole.
  * @param[in] min_size Minimum matching hole size.
@@ -606,12 +788,11 @@ sr_ext_hole_t *sr_ext_hole_find(sr_ext_shm_t *ext_shm, uint32_t off, uint32_t mi
 void sr_ext_hole_del(sr_ext_shm_t *ext_shm, sr_ext_hole_t *hole);
 
 /**
- * @brief Add a new hole.
+ * @brief Add a new hole, it is merged with any adjacent holes.
  *
  * @param[in] ext_shm Ext SHM.
  * @param[in] off Offset of the new hole.
  * @param[in] size Size of the new hole.
- * @return First suitable hole, NULL if none found.
  */
 void sr_ext_hole_add(sr_ext_shm_t *ext_shm, uint32_t off, uint32_t size);
 
@@ -753,6 +934,56 @@ sr_error_info_t *sr_mlock(pthread_mutex_t *lock, int timeout_ms, const char *fun
  */
 void sr_munlock(pthread_mutex_t *lock);
 
+/**
+ * @brief Duplicate thread attributes.
+ *
+ * @param[in] attr Thread attributes to duplicate.
+ * @param[out] dup Duplicated attributes.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_thread_attr_dup(const sr_thread_attr_t *attr, sr_thread_attr_t **dup);
+
+/**
+ * @brief Free duplicated thread attributes.
+ *
+ * @param[in] attr Thread attributes to free.
+ */
+void sr_thread_attr_free(sr_thread_attr_t *attr);
+
+/**
+ * @brief Create a new thread with specific attributes.
+ *
+ * @param[out] tid Created thread ID.
+ * @param[in] attr Optional thread attributes.
+ * @param[in] start_routine Thread routine.
+ * @param[in] arg Thread routine argument.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_thread_create(pthread_t *tid, const sr_thread_attr_t *attr, void *(*start_routine)(void *),
+        void *arg);
+
+/**
+ * @brief Create a new thread with the attributes set for the thread type in a connection.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] type Thread type.
+ * @param[out] tid Created thread ID.
+ * @param[in] start_routine Thread routine.
+ * @param[in] arg Thread routine argument.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_conn_thread_create(sr_conn_ctx_t *conn, sr_thread_type_t type, pthread_t *tid,
+        void *(*start_routine)(void *), void *arg);
+
+/**
+ * @brief Apply CPU affinity, scheduling, and name of thread attributes to a running thread.
+ *
+ * @param[in] tid Thread ID.
+ * @param[in] attr Thread attributes to apply.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_thread_attr_apply(pthread_t tid, const sr_thread_attr_t *attr);
+
 /**
  * @brief Initialize a sysrepo RW lock.
  *
@@ -800,6 +1031,23 @@ sr_error_info_t *sr_sub_rwlock(sr_rwlock_t *rwlock, struct timespec *timeout_abs
 sr_error_info_t *sr_rwlock(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, sr_cid_t cid, const char *func,
         sr_lock_recover_cb cb, void *cb_data);
 
+/**
+ * @brief Lock a sysrepo RW lock with a priority. A READ-UPGR lock is granted only once there are no READ-UPGR lock
+ * waiters with a higher priority. On failure, the lock is not changed in any way.
+ *
+ * @param[in] rwlock RW lock to lock.
+ * @param[in] timeout_ms Timeout in ms for locking.
+ * @param[in] mode Lock mode to set.
+ * @param[in] prio Priority of the lock, up to ::SR_COMMIT_PRIO_MAX, used only for ::SR_LOCK_READ_UPGR.
+ * @param[in] cid Lock owner connection ID.
+ * @param[in] func Name of the calling function for logging.
+ * @param[in] cb Optional callback called when recovering locks. When calling it, WRITE lock is always held.
+ * @param[in] cb_data Arbitrary user data for @p cb.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_rwlock_prio(sr_rwlock_t *rwlock, int timeout_ms, sr_lock_mode_t mode, uint32_t prio, sr_cid_t cid,
+        const char *func, sr_lock_recover_cb cb, void *cb_data);
+
 /**
  * @brief Relock a sysrepo RW lock (upgrade or downgrade). On failure, the lock is not changed in any way.
  *
@@ -864,6 +1112,79 @@ sr_error_info_t *sr_conn_oper_cache_add(sr_conn_ctx_t *conn, uint32_t sub_id, co
  */
 void sr_conn_oper_cache_del(sr_conn_ctx_t *conn, uint32_t sub_id);
 
+/**
+ * @brief Store running data of a module into its snapshot SHM to be shared by all the processes.
+ *
+ * Failing to store the snapshot is not an error, the data are then loaded from the DS plugin.
+ *
+ * @param[in] ly_mod libyang module.
+ * @param[in] ds_plg Running datastore plugin of @p ly_mod.
+ * @param[in] content_id Context content ID.
+ * @param[in] run_data_ver Module running data version of @p mod_data.
+ * @param[in] mod_data Current running data of @p ly_mod.
+ */
+void sr_run_snapshot_store(const struct lys_module *ly_mod, const struct srplg_ds_s *ds_plg, uint32_t content_id,
+        uint32_t run_data_ver, const struct lyd_node *mod_data);
+
+/**
+ * @brief Load running data of a module from its snapshot SHM, if it exists and is current.
+ *
+ * @param[in] ly_mod libyang module.
+ * @param[in] content_id Context content ID.
+ * @param[in] run_data_ver Current module running data version.
+ * @param[in,out] data Data tree to append to.
+ * @return Whether the data were loaded from the snapshot.
+ */
+int sr_run_snapshot_load(const struct lys_module *ly_mod, uint32_t content_id, uint32_t run_data_ver,
+        struct lyd_node **data);
+
+/**
+ * @brief Remove the running data snapshot SHM of a module.
+ *
+ * @param[in] mod_name Module name.
+ */
+void sr_run_snapshot_remove(const char *mod_name);
+
+/**
+ * @brief Store operational poll cached data into the shared SHM to be used by all the processes.
+ *
+ * Failing to store the data is not an error, other processes then get the data from the oper get subscription.
+ *
+ * @param[in] ly_mod libyang module.
+ * @param[in] ds_plg Operational datastore plugin of @p ly_mod.
+ * @param[in] xpath Oper poll subscription XPath.
+ * @param[in] cid Connection ID of the oper poll subscription.
+ * @param[in] content_id Context content ID.
+ * @param[in] valid_ms Validity period of @p data.
+ * @param[in] timestamp Realtime timestamp of @p data retrieval.
+ * @param[in] data Cached data.
+ */
+void sr_oper_poll_shm_store(const struct lys_module *ly_mod, const struct srplg_ds_s *ds_plg, const char *xpath,
+        sr_cid_t cid, uint32_t content_id, uint32_t valid_ms, const struct timespec *timestamp,
+        const struct lyd_node *data);
+
+/**
+ * @brief Load operational poll cached data from the shared SHM, if it exists and the data are still valid.
+ *
+ * @param[in] ly_mod libyang module.
+ * @param[in] xpath Oper poll subscription XPath.
+ * @param[in] content_id Context content ID.
+ * @param[out] data Loaded cached data, may be NULL if there are none.
+ * @param[out] timestamp Optional realtime timestamp of @p data retrieval.
+ * @return Whether the data were loaded.
+ */
+int sr_oper_poll_shm_load(const struct lys_module *ly_mod, const char *xpath, uint32_t content_id,
+        struct lyd_node **data, struct timespec *timestamp);
+
+/**
+ * @brief Remove the shared operational poll cache SHM, if stored by a connection.
+ *
+ * @param[in] mod_name Module name.
+ * @param[in] xpath Oper poll subscription XPath.
+ * @param[in] cid Connection ID of the oper poll subscription.
+ */
+void sr_oper_poll_shm_remove(const char *mod_name, const char *xpath, sr_cid_t cid);
+
 /**
  * @brief Update cached running data of a connection.
  *
@@ -881,6 +1202,227 @@ sr_error_info_t *sr_conn_run_cache_update(sr_conn_ctx_t *conn, const struct sr_m
  */
 void sr_conn_run_cache_flush(sr_conn_ctx_t *conn);
 
+/**
+ * @brief Flush all cached stored operational data of a connection.
+ *
+ * @param[in] conn Connection to use.
+ */
+void sr_conn_oper_push_cache_flush(sr_conn_ctx_t *conn);
+
+/**
+ * @brief Flush all cached operational views of a connection.
+ *
+ * @param[in] conn Connection to use.
+ */
+void sr_conn_oper_view_flush(sr_conn_ctx_t *conn);
+
+/**
+ * @brief Take a cached parsed diff of a change event out of the connection cache. Any cached diff of the module
+ * and datastore is removed from the cache.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mod_name Module name of the event.
+ * @param[in] ds Datastore of the event.
+ * @param[in] request_id Request ID of the event.
+ * @param[in] diff_lyb Diff of the event in LYB format.
+ * @param[in] diff_lyb_len Length of @p diff_lyb.
+ * @param[out] diff Cached parsed diff, NULL if not cached.
+ * @param[out] cache_lyb Cached diff in LYB format, NULL if not cached.
+ */
+void sr_conn_change_diff_cache_take(sr_conn_ctx_t *conn, const char *mod_name, sr_datastore_t ds, uint32_t request_id,
+        const char *diff_lyb, uint32_t diff_lyb_len, struct lyd_node **diff, char **cache_lyb);
+
+/**
+ * @brief Store a parsed diff of a change event into the connection cache so that it can be reused by the next event
+ * of the same request.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mod_name Module name of the event.
+ * @param[in] ds Datastore of the event.
+ * @param[in] request_id Request ID of the event.
+ * @param[in] diff_lyb Diff of the event in LYB format, is spent.
+ * @param[in] diff_lyb_len Length of @p diff_lyb.
+ * @param[in] diff Parsed diff, is spent.
+ */
+void sr_conn_change_diff_cache_store(sr_conn_ctx_t *conn, const char *mod_name, sr_datastore_t ds, uint32_t request_id,
+        char *diff_lyb, uint32_t diff_lyb_len, struct lyd_node *diff);
+
+/**
+ * @brief Flush all cached change event diffs of a connection.
+ *
+ * @param[in] conn Connection to use.
+ */
+void sr_conn_change_diff_cache_flush(sr_conn_ctx_t *conn);
+
+/**
+ * @brief Get a shared read-only get result from the connection cache. The running data cache must be READ locked.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] xpath Get XPath.
+ * @param[in] nacm_user NACM user of the session, if any.
+ * @param[in] nacm_gen NACM configuration generation, used only if @p nacm_user is set.
+ * @param[in] max_depth Get maximum depth.
+ * @param[in] opts Get options.
+ * @return Shared result with a new reference, NULL if not cached.
+ */
+sr_data_t *sr_conn_ro_data_cache_get(sr_conn_ctx_t *conn, const char *xpath, const char *nacm_user, uint32_t nacm_gen,
+        uint32_t max_depth, uint32_t opts);
+
+/**
+ * @brief Store a get result into the connection cache so that it can be shared with other read-only results.
+ * The running data cache must be READ locked.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] xpath Get XPath.
+ * @param[in] nacm_user NACM user of the session, if any.
+ * @param[in] nacm_gen NACM configuration generation @p data were filtered with, used only if @p nacm_user is set.
+ * @param[in] max_depth Get maximum depth.
+ * @param[in] opts Get options.
+ * @param[in] data Get result, its reference is held by the caller if it is stored.
+ */
+void sr_conn_ro_data_cache_store(sr_conn_ctx_t *conn, const char *xpath, const char *nacm_user, uint32_t nacm_gen,
+        uint32_t max_depth, uint32_t opts, sr_data_t *data);
+
+/**
+ * @brief Release a reference of a shared read-only get result.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] data Get result to release.
+ * @return 1 if @p data is a shared result and its reference was released;
+ * @return 0 if @p data is not shared and should be freed.
+ */
+int sr_conn_ro_data_cache_release(sr_conn_ctx_t *conn, const sr_data_t *data);
+
+/**
+ * @brief Get a shared read-only get result printed in a format from the connection cache.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] data Get result.
+ * @param[in] format Print format.
+ * @param[in] print_opts Print options.
+ * @param[out] str Copy of the printed result, NULL if not cached.
+ * @param[out] len Length of @p str.
+ * @return Whether the printed result was cached.
+ */
+int sr_conn_ro_data_cache_printed_get(sr_conn_ctx_t *conn, const sr_data_t *data, LYD_FORMAT format, uint32_t print_opts,
+        char **str, size_t *len);
+
+/**
+ * @brief Store a printed shared read-only get result into the connection cache, if @p data are shared.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] data Get result.
+ * @param[in] format Print format.
+ * @param[in] print_opts Print options.
+ * @param[in] str Printed result.
+ * @param[in] len Length of @p str.
+ */
+void sr_conn_ro_data_cache_printed_store(sr_conn_ctx_t *conn, const sr_data_t *data, LYD_FORMAT format,
+        uint32_t print_opts, const char *str, size_t len);
+
+/**
+ * @brief Flush all the shared read-only get results of a connection.
+ *
+ * @param[in] conn Connection to use.
+ */
+void sr_conn_ro_data_cache_flush(sr_conn_ctx_t *conn);
+
+/**
+ * @brief Get modules required by an XPath from the connection cache.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] xpath Collected XPath.
+ * @param[in] ds Datastore of the collected modules.
+ * @param[out] ly_mods Array of the cached modules, NULL if there are none.
+ * @param[out] ly_mod_count Count of @p ly_mods.
+ * @return Whether the modules of @p xpath were cached.
+ */
+int sr_conn_xpath_mods_cache_get(sr_conn_ctx_t *conn, const char *xpath, sr_datastore_t ds,
+        const struct lys_module ***ly_mods, uint32_t *ly_mod_count);
+
+/**
+ * @brief Store modules required by an XPath into the connection cache.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] xpath Collected XPath.
+ * @param[in] ds Datastore of the collected modules.
+ * @param[in] ly_mods Array of the collected modules, is spent.
+ * @param[in] ly_mod_count Count of @p ly_mods.
+ */
+void sr_conn_xpath_mods_cache_store(sr_conn_ctx_t *conn, const char *xpath, sr_datastore_t ds,
+        const struct lys_module **ly_mods, uint32_t ly_mod_count);
+
+/**
+ * @brief Flush all the cached XPath modules of a connection.
+ *
+ * @param[in] conn Connection to use.
+ */
+void sr_conn_xpath_mods_cache_flush(sr_conn_ctx_t *conn);
+
+/**
+ * @brief Add cached modules targeted by running instance-identifiers into mod info.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] ly_mod Module with the instance-identifiers.
+ * @param[in] source_path Path of the instance-identifier nodes.
+ * @param[in] run_data_ver Module running data version the targets must be collected from.
+ * @param[in,out] mod_info Mod info to add to.
+ * @param[out] err_info Error info, if any.
+ * @return Whether the targets were cached.
+ */
+int sr_conn_instid_cache_get(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, const char *source_path,
+        uint32_t run_data_ver, struct sr_mod_info_s *mod_info, sr_error_info_t **err_info);
+
+/**
+ * @brief Store modules targeted by running instance-identifiers into the connection cache.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] ly_mod Module with the instance-identifiers.
+ * @param[in] source_path Path of the instance-identifier nodes.
+ * @param[in] run_data_ver Module running data version the targets were collected from.
+ * @param[in] targets Array of targets, is spent.
+ * @param[in] target_count Count of @p targets.
+ */
+void sr_conn_instid_cache_store(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, const char *source_path,
+        uint32_t run_data_ver, struct sr_instid_cache_target_s *targets, uint32_t target_count);
+
+/**
+ * @brief Update cached instance-identifier targets of a module after its new running data were stored.
+ *
+ * Targets not affected by the stored diff remain valid for the new data version, the rest are removed.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] ly_mod Module whose data were stored.
+ * @param[in] mod_diff Stored diff of the module.
+ * @param[in] prev_run_data_ver Previous module running data version.
+ * @param[in] run_data_ver New module running data version.
+ */
+void sr_conn_instid_cache_update(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, const struct lyd_node *mod_diff,
+        uint32_t prev_run_data_ver, uint32_t run_data_ver);
+
+/**
+ * @brief Flush all the cached instance-identifier targets of a connection.
+ *
+ * @param[in] conn Connection to use.
+ */
+void sr_conn_instid_cache_flush(sr_conn_ctx_t *conn);
+
+/**
+ * @brief Check whether a diff changes any instance-identifier nodes.
+ *
+ * @param[in] diff Diff to check.
+ * @param[in] source_path Path of the instance-identifier nodes.
+ * @return Whether the nodes are changed, also returned on error.
+ */
+int sr_instid_diff_changed(const struct lyd_node *diff, const char *source_path);
+
+/**
+ * @brief Flush the cached yang-library data of a connection.
+ *
+ * @param[in] conn Connection to use.
+ */
+void sr_conn_yanglib_cache_flush(sr_conn_ctx_t *conn);
+
 /**
  * @brief Switch the context of a connection while correctly handling all connection data in the context.
  *
@@ -1059,6 +1601,54 @@ sr_event_t sr_ev2api(sr_sub_event_t ev);
  */
 sr_error_info_t *sr_val_ly2sr(const struct lyd_node *node, sr_val_t *sr_val);
 
+/**
+ * @brief Transform the value of a libyang node into sysrepo value without any allocations.
+ *
+ * The xpath and origin are not set and the string values point to the libyang canonical values.
+ *
+ * @param[in] node libyang node to transform, cannot be anyxml/anydata.
+ * @param[out] sr_val sysrepo value.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_val_ly2sr_data(const struct lyd_node *node, sr_val_t *sr_val);
+
+/**
+ * @brief Check whether a sysrepo value type has a string value.
+ *
+ * @param[in] type Value type.
+ * @return Whether the value is stored in sr_val_data_t.string_val.
+ */
+int sr_val_type_is_str(sr_val_type_t type);
+
+/**
+ * @brief Transform libyang nodes into sysrepo values stored in a single memory block.
+ *
+ * All the strings of the values are stored in the same allocation right after the values array, which is preceded
+ * by a header identifying the block so that it is recognized and freed at once by ::sr_free_values().
+ *
+ * @param[in] set Set of libyang nodes to transform.
+ * @param[out] values Array of sysrepo values, NULL if @p set is empty.
+ * @param[out] value_cnt Count of @p values.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_vals_ly2sr_block(const struct ly_set *set, sr_val_t **values, size_t *value_cnt);
+
+/**
+ * @brief Check whether sysrepo values are stored in a single memory block created by ::sr_vals_ly2sr_block().
+ *
+ * @param[in] values Array of sysrepo values.
+ * @param[in] count Count of @p values.
+ * @return Whether @p values are the values array of a block.
+ */
+int sr_vals_is_block(const sr_val_t *values, size_t count);
+
+/**
+ * @brief Free sysrepo values stored in a single memory block.
+ *
+ * @param[in] values Values array of the block.
+ */
+void sr_vals_block_free(sr_val_t *values);
+
 /**
  * @brief Transform a sysrepo value into libyang string value.
  *
@@ -1191,6 +1781,24 @@ uint32_t sr_str_hash(const char *str, uint32_t priority);
  */
 sr_error_info_t *sr_xpath_trim_last_node(const char *xpath, char **trim_xpath);
 
+/**
+ * @brief Check whether an XPath is a simple path identifying a single data instance. That is, it consists only of
+ * containers and lists with all their keys in predicates with literal values, in the schema order.
+ *
+ * @param[in] ly_ctx Context to use.
+ * @param[in] xpath XPath to examine.
+ * @return Whether @p xpath is an instance path or not.
+ */
+int sr_xpath_is_instance(const struct ly_ctx *ly_ctx, const char *xpath);
+
+/**
+ * @brief Check whether an XPath is a plain path consisting only of node names with no predicates or wildcards.
+ *
+ * @param[in] xpath XPath to examine.
+ * @return Whether @p xpath is a plain path or not.
+ */
+int sr_xpath_is_plain_path(const char *xpath);
+
 /**
  * @brief Get the first node (with predicates if any) from an XPath.
  *
@@ -1235,6 +1843,55 @@ sr_error_info_t *sr_xpath_get_text_atoms(const char *xpath, sr_xp_atoms_t **xp_a
  */
 void sr_xpath_atoms_free(sr_xp_atoms_t *xp_atoms);
 
+/**
+ * @brief Get text atoms of a subscription XPath serialized into a single buffer. Every atom is terminated
+ * by a zero byte and the last atom is followed by an empty one.
+ *
+ * @param[in] xpath Subscription XPath to parse.
+ * @param[out] atoms Serialized text atoms, NULL if unknown XPath expr or a union.
+ * @param[out] atoms_len Length of @p atoms including all the terminating zero bytes.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_xpath_get_sub_atoms(const char *xpath, char **atoms, size_t *atoms_len);
+
+/**
+ * @brief Get the length of serialized subscription XPath text atoms.
+ *
+ * @param[in] atoms Serialized text atoms.
+ * @return Length of @p atoms including all the terminating zero bytes.
+ */
+size_t sr_xpath_sub_atoms_len(const char *atoms);
+
+/**
+ * @brief Compile a subscription XPath filter. Only simple paths of qualified node names are compiled,
+ * other XPaths are left to be evaluated.
+ *
+ * @param[in] xpath Subscription XPath, may be NULL.
+ * @param[out] filter Compiled filter, with no steps if @p xpath is not a simple path.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_xpath_filter_compile(const char *xpath, sr_xpath_filter_t *filter);
+
+/**
+ * @brief Free members of a compiled subscription XPath filter.
+ *
+ * @param[in] filter Filter to clear.
+ */
+void sr_xpath_filter_clear(sr_xpath_filter_t *filter);
+
+/**
+ * @brief Find all the data nodes matching a subscription XPath filter. The compiled filter is used if possible,
+ * the XPath is evaluated otherwise.
+ *
+ * @param[in] filter Optional compiled filter of @p xpath.
+ * @param[in] xpath Subscription XPath.
+ * @param[in] tree Data tree to search in.
+ * @param[out] set Set of matching nodes.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_xpath_filter_find(const sr_xpath_filter_t *filter, const char *xpath, const struct lyd_node *tree,
+        struct ly_set **set);
+
 /**
  * @brief Check whether an atom (node) is foreign with respect to the expression.
  *
@@ -1280,9 +1937,39 @@ const char *sr_userord_anchor_meta_name(const struct lysc_node *schema);
  */
 struct lyd_node *sr_module_data_unlink(struct lyd_node **data, const struct lys_module *ly_mod);
 
+/**
+ * @brief Load module data by a DS plugin and update the module DS plugin statistics, if ::SR_DS_STATS_ENV is set.
+ *
+ * @param[in] shm_mod Optional SHM module to update the statistics of.
+ * @param[in] ds_plg Datastore plugin.
+ * @param[in] ly_mod libyang module.
+ * @param[in] ds Datastore.
+ * @param[in] xpaths Array of XPaths selecting the required data, NULL for all module data.
+ * @param[in] xpath_count Number of @p xpaths.
+ * @param[out] mod_data Loaded module data.
+ * @return SR_ERR value returned by the plugin.
+ */
+int sr_ds_plugin_load(sr_mod_t *shm_mod, const struct srplg_ds_s *ds_plg, const struct lys_module *ly_mod, sr_datastore_t ds,
+        const char **xpaths, uint32_t xpath_count, struct lyd_node **mod_data);
+
+/**
+ * @brief Store module data by a DS plugin and update the module DS plugin statistics, if ::SR_DS_STATS_ENV is set.
+ *
+ * @param[in] shm_mod Optional SHM module to update the statistics of.
+ * @param[in] ds_plg Datastore plugin.
+ * @param[in] ly_mod libyang module.
+ * @param[in] ds Datastore.
+ * @param[in] mod_diff Module diff.
+ * @param[in] mod_data New module data.
+ * @return SR_ERR value returned by the plugin.
+ */
+int sr_ds_plugin_store(sr_mod_t *shm_mod, const struct srplg_ds_s *ds_plg, const struct lys_module *ly_mod,
+        sr_datastore_t ds, const struct lyd_node *mod_diff, const struct lyd_node *mod_data);
+
 /**
  * @brief Append stored module data to a data tree.
  *
+ * @param[in] shm_mod Optional SHM module to update the DS plugin statistics of.
  * @param[in] ly_mod libyang module.
  * @param[in] ds_plg Datastore plugins of @p ly_mod.
  * @param[in] ds Datastore of the data.
@@ -1291,17 +1978,33 @@ struct lyd_node *sr_module_data_unlink(struct lyd_node **data, const struct lys_
  * @param[in,out] data Data tree to append to.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_module_file_data_append(const struct lys_module *ly_mod, const struct srplg_ds_s *ds_plg[],
-        sr_datastore_t ds, const char **xpaths, uint32_t xpath_count, struct lyd_node **data);
+sr_error_info_t *sr_module_file_data_append(sr_mod_t *shm_mod, const struct lys_module *ly_mod,
+        const struct srplg_ds_s *ds_plg[], sr_datastore_t ds, const char **xpaths, uint32_t xpath_count,
+        struct lyd_node **data);
 
 /**
  * @brief Load operational data (edit) loaded from a SHM for a specific module.
  *
+ * Edit of dead connections is removed. With ::SR_CONN_CACHE_OPER_PUSH the edit is taken from the connection cache,
+ * if current.
+ *
+ * @param[in] conn Connection to use.
  * @param[in] mod Mod info mod.
  * @param[out] edit Loaded edit to return.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_module_file_oper_data_load(struct sr_mod_info_mod_s *mod, struct lyd_node **edit);
+sr_error_info_t *sr_module_file_oper_data_load(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod,
+        struct lyd_node **edit);
+
+/**
+ * @brief Collect all the owner connections of a stored operational edit.
+ *
+ * @param[in] edit Stored operational edit.
+ * @param[out] cids Array of the owner CIDs.
+ * @param[out] cid_count Count of @p cids.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_oper_edit_owners(struct lyd_node *edit, sr_cid_t **cids, uint32_t *cid_count);
 
 /**
  * @brief Learn CIDs and PIDs of all the live connections.
@@ -20,6 +20,7 @@
 #define _GNU_SOURCE
 
 #include <pthread.h>
+#include <sys/types.h>
 #include <time.h>
 
 #include <libyang/libyang.h>
@@ -48,8 +49,17 @@ typedef enum {
     SR_LOCK_WRITE_URGE          /**< Write lock with priority forcing next readers to wait. */
 } sr_lock_mode_t;
 
-/** maximum number of system-wide concurrent connection owners of a read lock */
-#define SR_RWLOCK_READ_LIMIT 10
+/**
+ * @brief Sysrepo read-write lock statistics of a lock mode, collected only by processes with ::SR_LOCK_STATS_ENV set.
+ */
+typedef struct {
+    ATOMIC64_T lock_count;          /**< Number of acquired locks. */
+    ATOMIC64_T wait_count;          /**< Number of acquired locks that had to wait for the lock to be released. */
+    ATOMIC64_T wait_usec;           /**< Total time spent acquiring the locks in usec. */
+    ATOMIC_T wait_max_usec;         /**< Longest time spent acquiring a lock in usec. */
+    ATOMIC64_T hold_usec;           /**< Total time the lock was held in usec. */
+    ATOMIC_T hold_max_usec;         /**< Longest time the lock was held in usec. */
+} sr_rwlock_stats_t;
 
 /**
  * @brief Sysrepo read-write lock.
@@ -63,6 +73,15 @@ typedef struct {
     uint8_t read_count[SR_RWLOCK_READ_LIMIT];   /**< Number of recursive read locks of the connection in readers. */
     sr_cid_t upgr;                  /**< CID of the READ-UPGR lock owner if locked, 0 otherwise. */
     sr_cid_t writer;                /**< CID of the WRITE lock owner if locked, 0 otherwise. */
+    sr_cid_t upgr_wait[SR_RWLOCK_READ_LIMIT];   /**< CIDs of READ-UPGR lock waiters with a non-default priority, 0s
+                                                     otherwise. */
+    uint8_t upgr_wait_prio[SR_RWLOCK_READ_LIMIT];   /**< Priorities of the READ-UPGR lock waiters in upgr_wait. */
+
+    struct timespec read_ts;        /**< Time the first of the current readers locked, if measured. */
+    struct timespec write_ts;       /**< Time the current WRITE lock owner locked, if measured. */
+    sr_rwlock_stats_t stats[2];     /**< Statistics of READ (including READ-UPGR) and WRITE (including WRITE-URGE)
+                                         locks, read hold time spans from the first reader locking to the last one
+                                         unlocking. */
 } sr_rwlock_t;
 
 /**
@@ -94,6 +113,18 @@ typedef struct {
     uint32_t union_count;
 } sr_xp_atoms_t;
 
+/**
+ * @brief Subscription XPath filter compiled into a context-independent path of node names.
+ */
+typedef struct {
+    char *buf;                          /**< Buffer with all the module and node names. */
+    struct {
+        const char *mod_name;           /**< Module name of the node. */
+        const char *name;               /**< Node name. */
+    } *steps;                           /**< Path steps, NULL if the XPath is not a simple path and must be evaluated. */
+    uint32_t step_count;                /**< Path step count. */
+} sr_xpath_filter_t;
+
 /*
  * Private definitions of public declarations
  */
@@ -105,6 +136,9 @@ struct sr_conn_ctx_s {
     struct ly_ctx *ly_ctx;          /**< Libyang context, also available to user. */
     uint32_t content_id;            /**< Connection context content id. */
     sr_conn_options_t opts;         /**< Connection options. */
+    int lazy_ctx;                   /**< Whether the context includes only some modules (::SR_CONN_LAZY_CTX). */
+    char **lazy_mods;               /**< Modules to load into a lazy context, with all their dependencies. */
+    uint32_t lazy_mod_count;        /**< Count of lazy context modules. */
 
     pthread_mutex_t ptr_lock;       /**< Session-shared lock for accessing pointers to sessions. */
     sr_session_ctx_t **sessions;    /**< Array of sessions for this connection. */
@@ -112,6 +146,12 @@ struct sr_conn_ctx_s {
     sr_cid_t cid;                   /**< Globally unique connection ID */
     sr_rwlock_t ly_ext_data_lock;   /**< Session-shared lock for accessing ly_ext_data. */
     struct lyd_node *ly_ext_data;   /**< Data for LY ext data callback set for ly_ctx. */
+    struct {
+        int valid;                  /**< Whether the versions are valid, not if the data may change without them. */
+        uint32_t content_id;        /**< Context content ID. */
+        uint32_t run_data_ver;      /**< Schema-mount module running data version. */
+        uint32_t oper_data_ver;     /**< Schema-mount module stored operational data version. */
+    } ly_ext_data_ver;              /**< Versions of the data LY ext data were created from. */
 
     int create_lock;                /**< Process-shared file lock for creating main/mod/ext SHM. */
     sr_shm_t main_shm;              /**< Main SHM structure. */
@@ -128,11 +168,106 @@ struct sr_conn_ctx_s {
 
     struct lyd_node *run_cache_data;    /**< Cached running data of all the modules. */
     struct sr_run_cache_s {
-        const struct lys_module *mod;   /**< Cached libyang module. */
-        struct timespec ts;         /**< Cached module data timestamp. */
-    } *run_cache_mods;
-    uint32_t run_cache_mod_count;
+        const struct lys_module *mod;   /**< Cached libyang module, NULL if the module data are not cached. */
+        uint32_t run_data_ver;      /**< Cached module running data version. */
+    } *run_cache_mods;              /**< Cached modules indexed by their mod SHM index. */
+    uint32_t run_cache_mod_count;   /**< Size of the run_cache_mods array. */
     sr_rwlock_t run_cache_lock;     /**< Session-shared lock for accessing running data cache. */
+    uint32_t run_cache_gen;         /**< Generation of the running data cache, changed with any cached data change. */
+
+    struct sr_ro_data_cache_s {
+        char *xpath;                /**< Get XPath of the result. */
+        char *nacm_user;            /**< NACM user the result was filtered for, NULL if none. */
+        uint32_t max_depth;         /**< Get maximum depth of the result. */
+        uint32_t opts;              /**< Get options of the result. */
+        uint32_t run_cache_gen;     /**< Running data cache generation the result was created from. */
+        uint32_t nacm_gen;          /**< NACM configuration generation the result was filtered with, if filtered. */
+        sr_data_t *data;            /**< Shared result. */
+        uint32_t refcount;          /**< Number of users holding the result. */
+        struct {
+            uint32_t print_opts;    /**< Print options of the printed result. */
+            char *str;              /**< Printed result, NULL if not printed. */
+            size_t len;             /**< Length of the printed result. */
+        } printed[LYD_LYB + 1];     /**< Result printed in each format (indexed by LYD_FORMAT). */
+    } *ro_data_cache;               /**< Shared read-only get results (::SR_GET_READ_ONLY). */
+    uint32_t ro_data_cache_count;   /**< Count of shared read-only get results. */
+    pthread_mutex_t ro_data_cache_lock; /**< Lock for accessing shared read-only get results. */
+
+    struct sr_xpath_mods_cache_s {
+        char *xpath;                /**< Collected XPath. */
+        uint32_t hash;              /**< Hash of the XPath. */
+        sr_datastore_t ds;          /**< Datastore the modules were collected for. */
+        uint32_t content_id;        /**< Context content ID the modules were collected in. */
+        const struct lys_module **ly_mods;  /**< Collected modules, in the order they were found. */
+        uint32_t ly_mod_count;      /**< Count of collected modules. */
+    } *xpath_mods_cache;            /**< Modules required by recently used XPaths. */
+    uint32_t xpath_mods_cache_count;    /**< Count of XPaths with cached modules. */
+    uint32_t xpath_mods_cache_next; /**< Index of the next XPath to replace if the cache is full. */
+    pthread_mutex_t xpath_mods_cache_lock;  /**< Lock for accessing the XPath modules cache. */
+
+    struct sr_instid_cache_s {
+        const struct lys_module *ly_mod;    /**< Module with the instance-identifiers. */
+        char *source_path;          /**< Path of the instance-identifier nodes. */
+        uint32_t run_data_ver;      /**< Module running data version the targets were collected from. */
+        struct sr_instid_cache_target_s {
+            const struct lys_module *ly_mod;    /**< Target module. */
+            char *xpath;            /**< Target path. */
+        } *targets;                 /**< Modules and paths targeted by the instance-identifiers. */
+        uint32_t target_count;      /**< Count of targets. */
+    } *instid_cache;                /**< Resolved running instance-identifier dependencies. */
+    uint32_t instid_cache_count;    /**< Count of resolved instance-identifier dependencies. */
+    pthread_mutex_t instid_cache_lock;  /**< Lock for accessing the instance-identifier dependency cache. */
+
+    sr_thread_attr_t *thread_attr[SR_THREAD_NOTIF_BUF + 1];  /**< Attributes of created threads (indexed by
+                                                     sr_thread_type_t), NULL for the defaults. */
+    pthread_mutex_t thread_attr_lock;   /**< Lock for accessing the thread attributes. */
+
+    struct sr_oper_push_cache_s {
+        const struct lys_module *mod;   /**< Cached libyang module, NULL if the module edit is not cached. */
+        uint32_t oper_data_ver;     /**< Cached module stored operational data version. */
+        struct lyd_node *edit;      /**< Cached stored operational edit of the module. */
+        sr_cid_t *cids;             /**< Owner connections of the cached edit nodes. */
+        uint32_t cid_count;         /**< Count of owner connections. */
+    } *oper_push_cache_mods;        /**< Cached modules indexed by their mod SHM index. */
+    uint32_t oper_push_cache_mod_count; /**< Size of the oper_push_cache_mods array. */
+    pthread_mutex_t oper_push_cache_lock;   /**< Lock for accessing stored operational data cache. */
+
+    struct sr_oper_view_cache_s {
+        const struct lys_module *mod;   /**< Cached libyang module, NULL if the module view is not cached. */
+        uint32_t run_data_ver;      /**< Module running data version the view was created from. */
+        uint32_t oper_data_ver;     /**< Module stored operational data version the view was created from. */
+        uint32_t run_sub_ver;       /**< Module running change subscriptions version the view was created from. */
+        uint32_t get_oper_opts;     /**< Get oper data options the view was created with. */
+        struct lyd_node *data;      /**< Cached operational view of the module. */
+        sr_cid_t *cids;             /**< Owner connections of the stored operational data in the view. */
+        uint32_t cid_count;         /**< Count of owner connections. */
+    } *oper_view_mods;              /**< Cached module operational views indexed by their mod SHM index. */
+    uint32_t oper_view_mod_count;   /**< Size of the oper_view_mods array. */
+    pthread_mutex_t oper_view_lock; /**< Lock for accessing the operational view cache. */
+
+    struct sr_change_diff_cache_s {
+        char *module_name;          /**< Module of the cached diff. */
+        sr_datastore_t ds;          /**< Datastore of the cached diff. */
+        uint32_t request_id;        /**< Request ID of the change event with the diff. */
+        char *diff_lyb;             /**< Diff in LYB format, as written into sub data SHM. */
+        uint32_t diff_lyb_len;      /**< Length of the LYB diff. */
+        struct lyd_node *diff;      /**< Parsed diff. */
+    } *change_diff_cache;           /**< Parsed diffs of the last change events processed by subscriptions. */
+    uint32_t change_diff_cache_count;   /**< Count of cached change event diffs. */
+    pthread_mutex_t change_diff_cache_lock; /**< Lock for accessing the change event diff cache. */
+
+    struct sr_replay_ring_cache_s {
+        char *mod_name;             /**< Module of the replay ring. */
+        dev_t dev;                  /**< Device of the replay ring SHM file, 0 if there was none. */
+        ino_t ino;                  /**< Inode of the replay ring SHM file, 0 if there was none. */
+        void *ring;                 /**< Replay ring SHM mapped for writing, NULL if it cannot be written. */
+    } *replay_ring_cache;           /**< Replay rings of modules kept mapped for storing notifications. */
+    uint32_t replay_ring_cache_count;   /**< Count of cached replay rings. */
+    pthread_mutex_t replay_ring_cache_lock; /**< Lock for accessing the replay ring cache. */
+
+    struct lyd_node *yanglib_cache; /**< Cached generated ietf-yang-library data, NULL if not cached. */
+    uint32_t yanglib_cache_cid;     /**< Content ID of the context the cached yang-library data were generated for. */
+    pthread_mutex_t yanglib_cache_lock; /**< Lock for accessing the yang-library data cache. */
 
     struct sr_ntf_handle_s {
         void *dl_handle;            /**< Handle from dlopen(3) call. */
@@ -154,6 +289,51 @@ struct sr_conn_ctx_s {
 
     char **oper_push_mods;          /**< Modules whose pushed oper data were modified by this connection. */
     uint32_t oper_push_mod_count;   /**< Count of modules with modified push oper data. */
+
+    struct sr_evloop_s {
+        pthread_mutex_t lock;       /**< Lock for accessing the event loop members. */
+        sr_cond_t cond;             /**< Condition signalled when a worker finishes processing a subscription. */
+        int epoll_fd;               /**< epoll instance of all the handled event pipes, -1 if not started. */
+        int wake_fd;                /**< Event FD for waking up all the workers to quit. */
+        ATOMIC_T running;           /**< Flag whether the workers should keep running. */
+        pthread_t *tids;            /**< Thread IDs of the workers. */
+        uint32_t worker_count;      /**< Number of workers to start or running. */
+        sr_subscription_ctx_t **subs;   /**< Subscriptions handled by the event loop. */
+        uint32_t sub_count;         /**< Count of handled subscriptions. */
+    } evloop;                       /**< Shared event loop for handling subscriptions (::SR_SUBSCR_SHARED_THREAD). */
+
+    struct sr_rpc_async_s {
+        pthread_mutex_t lock;       /**< Lock for accessing the requests. */
+        sr_cond_t cond;             /**< Condition signalling new and finished requests. */
+        pthread_t *tids;            /**< Worker thread IDs, started with the first request. */
+        uint32_t worker_count;      /**< Number of started workers. */
+        int quit;                   /**< Flag for the workers to quit once all the requests are sent. */
+        struct sr_rpc_async_req_s *first;   /**< First queued request. */
+        struct sr_rpc_async_req_s *last;    /**< Last queued request. */
+        uint32_t request_id;        /**< Last assigned request ID. */
+    } rpc_async;                    /**< Asynchronous RPC/action requests (::sr_rpc_send_tree_async()). */
+};
+
+/**
+ * @brief Queued asynchronous RPC/action request.
+ */
+struct sr_rpc_async_req_s {
+    sr_session_ctx_t *session;      /**< Session of the request. */
+    uint32_t request_id;            /**< Request ID. */
+    sr_data_t *input;               /**< RPC/action input, holds the context lock. */
+    uint32_t timeout_ms;            /**< RPC/action callback timeout. */
+    sr_rpc_async_cb cb;             /**< Callback to report the result to. */
+    void *private_data;             /**< Private data of the callback. */
+    struct sr_rpc_async_req_s *next;    /**< Next queued request. */
+};
+
+/**
+ * @brief Sysrepo edit builder.
+ */
+struct sr_edit_builder_s {
+    sr_session_ctx_t *session;      /**< Session of the edit. */
+    sr_data_t *edit;                /**< Built edit, holds the context lock. */
+    struct lyd_node *parent;        /**< Current parent of the added nodes, NULL for top-level nodes. */
 };
 
 /**
@@ -169,12 +349,17 @@ struct sr_session_ctx_s {
 
     char *orig_name;                /**< Originator name used for all events sent on this session. */
     void *orig_data;                /**< Originator data used for all events sent on this session. */
+    uint32_t commit_prio;           /**< Priority of the changes applied by this session. */
+    int ds_locked;                  /**< Whether this session may hold some module DS locks, in any datastore. */
 
     sr_sub_event_t ev;              /**< Event of a callback session. ::SR_SUB_EV_NONE for standard user sessions. */
 
     struct {
         char *orig_name;            /**< Set originator name by the event originator. */
         void *orig_data;            /**< Set originator data by the event originator. */
+        uint32_t oper_max_depth;    /**< Requested maximum depth of operational data, only for ::SR_SUB_EV_OPER. */
+        uint32_t oper_limit;        /**< Requested maximum number of operational subtrees, only for ::SR_SUB_EV_OPER. */
+        sr_get_oper_flag_t oper_opts;   /**< Get oper data options of the request, only for ::SR_SUB_EV_OPER. */
     } ev_data;                      /**< Event data from the originator. Valid only if ev is not ::SR_SUB_EV_NONE. */
     struct {
         char *message;              /**< Event error message. */
@@ -189,6 +374,8 @@ struct sr_session_ctx_s {
     struct {
         sr_data_t *edit;            /**< Prepared edit data tree. */
         struct lyd_node *diff;      /**< Diff data tree, used for module change iterator. */
+        char *change_log;           /**< Change log of the event, used for module change iterator. The diff is built
+                                         from it only if needed. */
     } dt[SR_DS_COUNT];              /**< Session-exclusive prepared changes. */
 
     struct sr_sess_notif_buf {
@@ -203,6 +390,25 @@ struct sr_session_ctx_s {
         } *first;                   /**< First stored notification buffer node. */
         struct sr_sess_notif_buf_node *last;    /**< Last stored notification buffer node. */
     } notif_buf;                    /**< Notification buffering attributes. */
+
+    struct sr_sess_commit_buf {
+        pthread_t tid;              /**< Thread ID of the coalescing thread, 0 if not started. */
+        int thread_running;         /**< Flag whether the coalescing thread of this session should keep running. */
+        pthread_mutex_t lock;       /**< Lock for accessing the commit buffer. */
+        sr_cond_t cond;             /**< Condition signalling new buffered edits and finished commits. */
+        sr_datastore_t ds;          /**< Datastore of the buffered edits. */
+        sr_data_t **edits;          /**< Buffered edits to be committed together, each holding a context READ lock. */
+        uint32_t edit_count;        /**< Buffered edit count. */
+        uint32_t timeout_ms;        /**< Change callback timeout of the commit of the buffered edits. */
+        struct timespec commit_ts;  /**< Time (monotonic) when the buffered edits are committed. */
+        int committing;             /**< Flag whether a coalesced commit is in progress. */
+        sr_error_info_t *err_info;  /**< Error of the coalesced commits not yet returned by ::sr_apply_changes_wait(). */
+        sr_commit_cb cb;            /**< Optional callback called after each coalesced commit. */
+        void *cb_data;              /**< Private data of the callback. */
+    } commit_buf;                   /**< Coalesced commit attributes. */
+
+    uint32_t rpc_async_count;       /**< Count of queued or executing asynchronous RPC/action requests, accessed with
+                                         the connection RPC async lock. */
 };
 
 /**
@@ -213,22 +419,34 @@ struct sr_subscription_ctx_s {
     uint32_t evpipe_num;            /**< Event pipe number of this subscription structure. */
     int evpipe;                     /**< Event pipe opened for reading. */
     ATOMIC_T thread_running;        /**< Flag whether the thread handling this subscription is running. */
-    pthread_t tid;                  /**< Thread ID of the handler thread. */
+    pthread_t tid;                  /**< Thread ID of the handler thread, of the processing worker for shared. */
+    int evloop;                     /**< Whether the subscription is handled by the connection shared event loop. */
+    int evloop_busy;                /**< Whether a shared event loop worker is processing the subscription. */
+    struct timespec evloop_wake_up; /**< Time of the next scheduled event of the subscription for the shared event
+                                         loop, zeroed if none. */
     sr_rwlock_t subs_lock;          /**< Session-shared lock for accessing the subscriptions. */
     uint32_t last_sub_id;           /**< Subscription ID of the last created subscription. */
 
+    struct sr_subscr_workers_s {
+        pthread_mutex_t lock;       /**< Lock for accessing the workers and the task states of the subscriptions. */
+        sr_cond_t cond;             /**< Condition signalling new tasks and replaced workers. */
+        pthread_t *tids;            /**< Current worker thread IDs, any other worker quits. */
+        uint32_t count;             /**< Worker thread count, 0 if all the events are processed sequentially. */
+        uint32_t queued;            /**< Counter changed whenever new tasks may have been queued. */
+    } workers;                      /**< Worker threads processing independent subscriptions in parallel. */
+
     struct modsub_change_s {
         char *module_name;          /**< Module of the subscriptions. */
         sr_datastore_t ds;          /**< Datastore of the subscriptions. */
         struct modsub_changesub_s {
             uint32_t sub_id;        /**< Unique subscription ID. */
             char *xpath;            /**< Subscription XPath. */
+            sr_xpath_filter_t filter;   /**< Compiled subscription XPath filter. */
             uint32_t priority;      /**< Subscription priority. */
             sr_subscr_options_t opts;   /**< Subscription options. */
             sr_module_change_cb cb; /**< Subscription callback. */
             void *private_data;     /**< Subscription callback private data. */
             sr_session_ctx_t *sess; /**< Subscription session. */
-            ATOMIC_T filtered_out;  /**< Number of notifications that were filtered out. */
 
             ATOMIC_T request_id;    /**< Request ID of the last processed request. */
             ATOMIC_T event;         /**< Type of the last processed event. */
@@ -236,6 +454,7 @@ struct sr_subscription_ctx_s {
         uint32_t sub_count;         /**< Configuration change module XPath subscription count. */
 
         sr_shm_t sub_shm;           /**< Subscription SHM. */
+        uint8_t task;               /**< Worker task state, accessed with the workers lock. */
     } *change_subs;                 /**< Change subscriptions for each module. */
     uint32_t change_sub_count;      /**< Change module subscription count. */
 
@@ -253,6 +472,7 @@ struct sr_subscription_ctx_s {
             sr_shm_t sub_shm;       /**< Subscription SHM. */
         } *subs;                    /**< Operational subscriptions for each XPath. */
         uint32_t sub_count;         /**< Operational module XPath subscription count. */
+        uint8_t task;               /**< Worker task state, accessed with the workers lock. */
     } *oper_get_subs;               /**< Operational get subscriptions for each module. */
     uint32_t oper_get_sub_count;    /**< Operational get module subscription count. */
 
@@ -274,6 +494,7 @@ struct sr_subscription_ctx_s {
         struct modsub_notifsub_s {
             uint32_t sub_id;        /**< Unique subscription ID. */
             char *xpath;            /**< Subscription XPath. */
+            sr_xpath_filter_t filter;   /**< Compiled subscription XPath filter. */
             struct timespec listen_since;   /**< Timestamp of the subscription listening for real-time notifications. */
             struct timespec start_time; /**< Subscription start time. */
             int replayed;           /**< Flag whether the subscription replay is finished. */
@@ -309,6 +530,7 @@ struct sr_subscription_ctx_s {
         uint32_t sub_count;         /**< RPC/action XPath subscription count. */
 
         sr_shm_t sub_shm;           /**< Subscription SHM. */
+        uint8_t task;               /**< Worker task state, accessed with the workers lock. */
     } *rpc_subs;                    /**< RPC/action subscriptions for each operation. */
     uint32_t rpc_sub_count;         /**< RPC/action operation subscription count. */
 };
@@ -319,7 +541,23 @@ struct sr_subscription_ctx_s {
 struct sr_change_iter_s {
     struct lyd_node *diff;          /**< Optional copied diff that set items point into. */
     struct ly_set *set;             /**< Set of all the selected diff nodes. */
-    uint32_t idx;                   /**< Index of the next change. */
+    int8_t *opers;                  /**< Precomputed change operations of the set nodes. */
+    uint32_t idx;                   /**< Index of the next change, number of returned changes for the log iterator. */
+    struct sr_change_log_iter_s *log_iter;  /**< Optional change log iterator used instead of the set. */
+    char *xpath;                    /**< XPath selecting the changes of the log iterator. */
+};
+
+/**
+ * @brief Data iterator.
+ */
+struct sr_data_iter_s {
+    sr_session_ctx_t *session;      /**< Session used for getting the data. */
+    uint32_t chunk_size;            /**< Maximum number of subtrees returned at once. */
+    uint32_t max_depth;             /**< Maximum depth of the subtrees. */
+    sr_data_t *data;                /**< Loaded data, keeps the context locked. */
+    struct ly_set *set;             /**< Selected subtrees of the loaded data. */
+    int dup;                        /**< Whether the selected subtrees are duplicates, not in the loaded data. */
+    uint32_t offset;                /**< Index of the next subtree to return. */
 };
 
 /**
@@ -336,6 +574,11 @@ typedef void (*sr_lock_recover_cb)(sr_lock_mode_t mode, sr_cid_t cid, void *data
  */
 extern const struct srplg_ds_s srpds_json;
 
+/**
+ * @brief Internal DS plugin "LYB DS shm".
+ */
+extern const struct srplg_ds_s srpds_shm;
+
 /**
  * @brief Internal notif plugin "JSON notif".
  */
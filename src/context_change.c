@@ -19,6 +19,8 @@
 #include "context_change.h"
 
 #include <assert.h>
+#include <ctype.h>
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -32,6 +34,7 @@
 #include "log.h"
 #include "plugins_datastore.h"
 #include "plugins_notification.h"
+#include "replay.h"
 #include "shm_ext.h"
 #include "shm_mod.h"
 #include "sysrepo.h"
@@ -46,6 +49,7 @@ sr_lycc_lock(sr_conn_ctx_t *conn, sr_lock_mode_t mode, int lydmods_lock, const c
     struct sr_shmmod_recover_cb_s cb_data;
     struct ly_ctx *new_ctx = NULL;
     char *path;
+    int lazy_ctx;
 
     cb_data.ly_ctx_p = &conn->ly_ctx;
     cb_data.ds = SR_DS_STARTUP;
@@ -63,8 +67,8 @@ sr_lycc_lock(sr_conn_ctx_t *conn, sr_lock_mode_t mode, int lydmods_lock, const c
     }
     remap_mode = SR_LOCK_READ;
 
-    /* check whether the context is current and does not need to be updated */
-    if (main_shm->content_id != conn->content_id) {
+    /* check whether the context is current and does not need to be updated, schema changes need all the modules */
+    if ((main_shm->content_id != conn->content_id) || (lydmods_lock && conn->lazy_ctx)) {
         /* MOD REMAP UNLOCK */
         sr_rwunlock(&conn->mod_remap_lock, SR_CONN_REMAP_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, func);
         remap_mode = SR_LOCK_NONE;
@@ -85,7 +89,14 @@ sr_lycc_lock(sr_conn_ctx_t *conn, sr_lock_mode_t mode, int lydmods_lock, const c
         if ((err_info = sr_ly_ctx_init(conn, &new_ctx))) {
             goto cleanup_unlock;
         }
-        if ((err_info = sr_shmmod_ctx_load_modules(SR_CONN_MOD_SHM(conn), new_ctx, NULL))) {
+        lazy_ctx = (conn->opts & SR_CONN_LAZY_CTX) && !lydmods_lock;
+        if (lazy_ctx) {
+            err_info = sr_shmmod_ctx_load_lazy_modules(SR_CONN_MOD_SHM(conn), new_ctx, conn->lazy_mods,
+                    conn->lazy_mod_count);
+        } else {
+            err_info = sr_shmmod_ctx_load_modules(SR_CONN_MOD_SHM(conn), new_ctx, NULL);
+        }
+        if (err_info) {
             if (!strcmp(err_info->err[err_info->err_count - 1].message, "Loading \"ietf-datastores\" module failed.")) {
                 if (!(tmp_err = sr_path_yang_dir(&path))) {
                     sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED,
@@ -102,6 +113,8 @@ sr_lycc_lock(sr_conn_ctx_t *conn, sr_lock_mode_t mode, int lydmods_lock, const c
 
         /* use the new context */
         sr_conn_ctx_switch(conn, &new_ctx, NULL);
+        conn->lazy_ctx = lazy_ctx;
+        SR_TRACE(ctx_update, conn->cid, main_shm->content_id);
 
         /* MOD REMAP DOWNGRADE */
         if ((err_info = sr_rwrelock(&conn->mod_remap_lock, SR_CONN_REMAP_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, func,
@@ -116,6 +129,8 @@ sr_lycc_lock(sr_conn_ctx_t *conn, sr_lock_mode_t mode, int lydmods_lock, const c
         goto cleanup_unlock;
     }
 
+    SR_TRACE(ctx_lock, conn->cid, mode, lydmods_lock, conn->content_id);
+
 cleanup_unlock:
     ly_ctx_destroy(new_ctx);
     if (err_info) {
@@ -146,6 +161,8 @@ sr_lycc_relock(sr_conn_ctx_t *conn, sr_lock_mode_t mode, const char *func)
     }
     assert(main_shm->content_id == conn->content_id);
 
+    SR_TRACE(ctx_relock, conn->cid, mode);
+
     return NULL;
 }
 
@@ -158,6 +175,8 @@ sr_lycc_unlock(sr_conn_ctx_t *conn, sr_lock_mode_t mode, int lydmods_lock, const
         return;
     }
 
+    SR_TRACE(ctx_unlock, conn->cid, mode, lydmods_lock);
+
     /* LYDMODS UNLOCK */
     if (lydmods_lock) {
         sr_munlock(&main_shm->lydmods_lock);
@@ -170,12 +189,245 @@ sr_lycc_unlock(sr_conn_ctx_t *conn, sr_lock_mode_t mode, int lydmods_lock, const
     sr_rwunlock(&main_shm->context_lock, SR_CONTEXT_LOCK_TIMEOUT, mode, conn->cid, func);
 }
 
+/**
+ * @brief Collect all the module names used as prefixes in an XPath.
+ *
+ * @param[in] xpath XPath to parse.
+ * @param[in,out] mod_names Array of module names to add to.
+ * @param[in,out] mod_name_count Count of @p mod_names.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lycc_xpath_mod_names(const char *xpath, char ***mod_names, uint32_t *mod_name_count)
+{
+    sr_error_info_t *err_info = NULL;
+    const char *ptr, *start;
+    char quot;
+    uint32_t i;
+    void *mem;
+
+    for (ptr = xpath; *ptr; ) {
+        if ((*ptr == '\'') || (*ptr == '"')) {
+            /* skip literals */
+            quot = *ptr;
+            ptr = strchr(ptr + 1, quot);
+            if (!ptr) {
+                break;
+            }
+            ++ptr;
+            continue;
+        }
+
+        if (!isalpha(*ptr) && (*ptr != '_')) {
+            ++ptr;
+            continue;
+        }
+
+        /* identifier */
+        start = ptr;
+        while (isalnum(*ptr) || (*ptr == '_') || (*ptr == '-') || (*ptr == '.')) {
+            ++ptr;
+        }
+        if ((ptr[0] != ':') || (ptr[1] == ':')) {
+            /* not a prefix */
+            continue;
+        }
+
+        for (i = 0; i < *mod_name_count; ++i) {
+            if (!strncmp((*mod_names)[i], start, ptr - start) && !(*mod_names)[i][ptr - start]) {
+                break;
+            }
+        }
+        if (i == *mod_name_count) {
+            /* new module name */
+            mem = realloc(*mod_names, (*mod_name_count + 1) * sizeof **mod_names);
+            SR_CHECK_MEM_RET(!mem, err_info);
+            *mod_names = mem;
+
+            (*mod_names)[*mod_name_count] = strndup(start, ptr - start);
+            SR_CHECK_MEM_RET(!(*mod_names)[*mod_name_count], err_info);
+            ++(*mod_name_count);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Check that no session of a connection has any prepared changes.
+ *
+ * @param[in] conn Connection to use.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lycc_lazy_check_edits(sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+    sr_datastore_t ds;
+
+    /* CONN PTR LOCK */
+    if ((err_info = sr_mlock(&conn->ptr_lock, -1, __func__, NULL, NULL))) {
+        return err_info;
+    }
+
+    for (i = 0; i < conn->session_count; ++i) {
+        for (ds = 0; ds < SR_DS_COUNT; ++ds) {
+            if (conn->sessions[i]->dt[ds].edit) {
+                sr_errinfo_new(&err_info, SR_ERR_OPERATION_FAILED, "Loading new modules into the lazy context of the "
+                        "connection with prepared changes in session %" PRIu32 " is not supported.", conn->sessions[i]->sid);
+                goto cleanup;
+            }
+        }
+    }
+
+cleanup:
+    /* CONN PTR UNLOCK */
+    sr_munlock(&conn->ptr_lock);
+    return err_info;
+}
+
+sr_error_info_t *
+sr_lycc_lazy_load(sr_conn_ctx_t *conn, const char *xpath, const char *mod_name)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_mod_shm_t *mod_shm;
+    char **mod_names = NULL;
+    uint32_t i, j, mod_name_count = 0, missing_count = 0;
+    void *mem;
+
+    if (!(conn->opts & SR_CONN_LAZY_CTX)) {
+        /* all the modules loaded */
+        return NULL;
+    }
+    if (!xpath && !mod_name) {
+        /* all the installed modules */
+        goto lock;
+    }
+
+    /* collect the module names */
+    if (mod_name) {
+        mod_names = malloc(sizeof *mod_names);
+        SR_CHECK_MEM_GOTO(!mod_names, err_info, cleanup);
+        mod_names[0] = strdup(mod_name);
+        SR_CHECK_MEM_GOTO(!mod_names[0], err_info, cleanup);
+        mod_name_count = 1;
+    }
+    if (xpath && (err_info = sr_lycc_xpath_mod_names(xpath, &mod_names, &mod_name_count))) {
+        goto cleanup;
+    }
+    if (!mod_name_count) {
+        goto cleanup;
+    }
+
+lock:
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        goto cleanup;
+    }
+
+    if (!xpath && !mod_name) {
+        mod_shm = SR_CONN_MOD_SHM(conn);
+        mod_names = calloc(mod_shm->mod_count, sizeof *mod_names);
+        for (i = 0; mod_names && (i < mod_shm->mod_count); ++i) {
+            if (!(mod_names[i] = strdup(((char *)mod_shm) + SR_SHM_MOD_IDX(mod_shm, i)->name))) {
+                break;
+            }
+            ++mod_name_count;
+        }
+        if (mod_shm->mod_count && (!mod_names || (mod_name_count < mod_shm->mod_count))) {
+            /* CONTEXT UNLOCK */
+            sr_lycc_unlock(conn, SR_LOCK_READ, 0, __func__);
+
+            SR_ERRINFO_MEM(&err_info);
+            goto cleanup;
+        }
+    }
+
+    /* keep only the installed modules missing in the context */
+    for (i = 0; i < mod_name_count; ++i) {
+        if (conn->lazy_ctx && !ly_ctx_get_module_implemented(conn->ly_ctx, mod_names[i]) &&
+                sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), mod_names[i])) {
+            mod_names[missing_count++] = mod_names[i];
+        } else {
+            free(mod_names[i]);
+        }
+    }
+    mod_name_count = missing_count;
+
+    /* CONTEXT UNLOCK */
+    sr_lycc_unlock(conn, SR_LOCK_READ, 0, __func__);
+
+    if (!mod_name_count) {
+        /* nothing to load */
+        goto cleanup;
+    }
+
+    /* the context is going to be recreated, prepared changes would become invalid */
+    if ((err_info = sr_lycc_lazy_check_edits(conn))) {
+        goto cleanup;
+    }
+
+    /* MOD REMAP LOCK */
+    if ((err_info = sr_rwlock(&conn->mod_remap_lock, SR_CONN_REMAP_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__,
+            NULL, NULL))) {
+        goto cleanup;
+    }
+
+    /* add the modules to be loaded */
+    mem = realloc(conn->lazy_mods, (conn->lazy_mod_count + mod_name_count) * sizeof *conn->lazy_mods);
+    if (!mem) {
+        SR_ERRINFO_MEM(&err_info);
+    } else {
+        conn->lazy_mods = mem;
+        for (i = 0; i < mod_name_count; ++i) {
+            for (j = 0; j < conn->lazy_mod_count; ++j) {
+                if (!strcmp(conn->lazy_mods[j], mod_names[i])) {
+                    break;
+                }
+            }
+            if (j < conn->lazy_mod_count) {
+                /* added meanwhile */
+                free(mod_names[i]);
+            } else {
+                conn->lazy_mods[conn->lazy_mod_count++] = mod_names[i];
+            }
+        }
+        mod_name_count = 0;
+
+        /* force the context to be recreated */
+        conn->content_id = 0;
+    }
+
+    /* MOD REMAP UNLOCK */
+    sr_rwunlock(&conn->mod_remap_lock, SR_CONN_REMAP_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__);
+
+    if (err_info) {
+        goto cleanup;
+    }
+
+    /* CONTEXT LOCK, the context is recreated with the new modules */
+    if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        goto cleanup;
+    }
+
+    /* CONTEXT UNLOCK */
+    sr_lycc_unlock(conn, SR_LOCK_READ, 0, __func__);
+
+cleanup:
+    for (i = 0; i < mod_name_count; ++i) {
+        free(mod_names[i]);
+    }
+    free(mod_names);
+    return err_info;
+}
+
 sr_error_info_t *
-sr_lycc_check_add_modules(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx)
+sr_lycc_check_add_modules(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx, const struct ly_set *upd_mod_set)
 {
     sr_error_info_t *err_info = NULL;
     const struct lys_module *ly_mod, *ly_mod2;
-    uint32_t i = 0;
+    uint32_t i = 0, j;
 
     while ((ly_mod = ly_ctx_get_module_iter(new_ctx, &i))) {
         if (!ly_mod->implemented) {
@@ -187,6 +439,18 @@ sr_lycc_check_add_modules(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx)
             continue;
         }
 
+        if (upd_mod_set) {
+            /* updated modules are expected to have a different revision */
+            for (j = 0; j < upd_mod_set->count; ++j) {
+                if (upd_mod_set->objs[j] == ly_mod) {
+                    break;
+                }
+            }
+            if (j < upd_mod_set->count) {
+                continue;
+            }
+        }
+
         /* modules are implemented in both contexts, compare revisions */
         if ((!ly_mod->revision && ly_mod2->revision) || (ly_mod->revision && !ly_mod2->revision) ||
                 (ly_mod->revision && ly_mod2->revision && strcmp(ly_mod->revision, ly_mod2->revision))) {
@@ -319,6 +583,9 @@ sr_lycc_del_module(sr_conn_ctx_t *conn, const struct ly_ctx *ly_ctx, const struc
             }
         }
 
+        /* remove any running data snapshot */
+        sr_run_snapshot_remove(ly_mod->name);
+
         /* destroy notifications if replay support was enabled */
         if (!lyd_find_path(sr_mod, "replay-support", 0, NULL)) {
             /* find plugin */
@@ -336,6 +603,9 @@ sr_lycc_del_module(sr_conn_ctx_t *conn, const struct ly_ctx *ly_ctx, const struc
                 SR_ERRINFO_DSPLUGIN(&err_info, rc, "disable", ntf_plg->name, ly_mod->name);
                 goto cleanup;
             }
+
+            /* remove the replay ring */
+            sr_replay_ring_remove(ly_mod->name);
         }
 
         /* remove module YANG files and of all its imports */
@@ -480,16 +750,267 @@ cleanup:
     return err_info;
 }
 
+/**
+ * @brief Check whether a set includes a module with a specific name.
+ *
+ * @param[in] mod_set Set of modules.
+ * @param[in] name Module name.
+ * @return Whether the module is in the set.
+ */
+static int
+sr_lycc_set_has_module(const struct ly_set *mod_set, const char *name)
+{
+    uint32_t i;
+
+    for (i = 0; i < mod_set->count; ++i) {
+        if (!strcmp(((struct lys_module *)mod_set->objs[i])->name, name)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Add all the implemented modules of a context imported by a module into a set.
+ *
+ * @param[in] ly_mod Module whose imports to add, can be from another context.
+ * @param[in] ly_ctx Context of the added modules.
+ * @param[in,out] mod_set Set of modules to add to.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lycc_add_impl_imports(const struct lys_module *ly_mod, const struct ly_ctx *ly_ctx, struct ly_set *mod_set)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lys_module *imp_mod;
+    const struct lysp_import *imports;
+    LY_ARRAY_COUNT_TYPE u, v;
+
+    for (v = 0; v <= LY_ARRAY_COUNT(ly_mod->parsed->includes); ++v) {
+        /* imports of the module and of all its submodules */
+        imports = v ? ly_mod->parsed->includes[v - 1].submodule->imports : ly_mod->parsed->imports;
+
+        LY_ARRAY_FOR(imports, u) {
+            imp_mod = ly_ctx_get_module_implemented(ly_ctx, imports[u].module->name);
+            if (imp_mod && ly_set_add(mod_set, (void *)imp_mod, 0, NULL)) {
+                sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+                return err_info;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief DFS callback finding nodes whose data can depend on anything so they cannot be updated separately.
+ *
+ * @param[in] node Compiled schema node.
+ * @param[in,out] data Flag to set if such a node was found.
+ * @param[out] dfs_continue Whether to skip the subtree.
+ * @return LY_EEXIST if found to stop the traversal, LY_SUCCESS otherwise.
+ */
+static LY_ERR
+sr_lycc_update_all_dfs_cb(struct lysc_node *node, void *data, ly_bool *dfs_continue)
+{
+    int *found = (int *)data;
+    const struct lysc_type *type;
+    LY_ARRAY_COUNT_TYPE u;
+
+    (void)dfs_continue;
+
+    LY_ARRAY_FOR(node->exts, u) {
+        if (!strcmp(node->exts[u].def->name, "mount-point") &&
+                !strcmp(node->exts[u].def->module->name, "ietf-yang-schema-mount")) {
+            /* mounted data may use any modules */
+            *found = 1;
+            return LY_EEXIST;
+        }
+    }
+
+    if (node->nodetype & LYD_NODE_TERM) {
+        type = ((struct lysc_node_leaf *)node)->type;
+        if (type->basetype == LY_TYPE_LEAFREF) {
+            type = ((struct lysc_type_leafref *)type)->realtype;
+        }
+        if (type->basetype == LY_TYPE_INST) {
+            /* instance-identifiers may reference data of any module */
+            *found = 1;
+            return LY_EEXIST;
+        } else if (type->basetype == LY_TYPE_UNION) {
+            LY_ARRAY_FOR(((struct lysc_type_union *)type)->types, u) {
+                if (((struct lysc_type_union *)type)->types[u]->basetype == LY_TYPE_INST) {
+                    *found = 1;
+                    return LY_EEXIST;
+                }
+            }
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Check whether the compiled schema of a module differs in a new context.
+ *
+ * @param[in] old_mod Module in the current context, NULL if not implemented there.
+ * @param[in] new_mod Module in the new context.
+ * @param[out] differ Whether the module differs.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lycc_module_differ(const struct lys_module *old_mod, const struct lys_module *new_mod, int *differ)
+{
+    sr_error_info_t *err_info = NULL;
+    char *old_str = NULL, *new_str = NULL;
+
+    *differ = 1;
+
+    if (!old_mod) {
+        /* newly implemented */
+        goto cleanup;
+    }
+    if ((!old_mod->revision != !new_mod->revision) || (old_mod->revision && strcmp(old_mod->revision, new_mod->revision))) {
+        /* different revision */
+        goto cleanup;
+    }
+
+    /* compare the compiled modules, they include features, deviations, and augments from any other modules */
+    if (lys_print_mem(&old_str, old_mod, LYS_OUT_YANG_COMPILED, 0)) {
+        sr_errinfo_new_ly(&err_info, old_mod->ctx, NULL);
+        goto cleanup;
+    }
+    if (lys_print_mem(&new_str, new_mod, LYS_OUT_YANG_COMPILED, 0)) {
+        sr_errinfo_new_ly(&err_info, new_mod->ctx, NULL);
+        goto cleanup;
+    }
+    *differ = strcmp(old_str, new_str) ? 1 : 0;
+
+cleanup:
+    free(old_str);
+    free(new_str);
+    return err_info;
+}
+
+/**
+ * @brief Collect modules whose data need to be updated for a new context and all the modules whose data are needed
+ * for their validation.
+ *
+ * @param[in] old_ctx Current context.
+ * @param[in] new_ctx New context.
+ * @param[out] mod_set Modules of @p new_ctx whose data need to be updated, NULL if all of them.
+ * @param[out] load_set Modules of @p new_ctx whose data need to be loaded, NULL if all of them.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lycc_update_data_modules(const struct ly_ctx *old_ctx, const struct ly_ctx *new_ctx, struct ly_set **mod_set,
+        struct ly_set **load_set)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lys_module *old_mod, *new_mod;
+    struct ly_set *inv_imps = NULL;
+    uint32_t idx, i, j;
+    int differ, update_all = 0;
+
+    *mod_set = NULL;
+    *load_set = NULL;
+
+    if (ly_set_new(mod_set) || ly_set_new(load_set) || ly_set_new(&inv_imps)) {
+        SR_ERRINFO_MEM(&err_info);
+        goto cleanup;
+    }
+
+    /* modules with a changed compiled schema */
+    idx = 0;
+    while ((new_mod = ly_ctx_get_module_iter(new_ctx, &idx))) {
+        if (!new_mod->implemented || !strcmp(new_mod->name, "sysrepo")) {
+            continue;
+        }
+
+        lysc_module_dfs_full(new_mod, sr_lycc_update_all_dfs_cb, &update_all);
+        if (update_all) {
+            goto cleanup;
+        }
+
+        old_mod = ly_ctx_get_module_implemented(old_ctx, new_mod->name);
+        if ((err_info = sr_lycc_module_differ(old_mod, new_mod, &differ))) {
+            goto cleanup;
+        }
+        if (differ && ly_set_add(*mod_set, (void *)new_mod, 0, NULL)) {
+            sr_errinfo_new_ly(&err_info, new_ctx, NULL);
+            goto cleanup;
+        }
+    }
+
+    /* modules imported by removed or changed modules, they may have lost some derived identities */
+    idx = 0;
+    while ((old_mod = ly_ctx_get_module_iter(old_ctx, &idx))) {
+        new_mod = ly_ctx_get_module(new_ctx, old_mod->name, old_mod->revision);
+        if (new_mod && !sr_lycc_set_has_module(*mod_set, new_mod->name)) {
+            continue;
+        }
+
+        if ((err_info = sr_lycc_add_impl_imports(old_mod, new_ctx, *mod_set))) {
+            goto cleanup;
+        }
+    }
+
+    /* modules importing any of the modules, recursively */
+    for (i = 0; i < (*mod_set)->count; ++i) {
+        ly_set_erase(inv_imps, NULL);
+        if ((err_info = sr_module_get_impl_inv_imports((*mod_set)->objs[i], inv_imps))) {
+            goto cleanup;
+        }
+        for (j = 0; j < inv_imps->count; ++j) {
+            if (ly_set_add(*mod_set, inv_imps->objs[j], 0, NULL)) {
+                sr_errinfo_new_ly(&err_info, new_ctx, NULL);
+                goto cleanup;
+            }
+        }
+    }
+
+    /* the updated modules and all the implemented modules they import, their data may be referenced */
+    for (i = 0; i < (*mod_set)->count; ++i) {
+        new_mod = (*mod_set)->objs[i];
+
+        lysc_module_dfs_full(new_mod, sr_lycc_update_all_dfs_cb, &update_all);
+        if (update_all) {
+            goto cleanup;
+        }
+
+        if (ly_set_add(*load_set, (void *)new_mod, 0, NULL)) {
+            sr_errinfo_new_ly(&err_info, new_ctx, NULL);
+            goto cleanup;
+        }
+        if ((err_info = sr_lycc_add_impl_imports(new_mod, new_ctx, *load_set))) {
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    ly_set_free(inv_imps, NULL);
+    if (err_info || update_all) {
+        ly_set_free(*mod_set, NULL);
+        *mod_set = NULL;
+        ly_set_free(*load_set, NULL);
+        *load_set = NULL;
+    }
+    return err_info;
+}
+
 /**
  * @brief Append all stored DS data by implemented modules from context.
  *
  * @param[in] conn Connection to use.
  * @param[in] new_ctx New context to iterate over.
+ * @param[in] mod_set Optional set of modules (from any context) whose data to append, all if not set.
  * @param[out] data Data of each datastore.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_lycc_append_data(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx, struct sr_data_update_set_s *data)
+sr_lycc_append_data(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx, const struct ly_set *mod_set,
+        struct sr_data_update_set_s *data)
 {
     sr_error_info_t *err_info = NULL;
     const struct lys_module *ly_mod;
@@ -503,6 +1024,10 @@ sr_lycc_append_data(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx, struct sr
             /* we need data of only implemented modules and never from internal SR module */
             continue;
         }
+        if (mod_set && !sr_lycc_set_has_module(mod_set, ly_mod->name)) {
+            /* data of this module are not needed */
+            continue;
+        }
 
         /* get SHM mod */
         shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), ly_mod->name);
@@ -513,7 +1038,7 @@ sr_lycc_append_data(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx, struct sr
         if ((err_info = sr_ds_plugin_find(conn->mod_shm.addr + shm_mod->plugins[ds], conn, &ds_plg[ds]))) {
             goto cleanup;
         }
-        if ((err_info = sr_module_file_data_append(ly_mod, ds_plg, ds, NULL, 0, &data->start))) {
+        if ((err_info = sr_module_file_data_append(NULL, ly_mod, ds_plg, ds, NULL, 0, &data->start))) {
             goto cleanup;
         }
 
@@ -522,7 +1047,7 @@ sr_lycc_append_data(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx, struct sr
         if ((err_info = sr_ds_plugin_find(conn->mod_shm.addr + shm_mod->plugins[ds], conn, &ds_plg[ds]))) {
             goto cleanup;
         }
-        if ((err_info = sr_module_file_data_append(ly_mod, ds_plg, ds, NULL, 0, &data->run))) {
+        if ((err_info = sr_module_file_data_append(NULL, ly_mod, ds_plg, ds, NULL, 0, &data->run))) {
             goto cleanup;
         }
 
@@ -531,7 +1056,7 @@ sr_lycc_append_data(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx, struct sr
         if ((err_info = sr_ds_plugin_find(conn->mod_shm.addr + shm_mod->plugins[ds], conn, &ds_plg[ds]))) {
             goto cleanup;
         }
-        if ((err_info = sr_module_file_data_append(ly_mod, ds_plg, ds, NULL, 0, &data->oper))) {
+        if ((err_info = sr_module_file_data_append(NULL, ly_mod, ds_plg, ds, NULL, 0, &data->oper))) {
             goto cleanup;
         }
 
@@ -540,7 +1065,7 @@ sr_lycc_append_data(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx, struct sr
         if ((err_info = sr_ds_plugin_find(conn->mod_shm.addr + shm_mod->plugins[ds], conn, &ds_plg[ds]))) {
             goto cleanup;
         }
-        if ((err_info = sr_module_file_data_append(ly_mod, ds_plg, ds, NULL, 0, &data->fdflt))) {
+        if ((err_info = sr_module_file_data_append(NULL, ly_mod, ds_plg, ds, NULL, 0, &data->fdflt))) {
             goto cleanup;
         }
     }
@@ -603,12 +1128,19 @@ sr_lycc_update_data(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx, const str
         struct sr_data_update_s *data_info)
 {
     sr_error_info_t *err_info = NULL;
-    uint32_t parse_opts;
+    struct ly_set *load_set = NULL;
+    uint32_t parse_opts, i;
 
     memset(data_info, 0, sizeof *data_info);
 
-    /* parse all the startup/running/operational/factory-default data using the old context (that must succeed) */
-    if ((err_info = sr_lycc_append_data(conn, conn->ly_ctx, &data_info->old))) {
+    /* learn which modules are affected by the context change */
+    if ((err_info = sr_lycc_update_data_modules(conn->ly_ctx, new_ctx, &data_info->mod_set, &load_set))) {
+        goto cleanup;
+    }
+
+    /* parse all the startup/running/operational/factory-default data using the old context (that must succeed),
+     * only of the needed modules */
+    if ((err_info = sr_lycc_append_data(conn, conn->ly_ctx, load_set, &data_info->old))) {
         goto cleanup;
     }
 
@@ -628,16 +1160,30 @@ sr_lycc_update_data(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx, const str
         goto cleanup;
     }
 
-    /* fully validate complete startup, running, and factory-default datastore */
-    if (lyd_validate_all(&data_info->new.start, new_ctx, LYD_VALIDATE_NO_STATE, NULL) ||
-            lyd_validate_all(&data_info->new.run, new_ctx, LYD_VALIDATE_NO_STATE, NULL) ||
-            lyd_validate_all(&data_info->new.fdflt, new_ctx, LYD_VALIDATE_NO_STATE, NULL)) {
-        sr_errinfo_new_ly(&err_info, new_ctx, NULL);
-        err_info->err[0].err_code = SR_ERR_VALIDATION_FAILED;
-        goto cleanup;
+    if (!data_info->mod_set) {
+        /* fully validate complete startup, running, and factory-default datastore */
+        if (lyd_validate_all(&data_info->new.start, new_ctx, LYD_VALIDATE_NO_STATE, NULL) ||
+                lyd_validate_all(&data_info->new.run, new_ctx, LYD_VALIDATE_NO_STATE, NULL) ||
+                lyd_validate_all(&data_info->new.fdflt, new_ctx, LYD_VALIDATE_NO_STATE, NULL)) {
+            sr_errinfo_new_ly(&err_info, new_ctx, NULL);
+            err_info->err[0].err_code = SR_ERR_VALIDATION_FAILED;
+            goto cleanup;
+        }
+    } else {
+        /* validate startup, running, and factory-default datastore of the updated modules */
+        for (i = 0; i < data_info->mod_set->count; ++i) {
+            if (lyd_validate_module(&data_info->new.start, data_info->mod_set->objs[i], LYD_VALIDATE_NO_STATE, NULL) ||
+                    lyd_validate_module(&data_info->new.run, data_info->mod_set->objs[i], LYD_VALIDATE_NO_STATE, NULL) ||
+                    lyd_validate_module(&data_info->new.fdflt, data_info->mod_set->objs[i], LYD_VALIDATE_NO_STATE, NULL)) {
+                sr_errinfo_new_ly(&err_info, new_ctx, NULL);
+                err_info->err[0].err_code = SR_ERR_VALIDATION_FAILED;
+                goto cleanup;
+            }
+        }
     }
 
 cleanup:
+    ly_set_free(load_set, NULL);
     return err_info;
 }
 
@@ -649,13 +1195,15 @@ cleanup:
  * @param[in] new_ctx New context to iterate over.
  * @param[in] ds Affected datastore.
  * @param[in] sr_mods SR internal module data.
+ * @param[in] mod_set Optional set of the updated modules, all if not set.
  * @param[in,out] old_data Previous (current) data, are freed for each module.
  * @param[in,out] new_data New data, are freed for each module.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
 sr_lycc_store_data_ds_if_differ(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx, sr_datastore_t ds,
-        const struct lyd_node *sr_mods, struct lyd_node **old_data, struct lyd_node **new_data)
+        const struct lyd_node *sr_mods, const struct ly_set *mod_set, struct lyd_node **old_data,
+        struct lyd_node **new_data)
 {
     sr_error_info_t *err_info = NULL;
     const struct lys_module *new_ly_mod, *old_ly_mod;
@@ -671,6 +1219,10 @@ sr_lycc_store_data_ds_if_differ(sr_conn_ctx_t *conn, const struct ly_ctx *new_ct
         if (!new_ly_mod->implemented || sr_is_module_internal(new_ly_mod)) {
             continue;
         }
+        if (mod_set && !sr_lycc_set_has_module(mod_set, new_ly_mod->name)) {
+            /* module data not updated, keep them */
+            continue;
+        }
 
         old_ly_mod = ly_ctx_get_module_implemented(conn->ly_ctx, new_ly_mod->name);
 
@@ -735,26 +1287,26 @@ sr_lycc_store_data_if_differ(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx,
     sr_error_info_t *err_info = NULL;
 
     /* startup */
-    if ((err_info = sr_lycc_store_data_ds_if_differ(conn, new_ctx, SR_DS_STARTUP, sr_mods, &data_info->old.start,
-            &data_info->new.start))) {
+    if ((err_info = sr_lycc_store_data_ds_if_differ(conn, new_ctx, SR_DS_STARTUP, sr_mods, data_info->mod_set,
+            &data_info->old.start, &data_info->new.start))) {
         return err_info;
     }
 
     /* running */
-    if ((err_info = sr_lycc_store_data_ds_if_differ(conn, new_ctx, SR_DS_RUNNING, sr_mods, &data_info->old.run,
-            &data_info->new.run))) {
+    if ((err_info = sr_lycc_store_data_ds_if_differ(conn, new_ctx, SR_DS_RUNNING, sr_mods, data_info->mod_set,
+            &data_info->old.run, &data_info->new.run))) {
         return err_info;
     }
 
     /* operational */
-    if ((err_info = sr_lycc_store_data_ds_if_differ(conn, new_ctx, SR_DS_OPERATIONAL, sr_mods, &data_info->old.oper,
-            &data_info->new.oper))) {
+    if ((err_info = sr_lycc_store_data_ds_if_differ(conn, new_ctx, SR_DS_OPERATIONAL, sr_mods, data_info->mod_set,
+            &data_info->old.oper, &data_info->new.oper))) {
         return err_info;
     }
 
     /* factory-default */
-    if ((err_info = sr_lycc_store_data_ds_if_differ(conn, new_ctx, SR_DS_FACTORY_DEFAULT, sr_mods, &data_info->old.fdflt,
-            &data_info->new.fdflt))) {
+    if ((err_info = sr_lycc_store_data_ds_if_differ(conn, new_ctx, SR_DS_FACTORY_DEFAULT, sr_mods, data_info->mod_set,
+            &data_info->old.fdflt, &data_info->new.fdflt))) {
         return err_info;
     }
 
@@ -773,4 +1325,6 @@ sr_lycc_update_data_clear(struct sr_data_update_s *data_info)
     lyd_free_siblings(data_info->new.run);
     lyd_free_siblings(data_info->new.oper);
     lyd_free_siblings(data_info->new.fdflt);
+
+    ly_set_free(data_info->mod_set, NULL);
 }
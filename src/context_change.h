@@ -34,6 +34,7 @@ struct sr_data_update_s {
         struct lyd_node *fdflt;
     } old;
     struct sr_data_update_set_s new;
+    struct ly_set *mod_set;     /**< Modules of the new context whose data are updated, NULL for all the modules. */
 };
 
 /**
@@ -67,14 +68,29 @@ sr_error_info_t *sr_lycc_relock(sr_conn_ctx_t *conn, sr_lock_mode_t mode, const
  */
 void sr_lycc_unlock(sr_conn_ctx_t *conn, sr_lock_mode_t mode, int lydmods_lock, const char *func);
 
+/**
+ * @brief Load modules into a connection lazy context (::SR_CONN_LAZY_CTX), if not already loaded.
+ *
+ * Must be called without the context locked.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] xpath Optional XPath whose modules to load.
+ * @param[in] mod_name Optional module name to load, if neither it nor @p xpath is set, all the installed modules
+ * are loaded.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_lycc_lazy_load(sr_conn_ctx_t *conn, const char *xpath, const char *mod_name);
+
 /**
  * @brief Check that modules can be added.
  *
  * @param[in] conn Connection to use.
  * @param[in] new_ctx New context with all the modules.
+ * @param[in] upd_mod_set Optional set of modules updated in @p new_ctx, their revisions are not checked.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_lycc_check_add_modules(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx);
+sr_error_info_t *sr_lycc_check_add_modules(sr_conn_ctx_t *conn, const struct ly_ctx *new_ctx,
+        const struct ly_set *upd_mod_set);
 
 /**
  * @brief Finish adding new modules.
@@ -152,6 +168,9 @@ sr_error_info_t *sr_lycc_set_replay_support(sr_conn_ctx_t *conn, const struct ly
 /**
  * @brief Update SR data for use with the changed context.
  *
+ * Only data of the modules whose compiled schema changed and of the modules importing them are updated, the data
+ * of all the other modules are kept as they are.
+ *
  * @param[in] conn Connection to use.
  * @param[in] new_ctx New context.
  * @param[in] mod_data Optional new module initial data.
@@ -45,6 +45,17 @@ enum insert_val {
     INSERT_AFTER
 };
 
+/**
+ * @brief Cache of the last instance of a user-ordered (leaf-)list used while applying a single edit so that
+ * inserting many instances into one (leaf-)list does not search the siblings repeatedly.
+ */
+struct sr_edit_userord_cache_s {
+    const struct lysc_node *schema; /**< Schema node of the cached (leaf-)list, NULL if nothing is cached. */
+    const struct lyd_node *parent;  /**< Data parent of the (leaf-)list instances. */
+    struct lyd_node *last;          /**< Last (leaf-)list instance. */
+    uint32_t last_pos;              /**< Position of the last instance (instance count), 0 if unknown. */
+};
+
 /**
  * @brief Return operation from a string.
  *
@@ -678,25 +689,76 @@ sr_edit_find_previous_instance(const struct lyd_node *llist)
     return llist->prev;
 }
 
+/**
+ * @brief Get the last instance of a user-ordered (leaf-)list, use the cache if valid.
+ *
+ * @param[in] cache User-ordered (leaf-)list cache.
+ * @param[in] sibling First data tree sibling.
+ * @param[in] parent Data tree parent.
+ * @param[in] schema Schema node of the (leaf-)list.
+ * @return Last instance, NULL if there are none.
+ */
+static struct lyd_node *
+sr_edit_userord_cache_last(struct sr_edit_userord_cache_s *cache, const struct lyd_node *sibling,
+        const struct lyd_node *parent, const struct lysc_node *schema)
+{
+    struct lyd_node *iter;
+    uint32_t pos;
+
+    if ((cache->schema == schema) && (cache->parent == parent) && ((struct lyd_node *)cache->last->parent == parent) &&
+            (!cache->last->next || (cache->last->next->schema != schema))) {
+        /* valid, instances are always consecutive */
+        return cache->last;
+    }
+
+    /* find the first instance */
+    memset(cache, 0, sizeof *cache);
+    if (lyd_find_sibling_val(sibling, schema, NULL, 0, &iter)) {
+        return NULL;
+    }
+
+    /* find the last instance */
+    pos = 1;
+    while (iter->next && (iter->next->schema == schema)) {
+        iter = iter->next;
+        ++pos;
+    }
+
+    /* cache it */
+    cache->schema = schema;
+    cache->parent = parent;
+    cache->last = iter;
+    cache->last_pos = lysc_is_dup_inst_list(schema) ? pos : 0;
+    return iter;
+}
+
 /**
  * @brief Create a predicate for a user-ordered (leaf-)list. For dpulicate-instance list, it is its position.
  * In case of list, it is an array of predicates for each key. For leaf-list, it is simply its value.
  *
  * @param[in] llist (Leaf-)list to process.
+ * @param[in] cache Optional user-ordered (leaf-)list cache with the last instance position.
  * @return Predicate, NULL on error.
  */
 static char *
-sr_edit_create_userord_predicate(const struct lyd_node *llist)
+sr_edit_create_userord_predicate(const struct lyd_node *llist, const struct sr_edit_userord_cache_s *cache)
 {
     char *pred;
-    uint32_t pred_len, key_len;
+    uint32_t pred_len, key_len, pos;
     struct lyd_node *key;
 
     assert(lysc_is_userordered(llist->schema));
 
     if (lysc_is_dup_inst_list(llist->schema)) {
         /* duplicate-instance lists use their position */
-        if (asprintf(&pred, "%" PRIu32, lyd_list_pos(llist)) == -1) {
+        if (cache && cache->last_pos && (cache->schema == llist->schema) && (cache->last == llist)) {
+            pos = cache->last_pos;
+        } else if (cache && (cache->last_pos > 1) && (cache->schema == llist->schema) && (cache->last->prev == llist)) {
+            pos = cache->last_pos - 1;
+        } else {
+            pos = lyd_list_pos(llist);
+        }
+        if (asprintf(&pred, "%" PRIu32, pos) == -1) {
             return NULL;
         }
         return pred;
@@ -763,7 +825,7 @@ sr_meta_edit2diff(struct lyd_node *node, enum edit_op set_op, const struct lyd_n
         /* find previous instance */
         sibling_before = sr_edit_find_previous_instance(orig_node);
         if (sibling_before) {
-            sibling_before_val = sr_edit_create_userord_predicate(sibling_before);
+            sibling_before_val = sr_edit_create_userord_predicate(sibling_before, NULL);
         }
     }
 
@@ -1019,13 +1081,16 @@ sr_edit_userord_is_moved(const struct lyd_node *data_match, enum insert_val inse
  * @brief Find a matching node in data tree for a specific (leaf-)list instance.
  *
  * @param[in] sibling First data tree sibling.
+ * @param[in] parent Data tree parent.
  * @param[in] llist Arbitrary instance of the (leaf-)list.
  * @param[in] userord_anchor Preceding user-ordered anchor of the searched instance.
+ * @param[in] uo_cache Optional user-ordered (leaf-)list cache.
  * @param[out] match Matching instance in the data tree.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_edit_find_userord_predicate(const struct lyd_node *sibling, const struct lyd_node *llist, const char *userord_anchor,
+sr_edit_find_userord_predicate(const struct lyd_node *sibling, const struct lyd_node *parent,
+        const struct lyd_node *llist, const char *userord_anchor, struct sr_edit_userord_cache_s *uo_cache,
         struct lyd_node **match)
 {
     sr_error_info_t *err_info = NULL;
@@ -1036,6 +1101,13 @@ sr_edit_find_userord_predicate(const struct lyd_node *sibling, const struct lyd_
 
     if (lysc_is_dup_inst_list(llist->schema)) {
         pos = atoi(userord_anchor);
+        if (uo_cache && (iter = sr_edit_userord_cache_last(uo_cache, sibling, parent, llist->schema)) &&
+                uo_cache->last_pos && (pos == uo_cache->last_pos)) {
+            /* the last instance, usually when appending instances */
+            *match = iter;
+            return NULL;
+        }
+
         cur_pos = 1;
         LYD_LIST_FOR_INST(sibling, llist->schema, iter) {
             if (cur_pos == pos) {
@@ -1129,13 +1201,15 @@ sr_edit_find_match(const struct lyd_node *data_sibling, const struct lyd_node *e
  * @param[in] userord_anchor Optional user-ordered list anchor of relative (leaf-)list instance of the operation.
  * @param[in] dflt_ll_skip Whether to skip found default leaf-list instance.
  * @param[in] flags Flags modifying the behavior.
+ * @param[in] uo_cache Optional user-ordered (leaf-)list cache.
  * @param[out] match_p Matching node.
  * @param[out] val_equal_p Whether even the value matches.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
 sr_edit_find(const struct lyd_node *data_sibling, const struct lyd_node *edit_node, enum edit_op op, enum insert_val insert,
-        const char *userord_anchor, int dflt_ll_skip, int flags, struct lyd_node **match_p, int *val_equal_p)
+        const char *userord_anchor, int dflt_ll_skip, int flags, struct sr_edit_userord_cache_s *uo_cache,
+        struct lyd_node **match_p, int *val_equal_p)
 {
     sr_error_info_t *err_info = NULL;
     struct lyd_node *anchor_node;
@@ -1186,7 +1260,8 @@ sr_edit_find(const struct lyd_node *data_sibling, const struct lyd_node *edit_no
                     anchor_node = NULL;
                     if (userord_anchor) {
                         /* find the anchor node if set */
-                        if ((err_info = sr_edit_find_userord_predicate(data_sibling, match, userord_anchor, &anchor_node))) {
+                        if ((err_info = sr_edit_find_userord_predicate(data_sibling, lyd_parent(match), match,
+                                userord_anchor, uo_cache, &anchor_node))) {
                             return err_info;
                         }
                     } else if (flags & EDIT_APPLY_REPLACE_R) {
@@ -1259,15 +1334,17 @@ sr_edit_op2str(enum edit_op op)
  * @param[in] new_node Edit node to insert.
  * @param[in] insert Place where to insert the node.
  * @param[in] userord_anchor Optional user-ordered anchor of relative (leaf-)list instance.
+ * @param[in] uo_cache Optional user-ordered (leaf-)list cache.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
 sr_edit_insert(struct lyd_node **data_root, struct lyd_node *data_parent, struct lyd_node *new_node,
-        enum insert_val insert, const char *userord_anchor)
+        enum insert_val insert, const char *userord_anchor, struct sr_edit_userord_cache_s *uo_cache)
 {
     sr_error_info_t *err_info = NULL;
     const struct ly_ctx *ly_ctx;
     struct lyd_node *anchor;
+    int linked;
     LY_ERR lyrc = 0;
 
     assert(new_node);
@@ -1281,11 +1358,33 @@ sr_edit_insert(struct lyd_node **data_root, struct lyd_node *data_parent, struct
     }
 
     /* unlink properly first to avoid unwanted behavior (first node equals new_node or new_node is the first sibling) */
+    linked = new_node->parent || (new_node->prev != new_node) || (new_node == *data_root);
+    if (uo_cache && (uo_cache->last == new_node)) {
+        /* the cached instance is being moved */
+        memset(uo_cache, 0, sizeof *uo_cache);
+    }
     if (new_node == *data_root) {
         *data_root = (*data_root)->next;
     }
     lyd_unlink_tree(new_node);
 
+    if (uo_cache && lysc_is_userordered(new_node->schema) && ((insert == INSERT_DEFAULT) || (insert == INSERT_LAST))) {
+        /* append after the last instance, avoid searching for it */
+        anchor = sr_edit_userord_cache_last(uo_cache, data_parent ? lyd_child(data_parent) : *data_root, data_parent,
+                new_node->schema);
+        if (anchor) {
+            lyrc = lyd_insert_after(anchor, new_node);
+            if (!lyrc) {
+                uo_cache->last = new_node;
+                uo_cache->last_pos = (!linked && uo_cache->last_pos) ? uo_cache->last_pos + 1 : 0;
+            }
+            goto cleanup;
+        }
+    } else if (uo_cache && (uo_cache->schema == new_node->schema)) {
+        /* the positions are changing */
+        uo_cache->last_pos = 0;
+    }
+
     /* insert last or first */
     if ((insert == INSERT_DEFAULT) || (insert == INSERT_LAST)) {
         /* default insert is at the last position */
@@ -1319,8 +1418,8 @@ sr_edit_insert(struct lyd_node **data_root, struct lyd_node *data_parent, struct
     assert(lysc_is_userordered(new_node->schema) && userord_anchor);
 
     /* find the anchor sibling */
-    if ((err_info = sr_edit_find_userord_predicate(data_parent ? lyd_child(data_parent) : *data_root, new_node,
-            userord_anchor, &anchor))) {
+    if ((err_info = sr_edit_find_userord_predicate(data_parent ? lyd_child(data_parent) : *data_root, data_parent,
+            new_node, userord_anchor, NULL, &anchor))) {
         goto cleanup;
     }
 
@@ -1573,7 +1672,7 @@ sr_edit_diff_add(const struct lyd_node *node, const char *meta_val, const char *
                 /* only add information about previous instance for userord lists, nothing else is needed */
                 sibling_before = sr_edit_find_previous_instance(elem);
                 if (sibling_before) {
-                    sibling_before_val = sr_edit_create_userord_predicate(sibling_before);
+                    sibling_before_val = sr_edit_create_userord_predicate(sibling_before, NULL);
                 }
 
                 /* add metadata */
@@ -1805,7 +1904,7 @@ sr_edit_apply_remove(struct lyd_node *data_match, struct lyd_node *diff_parent,
             /* get original (current) previous instance to be stored in diff */
             sibling_before = sr_edit_find_previous_instance(data_match);
             if (sibling_before) {
-                sibling_before_val = sr_edit_create_userord_predicate(sibling_before);
+                sibling_before_val = sr_edit_create_userord_predicate(sibling_before, NULL);
             }
         }
 
@@ -1845,6 +1944,7 @@ cleanup:
  * @param[in] diff_parent Current sysrepo diff parent.
  * @param[in,out] diff_root Sysrepo diff root node.
  * @param[out] diff_node Created diff node.
+ * @param[in] uo_cache User-ordered (leaf-)list cache.
  * @param[out] next_op Next operation to be performed with these nodes.
  * @param[out] change Whether some data change occurred.
  * @return err_info, NULL on success.
@@ -1852,7 +1952,8 @@ cleanup:
 static sr_error_info_t *
 sr_edit_apply_move(struct lyd_node **data_root, struct lyd_node *data_parent, const struct lyd_node *edit_node,
         struct lyd_node **data_match, enum insert_val insert, const char *key_or_value, struct lyd_node *diff_parent,
-        struct lyd_node **diff_root, struct lyd_node **diff_node, enum edit_op *next_op, int *change)
+        struct lyd_node **diff_root, struct lyd_node **diff_node, struct sr_edit_userord_cache_s *uo_cache,
+        enum edit_op *next_op, int *change)
 {
     sr_error_info_t *err_info = NULL;
     const struct lyd_node *old_sibling_before, *sibling_before;
@@ -1877,7 +1978,7 @@ sr_edit_apply_move(struct lyd_node **data_root, struct lyd_node *data_parent, co
     old_sibling_before = sr_edit_find_previous_instance(*data_match);
 
     /* move the node */
-    if ((err_info = sr_edit_insert(data_root, data_parent, *data_match, insert, key_or_value))) {
+    if ((err_info = sr_edit_insert(data_root, data_parent, *data_match, insert, key_or_value, uo_cache))) {
         return err_info;
     }
 
@@ -1886,10 +1987,10 @@ sr_edit_apply_move(struct lyd_node **data_root, struct lyd_node *data_parent, co
 
     /* update diff with correct move information */
     if (old_sibling_before) {
-        old_sibling_before_val = sr_edit_create_userord_predicate(old_sibling_before);
+        old_sibling_before_val = sr_edit_create_userord_predicate(old_sibling_before, NULL);
     }
     if (sibling_before) {
-        sibling_before_val = sr_edit_create_userord_predicate(sibling_before);
+        sibling_before_val = sr_edit_create_userord_predicate(sibling_before, uo_cache);
     }
     err_info = sr_edit_diff_add(*data_match, sibling_before_val, old_sibling_before_val, diff_op, 0, diff_parent,
             diff_root, diff_node);
@@ -1920,7 +2021,7 @@ sr_edit_created_subtree_apply_move(struct lyd_node *match_subtree)
             sibling_before_val = NULL;
             sibling_before = sr_edit_find_previous_instance(elem);
             if (sibling_before) {
-                sibling_before_val = sr_edit_create_userord_predicate(sibling_before);
+                sibling_before_val = sr_edit_create_userord_predicate(sibling_before, NULL);
             }
 
             if (elem->schema->nodetype == LYS_LIST) {
@@ -2115,7 +2216,7 @@ sr_edit_apply_create(struct lyd_node **data_root, struct lyd_node *data_parent,
         return err_info;
     }
 
-    if ((err_info = sr_edit_insert(data_root, data_parent, *data_match, 0, NULL))) {
+    if ((err_info = sr_edit_insert(data_root, data_parent, *data_match, 0, NULL, NULL))) {
         return err_info;
     }
 
@@ -2213,12 +2314,14 @@ sr_edit_apply_op_error(sr_error_info_t **err_info, enum edit_op op)
  * @param[in] diff_parent Current sysrepo diff parent.
  * @param[in,out] diff_root Sysrepo diff root node.
  * @param[in] flags Flags modifying the behavior.
+ * @param[in] uo_cache User-ordered (leaf-)list cache of the edit application.
  * @param[out] change Set if there are some data changes.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
 sr_edit_apply_r(struct lyd_node **data_root, struct lyd_node *data_parent, const struct lyd_node *edit_node,
-        enum edit_op parent_op, struct lyd_node *diff_parent, struct lyd_node **diff_root, int flags, int *change)
+        enum edit_op parent_op, struct lyd_node *diff_parent, struct lyd_node **diff_root, int flags,
+        struct sr_edit_userord_cache_s *uo_cache, int *change)
 {
     sr_error_info_t *err_info = NULL;
     struct lyd_node *data_match = NULL, *child, *next, *edit_match, *diff_node = NULL, *data_del = NULL;
@@ -2259,7 +2362,7 @@ sr_edit_apply_r(struct lyd_node **data_root, struct lyd_node *data_parent, const
 reapply:
     /* find an equal node in the current data */
     if ((err_info = sr_edit_find(data_parent ? lyd_child(data_parent) : *data_root, edit_node, op, insert, key_or_value,
-            1, flags, &data_match, &val_equal))) {
+            1, flags, uo_cache, &data_match, &val_equal))) {
         goto cleanup;
     }
 
@@ -2298,6 +2401,8 @@ reapply:
             prev_op = next_op;
         /* fallthrough */
         case EDIT_REMOVE:
+            /* the cached instance may be freed */
+            memset(uo_cache, 0, sizeof *uo_cache);
             if ((err_info = sr_edit_apply_remove(data_match, diff_parent, diff_root, &diff_node, &next_op, &flags,
                     change, &data_del))) {
                 sr_edit_apply_op_error(&err_info, op);
@@ -2306,7 +2411,7 @@ reapply:
             break;
         case EDIT_MOVE:
             if ((err_info = sr_edit_apply_move(data_root, data_parent, edit_node, &data_match, insert, key_or_value,
-                    diff_parent, diff_root, &diff_node, &next_op, change))) {
+                    diff_parent, diff_root, &diff_node, uo_cache, &next_op, change))) {
                 sr_edit_apply_op_error(&err_info, op);
                 goto cleanup;
             }
@@ -2365,12 +2470,12 @@ reapply:
                 continue;
             }
 
-            if ((err_info = sr_edit_find(lyd_child_no_keys(edit_node), child, EDIT_DELETE, 0, NULL, 0, 0,
+            if ((err_info = sr_edit_find(lyd_child_no_keys(edit_node), child, EDIT_DELETE, 0, NULL, 0, 0, NULL,
                     &edit_match, NULL))) {
                 goto cleanup;
             }
             if (!edit_match && (err_info = sr_edit_apply_r(data_root, data_match, child, EDIT_DELETE, diff_parent,
-                    diff_root, flags, change))) {
+                    diff_root, flags, uo_cache, change))) {
                 goto cleanup;
             }
         }
@@ -2379,7 +2484,8 @@ reapply:
     /* apply edit recursively, keys are being checked, in case we were called by the recursion above,
      * edit_node and data_match are the same and so child will be freed, hence the safe loop */
     LY_LIST_FOR_SAFE(lyd_child(edit_node), next, child) {
-        if ((err_info = sr_edit_apply_r(data_root, data_match, child, op, diff_parent, diff_root, flags, change))) {
+        if ((err_info = sr_edit_apply_r(data_root, data_match, child, op, diff_parent, diff_root, flags, uo_cache,
+                change))) {
             goto cleanup;
         }
     }
@@ -2404,6 +2510,7 @@ sr_edit_mod_apply(const struct lyd_node *edit, const struct lys_module *ly_mod,
     sr_error_info_t *err_info = NULL;
     const struct lyd_node *root;
     struct lyd_node *mod_diff = NULL;
+    struct sr_edit_userord_cache_s uo_cache = {0};
 
     if (change) {
         *change = 0;
@@ -2416,7 +2523,8 @@ sr_edit_mod_apply(const struct lyd_node *edit, const struct lys_module *ly_mod,
         }
 
         /* apply relevant nodes from the edit datatree */
-        if ((err_info = sr_edit_apply_r(data, NULL, root, EDIT_CONTINUE, NULL, diff ? &mod_diff : NULL, 0, change))) {
+        if ((err_info = sr_edit_apply_r(data, NULL, root, EDIT_CONTINUE, NULL, diff ? &mod_diff : NULL, 0, &uo_cache,
+                change))) {
             goto cleanup;
         }
 
@@ -3178,66 +3286,184 @@ error_safe:
     return err_info;
 }
 
+/**
+ * @brief Decide the change operation of a diff node.
+ *
+ * @param[in] node Diff node.
+ * @param[in] meta Operation metadata of the node, inherited or its own.
+ * @param[in] meta_node Node with @p meta.
+ * @param[out] op Change operation, -1 if the node is not a change.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_diff_node_oper(const struct lyd_node *node, const struct lyd_meta *meta, const struct lyd_node *meta_node, int8_t *op)
+{
+    sr_error_info_t *err_info = NULL;
+
+    if (!meta) {
+        SR_ERRINFO_INT(&err_info);
+        return err_info;
+    }
+
+    if ((meta_node != node) && lysc_is_userordered(meta_node->schema) && (lyd_get_meta_value(meta)[0] == 'r')) {
+        /* do not return changes for descendants of moved userord lists without operation */
+        *op = -1;
+        return NULL;
+    }
+
+    /* decide operation */
+    switch (meta->value.enum_item->name[0]) {
+    case 'n':
+        /* skip the node */
+        *op = -1;
+        break;
+    case 'c':
+        *op = SR_OP_CREATED;
+        break;
+    case 'd':
+        *op = SR_OP_DELETED;
+        break;
+    case 'r':
+        if (node->schema->nodetype & (LYS_LEAF | LYS_ANYDATA)) {
+            *op = SR_OP_MODIFIED;
+        } else if (node->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) {
+            *op = SR_OP_MOVED;
+        } else {
+            SR_ERRINFO_INT(&err_info);
+            return err_info;
+        }
+        break;
+    default:
+        SR_ERRINFO_INT(&err_info);
+        return err_info;
+    }
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_diff_set_opers(const struct ly_set *set, int8_t **opers)
+{
+    sr_error_info_t *err_info = NULL;
+    struct {
+        const struct lyd_node *node;    /**< Ancestor of the current node. */
+        struct lyd_meta *meta;          /**< Operation of the ancestor, inherited or its own. */
+        const struct lyd_node *meta_node;   /**< Node with the operation. */
+    } *chain = NULL;
+    const struct lyd_node *node, *iter;
+    uint32_t i, d, depth, chain_len = 0, chain_size = 0;
+    void *mem;
+
+    *opers = NULL;
+    if (!set->count) {
+        return NULL;
+    }
+
+    *opers = malloc(set->count * sizeof **opers);
+    SR_CHECK_MEM_GOTO(!*opers, err_info, cleanup);
+
+    /* the set nodes are mostly in the document order so consecutive nodes share most of their ancestors, remember
+     * the operations of the ancestors of the previous node to learn the inherited operation of each node only once */
+    for (i = 0; i < set->count; ++i) {
+        node = set->dnodes[i];
+
+        /* learn the node depth */
+        depth = 0;
+        for (iter = node; iter; iter = lyd_parent(iter)) {
+            ++depth;
+        }
+        if (depth > chain_size) {
+            mem = realloc(chain, depth * sizeof *chain);
+            SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+            chain = mem;
+            chain_size = depth;
+        }
+
+        /* replace the ancestors not shared with the previous node */
+        d = depth;
+        iter = node;
+        while (d && ((d > chain_len) || (chain[d - 1].node != iter))) {
+            chain[d - 1].node = iter;
+            --d;
+            iter = lyd_parent(iter);
+        }
+
+        /* learn their operations */
+        for ( ; d < depth; ++d) {
+            chain[d].meta = lyd_find_meta(chain[d].node->meta, NULL, "yang:operation");
+            if (chain[d].meta) {
+                chain[d].meta_node = chain[d].node;
+            } else if (d) {
+                chain[d].meta = chain[d - 1].meta;
+                chain[d].meta_node = chain[d - 1].meta_node;
+            } else {
+                chain[d].meta_node = NULL;
+            }
+        }
+        chain_len = depth;
+
+        /* decide the operation */
+        if ((err_info = sr_diff_node_oper(node, chain[depth - 1].meta, chain[depth - 1].meta_node, &(*opers)[i]))) {
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    free(chain);
+    if (err_info) {
+        free(*opers);
+        *opers = NULL;
+    }
+    return err_info;
+}
+
 sr_error_info_t *
-sr_diff_set_getnext(struct ly_set *set, uint32_t *idx, struct lyd_node **node, sr_change_oper_t *op)
+sr_diff_set_getnext(const struct ly_set *set, const int8_t *opers, uint32_t *idx, struct lyd_node **node,
+        sr_change_oper_t *op)
 {
     sr_error_info_t *err_info = NULL;
     struct lyd_meta *meta;
     struct lyd_node *parent, *key;
+    int8_t node_op;
 
     while (*idx < set->count) {
         *node = set->dnodes[*idx];
 
-        /* find the (inherited) operation of the current edit node */
-        meta = NULL;
-        for (parent = *node; parent; parent = lyd_parent(parent)) {
-            meta = lyd_find_meta(parent->meta, NULL, "yang:operation");
-            if (meta) {
-                break;
+        if (opers) {
+            /* precomputed operation */
+            node_op = opers[*idx];
+        } else {
+            /* find the (inherited) operation of the current edit node */
+            meta = NULL;
+            for (parent = *node; parent; parent = lyd_parent(parent)) {
+                meta = lyd_find_meta(parent->meta, NULL, "yang:operation");
+                if (meta) {
+                    break;
+                }
+            }
+            if ((err_info = sr_diff_node_oper(*node, meta, parent, &node_op))) {
+                return err_info;
             }
         }
-        if (!meta) {
-            SR_ERRINFO_INT(&err_info);
-            return err_info;
-        }
-
-        if ((parent != *node) && lysc_is_userordered(parent->schema) && (lyd_get_meta_value(meta)[0] == 'r')) {
-            /* do not return changes for descendants of moved userord lists without operation */
-            ++(*idx);
-            continue;
-        }
+        ++(*idx);
 
-        /* decide operation */
-        if (meta->value.enum_item->name[0] == 'n') {
+        if (node_op == -1) {
             /* skip the node */
-            ++(*idx);
-
-            /* in case of lists we want to also skip all their keys */
-            if ((*node)->schema->nodetype == LYS_LIST) {
-                key = set->dnodes[*idx];
-                while ((*idx < set->count) && lysc_is_key(key->schema) && (lyd_parent(key) == *node)) {
-                    ++(*idx);
+            if (!opers && ((*node)->schema->nodetype == LYS_LIST) && (meta->value.enum_item->name[0] == 'n')) {
+                /* in case of lists we want to also skip all their keys */
+                while (*idx < set->count) {
                     key = set->dnodes[*idx];
+                    if (!lysc_is_key(key->schema) || (lyd_parent(key) != *node)) {
+                        break;
+                    }
+                    ++(*idx);
                 }
             }
             continue;
-        } else if (meta->value.enum_item->name[0] == 'c') {
-            *op = SR_OP_CREATED;
-        } else if (meta->value.enum_item->name[0] == 'd') {
-            *op = SR_OP_DELETED;
-        } else if (meta->value.enum_item->name[0] == 'r') {
-            if ((*node)->schema->nodetype & (LYS_LEAF | LYS_ANYDATA)) {
-                *op = SR_OP_MODIFIED;
-            } else if ((*node)->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) {
-                *op = SR_OP_MOVED;
-            } else {
-                SR_ERRINFO_INT(&err_info);
-                return err_info;
-            }
         }
 
         /* success */
-        ++(*idx);
+        *op = node_op;
         return NULL;
     }
 
@@ -3246,106 +3472,1012 @@ sr_diff_set_getnext(struct ly_set *set, uint32_t *idx, struct lyd_node **node, s
     return NULL;
 }
 
+#define SR_CHANGE_LOG_MAGIC "srcl"  /**< Magic of a change log, distinguishes it from LYB data. */
+
+#define SR_CL_KEY       0x01    /**< List key. */
+#define SR_CL_DFLT      0x02    /**< Default node. */
+#define SR_CL_LEAFLIST  0x04    /**< Leaf-list instance. */
+#define SR_CL_USERORD   0x08    /**< User-ordered list or leaf-list instance. */
+#define SR_CL_PREV      0x10    /**< Typed previous value follows the value. */
+
 /**
- * @brief Relink and adjust edit node from stored oper data into change edit for subscribers.
+ * @brief Change log header.
  *
- * @param[in] node Edit node, is used.
- * @param[in,out] change_edit Change edit to append to. If NULL, do not generate change edit.
+ * It is followed by the entries of all the diff nodes in the depth-first order, each of them:
+ * - uint32_t depth, 0 for top-level nodes,
+ * - uint8_t flags (SR_CL_*),
+ * - uint8_t ::sr_val_type_t of the node,
+ * - char first letter of its own diff operation, 0 if inherited,
+ * - path segment of the node, from its parent,
+ * - only for terminal nodes, canonical value and the typed value for non-string types,
+ * - only with ::SR_CL_PREV, uint8_t ::sr_val_type_t, canonical and typed value of the previous value,
+ * - uint16_t count of the other metadata, each of them with its name and value.
+ *
+ * Strings are stored with their uint32_t length and terminated, typed values as ::sr_val_data_t.
+ */
+struct sr_change_log_hdr_s {
+    char magic[4];              /**< ::SR_CHANGE_LOG_MAGIC */
+    uint32_t size;              /**< Size of the whole change log, including the header. */
+    uint32_t count;             /**< Count of the entries. */
+};
+
+/**
+ * @brief Read change log entry.
+ */
+struct sr_change_log_entry_s {
+    uint32_t depth;             /**< Depth of the node. */
+    uint8_t flags;              /**< SR_CL_* flags. */
+    sr_val_type_t type;         /**< Value type of the node. */
+    char op;                    /**< First letter of the own operation of the node, 0 if inherited. */
+    const char *segment;        /**< Path segment. */
+    uint32_t segment_len;       /**< Length of segment. */
+    const char *value;          /**< Canonical value, NULL if not a term. */
+    sr_val_data_t data;         /**< Typed value. */
+    sr_val_type_t prev_type;    /**< Type of the previous value. */
+    const char *prev_value;     /**< Canonical previous value. */
+    sr_val_data_t prev_data;    /**< Typed previous value. */
+    uint16_t meta_count;        /**< Count of the other metadata. */
+    const char *metas;          /**< Serialized other metadata. */
+    const char *end;            /**< End of the entry. */
+};
+
+/**
+ * @brief Change log iterator.
+ */
+struct sr_change_log_iter_s {
+    const char *pos;            /**< Next entry. */
+    const char *end;            /**< End of the change log. */
+    uint32_t remaining;         /**< Number of remaining entries. */
+    char *mod_name;             /**< Optional module of the selected changes. */
+    int skip;                   /**< Whether the current top-level subtree is skipped. */
+
+    struct {
+        uint32_t path_len;      /**< Path length of the ancestor. */
+        char op;                /**< Operation of the ancestor, inherited or its own. */
+        int moved;              /**< Whether the operation is a move of a user-ordered ancestor. */
+    } *chain;                   /**< Ancestors of the current entry. */
+    uint32_t chain_size;        /**< Allocated size of chain. */
+    char *path;                 /**< Path of the current entry. */
+    uint32_t path_size;         /**< Allocated size of path. */
+};
+
+/**
+ * @brief Change log being printed.
+ */
+struct sr_change_log_buf_s {
+    char *data;                 /**< Printed data. */
+    uint32_t len;               /**< Length of data. */
+    uint32_t size;              /**< Allocated size of data. */
+};
+
+/**
+ * @brief Append data to a change log.
+ *
+ * @param[in] buf Change log buffer.
+ * @param[in] src Data to append.
+ * @param[in] len Length of @p src.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_edit_oper_del_node(struct lyd_node *node, struct lyd_node **change_edit)
+sr_change_log_write(struct sr_change_log_buf_s *buf, const void *src, uint32_t len)
 {
     sr_error_info_t *err_info = NULL;
-    struct lyd_node *iter, *new_parent, *parent, *match;
-    enum edit_op op, cur_op;
-    int own_op;
+    void *mem;
 
-    if (!change_edit) {
-        /* nothing to do */
-        goto cleanup;
+    if (buf->len + len > buf->size) {
+        buf->size = (buf->len + len) * 2;
+        mem = realloc(buf->data, buf->size);
+        SR_CHECK_MEM_RET(!mem, err_info);
+        buf->data = mem;
     }
 
-    /* find parents in the change edit */
-    if ((err_info = sr_edit_diff_create_parents(node, change_edit, &new_parent, &parent))) {
-        goto cleanup;
-    }
+    memcpy(buf->data + buf->len, src, len);
+    buf->len += len;
+    return NULL;
+}
 
-    /* learn the operation */
-    op = sr_edit_diff_find_oper(node, 1, &own_op);
-    assert(op);
-    if ((op == EDIT_MERGE) || (op == EDIT_REMOVE)) {
-        /* reverse operation */
-        if (op == EDIT_MERGE) {
-            op = EDIT_REMOVE;
-        } else {
-            op = EDIT_MERGE;
-        }
-    } /* else ether - stays */
+/**
+ * @brief Append a string to a change log.
+ *
+ * @param[in] buf Change log buffer.
+ * @param[in] prefix Optional prefix of the string, separated by a colon.
+ * @param[in] str String to append.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_change_log_write_str(struct sr_change_log_buf_s *buf, const char *prefix, const char *str)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t len;
 
-    if (new_parent || lyd_find_sibling_first(parent ? lyd_child(parent) : *change_edit, node, &match)) {
-        /* set parent operation, if any new */
-        if (new_parent && (err_info = sr_edit_set_oper(new_parent, "ether"))) {
-            goto cleanup;
+    len = (prefix ? strlen(prefix) + 1 : 0) + strlen(str);
+    if ((err_info = sr_change_log_write(buf, &len, sizeof len))) {
+        return err_info;
+    }
+    if (prefix) {
+        if ((err_info = sr_change_log_write(buf, prefix, strlen(prefix))) || (err_info = sr_change_log_write(buf, ":", 1))) {
+            return err_info;
         }
+    }
+    return sr_change_log_write(buf, str, strlen(str) + 1);
+}
 
-        /* remove all the operations in the subtree and set the new one */
-        LYD_TREE_DFS_BEGIN(node, iter) {
-            sr_edit_del_meta_attr(iter, "operation");
-            LYD_TREE_DFS_END(node, iter);
-        }
-        if ((err_info = sr_edit_set_oper(node, sr_edit_op2str(op)))) {
-            goto cleanup;
-        }
+/**
+ * @brief Append a terminal value to a change log.
+ *
+ * @param[in] buf Change log buffer.
+ * @param[in] canon Canonical value.
+ * @param[in] val Typed value.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_change_log_write_term(struct sr_change_log_buf_s *buf, const char *canon, const sr_val_t *val)
+{
+    sr_error_info_t *err_info = NULL;
 
-        /* link to the change edit */
-        lyd_unlink_tree(node);
-        if (parent) {
-            lyd_insert_child(parent, node);
-        } else {
-            lyd_insert_sibling(*change_edit, node, change_edit);
-        }
-        node = NULL;
-    } else {
-        /* node already exists so keep it, learn its operation */
-        cur_op = sr_edit_diff_find_oper(match, 1, &own_op);
+    if ((err_info = sr_change_log_write_str(buf, NULL, canon))) {
+        return err_info;
+    }
+    if (!sr_val_type_is_str(val->type) && (val->type != SR_LEAF_EMPTY_T)) {
+        return sr_change_log_write(buf, &val->data, sizeof val->data);
+    }
+    return NULL;
+}
 
-        if (cur_op != op) {
-            /* remove current operation */
-            if (own_op) {
-                sr_edit_del_meta_attr(match, "operation");
-            }
+/**
+ * @brief Append the typed previous value of a terminal node to a change log.
+ *
+ * @param[in] buf Change log buffer.
+ * @param[in] node Diff node.
+ * @param[in] value_str Previous value of @p node.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_change_log_write_prev(struct sr_change_log_buf_s *buf, const struct lyd_node *node, const char *value_str)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *node_dup = NULL;
+    sr_val_t val;
+    uint8_t type;
+    LY_ERR lyrc;
 
-            /* set new operation */
-            if ((err_info = sr_edit_set_oper(match, sr_edit_op2str(op)))) {
-                goto cleanup;
-            }
-        }
+    /* store the previous value in a node copy to learn its type */
+    if (lyd_dup_single(node, NULL, 0, &node_dup)) {
+        sr_errinfo_new_ly(&err_info, LYD_CTX(node), NULL);
+        goto cleanup;
+    }
+    lyrc = lyd_change_term(node_dup, value_str);
+    if (lyrc && (lyrc != LY_EEXIST) && (lyrc != LY_ENOT)) {
+        sr_errinfo_new_ly(&err_info, LYD_CTX(node), NULL);
+        goto cleanup;
+    }
+    if ((err_info = sr_val_ly2sr_data(node_dup, &val))) {
+        goto cleanup;
+    }
+
+    type = val.type;
+    if ((err_info = sr_change_log_write(buf, &type, sizeof type))) {
+        goto cleanup;
+    }
+    if ((err_info = sr_change_log_write_term(buf, lyd_get_value(node_dup), &val))) {
+        goto cleanup;
     }
 
 cleanup:
-    lyd_free_tree(node);
+    lyd_free_tree(node_dup);
     return err_info;
 }
 
 /**
- * @brief Update a stored edit subtree by deleting nodes belonging to a connection and optionally selected by an xpath.
+ * @brief Append the entry of a diff node to a change log.
  *
- * @param[in] subtree Subtree to update, may be freed.
- * @param[in] cid CID of the deleted connection.
- * @param[in] parent_cid CID effective for (inherited from) the @p subtree parent.
- * @param[in] set Set of nodes selected by an xpath, only these can be deleted. If NULL, all the nodes can be deleted.
- * @param[out] child_cid_p CID effective for the @p subtree, 0 if it was deleted.
- * @param[in,out] change_edit Optional change edit created for subscribers based on the changes made in oper edit.
+ * @param[in] buf Change log buffer.
+ * @param[in] node Diff node.
+ * @param[in] depth Depth of @p node.
+ * @param[in] segment Path segment of @p node.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_edit_oper_del_r(struct lyd_node *subtree, sr_cid_t cid, sr_cid_t parent_cid, struct ly_set *set,
-        sr_cid_t *child_cid_p, struct lyd_node **change_edit)
+sr_change_log_write_entry(struct sr_change_log_buf_s *buf, const struct lyd_node *node, uint32_t depth,
+        const char *segment)
 {
     sr_error_info_t *err_info = NULL;
-    struct lyd_node *next, *child;
-    sr_cid_t cur_cid, child_cid, ch_cid;
+    struct lyd_meta *meta, *prev_meta = NULL;
+    sr_val_t val;
+    uint8_t flags = 0, type;
+    uint16_t meta_count = 0;
+    char op = 0;
+
+    if ((err_info = sr_val_ly2sr_data(node, &val))) {
+        return err_info;
+    }
+
+    /* learn the flags and the operation */
+    if (lysc_is_key(node->schema)) {
+        flags |= SR_CL_KEY;
+    }
+    if (node->flags & LYD_DEFAULT) {
+        flags |= SR_CL_DFLT;
+    }
+    if (node->schema->nodetype == LYS_LEAFLIST) {
+        flags |= SR_CL_LEAFLIST;
+    }
+    if (lysc_is_userordered(node->schema)) {
+        flags |= SR_CL_USERORD;
+    }
+    LY_LIST_FOR(node->meta, meta) {
+        if (!strcmp(meta->annotation->module->name, "yang") && !strcmp(meta->name, "operation")) {
+            op = lyd_get_meta_value(meta)[0];
+            continue;
+        }
+        ++meta_count;
+
+        if ((node->schema->nodetype == LYS_LEAF) && !strcmp(meta->name, "orig-value")) {
+            /* previous value of a modified leaf */
+            prev_meta = meta;
+        } else if ((node->schema->nodetype == LYS_LEAFLIST) && !strcmp(meta->name, "value") &&
+                lyd_get_meta_value(meta)[0]) {
+            /* previous instance of a created or moved leaf-list instance */
+            prev_meta = meta;
+        }
+    }
+    if (prev_meta) {
+        flags |= SR_CL_PREV;
+    }
+
+    type = val.type;
+    if ((err_info = sr_change_log_write(buf, &depth, sizeof depth)) ||
+            (err_info = sr_change_log_write(buf, &flags, sizeof flags)) ||
+            (err_info = sr_change_log_write(buf, &type, sizeof type)) ||
+            (err_info = sr_change_log_write(buf, &op, sizeof op))) {
+        return err_info;
+    }
+    if ((err_info = sr_change_log_write_str(buf, NULL, segment))) {
+        return err_info;
+    }
+
+    /* values */
+    if (node->schema->nodetype & LYD_NODE_TERM) {
+        if ((err_info = sr_change_log_write_term(buf, lyd_get_value(node), &val))) {
+            return err_info;
+        }
+    }
+    if (prev_meta && (err_info = sr_change_log_write_prev(buf, node, lyd_get_meta_value(prev_meta)))) {
+        return err_info;
+    }
+
+    /* other metadata */
+    if ((err_info = sr_change_log_write(buf, &meta_count, sizeof meta_count))) {
+        return err_info;
+    }
+    LY_LIST_FOR(node->meta, meta) {
+        if (!strcmp(meta->annotation->module->name, "yang") && !strcmp(meta->name, "operation")) {
+            continue;
+        }
+
+        if ((err_info = sr_change_log_write_str(buf, meta->annotation->module->name, meta->name))) {
+            return err_info;
+        }
+        if ((err_info = sr_change_log_write_str(buf, NULL, lyd_get_meta_value(meta)))) {
+            return err_info;
+        }
+    }
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_change_log_print(const struct lyd_node *diff, char **log, uint32_t *log_len)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_change_log_buf_s buf = {0};
+    struct sr_change_log_hdr_s hdr = {0};
+    const struct lyd_node *root, *elem, *iter;
+    uint32_t depth, *path_lens = NULL, path_lens_size = 0;
+    char *path = NULL;
+    void *mem;
+    int supported = 1;
+
+    *log = NULL;
+    *log_len = 0;
+
+    /* header, updated at the end */
+    memcpy(hdr.magic, SR_CHANGE_LOG_MAGIC, sizeof hdr.magic);
+    if ((err_info = sr_change_log_write(&buf, &hdr, sizeof hdr))) {
+        goto cleanup;
+    }
+
+    LY_LIST_FOR(diff, root) {
+        LYD_TREE_DFS_BEGIN(root, elem) {
+            if (!elem->schema || (elem->flags & LYD_EXT) || (elem->schema->nodetype & LYS_ANYDATA) ||
+                    lysc_is_dup_inst_list(elem->schema)) {
+                /* opaque, extension, anydata, and duplicate-instance nodes cannot be logged */
+                supported = 0;
+                goto cleanup;
+            }
+
+            /* learn the depth */
+            depth = 0;
+            for (iter = lyd_parent(elem); iter; iter = lyd_parent(iter)) {
+                ++depth;
+            }
+            if (depth >= path_lens_size) {
+                mem = realloc(path_lens, (depth + 1) * sizeof *path_lens);
+                SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+                path_lens = mem;
+                path_lens_size = depth + 1;
+            }
+
+            /* the path of every node is the path of its parent followed by its segment */
+            free(path);
+            path = lyd_path(elem, LYD_PATH_STD, NULL, 0);
+            SR_CHECK_MEM_GOTO(!path, err_info, cleanup);
+            path_lens[depth] = strlen(path);
+
+            if ((err_info = sr_change_log_write_entry(&buf, elem, depth,
+                    path + (depth ? path_lens[depth - 1] : 0) + 1))) {
+                goto cleanup;
+            }
+            ++hdr.count;
+
+            LYD_TREE_DFS_END(root, elem);
+        }
+    }
+
+    /* update the header */
+    hdr.size = buf.len;
+    memcpy(buf.data, &hdr, sizeof hdr);
+
+cleanup:
+    free(path);
+    free(path_lens);
+    if (err_info || !supported) {
+        free(buf.data);
+    } else {
+        *log = buf.data;
+        *log_len = buf.len;
+    }
+    return err_info;
+}
+
+int
+sr_change_log_is(const char *data)
+{
+    return !memcmp(data, SR_CHANGE_LOG_MAGIC, strlen(SR_CHANGE_LOG_MAGIC));
+}
+
+uint32_t
+sr_change_log_size(const char *log)
+{
+    struct sr_change_log_hdr_s hdr;
+
+    memcpy(&hdr, log, sizeof hdr);
+    return hdr.size;
+}
+
+/**
+ * @brief Read data from a change log.
+ *
+ * @param[in,out] pos Current position, is moved.
+ * @param[in] end End of the change log.
+ * @param[out] dst Read data.
+ * @param[in] len Length of the data.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_change_log_read(const char **pos, const char *end, void *dst, uint32_t len)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_INT_RET(*pos + len > end, err_info);
+
+    memcpy(dst, *pos, len);
+    *pos += len;
+    return NULL;
+}
+
+/**
+ * @brief Read a string from a change log.
+ *
+ * @param[in,out] pos Current position, is moved.
+ * @param[in] end End of the change log.
+ * @param[out] str Read string, points into the change log.
+ * @param[out] str_len Optional length of @p str.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_change_log_read_str(const char **pos, const char *end, const char **str, uint32_t *str_len)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t len;
+
+    if ((err_info = sr_change_log_read(pos, end, &len, sizeof len))) {
+        return err_info;
+    }
+    SR_CHECK_INT_RET((*pos + len + 1 > end) || (*pos)[len], err_info);
+
+    *str = *pos;
+    if (str_len) {
+        *str_len = len;
+    }
+    *pos += len + 1;
+    return NULL;
+}
+
+/**
+ * @brief Read a terminal value from a change log.
+ *
+ * @param[in,out] pos Current position, is moved.
+ * @param[in] end End of the change log.
+ * @param[in] type Value type.
+ * @param[out] value Canonical value.
+ * @param[out] data Typed value.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_change_log_read_term(const char **pos, const char *end, sr_val_type_t type, const char **value, sr_val_data_t *data)
+{
+    sr_error_info_t *err_info = NULL;
+
+    if ((err_info = sr_change_log_read_str(pos, end, value, NULL))) {
+        return err_info;
+    }
+    if (!sr_val_type_is_str(type) && (type != SR_LEAF_EMPTY_T)) {
+        return sr_change_log_read(pos, end, data, sizeof *data);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Read the next change log entry.
+ *
+ * @param[in,out] pos Current position, is moved after the entry.
+ * @param[in] end End of the change log.
+ * @param[out] entry Read entry.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_change_log_read_entry(const char **pos, const char *end, struct sr_change_log_entry_s *entry)
+{
+    sr_error_info_t *err_info = NULL;
+    const char *str;
+    uint8_t type;
+    uint16_t i;
+
+    memset(entry, 0, sizeof *entry);
+
+    if ((err_info = sr_change_log_read(pos, end, &entry->depth, sizeof entry->depth)) ||
+            (err_info = sr_change_log_read(pos, end, &entry->flags, sizeof entry->flags)) ||
+            (err_info = sr_change_log_read(pos, end, &type, sizeof type)) ||
+            (err_info = sr_change_log_read(pos, end, &entry->op, sizeof entry->op))) {
+        return err_info;
+    }
+    entry->type = type;
+    if ((err_info = sr_change_log_read_str(pos, end, &entry->segment, &entry->segment_len))) {
+        return err_info;
+    }
+
+    /* values */
+    if ((entry->type != SR_CONTAINER_T) && (entry->type != SR_CONTAINER_PRESENCE_T) && (entry->type != SR_LIST_T)) {
+        if ((err_info = sr_change_log_read_term(pos, end, entry->type, &entry->value, &entry->data))) {
+            return err_info;
+        }
+    }
+    if (entry->flags & SR_CL_PREV) {
+        if ((err_info = sr_change_log_read(pos, end, &type, sizeof type))) {
+            return err_info;
+        }
+        entry->prev_type = type;
+        if ((err_info = sr_change_log_read_term(pos, end, entry->prev_type, &entry->prev_value, &entry->prev_data))) {
+            return err_info;
+        }
+    }
+
+    /* other metadata, only checked */
+    if ((err_info = sr_change_log_read(pos, end, &entry->meta_count, sizeof entry->meta_count))) {
+        return err_info;
+    }
+    entry->metas = *pos;
+    for (i = 0; i < 2 * entry->meta_count; ++i) {
+        if ((err_info = sr_change_log_read_str(pos, end, &str, NULL))) {
+            return err_info;
+        }
+    }
+    entry->end = *pos;
+
+    return NULL;
+}
+
+/**
+ * @brief Get the value of a metadata of a change log entry.
+ *
+ * @param[in] entry Change log entry.
+ * @param[in] name Metadata name with the module prefix.
+ * @return Metadata value, NULL if not found.
+ */
+static const char *
+sr_change_log_entry_meta(const struct sr_change_log_entry_s *entry, const char *name)
+{
+    const char *pos = entry->metas, *meta_name, *meta_value;
+    uint16_t i;
+
+    /* already checked */
+    for (i = 0; i < entry->meta_count; ++i) {
+        sr_change_log_read_str(&pos, entry->end, &meta_name, NULL);
+        sr_change_log_read_str(&pos, entry->end, &meta_value, NULL);
+        if (!strcmp(meta_name, name)) {
+            return meta_value;
+        }
+    }
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_change_log_diff(const struct ly_ctx *ly_ctx, const char *log, struct lyd_node **diff)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_change_log_hdr_s hdr;
+    struct sr_change_log_entry_s entry;
+    struct lyd_node **parents = NULL, *node;
+    const char *pos, *end, *meta_pos, *meta_name, *meta_value, *op_name;
+    char *path = NULL;
+    uint32_t i, parent_count = 0;
+    uint16_t j;
+    void *mem;
+
+    *diff = NULL;
+
+    memcpy(&hdr, log, sizeof hdr);
+    pos = log + sizeof hdr;
+    end = log + hdr.size;
+
+    for (i = 0; i < hdr.count; ++i) {
+        if ((err_info = sr_change_log_read_entry(&pos, end, &entry))) {
+            goto cleanup;
+        }
+        SR_CHECK_INT_GOTO(entry.depth > parent_count, err_info, cleanup);
+
+        /* create the node */
+        if (entry.flags & SR_CL_KEY) {
+            /* created with its list */
+            SR_CHECK_INT_GOTO(!entry.depth, err_info, cleanup);
+            if (lyd_find_path(parents[entry.depth - 1], entry.segment, 0, &node)) {
+                sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+                goto cleanup;
+            }
+        } else if (!entry.depth) {
+            if (asprintf(&path, "/%s", entry.segment) == -1) {
+                SR_ERRINFO_MEM(&err_info);
+                goto cleanup;
+            }
+            if (lyd_new_path(NULL, ly_ctx, path, (entry.flags & SR_CL_LEAFLIST) ? NULL : entry.value, 0, &node)) {
+                sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+                goto cleanup;
+            }
+            free(path);
+            path = NULL;
+            lyd_insert_sibling(*diff, node, diff);
+        } else {
+            if (lyd_new_path(parents[entry.depth - 1], NULL, entry.segment,
+                    (entry.flags & SR_CL_LEAFLIST) ? NULL : entry.value, 0, &node)) {
+                sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+                goto cleanup;
+            }
+        }
+        if (entry.flags & SR_CL_DFLT) {
+            node->flags |= LYD_DEFAULT;
+        }
+
+        /* operation */
+        if (entry.op) {
+            switch (entry.op) {
+            case 'c':
+                op_name = "create";
+                break;
+            case 'd':
+                op_name = "delete";
+                break;
+            case 'r':
+                op_name = "replace";
+                break;
+            case 'n':
+                op_name = "none";
+                break;
+            default:
+                SR_ERRINFO_INT(&err_info);
+                goto cleanup;
+            }
+            if (lyd_new_meta(NULL, node, NULL, "yang:operation", op_name, 0, NULL)) {
+                sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+                goto cleanup;
+            }
+        }
+
+        /* other metadata */
+        meta_pos = entry.metas;
+        for (j = 0; j < entry.meta_count; ++j) {
+            sr_change_log_read_str(&meta_pos, entry.end, &meta_name, NULL);
+            sr_change_log_read_str(&meta_pos, entry.end, &meta_value, NULL);
+            if (lyd_new_meta(NULL, node, NULL, meta_name, meta_value, 0, NULL)) {
+                sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+                goto cleanup;
+            }
+        }
+
+        /* remember as a parent of the next entries */
+        if (entry.depth == parent_count) {
+            mem = realloc(parents, (parent_count + 1) * sizeof *parents);
+            SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+            parents = mem;
+        }
+        parents[entry.depth] = node;
+        parent_count = entry.depth + 1;
+    }
+
+cleanup:
+    free(path);
+    free(parents);
+    if (err_info) {
+        lyd_free_all(*diff);
+        *diff = NULL;
+    }
+    return err_info;
+}
+
+sr_error_info_t *
+sr_change_log_session_diff(sr_session_ctx_t *session)
+{
+    if (session->dt[session->ds].diff || !session->dt[session->ds].change_log) {
+        /* nothing to build */
+        return NULL;
+    }
+
+    /* the change log is kept because iterators may use it */
+    return sr_change_log_diff(session->conn->ly_ctx, session->dt[session->ds].change_log,
+            &session->dt[session->ds].diff);
+}
+
+sr_error_info_t *
+sr_change_log_iter_new(const char *log, const char *xpath, struct sr_change_log_iter_s **iter)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_change_log_hdr_s hdr;
+    const char *ptr;
+    char *mod_name = NULL;
+
+    *iter = NULL;
+
+    /* only all the changes, or all the changes of a module, can be selected without the diff */
+    if (strcmp(xpath, "//.")) {
+        if ((xpath[0] != '/') || !(ptr = strchr(xpath, ':')) || strcmp(ptr, ":*//.") || (ptr == xpath + 1)) {
+            return NULL;
+        }
+        mod_name = strndup(xpath + 1, ptr - (xpath + 1));
+        SR_CHECK_MEM_RET(!mod_name, err_info);
+    }
+
+    *iter = calloc(1, sizeof **iter);
+    if (!*iter) {
+        free(mod_name);
+        SR_ERRINFO_MEM(&err_info);
+        return err_info;
+    }
+
+    memcpy(&hdr, log, sizeof hdr);
+    (*iter)->pos = log + sizeof hdr;
+    (*iter)->end = log + hdr.size;
+    (*iter)->remaining = hdr.count;
+    (*iter)->mod_name = mod_name;
+
+    return NULL;
+}
+
+/**
+ * @brief Create a sysrepo value from a change log entry.
+ *
+ * @param[in] xpath Path of the value.
+ * @param[in] xpath_len Length of @p xpath to use.
+ * @param[in] anchor Optional list keys predicate to append to @p xpath.
+ * @param[in] type Value type.
+ * @param[in] value Canonical value.
+ * @param[in] data Typed value.
+ * @param[in] dflt Default flag of the value.
+ * @param[out] sr_val_p Created sysrepo value.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_change_log_val(const char *xpath, uint32_t xpath_len, const char *anchor, sr_val_type_t type, const char *value,
+        const sr_val_data_t *data, int dflt, sr_val_t **sr_val_p)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_val_t *sr_val;
+
+    sr_val = calloc(1, sizeof *sr_val);
+    SR_CHECK_MEM_GOTO(!sr_val, err_info, cleanup);
+
+    sr_val->xpath = malloc(xpath_len + (anchor ? strlen(anchor) : 0) + 1);
+    SR_CHECK_MEM_GOTO(!sr_val->xpath, err_info, cleanup);
+    memcpy(sr_val->xpath, xpath, xpath_len);
+    strcpy(sr_val->xpath + xpath_len, anchor ? anchor : "");
+
+    sr_val->type = type;
+    sr_val->dflt = dflt;
+    if (sr_val_type_is_str(type)) {
+        sr_val->data.string_val = strdup(value);
+        SR_CHECK_MEM_GOTO(!sr_val->data.string_val, err_info, cleanup);
+    } else if ((type != SR_CONTAINER_T) && (type != SR_CONTAINER_PRESENCE_T) && (type != SR_LIST_T) &&
+            (type != SR_LEAF_EMPTY_T)) {
+        sr_val->data = *data;
+    }
+
+cleanup:
+    if (err_info) {
+        if (sr_val) {
+            free(sr_val->xpath);
+        }
+        free(sr_val);
+    } else {
+        *sr_val_p = sr_val;
+    }
+    return err_info;
+}
+
+sr_error_info_t *
+sr_change_log_iter_next(struct sr_change_log_iter_s *iter, sr_change_oper_t *op, sr_val_t **old_value,
+        sr_val_t **new_value)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_change_log_entry_s entry;
+    const char *anchor, *dflt;
+    uint32_t d, parent_len, pred_len;
+    char node_op;
+    int moved;
+    void *mem;
+
+    *old_value = NULL;
+    *new_value = NULL;
+
+    while (iter->remaining) {
+        if ((err_info = sr_change_log_read_entry(&iter->pos, iter->end, &entry))) {
+            return err_info;
+        }
+        --iter->remaining;
+        d = entry.depth;
+
+        /* select only the changes of the module */
+        if (!d) {
+            iter->skip = iter->mod_name && (strncmp(entry.segment, iter->mod_name, strlen(iter->mod_name)) ||
+                    (entry.segment[strlen(iter->mod_name)] != ':'));
+        }
+        if (iter->skip) {
+            continue;
+        }
+
+        /* learn the path and the (inherited) operation */
+        SR_CHECK_INT_RET(d && (d > iter->chain_size), err_info);
+        if (d == iter->chain_size) {
+            mem = realloc(iter->chain, (d + 1) * sizeof *iter->chain);
+            SR_CHECK_MEM_RET(!mem, err_info);
+            iter->chain = mem;
+            iter->chain_size = d + 1;
+        }
+        parent_len = d ? iter->chain[d - 1].path_len : 0;
+        if (parent_len + 1 + entry.segment_len + 1 > iter->path_size) {
+            iter->path_size = (parent_len + 1 + entry.segment_len + 1) * 2;
+            mem = realloc(iter->path, iter->path_size);
+            SR_CHECK_MEM_RET(!mem, err_info);
+            iter->path = mem;
+        }
+        iter->path[parent_len] = '/';
+        memcpy(iter->path + parent_len + 1, entry.segment, entry.segment_len + 1);
+        iter->chain[d].path_len = parent_len + 1 + entry.segment_len;
+
+        if (entry.op) {
+            node_op = entry.op;
+            moved = 0;
+            iter->chain[d].op = entry.op;
+            iter->chain[d].moved = (entry.flags & SR_CL_USERORD) && (entry.op == 'r');
+        } else {
+            SR_CHECK_INT_RET(!d, err_info);
+            node_op = iter->chain[d - 1].op;
+            moved = iter->chain[d - 1].moved;
+            iter->chain[d].op = node_op;
+            iter->chain[d].moved = moved;
+        }
+
+        if (moved || (node_op == 'n')) {
+            /* descendants of moved user-ordered nodes and nodes without an operation are not changes */
+            continue;
+        }
+
+        /* length of the path without the predicate of the node */
+        pred_len = entry.segment_len;
+        if ((anchor = strchr(entry.segment, '['))) {
+            pred_len = anchor - entry.segment;
+        }
+        pred_len = parent_len + 1 + pred_len;
+
+        /* create values */
+        switch (node_op) {
+        case 'c':
+        case 'd':
+            if ((node_op == 'c') && (entry.flags & SR_CL_USERORD)) {
+                *op = SR_OP_CREATED;
+                goto userord;
+            }
+            err_info = sr_change_log_val(iter->path, (entry.flags & SR_CL_LEAFLIST) ? pred_len :
+                    iter->chain[d].path_len, NULL, entry.type, entry.value, &entry.data, entry.flags & SR_CL_DFLT,
+                    (node_op == 'c') ? new_value : old_value);
+            *op = (node_op == 'c') ? SR_OP_CREATED : SR_OP_DELETED;
+            return err_info;
+        case 'r':
+            if ((entry.type == SR_LIST_T) || (entry.flags & SR_CL_LEAFLIST)) {
+                *op = SR_OP_MOVED;
+                goto userord;
+            }
+            SR_CHECK_INT_RET((entry.type == SR_CONTAINER_T) || (entry.type == SR_CONTAINER_PRESENCE_T), err_info);
+
+            /* modified leaf */
+            dflt = sr_change_log_entry_meta(&entry, "yang:orig-default");
+            SR_CHECK_INT_RET(!(entry.flags & SR_CL_PREV) || !dflt, err_info);
+            if ((err_info = sr_change_log_val(iter->path, iter->chain[d].path_len, NULL, entry.prev_type,
+                    entry.prev_value, &entry.prev_data, !strcmp(dflt, "true"), old_value))) {
+                return err_info;
+            }
+            *op = SR_OP_MODIFIED;
+            goto new_value;
+        default:
+            SR_ERRINFO_INT(&err_info);
+            return err_info;
+        }
+
+userord:
+        /* metadata contains the instance before in the order */
+        anchor = sr_change_log_entry_meta(&entry, (entry.flags & SR_CL_LEAFLIST) ? "yang:value" : "yang:key");
+        SR_CHECK_INT_RET(!anchor, err_info);
+        if (anchor[0]) {
+            if (entry.flags & SR_CL_LEAFLIST) {
+                SR_CHECK_INT_RET(!(entry.flags & SR_CL_PREV), err_info);
+                err_info = sr_change_log_val(iter->path, pred_len, NULL, entry.prev_type, entry.prev_value,
+                        &entry.prev_data, entry.flags & SR_CL_DFLT, old_value);
+            } else {
+                err_info = sr_change_log_val(iter->path, pred_len, anchor, entry.type, NULL, NULL,
+                        entry.flags & SR_CL_DFLT, old_value);
+            }
+            if (err_info) {
+                return err_info;
+            }
+        }
+
+new_value:
+        if ((err_info = sr_change_log_val(iter->path, (entry.flags & SR_CL_LEAFLIST) ? pred_len :
+                iter->chain[d].path_len, NULL, entry.type, entry.value, &entry.data, entry.flags & SR_CL_DFLT,
+                new_value))) {
+            sr_free_val(*old_value);
+            *old_value = NULL;
+            return err_info;
+        }
+        return NULL;
+    }
+
+    /* no more changes */
+    return NULL;
+}
+
+void
+sr_change_log_iter_free(struct sr_change_log_iter_s *iter)
+{
+    if (!iter) {
+        return;
+    }
+
+    free(iter->mod_name);
+    free(iter->chain);
+    free(iter->path);
+    free(iter);
+}
+
+/**
+ * @brief Relink and adjust edit node from stored oper data into change edit for subscribers.
+ *
+ * @param[in] node Edit node, is used.
+ * @param[in,out] change_edit Change edit to append to. If NULL, do not generate change edit.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_edit_oper_del_node(struct lyd_node *node, struct lyd_node **change_edit)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *iter, *new_parent, *parent, *match;
+    enum edit_op op, cur_op;
+    int own_op;
+
+    if (!change_edit) {
+        /* nothing to do */
+        goto cleanup;
+    }
+
+    /* find parents in the change edit */
+    if ((err_info = sr_edit_diff_create_parents(node, change_edit, &new_parent, &parent))) {
+        goto cleanup;
+    }
+
+    /* learn the operation */
+    op = sr_edit_diff_find_oper(node, 1, &own_op);
+    assert(op);
+    if ((op == EDIT_MERGE) || (op == EDIT_REMOVE)) {
+        /* reverse operation */
+        if (op == EDIT_MERGE) {
+            op = EDIT_REMOVE;
+        } else {
+            op = EDIT_MERGE;
+        }
+    } /* else ether - stays */
+
+    if (new_parent || lyd_find_sibling_first(parent ? lyd_child(parent) : *change_edit, node, &match)) {
+        /* set parent operation, if any new */
+        if (new_parent && (err_info = sr_edit_set_oper(new_parent, "ether"))) {
+            goto cleanup;
+        }
+
+        /* remove all the operations in the subtree and set the new one */
+        LYD_TREE_DFS_BEGIN(node, iter) {
+            sr_edit_del_meta_attr(iter, "operation");
+            LYD_TREE_DFS_END(node, iter);
+        }
+        if ((err_info = sr_edit_set_oper(node, sr_edit_op2str(op)))) {
+            goto cleanup;
+        }
+
+        /* link to the change edit */
+        lyd_unlink_tree(node);
+        if (parent) {
+            lyd_insert_child(parent, node);
+        } else {
+            lyd_insert_sibling(*change_edit, node, change_edit);
+        }
+        node = NULL;
+    } else {
+        /* node already exists so keep it, learn its operation */
+        cur_op = sr_edit_diff_find_oper(match, 1, &own_op);
+
+        if (cur_op != op) {
+            /* remove current operation */
+            if (own_op) {
+                sr_edit_del_meta_attr(match, "operation");
+            }
+
+            /* set new operation */
+            if ((err_info = sr_edit_set_oper(match, sr_edit_op2str(op)))) {
+                goto cleanup;
+            }
+        }
+    }
+
+cleanup:
+    lyd_free_tree(node);
+    return err_info;
+}
+
+/**
+ * @brief Update a stored edit subtree by deleting nodes belonging to a connection and optionally selected by an xpath.
+ *
+ * @param[in] subtree Subtree to update, may be freed.
+ * @param[in] cid CID of the deleted connection.
+ * @param[in] parent_cid CID effective for (inherited from) the @p subtree parent.
+ * @param[in] set Set of nodes selected by an xpath, only these can be deleted. If NULL, all the nodes can be deleted.
+ * @param[out] child_cid_p CID effective for the @p subtree, 0 if it was deleted.
+ * @param[in,out] change_edit Optional change edit created for subscribers based on the changes made in oper edit.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_edit_oper_del_r(struct lyd_node *subtree, sr_cid_t cid, sr_cid_t parent_cid, struct ly_set *set,
+        sr_cid_t *child_cid_p, struct lyd_node **change_edit)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *next, *child;
+    sr_cid_t cur_cid, child_cid, ch_cid;
     int cid_own;
     char cid_str[11];
 
@@ -3440,3 +4572,243 @@ cleanup:
     ly_set_free(set, NULL);
     return err_info;
 }
+
+sr_error_info_t *
+sr_edit_oper_value_update(struct lyd_node *edit, sr_cid_t cid, const char *path, const char *value,
+        struct lyd_node **diff, int *change)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *node = NULL;
+    sr_cid_t node_cid;
+    LY_ERR lyrc;
+
+    *change = 0;
+
+    /* find the stored leaf */
+    if (edit) {
+        lyrc = lyd_find_path(edit, path, 0, &node);
+        if (lyrc && (lyrc != LY_ENOTFOUND) && (lyrc != LY_EINCOMPLETE)) {
+            sr_errinfo_new_ly(&err_info, LYD_CTX(edit), NULL);
+            return err_info;
+        } else if (lyrc) {
+            node = NULL;
+        }
+    }
+
+    if (node) {
+        /* it must be a merged leaf owned by the connection */
+        sr_edit_find_cid(node, &node_cid, NULL);
+        if (!node->schema || (node->schema->nodetype != LYS_LEAF) || (node_cid != cid) ||
+                (sr_edit_diff_find_oper(node, 1, NULL) != EDIT_MERGE)) {
+            node = NULL;
+        }
+    }
+    if (!node) {
+        sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, "No stored operational leaf \"%s\" owned by the connection.", path);
+        return err_info;
+    }
+
+    /* update the value in place */
+    lyrc = lyd_change_term(node, value);
+    if ((lyrc == LY_EEXIST) || (lyrc == LY_ENOT)) {
+        /* same value */
+        return NULL;
+    } else if (lyrc) {
+        sr_errinfo_new_ly(&err_info, LYD_CTX(node), NULL);
+        return err_info;
+    }
+    *change = 1;
+
+    /* append to diff the same way a merged value change is */
+    return sr_edit_diff_append(node, sr_op_edit2diff(EDIT_MERGE), 0, diff);
+}
+
+/**
+ * @brief Check whether a data tree can be diffed by ::sr_diff_siblings_fast_r().
+ *
+ * @param[in] first First top-level sibling of the data tree.
+ * @return Whether the fast diff is supported or not.
+ */
+static int
+sr_diff_siblings_fast_supported(const struct lyd_node *first)
+{
+    const struct lyd_node *root, *elem;
+
+    LY_LIST_FOR(first, root) {
+        LYD_TREE_DFS_BEGIN(root, elem) {
+            if (!elem->schema || (elem->flags & LYD_EXT) || (elem->schema->nodetype & LYS_ANYDATA) ||
+                    lysc_is_userordered(elem->schema) || lysc_is_dup_inst_list(elem->schema)) {
+                /* opaque nodes, mounted data, any values, moves, and instances without keys are not handled */
+                return 0;
+            }
+            LYD_TREE_DFS_END(root, elem);
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Find the instance of a data node in siblings, trying the expected position first.
+ *
+ * @param[in] siblings Siblings to search in.
+ * @param[in] node Node to find.
+ * @param[in] expected Expected instance, may be NULL.
+ * @return Found instance, NULL if not found.
+ */
+static const struct lyd_node *
+sr_diff_siblings_fast_find(const struct lyd_node *siblings, const struct lyd_node *node, const struct lyd_node *expected)
+{
+    struct lyd_node *match;
+
+    if (expected && (expected->schema == node->schema)) {
+        if (!(node->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) || !lyd_compare_single(expected, node, 0)) {
+            /* the siblings are usually in the same order */
+            return expected;
+        }
+    }
+
+    /* hash-based search */
+    if (!siblings || lyd_find_sibling_first(siblings, node, &match)) {
+        return NULL;
+    }
+    return match;
+}
+
+/**
+ * @brief Append a change into a diff.
+ *
+ * @param[in] node Changed node, its copy is added into the diff.
+ * @param[in] op Diff operation.
+ * @param[in] orig_node Original leaf for ::EDIT_REPLACE and ::EDIT_NONE operations.
+ * @param[in,out] diff Diff to append to.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_diff_siblings_fast_append(const struct lyd_node *node, enum edit_op op, const struct lyd_node *orig_node,
+        struct lyd_node **diff)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *diff_parent, *new_diff_parent, *diff_node = NULL;
+    const char *orig_dflt;
+
+    /* find/create node parents */
+    if ((err_info = sr_edit_diff_create_parents(node, diff, &new_diff_parent, &diff_parent))) {
+        goto cleanup;
+    }
+    if (new_diff_parent && (err_info = sr_diff_set_oper(new_diff_parent, "none"))) {
+        goto cleanup;
+    }
+
+    /* copy the node */
+    if (lyd_dup_single(node, NULL, LYD_DUP_NO_META | LYD_DUP_WITH_FLAGS | ((op == EDIT_CREATE) || (op == EDIT_DELETE) ?
+            LYD_DUP_RECURSIVE : 0), &diff_node)) {
+        sr_errinfo_new_ly(&err_info, LYD_CTX(node), NULL);
+        goto cleanup;
+    }
+
+    /* add the operation with its metadata */
+    if ((op == EDIT_REPLACE) || (op == EDIT_NONE)) {
+        orig_dflt = (orig_node->flags & LYD_DEFAULT) ? "true" : NULL;
+        err_info = sr_diff_add_meta(diff_node, lyd_get_value(orig_node), orig_dflt, op);
+    } else {
+        err_info = sr_diff_add_meta(diff_node, NULL, NULL, op);
+    }
+    if (err_info) {
+        goto cleanup;
+    }
+
+    /* insert */
+    if (diff_parent) {
+        lyd_insert_child(diff_parent, diff_node);
+    } else {
+        lyd_insert_sibling(*diff, diff_node, diff);
+    }
+    diff_node = NULL;
+
+cleanup:
+    lyd_free_tree(diff_node);
+    return err_info;
+}
+
+/**
+ * @brief Learn the differences between data siblings, recursively.
+ *
+ * @param[in] first First siblings.
+ * @param[in] second Second siblings.
+ * @param[in,out] diff Diff to append to.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_diff_siblings_fast_r(const struct lyd_node *first, const struct lyd_node *second, struct lyd_node **diff)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lyd_node *iter, *match, *expected;
+
+    /* deleted and changed nodes */
+    expected = second;
+    LY_LIST_FOR(first, iter) {
+        match = sr_diff_siblings_fast_find(second, iter, expected);
+        if (!match) {
+            if ((err_info = sr_diff_siblings_fast_append(iter, EDIT_DELETE, NULL, diff))) {
+                return err_info;
+            }
+            continue;
+        }
+        expected = match->next;
+
+        if (iter->schema->nodetype & LYD_NODE_TERM) {
+            if ((iter->schema->nodetype == LYS_LEAF) && lyd_compare_single(iter, match, 0)) {
+                /* value changed */
+                err_info = sr_diff_siblings_fast_append(match, EDIT_REPLACE, iter, diff);
+            } else if ((iter->flags & LYD_DEFAULT) != (match->flags & LYD_DEFAULT)) {
+                /* only the default flag changed */
+                err_info = sr_diff_siblings_fast_append(match, EDIT_NONE, iter, diff);
+            }
+        } else {
+            /* descendants */
+            err_info = sr_diff_siblings_fast_r(lyd_child_no_keys(iter), lyd_child_no_keys(match), diff);
+        }
+        if (err_info) {
+            return err_info;
+        }
+    }
+
+    /* created nodes */
+    expected = first;
+    LY_LIST_FOR(second, iter) {
+        match = sr_diff_siblings_fast_find(first, iter, expected);
+        if (!match) {
+            if ((err_info = sr_diff_siblings_fast_append(iter, EDIT_CREATE, NULL, diff))) {
+                return err_info;
+            }
+            continue;
+        }
+        expected = match->next;
+    }
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_diff_siblings_fast(const struct lyd_node *first, const struct lyd_node *second, struct lyd_node **diff)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct ly_ctx *ly_ctx = first ? LYD_CTX(first) : (second ? LYD_CTX(second) : NULL);
+
+    *diff = NULL;
+
+    if (!sr_diff_siblings_fast_supported(first) || !sr_diff_siblings_fast_supported(second)) {
+        /* generic diff */
+        if (lyd_diff_siblings(first, second, LYD_DIFF_DEFAULTS, diff)) {
+            sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+        }
+        return err_info;
+    }
+
+    if ((err_info = sr_diff_siblings_fast_r(first, second, diff))) {
+        lyd_free_siblings(*diff);
+        *diff = NULL;
+    }
+    return err_info;
+}
@@ -173,16 +173,102 @@ sr_error_info_t *sr_edit_add(sr_session_ctx_t *session, const char *xpath, const
         const char *def_operation, const sr_move_position_t *position, const char *keys, const char *val,
         const char *origin, int isolate);
 
+/**
+ * @brief Learn the change operations of all the nodes in a sysrepo diff set, in one pass.
+ *
+ * @param[in] set Set with nodes from a sysrepo diff.
+ * @param[out] opers Array of ::sr_change_oper_t for each set node, -1 if the node is not a change.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_diff_set_opers(const struct ly_set *set, int8_t **opers);
+
 /**
  * @brief Get next change from a sysrepo diff set.
  *
  * @param[in] set Set with nodes from a sysrepo diff.
+ * @param[in] opers Optional precomputed operations of the set nodes from ::sr_diff_set_opers().
  * @param[in,out] idx Index of the next change.
  * @param[out] node Changed node.
  * @param[out] op Change operation.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_diff_set_getnext(struct ly_set *set, uint32_t *idx, struct lyd_node **node, sr_change_oper_t *op);
+sr_error_info_t *sr_diff_set_getnext(const struct ly_set *set, const int8_t *opers, uint32_t *idx,
+        struct lyd_node **node, sr_change_oper_t *op);
+
+/**
+ * @brief Print a sysrepo diff as a compact change log, a flat array of all the diff nodes with their values
+ * and metadata that can be iterated over without parsing.
+ *
+ * @param[in] diff Diff to print.
+ * @param[out] log Printed change log, NULL if the diff includes nodes that cannot be printed (opaque, extension,
+ * anydata, and duplicate-instance nodes).
+ * @param[out] log_len Length of @p log.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_change_log_print(const struct lyd_node *diff, char **log, uint32_t *log_len);
+
+/**
+ * @brief Check whether data are a change log.
+ *
+ * @param[in] data Change log or LYB data.
+ * @return Whether the data are a change log.
+ */
+int sr_change_log_is(const char *data);
+
+/**
+ * @brief Get the size of a change log.
+ *
+ * @param[in] log Change log.
+ * @return Size of @p log.
+ */
+uint32_t sr_change_log_size(const char *log);
+
+/**
+ * @brief Build the sysrepo diff from a change log.
+ *
+ * @param[in] ly_ctx libyang context to use.
+ * @param[in] log Change log.
+ * @param[out] diff Built diff.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_change_log_diff(const struct ly_ctx *ly_ctx, const char *log, struct lyd_node **diff);
+
+/**
+ * @brief Build the diff of an event session from its change log, if not built yet.
+ *
+ * @param[in] session Event session.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_change_log_session_diff(sr_session_ctx_t *session);
+
+/**
+ * @brief Create a change log iterator.
+ *
+ * @param[in] log Change log to iterate over, must exist while the iterator is used.
+ * @param[in] xpath XPath selecting the changes.
+ * @param[out] iter Created iterator, NULL if @p xpath cannot be evaluated on the change log.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_change_log_iter_new(const char *log, const char *xpath, struct sr_change_log_iter_s **iter);
+
+/**
+ * @brief Get next change from a change log.
+ *
+ * @param[in] iter Change log iterator.
+ * @param[out] op Change operation.
+ * @param[out] old_value Old value of the change.
+ * @param[out] new_value New value of the change, both values are NULL if there are no more changes.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_change_log_iter_next(struct sr_change_log_iter_s *iter, sr_change_oper_t *op, sr_val_t **old_value,
+        sr_val_t **new_value);
+
+/**
+ * @brief Free a change log iterator.
+ *
+ * @param[in] iter Change log iterator to free.
+ */
+void sr_change_log_iter_free(struct sr_change_log_iter_s *iter);
 
 /**
  * @brief Remove stored edit nodes that belong to a connection and that optionally match an xpath.
@@ -195,4 +281,34 @@ sr_error_info_t *sr_diff_set_getnext(struct ly_set *set, uint32_t *idx, struct l
  */
 sr_error_info_t *sr_edit_oper_del(struct lyd_node **edit, sr_cid_t cid, const char *xpath, struct lyd_node **change_edit);
 
+/**
+ * @brief Update the value of a stored edit leaf owned by a connection, in place.
+ *
+ * @param[in] edit Edit to update.
+ * @param[in] cid Connection ID owning the leaf.
+ * @param[in] path Path to the leaf.
+ * @param[in] value New value of the leaf.
+ * @param[in,out] diff Diff to append the change to, do nothing if NULL.
+ * @param[out] change Set if the value was changed.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_edit_oper_value_update(struct lyd_node *edit, sr_cid_t cid, const char *path, const char *value,
+        struct lyd_node **diff, int *change);
+
+/**
+ * @brief Learn the differences between 2 data trees, such as consecutive operational data, the same way
+ * lyd_diff_siblings() with LYD_DIFF_DEFAULTS does.
+ *
+ * Siblings are expected in the same order and found by their hash otherwise, unchanged subtrees do not create
+ * any diff nodes. Falls back to lyd_diff_siblings() for data with opaque nodes, mounted data, any values,
+ * user-ordered nodes, or list instances without keys.
+ *
+ * @param[in] first First data tree.
+ * @param[in] second Second data tree.
+ * @param[out] diff Created diff, NULL if there are no differences.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_diff_siblings_fast(const struct lyd_node *first, const struct lyd_node *second,
+        struct lyd_node **diff);
+
 #endif
@@ -154,6 +154,20 @@ srpd_plugin_names_cmp(const struct srpd_plugin_s *plugin, const char *str2)
     return (strlen(str1) == n) ? strncmp(str1, str2, n) : -1;
 }
 
+int
+srpd_plugin_find(const struct srpd_plugin_s *plugins, int plugin_count, const char *name)
+{
+    int i;
+
+    for (i = 0; i < plugin_count; ++i) {
+        if (!srpd_plugin_names_cmp(&plugins[i], name)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
 int
 srpd_sort_plugins(sr_session_ctx_t *sess, struct srpd_plugin_s *plugins, int plugin_count, const char *plugin_name)
 {
@@ -34,6 +34,8 @@ struct srpd_plugin_s {
     void *private_data;
     char *plugin_name;
     int initialized;
+    const char **init_after;    /**< Optional NULL-terminated names of plugins to be initialized before this one. */
+    sr_session_ctx_t *sess;     /**< Own session of the plugin if initialized in parallel, NULL otherwise. */
 };
 
 /**
@@ -79,6 +81,16 @@ int srpd_exec(const char *plugin_name, const char *cmd, uint32_t num_of_args, ..
  */
 void srpd_swap(struct srpd_plugin_s *a, struct srpd_plugin_s *b);
 
+/**
+ * @brief Finds a plugin by its name.
+ *
+ * @param[in] plugins Array of plugins.
+ * @param[in] plugin_count Number of plugins within the array.
+ * @param[in] name Name of the plugin, which may or may not include the extension.
+ * @return Index of the plugin, -1 if not found.
+ */
+int srpd_plugin_find(const struct srpd_plugin_s *plugins, int plugin_count, const char *name);
+
 /**
  * @brief Sorts plugins.
  *
@@ -18,10 +18,12 @@
 #include <assert.h>
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <pthread.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <libyang/libyang.h>
 #include <sysrepo.h>
@@ -31,6 +33,10 @@
 #include "config.h"
 #include "srpd_common.h"
 
+#ifdef SR_HAVE_ZLIB
+# include <zlib.h>
+#endif
+
 #define SRPD_PLUGIN_NAME "srpd_rotation"
 
 /**
@@ -148,6 +154,80 @@ srpd_format_check(const char *file_name, time_t *file_time1, time_t *file_time2)
     return 0;
 }
 
+#ifdef SR_HAVE_ZLIB
+
+/**
+ * @brief Compress a notification file using zlib so that it can still be replayed.
+ *
+ * @param[in] src_path Path of the notification file.
+ * @param[in] dst_path Path of the created compressed file.
+ * @return 0 on success.
+ * @return -1 on failure.
+ */
+static int
+srpd_rotation_compress(const char *src_path, const char *dst_path)
+{
+    int rc = -1, fd = -1;
+    gzFile gz = NULL;
+    char buf[16384];
+    ssize_t r;
+
+    if ((fd = open(src_path, O_RDONLY)) == -1) {
+        SRPLG_LOG_ERR(SRPD_PLUGIN_NAME, "Opening \"%s\" failed (%s).", src_path, strerror(errno));
+        goto cleanup;
+    }
+    if (!(gz = gzopen(dst_path, "wb9"))) {
+        SRPLG_LOG_ERR(SRPD_PLUGIN_NAME, "Opening \"%s\" failed (%s).", dst_path, strerror(errno));
+        goto cleanup;
+    }
+
+    while ((r = read(fd, buf, sizeof buf))) {
+        if (r == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            SRPLG_LOG_ERR(SRPD_PLUGIN_NAME, "Reading \"%s\" failed (%s).", src_path, strerror(errno));
+            goto cleanup;
+        }
+        if (gzwrite(gz, buf, r) != r) {
+            SRPLG_LOG_ERR(SRPD_PLUGIN_NAME, "Compressing into \"%s\" failed (%s).", dst_path, gzerror(gz, NULL));
+            goto cleanup;
+        }
+    }
+
+    rc = 0;
+
+cleanup:
+    if (fd > -1) {
+        close(fd);
+    }
+    if (gz && (gzclose(gz) != Z_OK) && !rc) {
+        SRPLG_LOG_ERR(SRPD_PLUGIN_NAME, "Writing \"%s\" failed.", dst_path);
+        rc = -1;
+    }
+    if (rc && gz) {
+        unlink(dst_path);
+    }
+    return rc;
+}
+
+#endif
+
+/**
+ * @brief Check whether a notification file is a sparse index of another notification file.
+ *
+ * @param[in] file_name File name to be checked.
+ * @return Whether it is an index or not.
+ */
+static int
+srpd_is_index(const char *file_name)
+{
+    const char *suffix = ".index";
+    size_t len = strlen(file_name), suf_len = strlen(suffix);
+
+    return (len > suf_len) && !strcmp(file_name + len - suf_len, suffix);
+}
+
 static void *
 srpd_rotation_loop(void *arg)
 {
@@ -196,17 +276,29 @@ srpd_rotation_loop(void *arg)
             if ((current_time >= (time_t)ATOMIC_LOAD_RELAXED(data->rotation_time)) &&
                     (file_time2 < (current_time - (time_t)ATOMIC_LOAD_RELAXED(data->rotation_time)))) {
 
-                /* build compressing args */
-                if (ATOMIC_LOAD_RELAXED(data->compress)) {
+                /* build compressing args, indices of the notification files are kept uncompressed */
+                if (ATOMIC_LOAD_RELAXED(data->compress) && !srpd_is_index(dir->d_name)) {
+#ifdef SR_HAVE_ZLIB
+                    if (asprintf(&arg1, "%s%s%s", (char *)ATOMIC_PTR_LOAD_RELAXED(data->output_folder), dir->d_name,
+                            SRPD_COMPRESS_SUFFIX) == -1) {
+                        goto cleanup;
+                    }
+#else
                     if (asprintf(&arg1, "%s%s.tar.gz", (char *)ATOMIC_PTR_LOAD_RELAXED(data->output_folder), dir->d_name) == -1) {
                         goto cleanup;
                     }
+#endif
                     if (asprintf(&arg2, "%s%s", notif_dir_name, dir->d_name) == -1) {
                         goto cleanup;
                     }
 
+#ifdef SR_HAVE_ZLIB
+                    /* compress a file with zlib in output folder, it can be replayed from there */
+                    if ((rc = srpd_rotation_compress(arg2, arg1))) {
+#else
                     /* compress a file with tar in output folder */
                     if ((rc = srpd_exec(SRPD_PLUGIN_NAME, SRPD_TAR_BINARY, 4, SRPD_TAR_BINARY, "-czvf", arg1, arg2))) {
+#endif
                         SRPLG_LOG_ERR(SRPD_PLUGIN_NAME, "Compressing a file %s failed.", arg2);
                     } else {
                         ATOMIC_INC_RELAXED(data->rotated_files_count);
@@ -16,6 +16,7 @@
 
 #define _GNU_SOURCE
 
+#include <assert.h>
 #include <dirent.h>
 #include <dlfcn.h>
 #include <errno.h>
@@ -88,7 +89,7 @@ help_print(void)
 {
     printf(
             "Usage:\n"
-            "  sysrepo-plugind [-h] [-v <level>] [-d]\n"
+            "  sysrepo-plugind [-h] [-v <level>] [-d] [-j]\n"
             "\n"
             "Options:\n"
             "  -h, --help           Prints usage help.\n"
@@ -105,6 +106,8 @@ help_print(void)
             "                       plugin initialization is finished.\n"
             "  -f, --fatal-plugin-fail\n"
             "                       If any plugin initialization fails, terminate sysrepo-plugind.\n"
+            "  -j, --parallel-init  Initialize independent plugins concurrently, each with its own session.\n"
+            "                       Plugins wait only for the plugins listed in their \"" SRP_INIT_AFTER "\".\n"
             "\n"
             "Environment variable $SRPD_PLUGINS_PATH overwrites the default plugins directory.\n"
             "\n");
@@ -342,6 +345,9 @@ load_plugins(struct srpd_plugin_s **plugins, int *plugin_count)
             break;
         }
 
+        /* optional dependencies */
+        plugin->init_after = dlsym(handle, SRP_INIT_AFTER);
+
         /* finally store the plugin */
         plugin->handle = handle;
 
@@ -444,6 +450,289 @@ write_pidfile(int pidfd)
     return 0;
 }
 
+/** plugin is waiting for initialization */
+#define SRPD_INIT_PENDING 0
+/** plugin was successfully initialized */
+#define SRPD_INIT_DONE 1
+/** plugin initialization failed or was skipped */
+#define SRPD_INIT_FAILED 2
+
+/**
+ * @brief Parallel plugin initialization context shared by all the threads.
+ */
+struct init_ctx_s {
+    sr_conn_ctx_t *conn;
+    struct srpd_plugin_s *plugins;
+    int plugin_count;
+    int *states;                /**< Initialization state of each plugin. */
+    pthread_mutex_t lock;       /**< Lock for @p states. */
+    pthread_cond_t cond;        /**< Broadcast when any state changes. */
+};
+
+/**
+ * @brief Parallel plugin initialization thread structure.
+ */
+struct init_thread_s {
+    pthread_t tid;
+    struct init_ctx_s *ctx;
+    int idx;                    /**< Index of the initialized plugin. */
+};
+
+/**
+ * @brief Learn the initialization state of the plugins a plugin must be initialized after.
+ *
+ * @param[in] plugins Array of plugins.
+ * @param[in] plugin_count Number of plugins within the array.
+ * @param[in] idx Index of the plugin.
+ * @param[in] states Initialization state of each plugin.
+ * @return 0 if all of them were initialized, 1 if some are pending, -1 if some failed.
+ */
+static int
+init_deps_state(struct srpd_plugin_s *plugins, int plugin_count, int idx, const int *states)
+{
+    const char **name;
+    int i, ret = 0;
+
+    for (name = plugins[idx].init_after; name && *name; ++name) {
+        if ((i = srpd_plugin_find(plugins, plugin_count, *name)) < 0) {
+            /* not loaded */
+            continue;
+        }
+
+        if (states[i] == SRPD_INIT_FAILED) {
+            return -1;
+        } else if (states[i] == SRPD_INIT_PENDING) {
+            ret = 1;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Check that the plugin initialization dependencies can be satisfied.
+ *
+ * @param[in] plugins Array of plugins.
+ * @param[in] plugin_count Number of plugins within the array.
+ * @return 0 on success, -1 on a dependency cycle.
+ */
+static int
+init_deps_check(struct srpd_plugin_s *plugins, int plugin_count)
+{
+    const char **name;
+    int *states, i, done, progress, rc = 0;
+
+    for (i = 0; i < plugin_count; ++i) {
+        for (name = plugins[i].init_after; name && *name; ++name) {
+            if (srpd_plugin_find(plugins, plugin_count, *name) < 0) {
+                SRPLG_LOG_WRN("sysrepo-plugind", "Plugin \"%s\" should be initialized after plugin \"%s\" that is not "
+                        "loaded.", plugins[i].plugin_name, *name);
+            }
+        }
+    }
+
+    states = calloc(plugin_count, sizeof *states);
+    if (!states) {
+        SRPLG_LOG_ERR("sysrepo-plugind", "calloc() failed (%s).", strerror(errno));
+        return -1;
+    }
+
+    /* pretend to initialize the plugins in waves of all the plugins with initialized dependencies */
+    done = 0;
+    do {
+        progress = 0;
+        for (i = 0; i < plugin_count; ++i) {
+            if ((states[i] == SRPD_INIT_PENDING) && !init_deps_state(plugins, plugin_count, i, states)) {
+                states[i] = SRPD_INIT_DONE;
+                ++done;
+                progress = 1;
+            }
+        }
+    } while (progress);
+
+    if (done < plugin_count) {
+        for (i = 0; i < plugin_count; ++i) {
+            if (states[i] == SRPD_INIT_PENDING) {
+                SRPLG_LOG_ERR("sysrepo-plugind", "Plugin \"%s\" initialization dependencies form a cycle.",
+                        plugins[i].plugin_name);
+            }
+        }
+        rc = -1;
+    }
+
+    free(states);
+    return rc;
+}
+
+/**
+ * @brief Initialize plugins one by one using a single session, in their order respecting the dependencies.
+ *
+ * @param[in] sess Session to use.
+ * @param[in] plugins Array of plugins.
+ * @param[in] plugin_count Number of plugins within the array.
+ * @param[in] fatal_fail Whether to stop on the first failed initialization.
+ * @return 0 on success, -1 on a fatal error.
+ */
+static int
+init_plugins_serial(sr_session_ctx_t *sess, struct srpd_plugin_s *plugins, int plugin_count, int fatal_fail)
+{
+    int *states, i, r, deps = 0, done, rc = 0;
+
+    states = calloc(plugin_count, sizeof *states);
+    if (!states) {
+        SRPLG_LOG_ERR("sysrepo-plugind", "calloc() failed (%s).", strerror(errno));
+        return -1;
+    }
+
+    for (done = 0; done < plugin_count; ++done) {
+        /* first plugin in the order with all the dependencies processed, checked there are no cycles */
+        for (i = 0; i < plugin_count; ++i) {
+            if ((states[i] == SRPD_INIT_PENDING) && ((deps = init_deps_state(plugins, plugin_count, i, states)) < 1)) {
+                break;
+            }
+        }
+        assert(i < plugin_count);
+
+        if (deps) {
+            SRPLG_LOG_ERR("sysrepo-plugind", "Plugin \"%s\" not initialized because a plugin it depends on failed.",
+                    plugins[i].plugin_name);
+            states[i] = SRPD_INIT_FAILED;
+            continue;
+        }
+
+        r = plugins[i].init_cb(sess, &plugins[i].private_data);
+        if (r) {
+            SRPLG_LOG_ERR("sysrepo-plugind", "Plugin \"%s\" initialization failed (%s).", plugins[i].plugin_name,
+                    sr_strerror(r));
+            if (fatal_fail) {
+                rc = -1;
+                break;
+            }
+            states[i] = SRPD_INIT_FAILED;
+        } else {
+            SRPLG_LOG_INF("sysrepo-plugind", "Plugin \"%s\" initialized.", plugins[i].plugin_name);
+            plugins[i].initialized = 1;
+            states[i] = SRPD_INIT_DONE;
+        }
+    }
+
+    free(states);
+    return rc;
+}
+
+/**
+ * @brief Thread initializing a single plugin once all its dependencies are initialized.
+ *
+ * @param[in] arg Thread structure.
+ * @return NULL.
+ */
+static void *
+init_plugin_thread(void *arg)
+{
+    struct init_thread_s *thr = arg;
+    struct init_ctx_s *ctx = thr->ctx;
+    struct srpd_plugin_s *plugin = &ctx->plugins[thr->idx];
+    int r, deps;
+
+    /* wait for the dependencies */
+    pthread_mutex_lock(&ctx->lock);
+    while ((deps = init_deps_state(ctx->plugins, ctx->plugin_count, thr->idx, ctx->states)) == 1) {
+        pthread_cond_wait(&ctx->cond, &ctx->lock);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+
+    if (deps) {
+        SRPLG_LOG_ERR("sysrepo-plugind", "Plugin \"%s\" not initialized because a plugin it depends on failed.",
+                plugin->plugin_name);
+        r = SR_ERR_OPERATION_FAILED;
+    } else if ((r = sr_session_start(ctx->conn, SR_DS_RUNNING, &plugin->sess))) {
+        SRPLG_LOG_ERR("sysrepo-plugind", "Failed to start a session for plugin \"%s\" (%s).", plugin->plugin_name,
+                sr_strerror(r));
+    } else if ((r = plugin->init_cb(plugin->sess, &plugin->private_data))) {
+        SRPLG_LOG_ERR("sysrepo-plugind", "Plugin \"%s\" initialization failed (%s).", plugin->plugin_name,
+                sr_strerror(r));
+    } else {
+        SRPLG_LOG_INF("sysrepo-plugind", "Plugin \"%s\" initialized.", plugin->plugin_name);
+    }
+
+    /* publish the result */
+    pthread_mutex_lock(&ctx->lock);
+    if (r) {
+        ctx->states[thr->idx] = SRPD_INIT_FAILED;
+    } else {
+        plugin->initialized = 1;
+        ctx->states[thr->idx] = SRPD_INIT_DONE;
+    }
+    pthread_cond_broadcast(&ctx->cond);
+    pthread_mutex_unlock(&ctx->lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Initialize plugins concurrently, each in its own thread with its own session, plugins that depend on other
+ * plugins waiting for their initialization.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] plugins Array of plugins.
+ * @param[in] plugin_count Number of plugins within the array.
+ * @param[in] fatal_fail Whether any failed initialization is fatal.
+ * @return 0 on success, -1 on a fatal error.
+ */
+static int
+init_plugins_parallel(sr_conn_ctx_t *conn, struct srpd_plugin_s *plugins, int plugin_count, int fatal_fail)
+{
+    struct init_ctx_s ctx = {0};
+    struct init_thread_s *threads;
+    int i, r, rc = 0;
+
+    threads = calloc(plugin_count, sizeof *threads);
+    ctx.states = calloc(plugin_count, sizeof *ctx.states);
+    if (!threads || !ctx.states) {
+        SRPLG_LOG_ERR("sysrepo-plugind", "calloc() failed (%s).", strerror(errno));
+        free(threads);
+        free(ctx.states);
+        return -1;
+    }
+    ctx.conn = conn;
+    ctx.plugins = plugins;
+    ctx.plugin_count = plugin_count;
+    pthread_mutex_init(&ctx.lock, NULL);
+    pthread_cond_init(&ctx.cond, NULL);
+
+    /* start all the threads */
+    for (i = 0; i < plugin_count; ++i) {
+        threads[i].ctx = &ctx;
+        threads[i].idx = i;
+        if ((r = pthread_create(&threads[i].tid, NULL, init_plugin_thread, &threads[i]))) {
+            SRPLG_LOG_ERR("sysrepo-plugind", "Creating a thread for plugin \"%s\" failed (%s).", plugins[i].plugin_name,
+                    strerror(r));
+
+            pthread_mutex_lock(&ctx.lock);
+            ctx.states[i] = SRPD_INIT_FAILED;
+            pthread_cond_broadcast(&ctx.cond);
+            pthread_mutex_unlock(&ctx.lock);
+            threads[i].ctx = NULL;
+        }
+    }
+
+    /* wait for all of them */
+    for (i = 0; i < plugin_count; ++i) {
+        if (threads[i].ctx) {
+            pthread_join(threads[i].tid, NULL);
+        }
+        if (fatal_fail && (ctx.states[i] == SRPD_INIT_FAILED)) {
+            rc = -1;
+        }
+    }
+
+    pthread_cond_destroy(&ctx.cond);
+    pthread_mutex_destroy(&ctx.lock);
+    free(threads);
+    free(ctx.states);
+    return rc;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -451,7 +740,7 @@ main(int argc, char **argv)
     sr_conn_ctx_t *conn = NULL;
     sr_session_ctx_t *sess = NULL;
     sr_log_level_t log_level = SR_LL_ERR;
-    int plugin_count = 0, i, r, rc = EXIT_FAILURE, opt, debug = 0, pidfd = -1, fatal_fail = 0;
+    int plugin_count = 0, i, r, rc = EXIT_FAILURE, opt, debug = 0, pidfd = -1, fatal_fail = 0, parallel = 0;
     const char *plugins_dir, *pidfile = NULL;
 
     struct option options[] = {
@@ -462,12 +751,13 @@ main(int argc, char **argv)
         {"plugin-install",    required_argument, NULL, 'P'},
         {"pid-file",          required_argument, NULL, 'p'},
         {"fatal-plugin-fail", no_argument,       NULL, 'f'},
+        {"parallel-init",     no_argument,       NULL, 'j'},
         {NULL,                0,                 NULL, 0},
     };
 
     /* process options */
     opterr = 0;
-    while ((opt = getopt_long(argc, argv, "hVv:dP:p:f", options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "hVv:dP:p:fj", options, NULL)) != -1) {
         switch (opt) {
         case 'h':
             version_print();
@@ -518,6 +808,9 @@ main(int argc, char **argv)
         case 'f':
             fatal_fail = 1;
             break;
+        case 'j':
+            parallel = 1;
+            break;
         default:
             error_print(0, "Invalid option or missing argument: -%c", optopt);
             goto cleanup;
@@ -562,18 +855,16 @@ main(int argc, char **argv)
     }
 
     /* init plugins */
-    for (i = 0; i < plugin_count; ++i) {
-        r = plugins[i].init_cb(sess, &plugins[i].private_data);
-        if (r) {
-            SRPLG_LOG_ERR("sysrepo-plugind", "Plugin \"%s\" initialization failed (%s).", plugins[i].plugin_name,
-                    sr_strerror(r));
-            if (fatal_fail) {
-                goto cleanup;
-            }
-        } else {
-            SRPLG_LOG_INF("sysrepo-plugind", "Plugin \"%s\" initialized.", plugins[i].plugin_name);
-            plugins[i].initialized = 1;
-        }
+    if (init_deps_check(plugins, plugin_count)) {
+        goto cleanup;
+    }
+    if (parallel) {
+        r = init_plugins_parallel(conn, plugins, plugin_count, fatal_fail);
+    } else {
+        r = init_plugins_serial(sess, plugins, plugin_count, fatal_fail);
+    }
+    if (r) {
+        goto cleanup;
     }
 
     /* set state data */
@@ -607,7 +898,7 @@ main(int argc, char **argv)
     /* cleanup plugins */
     for (i = 0; i < plugin_count; ++i) {
         if (plugins[i].initialized) {
-            plugins[i].cleanup_cb(sess, plugins[i].private_data);
+            plugins[i].cleanup_cb(plugins[i].sess ? plugins[i].sess : sess, plugins[i].private_data);
         }
     }
 
@@ -16,13 +16,16 @@
 
 #define _GNU_SOURCE
 
+#include <ctype.h>
 #include <errno.h>
 #include <getopt.h>
+#include <inttypes.h>
 #include <stdarg.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -65,6 +68,8 @@ help_print(void)
             "                               Send a RPC/action in a file or using a text editor. Output is printed to STDOUT.\n"
             "  -N, --notification[=<path>/<editor>]\n"
             "                               Send a notification in a file or using a text editor.\n"
+            "  -B, --batch[=<path>]         Perform operations read from a file or STDIN, one per line written as the\n"
+            "                               options of a single sysrepocfg call, using one connection and session.\n"
             "  -C, --copy-from <path>/<source-datastore>\n"
             "                               Perform a copy-config from a file or a datastore.\n"
             "\n"
@@ -88,6 +93,9 @@ help_print(void)
             "  -o, --opaque                 Parse invalid nodes in the edit into opaque nodes. Accepted by edit op.\n"
             "  -p, --depth <depth>          Limit the depth of returned subtrees, 0 (unlimited) by default. Accepted by\n"
             "                               export op.\n"
+            "  -c, --chunk <count>          Export the data in chunks of at most <count> selected subtrees printed\n"
+            "                               one after another so that the whole data tree is never held in memory.\n"
+            "                               Only XML format, accepted by export op.\n"
             "  -t, --timeout <seconds>      Set the timeout for the operation, otherwise the default one is used.\n"
             "                               Accepted by all op.\n"
             "  -e, --defaults <wd-mode>     Print the default values, which are trimmed by default (\"report-all\",\n"
@@ -223,6 +231,7 @@ step_load_data(const struct ly_ctx *ly_ctx, const char *file_path, LYD_FORMAT fo
         int not_strict, int opaq, struct lyd_node **data)
 {
     struct ly_in *in;
+    struct stat st;
     char *ptr;
     int parse_flags;
     LY_ERR lyrc = 0;
@@ -259,6 +268,12 @@ step_load_data(const struct ly_ctx *ly_ctx, const char *file_path, LYD_FORMAT fo
             error_print(0, "Failed to create input handler from file \"%s\"", file_path);
             return EXIT_FAILURE;
         }
+    } else if (!fstat(STDIN_FILENO, &st) && S_ISREG(st.st_mode) && st.st_size) {
+        /* regular file redirected to STDIN, it can be mapped instead of copied into memory */
+        if (ly_in_new_fd(STDIN_FILENO, &in)) {
+            error_print(0, "Failed to create input handler from STDIN");
+            return EXIT_FAILURE;
+        }
     } else {
         /* we need to load the data into memory first */
         if (step_read_file(stdin, &ptr)) {
@@ -362,10 +377,37 @@ cleanup:
 }
 
 static int
-op_export(sr_session_ctx_t *sess, const char *file_path, const char *module_name, const char *xpath, LYD_FORMAT format,
-        uint32_t max_depth, int wd_opt, int timeout_s)
+step_export_chunks(sr_session_ctx_t *sess, FILE *file, const char *xpath, uint32_t chunk_size, uint32_t max_depth,
+        int wd_opt, int timeout_s)
 {
+    sr_data_iter_t *iter = NULL;
     sr_data_t *data;
+    int r;
+
+    r = sr_get_data_iter(sess, xpath, chunk_size, max_depth, timeout_s * 1000, 0, &iter);
+    while (!r) {
+        r = sr_get_data_next(iter, &data);
+        if (r) {
+            break;
+        }
+
+        /* print the chunk right away, consecutive XML chunks form valid data */
+        lyd_print_file(file, data->tree, LYD_XML, LYD_PRINT_WITHSIBLINGS | wd_opt);
+        sr_release_data(data);
+    }
+    sr_free_data_iter(iter);
+
+    if (r != SR_ERR_NOT_FOUND) {
+        return r;
+    }
+    return SR_ERR_OK;
+}
+
+static int
+op_export(sr_session_ctx_t *sess, const char *file_path, const char *module_name, const char *xpath, LYD_FORMAT format,
+        uint32_t max_depth, uint32_t chunk_size, int wd_opt, int timeout_s)
+{
+    sr_data_t *data = NULL;
     FILE *file = NULL;
     char *str;
     int r;
@@ -373,6 +415,10 @@ op_export(sr_session_ctx_t *sess, const char *file_path, const char *module_name
     if (format == LYD_UNKNOWN) {
         format = LYD_XML;
     }
+    if (chunk_size && (format != LYD_XML)) {
+        error_print(0, "Chunked export is supported only in XML format");
+        return EXIT_FAILURE;
+    }
 
     if (file_path) {
         file = fopen(file_path, "w");
@@ -386,10 +432,16 @@ op_export(sr_session_ctx_t *sess, const char *file_path, const char *module_name
     if (module_name) {
         if (asprintf(&str, "/%s:*", module_name) == -1) {
             r = SR_ERR_NO_MEMORY;
+        } else if (chunk_size) {
+            r = step_export_chunks(sess, file ? file : stdout, str, chunk_size, max_depth, wd_opt, timeout_s);
+            free(str);
         } else {
             r = sr_get_data(sess, str, max_depth, timeout_s * 1000, 0, &data);
             free(str);
         }
+    } else if (chunk_size) {
+        r = step_export_chunks(sess, file ? file : stdout, xpath ? xpath : "/*", chunk_size, max_depth, wd_opt,
+                timeout_s);
     } else if (xpath) {
         r = sr_get_data(sess, xpath, max_depth, timeout_s * 1000, 0, &data);
     } else {
@@ -403,9 +455,11 @@ op_export(sr_session_ctx_t *sess, const char *file_path, const char *module_name
         return EXIT_FAILURE;
     }
 
-    /* print exported data */
-    lyd_print_file(file ? file : stdout, data ? data->tree : NULL, format, LYD_PRINT_WITHSIBLINGS | wd_opt);
-    sr_release_data(data);
+    if (!chunk_size) {
+        /* print exported data */
+        lyd_print_file(file ? file : stdout, data ? data->tree : NULL, format, LYD_PRINT_WITHSIBLINGS | wd_opt);
+        sr_release_data(data);
+    }
 
     /* cleanup */
     if (file) {
@@ -467,7 +521,7 @@ op_edit(sr_session_ctx_t *sess, const char *file_path, const char *editor, const
     }
 
     /* use export operation to get data to edit */
-    if (op_export(sess, tmp_file, module_name, NULL, format, 0, wd_opt, timeout_s)) {
+    if (op_export(sess, tmp_file, module_name, NULL, format, 0, 0, wd_opt, timeout_s)) {
         goto cleanup_unlock;
     }
 
@@ -650,17 +704,33 @@ arg_get_ds(const char *optarg, sr_datastore_t *ds)
     return 0;
 }
 
-int
-main(int argc, char **argv)
+/**
+ * @brief Arguments of a single sysrepocfg operation.
+ */
+struct cfg_args {
+    int operation;
+    sr_datastore_t ds;
+    sr_datastore_t source_ds;
+    LYD_FORMAT format;
+    const char *module_name;
+    const char *editor;
+    const char *file_path;
+    const char *xpath;
+    int lock;
+    int not_strict;
+    int opaq;
+    int timeout;
+    int wd_opt;
+    uint32_t max_depth;
+    uint32_t chunk_size;
+};
+
+static int
+arg_parse(int argc, char **argv, struct cfg_args *args)
 {
-    sr_conn_ctx_t *conn = NULL;
-    sr_session_ctx_t *sess = NULL;
-    sr_datastore_t ds = SR_DS_RUNNING, source_ds;
-    LYD_FORMAT format = LYD_UNKNOWN;
-    const char *module_name = NULL, *editor = NULL, *file_path = NULL, *xpath = NULL, *op_str;
+    int opt;
+    const char *op_str;
     char *ptr;
-    int r, rc = EXIT_FAILURE, opt, operation = 0, lock = 0, not_strict = 0, opaq = 0, timeout = 0, wd_opt = 0;
-    uint32_t max_depth = 0;
     struct option options[] = {
         {"help",            no_argument,       NULL, 'h'},
         {"version",         no_argument,       NULL, 'V'},
@@ -669,6 +739,7 @@ main(int argc, char **argv)
         {"edit",            optional_argument, NULL, 'E'},
         {"rpc",             optional_argument, NULL, 'R'},
         {"notification",    optional_argument, NULL, 'N'},
+        {"batch",           optional_argument, NULL, 'B'},
         {"copy-from",       required_argument, NULL, 'C'},
         {"datastore",       required_argument, NULL, 'd'},
         {"module",          required_argument, NULL, 'm'},
@@ -678,180 +749,196 @@ main(int argc, char **argv)
         {"not-strict",      no_argument,       NULL, 'n'},
         {"opaque",          no_argument,       NULL, 'o'},
         {"depth",           required_argument, NULL, 'p'},
+        {"chunk",           required_argument, NULL, 'c'},
         {"timeout",         required_argument, NULL, 't'},
         {"defaults",        required_argument, NULL, 'e'},
         {"verbosity",       required_argument, NULL, 'v'},
         {NULL,              0,                 NULL, 0},
     };
 
-    if (argc == 1) {
-        help_print();
-        goto cleanup;
-    }
+    memset(args, 0, sizeof *args);
+    args->ds = SR_DS_RUNNING;
+    args->format = LYD_UNKNOWN;
 
-    /* process options */
+    /* process options, restart getopt in case it was already used */
+    optind = 0;
     opterr = 0;
-    while ((opt = getopt_long(argc, argv, "hVI::X::E::R::N::C:d:m:x:f:lnop:t:e:v:", options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "hVI::X::E::R::N::B::C:d:m:x:f:lnop:c:t:e:v:", options, NULL)) != -1) {
         switch (opt) {
         case 'h':
             version_print();
             help_print();
-            rc = EXIT_SUCCESS;
-            goto cleanup;
+            return 1;
         case 'V':
             version_print();
-            rc = EXIT_SUCCESS;
-            goto cleanup;
+            return 1;
         case 'I':
-            if (operation) {
+            if (args->operation) {
                 error_print(0, "Operation already specified");
-                goto cleanup;
+                return -1;
             }
             if (optarg) {
-                file_path = optarg;
+                args->file_path = optarg;
             }
-            operation = opt;
+            args->operation = opt;
             break;
         case 'X':
-            if (operation) {
+            if (args->operation) {
+                error_print(0, "Operation already specified");
+                return -1;
+            }
+            if (optarg) {
+                args->file_path = optarg;
+            }
+            args->operation = opt;
+            break;
+        case 'B':
+            if (args->operation) {
                 error_print(0, "Operation already specified");
-                goto cleanup;
+                return -1;
             }
             if (optarg) {
-                file_path = optarg;
+                args->file_path = optarg;
             }
-            operation = opt;
+            args->operation = opt;
             break;
         case 'E':
-            if (operation) {
+            if (args->operation) {
                 error_print(0, "Operation already specified");
-                goto cleanup;
+                return -1;
             }
             if (optarg) {
                 if (arg_is_file(optarg)) {
-                    file_path = optarg;
+                    args->file_path = optarg;
                 } else {
-                    editor = optarg;
+                    args->editor = optarg;
                 }
             }
-            operation = opt;
+            args->operation = opt;
             break;
         case 'R':
-            if (operation) {
+            if (args->operation) {
                 error_print(0, "Operation already specified");
-                goto cleanup;
+                return -1;
             }
             if (optarg) {
                 if (arg_is_file(optarg)) {
-                    file_path = optarg;
+                    args->file_path = optarg;
                 } else {
-                    editor = optarg;
+                    args->editor = optarg;
                 }
             }
-            operation = opt;
+            args->operation = opt;
             break;
         case 'N':
-            if (operation) {
+            if (args->operation) {
                 error_print(0, "Operation already specified");
-                goto cleanup;
+                return -1;
             }
             if (optarg) {
                 if (arg_is_file(optarg)) {
-                    file_path = optarg;
+                    args->file_path = optarg;
                 } else {
-                    editor = optarg;
+                    args->editor = optarg;
                 }
             }
-            operation = opt;
+            args->operation = opt;
             break;
         case 'C':
-            if (operation) {
+            if (args->operation) {
                 error_print(0, "Operation already specified");
-                goto cleanup;
+                return -1;
             }
             if (arg_is_file(optarg)) {
-                file_path = optarg;
+                args->file_path = optarg;
             } else {
-                if (arg_get_ds(optarg, &source_ds)) {
-                    goto cleanup;
+                if (arg_get_ds(optarg, &args->source_ds)) {
+                    return -1;
                 }
             }
-            operation = opt;
+            args->operation = opt;
             break;
         case 'd':
-            if (arg_get_ds(optarg, &ds)) {
-                goto cleanup;
+            if (arg_get_ds(optarg, &args->ds)) {
+                return -1;
             }
             break;
         case 'm':
-            if (module_name) {
+            if (args->module_name) {
                 error_print(0, "Module already specified");
-                goto cleanup;
-            } else if (xpath) {
+                return -1;
+            } else if (args->xpath) {
                 error_print(0, "Only one of options --module and --xpath can be set");
-                goto cleanup;
+                return -1;
             }
-            module_name = optarg;
+            args->module_name = optarg;
             break;
         case 'x':
-            if (xpath) {
+            if (args->xpath) {
                 error_print(0, "XPath already specified");
-                goto cleanup;
-            } else if (module_name) {
+                return -1;
+            } else if (args->module_name) {
                 error_print(0, "Only one of options --module and --xpath can be set");
-                goto cleanup;
+                return -1;
             }
-            xpath = optarg;
+            args->xpath = optarg;
             break;
         case 'f':
             if (!strcmp(optarg, "xml")) {
-                format = LYD_XML;
+                args->format = LYD_XML;
             } else if (!strcmp(optarg, "json")) {
-                format = LYD_JSON;
+                args->format = LYD_JSON;
             } else if (!strcmp(optarg, "lyb")) {
-                format = LYD_LYB;
+                args->format = LYD_LYB;
             } else {
                 error_print(0, "Unknown format \"%s\"", optarg);
-                goto cleanup;
+                return -1;
             }
             break;
         case 'l':
-            lock = 1;
+            args->lock = 1;
             break;
         case 'n':
-            not_strict = 1;
+            args->not_strict = 1;
             break;
         case 'o':
-            opaq = 1;
+            args->opaq = 1;
             break;
         case 'p':
-            max_depth = strtoul(optarg, &ptr, 10);
+            args->max_depth = strtoul(optarg, &ptr, 10);
             if (ptr[0]) {
                 error_print(0, "Invalid depth \"%s\"", optarg);
-                goto cleanup;
+                return -1;
+            }
+            break;
+        case 'c':
+            args->chunk_size = strtoul(optarg, &ptr, 10);
+            if (ptr[0] || !args->chunk_size) {
+                error_print(0, "Invalid chunk size \"%s\"", optarg);
+                return -1;
             }
             break;
         case 't':
-            timeout = strtoul(optarg, &ptr, 10);
+            args->timeout = strtoul(optarg, &ptr, 10);
             if (ptr[0]) {
                 error_print(0, "Invalid timeout \"%s\"", optarg);
-                goto cleanup;
+                return -1;
             }
             break;
         case 'e':
             if (!strcmp(optarg, "report-all")) {
-                wd_opt = LYD_PRINT_WD_ALL;
+                args->wd_opt = LYD_PRINT_WD_ALL;
             } else if (!strcmp(optarg, "report-all-tagged")) {
-                wd_opt = LYD_PRINT_WD_ALL_TAG;
+                args->wd_opt = LYD_PRINT_WD_ALL_TAG;
             } else if (!strcmp(optarg, "trim")) {
-                wd_opt = LYD_PRINT_WD_TRIM;
+                args->wd_opt = LYD_PRINT_WD_TRIM;
             } else if (!strcmp(optarg, "explicit")) {
-                wd_opt = LYD_PRINT_WD_EXPLICIT;
+                args->wd_opt = LYD_PRINT_WD_EXPLICIT;
             } else if (!strcmp(optarg, "implicit-tagged")) {
-                wd_opt = LYD_PRINT_WD_IMPL_TAG;
+                args->wd_opt = LYD_PRINT_WD_IMPL_TAG;
             } else {
                 error_print(0, "Invalid defaults mode \"%s\"", optarg);
-                goto cleanup;
+                return -1;
             }
             break;
         case 'v':
@@ -869,24 +956,25 @@ main(int argc, char **argv)
                 log_level = atoi(optarg);
             } else {
                 error_print(0, "Invalid verbosity \"%s\"", optarg);
-                goto cleanup;
+                return -1;
             }
             break;
         default:
             error_print(0, "Invalid option or missing argument: -%c", optopt);
-            goto cleanup;
+            return -1;
         }
     }
 
+
     /* check for additional argument */
     if (optind < argc) {
         error_print(0, "Redundant parameters (%s)", argv[optind]);
-        goto cleanup;
+        return -1;
     }
 
     /* check if operation on the datastore is supported */
-    if (ds == SR_DS_OPERATIONAL) {
-        switch (operation) {
+    if (args->ds == SR_DS_OPERATIONAL) {
+        switch (args->operation) {
         case 'I':
             op_str = "Import";
             break;
@@ -903,45 +991,39 @@ main(int argc, char **argv)
 
         if (op_str) {
             error_print(0, "%s operation on operational DS not supported, changes would be lost after session is terminated", op_str);
-            goto cleanup;
+            return -1;
         }
     }
 
-    /* set logging */
-    sr_log_stderr(log_level);
+    return 0;
+}
 
-    /* create connection */
-    if ((r = sr_connect(0, &conn)) != SR_ERR_OK) {
-        error_print(r, "Failed to connect");
-        goto cleanup;
-    }
+static int
+op_perform(sr_session_ctx_t *sess, const struct cfg_args *args)
+{
+    int r;
 
-    /* create session */
-    if ((r = sr_session_start(conn, ds, &sess)) != SR_ERR_OK) {
-        error_print(r, "Failed to start a session");
-        goto cleanup;
+    if ((r = sr_session_switch_ds(sess, args->ds)) != SR_ERR_OK) {
+        error_print(r, "Failed to switch the session datastore");
+        return EXIT_FAILURE;
     }
 
-    /* perform the operation */
-    switch (operation) {
+    switch (args->operation) {
     case 'I':
-        rc = op_import(sess, file_path, module_name, format, not_strict, timeout);
-        break;
+        return op_import(sess, args->file_path, args->module_name, args->format, args->not_strict, args->timeout);
     case 'X':
-        rc = op_export(sess, file_path, module_name, xpath, format, max_depth, wd_opt, timeout);
-        break;
+        return op_export(sess, args->file_path, args->module_name, args->xpath, args->format, args->max_depth,
+                args->chunk_size, args->wd_opt, args->timeout);
     case 'E':
-        rc = op_edit(sess, file_path, editor, module_name, format, lock, not_strict, opaq, wd_opt, timeout);
-        break;
+        return op_edit(sess, args->file_path, args->editor, args->module_name, args->format, args->lock,
+                args->not_strict, args->opaq, args->wd_opt, args->timeout);
     case 'R':
-        rc = op_rpc(sess, file_path, editor, format, wd_opt, timeout);
-        break;
+        return op_rpc(sess, args->file_path, args->editor, args->format, args->wd_opt, args->timeout);
     case 'N':
-        rc = op_notif(sess, file_path, editor, format);
-        break;
+        return op_notif(sess, args->file_path, args->editor, args->format);
     case 'C':
-        rc = op_copy(sess, file_path, source_ds, module_name, format, not_strict, timeout);
-        break;
+        return op_copy(sess, args->file_path, args->source_ds, args->module_name, args->format, args->not_strict,
+                args->timeout);
     case 0:
         error_print(0, "No operation specified");
         break;
@@ -950,6 +1032,177 @@ main(int argc, char **argv)
         break;
     }
 
+    return EXIT_FAILURE;
+}
+
+static int
+step_split_line(char *line, int *argc, char ***argv)
+{
+    char *ptr, *arg, quote;
+    void *mem;
+
+    *argc = 0;
+    *argv = NULL;
+
+    /* the program name */
+    mem = malloc(2 * sizeof **argv);
+    if (!mem) {
+        return EXIT_FAILURE;
+    }
+    *argv = mem;
+    (*argv)[(*argc)++] = "sysrepocfg";
+
+    ptr = line;
+    while (1) {
+        /* skip whitespaces */
+        while (isspace(*ptr)) {
+            ++ptr;
+        }
+        if (!*ptr || (*ptr == '#')) {
+            /* end of the line or a comment */
+            break;
+        }
+
+        /* read an argument in place, it may be quoted */
+        arg = ptr;
+        if ((*ptr == '\'') || (*ptr == '"')) {
+            quote = *ptr;
+            arg = ++ptr;
+            while (*ptr && (*ptr != quote)) {
+                ++ptr;
+            }
+            if (!*ptr) {
+                error_print(0, "Missing closing quote");
+                return EXIT_FAILURE;
+            }
+        } else {
+            while (*ptr && !isspace(*ptr)) {
+                ++ptr;
+            }
+        }
+        if (*ptr) {
+            *ptr = '\0';
+            ++ptr;
+        }
+
+        mem = realloc(*argv, (*argc + 2) * sizeof **argv);
+        if (!mem) {
+            return EXIT_FAILURE;
+        }
+        *argv = mem;
+        (*argv)[(*argc)++] = arg;
+    }
+
+    /* terminate the arguments */
+    (*argv)[*argc] = NULL;
+    return EXIT_SUCCESS;
+}
+
+static int
+op_batch(sr_session_ctx_t *sess, const char *file_path)
+{
+    struct cfg_args args;
+    FILE *file = stdin;
+    char *line = NULL, **argv = NULL;
+    size_t line_len = 0;
+    uint32_t line_num = 0;
+    int argc, r, rc = EXIT_SUCCESS;
+
+    if (file_path) {
+        file = fopen(file_path, "r");
+        if (!file) {
+            error_print(0, "Failed to open \"%s\" for reading (%s)", file_path, strerror(errno));
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* perform every operation with its own arguments on the same session */
+    while (getline(&line, &line_len, file) != -1) {
+        ++line_num;
+
+        free(argv);
+        if (step_split_line(line, &argc, &argv)) {
+            rc = EXIT_FAILURE;
+            break;
+        }
+        if (argc == 1) {
+            /* empty line or comment */
+            continue;
+        }
+
+        r = arg_parse(argc, argv, &args);
+        if (r == 1) {
+            continue;
+        } else if (!r && (args.operation == 'B')) {
+            error_print(0, "Batch operation cannot be nested");
+            r = -1;
+        } else if (!r && !file_path && (args.operation == 'I') && !args.file_path) {
+            error_print(0, "Import from STDIN is not possible when the batch is read from STDIN");
+            r = -1;
+        } else if (!r) {
+            r = op_perform(sess, &args);
+        }
+
+        if (r) {
+            error_print(0, "Batch operation on line %" PRIu32 " failed", line_num);
+            rc = EXIT_FAILURE;
+            break;
+        }
+    }
+
+    free(argv);
+    free(line);
+    if (file_path) {
+        fclose(file);
+    }
+    return rc;
+}
+
+int
+main(int argc, char **argv)
+{
+    sr_conn_ctx_t *conn = NULL;
+    sr_session_ctx_t *sess = NULL;
+    struct cfg_args args;
+    int r, rc = EXIT_FAILURE;
+
+    if (argc == 1) {
+        help_print();
+        goto cleanup;
+    }
+
+    /* process options */
+    r = arg_parse(argc, argv, &args);
+    if (r == 1) {
+        rc = EXIT_SUCCESS;
+        goto cleanup;
+    } else if (r) {
+        goto cleanup;
+    }
+
+    /* set logging */
+    sr_log_stderr(log_level);
+
+    /* create connection */
+    if ((r = sr_connect(0, &conn)) != SR_ERR_OK) {
+        error_print(r, "Failed to connect");
+        goto cleanup;
+    }
+
+    /* create session */
+    if ((r = sr_session_start(conn, args.ds, &sess)) != SR_ERR_OK) {
+        error_print(r, "Failed to start a session");
+        goto cleanup;
+    }
+
+    /* perform the operation */
+    if (args.operation == 'B') {
+        /* all the operations from the batch share the connection and session */
+        rc = op_batch(sess, args.file_path);
+    } else {
+        rc = op_perform(sess, &args);
+    }
+
 cleanup:
     sr_session_stop(sess);
     sr_disconnect(conn);
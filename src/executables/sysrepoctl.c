@@ -18,6 +18,7 @@
 
 #include <assert.h>
 #include <getopt.h>
+#include <inttypes.h>
 #include <stdarg.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -52,6 +53,17 @@ struct list_item {
     char *features;
 };
 
+struct slow_sub_item {
+    const char *owner;
+    const char *type;
+    const char *xpath;
+    uint32_t cid;
+    uint64_t count;
+    uint64_t avg_time;
+    uint64_t max_time;
+    uint64_t max_queue_time;
+};
+
 struct change_item {
     const char *module_name;
     const char **features;
@@ -101,7 +113,18 @@ help_print(void)
             "  -P, --plugin-install <path>\n"
             "                       Install a datastore or notification sysrepo plugin. The plugin is simply copied\n"
             "                       to the designated plugin directory.\n"
-            "\n"
+            "  -S, --shm-stats      Print memory usage of all the shared memory, fragmentation of the one with\n"
+            "                       all the subscriptions, and the memory used by every module and mapped\n"
+            "                       by every connection with subscriptions.\n"
+            "  -w, --slow-subs[=<count>]\n"
+            "                       List the subscriptions with the longest callback durations, optionally only\n"
+            "                       a number of the slowest ones.\n"
+            "  -T, --transaction    Perform all the following install, uninstall, update, and change operations\n"
+            "                       in a single context change so that the modules and their data are processed\n"
+            "                       only once. The operations can be combined and change op can be specified\n"
+            "                       multiple times but then supports only changing features and replay.\n"
+            "\n");
+    printf(
             "Available options:\n"
             "  -s, --search-dirs <dir-path> [:<dir-path>...]\n"
             "                       Directories to search for include/import modules. Directory with already-installed\n"
@@ -201,6 +224,69 @@ new_str(const char *optarg, const char ***strs)
     return 0;
 }
 
+static int
+tr_add_citem(struct change_item *citem, sr_feature_change_t **feats, uint32_t *feat_count, sr_replay_change_t **replays,
+        uint32_t *replay_count)
+{
+    void *mem;
+    uint32_t i;
+    int en, r = 0;
+
+    if (!citem->module_name) {
+        /* no change */
+        return 0;
+    }
+
+    if (!strcmp(citem->module_name, ":ALL")) {
+        /* all the modules */
+        if (citem->features || citem->dis_features) {
+            error_print(0, "To enable/disable features, the module must be specified");
+            r = 1;
+            goto cleanup;
+        }
+        citem->module_name = NULL;
+    }
+
+    /* enabled and disabled features */
+    for (en = 1; en >= 0; --en) {
+        for (i = 0; (en ? citem->features : citem->dis_features) && (en ? citem->features : citem->dis_features)[i];
+                ++i) {
+            mem = realloc(*feats, (*feat_count + 1) * sizeof **feats);
+            if (!mem) {
+                r = 1;
+                goto cleanup;
+            }
+            *feats = mem;
+            (*feats)[*feat_count].module_name = citem->module_name;
+            (*feats)[*feat_count].feature_name = (en ? citem->features : citem->dis_features)[i];
+            (*feats)[*feat_count].enable = en;
+            ++(*feat_count);
+        }
+    }
+
+    /* replay */
+    if (citem->replay != -1) {
+        mem = realloc(*replays, (*replay_count + 1) * sizeof **replays);
+        if (!mem) {
+            r = 1;
+            goto cleanup;
+        }
+        *replays = mem;
+        (*replays)[*replay_count].module_name = citem->module_name;
+        (*replays)[*replay_count].enable = citem->replay;
+        ++(*replay_count);
+    }
+
+cleanup:
+    /* prepare for the next change */
+    free(citem->features);
+    free(citem->dis_features);
+    memset(citem, 0, sizeof *citem);
+    citem->replay = -1;
+    citem->mod_ds = SR_MOD_DS_PLUGIN_COUNT;
+    return r;
+}
+
 static int
 set_replay(const char *optarg, int *replay)
 {
@@ -606,6 +692,169 @@ cleanup:
     return ret;
 }
 
+static int
+srctl_shm_stats(sr_conn_ctx_t *conn)
+{
+    int ret;
+    sr_shm_stats_t *stats;
+    const sr_ext_shm_stats_t *ext;
+    const sr_mod_shm_stats_t *mod;
+    uint32_t i;
+
+    if ((ret = sr_get_shm_stats(conn, &stats))) {
+        return ret;
+    }
+    ext = &stats->ext;
+
+    printf("Main SHM size:          %" PRIu64 "\n", stats->main_size);
+    printf("Module SHM size:        %" PRIu64 "\n", stats->mod_size);
+    printf("Subscription SHM size:  %" PRIu64 "\n", ext->size);
+    printf("Used:                   %" PRIu64 "\n", ext->size - ext->hole_size);
+    printf("Memory holes:           %" PRIu32 "\n", ext->hole_count);
+    printf("Memory holes size:      %" PRIu64 "\n", ext->hole_size);
+    printf("Largest memory hole:    %" PRIu64 "\n", ext->largest_hole);
+    printf("Fragmentation:          %" PRIu64 "%%\n",
+            ext->hole_size ? 100 - (ext->largest_hole * 100) / ext->hole_size : 0);
+    printf("Event SHM files:        %" PRIu32 " (%" PRIu64 ")\n", stats->sub_shm_count, stats->sub_shm_size);
+    printf("Event data SHM files:   %" PRIu32 " (%" PRIu64 ")\n", stats->sub_data_shm_count, stats->sub_data_shm_size);
+
+    /* modules with any subscriptions or files */
+    printf("\n%-40s %6s %10s %14s %14s\n", "Module Name", "Subs", "Subs size", "Event SHM", "Event data SHM");
+    for (i = 0; i < stats->mod_count; ++i) {
+        mod = &stats->mods[i];
+        if (!mod->sub_count && !mod->ext_size && !mod->sub_shm_count && !mod->sub_data_shm_count) {
+            continue;
+        }
+        printf("%-40s %6" PRIu32 " %10" PRIu64 " %4" PRIu32 " %9" PRIu64 " %4" PRIu32 " %9" PRIu64 "\n", mod->name,
+                mod->sub_count, mod->ext_size, mod->sub_shm_count, mod->sub_shm_size, mod->sub_data_shm_count,
+                mod->sub_data_shm_size);
+    }
+
+    /* connections */
+    printf("\n%-10s %6s %14s\n", "CID", "Subs", "Mapped size");
+    for (i = 0; i < stats->conn_count; ++i) {
+        printf("%-10" PRIu32 " %6" PRIu32 " %14" PRIu64 "\n", stats->conns[i].cid, stats->conns[i].sub_count,
+                stats->conns[i].mapped_size);
+    }
+
+    sr_free_shm_stats(stats);
+    return SR_ERR_OK;
+}
+
+static uint64_t
+srctl_slow_subs_leaf(const struct lyd_node *parent, const char *path)
+{
+    struct lyd_node *leaf;
+
+    if (lyd_find_path(parent, path, 0, &leaf)) {
+        return 0;
+    }
+    return strtoull(lyd_get_value(leaf), NULL, 10);
+}
+
+static int
+srctl_slow_subs_cmp(const void *ptr1, const void *ptr2)
+{
+    const struct slow_sub_item *item1 = ptr1, *item2 = ptr2;
+
+    /* sort by the longest callback duration, descending */
+    if (item1->max_time != item2->max_time) {
+        return (item1->max_time < item2->max_time) ? 1 : -1;
+    }
+    if (item1->avg_time != item2->avg_time) {
+        return (item1->avg_time < item2->avg_time) ? 1 : -1;
+    }
+    return 0;
+}
+
+static int
+srctl_slow_subs(sr_conn_ctx_t *conn, uint32_t max_count)
+{
+    int ret = SR_ERR_OK;
+    sr_session_ctx_t *sess = NULL;
+    sr_data_t *data = NULL;
+    struct lyd_node *node, *sub, *owner, *xpath;
+    struct slow_sub_item *items = NULL, *item;
+    uint32_t i, item_count = 0;
+    void *mem;
+
+    /* get all the subscriptions */
+    if ((ret = sr_session_start(conn, SR_DS_OPERATIONAL, &sess))) {
+        goto cleanup;
+    }
+    if ((ret = sr_get_data(sess, "/sysrepo-monitoring:sysrepo-state", 0, 0, 0, &data))) {
+        goto cleanup;
+    }
+    if (!data) {
+        goto cleanup;
+    }
+
+    /* collect all the subscriptions with callback statistics */
+    LYD_TREE_DFS_BEGIN(data->tree, node) {
+        if (!strcmp(LYD_NAME(node), "callback-time")) {
+            sub = lyd_parent(node);
+
+            mem = realloc(items, (item_count + 1) * sizeof *items);
+            if (!mem) {
+                ret = SR_ERR_NO_MEMORY;
+                goto cleanup;
+            }
+            items = mem;
+            item = &items[item_count];
+            ++item_count;
+            memset(item, 0, sizeof *item);
+
+            /* subscription information, XPath of operational get subscriptions is in the parent */
+            item->type = LYD_NAME(sub);
+            xpath = NULL;
+            if (!strcmp(item->type, "xpath-sub")) {
+                item->type = LYD_NAME(lyd_parent(sub));
+                lyd_find_path(lyd_parent(sub), "xpath", 0, &xpath);
+            } else {
+                lyd_find_path(sub, "xpath", 0, &xpath);
+            }
+            item->xpath = xpath ? lyd_get_value(xpath) : "";
+            item->cid = srctl_slow_subs_leaf(sub, "cid");
+
+            /* module or RPC the subscription belongs to, identified by its key */
+            for (owner = sub; owner && strcmp(LYD_NAME(owner), "module") && strcmp(LYD_NAME(owner), "rpc");
+                    owner = lyd_parent(owner)) {}
+            item->owner = owner ? lyd_get_value(lyd_child(owner)) : "";
+
+            /* statistics */
+            item->count = srctl_slow_subs_leaf(node, "count");
+            item->avg_time = item->count ? srctl_slow_subs_leaf(node, "total-time") / item->count : 0;
+            item->max_time = srctl_slow_subs_leaf(node, "max-time");
+            item->max_queue_time = srctl_slow_subs_leaf(sub, "queue-time/max-time");
+
+            LYD_TREE_DFS_continue = 1;
+        }
+
+        LYD_TREE_DFS_END(data->tree, node);
+    }
+
+    /* sort */
+    qsort(items, item_count, sizeof *items, srctl_slow_subs_cmp);
+    if (max_count && (max_count < item_count)) {
+        item_count = max_count;
+    }
+
+    /* print */
+    printf("%10s %10s %10s %10s %6s  %-20s %-30s %s\n", "Max [us]", "Avg [us]", "Count", "Queue [us]", "CID", "Type",
+            "Module/RPC", "XPath");
+    for (i = 0; i < item_count; ++i) {
+        item = &items[i];
+        printf("%10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %6" PRIu32 "  %-20s %-30s %s\n", item->max_time,
+                item->avg_time, item->count, item->max_queue_time, item->cid, item->type, item->owner, item->xpath);
+    }
+
+cleanup:
+    free(items);
+    sr_release_data(data);
+    sr_session_stop(sess);
+    return ret;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -613,9 +862,13 @@ main(int argc, char **argv)
     sr_install_mod_t *iitems = NULL;
     uint32_t i, iitem_count = 0;
     struct change_item citem = {.replay = -1, .mod_ds = SR_MOD_DS_PLUGIN_COUNT};
-    const char *file_path = NULL, *search_dirs = NULL, **module_names = NULL, *data_path = NULL;
+    sr_module_change_set_t changes = {0};
+    sr_feature_change_t *feats = NULL;
+    sr_replay_change_t *replays = NULL;
+    const char *file_path = NULL, *search_dirs = NULL, **module_names = NULL, **upd_paths = NULL, *data_path = NULL;
     char *ptr;
-    int r, rc = EXIT_FAILURE, opt, operation = 0, force = 0;
+    uint32_t slow_sub_count = 0, feat_count = 0, replay_count = 0;
+    int r, rc = EXIT_FAILURE, opt, operation = 0, force = 0, transaction = 0;
     struct option options[] = {
         {"help",            no_argument,       NULL, 'h'},
         {"version",         no_argument,       NULL, 'V'},
@@ -626,6 +879,9 @@ main(int argc, char **argv)
         {"update",          required_argument, NULL, 'U'},
         {"plugin-list",     no_argument,       NULL, 'L'},
         {"plugin-install",  required_argument, NULL, 'P'},
+        {"shm-stats",       no_argument,       NULL, 'S'},
+        {"slow-subs",       optional_argument, NULL, 'w'},
+        {"transaction",     no_argument,       NULL, 'T'},
         {"search-dirs",     required_argument, NULL, 's'},
         {"enable-feature",  required_argument, NULL, 'e'},
         {"disable-feature", required_argument, NULL, 'd'},
@@ -648,7 +904,7 @@ main(int argc, char **argv)
 
     /* process options */
     opterr = 0;
-    while ((opt = getopt_long(argc, argv, "hVli:u:c:U:LP:s:e:d:r:o:g:p:D:m:I:fv:", options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "hVli:u:c:U:LP:Sw::Ts:e:d:r:o:g:p:D:m:I:fv:", options, NULL)) != -1) {
         switch (opt) {
         case 'h':
             /* help */
@@ -671,7 +927,7 @@ main(int argc, char **argv)
             break;
         case 'i':
             /* install */
-            if (operation && (operation != 'i')) {
+            if (operation && (operation != 'i') && !transaction) {
                 error_print(0, "Operation already specified");
                 goto cleanup;
             }
@@ -682,7 +938,7 @@ main(int argc, char **argv)
             break;
         case 'u':
             /* uninstall */
-            if (operation && (operation != 'u')) {
+            if (operation && (operation != 'u') && !transaction) {
                 error_print(0, "Operation already specified");
                 goto cleanup;
             }
@@ -693,21 +949,24 @@ main(int argc, char **argv)
             break;
         case 'c':
             /* change */
-            if (operation) {
+            if (operation && !transaction) {
                 error_print(0, "Operation already specified");
                 goto cleanup;
             }
+            if (transaction && tr_add_citem(&citem, &feats, &feat_count, &replays, &replay_count)) {
+                goto cleanup;
+            }
             operation = 'c';
             citem.module_name = optarg;
             break;
         case 'U':
             /* update */
-            if (operation && (operation != 'U')) {
+            if (operation && (operation != 'U') && !transaction) {
                 error_print(0, "Operation already specified");
                 goto cleanup;
             }
             operation = 'U';
-            if (new_str(optarg, &module_names)) {
+            if (new_str(optarg, &upd_paths)) {
                 goto cleanup;
             }
             break;
@@ -728,6 +987,37 @@ main(int argc, char **argv)
             operation = 'P';
             file_path = optarg;
             break;
+        case 'S':
+            /* shm-stats */
+            if (operation) {
+                error_print(0, "Operation already specified");
+                goto cleanup;
+            }
+            operation = 'S';
+            break;
+        case 'w':
+            /* slow-subs */
+            if (operation) {
+                error_print(0, "Operation already specified");
+                goto cleanup;
+            }
+            operation = 'w';
+            if (optarg) {
+                slow_sub_count = strtoul(optarg, &ptr, 10);
+                if (ptr[0]) {
+                    error_print(0, "Invalid subscription count \"%s\"", optarg);
+                    goto cleanup;
+                }
+            }
+            break;
+        case 'T':
+            /* transaction */
+            if (operation) {
+                error_print(0, "Transaction must be specified before all the operations");
+                goto cleanup;
+            }
+            transaction = 1;
+            break;
         case 's':
             /* search-dirs */
             if (search_dirs) {
@@ -779,7 +1069,7 @@ main(int argc, char **argv)
                 if (set_owner(optarg, &iitems[iitem_count - 1].owner)) {
                     goto cleanup;
                 }
-            } else if (operation == 'c') {
+            } else if ((operation == 'c') && !transaction) {
                 if (set_owner(optarg, &citem.owner)) {
                     goto cleanup;
                 }
@@ -794,7 +1084,7 @@ main(int argc, char **argv)
                 if (set_group(optarg, &iitems[iitem_count - 1].group)) {
                     goto cleanup;
                 }
-            } else if (operation == 'c') {
+            } else if ((operation == 'c') && !transaction) {
                 if (set_group(optarg, &citem.group)) {
                     goto cleanup;
                 }
@@ -809,7 +1099,7 @@ main(int argc, char **argv)
                 if (set_perms(optarg, &iitems[iitem_count - 1].perm)) {
                     goto cleanup;
                 }
-            } else if (operation == 'c') {
+            } else if ((operation == 'c') && !transaction) {
                 if (set_perms(optarg, &citem.perms)) {
                     goto cleanup;
                 }
@@ -820,7 +1110,7 @@ main(int argc, char **argv)
             break;
         case 'D':
             /* datastore */
-            if (operation == 'c') {
+            if ((operation == 'c') && !transaction) {
                 if (set_datastore(optarg, &citem.mod_ds)) {
                     goto cleanup;
                 }
@@ -842,7 +1132,7 @@ main(int argc, char **argv)
             break;
         case 'I':
             /* init-data */
-            if (operation == 'i') {
+            if ((operation == 'i') && !transaction) {
                 data_path = optarg;
             } else {
                 error_operation(operation, opt);
@@ -900,6 +1190,34 @@ main(int argc, char **argv)
         }
     }
 
+    if (transaction) {
+        /* all the module changes at once */
+        if (operation && !strchr("iucU", operation)) {
+            error_print(0, "Operation '%c' cannot be performed in a transaction", operation);
+            goto cleanup;
+        }
+        if (tr_add_citem(&citem, &feats, &feat_count, &replays, &replay_count)) {
+            goto cleanup;
+        }
+
+        changes.install = iitems;
+        changes.install_count = iitem_count;
+        changes.remove = module_names;
+        changes.force_remove = force;
+        changes.update = upd_paths;
+        changes.features = feats;
+        changes.feature_count = feat_count;
+        changes.replay = replays;
+        changes.replay_count = replay_count;
+        if ((r = sr_change_modules(conn, &changes, search_dirs))) {
+            error_print(r, "Failed to change modules");
+            goto cleanup;
+        }
+
+        rc = EXIT_SUCCESS;
+        goto cleanup;
+    }
+
     /* perform the operation */
     switch (operation) {
     case 'l':
@@ -934,7 +1252,7 @@ main(int argc, char **argv)
         break;
     case 'U':
         /* update */
-        if ((r = sr_update_modules(conn, module_names, search_dirs))) {
+        if ((r = sr_update_modules(conn, upd_paths, search_dirs))) {
             error_print(r, "Failed to update modules");
             goto cleanup;
         }
@@ -946,6 +1264,20 @@ main(int argc, char **argv)
             goto cleanup;
         }
         break;
+    case 'S':
+        /* shm-stats */
+        if ((r = srctl_shm_stats(conn))) {
+            error_print(r, "Failed to get SHM statistics");
+            goto cleanup;
+        }
+        break;
+    case 'w':
+        /* slow-subs */
+        if ((r = srctl_slow_subs(conn, slow_sub_count))) {
+            error_print(r, "Failed to list subscriptions");
+            goto cleanup;
+        }
+        break;
     case 'P':
         /* plugin-install */
         if (asprintf(&ptr, "/bin/mkdir -p \"%s\" && /bin/cp -- \"%s\" %s", SR_PLG_PATH, file_path, SR_PLG_PATH) == -1) {
@@ -977,6 +1309,9 @@ cleanup:
     free(iitems);
     free(citem.features);
     free(citem.dis_features);
+    free(feats);
+    free(replays);
     free(module_names);
+    free(upd_paths);
     return rc;
 }
@@ -19,11 +19,15 @@
 #include "log.h"
 
 #include <assert.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <syslog.h>
+#include <time.h>
 
 #include <libyang/libyang.h>
 
@@ -35,6 +39,38 @@ sr_log_level_t sr_syslog_ll = SR_LL_NONE;   /**< syslog log level */
 int syslog_open;                            /**< Whether syslog was opened */
 sr_log_cb sr_lcb;                           /**< Logging callback */
 
+/**
+ * @brief Asynchronous logging ring slot.
+ */
+struct sr_log_async_slot_s {
+    ATOMIC_T seq;           /**< Slot sequence number, the slot is full if it is the next dequeue position. */
+    int plugin;             /**< Whether the message was generated by a plugin. */
+    sr_log_level_t ll;      /**< Message log level. */
+    char *msg;              /**< Message. */
+};
+
+/**
+ * @brief Asynchronous logging, bounded lock-free multi-producer single-consumer ring with a writer thread.
+ */
+static struct {
+    struct sr_log_async_slot_s slots[SR_LOG_ASYNC_RING_SIZE];   /**< Ring slots. */
+    ATOMIC_T enq_pos;       /**< Next enqueue position. */
+    uint_fast32_t deq_pos;  /**< Next dequeue position, used only by the writer thread. */
+    ATOMIC_T running;       /**< Whether asynchronous logging is enabled. */
+    ATOMIC_T producers;     /**< Number of threads currently enqueueing a message. */
+    ATOMIC_T dropped;       /**< Number of messages dropped because the ring was full. */
+    ATOMIC_T waiting;       /**< Whether the writer thread is (going to be) waiting for new messages. */
+    ATOMIC_T stop;          /**< Whether the writer thread should stop. */
+    pthread_t tid;          /**< Writer thread ID. */
+    pthread_mutex_t ctl_lock;   /**< Lock for enabling/disabling asynchronous logging. */
+    pthread_mutex_t lock;   /**< Lock for waiting on @p cond. */
+    pthread_cond_t cond;    /**< Condition signalled on new messages. */
+} sr_log_async_ring = {
+    .ctl_lock = PTHREAD_MUTEX_INITIALIZER,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER
+};
+
 /**
  * @brief String error list.
  */
@@ -103,8 +139,15 @@ sr_api_ret(sr_session_ctx_t *session, sr_error_info_t *err_info)
     return err_code;
 }
 
-void
-sr_log_msg(int plugin, sr_log_level_t ll, const char *msg)
+/**
+ * @brief Write a message to all the log outputs.
+ *
+ * @param[in] plugin Whether the message was generated by a plugin.
+ * @param[in] ll Log level (severity).
+ * @param[in] msg Message.
+ */
+static void
+sr_log_msg_write(int plugin, sr_log_level_t ll, const char *msg)
 {
     int priority = 0;
     const char *severity = NULL;
@@ -147,6 +190,178 @@ sr_log_msg(int plugin, sr_log_level_t ll, const char *msg)
     }
 }
 
+/**
+ * @brief Enqueue a message into the asynchronous logging ring.
+ *
+ * @param[in] plugin Whether the message was generated by a plugin.
+ * @param[in] ll Log level (severity).
+ * @param[in] msg Message.
+ * @return 0 if the message was enqueued or dropped, non-zero if it needs to be written synchronously.
+ */
+static int
+sr_log_async_push(int plugin, sr_log_level_t ll, const char *msg)
+{
+    struct sr_log_async_slot_s *slot;
+    uint_fast32_t pos, seq;
+    char *dup;
+    int r;
+
+    if (!(dup = strdup(msg))) {
+        return 1;
+    }
+
+    /* claim a slot */
+    pos = ATOMIC_LOAD_RELAXED(sr_log_async_ring.enq_pos);
+    while (1) {
+        slot = &sr_log_async_ring.slots[pos & (SR_LOG_ASYNC_RING_SIZE - 1)];
+        seq = ATOMIC_LOAD_RELAXED(slot->seq);
+        ATOMIC_FENCE();
+        if ((int32_t)(seq - pos) == 0) {
+            ATOMIC_COMPARE_EXCHANGE_RELAXED(sr_log_async_ring.enq_pos, pos, pos + 1, r);
+            if (r) {
+                break;
+            }
+        } else if ((int32_t)(seq - pos) < 0) {
+            /* ring full */
+            ATOMIC_INC_RELAXED(sr_log_async_ring.dropped);
+            free(dup);
+            return 0;
+        } else {
+            pos = ATOMIC_LOAD_RELAXED(sr_log_async_ring.enq_pos);
+        }
+    }
+
+    /* fill and publish it */
+    slot->plugin = plugin;
+    slot->ll = ll;
+    slot->msg = dup;
+    ATOMIC_FENCE();
+    ATOMIC_STORE_RELAXED(slot->seq, pos + 1);
+
+    /* wake the writer, if waiting */
+    ATOMIC_FENCE();
+    if (ATOMIC_LOAD_RELAXED(sr_log_async_ring.waiting)) {
+        pthread_mutex_lock(&sr_log_async_ring.lock);
+        pthread_cond_signal(&sr_log_async_ring.cond);
+        pthread_mutex_unlock(&sr_log_async_ring.lock);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Dequeue a message from the asynchronous logging ring, only by the writer thread.
+ *
+ * @param[out] plugin Whether the message was generated by a plugin.
+ * @param[out] ll Log level (severity).
+ * @param[out] msg Message, to be freed.
+ * @return 1 if a message was dequeued, 0 if the ring is empty.
+ */
+static int
+sr_log_async_pop(int *plugin, sr_log_level_t *ll, char **msg)
+{
+    struct sr_log_async_slot_s *slot;
+    uint_fast32_t pos = sr_log_async_ring.deq_pos;
+
+    slot = &sr_log_async_ring.slots[pos & (SR_LOG_ASYNC_RING_SIZE - 1)];
+    if (ATOMIC_LOAD_RELAXED(slot->seq) != pos + 1) {
+        return 0;
+    }
+    ATOMIC_FENCE();
+
+    *plugin = slot->plugin;
+    *ll = slot->ll;
+    *msg = slot->msg;
+    slot->msg = NULL;
+
+    /* release the slot for the next cycle */
+    ATOMIC_FENCE();
+    ATOMIC_STORE_RELAXED(slot->seq, pos + SR_LOG_ASYNC_RING_SIZE);
+    sr_log_async_ring.deq_pos = pos + 1;
+    return 1;
+}
+
+/**
+ * @brief Asynchronous logging writer thread.
+ *
+ * @param[in] arg Unused.
+ * @return Always NULL.
+ */
+static void *
+sr_log_async_thread(void *arg)
+{
+    struct sr_log_async_slot_s *slot;
+    struct timespec ts;
+    sr_log_level_t ll;
+    uint32_t dropped, reported = 0;
+    int plugin, stop;
+    char *msg, buf[64];
+
+    (void)arg;
+
+    do {
+        stop = ATOMIC_LOAD_RELAXED(sr_log_async_ring.stop);
+
+        /* write all the queued messages */
+        while (sr_log_async_pop(&plugin, &ll, &msg)) {
+            sr_log_msg_write(plugin, ll, msg);
+            free(msg);
+        }
+
+        /* report dropped messages */
+        dropped = ATOMIC_LOAD_RELAXED(sr_log_async_ring.dropped);
+        if (dropped != reported) {
+            sprintf(buf, "%" PRIu32 " log messages were dropped.", dropped - reported);
+            sr_log_msg_write(0, SR_LL_WRN, buf);
+            reported = dropped;
+        }
+
+        if (!stop) {
+            /* wait for new messages */
+            pthread_mutex_lock(&sr_log_async_ring.lock);
+            ATOMIC_STORE_RELAXED(sr_log_async_ring.waiting, 1);
+            ATOMIC_FENCE();
+            slot = &sr_log_async_ring.slots[sr_log_async_ring.deq_pos & (SR_LOG_ASYNC_RING_SIZE - 1)];
+            if ((ATOMIC_LOAD_RELAXED(slot->seq) != sr_log_async_ring.deq_pos + 1) &&
+                    !ATOMIC_LOAD_RELAXED(sr_log_async_ring.stop)) {
+                /* a wakeup can be missed only in a rare race, do not wait too long */
+                clock_gettime(CLOCK_REALTIME, &ts);
+                ts.tv_nsec += SR_LOG_ASYNC_WAIT_MS * 1000000L;
+                if (ts.tv_nsec >= 1000000000L) {
+                    ++ts.tv_sec;
+                    ts.tv_nsec -= 1000000000L;
+                }
+                pthread_cond_timedwait(&sr_log_async_ring.cond, &sr_log_async_ring.lock, &ts);
+            }
+            ATOMIC_STORE_RELAXED(sr_log_async_ring.waiting, 0);
+            pthread_mutex_unlock(&sr_log_async_ring.lock);
+        }
+    } while (!stop);
+
+    return NULL;
+}
+
+void
+sr_log_msg(int plugin, sr_log_level_t ll, const char *msg)
+{
+    if ((ll > sr_stderr_ll) && (ll > sr_syslog_ll) && !sr_lcb) {
+        /* nothing to do */
+        return;
+    }
+
+    if (ATOMIC_LOAD_RELAXED(sr_log_async_ring.running)) {
+        ATOMIC_INC_RELAXED(sr_log_async_ring.producers);
+        ATOMIC_FENCE();
+        if (ATOMIC_LOAD_RELAXED(sr_log_async_ring.running) && !sr_log_async_push(plugin, ll, msg)) {
+            ATOMIC_DEC_RELAXED(sr_log_async_ring.producers);
+            return;
+        }
+        ATOMIC_DEC_RELAXED(sr_log_async_ring.producers);
+    }
+
+    sr_log_msg_write(plugin, ll, msg);
+}
+
 void
 sr_errinfo_add(sr_error_info_t **err_info, sr_error_t err_code, const char *err_format, const void *err_data,
         const char *msg_format, va_list *vargs)
@@ -410,6 +625,11 @@ sr_log(sr_log_level_t ll, const char *format, ...)
     char *msg;
     int msg_len = 0;
 
+    if ((ll > sr_stderr_ll) && (ll > sr_syslog_ll) && !sr_lcb) {
+        /* filtered out, do not even format it */
+        return;
+    }
+
     va_start(ap, format);
     sr_vsprintf(&msg, &msg_len, 0, format, ap);
     va_end(ap);
@@ -425,7 +645,7 @@ srplg_log(const char *plg_name, sr_log_level_t ll, const char *format, ...)
     char *msg;
     int msg_len = 0, off;
 
-    if (!plg_name) {
+    if (!plg_name || ((ll > sr_stderr_ll) && (ll > sr_syslog_ll) && !sr_lcb)) {
         return;
     }
 
@@ -499,3 +719,90 @@ sr_log_set_cb(sr_log_cb log_callback)
 
     sr_lcb = log_callback;
 }
+
+/**
+ * @brief Disable asynchronous logging, writing all the queued messages.
+ */
+static void
+sr_log_async_disable(void)
+{
+    if (!ATOMIC_LOAD_RELAXED(sr_log_async_ring.running)) {
+        return;
+    }
+
+    /* no new messages and wait for the ones being enqueued */
+    ATOMIC_STORE_RELAXED(sr_log_async_ring.running, 0);
+    ATOMIC_FENCE();
+    while (ATOMIC_LOAD_RELAXED(sr_log_async_ring.producers)) {
+        sched_yield();
+    }
+
+    /* stop the writer, it writes all the remaining messages */
+    pthread_mutex_lock(&sr_log_async_ring.lock);
+    ATOMIC_STORE_RELAXED(sr_log_async_ring.stop, 1);
+    pthread_cond_signal(&sr_log_async_ring.cond);
+    pthread_mutex_unlock(&sr_log_async_ring.lock);
+    pthread_join(sr_log_async_ring.tid, NULL);
+}
+
+/**
+ * @brief Process exit handler writing all the queued messages.
+ */
+static void
+sr_log_async_atexit(void)
+{
+    pthread_mutex_lock(&sr_log_async_ring.ctl_lock);
+    sr_log_async_disable();
+    pthread_mutex_unlock(&sr_log_async_ring.ctl_lock);
+}
+
+API int
+sr_log_async(int enable)
+{
+    static int atexit_set;
+    uint32_t i;
+    int rc = SR_ERR_OK;
+
+    pthread_mutex_lock(&sr_log_async_ring.ctl_lock);
+
+    if (!enable) {
+        sr_log_async_disable();
+        goto cleanup;
+    } else if (ATOMIC_LOAD_RELAXED(sr_log_async_ring.running)) {
+        /* already enabled */
+        goto cleanup;
+    }
+
+    /* init the ring */
+    for (i = 0; i < SR_LOG_ASYNC_RING_SIZE; ++i) {
+        ATOMIC_STORE_RELAXED(sr_log_async_ring.slots[i].seq, i);
+        sr_log_async_ring.slots[i].msg = NULL;
+    }
+    ATOMIC_STORE_RELAXED(sr_log_async_ring.enq_pos, 0);
+    sr_log_async_ring.deq_pos = 0;
+    ATOMIC_STORE_RELAXED(sr_log_async_ring.dropped, 0);
+    ATOMIC_STORE_RELAXED(sr_log_async_ring.stop, 0);
+
+    /* start the writer */
+    if (pthread_create(&sr_log_async_ring.tid, NULL, sr_log_async_thread, NULL)) {
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+    if (!atexit_set) {
+        atexit(sr_log_async_atexit);
+        atexit_set = 1;
+    }
+
+    ATOMIC_FENCE();
+    ATOMIC_STORE_RELAXED(sr_log_async_ring.running, 1);
+
+cleanup:
+    pthread_mutex_unlock(&sr_log_async_ring.ctl_lock);
+    return rc;
+}
+
+API uint32_t
+sr_log_async_dropped(void)
+{
+    return ATOMIC_LOAD_RELAXED(sr_log_async_ring.dropped);
+}
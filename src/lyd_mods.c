@@ -795,6 +795,68 @@ sr_lydmods_add_inv_data_dep(struct lyd_node *sr_mod, const char *inv_dep_mod)
     return NULL;
 }
 
+/**
+ * @brief Add an imported module into SR internal module data.
+ *
+ * @param[in] sr_mod Module importing @p imp_mod.
+ * @param[in] imp_mod Name of the imported module.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lydmods_add_import(struct lyd_node *sr_mod, const char *imp_mod)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *node;
+
+    /* does it exist already? */
+    LY_LIST_FOR(lyd_child(sr_mod), node) {
+        if (strcmp(node->schema->name, "imports")) {
+            continue;
+        }
+
+        if (!strcmp(lyd_get_value(node), imp_mod)) {
+            /* exists already */
+            return NULL;
+        }
+    }
+
+    SR_CHECK_LY_RET(lyd_new_term(sr_mod, NULL, "imports", imp_mod, 0, NULL), LYD_CTX(sr_mod), err_info)
+
+    return NULL;
+}
+
+/**
+ * @brief Add all the modules imported by a module and its submodules into SR internal module data.
+ *
+ * @param[in] sr_mod Module to add to.
+ * @param[in] ly_mod Module with the imports.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lydmods_add_imports(struct lyd_node *sr_mod, const struct lys_module *ly_mod)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lysp_submodule *lysp_submod;
+    LY_ARRAY_COUNT_TYPE i, j;
+
+    LY_ARRAY_FOR(ly_mod->parsed->imports, i) {
+        if ((err_info = sr_lydmods_add_import(sr_mod, ly_mod->parsed->imports[i].module->name))) {
+            return err_info;
+        }
+    }
+
+    LY_ARRAY_FOR(ly_mod->parsed->includes, i) {
+        lysp_submod = ly_mod->parsed->includes[i].submodule;
+        LY_ARRAY_FOR(lysp_submod->imports, j) {
+            if ((err_info = sr_lydmods_add_import(sr_mod, lysp_submod->imports[j].module->name))) {
+                return err_info;
+            }
+        }
+    }
+
+    return NULL;
+}
+
 /**
  * @brief Free all module dependency containers from SR internal module data.
  *
@@ -809,7 +871,8 @@ sr_lydmods_del_deps_all(struct lyd_node *sr_mods)
     uint32_t i;
 
     /* find all the containers */
-    if (lyd_find_xpath(sr_mods, "module/deps | module/rpcs | module/notifications | module/inverse-deps", &set)) {
+    if (lyd_find_xpath(sr_mods, "module/deps | module/rpcs | module/notifications | module/inverse-deps | module/imports",
+            &set)) {
         sr_errinfo_new_ly(&err_info, LYD_CTX(sr_mods), NULL);
         goto cleanup;
     }
@@ -825,7 +888,8 @@ cleanup:
 }
 
 /**
- * @brief Rebuild all dependencies (with inverse) and RPCs/notifications with dependencies in SR internal module data.
+ * @brief Rebuild all dependencies (with inverse), imports, and RPCs/notifications with dependencies in SR internal
+ * module data.
  *
  * @param[in] ly_ctx Context with all the modules and in the same state as described in @p sr_mods.
  * @param[in,out] sr_mods SR internal module data to add to.
@@ -872,6 +936,11 @@ sr_lydmods_add_deps_all(const struct ly_ctx *ly_ctx, struct lyd_node *sr_mods)
             goto cleanup;
         }
 
+        /* add imports */
+        if ((err_info = sr_lydmods_add_imports(sr_mod, ly_mod))) {
+            goto cleanup;
+        }
+
         /* add inverse data deps */
         SR_CHECK_LY_GOTO(lyd_find_xpath(sr_mod, "deps/*/target-module", &set), LYD_CTX(sr_mods), err_info, cleanup);
 
@@ -901,16 +970,220 @@ cleanup:
 }
 
 /**
- * @brief Store (print) sysrepo module data.
+ * @brief Header of the LYB cache file of sysrepo module data, followed by the LYB data.
+ */
+typedef struct {
+    uint64_t json_size;         /**< Size of the JSON plugin file the cache was created for. */
+    int64_t json_mtime_sec;     /**< Modification time (seconds) of the JSON plugin file. */
+    int64_t json_mtime_nsec;    /**< Modification time (nanoseconds) of the JSON plugin file. */
+    uint32_t hash;              /**< Hash of the (validated) data content. */
+    uint32_t data_len;          /**< Length of the LYB data stored after this structure. */
+} sr_lydmods_lyb_hdr_t;
+
+/**
+ * @brief Get the hash of sysrepo module data content, independent of any node flags.
  *
- * @param[in,out] sr_mods Data to store, are validated so could (in theory) be modified.
+ * @param[in] sr_mods Sysrepo module data.
+ * @param[out] hash Content hash.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_lydmods_print(struct lyd_node **sr_mods)
+sr_lydmods_hash(const struct lyd_node *sr_mods, uint32_t *hash)
+{
+    sr_error_info_t *err_info = NULL;
+    char *str = NULL;
+
+    if (lyd_print_mem(&str, sr_mods, LYD_JSON, LYD_PRINT_WITHSIBLINGS | LYD_PRINT_SHRINK | LYD_PRINT_WD_IMPL_TAG)) {
+        sr_errinfo_new_ly(&err_info, LYD_CTX(sr_mods), NULL);
+        return err_info;
+    }
+
+    *hash = sr_str_hash(str ? str : "", 0);
+    free(str);
+    return NULL;
+}
+
+/**
+ * @brief Get paths of the JSON plugin file and of the LYB cache file of sysrepo module data.
+ *
+ * @param[in] ly_mod Sysrepo module.
+ * @param[out] json_path JSON plugin file path.
+ * @param[out] lyb_path LYB cache file path.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lydmods_lyb_path(const struct lys_module *ly_mod, char **json_path, char **lyb_path)
+{
+    sr_error_info_t *err_info = NULL;
+
+    *json_path = NULL;
+    *lyb_path = NULL;
+
+    if (srpjson_get_path(NULL, ly_mod->name, SR_DS_STARTUP, json_path)) {
+        SR_ERRINFO_MEM(&err_info);
+        return err_info;
+    }
+    if (asprintf(lyb_path, "%s%s", *json_path, SR_LYDMODS_LYB_SUFFIX) == -1) {
+        *lyb_path = NULL;
+        free(*json_path);
+        *json_path = NULL;
+        SR_ERRINFO_MEM(&err_info);
+        return err_info;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Read the LYB cache file of sysrepo module data, if still valid for the JSON plugin file.
+ *
+ * @param[in] ly_mod Sysrepo module.
+ * @param[out] hdr Read header of a valid cache.
+ * @param[out] lyb Optional read LYB data of a valid cache.
+ * @return 1 if a valid cache was read, 0 otherwise.
+ */
+static int
+sr_lydmods_lyb_read(const struct lys_module *ly_mod, sr_lydmods_lyb_hdr_t *hdr, char **lyb)
+{
+    char *json_path = NULL, *lyb_path = NULL, *data = NULL;
+    struct stat st;
+    int fd = -1, valid = 0;
+    sr_error_info_t *err_info;
+
+    if ((err_info = sr_lydmods_lyb_path(ly_mod, &json_path, &lyb_path))) {
+        sr_errinfo_free(&err_info);
+        goto cleanup;
+    }
+
+    /* the cache is valid only for the current JSON file */
+    if (stat(json_path, &st)) {
+        goto cleanup;
+    }
+    if ((fd = sr_open(lyb_path, O_RDONLY, 0)) == -1) {
+        goto cleanup;
+    }
+    if (read(fd, hdr, sizeof *hdr) != sizeof *hdr) {
+        goto cleanup;
+    }
+    if ((hdr->json_size != (uint64_t)st.st_size) || (hdr->json_mtime_sec != (int64_t)st.st_mtim.tv_sec) ||
+            (hdr->json_mtime_nsec != (int64_t)st.st_mtim.tv_nsec) || !hdr->data_len) {
+        goto cleanup;
+    }
+
+    if (lyb) {
+        if (!(data = malloc(hdr->data_len))) {
+            goto cleanup;
+        }
+        if (read(fd, data, hdr->data_len) != (ssize_t)hdr->data_len) {
+            goto cleanup;
+        }
+        *lyb = data;
+        data = NULL;
+    }
+    valid = 1;
+
+cleanup:
+    if (fd > -1) {
+        close(fd);
+    }
+    free(data);
+    free(json_path);
+    free(lyb_path);
+    return valid;
+}
+
+/**
+ * @brief Store the LYB cache file of sysrepo module data. Failure is not fatal, the cache is only
+ * not going to be used.
+ *
+ * @param[in] sr_mods Stored (validated) sysrepo module data.
+ * @param[in] hash Content hash of @p sr_mods.
+ */
+static void
+sr_lydmods_lyb_store(const struct lyd_node *sr_mods, uint32_t hash)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_lydmods_lyb_hdr_t hdr;
+    char *json_path = NULL, *lyb_path = NULL, *tmp_path = NULL, *lyb = NULL;
+    struct stat st;
+    size_t len = 0;
+    int fd = -1;
+
+    if ((err_info = sr_lydmods_lyb_path(sr_mods->schema->module, &json_path, &lyb_path))) {
+        goto cleanup;
+    }
+    if (asprintf(&tmp_path, "%s%s", lyb_path, SRPJSON_FILE_TMP_SUFFIX) == -1) {
+        tmp_path = NULL;
+        SR_ERRINFO_MEM(&err_info);
+        goto cleanup;
+    }
+
+    /* print the data */
+    if (lyd_print_mem(&lyb, sr_mods, LYD_LYB, LYD_PRINT_WITHSIBLINGS)) {
+        sr_errinfo_new_ly(&err_info, LYD_CTX(sr_mods), NULL);
+        goto cleanup;
+    }
+    len = lyd_lyb_data_length(lyb);
+
+    /* bind the cache to the current JSON file */
+    if (stat(json_path, &st)) {
+        SR_ERRINFO_SYSERRNO(&err_info, "stat");
+        goto cleanup;
+    }
+    memset(&hdr, 0, sizeof hdr);
+    hdr.json_size = st.st_size;
+    hdr.json_mtime_sec = st.st_mtim.tv_sec;
+    hdr.json_mtime_nsec = st.st_mtim.tv_nsec;
+    hdr.hash = hash;
+    hdr.data_len = len;
+
+    /* write into a temporary file and rename it so that no incomplete cache is ever read */
+    if ((fd = sr_open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, SR_INTMOD_MAIN_FILE_PERM)) == -1) {
+        sr_errinfo_new(&err_info, SR_ERR_SYS, "Failed to open \"%s\" (%s).", tmp_path, strerror(errno));
+        goto cleanup;
+    }
+    if ((write(fd, &hdr, sizeof hdr) != sizeof hdr) || (write(fd, lyb, len) != (ssize_t)len)) {
+        SR_ERRINFO_SYSERRNO(&err_info, "write");
+        goto cleanup;
+    }
+    close(fd);
+    fd = -1;
+    if (rename(tmp_path, lyb_path)) {
+        SR_ERRINFO_SYSERRNO(&err_info, "rename");
+        goto cleanup;
+    }
+
+cleanup:
+    if (fd > -1) {
+        close(fd);
+    }
+    if (err_info) {
+        if (tmp_path) {
+            unlink(tmp_path);
+        }
+        sr_errinfo_free(&err_info);
+        SR_LOG_DBG("Failed to store \"sysrepo\" data LYB cache.");
+    }
+    free(json_path);
+    free(lyb_path);
+    free(tmp_path);
+    free(lyb);
+}
+
+/**
+ * @brief Store sysrepo module data, optionally validating them first.
+ *
+ * @param[in,out] sr_mods Data to store, if validated could (in theory) be modified.
+ * @param[in] validate Whether to validate the data, they are expected to be valid otherwise.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lydmods_store_(struct lyd_node **sr_mods, int validate)
 {
     sr_error_info_t *err_info = NULL;
     const struct lys_module *sr_ly_mod;
+    sr_lydmods_lyb_hdr_t hdr;
+    uint32_t hash;
     int rc;
 
     assert(sr_mods && *sr_mods && !strcmp((*sr_mods)->schema->module->name, "sysrepo"));
@@ -918,11 +1191,26 @@ sr_lydmods_print(struct lyd_node **sr_mods)
     /* get the module */
     sr_ly_mod = (*sr_mods)->schema->module;
 
-    /* validate */
-    if (lyd_validate_module(sr_mods, sr_ly_mod, 0, NULL)) {
-        sr_errinfo_new_ly(&err_info, sr_ly_mod->ctx, NULL);
+    /* the same content as the stored one was already validated, nothing to do */
+    if ((err_info = sr_lydmods_hash(*sr_mods, &hash))) {
         return err_info;
     }
+    if (sr_lydmods_lyb_read(sr_ly_mod, &hdr, NULL) && (hdr.hash == hash)) {
+        return NULL;
+    }
+
+    if (validate) {
+        /* validate */
+        if (lyd_validate_module(sr_mods, sr_ly_mod, 0, NULL)) {
+            sr_errinfo_new_ly(&err_info, sr_ly_mod->ctx, NULL);
+            return err_info;
+        }
+
+        /* validation may have added default nodes */
+        if ((err_info = sr_lydmods_hash(*sr_mods, &hash))) {
+            return err_info;
+        }
+    }
 
     /* store the data using the internal JSON plugin */
     if ((rc = srpds_json.store_cb(sr_ly_mod, SR_DS_STARTUP, NULL, *sr_mods))) {
@@ -930,9 +1218,30 @@ sr_lydmods_print(struct lyd_node **sr_mods)
         return err_info;
     }
 
+    /* update the LYB cache */
+    sr_lydmods_lyb_store(*sr_mods, hash);
+
     return NULL;
 }
 
+/**
+ * @brief Store (print) sysrepo module data.
+ *
+ * @param[in,out] sr_mods Data to store, are validated so could (in theory) be modified.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lydmods_print(struct lyd_node **sr_mods)
+{
+    return sr_lydmods_store_(sr_mods, 1);
+}
+
+sr_error_info_t *
+sr_lydmods_store(struct lyd_node **sr_mods)
+{
+    return sr_lydmods_store_(sr_mods, 0);
+}
+
 /**
  * @brief Create default sysrepo module data. All libyang internal implemented modules
  * are installed into sysrepo. Sysrepo internal modules ietf-netconf, ietf-netconf-with-defaults,
@@ -1050,7 +1359,9 @@ sr_lydmods_parse(const struct ly_ctx *ly_ctx, int *initialized, struct lyd_node
     sr_error_info_t *err_info = NULL;
     struct lyd_node *sr_mods = NULL;
     const struct lys_module *ly_mod;
-    char *path = NULL;
+    sr_lydmods_lyb_hdr_t hdr;
+    char *path = NULL, *lyb = NULL;
+    uint32_t hash;
     int rc;
 
     assert(ly_ctx && sr_mods_p);
@@ -1068,12 +1379,30 @@ sr_lydmods_parse(const struct ly_ctx *ly_ctx, int *initialized, struct lyd_node
         SR_ERRINFO_MEM(&err_info);
         goto cleanup;
     }
+    if ((rc = srpjson_file_format_check(NULL, path))) {
+        sr_errinfo_new(&err_info, rc, "Stored \"sysrepo\" data are in a different format than JSON_DS_FORMAT.");
+        goto cleanup;
+    }
     if (srpjson_file_exists(NULL, path)) {
+        /* try to use the LYB cache of the stored (validated) data first */
+        if (sr_lydmods_lyb_read(ly_mod, &hdr, &lyb) && !lyd_parse_data_mem(ly_ctx, lyb, LYD_LYB,
+                LYD_PARSE_ONLY | LYD_PARSE_STRICT | LYD_PARSE_ORDERED, 0, &sr_mods)) {
+            goto cleanup;
+        }
+        lyd_free_all(sr_mods);
+        sr_mods = NULL;
+
         /* load the data using the internal JSON plugin */
         if ((rc = srpds_json.load_cb(ly_mod, SR_DS_STARTUP, NULL, 0, &sr_mods))) {
             sr_errinfo_new(&err_info, rc, "Loading \"sysrepo\" data failed.");
             goto cleanup;
         }
+
+        /* create the LYB cache for the next time */
+        if ((err_info = sr_lydmods_hash(sr_mods, &hash))) {
+            goto cleanup;
+        }
+        sr_lydmods_lyb_store(sr_mods, hash);
     } else if (initialized) {
         /* install the "sysrepo" module */
         if ((rc = srpds_json.install_cb(ly_mod, SR_DS_STARTUP, NULL, strlen(SR_GROUP) ? SR_GROUP : NULL,
@@ -1102,28 +1431,29 @@ cleanup:
         *sr_mods_p = sr_mods;
     }
     free(path);
+    free(lyb);
     return err_info;
 }
 
-sr_error_info_t *
-sr_lydmods_change_add_modules(const struct ly_ctx *ly_ctx, sr_int_install_mod_t **new_mods, uint32_t *new_mod_count,
-        struct lyd_node **sr_mods)
+/**
+ * @brief Add new modules with all their implemented dependencies into SR internal module data.
+ *
+ * @param[in,out] sr_mods SR internal module data.
+ * @param[in,out] new_mods Array of new modules, implemented dependencies are added.
+ * @param[in,out] new_mod_count Count of @p new_mods.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lydmods_add_modules(struct lyd_node *sr_mods, sr_int_install_mod_t **new_mods, uint32_t *new_mod_count)
 {
     sr_error_info_t *err_info = NULL;
     uint32_t i, orig_mod_count = *new_mod_count;
 
-    *sr_mods = NULL;
-
-    /* parse current module information */
-    if ((err_info = sr_lydmods_parse(ly_ctx, NULL, sr_mods))) {
-        goto cleanup;
-    }
-
     /* add new modules with all implemented dependencies to SR data, the latter are added to new_mods as well */
     for (i = 0; i < orig_mod_count; ++i) {
-        if ((err_info = sr_lydmods_add_module_with_imps(*sr_mods, (*new_mods)[i].ly_mod, (*new_mods)[i].module_ds,
+        if ((err_info = sr_lydmods_add_module_with_imps(sr_mods, (*new_mods)[i].ly_mod, (*new_mods)[i].module_ds,
                 (*new_mods)[i].owner, (*new_mods)[i].group, (*new_mods)[i].perm, new_mods, new_mod_count))) {
-            goto cleanup;
+            return err_info;
         }
         SR_LOG_INF("Module \"%s\" was installed.", (*new_mods)[i].ly_mod->name);
     }
@@ -1132,32 +1462,19 @@ sr_lydmods_change_add_modules(const struct ly_ctx *ly_ctx, sr_int_install_mod_t
         SR_LOG_INF("Dependency module \"%s\" was installed.", (*new_mods)[i].ly_mod->name);
     }
 
-    /* delete all dependencies */
-    if ((err_info = sr_lydmods_del_deps_all(*sr_mods))) {
-        goto cleanup;
-    }
-
-    /* add new dependencies for all the modules */
-    if ((err_info = sr_lydmods_add_deps_all(ly_ctx, *sr_mods))) {
-        goto cleanup;
-    }
-
-    /* store updated SR internal module data */
-    if ((err_info = sr_lydmods_print(sr_mods))) {
-        goto cleanup;
-    }
-
-cleanup:
-    if (err_info) {
-        lyd_free_all(*sr_mods);
-        *sr_mods = NULL;
-    }
-    return err_info;
+    return NULL;
 }
 
-sr_error_info_t *
-sr_lydmods_change_del_module(const struct ly_ctx *ly_ctx, const struct ly_ctx *new_ctx, const struct ly_set *mod_set,
-        struct lyd_node **sr_del_mods, struct lyd_node **sr_mods)
+/**
+ * @brief Move removed modules from SR internal module data into deleted module data.
+ *
+ * @param[in,out] sr_mods SR internal module data.
+ * @param[in] mod_set Set of all the removed modules.
+ * @param[in,out] sr_del_mods Deleted modules from @p sr_mods, in the order of @p mod_set.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lydmods_del_modules(struct lyd_node *sr_mods, const struct ly_set *mod_set, struct lyd_node **sr_del_mods)
 {
     sr_error_info_t *err_info = NULL;
     struct lys_module *ly_mod;
@@ -1165,14 +1482,6 @@ sr_lydmods_change_del_module(const struct ly_ctx *ly_ctx, const struct ly_ctx *n
     char *path = NULL;
     uint32_t i;
 
-    *sr_del_mods = NULL;
-    *sr_mods = NULL;
-
-    /* parse current module information */
-    if ((err_info = sr_lydmods_parse(ly_ctx, NULL, sr_mods))) {
-        goto cleanup;
-    }
-
     for (i = 0; i < mod_set->count; ++i) {
         ly_mod = mod_set->objs[i];
 
@@ -1181,12 +1490,12 @@ sr_lydmods_change_del_module(const struct ly_ctx *ly_ctx, const struct ly_ctx *n
             SR_ERRINFO_MEM(&err_info);
             goto cleanup;
         }
-        SR_CHECK_INT_GOTO(lyd_find_path(*sr_mods, path, 0, &sr_mod), err_info, cleanup);
+        SR_CHECK_INT_GOTO(lyd_find_path(sr_mods, path, 0, &sr_mod), err_info, cleanup);
         free(path);
         path = NULL;
 
         /* relink it */
-        if (!*sr_del_mods && lyd_dup_single(*sr_mods, NULL, 0, sr_del_mods)) {
+        if (!*sr_del_mods && lyd_dup_single(sr_mods, NULL, 0, sr_del_mods)) {
             sr_errinfo_new_ly(&err_info, LYD_CTX(sr_mod), NULL);
             goto cleanup;
         }
@@ -1198,48 +1507,27 @@ sr_lydmods_change_del_module(const struct ly_ctx *ly_ctx, const struct ly_ctx *n
         SR_LOG_INF("Module \"%s\" removed.", ly_mod->name);
     }
 
-    /* delete all dependencies */
-    if ((err_info = sr_lydmods_del_deps_all(*sr_mods))) {
-        goto cleanup;
-    }
-
-    /* add new dependencies for all the modules */
-    if ((err_info = sr_lydmods_add_deps_all(new_ctx, *sr_mods))) {
-        goto cleanup;
-    }
-
-    /* store updated SR internal module data */
-    if ((err_info = sr_lydmods_print(sr_mods))) {
-        goto cleanup;
-    }
-
 cleanup:
     free(path);
-    if (err_info) {
-        lyd_free_all(*sr_del_mods);
-        *sr_del_mods = NULL;
-        lyd_free_all(*sr_mods);
-        *sr_mods = NULL;
-    }
     return err_info;
 }
 
-sr_error_info_t *
-sr_lydmods_change_upd_modules(const struct ly_ctx *ly_ctx, const struct ly_set *upd_mod_set, struct lyd_node **sr_mods)
+/**
+ * @brief Set new revisions of updated modules in SR internal module data.
+ *
+ * @param[in,out] sr_mods SR internal module data.
+ * @param[in] upd_mod_set Set with all the new updated modules.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lydmods_upd_modules(struct lyd_node *sr_mods, const struct ly_set *upd_mod_set)
 {
     sr_error_info_t *err_info = NULL;
-    const struct lys_module *upd_mod = NULL;
+    const struct lys_module *upd_mod;
     struct lyd_node *sr_mod, *sr_rev;
     char *path = NULL;
     uint32_t i;
 
-    *sr_mods = NULL;
-
-    /* parse current module information */
-    if ((err_info = sr_lydmods_parse(ly_ctx, NULL, sr_mods))) {
-        goto cleanup;
-    }
-
     for (i = 0; i < upd_mod_set->count; ++i) {
         upd_mod = upd_mod_set->objs[i];
 
@@ -1248,7 +1536,7 @@ sr_lydmods_change_upd_modules(const struct ly_ctx *ly_ctx, const struct ly_set *
             SR_ERRINFO_MEM(&err_info);
             goto cleanup;
         }
-        SR_CHECK_INT_GOTO(lyd_find_path(*sr_mods, path, 0, &sr_mod), err_info, cleanup);
+        SR_CHECK_INT_GOTO(lyd_find_path(sr_mods, path, 0, &sr_mod), err_info, cleanup);
         free(path);
         path = NULL;
 
@@ -1259,30 +1547,194 @@ sr_lydmods_change_upd_modules(const struct ly_ctx *ly_ctx, const struct ly_set *
         /* add new revision */
         assert(upd_mod->revision);
         if (lyd_new_term(sr_mod, NULL, "revision", upd_mod->revision, 0, NULL)) {
-            sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+            sr_errinfo_new_ly(&err_info, LYD_CTX(sr_mods), NULL);
             goto cleanup;
         }
 
         SR_LOG_INF("Module \"%s\" updated.", upd_mod->name);
     }
 
+cleanup:
+    free(path);
+    return err_info;
+}
+
+/**
+ * @brief Enable or disable a feature of a module in SR internal module data.
+ *
+ * @param[in,out] sr_mods SR internal module data.
+ * @param[in] mod_name Module name.
+ * @param[in] feat_name Feature name.
+ * @param[in] enable Whether the feature was enabled or disabled.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lydmods_chng_feature(struct lyd_node *sr_mods, const char *mod_name, const char *feat_name, int enable)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *sr_mod, *node;
+    char *path = NULL;
+
+    /* find this module */
+    if (asprintf(&path, "module[name='%s']", mod_name) == -1) {
+        SR_ERRINFO_MEM(&err_info);
+        goto cleanup;
+    }
+    if (lyd_find_path(sr_mods, path, 0, &sr_mod)) {
+        sr_errinfo_new_ly(&err_info, LYD_CTX(sr_mods), NULL);
+        goto cleanup;
+    }
+
+    if (enable) {
+        /* add enabled feature */
+        if (lyd_new_term(sr_mod, NULL, "enabled-feature", feat_name, 0, NULL)) {
+            sr_errinfo_new_ly(&err_info, LYD_CTX(sr_mods), NULL);
+            goto cleanup;
+        }
+
+        SR_LOG_INF("Module \"%s\" feature \"%s\" enabled.", mod_name, feat_name);
+    } else {
+        /* find and free the enabled feature */
+        free(path);
+        if (asprintf(&path, "enabled-feature[.='%s']", feat_name) == -1) {
+            SR_ERRINFO_MEM(&err_info);
+            goto cleanup;
+        }
+        if (lyd_find_path(sr_mod, path, 0, &node)) {
+            sr_errinfo_new_ly(&err_info, LYD_CTX(sr_mods), NULL);
+            goto cleanup;
+        }
+        lyd_free_tree(node);
+
+        SR_LOG_INF("Module \"%s\" feature \"%s\" disabled.", mod_name, feat_name);
+    }
+
+cleanup:
+    free(path);
+    return err_info;
+}
+
+/**
+ * @brief Finish a change of SR internal module data by regenerating all the dependencies and validating them.
+ * The data are stored separately by ::sr_lydmods_store() so that it can be done only once the context is locked
+ * for writing.
+ *
+ * @param[in] new_ctx Context with the changes applied.
+ * @param[in,out] sr_mods SR internal module data.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_lydmods_change_finish(const struct ly_ctx *new_ctx, struct lyd_node **sr_mods)
+{
+    sr_error_info_t *err_info = NULL;
+
     /* delete all dependencies */
     if ((err_info = sr_lydmods_del_deps_all(*sr_mods))) {
-        goto cleanup;
+        return err_info;
     }
 
     /* add new dependencies for all the modules */
-    if ((err_info = sr_lydmods_add_deps_all(upd_mod->ctx, *sr_mods))) {
+    if ((err_info = sr_lydmods_add_deps_all(new_ctx, *sr_mods))) {
+        return err_info;
+    }
+
+    /* validate updated SR internal module data */
+    if (lyd_validate_module(sr_mods, (*sr_mods)->schema->module, 0, NULL)) {
+        sr_errinfo_new_ly(&err_info, new_ctx, NULL);
+        return err_info;
+    }
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_lydmods_change_add_modules(const struct ly_ctx *ly_ctx, sr_int_install_mod_t **new_mods, uint32_t *new_mod_count,
+        struct lyd_node **sr_mods)
+{
+    sr_error_info_t *err_info = NULL;
+
+    *sr_mods = NULL;
+
+    /* parse current module information */
+    if ((err_info = sr_lydmods_parse(ly_ctx, NULL, sr_mods))) {
         goto cleanup;
     }
 
-    /* store updated SR internal module data */
-    if ((err_info = sr_lydmods_print(sr_mods))) {
+    /* add the modules */
+    if ((err_info = sr_lydmods_add_modules(*sr_mods, new_mods, new_mod_count))) {
+        goto cleanup;
+    }
+
+    /* update dependencies and store */
+    if ((err_info = sr_lydmods_change_finish(ly_ctx, sr_mods))) {
+        goto cleanup;
+    }
+
+cleanup:
+    if (err_info) {
+        lyd_free_all(*sr_mods);
+        *sr_mods = NULL;
+    }
+    return err_info;
+}
+
+sr_error_info_t *
+sr_lydmods_change_del_module(const struct ly_ctx *ly_ctx, const struct ly_ctx *new_ctx, const struct ly_set *mod_set,
+        struct lyd_node **sr_del_mods, struct lyd_node **sr_mods)
+{
+    sr_error_info_t *err_info = NULL;
+
+    *sr_del_mods = NULL;
+    *sr_mods = NULL;
+
+    /* parse current module information */
+    if ((err_info = sr_lydmods_parse(ly_ctx, NULL, sr_mods))) {
+        goto cleanup;
+    }
+
+    /* remove the modules */
+    if ((err_info = sr_lydmods_del_modules(*sr_mods, mod_set, sr_del_mods))) {
+        goto cleanup;
+    }
+
+    /* update dependencies and store */
+    if ((err_info = sr_lydmods_change_finish(new_ctx, sr_mods))) {
+        goto cleanup;
+    }
+
+cleanup:
+    if (err_info) {
+        lyd_free_all(*sr_del_mods);
+        *sr_del_mods = NULL;
+        lyd_free_all(*sr_mods);
+        *sr_mods = NULL;
+    }
+    return err_info;
+}
+
+sr_error_info_t *
+sr_lydmods_change_upd_modules(const struct ly_ctx *ly_ctx, const struct ly_set *upd_mod_set, struct lyd_node **sr_mods)
+{
+    sr_error_info_t *err_info = NULL;
+
+    *sr_mods = NULL;
+
+    /* parse current module information */
+    if ((err_info = sr_lydmods_parse(ly_ctx, NULL, sr_mods))) {
+        goto cleanup;
+    }
+
+    /* update the modules */
+    if ((err_info = sr_lydmods_upd_modules(*sr_mods, upd_mod_set))) {
+        goto cleanup;
+    }
+
+    /* update dependencies and store */
+    if ((err_info = sr_lydmods_change_finish(((struct lys_module *)upd_mod_set->objs[0])->ctx, sr_mods))) {
         goto cleanup;
     }
 
 cleanup:
-    free(path);
     if (err_info) {
         lyd_free_all(*sr_mods);
         *sr_mods = NULL;
@@ -1295,8 +1747,6 @@ sr_lydmods_change_chng_feature(const struct ly_ctx *ly_ctx, const struct lys_mod
         const struct lys_module *new_mod, const char *feat_name, int enable, struct lyd_node **sr_mods)
 {
     sr_error_info_t *err_info = NULL;
-    struct lyd_node *sr_mod, *node;
-    char *path = NULL;
 
     *sr_mods = NULL;
 
@@ -1305,58 +1755,66 @@ sr_lydmods_change_chng_feature(const struct ly_ctx *ly_ctx, const struct lys_mod
         goto cleanup;
     }
 
-    /* find this module */
-    if (asprintf(&path, "module[name='%s']", old_mod->name) == -1) {
-        SR_ERRINFO_MEM(&err_info);
+    /* change the feature */
+    if ((err_info = sr_lydmods_chng_feature(*sr_mods, old_mod->name, feat_name, enable))) {
         goto cleanup;
     }
-    if (lyd_find_path(*sr_mods, path, 0, &sr_mod)) {
-        sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+
+    /* update dependencies and store */
+    if ((err_info = sr_lydmods_change_finish(new_mod->ctx, sr_mods))) {
         goto cleanup;
     }
 
-    if (enable) {
-        /* add enabled feature */
-        if (lyd_new_term(sr_mod, NULL, "enabled-feature", feat_name, 0, NULL)) {
-            sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
-            goto cleanup;
-        }
+cleanup:
+    if (err_info) {
+        lyd_free_all(*sr_mods);
+        *sr_mods = NULL;
+    }
+    return err_info;
+}
 
-        SR_LOG_INF("Module \"%s\" feature \"%s\" enabled.", old_mod->name, feat_name);
-    } else {
-        /* find and free the enabled feature */
-        free(path);
-        if (asprintf(&path, "enabled-feature[.='%s']", feat_name) == -1) {
-            SR_ERRINFO_MEM(&err_info);
-            goto cleanup;
-        }
-        if (lyd_find_path(sr_mod, path, 0, &node)) {
-            sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
-            goto cleanup;
-        }
-        lyd_free_tree(node);
+sr_error_info_t *
+sr_lydmods_change_modules(const struct ly_ctx *new_ctx, sr_int_install_mod_t **new_mods, uint32_t *new_mod_count,
+        const struct ly_set *del_mod_set, const struct ly_set *upd_mod_set, const sr_feature_change_t *feat_changes,
+        uint32_t feat_change_count, struct lyd_node **sr_del_mods, struct lyd_node **sr_mods)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
 
-        SR_LOG_INF("Module \"%s\" feature \"%s\" disabled.", old_mod->name, feat_name);
-    }
+    *sr_del_mods = NULL;
+    *sr_mods = NULL;
 
-    /* delete all dependencies */
-    if ((err_info = sr_lydmods_del_deps_all(*sr_mods))) {
+    /* parse current module information */
+    if ((err_info = sr_lydmods_parse(new_ctx, NULL, sr_mods))) {
         goto cleanup;
     }
 
-    /* add new dependencies for all the modules */
-    if ((err_info = sr_lydmods_add_deps_all(new_mod->ctx, *sr_mods))) {
+    /* apply all the changes */
+    if ((err_info = sr_lydmods_del_modules(*sr_mods, del_mod_set, sr_del_mods))) {
+        goto cleanup;
+    }
+    if ((err_info = sr_lydmods_upd_modules(*sr_mods, upd_mod_set))) {
+        goto cleanup;
+    }
+    for (i = 0; i < feat_change_count; ++i) {
+        if ((err_info = sr_lydmods_chng_feature(*sr_mods, feat_changes[i].module_name, feat_changes[i].feature_name,
+                feat_changes[i].enable))) {
+            goto cleanup;
+        }
+    }
+    if ((err_info = sr_lydmods_add_modules(*sr_mods, new_mods, new_mod_count))) {
         goto cleanup;
     }
 
-    /* store updated SR internal module data */
-    if ((err_info = sr_lydmods_print(sr_mods))) {
+    /* update dependencies only once and store */
+    if ((err_info = sr_lydmods_change_finish(new_ctx, sr_mods))) {
         goto cleanup;
     }
 
 cleanup:
-    free(path);
     if (err_info) {
+        lyd_free_all(*sr_del_mods);
+        *sr_del_mods = NULL;
         lyd_free_all(*sr_mods);
         *sr_mods = NULL;
     }
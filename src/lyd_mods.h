@@ -35,6 +35,15 @@
  */
 sr_error_info_t *sr_lydmods_parse(const struct ly_ctx *ly_ctx, int *initialized, struct lyd_node **sr_mods_p);
 
+/**
+ * @brief Store validated internal module data changed by one of the sr_lydmods_change_*() functions. Does nothing
+ * if the stored data are the same.
+ *
+ * @param[in] sr_mods Sysrepo module data tree to store.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_lydmods_store(struct lyd_node **sr_mods);
+
 /**
  * @brief Add modules to SR internal module data.
  *
@@ -85,6 +94,25 @@ sr_error_info_t *sr_lydmods_change_upd_modules(const struct ly_ctx *ly_ctx, cons
 sr_error_info_t *sr_lydmods_change_chng_feature(const struct ly_ctx *ly_ctx, const struct lys_module *old_mod,
         const struct lys_module *new_mod, const char *feat_name, int enable, struct lyd_node **sr_mods);
 
+/**
+ * @brief Apply a whole set of module changes to SR internal module data at once.
+ *
+ * @param[in] new_ctx Context with all the changes applied.
+ * @param[in,out] new_mods Array of new modules to add, implemented dependencies are added.
+ * @param[in,out] new_mod_count Count of @p new_mods.
+ * @param[in] del_mod_set Set of all the removed modules.
+ * @param[in] upd_mod_set Set with all the new updated modules.
+ * @param[in] feat_changes Array of feature changes.
+ * @param[in] feat_change_count Count of @p feat_changes.
+ * @param[out] sr_del_mods Deleted modules from @p sr_mods.
+ * @param[out] sr_mods SR internal module data.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_lydmods_change_modules(const struct ly_ctx *new_ctx, sr_int_install_mod_t **new_mods,
+        uint32_t *new_mod_count, const struct ly_set *del_mod_set, const struct ly_set *upd_mod_set,
+        const sr_feature_change_t *feat_changes, uint32_t feat_change_count, struct lyd_node **sr_del_mods,
+        struct lyd_node **sr_mods);
+
 /**
  * @brief Change replay support of a module in SR internal module data.
  *
@@ -22,6 +22,7 @@
 #include <ctype.h>
 #include <fcntl.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdarg.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -81,6 +82,12 @@ sr_modinfo_add(const struct lys_module *ly_mod, const char *xpath, int dup_xpath
         mod->ly_mod = ly_mod;
         mod->state |= MOD_INFO_NEW;
     } else if (!mod->xpath_count) {
+        if (mod->state & MOD_INFO_DATA_LAZY) {
+            /* lazily loaded module is a dependency of another module, its full data tree is needed */
+            mod->state &= ~MOD_INFO_DATA_LAZY;
+            mod->state |= MOD_INFO_NEW;
+        }
+
         /* mod is present with no xpaths (full data tree), nothing to add */
         return NULL;
     }
@@ -177,11 +184,27 @@ sr_modinfo_collect_xpath(const struct ly_ctx *ly_ctx, const char *xpath, sr_data
         int dup_xpath, struct sr_mod_info_s *mod_info)
 {
     sr_error_info_t *err_info = NULL;
-    const struct lys_module *prev_ly_mod, *ly_mod;
+    const struct lys_module *prev_ly_mod, *ly_mod, **ly_mods = NULL;
     const struct lysc_node *snode;
     struct ly_set *set = NULL;
     struct ly_ctx *sm_ctx = NULL;
-    uint32_t i;
+    uint32_t i, ly_mod_count = 0;
+    int use_cache;
+    void *mem;
+
+    /* the cache can be used only for the connection context */
+    use_cache = (mod_info->conn && (ly_ctx == mod_info->conn->ly_ctx)) ? 1 : 0;
+
+    if (use_cache && sr_conn_xpath_mods_cache_get(mod_info->conn, xpath, ds, &ly_mods, &ly_mod_count)) {
+        /* add all the cached modules */
+        for (i = 0; i < ly_mod_count; ++i) {
+            if ((err_info = sr_modinfo_add(ly_mods[i], store_xpath ? xpath : NULL, dup_xpath, 0, mod_info))) {
+                break;
+            }
+        }
+        free(ly_mods);
+        return err_info;
+    }
 
     /* learn what nodes are needed for evaluation */
     if (lys_find_xpath_atoms(ly_ctx, NULL, xpath, LYS_FIND_NO_MATCH_ERROR | LYS_FIND_SCHEMAMOUNT, &set)) {
@@ -219,16 +242,35 @@ sr_modinfo_collect_xpath(const struct ly_ctx *ly_ctx, const char *xpath, sr_data
         if ((err_info = sr_modinfo_add(ly_mod, store_xpath ? xpath : NULL, dup_xpath, 0, mod_info))) {
             goto cleanup;
         }
+
+        if (use_cache) {
+            /* remember the module for the cache */
+            mem = realloc(ly_mods, (ly_mod_count + 1) * sizeof *ly_mods);
+            if (!mem) {
+                use_cache = 0;
+                continue;
+            }
+            ly_mods = mem;
+            ly_mods[ly_mod_count] = ly_mod;
+            ++ly_mod_count;
+        }
+    }
+
+    if (use_cache) {
+        /* cache the modules for the next time */
+        sr_conn_xpath_mods_cache_store(mod_info->conn, xpath, ds, ly_mods, ly_mod_count);
+        ly_mods = NULL;
     }
 
 cleanup:
+    free(ly_mods);
     ly_ctx_destroy(sm_ctx);
     ly_set_free(set, NULL);
     return err_info;
 }
 
 sr_error_info_t *
-sr_modinfo_collect_deps(struct sr_mod_info_s *mod_info)
+sr_modinfo_collect_deps(struct sr_mod_info_s *mod_info, int full_diff)
 {
     sr_error_info_t *err_info = NULL;
     struct sr_mod_info_mod_s *mod;
@@ -244,11 +286,18 @@ sr_modinfo_collect_deps(struct sr_mod_info_s *mod_info)
             }
         /* fallthrough */
         case MOD_INFO_INV_DEP:
+            if (mod->state & MOD_INFO_DATA_LAZY) {
+                /* the module data were not loaded yet, its dependencies are collected only when it is */
+                break;
+            }
+
             /* this module data will be validated */
             assert(mod->state & MOD_INFO_DATA);
+            /* the running data of the module were loaded under a lock, their version cannot change */
             if ((err_info = sr_shmmod_collect_deps(SR_CONN_MOD_SHM(mod_info->conn),
                     (sr_dep_t *)(mod_info->conn->mod_shm.addr + mod->shm_mod->deps), mod->shm_mod->dep_count,
-                    mod_info->data, mod_info))) {
+                    mod_info->data, full_diff ? mod->ly_mod : NULL, ATOMIC_LOAD_RELAXED(mod->shm_mod->run_data_ver),
+                    mod_info))) {
                 return err_info;
             }
             break;
@@ -465,6 +514,7 @@ sr_modinfo_edit_apply(struct sr_mod_info_s *mod_info, const struct lyd_node *edi
     const struct lys_module *ly_mod;
     struct sr_mod_info_mod_s *mod = NULL;
     const struct lyd_node *node;
+    struct timespec start;
     uint32_t *aux = NULL;
     int change;
 
@@ -487,6 +537,7 @@ sr_modinfo_edit_apply(struct sr_mod_info_s *mod_info, const struct lyd_node *edi
 
     while ((mod = sr_modinfo_next_mod(mod, mod_info, edit, &aux))) {
         assert(mod->state & MOD_INFO_REQ);
+        sr_timeouttime_get(&start, 0);
 
         if (mod_info->ds == SR_DS_OPERATIONAL) {
             /* merge relevant edit changes */
@@ -506,6 +557,11 @@ sr_modinfo_edit_apply(struct sr_mod_info_s *mod_info, const struct lyd_node *edi
             /* there is a diff for this module */
             mod->state |= MOD_INFO_CHANGED;
         }
+
+        if (create_diff) {
+            /* the changes are being applied, not only validated */
+            sr_modinfo_commit_stats_add(mod_info, mod, SR_COMMIT_PHASE_EDIT, &start);
+        }
     }
 
 cleanup:
@@ -550,6 +606,15 @@ sr_modinfo_replace(struct sr_mod_info_s *mod_info, struct lyd_node **src_data)
             dst_mod_data = sr_module_data_unlink(&mod_info->data, mod->ly_mod);
             src_mod_data = sr_module_data_unlink(src_data, mod->ly_mod);
 
+            if (!lyd_compare_siblings(dst_mod_data, src_mod_data, LYD_COMPARE_FULL_RECURSION | LYD_COMPARE_DEFAULTS)) {
+                /* identical data, no need to generate a diff, keep old data (for validation) */
+                if (dst_mod_data) {
+                    lyd_insert_sibling(mod_info->data, dst_mod_data, &mod_info->data);
+                }
+                lyd_free_all(src_mod_data);
+                continue;
+            }
+
             /* get diff on only this module's data */
             if (lyd_diff_siblings(dst_mod_data, src_mod_data, LYD_DIFF_DEFAULTS, &diff)) {
                 sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx, src_mod_data);
@@ -697,6 +762,52 @@ sr_xpath_oper_data_text_atoms_required(const char *request_atom, const char *sub
     return 1;
 }
 
+/**
+ * @brief Check whether operational data are required based on parsed request atoms and serialized subscription atoms.
+ *
+ * @param[in] req_atoms Request XPath text atoms, NULL if unknown.
+ * @param[in] sub_atoms Subscription XPath serialized text atoms, NULL if unknown.
+ * @return Whether the oper data are required or not.
+ */
+static int
+sr_xpath_oper_data_atoms_required(const sr_xp_atoms_t *req_atoms, const char *sub_atoms)
+{
+    const char *sub_atom;
+    uint32_t i, j;
+    int r, required, filtered;
+
+    if (!req_atoms || !sub_atoms) {
+        /* we do not know, say it is required */
+        return 1;
+    }
+
+    /* check whether any atoms match */
+    for (i = 0; i < req_atoms->union_count; ++i) {
+        required = 0;
+        filtered = 0;
+        for (j = 0; !filtered && (j < req_atoms->unions[i].atom_count); ++j) {
+            for (sub_atom = sub_atoms; sub_atom[0]; sub_atom += strlen(sub_atom) + 1) {
+                r = sr_xpath_oper_data_text_atoms_required(req_atoms->unions[i].atoms[j], sub_atom);
+                if (r == 1) {
+                    /* required but need to check all atoms */
+                    required = 1;
+                } else if (r == 2) {
+                    /* not required for the union */
+                    filtered = 1;
+                    break;
+                }
+            }
+        }
+
+        if (required && !filtered) {
+            /* required for a union */
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 /**
  * @brief Check whether operational data are required.
  *
@@ -709,9 +820,9 @@ static sr_error_info_t *
 sr_xpath_oper_data_required(const char *request_xpath, const char *sub_xpath, int *required)
 {
     sr_error_info_t *err_info = NULL;
-    sr_xp_atoms_t *req_atoms = NULL, *sub_atoms = NULL;
-    uint32_t i, j, k;
-    int r;
+    sr_xp_atoms_t *req_atoms = NULL;
+    char *sub_atoms = NULL;
+    size_t sub_atoms_len;
 
     assert(sub_xpath);
 
@@ -726,40 +837,73 @@ sr_xpath_oper_data_required(const char *request_xpath, const char *sub_xpath, in
     if ((err_info = sr_xpath_get_text_atoms(request_xpath, &req_atoms)) || !req_atoms) {
         goto cleanup;
     }
-    if ((err_info = sr_xpath_get_text_atoms(sub_xpath, &sub_atoms)) || !sub_atoms) {
+    if ((err_info = sr_xpath_get_sub_atoms(sub_xpath, &sub_atoms, &sub_atoms_len)) || !sub_atoms) {
         goto cleanup;
     }
-    assert(sub_atoms->union_count == 1);
 
-    /* check whether any atoms match */
-    *required = 0;
-    for (i = 0; i < req_atoms->union_count; ++i) {
-        for (j = 0; j < req_atoms->unions[i].atom_count; ++j) {
-            for (k = 0; k < sub_atoms->unions[0].atom_count; ++k) {
-                r = sr_xpath_oper_data_text_atoms_required(req_atoms->unions[i].atoms[j], sub_atoms->unions[0].atoms[k]);
-                if (r == 1) {
-                    /* required but need to check all atoms */
-                    *required = 1;
-                } else if (r == 2) {
-                    /* not required for the union */
-                    *required = 0;
-                    break;
-                }
+    *required = sr_xpath_oper_data_atoms_required(req_atoms, sub_atoms);
+
+cleanup:
+    sr_xpath_atoms_free(req_atoms);
+    free(sub_atoms);
+    return err_info;
+}
+
+/**
+ * @brief Prepare a stand-alone copy of the data parent of operational data, unless it would be filtered out.
+ *
+ * @param[in] mod Modinfo structure of the data.
+ * @param[in] parent Data parent required for the subscription.
+ * @param[in] request_xpaths XPaths based on which these data are required, if NULL the complete module data are needed.
+ * @param[in] req_xpath_count Count of @p request_xpaths.
+ * @param[out] parent_dup Top-level node of the duplicated parent, NULL if it would be filtered out.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_xpath_oper_data_parent_dup(struct sr_mod_info_mod_s *mod, const struct lyd_node *parent, const char **request_xpaths,
+        uint32_t req_xpath_count, struct lyd_node **parent_dup)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *last_parent;
+    char *parent_path = NULL;
+    uint32_t i;
+    int required;
+
+    /* duplicate parent so that it is a stand-alone subtree */
+    if (lyd_dup_single(parent, NULL, LYD_DUP_WITH_PARENTS, &last_parent)) {
+        sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, NULL);
+        return err_info;
+    }
+
+    /* go top-level */
+    for (*parent_dup = last_parent; (*parent_dup)->parent; *parent_dup = lyd_parent(*parent_dup)) {}
+
+    if (req_xpath_count) {
+        /* check whether the parent would not be filtered out */
+        parent_path = lyd_path(last_parent, LYD_PATH_STD, NULL, 0);
+        SR_CHECK_MEM_GOTO(!parent_path, err_info, cleanup);
+
+        for (i = 0; i < req_xpath_count; ++i) {
+            if ((err_info = sr_xpath_oper_data_required(request_xpaths[i], parent_path, &required))) {
+                goto cleanup;
             }
-            if (k < sub_atoms->unions[0].atom_count) {
+            if (required) {
                 break;
             }
         }
-
-        if (*required) {
-            /* required for a union */
-            goto cleanup;
+        if (i == req_xpath_count) {
+            /* filtered out */
+            lyd_free_tree(*parent_dup);
+            *parent_dup = NULL;
         }
     }
 
 cleanup:
-    sr_xpath_atoms_free(req_atoms);
-    sr_xpath_atoms_free(sub_atoms);
+    if (err_info) {
+        lyd_free_tree(*parent_dup);
+        *parent_dup = NULL;
+    }
+    free(parent_path);
     return err_info;
 }
 
@@ -770,6 +914,7 @@ cleanup:
  * @param[in] xpath XPath of the provided data.
  * @param[in] request_xpaths XPaths based on which these data are required, if NULL the complete module data are needed.
  * @param[in] req_xpath_count Count of @p request_xpaths.
+ * @param[in] hints Hints of the request for the subscriber.
  * @param[in] orig_name Event originator name.
  * @param[in] orig_data Event originator data.
  * @param[in] shm_subs Subscription array.
@@ -782,45 +927,23 @@ cleanup:
  */
 static sr_error_info_t *
 sr_xpath_oper_data_get(struct sr_mod_info_mod_s *mod, const char *xpath, const char **request_xpaths,
-        uint32_t req_xpath_count, const char *orig_name, const void *orig_data, sr_mod_oper_get_sub_t *shm_subs,
-        uint32_t idx1, const struct lyd_node *parent, uint32_t timeout_ms, sr_conn_ctx_t *conn,
-        struct lyd_node **oper_data)
+        uint32_t req_xpath_count, const sr_oper_get_hints_t *hints, const char *orig_name, const void *orig_data,
+        sr_mod_oper_get_sub_t *shm_subs, uint32_t idx1, const struct lyd_node *parent, uint32_t timeout_ms,
+        sr_conn_ctx_t *conn, struct lyd_node **oper_data)
 {
     sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
-    struct lyd_node *parent_dup = NULL, *last_parent;
+    struct lyd_node *parent_dup = NULL;
     const char *request_xpath;
-    char *parent_path = NULL;
-    uint32_t i;
-    int required;
 
     *oper_data = NULL;
 
     if (parent) {
-        /* duplicate parent so that it is a stand-alone subtree */
-        if (lyd_dup_single(parent, NULL, LYD_DUP_WITH_PARENTS, &last_parent)) {
-            sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, NULL);
+        if ((err_info = sr_xpath_oper_data_parent_dup(mod, parent, request_xpaths, req_xpath_count, &parent_dup))) {
             return err_info;
         }
-
-        /* go top-level */
-        for (parent_dup = last_parent; parent_dup->parent; parent_dup = lyd_parent(parent_dup)) {}
-
-        if (req_xpath_count) {
-            /* check whether the parent would not be filtered out */
-            parent_path = lyd_path(last_parent, LYD_PATH_STD, NULL, 0);
-            SR_CHECK_MEM_GOTO(!parent_path, err_info, cleanup);
-
-            for (i = 0; i < req_xpath_count; ++i) {
-                if ((err_info = sr_xpath_oper_data_required(request_xpaths[i], parent_path, &required))) {
-                    goto cleanup;
-                }
-                if (required) {
-                    break;
-                }
-            }
-            if (i == req_xpath_count) {
-                goto cleanup;
-            }
+        if (!parent_dup) {
+            /* filtered out */
+            return NULL;
         }
     }
 
@@ -828,8 +951,8 @@ sr_xpath_oper_data_get(struct sr_mod_info_mod_s *mod, const char *xpath, const c
     request_xpath = (req_xpath_count == 1) ? request_xpaths[0] : NULL;
 
     /* get data from client */
-    if ((err_info = sr_shmsub_oper_get_notify(mod, xpath, request_xpath, parent_dup, orig_name, orig_data, shm_subs,
-            idx1, timeout_ms, conn, oper_data, &cb_err_info))) {
+    if ((err_info = sr_shmsub_oper_get_notify(mod, xpath, request_xpath, hints, parent_dup, orig_name, orig_data,
+            shm_subs, idx1, timeout_ms, conn, oper_data, &cb_err_info))) {
         sr_errinfo_merge(&err_info, cb_err_info);
         goto cleanup;
     }
@@ -851,12 +974,12 @@ sr_xpath_oper_data_get(struct sr_mod_info_mod_s *mod, const char *xpath, const c
 
 cleanup:
     lyd_free_tree(parent_dup);
-    free(parent_path);
     return err_info;
 }
 
 /**
- * @brief Try to merge operational get cached data of a subscription.
+ * @brief Try to merge operational get cached data of a subscription. If not cached by the connection, try to use
+ * data cached by a shared oper poll subscription of any connection.
  *
  * @param[in] mod Mod info module.
  * @param[in] sub_xpath Subscription XPath.
@@ -871,6 +994,7 @@ sr_module_oper_data_update_cached(struct sr_mod_info_mod_s *mod, const char *sub
 {
     sr_error_info_t *err_info = NULL;
     struct sr_oper_poll_cache_s *cache = NULL;
+    struct lyd_node *shared_data;
     uint32_t i;
 
     *merged = 0;
@@ -890,7 +1014,19 @@ sr_module_oper_data_update_cached(struct sr_mod_info_mod_s *mod, const char *sub
         }
     }
     if (!cache) {
-        goto cleanup_cache_unlock;
+        /* CONN OPER CACHE UNLOCK */
+        sr_rwunlock(&conn->oper_cache_lock, SR_CONN_OPER_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+
+        /* try to get the shared data */
+        if (sr_oper_poll_shm_load(mod->ly_mod, sub_xpath, conn->content_id, &shared_data, NULL)) {
+            if (lyd_merge_siblings(data, shared_data, 0)) {
+                sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, NULL);
+            } else {
+                *merged = 1;
+            }
+            lyd_free_siblings(shared_data);
+        }
+        goto cleanup;
     }
 
     /* CACHE DATA READ LOCK */
@@ -919,117 +1055,454 @@ cleanup:
 }
 
 /**
- * @brief Update (replace or append) operational data for a specific module.
+ * @brief Operational get data of a subscription retrieved together with other subscriptions.
+ */
+struct sr_oper_get_batch_item_s {
+    const char *sub_xpath;      /**< Subscription XPath. */
+    int merge;                  /**< Whether to merge the data with any present data instead of replacing them. */
+    int event;                  /**< Whether an event was generated for the data, otherwise they were cached. */
+    uint32_t xpath_idx;         /**< Index of the XPath in the SHM batch, if an event was generated. */
+    struct lyd_node *data;      /**< Retrieved data. */
+};
+
+/**
+ * @brief Operational get data of several subscriptions retrieved together.
+ */
+struct sr_oper_get_batch_s {
+    struct sr_shmsub_oper_get_batch_s shm_batch;    /**< Generated events. */
+    struct sr_oper_get_batch_item_s *items;         /**< Subscription data in the subscription order. */
+    uint32_t item_count;                            /**< Count of @p items. */
+};
+
+/**
+ * @brief Clear operational get batch.
+ *
+ * @param[in] batch Batch to clear.
+ * @param[in] cid Connection ID.
+ */
+static void
+sr_module_oper_data_batch_clear(struct sr_oper_get_batch_s *batch, sr_cid_t cid)
+{
+    uint32_t i;
+
+    for (i = 0; i < batch->item_count; ++i) {
+        lyd_free_all(batch->items[i].data);
+    }
+    free(batch->items);
+    batch->items = NULL;
+    batch->item_count = 0;
+
+    sr_shmsub_oper_get_notify_batch_clear(&batch->shm_batch, cid);
+}
+
+/**
+ * @brief Add operational data of a subscription into a batch, either cached or generate an event for them.
  *
- * @param[in] mod Mod info module to process.
- * @param[in] oper_mode Current lock mode of @p mod for ::SR_DS_OPERATIONAL.
+ * @param[in] mod Mod info module.
+ * @param[in] sub_xpath Subscription XPath.
+ * @param[in] merge Whether the subscription data are merged with any present data.
+ * @param[in] request_xpaths XPaths based on which these data are required, if NULL the complete module data are needed.
+ * @param[in] req_xpath_count Count of @p request_xpaths.
+ * @param[in] hints Hints of the request for the subscriber.
  * @param[in] orig_name Event originator name.
  * @param[in] orig_data Event originator data.
+ * @param[in] shm_subs Subscription array.
+ * @param[in] idx1 Index of the subscription array from where to read subscriptions with the same XPath.
+ * @param[in] parent Data parent required for the subscription, NULL if top-level.
  * @param[in] conn Connection to use.
- * @param[in] timeout_ms Operational callback timeout in milliseconds.
- * @param[in] get_oper_opts Get oper data options.
- * @param[in,out] data Operational data tree.
+ * @param[in,out] batch Batch to add to.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_module_oper_data_update(struct sr_mod_info_mod_s *mod, const char *orig_name, const void *orig_data, sr_conn_ctx_t *conn,
-        uint32_t timeout_ms, sr_get_oper_flag_t get_oper_opts, struct lyd_node **data)
+sr_module_oper_data_batch_add(struct sr_mod_info_mod_s *mod, const char *sub_xpath, int merge,
+        const char **request_xpaths, uint32_t req_xpath_count, const sr_oper_get_hints_t *hints, const char *orig_name,
+        const void *orig_data, sr_mod_oper_get_sub_t *shm_subs, uint32_t idx1, const struct lyd_node *parent,
+        sr_conn_ctx_t *conn, struct sr_oper_get_batch_s *batch)
 {
     sr_error_info_t *err_info = NULL;
-    sr_mod_oper_get_sub_t *shm_subs;
-    sr_mod_oper_get_xpath_sub_t *xpath_subs;
-    const char *sub_xpath, **request_xpaths = NULL;
-    char *parent_xpath = NULL;
-    uint32_t i, j, req_xpath_count = 0;
-    int required, merged;
-    struct ly_set *set = NULL;
-    struct lyd_node *edit = NULL, *oper_data;
+    struct sr_oper_get_batch_item_s *item;
+    struct lyd_node *parent_dup = NULL;
+    int merged;
 
-    if (!(get_oper_opts & SR_OPER_NO_STORED)) {
-        /* get stored operational edit */
-        if ((err_info = sr_module_file_oper_data_load(mod, &edit))) {
-            return err_info;
-        }
-    }
-    if (edit) {
-        /* apply the edit */
-        err_info = sr_edit_mod_apply(edit, mod->ly_mod, data, NULL, NULL);
-        lyd_free_all(edit);
-        if (err_info) {
+    if (parent) {
+        if ((err_info = sr_xpath_oper_data_parent_dup(mod, parent, request_xpaths, req_xpath_count, &parent_dup))) {
             return err_info;
         }
-
-        /* add any missing NP containers in the data */
-        if (lyd_new_implicit_module(data, mod->ly_mod, LYD_IMPLICIT_NO_DEFAULTS, NULL)) {
-            sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, *data);
-            return err_info;
+        if (!parent_dup) {
+            /* filtered out */
+            return NULL;
         }
     }
 
-    if (get_oper_opts & SR_OPER_NO_SUBS) {
-        /* do not get data from subscribers */
-        return NULL;
+    /* add new item */
+    item = realloc(batch->items, (batch->item_count + 1) * sizeof *batch->items);
+    SR_CHECK_MEM_GOTO(!item, err_info, cleanup);
+    batch->items = item;
+    item = &batch->items[batch->item_count];
+    memset(item, 0, sizeof *item);
+    item->sub_xpath = sub_xpath;
+    item->merge = merge;
+    ++batch->item_count;
+
+    if (!(hints->get_oper_opts & SR_OPER_NO_CACHED)) {
+        /* try to get data from the cache */
+        if ((err_info = sr_module_oper_data_update_cached(mod, sub_xpath, conn, &item->data, &merged))) {
+            goto cleanup;
+        }
+        if (merged) {
+            /* we have the data */
+            goto cleanup;
+        }
     }
 
-    assert(timeout_ms);
+    /* generate the event, provide request XPath for the client, if possible */
+    item->event = 1;
+    item->xpath_idx = batch->shm_batch.xpath_count;
+    err_info = sr_shmsub_oper_get_notify_batch_add(&batch->shm_batch, mod, sub_xpath,
+            (req_xpath_count == 1) ? request_xpaths[0] : NULL, hints, parent_dup, orig_name, orig_data, shm_subs, idx1,
+            conn);
 
-    /* OPER GET SUB READ LOCK */
-    if ((err_info = sr_rwlock(&mod->shm_mod->oper_get_lock, SR_SHMEXT_SUB_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid,
-            __func__, NULL, NULL))) {
-        return err_info;
-    }
+cleanup:
+    lyd_free_tree(parent_dup);
+    return err_info;
+}
 
-    /* EXT READ LOCK */
-    if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_READ, 0, __func__))) {
-        goto cleanup_opergetsub_unlock;
+/**
+ * @brief Skip any predicates in an XPath.
+ *
+ * @param[in] ptr Current position in an XPath.
+ * @return Position after the predicates.
+ */
+static const char *
+sr_xpath_skip_predicates(const char *ptr)
+{
+    char quote = 0;
+
+    while (ptr[0] == '[') {
+        for (++ptr; quote || (ptr[0] != ']'); ++ptr) {
+            if (quote && (ptr[0] == quote)) {
+                quote = 0;
+            } else if (!quote && ((ptr[0] == '\'') || (ptr[0] == '\"'))) {
+                quote = ptr[0];
+            }
+        }
+        ++ptr;
     }
 
-    /* XPaths are ordered based on depth */
-    shm_subs = (sr_mod_oper_get_sub_t *)(conn->ext_shm.addr + mod->shm_mod->oper_get_subs);
-    for (i = 0; i < mod->shm_mod->oper_get_sub_count; ++i) {
-        sub_xpath = conn->ext_shm.addr + shm_subs[i].xpath;
-        xpath_subs = (sr_mod_oper_get_xpath_sub_t *)(conn->ext_shm.addr + shm_subs[i].xpath_subs);
+    return ptr;
+}
 
-        /* useless to retrieve configuration data, state data */
-        if (((shm_subs[i].sub_type == SR_OPER_GET_SUB_CONFIG) && (get_oper_opts & SR_OPER_NO_CONFIG)) ||
-                ((shm_subs[i].sub_type == SR_OPER_GET_SUB_STATE) && (get_oper_opts & SR_OPER_NO_STATE))) {
-            continue;
-        }
+/**
+ * @brief Check whether any subscription in an operational get batch may provide a data parent.
+ *
+ * Predicates are ignored so the check is conservative.
+ *
+ * @param[in] batch Batch to examine.
+ * @param[in] parent_xpath Data parent XPath.
+ * @return Whether data of any batch subscription may be an ancestor-or-self of the parent.
+ */
+static int
+sr_module_oper_data_batch_provides(const struct sr_oper_get_batch_s *batch, const char *parent_xpath)
+{
+    const char *ptr1, *ptr2;
+    uint32_t i;
 
-        if (mod->xpath_count) {
-            /* check whether these data are even required */
-            for (j = 0; j < mod->xpath_count; ++j) {
-                if ((err_info = sr_xpath_oper_data_required(mod->xpaths[j], sub_xpath, &required))) {
-                    goto cleanup_opergetsub_ext_unlock;
-                }
-                if (required) {
-                    /* remember all xpaths causing these data to be required */
-                    request_xpaths = sr_realloc(request_xpaths, (req_xpath_count + 1) * sizeof *request_xpaths);
-                    SR_CHECK_MEM_GOTO(!request_xpaths, err_info, cleanup_opergetsub_ext_unlock);
-                    request_xpaths[req_xpath_count] = mod->xpaths[j];
-                    ++req_xpath_count;
+    for (i = 0; i < batch->item_count; ++i) {
+        ptr1 = batch->items[i].sub_xpath;
+        ptr2 = parent_xpath;
+        while (1) {
+            ptr1 = sr_xpath_skip_predicates(ptr1);
+            ptr2 = sr_xpath_skip_predicates(ptr2);
+            if (!ptr1[0]) {
+                if (!ptr2[0] || (ptr2[0] == '/')) {
+                    return 1;
                 }
+                break;
             }
-
-            if (!req_xpath_count) {
-                /* not required */
-                continue;
+            if (ptr1[0] != ptr2[0]) {
+                break;
             }
+            ++ptr1;
+            ++ptr2;
         }
+    }
 
-        /* remove any present data */
-        if (!(xpath_subs[0].opts & SR_SUBSCR_OPER_MERGE) && (err_info = sr_lyd_xpath_complement(data, sub_xpath))) {
-            goto cleanup_opergetsub_ext_unlock;
+    return 0;
+}
+
+/**
+ * @brief Wait for all the generated events in an operational get batch and merge the data of all the subscriptions
+ * in their order. The batch is cleared.
+ *
+ * @param[in] mod Mod info module.
+ * @param[in] batch Batch to flush.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds.
+ * @param[in] conn Connection to use.
+ * @param[in,out] data Operational data tree.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_module_oper_data_batch_flush(struct sr_mod_info_mod_s *mod, struct sr_oper_get_batch_s *batch, uint32_t timeout_ms,
+        sr_conn_ctx_t *conn, struct lyd_node **data)
+{
+    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
+    struct sr_oper_get_batch_item_s *item;
+    struct lyd_node **oper_data = NULL;
+    uint32_t i;
+
+    if (batch->shm_batch.xpath_count) {
+        oper_data = calloc(batch->shm_batch.xpath_count, sizeof *oper_data);
+        SR_CHECK_MEM_GOTO(!oper_data, err_info, cleanup);
+
+        /* wait for all the subscribers together */
+        if ((err_info = sr_shmsub_oper_get_notify_batch_wait(&batch->shm_batch, mod, timeout_ms, conn, oper_data,
+                &cb_err_info))) {
+            sr_errinfo_merge(&err_info, cb_err_info);
+            goto cleanup;
         }
 
-        if (!(get_oper_opts & SR_OPER_NO_CACHED)) {
-            /* try to get data from the cache */
-            if ((err_info = sr_module_oper_data_update_cached(mod, sub_xpath, conn, data, &merged))) {
-                goto cleanup_opergetsub_ext_unlock;
-            }
-            if (merged) {
-                /* we have the data */
-                goto next_iter;
+        /* return callback error if some was generated */
+        if (cb_err_info) {
+            sr_errinfo_merge(&err_info, cb_err_info);
+            sr_errinfo_new(&err_info, SR_ERR_CALLBACK_FAILED, "User callback failed.");
+            goto cleanup;
+        }
+
+        for (i = 0; i < batch->item_count; ++i) {
+            item = &batch->items[i];
+            if (item->event) {
+                item->data = oper_data[item->xpath_idx];
+                oper_data[item->xpath_idx] = NULL;
+
+                /* add any missing NP containers, redundant to add top-level containers */
+                if (item->data && lyd_new_implicit_tree(item->data, LYD_IMPLICIT_NO_DEFAULTS, NULL)) {
+                    sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, NULL);
+                    goto cleanup;
+                }
+            }
+        }
+    }
+
+    /* merge the data in the order of the subscriptions */
+    for (i = 0; i < batch->item_count; ++i) {
+        item = &batch->items[i];
+
+        /* remove any present data */
+        if (!item->merge && (err_info = sr_lyd_xpath_complement(data, item->sub_xpath))) {
+            goto cleanup;
+        }
+
+        if (lyd_merge_siblings(data, item->data, LYD_MERGE_DESTRUCT)) {
+            sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, NULL);
+            goto cleanup;
+        }
+        item->data = NULL;
+    }
+
+cleanup:
+    if (oper_data) {
+        for (i = 0; i < batch->shm_batch.xpath_count; ++i) {
+            lyd_free_all(oper_data[i]);
+        }
+        free(oper_data);
+    }
+    sr_module_oper_data_batch_clear(batch, conn->cid);
+    return err_info;
+}
+
+/**
+ * @brief Find all the data parents of a subscription.
+ *
+ * @param[in] mod Mod info module.
+ * @param[in] data Operational data tree.
+ * @param[in] parent_xpath Data parent XPath.
+ * @param[in] parent_inst Whether @p parent_xpath is a single instance identified by its keys.
+ * @param[out] set Set with the found parents.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_module_oper_data_parents(struct sr_mod_info_mod_s *mod, const struct lyd_node *data, const char *parent_xpath,
+        int parent_inst, struct ly_set **set)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *parent;
+    LY_ERR lyrc;
+
+    *set = NULL;
+
+    if (!parent_inst) {
+        /* evaluate the XPath */
+        if (lyd_find_xpath(data, parent_xpath, set)) {
+            sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, NULL);
+        }
+        return err_info;
+    }
+
+    /* find the keyed instance directly, avoids evaluating the XPath on all the list instances */
+    if (ly_set_new(set)) {
+        SR_ERRINFO_MEM(&err_info);
+        return err_info;
+    }
+    lyrc = lyd_find_path(data, parent_xpath, 0, &parent);
+    if (!lyrc) {
+        if (ly_set_add(*set, parent, 1, NULL)) {
+            SR_ERRINFO_MEM(&err_info);
+        }
+    } else if ((lyrc != LY_ENOTFOUND) && (lyrc != LY_EINCOMPLETE)) {
+        sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, NULL);
+    }
+
+    return err_info;
+}
+
+/**
+ * @brief Apply stored operational data (edit) of a specific module.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mod Mod info module to process.
+ * @param[out] cids Optional owner connections of the applied edit.
+ * @param[out] cid_count Count of @p cids.
+ * @param[in,out] data Operational data tree.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_module_oper_data_stored_apply(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod, sr_cid_t **cids,
+        uint32_t *cid_count, struct lyd_node **data)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *edit = NULL;
+
+    if (cids) {
+        *cids = NULL;
+        *cid_count = 0;
+    }
+
+    /* get stored operational edit */
+    if ((err_info = sr_module_file_oper_data_load(conn, mod, &edit))) {
+        return err_info;
+    }
+    if (!edit) {
+        return NULL;
+    }
+
+    if (cids && (err_info = sr_oper_edit_owners(edit, cids, cid_count))) {
+        goto cleanup;
+    }
+
+    /* apply the edit */
+    if ((err_info = sr_edit_mod_apply(edit, mod->ly_mod, data, NULL, NULL))) {
+        goto cleanup;
+    }
+
+    /* add any missing NP containers in the data */
+    if (lyd_new_implicit_module(data, mod->ly_mod, LYD_IMPLICIT_NO_DEFAULTS, NULL)) {
+        sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, *data);
+        goto cleanup;
+    }
+
+cleanup:
+    if (err_info && cids) {
+        free(*cids);
+        *cids = NULL;
+        *cid_count = 0;
+    }
+    lyd_free_all(edit);
+    return err_info;
+}
+
+/**
+ * @brief Append operational data of a specific module provided by operational get subscriptions.
+ *
+ * @param[in] mod Mod info module to process.
+ * @param[in] orig_name Event originator name.
+ * @param[in] orig_data Event originator data.
+ * @param[in] conn Connection to use.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds.
+ * @param[in] get_oper_opts Get oper data options.
+ * @param[in] max_depth Requested maximum depth of the data, only a hint for the subscribers.
+ * @param[in] limit Requested maximum number of subtrees, only a hint for the subscribers.
+ * @param[in,out] data Operational data tree.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_module_oper_data_update(struct sr_mod_info_mod_s *mod, const char *orig_name, const void *orig_data, sr_conn_ctx_t *conn,
+        uint32_t timeout_ms, sr_get_oper_flag_t get_oper_opts, uint32_t max_depth, uint32_t limit, struct lyd_node **data)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_oper_get_hints_t hints;
+    sr_mod_oper_get_sub_t *shm_subs;
+    sr_mod_oper_get_xpath_sub_t *xpath_subs;
+    const char *sub_xpath, **request_xpaths = NULL;
+    char *parent_xpath = NULL;
+    sr_xp_atoms_t **req_atoms = NULL;
+    uint32_t i, j, req_xpath_count = 0;
+    int merged;
+    struct ly_set *set = NULL;
+    struct lyd_node *oper_data;
+    struct sr_oper_get_batch_s batch = {0};
+
+    if (get_oper_opts & SR_OPER_NO_SUBS) {
+        /* do not get data from subscribers */
+        return NULL;
+    }
+
+    assert(timeout_ms);
+
+    /* the subscribers may skip generating data that would be trimmed anyway */
+    hints.max_depth = max_depth;
+    hints.limit = limit;
+    hints.get_oper_opts = get_oper_opts;
+
+    if (mod->xpath_count) {
+        /* split the request XPaths into text atoms only once, subscription atoms are prepared in ext SHM */
+        req_atoms = calloc(mod->xpath_count, sizeof *req_atoms);
+        SR_CHECK_MEM_RET(!req_atoms, err_info);
+        for (j = 0; j < mod->xpath_count; ++j) {
+            if ((err_info = sr_xpath_get_text_atoms(mod->xpaths[j], &req_atoms[j]))) {
+                goto cleanup_atoms;
+            }
+        }
+    }
+
+    /* OPER GET SUB READ LOCK */
+    if ((err_info = sr_rwlock(&mod->shm_mod->oper_get_lock, SR_SHMEXT_SUB_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid,
+            __func__, NULL, NULL))) {
+        goto cleanup_atoms;
+    }
+
+    /* EXT READ LOCK */
+    if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        goto cleanup_opergetsub_unlock;
+    }
+
+    /* XPaths are ordered based on depth */
+    shm_subs = (sr_mod_oper_get_sub_t *)(conn->ext_shm.addr + mod->shm_mod->oper_get_subs);
+    for (i = 0; i < mod->shm_mod->oper_get_sub_count; ++i) {
+        sub_xpath = conn->ext_shm.addr + shm_subs[i].xpath;
+        xpath_subs = (sr_mod_oper_get_xpath_sub_t *)(conn->ext_shm.addr + shm_subs[i].xpath_subs);
+
+        /* useless to retrieve configuration data, state data */
+        if (((shm_subs[i].sub_type == SR_OPER_GET_SUB_CONFIG) && (get_oper_opts & SR_OPER_NO_CONFIG)) ||
+                ((shm_subs[i].sub_type == SR_OPER_GET_SUB_STATE) && (get_oper_opts & SR_OPER_NO_STATE))) {
+            continue;
+        }
+
+        if (mod->xpath_count) {
+            /* check whether these data are even required */
+            for (j = 0; j < mod->xpath_count; ++j) {
+                if (sr_xpath_oper_data_atoms_required(req_atoms[j],
+                        shm_subs[i].atoms ? conn->ext_shm.addr + shm_subs[i].atoms : NULL)) {
+                    /* remember all xpaths causing these data to be required */
+                    request_xpaths = sr_realloc(request_xpaths, (req_xpath_count + 1) * sizeof *request_xpaths);
+                    SR_CHECK_MEM_GOTO(!request_xpaths, err_info, cleanup_opergetsub_ext_unlock);
+                    request_xpaths[req_xpath_count] = mod->xpaths[j];
+                    ++req_xpath_count;
+                }
+            }
+
+            if (!req_xpath_count) {
+                /* not required */
+                continue;
             }
         }
 
@@ -1038,14 +1511,63 @@ sr_module_oper_data_update(struct sr_mod_info_mod_s *mod, const char *orig_name,
             goto cleanup_opergetsub_ext_unlock;
         }
 
+        if (get_oper_opts & SR_OPER_SUBS_PARALLEL) {
+            if (!parent_xpath) {
+                /* top-level data, get them together with all the other top-level data */
+                if ((err_info = sr_module_oper_data_batch_add(mod, sub_xpath,
+                        xpath_subs[0].opts & SR_SUBSCR_OPER_MERGE, request_xpaths, req_xpath_count, &hints,
+                        orig_name, orig_data, shm_subs, i, NULL, conn, &batch))) {
+                    goto cleanup_opergetsub_ext_unlock;
+                }
+                goto next_iter;
+            }
+
+            if (shm_subs[i].parent_inst && *data && !sr_module_oper_data_batch_provides(&batch, parent_xpath)) {
+                /* nested data of an existing single parent, get them together with the other data */
+                if ((err_info = sr_module_oper_data_parents(mod, *data, parent_xpath, 1, &set))) {
+                    goto cleanup_opergetsub_ext_unlock;
+                }
+                if (set->count) {
+                    if ((err_info = sr_module_oper_data_batch_add(mod, sub_xpath,
+                            xpath_subs[0].opts & SR_SUBSCR_OPER_MERGE, request_xpaths, req_xpath_count, &hints,
+                            orig_name, orig_data, shm_subs, i, set->dnodes[0], conn, &batch))) {
+                        goto cleanup_opergetsub_ext_unlock;
+                    }
+                    goto next_iter;
+                }
+                ly_set_free(set, NULL);
+                set = NULL;
+            }
+
+            /* nested data may require the data of the previous subscriptions */
+            if ((err_info = sr_module_oper_data_batch_flush(mod, &batch, timeout_ms, conn, data))) {
+                goto cleanup_opergetsub_ext_unlock;
+            }
+        }
+
+        /* remove any present data */
+        if (!(xpath_subs[0].opts & SR_SUBSCR_OPER_MERGE) && (err_info = sr_lyd_xpath_complement(data, sub_xpath))) {
+            goto cleanup_opergetsub_ext_unlock;
+        }
+
+        if (!(get_oper_opts & SR_OPER_NO_CACHED)) {
+            /* try to get data from the cache */
+            if ((err_info = sr_module_oper_data_update_cached(mod, sub_xpath, conn, data, &merged))) {
+                goto cleanup_opergetsub_ext_unlock;
+            }
+            if (merged) {
+                /* we have the data */
+                goto next_iter;
+            }
+        }
+
         if (parent_xpath) {
             if (!*data) {
                 /* parent does not exist for sure */
                 goto next_iter;
             }
 
-            if (lyd_find_xpath(*data, parent_xpath, &set)) {
-                sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, NULL);
+            if ((err_info = sr_module_oper_data_parents(mod, *data, parent_xpath, shm_subs[i].parent_inst, &set))) {
                 goto cleanup_opergetsub_ext_unlock;
             }
 
@@ -1057,8 +1579,8 @@ sr_module_oper_data_update(struct sr_mod_info_mod_s *mod, const char *orig_name,
             /* nested data */
             for (j = 0; j < set->count; ++j) {
                 /* get oper data from the client */
-                if ((err_info = sr_xpath_oper_data_get(mod, sub_xpath, request_xpaths, req_xpath_count, orig_name,
-                        orig_data, shm_subs, i, set->dnodes[j], timeout_ms, conn, &oper_data))) {
+                if ((err_info = sr_xpath_oper_data_get(mod, sub_xpath, request_xpaths, req_xpath_count, &hints,
+                        orig_name, orig_data, shm_subs, i, set->dnodes[j], timeout_ms, conn, &oper_data))) {
                     goto cleanup_opergetsub_ext_unlock;
                 }
 
@@ -1078,8 +1600,8 @@ next_iter:
             set = NULL;
         } else {
             /* top-level data */
-            if ((err_info = sr_xpath_oper_data_get(mod, sub_xpath, request_xpaths, req_xpath_count, orig_name,
-                    orig_data, shm_subs, i, NULL, timeout_ms, conn, &oper_data))) {
+            if ((err_info = sr_xpath_oper_data_get(mod, sub_xpath, request_xpaths, req_xpath_count, &hints,
+                    orig_name, orig_data, shm_subs, i, NULL, timeout_ms, conn, &oper_data))) {
                 goto cleanup_opergetsub_ext_unlock;
             }
 
@@ -1095,7 +1617,14 @@ next_iter:
         req_xpath_count = 0;
     }
 
+    /* get all the remaining data */
+    if ((err_info = sr_module_oper_data_batch_flush(mod, &batch, timeout_ms, conn, data))) {
+        goto cleanup_opergetsub_ext_unlock;
+    }
+
 cleanup_opergetsub_ext_unlock:
+    sr_module_oper_data_batch_clear(&batch, conn->cid);
+
     /* EXT READ UNLOCK */
     sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 0, __func__);
 
@@ -1106,6 +1635,12 @@ cleanup_opergetsub_unlock:
     free(request_xpaths);
     free(parent_xpath);
     ly_set_free(set, NULL);
+
+cleanup_atoms:
+    for (j = 0; req_atoms && (j < mod->xpath_count); ++j) {
+        sr_xpath_atoms_free(req_atoms[j]);
+    }
+    free(req_atoms);
     return err_info;
 }
 
@@ -1287,44 +1822,97 @@ sr_oper_data_trim_r(struct lyd_node **data, struct lyd_node *sibling, sr_get_ope
 }
 
 /**
- * @brief Load module data of the ietf-yang-library module. They are actually generated.
+ * @brief Generate data of the ietf-yang-library module.
  *
- * @param[in] mod_info Mod info to use.
+ * @param[in] conn Connection to use.
  * @param[in] mod Mod info module to use.
+ * @param[in] content_id Context content ID.
+ * @param[out] mod_data Generated module data.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_modinfo_module_data_load_yanglib(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod)
+sr_modinfo_module_yanglib_generate(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod, uint32_t content_id,
+        struct lyd_node **mod_data)
 {
     sr_error_info_t *err_info = NULL;
-    struct lyd_node *mod_data;
-    uint32_t content_id;
-
-    /* get content-id */
-    content_id = SR_CONN_MAIN_SHM(mod_info->conn)->content_id;
 
     /* get the data from libyang */
-    SR_CHECK_LY_RET(ly_ctx_get_yanglib_data(mod_info->conn->ly_ctx, &mod_data, "%" PRIu32, content_id),
-            mod_info->conn->ly_ctx, err_info);
+    SR_CHECK_LY_RET(ly_ctx_get_yanglib_data(conn->ly_ctx, mod_data, "%" PRIu32, content_id), conn->ly_ctx, err_info);
 
     if (!strcmp(mod->ly_mod->revision, "2019-01-04")) {
-        assert(!strcmp(mod_data->schema->name, "yang-library"));
+        assert(!strcmp((*mod_data)->schema->name, "yang-library"));
 
         /* add supported datastores */
-        if (lyd_new_path(mod_data, NULL, "datastore[name='ietf-datastores:running']/schema", "complete", 0, 0) ||
-                lyd_new_path(mod_data, NULL, "datastore[name='ietf-datastores:candidate']/schema", "complete", 0, 0) ||
-                lyd_new_path(mod_data, NULL, "datastore[name='ietf-datastores:startup']/schema", "complete", 0, 0) ||
-                lyd_new_path(mod_data, NULL, "datastore[name='ietf-datastores:operational']/schema", "complete", 0, 0)) {
-            sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx, NULL);
-            return err_info;
+        if (lyd_new_path(*mod_data, NULL, "datastore[name='ietf-datastores:running']/schema", "complete", 0, 0) ||
+                lyd_new_path(*mod_data, NULL, "datastore[name='ietf-datastores:candidate']/schema", "complete", 0, 0) ||
+                lyd_new_path(*mod_data, NULL, "datastore[name='ietf-datastores:startup']/schema", "complete", 0, 0) ||
+                lyd_new_path(*mod_data, NULL, "datastore[name='ietf-datastores:operational']/schema", "complete", 0, 0)) {
+            sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
+            goto cleanup;
         }
     } else if (!strcmp(mod->ly_mod->revision, "2016-06-21")) {
-        assert(!strcmp(mod_data->schema->name, "modules-state"));
+        assert(!strcmp((*mod_data)->schema->name, "modules-state"));
 
         /* all data should already be there */
     } else {
         /* no other revision is supported */
         SR_ERRINFO_INT(&err_info);
+        goto cleanup;
+    }
+
+cleanup:
+    if (err_info) {
+        lyd_free_siblings(*mod_data);
+        *mod_data = NULL;
+    }
+    return err_info;
+}
+
+/**
+ * @brief Load module data of the ietf-yang-library module. They are actually generated, but only once
+ * for every context, then they are duplicated from the connection cache.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] mod Mod info module to use.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_module_data_load_yanglib(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_conn_ctx_t *conn = mod_info->conn;
+    struct lyd_node *mod_data = NULL;
+    uint32_t content_id;
+
+    /* get content-id */
+    content_id = SR_CONN_MAIN_SHM(conn)->content_id;
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->yanglib_cache_lock, SR_CONN_YANGLIB_CACHE_LOCK_TIMEOUT, __func__, NULL, NULL))) {
+        return err_info;
+    }
+
+    if (!conn->yanglib_cache || (conn->yanglib_cache_cid != content_id)) {
+        /* generate the data and cache them */
+        lyd_free_siblings(conn->yanglib_cache);
+        conn->yanglib_cache = NULL;
+        if ((err_info = sr_modinfo_module_yanglib_generate(conn, mod, content_id, &conn->yanglib_cache))) {
+            goto cache_unlock;
+        }
+        conn->yanglib_cache_cid = content_id;
+    }
+
+    /* use a copy of the cached data */
+    if (lyd_dup_siblings(conn->yanglib_cache, NULL, LYD_DUP_RECURSIVE, &mod_data)) {
+        sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
+        goto cache_unlock;
+    }
+
+cache_unlock:
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->yanglib_cache_lock);
+
+    if (err_info) {
         return err_info;
     }
 
@@ -1455,30 +2043,92 @@ sr_modinfo_module_srmon_locks_ds(sr_rwlock_t *rwlock, uint32_t skip_read_cid, co
 }
 
 /**
- * @brief Add held lock nodes (cid, mode) to a data tree.
+ * @brief Add lock statistics nodes to a data tree.
  *
- * @param[in] rwlock Lock to read CIDs from.
- * @param[in] list_name List node name to create.
- * @param[in] parent Parent node of the new node @p list_name\.
+ * @param[in] rwlock Lock to read the statistics from.
+ * @param[in] name Lock name.
+ * @param[in] parent Parent node of the new "lock-stats" node.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_modinfo_module_srmon_locks(sr_rwlock_t *rwlock, const char *list_name, struct lyd_node *parent)
+sr_modinfo_module_srmon_lock_stats(sr_rwlock_t *rwlock, const char *name, struct lyd_node *parent)
 {
     sr_error_info_t *err_info = NULL;
-    sr_cid_t cid;
+    const char *mode_names[] = {"read", "write"};
+    sr_rwlock_stats_t *stats;
+    struct lyd_node *sr_lock = NULL, *sr_mode;
     uint32_t i;
-    int ret;
+    char buf[22];
+    const struct ly_ctx *ly_ctx = LYD_CTX(parent);
 
-#define CID_STR_LEN 64
-    char cid_str[CID_STR_LEN];
-    struct lyd_node *list;
-    struct ly_ctx *ly_ctx;
+    for (i = 0; i < 2; ++i) {
+        stats = &rwlock->stats[i];
+        if (!ATOMIC_LOAD_RELAXED(stats->lock_count)) {
+            /* never acquired or not measured */
+            continue;
+        }
 
-    ly_ctx = (struct ly_ctx *)LYD_CTX(parent);
+        if (!sr_lock) {
+            /* lock-stats with name */
+            SR_CHECK_LY_RET(lyd_new_list(parent, NULL, "lock-stats", 0, &sr_lock, name), ly_ctx, err_info);
+        }
 
-    if ((cid = rwlock->writer)) {
-        /* list instance */
+        /* mode with name */
+        SR_CHECK_LY_RET(lyd_new_list(sr_lock, NULL, "mode", 0, &sr_mode, mode_names[i]), ly_ctx, err_info);
+
+        /* acquired */
+        sprintf(buf, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(stats->lock_count));
+        SR_CHECK_LY_RET(lyd_new_term(sr_mode, NULL, "acquired", buf, 0, NULL), ly_ctx, err_info);
+
+        /* waited */
+        sprintf(buf, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(stats->wait_count));
+        SR_CHECK_LY_RET(lyd_new_term(sr_mode, NULL, "waited", buf, 0, NULL), ly_ctx, err_info);
+
+        /* wait-time */
+        sprintf(buf, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(stats->wait_usec));
+        SR_CHECK_LY_RET(lyd_new_term(sr_mode, NULL, "wait-time", buf, 0, NULL), ly_ctx, err_info);
+
+        /* max-wait-time */
+        sprintf(buf, "%" PRIu32, (uint32_t)ATOMIC_LOAD_RELAXED(stats->wait_max_usec));
+        SR_CHECK_LY_RET(lyd_new_term(sr_mode, NULL, "max-wait-time", buf, 0, NULL), ly_ctx, err_info);
+
+        /* hold-time */
+        sprintf(buf, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(stats->hold_usec));
+        SR_CHECK_LY_RET(lyd_new_term(sr_mode, NULL, "hold-time", buf, 0, NULL), ly_ctx, err_info);
+
+        /* max-hold-time */
+        sprintf(buf, "%" PRIu32, (uint32_t)ATOMIC_LOAD_RELAXED(stats->hold_max_usec));
+        SR_CHECK_LY_RET(lyd_new_term(sr_mode, NULL, "max-hold-time", buf, 0, NULL), ly_ctx, err_info);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add held lock nodes (cid, mode) and the lock statistics to a data tree.
+ *
+ * @param[in] rwlock Lock to read CIDs from.
+ * @param[in] list_name List node name to create.
+ * @param[in] parent Parent node of the new node @p list_name\.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_module_srmon_locks(sr_rwlock_t *rwlock, const char *list_name, struct lyd_node *parent)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_cid_t cid;
+    uint32_t i;
+    int ret;
+
+#define CID_STR_LEN 64
+    char cid_str[CID_STR_LEN];
+    struct lyd_node *list;
+    struct ly_ctx *ly_ctx;
+
+    ly_ctx = (struct ly_ctx *)LYD_CTX(parent);
+
+    if ((cid = rwlock->writer)) {
+        /* list instance */
         SR_CHECK_LY_RET(lyd_new_list(parent, NULL, list_name, 0, &list), ly_ctx, err_info);
 
         /* cid */
@@ -1517,10 +2167,151 @@ cleanup:
     /* READ MUTEX UNLOCK */
     pthread_mutex_unlock(&rwlock->r_mutex);
 
+    if (!err_info) {
+        /* lock-stats */
+        err_info = sr_modinfo_module_srmon_lock_stats(rwlock, list_name, parent);
+    }
     return err_info;
 #undef CID_STR_LEN
 }
 
+/**
+ * @brief Add latency statistics nodes to a data tree.
+ *
+ * @param[in] stats Statistics to read.
+ * @param[in] parent Parent node of the new nodes.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_module_srmon_latency(sr_latency_stats_t *stats, struct lyd_node *parent)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *sr_bucket;
+    uint64_t bound;
+    uint32_t i;
+    char buf[22];
+    const struct ly_ctx *ly_ctx = LYD_CTX(parent);
+
+    /* count */
+    sprintf(buf, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(stats->count));
+    SR_CHECK_LY_RET(lyd_new_term(parent, NULL, "count", buf, 0, NULL), ly_ctx, err_info);
+
+    /* total-time */
+    sprintf(buf, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(stats->sum_usec));
+    SR_CHECK_LY_RET(lyd_new_term(parent, NULL, "total-time", buf, 0, NULL), ly_ctx, err_info);
+
+    /* max-time */
+    sprintf(buf, "%" PRIu32, (uint32_t)ATOMIC_LOAD_RELAXED(stats->max_usec));
+    SR_CHECK_LY_RET(lyd_new_term(parent, NULL, "max-time", buf, 0, NULL), ly_ctx, err_info);
+
+    /* bucket */
+    bound = 100;
+    for (i = 0; i < SR_LATENCY_BUCKET_COUNT; ++i) {
+        if (i < SR_LATENCY_BUCKET_COUNT - 1) {
+            sprintf(buf, "%" PRIu64, bound);
+            bound *= 10;
+        } else {
+            strcpy(buf, "infinity");
+        }
+        SR_CHECK_LY_RET(lyd_new_list(parent, NULL, "bucket", 0, &sr_bucket, buf), ly_ctx, err_info);
+
+        sprintf(buf, "%" PRIu64, (uint64_t)ATOMIC_LOAD_RELAXED(stats->buckets[i]));
+        SR_CHECK_LY_RET(lyd_new_term(sr_bucket, NULL, "count", buf, 0, NULL), ly_ctx, err_info);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add module DS plugin call statistics nodes of a datastore to a data tree.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] shm_mod SHM module to read from.
+ * @param[in] ds Datastore of the statistics.
+ * @param[in] sr_mod Module node to append to.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_module_srmon_ds_stats(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_datastore_t ds, struct lyd_node *sr_mod)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *sr_store = NULL, *node, *sr_cont;
+    sr_latency_stats_t *load = &shm_mod->ds_stats[ds].load, *store = &shm_mod->ds_stats[ds].store;
+    const struct ly_ctx *ly_ctx = LYD_CTX(sr_mod);
+
+    if (!ATOMIC_LOAD_RELAXED(load->count) && !ATOMIC_LOAD_RELAXED(store->count)) {
+        /* the plugin was not used */
+        return NULL;
+    }
+
+    /* find the datastore or create it */
+    LY_LIST_FOR(lyd_child(sr_mod), node) {
+        if (!strcmp(LYD_NAME(node), "datastore") && !strcmp(lyd_get_value(lyd_child(node)), sr_ds2ident(ds))) {
+            sr_store = node;
+            break;
+        }
+    }
+    if (!sr_store) {
+        SR_CHECK_LY_RET(lyd_new_list(sr_mod, NULL, "datastore", 0, &sr_store, sr_ds2ident(ds)), ly_ctx, err_info);
+    }
+
+    /* plugin */
+    SR_CHECK_LY_RET(lyd_new_term(sr_store, NULL, "plugin", conn->mod_shm.addr + shm_mod->plugins[ds], 0, NULL),
+            ly_ctx, err_info);
+
+    /* load-time */
+    if (ATOMIC_LOAD_RELAXED(load->count)) {
+        SR_CHECK_LY_RET(lyd_new_inner(sr_store, NULL, "load-time", 0, &sr_cont), ly_ctx, err_info);
+        if ((err_info = sr_modinfo_module_srmon_latency(load, sr_cont))) {
+            return err_info;
+        }
+    }
+
+    /* store-time */
+    if (ATOMIC_LOAD_RELAXED(store->count)) {
+        SR_CHECK_LY_RET(lyd_new_inner(sr_store, NULL, "store-time", 0, &sr_cont), ly_ctx, err_info);
+        if ((err_info = sr_modinfo_module_srmon_latency(store, sr_cont))) {
+            return err_info;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add subscription event processing statistics nodes to a data tree.
+ *
+ * @param[in] stats Statistics to read.
+ * @param[in] sr_sub Subscription node of sysrepo-monitoring.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_module_srmon_sub_stats(sr_sub_stats_t *stats, struct lyd_node *sr_sub)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *sr_stats;
+    const struct ly_ctx *ly_ctx = LYD_CTX(sr_sub);
+
+    if (!ATOMIC_LOAD_RELAXED(stats->callback.count)) {
+        /* no events processed yet */
+        return NULL;
+    }
+
+    /* queue-time */
+    SR_CHECK_LY_RET(lyd_new_inner(sr_sub, NULL, "queue-time", 0, &sr_stats), ly_ctx, err_info);
+    if ((err_info = sr_modinfo_module_srmon_latency(&stats->queue, sr_stats))) {
+        return err_info;
+    }
+
+    /* callback-time */
+    SR_CHECK_LY_RET(lyd_new_inner(sr_sub, NULL, "callback-time", 0, &sr_stats), ly_ctx, err_info);
+    if ((err_info = sr_modinfo_module_srmon_latency(&stats->callback, sr_stats))) {
+        return err_info;
+    }
+
+    return NULL;
+}
+
 /**
  * @brief Append a "subscriptions" data node with the specific subscriptions to sysrepo-monitoring module data.
  *
@@ -1590,6 +2381,11 @@ sr_modinfo_module_srmon_module_subs(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, stru
             /* suspended */
             sprintf(buf, "%s", ATOMIC_LOAD_RELAXED(change_subs[i].suspended) ? "true" : "false");
             SR_CHECK_LY_GOTO(lyd_new_term(sr_sub, NULL, "suspended", buf, 0, NULL), ly_ctx, err_info, change_ext_sub_unlock);
+
+            /* queue-time, callback-time */
+            if ((err_info = sr_modinfo_module_srmon_sub_stats(&change_subs[i].stats, sr_sub))) {
+                goto change_ext_sub_unlock;
+            }
         }
 
 change_ext_sub_unlock:
@@ -1638,6 +2434,11 @@ change_sub_unlock:
             /* suspended */
             sprintf(buf, "%s", ATOMIC_LOAD_RELAXED(xpath_sub->suspended) ? "true" : "false");
             SR_CHECK_LY_GOTO(lyd_new_term(sr_sub, NULL, "suspended", buf, 0, NULL), ly_ctx, err_info, operget_ext_sub_unlock);
+
+            /* queue-time, callback-time */
+            if ((err_info = sr_modinfo_module_srmon_sub_stats(&xpath_sub->stats, sr_sub))) {
+                goto operget_ext_sub_unlock;
+            }
         }
     }
 
@@ -1722,6 +2523,11 @@ operpoll_sub_unlock:
         /* suspended */
         sprintf(buf, "%s", ATOMIC_LOAD_RELAXED(notif_subs[i].suspended) ? "true" : "false");
         SR_CHECK_LY_GOTO(lyd_new_term(sr_sub, NULL, "suspended", buf, 0, NULL), ly_ctx, err_info, notif_ext_sub_unlock);
+
+        /* queue-time, callback-time */
+        if ((err_info = sr_modinfo_module_srmon_sub_stats(&notif_subs[i].stats, sr_sub))) {
+            goto notif_ext_sub_unlock;
+        }
     }
 
 notif_ext_sub_unlock:
@@ -1735,23 +2541,146 @@ notif_sub_unlock:
     return err_info;
 }
 
+/**
+ * @brief Append "commit-phase" data nodes with the latency statistics of a module to sysrepo-monitoring data.
+ *
+ * @param[in] shm_mod SHM module to read from.
+ * @param[in,out] sr_mod Module list node of sysrepo-monitoring.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_module_srmon_commit_stats(sr_mod_t *shm_mod, struct lyd_node *sr_mod)
+{
+    sr_error_info_t *err_info = NULL;
+    const char *phase_names[] = {"edit", "validate", "update", "change", "done", "store"};
+    sr_latency_stats_t *stats;
+    struct lyd_node *sr_phase;
+    uint32_t phase;
+    const struct ly_ctx *ly_ctx = LYD_CTX(sr_mod);
+
+    assert((sizeof phase_names / sizeof *phase_names) == SR_COMMIT_PHASE_COUNT);
+
+    for (phase = 0; phase < SR_COMMIT_PHASE_COUNT; ++phase) {
+        stats = &shm_mod->commit_stats[phase];
+        if (!ATOMIC_LOAD_RELAXED(stats->count)) {
+            /* never performed */
+            continue;
+        }
+
+        /* commit-phase with name */
+        SR_CHECK_LY_RET(lyd_new_list(sr_mod, NULL, "commit-phase", 0, &sr_phase, phase_names[phase]), ly_ctx, err_info);
+
+        if ((err_info = sr_modinfo_module_srmon_latency(stats, sr_phase))) {
+            return err_info;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Check whether specific operational data are required for a module.
+ *
+ * @param[in] mod Module with all requested XPaths.
+ * @param[out] required Whether the oper data are required or not.
+ * @param[in] sub_xpath_fmt Operational subscription XPath format.
+ * @param[in] ... Format parameters of @p sub_xpath_fmt.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_module_data_oper_required(struct sr_mod_info_mod_s *mod, int *required, const char *sub_xpath_fmt, ...)
+{
+    sr_error_info_t *err_info = NULL;
+    va_list ap;
+    char *xpath = NULL;
+    uint32_t i;
+    int req;
+
+    *required = 1;
+
+    /* print sub_xpath */
+    va_start(ap, sub_xpath_fmt);
+    if (vasprintf(&xpath, sub_xpath_fmt, ap) == -1) {
+        SR_ERRINFO_MEM(&err_info);
+        goto cleanup;
+    }
+
+    /* check all the xpaths */
+    for (i = 0; i < mod->xpath_count; ++i) {
+        if ((err_info = sr_xpath_oper_data_required(mod->xpaths[i], xpath, &req))) {
+            goto cleanup;
+        }
+        if (req) {
+            /* required */
+            goto cleanup;
+        }
+    }
+
+    /* not required */
+    *required = 0;
+
+cleanup:
+    va_end(ap);
+    free(xpath);
+    return err_info;
+}
+
+/**
+ * @brief Add held lock nodes of a module and/or their statistics, if required, to a data tree.
+ *
+ * @param[in] mod Mod info module of sysrepo-monitoring with the requested XPaths.
+ * @param[in] rwlock Lock to read.
+ * @param[in] list_name List node name of the held locks.
+ * @param[in] req_stats Whether the lock statistics are required.
+ * @param[in] sr_mod Module node of sysrepo-monitoring.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_module_srmon_module_locks(struct sr_mod_info_mod_s *mod, sr_rwlock_t *rwlock, const char *list_name,
+        int req_stats, struct lyd_node *sr_mod)
+{
+    sr_error_info_t *err_info = NULL;
+    int req;
+
+    if ((err_info = sr_modinfo_module_data_oper_required(mod, &req, "/sysrepo-monitoring:sysrepo-state/module/%s",
+            list_name))) {
+        return err_info;
+    }
+
+    if (req) {
+        /* held locks with the statistics */
+        err_info = sr_modinfo_module_srmon_locks(rwlock, list_name, sr_mod);
+    } else if (req_stats) {
+        /* only the statistics */
+        err_info = sr_modinfo_module_srmon_lock_stats(rwlock, list_name, sr_mod);
+    }
+
+    return err_info;
+}
+
 /**
  * @brief Append a "module" data node with its subscriptions to sysrepo-monitoring data.
  *
+ * Only the children required by the request XPaths are generated.
+ *
  * @param[in] conn Connection to use.
+ * @param[in] mod Mod info module of sysrepo-monitoring with the requested XPaths.
  * @param[in] shm_mod SHM module to read from.
  * @param[in,out] sr_state Main container node of sysrepo-monitoring.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_modinfo_module_srmon_module(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, struct lyd_node *sr_state)
+sr_modinfo_module_srmon_module(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod, sr_mod_t *shm_mod,
+        struct lyd_node *sr_state)
 {
     sr_error_info_t *err_info = NULL;
     struct lyd_node *sr_mod, *sr_ds_lock;
     sr_datastore_t ds;
     struct sr_mod_lock_s *shm_lock;
+    int req_stats, req;
 
 #define BUF_LEN 128
+#define SRMON_MOD_PATH "/sysrepo-monitoring:sysrepo-state/module/"
     char buf[BUF_LEN], *str = NULL;
     const struct ly_ctx *ly_ctx = LYD_CTX(sr_state);
 
@@ -1759,23 +2688,53 @@ sr_modinfo_module_srmon_module(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, struct ly
     SR_CHECK_LY_RET(lyd_new_list(sr_state, NULL, "module", 0, &sr_mod, conn->mod_shm.addr + shm_mod->name), ly_ctx,
             err_info);
 
-    /* last-modified */
-    for (ds = 0; ds < SR_DS_COUNT; ++ds) {
+    /* lock statistics are generated for several locks */
+    if ((err_info = sr_modinfo_module_data_oper_required(mod, &req_stats, SRMON_MOD_PATH "lock-stats"))) {
+        return err_info;
+    }
+
+    /* last-modified and DS plugin statistics */
+    if ((err_info = sr_modinfo_module_data_oper_required(mod, &req, SRMON_MOD_PATH "datastore"))) {
+        return err_info;
+    }
+    for (ds = 0; req && (ds < SR_DS_COUNT); ++ds) {
         if ((err_info = sr_modinfo_module_srmon_datastore(conn, shm_mod, ds, sr_mod))) {
             return err_info;
         }
+        if ((err_info = sr_modinfo_module_srmon_ds_stats(conn, shm_mod, ds, sr_mod))) {
+            return err_info;
+        }
     }
 
+    /* data-lock */
+    if ((err_info = sr_modinfo_module_data_oper_required(mod, &req, SRMON_MOD_PATH "data-lock"))) {
+        return err_info;
+    }
     for (ds = 0; ds < SR_DS_COUNT; ++ds) {
         shm_lock = &shm_mod->data_lock_info[ds];
 
-        /* data-lock */
-        snprintf(buf, BUF_LEN, "data-lock[cid='%%" PRIu32 "'][datastore='%s']/mode", sr_ds2ident(ds));
-        err_info = sr_modinfo_module_srmon_locks_ds(&shm_lock->data_lock, conn->cid, buf, sr_mod);
+        if (req) {
+            snprintf(buf, BUF_LEN, "data-lock[cid='%%" PRIu32 "'][datastore='%s']/mode", sr_ds2ident(ds));
+            if ((err_info = sr_modinfo_module_srmon_locks_ds(&shm_lock->data_lock, conn->cid, buf, sr_mod))) {
+                return err_info;
+            }
+        }
 
-        if (err_info) {
-            return err_info;
+        /* data-lock stats */
+        if (req_stats) {
+            snprintf(buf, BUF_LEN, "data-lock/%s", sr_ds2str(ds));
+            if ((err_info = sr_modinfo_module_srmon_lock_stats(&shm_lock->data_lock, buf, sr_mod))) {
+                return err_info;
+            }
         }
+    }
+
+    /* ds-lock */
+    if ((err_info = sr_modinfo_module_data_oper_required(mod, &req, SRMON_MOD_PATH "ds-lock"))) {
+        return err_info;
+    }
+    for (ds = 0; req && (ds < SR_DS_COUNT); ++ds) {
+        shm_lock = &shm_mod->data_lock_info[ds];
 
         /* DS LOCK */
         if ((err_info = sr_mlock(&shm_lock->ds_lock, SR_DS_LOCK_MUTEX_TIMEOUT, __func__, NULL, NULL))) {
@@ -1811,33 +2770,61 @@ ds_unlock:
     }
 
     /* change-sub-lock */
+    if ((err_info = sr_modinfo_module_data_oper_required(mod, &req, SRMON_MOD_PATH "change-sub-lock"))) {
+        return err_info;
+    }
     for (ds = 0; ds < SR_DS_COUNT; ++ds) {
-        snprintf(buf, BUF_LEN, "change-sub-lock[cid='%%" PRIu32 "'][datastore='%s']/mode", sr_ds2ident(ds));
-        if ((err_info = sr_modinfo_module_srmon_locks_ds(&shm_mod->change_sub[ds].lock, 0, buf, sr_mod))) {
-            return err_info;
+        if (req) {
+            snprintf(buf, BUF_LEN, "change-sub-lock[cid='%%" PRIu32 "'][datastore='%s']/mode", sr_ds2ident(ds));
+            if ((err_info = sr_modinfo_module_srmon_locks_ds(&shm_mod->change_sub[ds].lock, 0, buf, sr_mod))) {
+                return err_info;
+            }
+        }
+
+        /* change-sub-lock stats */
+        if (req_stats) {
+            snprintf(buf, BUF_LEN, "change-sub-lock/%s", sr_ds2str(ds));
+            if ((err_info = sr_modinfo_module_srmon_lock_stats(&shm_mod->change_sub[ds].lock, buf, sr_mod))) {
+                return err_info;
+            }
         }
     }
 #undef BUF_LEN
 
     /* oper-get-sub-lock */
-    if ((err_info = sr_modinfo_module_srmon_locks(&shm_mod->oper_get_lock, "oper-get-sub-lock", sr_mod))) {
+    if ((err_info = sr_modinfo_module_srmon_module_locks(mod, &shm_mod->oper_get_lock, "oper-get-sub-lock", req_stats,
+            sr_mod))) {
         return err_info;
     }
 
     /* oper-poll-sub-lock */
-    if ((err_info = sr_modinfo_module_srmon_locks(&shm_mod->oper_poll_lock, "oper-poll-sub-lock", sr_mod))) {
+    if ((err_info = sr_modinfo_module_srmon_module_locks(mod, &shm_mod->oper_poll_lock, "oper-poll-sub-lock",
+            req_stats, sr_mod))) {
         return err_info;
     }
 
     /* notif-sub-lock */
-    if ((err_info = sr_modinfo_module_srmon_locks(&shm_mod->notif_lock, "notif-sub-lock", sr_mod))) {
+    if ((err_info = sr_modinfo_module_srmon_module_locks(mod, &shm_mod->notif_lock, "notif-sub-lock", req_stats,
+            sr_mod))) {
         return err_info;
     }
 
     /* module subscriptions */
-    if ((err_info = sr_modinfo_module_srmon_module_subs(conn, shm_mod, sr_mod))) {
+    if ((err_info = sr_modinfo_module_data_oper_required(mod, &req, SRMON_MOD_PATH "subscriptions"))) {
         return err_info;
     }
+    if (req && (err_info = sr_modinfo_module_srmon_module_subs(conn, shm_mod, sr_mod))) {
+        return err_info;
+    }
+
+    /* commit-phase */
+    if ((err_info = sr_modinfo_module_data_oper_required(mod, &req, SRMON_MOD_PATH "commit-phase"))) {
+        return err_info;
+    }
+    if (req && (err_info = sr_modinfo_module_srmon_commit_stats(shm_mod, sr_mod))) {
+        return err_info;
+    }
+#undef SRMON_MOD_PATH
 
     return NULL;
 }
@@ -1890,6 +2877,11 @@ sr_modinfo_module_srmon_rpc(sr_conn_ctx_t *conn, sr_rpc_t *shm_rpc, struct lyd_n
         /* suspended */
         sprintf(buf, "%s", ATOMIC_LOAD_RELAXED(rpc_sub[i].suspended) ? "true" : "false");
         SR_CHECK_LY_RET(lyd_new_term(sr_sub, NULL, "suspended", buf, 0, NULL), ly_ctx, err_info);
+
+        /* queue-time, callback-time */
+        if ((err_info = sr_modinfo_module_srmon_sub_stats(&rpc_sub[i].stats, sr_sub))) {
+            return err_info;
+        }
     }
 
     if (!lyd_child(sr_rpc)->next) {
@@ -1940,63 +2932,16 @@ sr_modinfo_module_srmon_connections(struct lyd_node *sr_state)
 }
 
 /**
- * @brief Check whether specific operational data are required for a module.
+ * @brief Load module data of the sysrepo-monitoring module. They are actually generated.
  *
- * @param[in] mod Module with all requested XPaths.
- * @param[out] required Whether the oper data are required or not.
- * @param[in] sub_xpath_fmt Operational subscription XPath format.
- * @param[in] ... Format parameters of @p sub_xpath_fmt.
+ * SHM READ lock is expected to be held.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] mod Mod info module to use.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_modinfo_module_data_oper_required(struct sr_mod_info_mod_s *mod, int *required, const char *sub_xpath_fmt, ...)
-{
-    sr_error_info_t *err_info = NULL;
-    va_list ap;
-    char *xpath = NULL;
-    uint32_t i;
-    int req;
-
-    *required = 1;
-
-    /* print sub_xpath */
-    va_start(ap, sub_xpath_fmt);
-    if (vasprintf(&xpath, sub_xpath_fmt, ap) == -1) {
-        SR_ERRINFO_MEM(&err_info);
-        goto cleanup;
-    }
-
-    /* check all the xpaths */
-    for (i = 0; i < mod->xpath_count; ++i) {
-        if ((err_info = sr_xpath_oper_data_required(mod->xpaths[i], xpath, &req))) {
-            goto cleanup;
-        }
-        if (req) {
-            /* required */
-            goto cleanup;
-        }
-    }
-
-    /* not required */
-    *required = 0;
-
-cleanup:
-    va_end(ap);
-    free(xpath);
-    return err_info;
-}
-
-/**
- * @brief Load module data of the sysrepo-monitoring module. They are actually generated.
- *
- * SHM READ lock is expected to be held.
- *
- * @param[in] mod_info Mod info to use.
- * @param[in] mod Mod info module to use.
- * @return err_info, NULL on success.
- */
-static sr_error_info_t *
-sr_modinfo_module_data_load_srmon(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod)
+sr_modinfo_module_data_load_srmon(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod)
 {
     sr_error_info_t *err_info = NULL;
     struct lyd_node *mod_data;
@@ -2026,7 +2971,7 @@ sr_modinfo_module_data_load_srmon(struct sr_mod_info_s *mod_info, struct sr_mod_
                 goto cleanup;
             }
 
-            if (req && (err_info = sr_modinfo_module_srmon_module(mod_info->conn, shm_mod, mod_data))) {
+            if (req && (err_info = sr_modinfo_module_srmon_module(mod_info->conn, mod, shm_mod, mod_data))) {
                 goto cleanup;
             }
         }
@@ -2053,6 +2998,15 @@ sr_modinfo_module_data_load_srmon(struct sr_mod_info_s *mod_info, struct sr_mod_
         }
     }
 
+    /* context lock statistics */
+    if ((err_info = sr_modinfo_module_data_oper_required(mod, &req, "/sysrepo-monitoring:sysrepo-state/lock-stats"))) {
+        goto cleanup;
+    }
+    if (req && (err_info = sr_modinfo_module_srmon_lock_stats(&SR_CONN_MAIN_SHM(mod_info->conn)->context_lock,
+            "context-lock", mod_data))) {
+        goto cleanup;
+    }
+
     /* connections */
     if ((err_info = sr_modinfo_module_data_oper_required(mod, &req, "/sysrepo-monitoring:sysrepo-state/connection"))) {
         goto cleanup;
@@ -2073,6 +3027,192 @@ cleanup:
     return err_info;
 }
 
+/**
+ * @brief Append stored DS data of a mod info module. Running data are taken from the shared snapshot, if possible.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mod Mod info module to load.
+ * @param[in] ds Datastore of the data.
+ * @param[in,out] data Data tree to append to.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_module_ds_data_append(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod, sr_datastore_t ds,
+        struct lyd_node **data)
+{
+    if (SR_RUN_SHM_SNAPSHOT && (ds == SR_DS_RUNNING) && sr_run_snapshot_load(mod->ly_mod, conn->content_id,
+            ATOMIC_LOAD_RELAXED(mod->shm_mod->run_data_ver), data)) {
+        return NULL;
+    }
+
+    return sr_module_file_data_append(mod->shm_mod, mod->ly_mod, mod->ds_plg, ds, mod->xpaths, mod->xpath_count,
+            data);
+}
+
+/**
+ * @brief Learn the current key of the operational view of a module. Needs to be called before any module data
+ * are loaded.
+ *
+ * @param[in] mod Mod info module.
+ * @param[in] get_oper_opts Get oper data options.
+ * @param[out] key Operational view cache key, without any data.
+ */
+static void
+sr_modinfo_oper_view_key(struct sr_mod_info_mod_s *mod, sr_get_oper_flag_t get_oper_opts,
+        struct sr_oper_view_cache_s *key)
+{
+    memset(key, 0, sizeof *key);
+
+    key->mod = mod->ly_mod;
+    key->run_data_ver = ATOMIC_LOAD_RELAXED(mod->shm_mod->run_data_ver);
+    key->oper_data_ver = ATOMIC_LOAD_RELAXED(mod->shm_mod->oper_data_ver);
+    key->run_sub_ver = ATOMIC_LOAD_RELAXED(mod->shm_mod->run_sub_ver);
+
+    /* only these options affect the view */
+    key->get_oper_opts = get_oper_opts & (SR_OPER_WITH_ORIGIN | SR_OPER_NO_STORED);
+}
+
+/**
+ * @brief Free an operational view cache entry.
+ *
+ * @param[in] cmod Cache entry to free.
+ */
+static void
+sr_modinfo_oper_view_free(struct sr_oper_view_cache_s *cmod)
+{
+    lyd_free_siblings(cmod->data);
+    free(cmod->cids);
+    memset(cmod, 0, sizeof *cmod);
+}
+
+/**
+ * @brief Get a copy of the cached operational view of a module, if current.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mod Mod info module.
+ * @param[in] key Current key of the module view.
+ * @param[out] data Copy of the module view.
+ * @param[out] found Whether a current view was found.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_oper_view_get(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod, const struct sr_oper_view_cache_s *key,
+        struct lyd_node **data, int *found)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_oper_view_cache_s *cmod;
+    uint32_t idx, i;
+
+    *data = NULL;
+    *found = 0;
+
+    /* get the index of the cache mod */
+    idx = mod->shm_mod - SR_SHM_MOD_IDX(conn->mod_shm.addr, 0);
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->oper_view_lock, SR_CONN_OPER_VIEW_LOCK_TIMEOUT, __func__, NULL, NULL))) {
+        return err_info;
+    }
+
+    if (idx >= conn->oper_view_mod_count) {
+        /* not cached */
+        goto cleanup_unlock;
+    }
+    cmod = &conn->oper_view_mods[idx];
+
+    if ((cmod->mod != key->mod) || (cmod->run_data_ver != key->run_data_ver) ||
+            (cmod->oper_data_ver != key->oper_data_ver) || (cmod->run_sub_ver != key->run_sub_ver) ||
+            (cmod->get_oper_opts != key->get_oper_opts)) {
+        /* not current */
+        goto cleanup_unlock;
+    }
+
+    for (i = 0; i < cmod->cid_count; ++i) {
+        if (!sr_conn_is_alive(cmod->cids[i])) {
+            /* stored operational data of this connection will be removed */
+            sr_modinfo_oper_view_free(cmod);
+            goto cleanup_unlock;
+        }
+    }
+
+    /* return a copy of the view */
+    if (cmod->data && lyd_dup_siblings(cmod->data, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, data)) {
+        sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, NULL);
+        goto cleanup_unlock;
+    }
+    *found = 1;
+
+cleanup_unlock:
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->oper_view_lock);
+
+    return err_info;
+}
+
+/**
+ * @brief Store the operational view of a module in the cache.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mod Mod info module.
+ * @param[in] key Key of the module view learned before its data were loaded.
+ * @param[in] data Data tree with the module view.
+ * @param[in] cids Owner connections of the stored operational data in the view, are spent.
+ * @param[in] cid_count Count of @p cids.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_oper_view_store(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod, const struct sr_oper_view_cache_s *key,
+        struct lyd_node **data, sr_cid_t *cids, uint32_t cid_count)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_oper_view_cache_s *cmod;
+    uint32_t idx, mod_count;
+    void *mem;
+
+    /* get the index of the cache mod */
+    idx = mod->shm_mod - SR_SHM_MOD_IDX(conn->mod_shm.addr, 0);
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->oper_view_lock, SR_CONN_OPER_VIEW_LOCK_TIMEOUT, __func__, NULL, NULL))) {
+        free(cids);
+        return err_info;
+    }
+
+    if (idx >= conn->oper_view_mod_count) {
+        /* enlarge the cache for all the modules */
+        mod_count = SR_CONN_MOD_SHM(conn)->mod_count;
+        assert(idx < mod_count);
+        mem = realloc(conn->oper_view_mods, mod_count * sizeof *conn->oper_view_mods);
+        if (!mem) {
+            free(cids);
+            SR_ERRINFO_MEM(&err_info);
+            goto cleanup_unlock;
+        }
+        conn->oper_view_mods = mem;
+        memset(conn->oper_view_mods + conn->oper_view_mod_count, 0,
+                (mod_count - conn->oper_view_mod_count) * sizeof *conn->oper_view_mods);
+        conn->oper_view_mod_count = mod_count;
+    }
+    cmod = &conn->oper_view_mods[idx];
+
+    /* replace any previous view */
+    sr_modinfo_oper_view_free(cmod);
+    *cmod = *key;
+    cmod->cids = cids;
+    cmod->cid_count = cid_count;
+    if ((err_info = sr_lyd_get_module_data(data, mod->ly_mod, 1, 1, &cmod->data))) {
+        /* the view may be incomplete */
+        sr_modinfo_oper_view_free(cmod);
+        goto cleanup_unlock;
+    }
+
+cleanup_unlock:
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->oper_view_lock);
+
+    return err_info;
+}
+
 /**
  * @brief Load module data of a specific module.
  *
@@ -2083,20 +3223,43 @@ cleanup:
  * @param[in] timeout_ms Operational callback timeout in milliseconds.
  * @param[in] get_oper_opts Get oper data options.
  * @param[in] run_cached_data_cur Whether any cached running data in @p conn are usable and current.
+ * @param[in,out] ds_data Optional already loaded DS data of the module, are spent. If not set, they are loaded.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
 sr_modinfo_module_data_load(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod, const char *orig_name,
-        const void *orig_data, uint32_t timeout_ms, sr_get_oper_flag_t get_oper_opts, int run_cached_data_cur)
+        const void *orig_data, uint32_t timeout_ms, sr_get_oper_flag_t get_oper_opts, int run_cached_data_cur,
+        struct lyd_node **ds_data)
 {
     sr_error_info_t *err_info = NULL;
     sr_conn_ctx_t *conn = mod_info->conn;
     struct lyd_node *mod_data = NULL;
-    int r, modified;
+    struct sr_oper_view_cache_s view_key;
+    sr_cid_t *cids = NULL;
+    uint32_t cid_count = 0;
+    int r, modified, use_view = 0, found;
 
     assert(!mod_info->data_cached);
     assert((mod_info->ds != SR_DS_OPERATIONAL) || (mod_info->ds2 != SR_DS_OPERATIONAL));
 
+    if ((mod_info->ds == SR_DS_OPERATIONAL) && (conn->opts & SR_CONN_CACHE_OPER_VIEW) &&
+            strcmp(mod->ly_mod->name, "ietf-yang-library") && strcmp(mod->ly_mod->name, "sysrepo-monitoring")) {
+        /* learn the view key before the data are loaded, it is valid only for the full module data */
+        sr_modinfo_oper_view_key(mod, get_oper_opts, &view_key);
+        use_view = run_cached_data_cur || !mod->xpath_count;
+
+        /* try to use the cached view, it can be used even for only some module data */
+        if ((err_info = sr_modinfo_oper_view_get(conn, mod, &view_key, &mod_data, &found))) {
+            return err_info;
+        }
+        if (found) {
+            if (mod_data) {
+                lyd_insert_sibling(mod_info->data, mod_data, &mod_info->data);
+            }
+            goto oper_subs;
+        }
+    }
+
     if (run_cached_data_cur) {
         /* there are cached data */
         switch (mod_info->ds) {
@@ -2136,10 +3299,17 @@ sr_modinfo_module_data_load(struct sr_mod_info_s *mod_info, struct sr_mod_info_m
     if (!run_cached_data_cur) {
         /* no cached data or unusable */
 
-        /* get current DS data (ds2 is running when getting operational data) */
-        if ((err_info = sr_module_file_data_append(mod->ly_mod, mod->ds_plg, mod_info->ds2, mod->xpaths,
-                mod->xpath_count, &mod_info->data))) {
-            return err_info;
+        if (ds_data) {
+            /* use the loaded DS data */
+            if (*ds_data) {
+                lyd_insert_sibling(mod_info->data, *ds_data, &mod_info->data);
+                *ds_data = NULL;
+            }
+        } else {
+            /* get current DS data (ds2 is running when getting operational data) */
+            if ((err_info = sr_modinfo_module_ds_data_append(conn, mod, mod_info->ds2, &mod_info->data))) {
+                return err_info;
+            }
         }
 
         if (mod_info->ds == SR_DS_OPERATIONAL) {
@@ -2167,9 +3337,27 @@ sr_modinfo_module_data_load(struct sr_mod_info_s *mod_info, struct sr_mod_info_m
             }
         }
 
+        if (!(get_oper_opts & SR_OPER_NO_STORED)) {
+            /* apply any stored operational data */
+            if ((err_info = sr_module_oper_data_stored_apply(conn, mod, use_view ? &cids : NULL, &cid_count,
+                    &mod_info->data))) {
+                return err_info;
+            }
+        }
+
+        if (use_view) {
+            /* remember the view of the module */
+            if ((err_info = sr_modinfo_oper_view_store(conn, mod, &view_key, &mod_info->data, cids, cid_count))) {
+                return err_info;
+            }
+        }
+    }
+
+oper_subs:
+    if (mod_info->ds == SR_DS_OPERATIONAL) {
         /* append any operational data provided by clients */
         if ((err_info = sr_module_oper_data_update(mod, orig_name, orig_data, conn, timeout_ms, get_oper_opts,
-                &mod_info->data))) {
+                mod_info->oper_max_depth, mod_info->oper_limit, &mod_info->data))) {
             return err_info;
         }
 
@@ -2213,7 +3401,10 @@ sr_modinfo_mod_new(const struct lys_module *ly_mod, uint32_t mod_type, struct sr
                 mod->state |= mod_type;
             }
             if (new) {
-                /* new module, needs it members filled */
+                /* new module, needs it members filled, keep its type if it was already added */
+                if ((mod->state & MOD_INFO_TYPE_MASK & ~MOD_INFO_NEW) > mod_type) {
+                    mod_type = mod->state & MOD_INFO_TYPE_MASK & ~MOD_INFO_NEW;
+                }
                 break;
             }
             return NULL;
@@ -2327,6 +3518,140 @@ sr_modinfo_qsort_cmp(const void *ptr1, const void *ptr2)
     return 0;
 }
 
+#if SR_DATA_LOAD_THREADS > 0
+
+/**
+ * @brief DS data of a single module loaded in parallel.
+ */
+struct sr_modinfo_ds_load_s {
+    struct sr_mod_info_mod_s *mod;  /**< Mod info module. */
+    struct lyd_node *data;          /**< Loaded module DS data. */
+    sr_error_info_t *err_info;      /**< Error info of the load. */
+};
+
+/**
+ * @brief Shared state of the parallel DS data load threads.
+ */
+struct sr_modinfo_ds_load_pool_s {
+    struct sr_modinfo_ds_load_s *loads; /**< Module DS data to load. */
+    uint32_t count;                 /**< Count of @p loads. */
+    sr_conn_ctx_t *conn;            /**< Connection to use. */
+    sr_datastore_t ds;              /**< Datastore to load the data from. */
+    ATOMIC_T next;                  /**< Index of the next module to load. */
+};
+
+/**
+ * @brief Thread loading DS data of the modules that are not yet taken by another thread.
+ *
+ * @param[in] arg Load pool.
+ * @return Always NULL.
+ */
+static void *
+sr_modinfo_ds_load_thread(void *arg)
+{
+    struct sr_modinfo_ds_load_pool_s *pool = arg;
+    struct sr_modinfo_ds_load_s *load;
+    uint32_t i;
+
+    while ((i = ATOMIC_INC_RELAXED(pool->next)) < pool->count) {
+        load = &pool->loads[i];
+        load->err_info = sr_modinfo_module_ds_data_append(pool->conn, load->mod, pool->ds, &load->data);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Load DS data of all the modules in mod info in parallel. Only the DS plugin load callbacks are executed
+ * in the threads, the rest of the module data processing is performed sequentially in the module order.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[out] loads Loaded DS data of all the modules in mod info (by index), NULL if no parallel load was performed.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_ds_data_load_parallel(struct sr_mod_info_s *mod_info, struct sr_modinfo_ds_load_s **loads)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_modinfo_ds_load_pool_s pool = {0};
+    pthread_t tids[SR_DATA_LOAD_THREADS - 1];
+    uint32_t i, mod_count = 0, tid_count = 0;
+
+    *loads = NULL;
+
+    /* count the modules with data to load */
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        if (!(mod_info->mods[i].state & (MOD_INFO_DATA | MOD_INFO_DATA_LAZY))) {
+            ++mod_count;
+        }
+    }
+    if (mod_count < 2) {
+        /* nothing to parallelize */
+        return NULL;
+    }
+
+    /* prepare the loads */
+    pool.loads = calloc(mod_info->mod_count, sizeof *pool.loads);
+    SR_CHECK_MEM_RET(!pool.loads, err_info);
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        if (!(mod_info->mods[i].state & (MOD_INFO_DATA | MOD_INFO_DATA_LAZY))) {
+            pool.loads[pool.count++].mod = &mod_info->mods[i];
+        }
+    }
+    pool.conn = mod_info->conn;
+    pool.ds = ((mod_info->ds == SR_DS_OPERATIONAL) && (mod_info->ds2 == SR_DS_OPERATIONAL)) ? SR_DS_OPERATIONAL : mod_info->ds2;
+    ATOMIC_STORE_RELAXED(pool.next, 0);
+
+    /* start the threads, if any fails to start, the remaining ones (including this one) load its share */
+    while ((tid_count < SR_DATA_LOAD_THREADS - 1) && (tid_count < mod_count - 1)) {
+        if (pthread_create(&tids[tid_count], NULL, sr_modinfo_ds_load_thread, &pool)) {
+            break;
+        }
+        ++tid_count;
+    }
+
+    /* load in this thread as well */
+    sr_modinfo_ds_load_thread(&pool);
+
+    /* wait for all the threads */
+    for (i = 0; i < tid_count; ++i) {
+        pthread_join(tids[i], NULL);
+    }
+
+    /* collect errors */
+    for (i = 0; i < pool.count; ++i) {
+        if (pool.loads[i].err_info) {
+            sr_errinfo_merge(&err_info, pool.loads[i].err_info);
+        }
+    }
+    if (err_info) {
+        for (i = 0; i < pool.count; ++i) {
+            lyd_free_siblings(pool.loads[i].data);
+        }
+        free(pool.loads);
+        return err_info;
+    }
+
+    /* reorder the loads by mod info module index */
+    *loads = calloc(mod_info->mod_count, sizeof **loads);
+    if (!*loads) {
+        for (i = 0; i < pool.count; ++i) {
+            lyd_free_siblings(pool.loads[i].data);
+        }
+        free(pool.loads);
+        SR_ERRINFO_MEM(&err_info);
+        return err_info;
+    }
+    for (i = 0; i < pool.count; ++i) {
+        (*loads)[pool.loads[i].mod - mod_info->mods] = pool.loads[i];
+    }
+    free(pool.loads);
+
+    return NULL;
+}
+
+#endif
+
 /**
  * @brief Load data for modules in mod info.
  *
@@ -2345,9 +3670,14 @@ sr_modinfo_data_load(struct sr_mod_info_s *mod_info, int cache, const char *orig
     sr_error_info_t *err_info = NULL;
     sr_conn_ctx_t *conn;
     struct sr_mod_info_mod_s *mod;
+    struct lyd_node **ds_data = NULL;
     uint32_t i;
     int run_data_cache_cur = 0;
 
+#if SR_DATA_LOAD_THREADS > 0
+    struct sr_modinfo_ds_load_s *loads = NULL;
+#endif
+
     conn = mod_info->conn;
 
     /* CACHE READ LOCK */
@@ -2378,24 +3708,45 @@ sr_modinfo_data_load(struct sr_mod_info_s *mod_info, int cache, const char *orig
         }
     }
 
+#if SR_DATA_LOAD_THREADS > 0
+    if (!run_data_cache_cur) {
+        /* load DS data of all the modules in parallel */
+        if ((err_info = sr_modinfo_ds_data_load_parallel(mod_info, &loads))) {
+            goto cleanup;
+        }
+    }
+#endif
+
     /* load data for each module */
     for (i = 0; i < mod_info->mod_count; ++i) {
         mod = &mod_info->mods[i];
         if (mod->state & MOD_INFO_DATA) {
             /* module data were already loaded */
             continue;
+        } else if (mod->state & MOD_INFO_DATA_LAZY) {
+            /* module data will be loaded only if needed */
+            continue;
         }
 
+#if SR_DATA_LOAD_THREADS > 0
+        ds_data = loads ? &loads[i].data : NULL;
+#endif
+
         if ((mod_info->ds == SR_DS_OPERATIONAL) && (mod_info->ds2 == SR_DS_OPERATIONAL)) {
             /* special case when we are not working with data but with edit */
             assert(!mod->xpath_count);
-            if ((err_info = sr_module_file_data_append(mod->ly_mod, mod->ds_plg, SR_DS_OPERATIONAL, NULL, 0,
-                    &mod_info->data))) {
+            if (ds_data) {
+                if (*ds_data) {
+                    lyd_insert_sibling(mod_info->data, *ds_data, &mod_info->data);
+                    *ds_data = NULL;
+                }
+            } else if ((err_info = sr_module_file_data_append(mod->shm_mod, mod->ly_mod, mod->ds_plg,
+                    SR_DS_OPERATIONAL, NULL, 0, &mod_info->data))) {
                 goto cleanup;
             }
         } else {
             if ((err_info = sr_modinfo_module_data_load(mod_info, mod, orig_name, orig_data, timeout_ms, get_oper_opts,
-                    run_data_cache_cur))) {
+                    run_data_cache_cur, ds_data))) {
                 goto cleanup;
             }
         }
@@ -2406,6 +3757,15 @@ sr_modinfo_data_load(struct sr_mod_info_s *mod_info, int cache, const char *orig
     }
 
 cleanup:
+#if SR_DATA_LOAD_THREADS > 0
+    if (loads) {
+        /* free any data not used because of an error */
+        for (i = 0; i < mod_info->mod_count; ++i) {
+            lyd_free_siblings(loads[i].data);
+        }
+        free(loads);
+    }
+#endif
     if (!mod_info->data_cached) {
         /* CACHE READ UNLOCK */
         sr_rwunlock(&conn->run_cache_lock, SR_CONN_RUN_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
@@ -2460,45 +3820,345 @@ sr_modinfo_consolidate(struct sr_mod_info_s *mod_info, int mod_deps, sr_lock_mod
                 }
             }
         }
+
+        if (mi_opts & SR_MI_DATA_INV_DEP_LAZY) {
+            /* postpone loading data of the inverse dependencies */
+            for (i = 0; i < mod_info->mod_count; ++i) {
+                if (((mod_info->mods[i].state & MOD_INFO_TYPE_MASK) == MOD_INFO_INV_DEP) &&
+                        !(mod_info->mods[i].state & MOD_INFO_DATA)) {
+                    mod_info->mods[i].state |= MOD_INFO_DATA_LAZY;
+                }
+            }
+        }
+    }
+
+    if (!(mi_opts & SR_MI_PERM_NO)) {
+        /* check permissions */
+        if ((err_info = sr_modinfo_perm_check(mod_info, mi_opts & SR_MI_PERM_WRITE ? 1 : 0, mi_opts & SR_MI_PERM_STRICT))) {
+            goto cleanup;
+        }
+    }
+
+    /* all modules could have been removed by the permission check */
+    if (mod_info->mod_count) {
+        /* sort the modules based on their offsets in the SHM so that we have a uniform order for locking */
+        qsort(mod_info->mods, mod_info->mod_count, sizeof *mod_info->mods, sr_modinfo_qsort_cmp);
+    }
+
+    if (mod_lock) {
+        if (mod_lock == SR_LOCK_READ) {
+            /* MODULES READ LOCK */
+            if ((err_info = sr_shmmod_modinfo_rdlock(mod_info, mi_opts & SR_MI_LOCK_UPGRADEABLE, sid, timeout_ms,
+                    ds_lock_timeout_ms))) {
+                goto cleanup;
+            }
+        } else {
+            /* MODULES WRITE LOCK */
+            if ((err_info = sr_shmmod_modinfo_wrlock(mod_info, sid, timeout_ms, ds_lock_timeout_ms))) {
+                goto cleanup;
+            }
+        }
+    }
+
+    if (!(mi_opts & SR_MI_DATA_NO)) {
+        /* load all modules data */
+        if ((err_info = sr_modinfo_data_load(mod_info, mi_opts & SR_MI_DATA_CACHE, orig_name, orig_data, timeout_ms,
+                get_oper_opts))) {
+            goto cleanup;
+        }
+    }
+
+    if ((mod_lock == SR_LOCK_READ) && (mi_opts & SR_MI_DATA_RO)) {
+        /* the loaded data no longer depend on the stored ones so concurrent changes need not wait for the reader */
+
+        /* MODULES UNLOCK */
+        sr_shmmod_modinfo_unlock(mod_info);
+    }
+
+cleanup:
+    return err_info;
+}
+
+/**
+ * @brief Argument for collecting schema atoms of the data dependencies of a module.
+ */
+struct sr_modinfo_dep_atoms_dfs_arg {
+    struct ly_set *atoms;       /**< Collected schema atoms of all leafref, must, and when expressions. */
+    int instid;                 /**< Set if there is an instance-identifier with unknown target. */
+    sr_error_info_t *err_info;  /**< Error info. */
+};
+
+/**
+ * @brief Collect schema atoms of a leafref type, learn about any instance-identifiers.
+ *
+ * @param[in] type Type to examine.
+ * @param[in] node Node with the type.
+ * @param[in] arg DFS callback argument.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_dep_atoms_type(const struct lysc_type *type, const struct lysc_node *node,
+        struct sr_modinfo_dep_atoms_dfs_arg *arg)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lysc_type_leafref *lref;
+    const struct lysc_type_union *uni;
+    struct ly_set *atoms;
+    LY_ARRAY_COUNT_TYPE u;
+
+    switch (type->basetype) {
+    case LY_TYPE_INST:
+        if (((struct lysc_type_instanceid *)type)->require_instance) {
+            /* any data node can be referenced */
+            arg->instid = 1;
+        }
+        break;
+    case LY_TYPE_LEAFREF:
+        lref = (struct lysc_type_leafref *)type;
+        if (!lref->require_instance) {
+            break;
+        }
+
+        if (lys_find_expr_atoms(node, node->module, lref->path, lref->prefixes, LYS_FIND_XP_SCHEMA, &atoms)) {
+            sr_errinfo_new_ly(&err_info, node->module->ctx, NULL);
+            break;
+        }
+        ly_set_merge(arg->atoms, atoms, 0, NULL);
+        ly_set_free(atoms, NULL);
+        break;
+    case LY_TYPE_UNION:
+        uni = (struct lysc_type_union *)type;
+        LY_ARRAY_FOR(uni->types, u) {
+            if ((err_info = sr_modinfo_dep_atoms_type(uni->types[u], node, arg))) {
+                break;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+
+    return err_info;
+}
+
+/**
+ * @brief DFS callback collecting schema atoms of all the data dependencies of a module.
+ * Similar to ::sr_lydmods_add_all_deps_dfs_cb() but operations are skipped since they are never validated with data.
+ */
+static LY_ERR
+sr_modinfo_dep_atoms_dfs_cb(struct lysc_node *node, void *data, ly_bool *dfs_continue)
+{
+    struct sr_modinfo_dep_atoms_dfs_arg *arg = data;
+    struct lysc_when **when;
+    struct lysc_must *musts;
+    struct ly_set *atoms;
+    LY_ARRAY_COUNT_TYPE u;
+
+    if (node->nodetype & (LYS_RPC | LYS_ACTION | LYS_NOTIF)) {
+        *dfs_continue = 1;
+        return LY_SUCCESS;
+    }
+
+    if ((node->nodetype & (LYS_LEAF | LYS_LEAFLIST)) &&
+            (arg->err_info = sr_modinfo_dep_atoms_type(((struct lysc_node_leaf *)node)->type, node, arg))) {
+        return LY_EOTHER;
+    }
+
+    when = lysc_node_when(node);
+    LY_ARRAY_FOR(when, u) {
+        if (lys_find_expr_atoms(when[u]->context, node->module, when[u]->cond, when[u]->prefixes, LYS_FIND_XP_SCHEMA,
+                &atoms)) {
+            sr_errinfo_new_ly(&arg->err_info, node->module->ctx, NULL);
+            return LY_EOTHER;
+        }
+        ly_set_merge(arg->atoms, atoms, 0, NULL);
+        ly_set_free(atoms, NULL);
+    }
+
+    musts = lysc_node_musts(node);
+    LY_ARRAY_FOR(musts, u) {
+        if (lys_find_expr_atoms(node, node->module, musts[u].cond, musts[u].prefixes, LYS_FIND_XP_SCHEMA, &atoms)) {
+            sr_errinfo_new_ly(&arg->err_info, node->module->ctx, NULL);
+            return LY_EOTHER;
+        }
+        ly_set_merge(arg->atoms, atoms, 0, NULL);
+        ly_set_free(atoms, NULL);
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Learn whether an unchanged inverse dependency module needs to be validated, meaning whether any of
+ * the changed nodes in the diff can be referenced by its leafref, must, or when expressions.
+ *
+ * @param[in] ly_mod Inverse dependency module.
+ * @param[in] diff Diff of the changes.
+ * @param[out] validate Whether the module needs to be validated.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_inv_dep_validate_needed(const struct lys_module *ly_mod, const struct lyd_node *diff, int *validate)
+{
+    struct sr_modinfo_dep_atoms_dfs_arg arg = {0};
+    const struct lyd_node *root, *elem;
+
+    *validate = 1;
+
+    if (ly_set_new(&arg.atoms)) {
+        SR_ERRINFO_MEM(&arg.err_info);
+        return arg.err_info;
+    }
+
+    /* collect all the schema nodes the module data depend on */
+    if (lysc_module_dfs_full(ly_mod, sr_modinfo_dep_atoms_dfs_cb, &arg)) {
+        if (!arg.err_info) {
+            sr_errinfo_new_ly(&arg.err_info, ly_mod->ctx, NULL);
+        }
+        goto cleanup;
+    }
+    if (arg.instid) {
+        /* unknown dependencies */
+        goto cleanup;
+    }
+
+    /* check whether any of them was changed */
+    LY_LIST_FOR(diff, root) {
+        LYD_TREE_DFS_BEGIN(root, elem) {
+            if (elem->schema && ly_set_contains(arg.atoms, (void *)elem->schema, NULL)) {
+                goto cleanup;
+            }
+            LYD_TREE_DFS_END(root, elem);
+        }
+    }
+
+    /* none of the dependencies were changed, the module data stay valid */
+    *validate = 0;
+
+cleanup:
+    ly_set_free(arg.atoms, NULL);
+    return arg.err_info;
+}
+
+/**
+ * @brief Load data of the lazily loaded inverse dependency modules that need to be validated, with their dependencies.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] inv_dep_check Whether to load only the modules that can be affected by the changes in the diff.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_inv_dep_lazy_load(struct sr_mod_info_s *mod_info, int inv_dep_check)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_mod_info_mod_s *mod;
+    uint32_t i, *loaded = NULL, load_count = 0;
+    int validate;
+
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        mod = &mod_info->mods[i];
+        if (!(mod->state & MOD_INFO_DATA_LAZY)) {
+            continue;
+        }
+
+        if (inv_dep_check) {
+            if ((err_info = sr_modinfo_inv_dep_validate_needed(mod->ly_mod, mod_info->diff, &validate))) {
+                goto cleanup;
+            }
+            if (!validate) {
+                /* the module data stay lazy and will not be validated */
+                continue;
+            }
+        }
+
+        if (!loaded) {
+            loaded = malloc(mod_info->mod_count * sizeof *loaded);
+            SR_CHECK_MEM_GOTO(!loaded, err_info, cleanup);
+        }
+        loaded[load_count++] = i;
+        mod->state &= ~MOD_INFO_DATA_LAZY;
+    }
+    if (!load_count) {
+        goto cleanup;
     }
 
-    if (!(mi_opts & SR_MI_PERM_NO)) {
-        /* check permissions */
-        if ((err_info = sr_modinfo_perm_check(mod_info, mi_opts & SR_MI_PERM_WRITE ? 1 : 0, mi_opts & SR_MI_PERM_STRICT))) {
+    /* load the data of the modules, they were locked with the others */
+    if ((err_info = sr_modinfo_data_load(mod_info, 0, NULL, NULL, 0, 0))) {
+        goto cleanup;
+    }
+
+    /* collect their dependencies */
+    for (i = 0; i < load_count; ++i) {
+        mod = &mod_info->mods[loaded[i]];
+        if ((err_info = sr_shmmod_collect_deps(SR_CONN_MOD_SHM(mod_info->conn),
+                (sr_dep_t *)(mod_info->conn->mod_shm.addr + mod->shm_mod->deps), mod->shm_mod->dep_count,
+                mod_info->data, mod->ly_mod, ATOMIC_LOAD_RELAXED(mod->shm_mod->run_data_ver), mod_info))) {
             goto cleanup;
         }
     }
 
-    /* all modules could have been removed by the permission check */
-    if (mod_info->mod_count) {
-        /* sort the modules based on their offsets in the SHM so that we have a uniform order for locking */
-        qsort(mod_info->mods, mod_info->mod_count, sizeof *mod_info->mods, sr_modinfo_qsort_cmp);
+    /* lock and load the new dependencies, session ID is relevant only for DS locks */
+    if ((err_info = sr_modinfo_consolidate(mod_info, 0, SR_LOCK_READ, SR_MI_NEW_DEPS | SR_MI_PERM_NO, 0, NULL, NULL,
+            0, 0, 0))) {
+        goto cleanup;
     }
 
-    if (mod_lock) {
-        if (mod_lock == SR_LOCK_READ) {
-            /* MODULES READ LOCK */
-            if ((err_info = sr_shmmod_modinfo_rdlock(mod_info, mi_opts & SR_MI_LOCK_UPGRADEABLE, sid, timeout_ms,
-                    ds_lock_timeout_ms))) {
-                goto cleanup;
-            }
-        } else {
-            /* MODULES WRITE LOCK */
-            if ((err_info = sr_shmmod_modinfo_wrlock(mod_info, sid, timeout_ms, ds_lock_timeout_ms))) {
-                goto cleanup;
-            }
-        }
+cleanup:
+    free(loaded);
+    return err_info;
+}
+
+/**
+ * @brief Validate data of a single module in mod info.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] mod Module to validate.
+ * @param[in] val_opts Validation options.
+ * @param[in] finish_diff Whether to update the diff with the changes made by the validation.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_validate_mod(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod, int val_opts, int finish_diff)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *diff = NULL, *iter;
+    struct timespec start;
+
+    /* validate this module */
+    sr_timeouttime_get(&start, 0);
+    if (lyd_validate_module(&mod_info->data, mod->ly_mod, val_opts, finish_diff ? &diff : NULL)) {
+        sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx, NULL);
+        SR_ERRINFO_VALID(&err_info);
+        goto cleanup;
+    }
+    if (finish_diff) {
+        /* the changes are being applied, not only validated */
+        sr_modinfo_commit_stats_add(mod_info, mod, SR_COMMIT_PHASE_VALIDATE, &start);
     }
 
-    if (!(mi_opts & SR_MI_DATA_NO)) {
-        /* load all modules data */
-        if ((err_info = sr_modinfo_data_load(mod_info, mi_opts & SR_MI_DATA_CACHE, orig_name, orig_data, timeout_ms,
-                get_oper_opts))) {
+    if (diff) {
+        /* it may not have been modified before */
+        mod->state |= MOD_INFO_CHANGED;
+
+        /* merge the changes made by the validation into our diff */
+        if (lyd_diff_merge_all(&mod_info->diff, diff, 0)) {
+            sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx, NULL);
             goto cleanup;
         }
+
+        LY_LIST_FOR(mod_info->diff, iter) {
+            if (lyd_owner_module(iter) == mod->ly_mod) {
+                break;
+            }
+        }
+        if (!iter) {
+            /* the previous changes have actually been reverted */
+            mod->state &= ~MOD_INFO_CHANGED;
+        }
     }
 
 cleanup:
+    lyd_free_all(diff);
     return err_info;
 }
 
@@ -2507,9 +4167,9 @@ sr_modinfo_validate(struct sr_mod_info_s *mod_info, uint32_t mod_state, int fini
 {
     sr_error_info_t *err_info = NULL;
     struct sr_mod_info_mod_s *mod;
-    struct lyd_node *diff = NULL, *iter;
-    uint32_t i;
-    int val_opts;
+    const struct lys_module **validated = NULL;
+    uint32_t i, j, validated_count = 0;
+    int val_opts, inv_dep_check, validate;
 
     assert(!mod_info->data_cached);
     assert(SR_IS_CONVENTIONAL_DS(mod_info->ds) || !finish_diff);
@@ -2520,44 +4180,65 @@ sr_modinfo_validate(struct sr_mod_info_s *mod_info, uint32_t mod_state, int fini
     } else {
         val_opts = LYD_VALIDATE_OPERATIONAL | LYD_VALIDATE_NO_DEFAULTS;
     }
+
+    /* if only the changes are validated, the stored data are valid and unchanged inverse dependencies need to be
+     * validated only if the changes can affect them */
+    inv_dep_check = (mod_state & MOD_INFO_CHANGED) && !(mod_state & MOD_INFO_REQ) && SR_IS_CONVENTIONAL_DS(mod_info->ds);
+
+    validated = calloc(mod_info->mod_count, sizeof *validated);
+    SR_CHECK_MEM_GOTO(mod_info->mod_count && !validated, err_info, cleanup);
+
+    /* validate the changed modules first so that the diff includes the changes made by their validation */
     for (i = 0; i < mod_info->mod_count; ++i) {
         mod = &mod_info->mods[i];
-        if (mod->state & mod_state) {
-            /* validate this module */
-            if (lyd_validate_module(&mod_info->data, mod->ly_mod, val_opts, finish_diff ? &diff : NULL)) {
-                sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx, NULL);
-                SR_ERRINFO_VALID(&err_info);
+        if ((mod->state & mod_state) && (mod->state & MOD_INFO_CHANGED)) {
+            if ((err_info = sr_modinfo_validate_mod(mod_info, mod, val_opts, finish_diff))) {
                 goto cleanup;
             }
+            validated[validated_count++] = mod->ly_mod;
+        }
+    }
 
-            if (diff) {
-                /* it may not have been modified before */
-                mod->state |= MOD_INFO_CHANGED;
-
-                /* merge the changes made by the validation into our diff */
-                if (lyd_diff_merge_all(&mod_info->diff, diff, 0)) {
-                    sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx, NULL);
-                    goto cleanup;
-                }
+    if (mod_state & MOD_INFO_INV_DEP) {
+        /* the changed modules were validated, load the lazy inverse dependencies that can be affected by them,
+         * mods may be reordered */
+        if ((err_info = sr_modinfo_inv_dep_lazy_load(mod_info, inv_dep_check))) {
+            goto cleanup;
+        }
+    }
 
-                lyd_free_all(diff);
-                diff = NULL;
+    /* validate the rest of the modules */
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        mod = &mod_info->mods[i];
+        if (!(mod->state & mod_state) || (mod->state & MOD_INFO_DATA_LAZY)) {
+            continue;
+        }
+        for (j = 0; j < validated_count; ++j) {
+            if (validated[j] == mod->ly_mod) {
+                break;
+            }
+        }
+        if (j < validated_count) {
+            /* already validated */
+            continue;
+        }
 
-                LY_LIST_FOR(mod_info->diff, iter) {
-                    if (lyd_owner_module(iter) == mod->ly_mod) {
-                        break;
-                    }
-                }
-                if (!iter) {
-                    /* the previous changes have actually been reverted */
-                    mod->state &= ~MOD_INFO_CHANGED;
-                }
+        if (inv_dep_check && ((mod->state & MOD_INFO_TYPE_MASK) == MOD_INFO_INV_DEP)) {
+            if ((err_info = sr_modinfo_inv_dep_validate_needed(mod->ly_mod, mod_info->diff, &validate))) {
+                goto cleanup;
             }
+            if (!validate) {
+                continue;
+            }
+        }
+
+        if ((err_info = sr_modinfo_validate_mod(mod_info, mod, val_opts, finish_diff))) {
+            goto cleanup;
         }
     }
 
 cleanup:
-    lyd_free_all(diff);
+    free(validated);
     return err_info;
 }
 
@@ -2864,6 +4545,67 @@ cleanup:
     return err_info;
 }
 
+/**
+ * @brief Check whether an edit or a diff includes any changes of a module.
+ *
+ * @param[in] ly_mod Module to check.
+ * @param[in] edit Edit to check, may be NULL.
+ * @param[in] diff Diff to check, may be NULL.
+ * @return Whether there are any changes or not.
+ */
+static int
+sr_modinfo_get_filter_mod_changed(const struct lys_module *ly_mod, const struct lyd_node *edit,
+        const struct lyd_node *diff)
+{
+    const struct lyd_node *node;
+
+    LY_LIST_FOR(edit, node) {
+        if (lyd_owner_module(node) == ly_mod) {
+            return 1;
+        }
+    }
+    LY_LIST_FOR(diff, node) {
+        if (lyd_owner_module(node) == ly_mod) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Stop using cached running data in mod info by duplicating only the data of its modules,
+ * not the whole cache.
+ *
+ * @param[in] mod_info Mod info with cached data.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_get_filter_uncache(struct sr_mod_info_s *mod_info)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *data = NULL;
+    uint32_t i;
+
+    assert(mod_info->data_cached);
+
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        if ((err_info = sr_lyd_get_module_data(&mod_info->data, mod_info->mods[i].ly_mod, 0, 1, &data))) {
+            lyd_free_siblings(data);
+            return err_info;
+        }
+    }
+
+    mod_info->data = data;
+    mod_info->data_cached = 0;
+
+    /* CACHE READ UNLOCK */
+    sr_rwunlock(&mod_info->conn->run_cache_lock, SR_CONN_RUN_CACHE_LOCK_TIMEOUT, SR_LOCK_READ, mod_info->conn->cid,
+            __func__);
+
+    return NULL;
+}
+
 sr_error_info_t *
 sr_modinfo_get_filter(struct sr_mod_info_s *mod_info, const char *xpath, sr_session_ctx_t *session,
         struct ly_set **result, int *dup)
@@ -2887,6 +4629,9 @@ sr_modinfo_get_filter(struct sr_mod_info_s *mod_info, const char *xpath, sr_sess
             switch (session->ev) {
             case SR_SUB_EV_CHANGE:
             case SR_SUB_EV_UPDATE:
+                if ((err_info = sr_change_log_session_diff(session))) {
+                    goto cleanup;
+                }
                 diff = session->dt[session->ds].diff;
                 if (session->ev != SR_SUB_EV_UPDATE) {
                     break;
@@ -2910,14 +4655,16 @@ sr_modinfo_get_filter(struct sr_mod_info_s *mod_info, const char *xpath, sr_sess
                 goto cleanup;
             }
 
-            if (mod_info->data_cached && ((session->ds == SR_DS_RUNNING) && (edit || diff))) {
-                /* data will be changed, we cannot use the cache anymore */
-                lyd_dup_siblings(mod_info->data, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &mod_info->data);
-                mod_info->data_cached = 0;
+            if (!sr_modinfo_get_filter_mod_changed(mod->ly_mod, edit, diff)) {
+                /* the data of this module are not changed, the cache can still be used */
+                continue;
+            }
 
-                /* CACHE READ UNLOCK */
-                sr_rwunlock(&mod_info->conn->run_cache_lock, SR_CONN_RUN_CACHE_LOCK_TIMEOUT, SR_LOCK_READ,
-                        mod_info->conn->cid, __func__);
+            if (mod_info->data_cached && (session->ds == SR_DS_RUNNING)) {
+                /* data will be changed, we cannot use the cache anymore */
+                if ((err_info = sr_modinfo_get_filter_uncache(mod_info))) {
+                    goto cleanup;
+                }
             }
 
             /* apply any currently handled changes (diff) or additional performed ones (edit) to get
@@ -3011,8 +4758,8 @@ sr_modinfo_change_notify_update(struct sr_mod_info_s *mod_info, sr_session_ctx_t
         switch (mod_info->ds) {
         case SR_DS_STARTUP:
         case SR_DS_RUNNING:
-            /* add new modules */
-            if ((err_info = sr_modinfo_collect_deps(mod_info))) {
+            /* add new modules, the diff includes only the update changes */
+            if ((err_info = sr_modinfo_collect_deps(mod_info, 0))) {
                 goto cleanup;
             }
             if ((err_info = sr_modinfo_consolidate(mod_info, 0, SR_LOCK_READ, SR_MI_NEW_DEPS | SR_MI_PERM_NO, sid,
@@ -3177,7 +4924,7 @@ sr_modinfo_generate_config_change_notif(struct sr_mod_info_s *mod_info, sr_sessi
         goto cleanup;
     }
 
-    while (!(err_info = sr_diff_set_getnext(set, &idx, &elem, &op)) && elem) {
+    while (!(err_info = sr_diff_set_getnext(set, NULL, &idx, &elem, &op)) && elem) {
         /* edit (list instance) */
         if (lyd_new_list(notif, NULL, "edit", 0, &root)) {
             sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx, NULL);
@@ -3229,7 +4976,8 @@ sr_modinfo_generate_config_change_notif(struct sr_mod_info_s *mod_info, sr_sessi
     tmp_err = sr_replay_store(session, notif, notif_ts);
 
     /* send the notification (non-validated, if everything works correctly it must be valid) */
-    if ((err_info = sr_shmsub_notif_notify(mod_info->conn, notif, notif_ts, session->orig_name, session->orig_data, 0, 0))) {
+    if ((err_info = sr_shmsub_notif_notify(mod_info->conn, &notif, &notif_ts, 1,
+            session->orig_name, session->orig_data, 0, 0))) {
         goto cleanup;
     }
 
@@ -3247,17 +4995,209 @@ cleanup:
     return err_info;
 }
 
+/**
+ * @brief Finish storing new data of a module, connect its diff and data back into mod info.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] mod Mod info module whose data were stored.
+ * @param[in] mod_diff Unlinked stored module diff.
+ * @param[in] mod_data Unlinked stored module data.
+ * @param[in] rc DS plugin store return code.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_module_data_stored(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod, struct lyd_node *mod_diff,
+        struct lyd_node *mod_data, int rc)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t run_data_ver = 0;
+
+    if (mod_info->ds == SR_DS_RUNNING) {
+        /* running data (may have) changed, any cached data are no longer current */
+        run_data_ver = ATOMIC_INC_RELAXED(mod->shm_mod->run_data_ver) + 1;
+    } else if (mod_info->ds == SR_DS_OPERATIONAL) {
+        /* the same for the stored operational data */
+        ATOMIC_INC_RELAXED(mod->shm_mod->oper_data_ver);
+    }
+    if (rc) {
+        SR_ERRINFO_DSPLUGIN(&err_info, rc, "store", mod->ds_plg[mod_info->ds]->name, mod->ly_mod->name);
+        goto cleanup;
+    }
+
+    if (mod_info->ds == SR_DS_RUNNING) {
+        /* keep the resolved inst-id dependencies not affected by the changes */
+        sr_conn_instid_cache_update(mod_info->conn, mod->ly_mod, mod_diff, run_data_ver - 1, run_data_ver);
+    }
+
+    if (SR_RUN_SHM_SNAPSHOT && (mod_info->ds == SR_DS_RUNNING)) {
+        /* share the new data with all the processes */
+        sr_run_snapshot_store(mod->ly_mod, mod->ds_plg[SR_DS_RUNNING], mod_info->conn->content_id,
+                run_data_ver, mod_data);
+    }
+
+    if ((mod_info->ds == SR_DS_OPERATIONAL) && (mod_info->ds2 == SR_DS_OPERATIONAL)) {
+        /* stored oper data, cache the modified module in the connection */
+        err_info = sr_conn_push_oper_mod_add(mod_info->conn, mod->ly_mod->name);
+    }
+
+cleanup:
+    /* connect them back */
+    if (mod_diff) {
+        lyd_insert_sibling(mod_info->diff, mod_diff, &mod_info->diff);
+    }
+    if (mod_data) {
+        lyd_insert_sibling(mod_info->data, mod_data, &mod_info->data);
+    }
+    return err_info;
+}
+
+#if SR_DATA_STORE_THREADS > 0
+
+/**
+ * @brief DS data of a single module stored in parallel.
+ */
+struct sr_modinfo_ds_store_s {
+    struct sr_mod_info_mod_s *mod;  /**< Mod info module. */
+    struct lyd_node *diff;          /**< Unlinked module diff. */
+    struct lyd_node *data;          /**< Unlinked module data. */
+    int rc;                         /**< DS plugin store return code. */
+};
+
+/**
+ * @brief Shared state of the parallel DS data store threads.
+ */
+struct sr_modinfo_ds_store_pool_s {
+    struct sr_modinfo_ds_store_s *stores;   /**< Module DS data to store. */
+    uint32_t count;                 /**< Count of @p stores. */
+    struct sr_mod_info_s *mod_info; /**< Mod info to use. */
+    ATOMIC_T next;                  /**< Index of the next module to store. */
+};
+
+/**
+ * @brief Thread storing DS data of the modules that are not yet taken by another thread.
+ *
+ * @param[in] arg Store pool.
+ * @return Always NULL.
+ */
+static void *
+sr_modinfo_ds_store_thread(void *arg)
+{
+    struct sr_modinfo_ds_store_pool_s *pool = arg;
+    struct sr_modinfo_ds_store_s *store;
+    sr_datastore_t ds = pool->mod_info->ds;
+    struct timespec start;
+    uint32_t i;
+
+    while ((i = ATOMIC_INC_RELAXED(pool->next)) < pool->count) {
+        store = &pool->stores[i];
+
+        sr_timeouttime_get(&start, 0);
+        store->rc = sr_ds_plugin_store(store->mod->shm_mod, store->mod->ds_plg[ds], store->mod->ly_mod, ds, store->diff,
+                store->data);
+        sr_modinfo_commit_stats_add(pool->mod_info, store->mod, SR_COMMIT_PHASE_STORE, &start);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Store DS data of all the changed modules in mod info in parallel. Only the DS plugin store callbacks are
+ * executed in the threads, the rest is performed sequentially in the module order.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[out] stored Whether the data were stored, not if there were not enough changed modules.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_data_store_parallel(struct sr_mod_info_s *mod_info, int *stored)
+{
+    sr_error_info_t *err_info = NULL, *tmp_err;
+    struct sr_modinfo_ds_store_pool_s pool = {0};
+    pthread_t tids[SR_DATA_STORE_THREADS - 1];
+    uint32_t i, tid_count = 0;
+
+    *stored = 0;
+
+    /* count the changed modules */
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        if (mod_info->mods[i].state & MOD_INFO_CHANGED) {
+            ++pool.count;
+        }
+    }
+    if (pool.count < 2) {
+        /* nothing to parallelize */
+        return NULL;
+    }
+
+    /* separate diff and data of all the modules */
+    pool.stores = calloc(pool.count, sizeof *pool.stores);
+    SR_CHECK_MEM_RET(!pool.stores, err_info);
+    pool.count = 0;
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        if (mod_info->mods[i].state & MOD_INFO_CHANGED) {
+            pool.stores[pool.count].mod = &mod_info->mods[i];
+            pool.stores[pool.count].diff = sr_module_data_unlink(&mod_info->diff, mod_info->mods[i].ly_mod);
+            pool.stores[pool.count].data = sr_module_data_unlink(&mod_info->data, mod_info->mods[i].ly_mod);
+            ++pool.count;
+        }
+    }
+    pool.mod_info = mod_info;
+    ATOMIC_STORE_RELAXED(pool.next, 0);
+
+    /* start the threads, if any fails to start, the remaining ones (including this one) store its share */
+    while ((tid_count < SR_DATA_STORE_THREADS - 1) && (tid_count < pool.count - 1)) {
+        if (pthread_create(&tids[tid_count], NULL, sr_modinfo_ds_store_thread, &pool)) {
+            break;
+        }
+        ++tid_count;
+    }
+
+    /* store in this thread as well */
+    sr_modinfo_ds_store_thread(&pool);
+
+    /* wait for all the threads */
+    for (i = 0; i < tid_count; ++i) {
+        pthread_join(tids[i], NULL);
+    }
+
+    /* finish all the stores, in case of an error in some, the others were still stored */
+    for (i = 0; i < pool.count; ++i) {
+        if ((tmp_err = sr_modinfo_module_data_stored(mod_info, pool.stores[i].mod, pool.stores[i].diff,
+                pool.stores[i].data, pool.stores[i].rc))) {
+            sr_errinfo_merge(&err_info, tmp_err);
+        }
+    }
+    free(pool.stores);
+
+    *stored = 1;
+    return err_info;
+}
+
+#endif
+
 sr_error_info_t *
 sr_modinfo_data_store(struct sr_mod_info_s *mod_info)
 {
     sr_error_info_t *err_info = NULL;
     struct sr_mod_info_mod_s *mod;
     struct lyd_node *mod_diff, *mod_data;
+    struct timespec start;
     uint32_t i;
     int rc;
 
+#if SR_DATA_STORE_THREADS > 0
+    int stored;
+#endif
+
     assert(!mod_info->data_cached);
 
+#if SR_DATA_STORE_THREADS > 0
+    /* store DS data of all the modules in parallel */
+    if ((err_info = sr_modinfo_data_store_parallel(mod_info, &stored)) || stored) {
+        return err_info;
+    }
+#endif
+
     for (i = 0; i < mod_info->mod_count; ++i) {
         mod = &mod_info->mods[i];
         if (mod->state & MOD_INFO_CHANGED) {
@@ -3266,29 +5206,39 @@ sr_modinfo_data_store(struct sr_mod_info_s *mod_info)
             mod_data = sr_module_data_unlink(&mod_info->data, mod->ly_mod);
 
             /* store the new data */
-            if ((rc = mod->ds_plg[mod_info->ds]->store_cb(mod->ly_mod, mod_info->ds, mod_diff, mod_data))) {
-                SR_ERRINFO_DSPLUGIN(&err_info, rc, "store", mod->ds_plg[mod_info->ds]->name, mod->ly_mod->name);
-                goto cleanup;
-            }
-
-            /* connect them back */
-            lyd_insert_sibling(mod_info->diff, mod_diff, &mod_info->diff);
-            if (mod_data) {
-                lyd_insert_sibling(mod_info->data, mod_data, &mod_info->data);
-            }
+            sr_timeouttime_get(&start, 0);
+            rc = sr_ds_plugin_store(mod->shm_mod, mod->ds_plg[mod_info->ds], mod->ly_mod, mod_info->ds, mod_diff, mod_data);
+            sr_modinfo_commit_stats_add(mod_info, mod, SR_COMMIT_PHASE_STORE, &start);
 
-            if ((mod_info->ds == SR_DS_OPERATIONAL) && (mod_info->ds2 == SR_DS_OPERATIONAL)) {
-                /* stored oper data, cache the modified module in the connection */
-                if ((err_info = sr_conn_push_oper_mod_add(mod_info->conn, mod->ly_mod->name))) {
-                    goto cleanup;
-                }
+            if ((err_info = sr_modinfo_module_data_stored(mod_info, mod, mod_diff, mod_data, rc))) {
+                return err_info;
             }
         }
     }
 
-cleanup:
-    return err_info;
+    return NULL;
+}
+
+void
+sr_modinfo_commit_stats_add(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod, sr_commit_phase_t phase,
+        const struct timespec *start)
+{
+    struct timespec end;
+    uint32_t i, usec;
+
+    sr_timeouttime_get(&end, 0);
+    usec = sr_time_sub_us(&end, start);
+
+    if (mod) {
+        sr_latency_stats_add(&mod->shm_mod->commit_stats[phase], usec);
+        return;
+    }
 
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        if (mod_info->mods[i].state & MOD_INFO_CHANGED) {
+            sr_latency_stats_add(&mod_info->mods[i].shm_mod->commit_stats[phase], usec);
+        }
+    }
 }
 
 sr_error_info_t *
@@ -36,6 +36,7 @@
 #define MOD_INFO_DATA       0x0100 /* module data were loaded */
 #define MOD_INFO_CHANGED    0x0200 /* module data were changed */
 #define MOD_INFO_XPATH_DYN  0x0400 /* module XPaths are dynamically allocated and need to be freed */
+#define MOD_INFO_DATA_LAZY  0x0800 /* inverse dependency module data are loaded only once they need to be validated */
 
 /**
  * @brief Mod info structure, used for keeping all relevant modules for a data operation.
@@ -58,6 +59,10 @@ struct sr_mod_info_s {
         uint32_t request_id;    /**< Request ID of the published event. */
     } *mods;                    /**< Relevant modules. */
     uint32_t mod_count;         /**< Modules count. */
+
+    uint32_t oper_max_depth;    /**< Requested maximum depth of operational data, 0 for unlimited. */
+    uint32_t oper_limit;        /**< Requested maximum number of operational subtrees, 0 for unlimited. */
+    uint32_t commit_prio;       /**< Priority of the upgradeable module locks, when waiting for other commits. */
 };
 
 /**
@@ -113,9 +118,11 @@ sr_error_info_t *sr_modinfo_collect_xpath(const struct ly_ctx *ly_ctx, const cha
  * Other modules will not be validated.
  *
  * @param[in,out] mod_info Mod info with the modules and data.
+ * @param[in] full_diff Whether the diff in @p mod_info includes all the changes against the stored data so that
+ * cached instance-identifier dependencies of unchanged data can be used.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_modinfo_collect_deps(struct sr_mod_info_s *mod_info);
+sr_error_info_t *sr_modinfo_collect_deps(struct sr_mod_info_s *mod_info, int full_diff);
 
 /**
  * @brief Collect required modules and XPath for all mounted data and parent-reference nodes in schema-mount ext data
@@ -201,6 +208,11 @@ void sr_modinfo_changesub_rdunlock(struct sr_mod_info_s *mod_info);
 #define SR_MI_PERM_NO           0x20    /**< do not check any permissions */
 #define SR_MI_PERM_READ         0x40    /**< check read permissions of the MOD_INFO_REQ modules */
 #define SR_MI_PERM_WRITE        0x80    /**< check write permissions of the MOD_INFO_REQ modules */
+#define SR_MI_DATA_RO           0x100   /**< only valid for a read lock, the data are only read once loaded so the module
+                                             locks are released right after loading them (their own copy or the pinned
+                                             connection cache is used) */
+#define SR_MI_DATA_INV_DEP_LAZY 0x200   /**< do not load data of the inverse dependencies (MOD_INFO_INV_DEP), they are
+                                             loaded during validation only if the changes can affect them */
 
 /**
  * @brief Consolidate mod info by adding dependencies of the added modules, check the permissions, lock, and load data.
@@ -300,6 +312,17 @@ sr_error_info_t *sr_modinfo_generate_config_change_notif(struct sr_mod_info_s *m
  */
 sr_error_info_t *sr_modinfo_data_store(struct sr_mod_info_s *mod_info);
 
+/**
+ * @brief Add the duration of a phase of applying changes into the module latency statistics.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] mod Specific module to add to, NULL for all the changed modules.
+ * @param[in] phase Measured phase.
+ * @param[in] start Start of the phase (::COMPAT_CLOCK_ID), it ends now.
+ */
+void sr_modinfo_commit_stats_add(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod,
+        sr_commit_phase_t phase, const struct timespec *start);
+
 /**
  * @brief Reset (unlock SHM files) all candidate data for mod info.
  *
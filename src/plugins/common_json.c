@@ -27,11 +27,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
 
+#ifdef SR_HAVE_FICLONE
+# include <linux/fs.h>
+#endif
+
 #include <libyang/libyang.h>
 
 #include "compat.h"
@@ -121,6 +126,38 @@ srpjson_file_exists(const char *plg_name, const char *path)
     return 1;
 }
 
+int
+srpjson_file_format_check(const char *plg_name, const char *path)
+{
+    char *other_path;
+    int other;
+
+    if (SRPJSON_DS_FORMAT == LYD_LYB) {
+        /* no JSON file is ever created when using LYB */
+        other_path = strndup(path, strlen(path) - strlen(SRPJSON_FILE_LYB_SUFFIX));
+        if (!other_path) {
+            SRPLG_LOG_ERR(plg_name, "Memory allocation failed.");
+            return SR_ERR_NO_MEMORY;
+        }
+        other = srpjson_file_exists(plg_name, other_path);
+    } else {
+        /* the LYB cache of "sysrepo" data has the same name, consider it only if there is no JSON file */
+        if (asprintf(&other_path, "%s%s", path, SRPJSON_FILE_LYB_SUFFIX) == -1) {
+            SRPLG_LOG_ERR(plg_name, "Memory allocation failed.");
+            return SR_ERR_NO_MEMORY;
+        }
+        other = !srpjson_file_exists(plg_name, path) && srpjson_file_exists(plg_name, other_path);
+    }
+
+    if (other) {
+        SRPLG_LOG_ERR(plg_name, "Data file \"%s\" is stored in the %s format but %s is used (JSON_DS_FORMAT), "
+                "the data must be converted first.", other_path, (SRPJSON_DS_FORMAT == LYD_LYB) ? "JSON" : "LYB",
+                (SRPJSON_DS_FORMAT == LYD_LYB) ? "LYB" : "JSON");
+    }
+    free(other_path);
+    return other ? SR_ERR_UNSUPPORTED : SR_ERR_OK;
+}
+
 int
 srpjson_shm_prefix(const char *plg_name, const char **prefix)
 {
@@ -472,6 +509,13 @@ srpjson_cp_path(const char *plg_name, const char *to, const char *from)
         goto cleanup;
     }
 
+#ifdef SR_HAVE_FICLONE
+    /* copy-on-write clone, not supported across file systems and by some of them */
+    if (!ioctl(fd_to, FICLONE, fd_from)) {
+        goto cleanup;
+    }
+#endif
+
     while ((nread = read(fd_from, buf, sizeof buf)) > 0) {
         out_ptr = buf;
         do {
@@ -623,16 +667,18 @@ srpjson_get_path(const char *plg_name, const char *mod_name, sr_datastore_t ds,
     switch (ds) {
     case SR_DS_STARTUP:
         if (SR_STARTUP_PATH[0]) {
-            r = asprintf(path, "%s/%s.startup", SR_STARTUP_PATH, mod_name);
+            r = asprintf(path, "%s/%s.startup%s", SR_STARTUP_PATH, mod_name, SRPJSON_FILE_FORMAT_SUFFIX);
         } else {
-            r = asprintf(path, "%s/data/%s.startup", sr_get_repo_path(), mod_name);
+            r = asprintf(path, "%s/data/%s.startup%s", sr_get_repo_path(), mod_name, SRPJSON_FILE_FORMAT_SUFFIX);
         }
         break;
     case SR_DS_FACTORY_DEFAULT:
         if (SR_FACTORY_DEFAULT_PATH[0]) {
-            r = asprintf(path, "%s/%s.factory-default", SR_FACTORY_DEFAULT_PATH, mod_name);
+            r = asprintf(path, "%s/%s.factory-default%s", SR_FACTORY_DEFAULT_PATH, mod_name,
+                    SRPJSON_FILE_FORMAT_SUFFIX);
         } else {
-            r = asprintf(path, "%s/data/%s.factory-default", sr_get_repo_path(), mod_name);
+            r = asprintf(path, "%s/data/%s.factory-default%s", sr_get_repo_path(), mod_name,
+                    SRPJSON_FILE_FORMAT_SUFFIX);
         }
         break;
     case SR_DS_RUNNING:
@@ -642,7 +688,8 @@ srpjson_get_path(const char *plg_name, const char *mod_name, sr_datastore_t ds,
             return rc;
         }
 
-        r = asprintf(path, "%s/%s_%s.%s", SR_SHM_DIR, prefix, mod_name, srpjson_ds2str(ds));
+        r = asprintf(path, "%s/%s_%s.%s%s", SR_SHM_DIR, prefix, mod_name, srpjson_ds2str(ds),
+                SRPJSON_FILE_FORMAT_SUFFIX);
         break;
     }
 
@@ -704,6 +751,26 @@ srpjson_get_notif_dir(const char *plg_name, char **path)
     return SR_ERR_OK;
 }
 
+int
+srpjson_get_notif_archive_dir(const char *plg_name, char **path)
+{
+    const char *dir;
+
+    *path = NULL;
+
+    dir = getenv(SR_NOTIF_ARCHIVE_PATH_ENV);
+    if (!dir || !dir[0]) {
+        return SR_ERR_OK;
+    }
+
+    *path = strdup(dir);
+    if (!*path) {
+        SRPLG_LOG_ERR(plg_name, "Memory allocation failed.");
+        return SR_ERR_NO_MEMORY;
+    }
+    return SR_ERR_OK;
+}
+
 int
 srpjson_get_notif_path(const char *plg_name, const char *mod_name, time_t from_ts, time_t to_ts, char **path)
 {
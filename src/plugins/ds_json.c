@@ -20,6 +20,7 @@
 #include "plugins_datastore.h"
 
 #include <assert.h>
+#include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <pthread.h>
@@ -28,6 +29,7 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -39,12 +41,555 @@
 
 #define srpds_name "JSON DS file"  /**< plugin name */
 
+/** whether changes of a datastore are stored in a diff journal */
+#define SRPDS_JSON_JOURNAL_DS(ds) (SRPJSON_JOURNAL_MAX_SIZE && ((ds == SR_DS_RUNNING) || (ds == SR_DS_CANDIDATE)))
+
 static int srpds_json_load(const struct lys_module *mod, sr_datastore_t ds, const char **xpaths, uint32_t xpath_count,
         struct lyd_node **mod_data);
 
 static int srpds_json_access_get(const struct lys_module *mod, sr_datastore_t ds, char **owner, char **group,
         mode_t *perm);
 
+/** magic number of index files */
+#define SRPDS_JSON_INDEX_MAGIC 0x78646973
+
+/** index segment with a top-level member that is always loaded */
+#define SRPDS_JSON_INDEX_SEG_MEMBER 0
+
+/** index segment with a top-level list whose entries are loaded selectively */
+#define SRPDS_JSON_INDEX_SEG_LIST 1
+
+/** maximum number of list keys of selectively loaded list entries */
+#define SRPDS_JSON_INDEX_MAX_KEYS 8
+
+/**
+ * @brief Index file header, followed by all the segments in the order of the data file.
+ *
+ * Member segment is a single ::srpds_json_index_rec with the member range. List segment is a ::srpds_json_index_rec
+ * with the segment type, list name length, and entry count followed by the module-qualified list name, key count,
+ * and for every entry its ::srpds_json_index_rec range followed by the canonical values of all its keys, each stored
+ * as its length and the value itself.
+ */
+struct srpds_json_index_hdr {
+    uint32_t magic;             /**< index magic number */
+    uint32_t seg_count;         /**< number of segments */
+    uint64_t data_size;         /**< size of the indexed data file */
+    int64_t data_mtime_sec;     /**< modification time of the indexed data file, seconds */
+    int64_t data_mtime_nsec;    /**< modification time of the indexed data file, nanoseconds */
+};
+
+/**
+ * @brief Index record.
+ */
+struct srpds_json_index_rec {
+    uint32_t type;              /**< segment type, unused for list entries */
+    uint32_t len;               /**< length of the data file range or the list name */
+    uint64_t offset;            /**< offset of the data file range or list entry count */
+};
+
+/** magic number of journal files */
+#define SRPDS_JSON_JOURNAL_MAGIC 0x726e6a73
+
+/** version of the journal file format */
+#define SRPDS_JSON_JOURNAL_VERSION 1
+
+/**
+ * @brief Journal file header, followed by the records, each being the diff length and the diff itself.
+ *
+ * A journal applies only to the data file it was started for so that it is obsolete once the full data are stored,
+ * even if it could not be removed. The data file is identified by its size, modification time, and the checksum
+ * of its content so that a journal is never applied on other data, even with coarse file timestamps.
+ */
+struct srpds_json_journal_hdr {
+    uint32_t magic;             /**< journal magic number */
+    uint32_t version;           /**< journal format version */
+    uint64_t data_size;         /**< size of the journaled data file */
+    int64_t data_mtime_sec;     /**< modification time of the journaled data file, seconds */
+    int64_t data_mtime_nsec;    /**< modification time of the journaled data file, nanoseconds */
+    uint64_t data_checksum;     /**< checksum of the content of the journaled data file */
+};
+
+/**
+ * @brief Growing memory buffer.
+ */
+struct srpds_json_buf {
+    char *mem;                  /**< buffer memory */
+    size_t len;                 /**< used length */
+    size_t size;                /**< allocated size */
+};
+
+/**
+ * @brief Append to a memory buffer.
+ *
+ * @param[in] buf Buffer to append to.
+ * @param[in] data Data to append, NULL to only reserve the space.
+ * @param[in] len Length of @p data.
+ * @return SR err value.
+ */
+static int
+srpds_json_buf_add(struct srpds_json_buf *buf, const void *data, size_t len)
+{
+    char *mem;
+    size_t size;
+
+    if (buf->len + len > buf->size) {
+        size = buf->size ? buf->size : 4096;
+        while (size < buf->len + len) {
+            size *= 2;
+        }
+
+        mem = realloc(buf->mem, size);
+        if (!mem) {
+            SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
+            return SR_ERR_NO_MEMORY;
+        }
+        buf->mem = mem;
+        buf->size = size;
+    }
+
+    if (data) {
+        memcpy(buf->mem + buf->len, data, len);
+    }
+    buf->len += len;
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Get path to the index of a module datastore file.
+ *
+ * @param[in] path Datastore file path.
+ * @param[out] index_path Generated index file path.
+ * @return SR err value.
+ */
+static int
+srpds_json_get_index_path(const char *path, char **index_path)
+{
+    if (asprintf(index_path, "%s%s", path, SRPJSON_FILE_INDEX_SUFFIX) == -1) {
+        *index_path = NULL;
+        SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
+        return SR_ERR_NO_MEMORY;
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Remove the index of a module datastore file, if any.
+ *
+ * @param[in] path Datastore file path.
+ * @return SR err value.
+ */
+static int
+srpds_json_index_remove(const char *path)
+{
+    int rc = SR_ERR_OK;
+    char *index_path;
+
+    if ((rc = srpds_json_get_index_path(path, &index_path))) {
+        return rc;
+    }
+
+    if ((unlink(index_path) == -1) && (errno != ENOENT)) {
+        SRPLG_LOG_ERR(srpds_name, "Failed to unlink \"%s\" (%s).", index_path, strerror(errno));
+        rc = SR_ERR_SYS;
+    }
+
+    free(index_path);
+    return rc;
+}
+
+/**
+ * @brief Learn whether it is worth indexing module data.
+ *
+ * @param[in] mod_data Module data.
+ * @return Whether there is a top-level list with enough instances.
+ */
+static int
+srpds_json_index_needed(const struct lyd_node *mod_data)
+{
+    const struct lyd_node *node;
+    uint32_t count = 0;
+
+    LY_LIST_FOR(mod_data, node) {
+        if (!node->schema || (node->schema->nodetype != LYS_LIST) || (node->schema->flags & LYS_KEYLESS)) {
+            continue;
+        }
+
+        if (!node->prev->next || (node->prev->schema != node->schema)) {
+            /* first instance */
+            count = 0;
+        }
+        if (++count >= SRPJSON_INDEX_MIN_ENTRIES) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Print module data split into top-level members and list entries and generate their index.
+ *
+ * All the instances of a top-level keyed list are printed separately so that they can be loaded selectively,
+ * the result is still a valid JSON data file.
+ *
+ * @param[in] mod_data Module data to print.
+ * @param[in] print_opts Print options.
+ * @param[in,out] data Printed data.
+ * @param[in,out] index Generated index, its header data file size and modification time are not set.
+ * @param[out] indexed Whether the data could be printed this way, if not, they must be printed normally.
+ * @return SR err value.
+ */
+static int
+srpds_json_print_indexed(const struct lyd_node *mod_data, uint32_t print_opts, struct srpds_json_buf *data,
+        struct srpds_json_buf *index, int *indexed)
+{
+    int rc = SR_ERR_OK;
+    const struct lyd_node *node, *inst, *key;
+    const struct lysc_node *skey;
+    struct lyd_node *dup = NULL, *first = NULL;
+    struct srpds_json_index_hdr hdr = {0};
+    struct srpds_json_index_rec seg, rec;
+    char *str = NULL, *prefix = NULL;
+    const char *val;
+    size_t len, plen, seg_off;
+    uint32_t key_count, val_len;
+
+    *indexed = 0;
+    print_opts &= ~LYD_PRINT_WITHSIBLINGS;
+
+    /* index header placeholder and opening brace */
+    if ((rc = srpds_json_buf_add(index, NULL, sizeof hdr))) {
+        goto cleanup;
+    }
+    if ((rc = srpds_json_buf_add(data, "{", 1))) {
+        goto cleanup;
+    }
+
+    node = mod_data;
+    while (node) {
+        if (node->schema && (node->schema->nodetype == LYS_LIST) && !(node->schema->flags & LYS_KEYLESS)) {
+            /* all the instances are printed as a single array member */
+            if (asprintf(&prefix, "{\"%s:%s\":[", node->schema->module->name, node->schema->name) == -1) {
+                prefix = NULL;
+                SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
+                rc = SR_ERR_NO_MEMORY;
+                goto cleanup;
+            }
+            plen = strlen(prefix);
+
+            /* list segment header */
+            key_count = 0;
+            for (skey = lysc_node_child(node->schema); skey && (skey->flags & LYS_KEY); skey = skey->next) {
+                ++key_count;
+            }
+            seg.type = SRPDS_JSON_INDEX_SEG_LIST;
+            seg.len = plen - 4;
+            seg.offset = 0;
+            seg_off = index->len;
+            if ((rc = srpds_json_buf_add(index, &seg, sizeof seg))) {
+                goto cleanup;
+            }
+            if ((rc = srpds_json_buf_add(index, prefix + 2, seg.len))) {
+                goto cleanup;
+            }
+            if ((rc = srpds_json_buf_add(index, &key_count, sizeof key_count))) {
+                goto cleanup;
+            }
+
+            if ((data->len > 1) && (rc = srpds_json_buf_add(data, ",", 1))) {
+                goto cleanup;
+            }
+            if ((rc = srpds_json_buf_add(data, prefix + 1, plen - 1))) {
+                goto cleanup;
+            }
+
+            for (inst = node; inst && (inst->schema == node->schema); inst = inst->next) {
+                if (lyd_print_mem(&str, inst, LYD_JSON, print_opts)) {
+                    srpjson_log_err_ly(srpds_name, LYD_CTX(inst));
+                    rc = SR_ERR_LY;
+                    goto cleanup;
+                }
+                len = strlen(str);
+                if ((len < plen + 2) || strncmp(str, prefix, plen) || strcmp(str + len - 2, "]}")) {
+                    /* unexpected format, cannot be split */
+                    goto cleanup;
+                }
+
+                if ((inst != node) && (rc = srpds_json_buf_add(data, ",", 1))) {
+                    goto cleanup;
+                }
+
+                /* entry record with all the keys */
+                rec.type = 0;
+                rec.len = len - plen - 2;
+                rec.offset = data->len;
+                if ((rc = srpds_json_buf_add(index, &rec, sizeof rec))) {
+                    goto cleanup;
+                }
+                for (key = lyd_child(inst); key && key->schema && (key->schema->flags & LYS_KEY); key = key->next) {
+                    val = lyd_get_value(key);
+                    val_len = strlen(val);
+                    if ((rc = srpds_json_buf_add(index, &val_len, sizeof val_len))) {
+                        goto cleanup;
+                    }
+                    if ((rc = srpds_json_buf_add(index, val, val_len))) {
+                        goto cleanup;
+                    }
+                }
+
+                /* entry */
+                if ((rc = srpds_json_buf_add(data, str + plen, rec.len))) {
+                    goto cleanup;
+                }
+                free(str);
+                str = NULL;
+                ++seg.offset;
+            }
+
+            if ((rc = srpds_json_buf_add(data, "]", 1))) {
+                goto cleanup;
+            }
+            free(prefix);
+            prefix = NULL;
+
+            /* set the entry count */
+            memcpy(index->mem + seg_off, &seg, sizeof seg);
+            ++hdr.seg_count;
+            node = inst;
+            continue;
+        }
+
+        if (node->schema && (node->schema->nodetype & (LYS_LIST | LYS_LEAFLIST))) {
+            /* all the instances are printed together, as a member */
+            for (inst = node; inst && (inst->schema == node->schema); inst = inst->next) {
+                if (lyd_dup_single(inst, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &dup)) {
+                    srpjson_log_err_ly(srpds_name, LYD_CTX(inst));
+                    rc = SR_ERR_LY;
+                    goto cleanup;
+                }
+                lyd_insert_sibling(first, dup, &first);
+                dup = NULL;
+            }
+
+            if (lyd_print_mem(&str, first, LYD_JSON, print_opts | LYD_PRINT_WITHSIBLINGS)) {
+                srpjson_log_err_ly(srpds_name, LYD_CTX(node));
+                rc = SR_ERR_LY;
+                goto cleanup;
+            }
+            lyd_free_siblings(first);
+            first = NULL;
+        } else {
+            /* single node */
+            if (lyd_print_mem(&str, node, LYD_JSON, print_opts)) {
+                srpjson_log_err_ly(srpds_name, LYD_CTX(node));
+                rc = SR_ERR_LY;
+                goto cleanup;
+            }
+            inst = node->next;
+        }
+
+        /* strip the braces to get the member */
+        len = strlen(str);
+        if ((len < 2) || (str[0] != '{') || (str[len - 1] != '}')) {
+            /* unexpected format */
+            goto cleanup;
+        }
+        if (len > 2) {
+            if ((data->len > 1) && (rc = srpds_json_buf_add(data, ",", 1))) {
+                goto cleanup;
+            }
+
+            /* member segment */
+            seg.type = SRPDS_JSON_INDEX_SEG_MEMBER;
+            seg.len = len - 2;
+            seg.offset = data->len;
+            if ((rc = srpds_json_buf_add(index, &seg, sizeof seg))) {
+                goto cleanup;
+            }
+            if ((rc = srpds_json_buf_add(data, str + 1, seg.len))) {
+                goto cleanup;
+            }
+            ++hdr.seg_count;
+        }
+        free(str);
+        str = NULL;
+
+        node = inst;
+    }
+
+    if ((rc = srpds_json_buf_add(data, "}", 1))) {
+        goto cleanup;
+    }
+
+    /* index header */
+    hdr.magic = SRPDS_JSON_INDEX_MAGIC;
+    memcpy(index->mem, &hdr, sizeof hdr);
+    *indexed = 1;
+
+cleanup:
+    free(str);
+    free(prefix);
+    lyd_free_siblings(first);
+    lyd_free_tree(dup);
+    return rc;
+}
+
+/**
+ * @brief Write the index of a stored datastore file.
+ *
+ * @param[in] fd Datastore file descriptor.
+ * @param[in] path Datastore file path.
+ * @param[in] index Index to write, its header is updated.
+ * @return SR err value.
+ */
+static int
+srpds_json_index_write(int fd, const char *path, struct srpds_json_buf *index)
+{
+    int rc = SR_ERR_OK, ifd = -1;
+    char *index_path = NULL;
+    struct srpds_json_index_hdr hdr;
+    struct stat st;
+    struct iovec iov;
+
+    /* get index path */
+    if ((rc = srpds_json_get_index_path(path, &index_path))) {
+        goto cleanup;
+    }
+
+    /* the index is valid only for this exact data file */
+    if (fstat(fd, &st) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Stat of \"%s\" failed (%s).", path, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+    memcpy(&hdr, index->mem, sizeof hdr);
+    hdr.data_size = st.st_size;
+    hdr.data_mtime_sec = st.st_mtim.tv_sec;
+    hdr.data_mtime_nsec = st.st_mtim.tv_nsec;
+    memcpy(index->mem, &hdr, sizeof hdr);
+
+    /* create the index with the same permissions as the data file */
+    if ((ifd = srpjson_open(index_path, O_WRONLY | O_CREAT | O_TRUNC, st.st_mode & 0007777)) == -1) {
+        rc = srpjson_open_error(srpds_name, index_path);
+        goto cleanup;
+    }
+
+    iov.iov_base = index->mem;
+    iov.iov_len = index->len;
+    if ((rc = srpjson_writev(srpds_name, ifd, &iov, 1))) {
+        goto cleanup;
+    }
+
+cleanup:
+    if (ifd > -1) {
+        close(ifd);
+    }
+    if (rc && index_path) {
+        unlink(index_path);
+    }
+    free(index_path);
+    return rc;
+}
+
+/**
+ * @brief Open a temporary file for storing new startup data to be renamed over the data file.
+ *
+ * @param[in] path Data file path.
+ * @param[in] st Data file stat.
+ * @param[out] tmp_path Temporary file path, NULL if the data file owner cannot be kept and it must be backed up instead.
+ * @param[out] fd Opened temporary file, -1 if @p tmp_path is NULL.
+ * @return SR_ERR value.
+ */
+static int
+srpds_json_tmp_open(const char *path, const struct stat *st, char **tmp_path, int *fd)
+{
+    *tmp_path = NULL;
+    *fd = -1;
+
+    if (asprintf(tmp_path, "%s%s", path, SRPJSON_FILE_TMP_SUFFIX) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
+        *tmp_path = NULL;
+        return SR_ERR_NO_MEMORY;
+    }
+
+    /* create the file with same permissions, truncate any left by a previous failed store */
+    if ((*fd = srpjson_open(*tmp_path, O_WRONLY | O_CREAT | O_TRUNC, st->st_mode)) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Opening \"%s\" failed (%s).", *tmp_path, strerror(errno));
+        free(*tmp_path);
+        *tmp_path = NULL;
+        return SR_ERR_SYS;
+    }
+
+    if (((st->st_uid != geteuid()) || (st->st_gid != getegid())) && (fchown(*fd, st->st_uid, st->st_gid) == -1)) {
+        /* the new file would have a different owner, the data file must be rewritten in place */
+        close(*fd);
+        *fd = -1;
+        unlink(*tmp_path);
+        free(*tmp_path);
+        *tmp_path = NULL;
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Make stored data in a temporary file durable and rename it over the data file.
+ *
+ * @param[in] fd Temporary file descriptor.
+ * @param[in] tmp_path Temporary file path.
+ * @param[in] path Data file path.
+ * @return SR_ERR value.
+ */
+static int
+srpds_json_tmp_rename(int fd, const char *tmp_path, const char *path)
+{
+    int rc = SR_ERR_OK, dfd = -1;
+    char *dir = NULL, *ptr;
+
+    /* the data must be written before they replace the previous data */
+    if (fsync(fd) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Fsync of \"%s\" failed (%s).", tmp_path, strerror(errno));
+        return SR_ERR_SYS;
+    }
+
+    if (rename(tmp_path, path) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Renaming \"%s\" failed (%s).", tmp_path, strerror(errno));
+        return SR_ERR_SYS;
+    }
+
+    if (SRPJSON_DIR_SYNC) {
+        /* make the rename itself durable */
+        dir = strdup(path);
+        if (!dir) {
+            SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
+            rc = SR_ERR_NO_MEMORY;
+            goto cleanup;
+        }
+        if ((ptr = strrchr(dir, '/'))) {
+            *ptr = '\0';
+        }
+
+        if ((dfd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) == -1) {
+            SRPLG_LOG_ERR(srpds_name, "Opening \"%s\" failed (%s).", dir, strerror(errno));
+            rc = SR_ERR_SYS;
+            goto cleanup;
+        }
+        if (fsync(dfd) == -1) {
+            SRPLG_LOG_ERR(srpds_name, "Fsync of \"%s\" failed (%s).", dir, strerror(errno));
+            rc = SR_ERR_SYS;
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    if (dfd > -1) {
+        close(dfd);
+    }
+    free(dir);
+    return rc;
+}
+
 static int
 srpds_json_store_(const struct lys_module *mod, sr_datastore_t ds, const struct lyd_node *mod_data, const char *owner,
         const char *group, mode_t perm, int make_backup)
@@ -52,8 +597,10 @@ srpds_json_store_(const struct lys_module *mod, sr_datastore_t ds, const struct
     int rc = SR_ERR_OK;
     struct stat st;
     struct timespec times[2];
-    char *path = NULL, *bck_path = NULL;
-    int fd = -1, backup = 0, creat = 0;
+    char *path = NULL, *bck_path = NULL, *tmp_path = NULL;
+    int fd = -1, backup = 0, creat = 0, indexed = 0;
+    struct srpds_json_buf data = {0}, index = {0};
+    struct iovec iov;
     uint32_t print_opts;
     off_t size;
 
@@ -75,6 +622,15 @@ srpds_json_store_(const struct lys_module *mod, sr_datastore_t ds, const struct
             goto cleanup;
         }
 
+        if (SRPJSON_ATOMIC_STORE) {
+            /* write the data into a new file replacing the original one only once complete */
+            if ((rc = srpds_json_tmp_open(path, &st, &tmp_path, &fd))) {
+                goto cleanup;
+            }
+        }
+    }
+
+    if (make_backup && (ds == SR_DS_STARTUP) && !tmp_path) {
         /* generate the backup path */
         if (asprintf(&bck_path, "%s%s", path, SRPJSON_FILE_BACKUP_SUFFIX) == -1) {
             SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
@@ -101,7 +657,7 @@ srpds_json_store_(const struct lys_module *mod, sr_datastore_t ds, const struct
         }
     }
 
-    if (perm) {
+    if (!tmp_path && perm) {
         /* try to create the file */
         fd = srpjson_open(path, O_WRONLY | O_CREAT | O_EXCL, perm);
         if (fd > 0) {
@@ -116,59 +672,1081 @@ srpds_json_store_(const struct lys_module *mod, sr_datastore_t ds, const struct
         rc = srpjson_open_error(srpds_name, path);
         goto cleanup;
     }
-
-    if (creat && (owner || group)) {
-        /* change the owner of the created file */
-        if ((rc = srpjson_chmodown(srpds_name, path, owner, group, 0))) {
+
+    if (creat && (owner || group)) {
+        /* change the owner of the created file */
+        if ((rc = srpjson_chmodown(srpds_name, path, owner, group, 0))) {
+            goto cleanup;
+        }
+    }
+
+    /* any index is obsolete now */
+    if ((rc = srpds_json_index_remove(path))) {
+        goto cleanup;
+    }
+
+    /* print data */
+    print_opts = LYD_PRINT_SHRINK | LYD_PRINT_WITHSIBLINGS | LYD_PRINT_KEEPEMPTYCONT | LYD_PRINT_WD_IMPL_TAG;
+    if ((SRPJSON_DS_FORMAT == LYD_JSON) && (ds != SR_DS_OPERATIONAL) && srpds_json_index_needed(mod_data)) {
+        /* print the data so that they can be loaded partially */
+        if ((rc = srpds_json_print_indexed(mod_data, print_opts, &data, &index, &indexed))) {
+            goto cleanup;
+        }
+    }
+    if (indexed) {
+        iov.iov_base = data.mem;
+        iov.iov_len = data.len;
+        if ((rc = srpjson_writev(srpds_name, fd, &iov, 1))) {
+            goto cleanup;
+        }
+    } else if (lyd_print_fd(fd, mod_data, SRPJSON_DS_FORMAT, print_opts)) {
+        srpjson_log_err_ly(srpds_name, LYD_CTX(mod_data));
+        SRPLG_LOG_ERR(srpds_name, "Failed to store data into \"%s\".", path);
+        rc = SR_ERR_INTERNAL;
+        goto cleanup;
+    }
+
+    /* truncate the file to the exact size (to get rid of possible following old data) */
+    if ((size = lseek(fd, 0, SEEK_CUR)) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Failed to get the size of \"%s\" (%s).", path, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+    if (ftruncate(fd, size) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Failed to truncate \"%s\" (%s).", path, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+
+    /* manually update modification time to get maximum supported frequency updates (by default, some cached timestamp
+     * is used that has a really poor update period) */
+    times[0].tv_nsec = UTIME_OMIT;
+    clock_gettime(CLOCK_REALTIME, &times[1]);
+    if (futimens(fd, times) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Failed to update file \"%s\" modification time (%s).", path, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+
+    if (tmp_path) {
+        /* replace the original file */
+        if ((rc = srpds_json_tmp_rename(fd, tmp_path, path))) {
+            goto cleanup;
+        }
+        free(tmp_path);
+        tmp_path = NULL;
+    }
+
+    /* write the index, the data can always be loaded without it */
+    if (indexed && srpds_json_index_write(fd, path, &index)) {
+        SRPLG_LOG_WRN(srpds_name, "Failed to write \"%s\" %s index.", mod->name, srpjson_ds2str(ds));
+    }
+
+cleanup:
+    /* delete the backup file */
+    if (backup && (unlink(bck_path) == -1)) {
+        SRPLG_LOG_ERR(srpds_name, "Failed to remove backup \"%s\" (%s).", bck_path, strerror(errno));
+        if (!rc) {
+            rc = SR_ERR_SYS;
+        }
+    }
+
+    /* remove the unfinished new file */
+    if (tmp_path) {
+        unlink(tmp_path);
+    }
+
+    if (fd > -1) {
+        close(fd);
+    }
+    free(path);
+    free(bck_path);
+    free(tmp_path);
+    free(data.mem);
+    free(index.mem);
+    return rc;
+}
+
+/**
+ * @brief Get path to the diff journal of a module datastore file.
+ *
+ * @param[in] mod Module.
+ * @param[in] ds Datastore.
+ * @param[out] path Generated file path.
+ * @return SR err value.
+ */
+static int
+srpds_json_get_journal_path(const struct lys_module *mod, sr_datastore_t ds, char **path)
+{
+    int rc = SR_ERR_OK;
+    char *ds_path = NULL;
+
+    *path = NULL;
+
+    if ((rc = srpjson_get_path(srpds_name, mod->name, ds, &ds_path))) {
+        return rc;
+    }
+
+    if (asprintf(path, "%s%s", ds_path, SRPJSON_FILE_JOURNAL_SUFFIX) == -1) {
+        *path = NULL;
+        SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
+        rc = SR_ERR_NO_MEMORY;
+    }
+
+    free(ds_path);
+    return rc;
+}
+
+/**
+ * @brief Remove the diff journal of a module datastore file, if any.
+ *
+ * @param[in] mod Module.
+ * @param[in] ds Datastore.
+ * @return SR err value.
+ */
+static int
+srpds_json_journal_remove(const struct lys_module *mod, sr_datastore_t ds)
+{
+    int rc = SR_ERR_OK;
+    char *path = NULL;
+
+    if (!SRPDS_JSON_JOURNAL_DS(ds)) {
+        /* no journal */
+        return SR_ERR_OK;
+    }
+
+    if ((rc = srpds_json_get_journal_path(mod, ds, &path))) {
+        return rc;
+    }
+
+    if ((unlink(path) == -1) && (errno != ENOENT)) {
+        SRPLG_LOG_ERR(srpds_name, "Failed to unlink \"%s\" (%s).", path, strerror(errno));
+        rc = SR_ERR_SYS;
+    }
+
+    free(path);
+    return rc;
+}
+
+/**
+ * @brief Invalidate the diff journal of a module datastore file after its full data were stored.
+ *
+ * The data file is synced before the journal is removed so that the journaled changes are never lost. A journal
+ * that is left behind does not match the new data file and is ignored.
+ *
+ * @param[in] mod Module.
+ * @param[in] ds Datastore.
+ * @return SR err value.
+ */
+static int
+srpds_json_journal_invalidate(const struct lys_module *mod, sr_datastore_t ds)
+{
+    int rc = SR_ERR_OK, fd = -1;
+    char *path = NULL;
+
+    if (!SRPDS_JSON_JOURNAL_DS(ds)) {
+        /* no journal */
+        return SR_ERR_OK;
+    }
+
+    if ((rc = srpjson_get_path(srpds_name, mod->name, ds, &path))) {
+        goto cleanup;
+    }
+
+    /* make sure the full data are written */
+    if ((fd = srpjson_open(path, O_RDONLY, 0)) == -1) {
+        rc = srpjson_open_error(srpds_name, path);
+        goto cleanup;
+    }
+    if (fsync(fd) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Fsync of \"%s\" failed (%s).", path, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+
+    /* the journal is obsolete */
+    rc = srpds_json_journal_remove(mod, ds);
+
+cleanup:
+    if (fd > -1) {
+        close(fd);
+    }
+    free(path);
+    return rc;
+}
+
+/**
+ * @brief Compute the checksum (FNV-1a) of the content of a data file.
+ *
+ * @param[in] fd Data file descriptor.
+ * @param[in] st Data file stat.
+ * @param[out] checksum Data file checksum.
+ * @return SR err value.
+ */
+static int
+srpds_json_journal_data_checksum(int fd, const struct stat *st, uint64_t *checksum)
+{
+    unsigned char buf[8192];
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    off_t off;
+    ssize_t r, i;
+
+    for (off = 0; off < st->st_size; off += r) {
+        r = pread(fd, buf, ((st->st_size - off) < (off_t)sizeof buf) ? (size_t)(st->st_size - off) : sizeof buf, off);
+        if (r == -1) {
+            SRPLG_LOG_ERR(srpds_name, "Read of a data file failed (%s).", strerror(errno));
+            return SR_ERR_SYS;
+        } else if (!r) {
+            break;
+        }
+
+        for (i = 0; i < r; ++i) {
+            hash ^= buf[i];
+            hash *= 0x100000001b3ULL;
+        }
+    }
+
+    *checksum = hash;
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Learn whether a journal header matches a data file.
+ *
+ * @param[in] hdr Journal header.
+ * @param[in] fd Data file descriptor.
+ * @param[in] st Data file stat.
+ * @param[out] match Whether the journal applies to the data file.
+ * @return SR err value.
+ */
+static int
+srpds_json_journal_hdr_match(const struct srpds_json_journal_hdr *hdr, int fd, const struct stat *st, int *match)
+{
+    int rc;
+    uint64_t checksum;
+
+    *match = 0;
+
+    if ((hdr->magic != SRPDS_JSON_JOURNAL_MAGIC) || (hdr->version != SRPDS_JSON_JOURNAL_VERSION) ||
+            (hdr->data_size != (uint64_t)st->st_size) || (hdr->data_mtime_sec != st->st_mtim.tv_sec) ||
+            (hdr->data_mtime_nsec != st->st_mtim.tv_nsec)) {
+        /* obsolete, no need to read the data */
+        return SR_ERR_OK;
+    }
+
+    /* the data may still have been stored again with the same size and modification time */
+    if ((rc = srpds_json_journal_data_checksum(fd, st, &checksum))) {
+        return rc;
+    }
+    *match = (hdr->data_checksum == checksum);
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Learn the size of the records of an opened diff journal.
+ *
+ * @param[in] fd Journal file descriptor.
+ * @param[in] jpath Journal path.
+ * @param[in] data_fd Journaled data file descriptor.
+ * @param[in] st Stat of the journaled data file.
+ * @param[out] size Size of the journal, 0 if it does not match the data file and must be started again.
+ * @param[out] torn Whether the last record was not written completely.
+ * @return SR err value.
+ */
+static int
+srpds_json_journal_size(int fd, const char *jpath, int data_fd, const struct stat *st, off_t *size, int *torn)
+{
+    struct srpds_json_journal_hdr hdr;
+    struct stat jst;
+    uint32_t len;
+    off_t off;
+    ssize_t r;
+    int rc, match;
+
+    *size = 0;
+    *torn = 0;
+
+    if (fstat(fd, &jst) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Stat of \"%s\" failed (%s).", jpath, strerror(errno));
+        return SR_ERR_SYS;
+    }
+
+    /* read the header */
+    if ((size_t)jst.st_size < sizeof hdr) {
+        return SR_ERR_OK;
+    }
+    if ((r = pread(fd, &hdr, sizeof hdr, 0)) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Read of \"%s\" failed (%s).", jpath, strerror(errno));
+        return SR_ERR_SYS;
+    }
+    if ((size_t)r < sizeof hdr) {
+        return SR_ERR_OK;
+    }
+    if ((rc = srpds_json_journal_hdr_match(&hdr, data_fd, st, &match))) {
+        return rc;
+    }
+    if (!match) {
+        return SR_ERR_OK;
+    }
+
+    /* walk the records */
+    for (off = sizeof hdr; off < jst.st_size; off += sizeof len + len) {
+        if ((r = pread(fd, &len, sizeof len, off)) == -1) {
+            SRPLG_LOG_ERR(srpds_name, "Read of \"%s\" failed (%s).", jpath, strerror(errno));
+            return SR_ERR_SYS;
+        }
+        if (((size_t)r < sizeof len) || !len || (len > jst.st_size - off - sizeof len)) {
+            *torn = 1;
+            break;
+        }
+    }
+
+    *size = jst.st_size;
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Append a diff of module data to the diff journal of the datastore file.
+ *
+ * The diff is not appended if the journal would exceed its maximum size or grow larger than the datastore file
+ * itself, or if the last record was not written completely. The journal needs to be compacted by storing the full
+ * data, instead.
+ *
+ * @param[in] mod Module.
+ * @param[in] ds Datastore.
+ * @param[in] mod_diff Diff to append.
+ * @param[out] appended Whether the diff was appended or not.
+ * @return SR err value.
+ */
+static int
+srpds_json_journal_append(const struct lys_module *mod, sr_datastore_t ds, const struct lyd_node *mod_diff, int *appended)
+{
+    int rc = SR_ERR_OK, fd = -1, dfd = -1, torn = 0, iov_count = 0;
+    char *path = NULL, *jpath = NULL, *diff_str = NULL;
+    struct srpds_json_journal_hdr hdr = {0};
+    struct stat st;
+    struct iovec iov[3];
+    struct timespec times[2];
+    uint32_t print_opts, len;
+    off_t jsize = 0, size;
+
+    *appended = 0;
+
+    /* get paths */
+    if ((rc = srpjson_get_path(srpds_name, mod->name, ds, &path))) {
+        goto cleanup;
+    }
+    if ((rc = srpds_json_get_journal_path(mod, ds, &jpath))) {
+        goto cleanup;
+    }
+
+    /* open the data file and get its size and permissions */
+    if ((dfd = srpjson_open(path, O_RDONLY, 0)) == -1) {
+        if (errno == ENOENT) {
+            /* no data file, store the full data */
+            goto cleanup;
+        }
+        rc = srpjson_open_error(srpds_name, path);
+        goto cleanup;
+    }
+    if (fstat(dfd, &st) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Stat of \"%s\" failed (%s).", path, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+
+    /* print the diff */
+    print_opts = LYD_PRINT_SHRINK | LYD_PRINT_WITHSIBLINGS | LYD_PRINT_KEEPEMPTYCONT | LYD_PRINT_WD_IMPL_TAG;
+    if (lyd_print_mem(&diff_str, mod_diff, LYD_JSON, print_opts)) {
+        srpjson_log_err_ly(srpds_name, LYD_CTX(mod_diff));
+        rc = SR_ERR_LY;
+        goto cleanup;
+    }
+    len = strlen(diff_str) + 1;
+
+    /* open any existing journal and learn its size */
+    if ((fd = srpjson_open(jpath, O_RDWR, 0)) == -1) {
+        if (errno != ENOENT) {
+            rc = srpjson_open_error(srpds_name, jpath);
+            goto cleanup;
+        }
+    } else if ((rc = srpds_json_journal_size(fd, jpath, dfd, &st, &jsize, &torn))) {
+        goto cleanup;
+    }
+    if (torn) {
+        /* a previous append was interrupted, compact the journal */
+        goto cleanup;
+    }
+
+    /* check whether it is worth appending, compact the journal otherwise */
+    size = (jsize ? jsize : (off_t)sizeof hdr) + sizeof len + len;
+    if ((size > SRPJSON_JOURNAL_MAX_SIZE * 1024) || (size > st.st_size)) {
+        goto cleanup;
+    }
+
+    if (fd == -1) {
+        /* create the journal, with the same permissions as the data file */
+        if ((fd = srpjson_open(jpath, O_RDWR | O_CREAT, st.st_mode & 0007777)) == -1) {
+            rc = srpjson_open_error(srpds_name, jpath);
+            goto cleanup;
+        }
+    }
+
+    if (!jsize) {
+        /* start a new journal for the current data file */
+        if (ftruncate(fd, 0) == -1) {
+            SRPLG_LOG_ERR(srpds_name, "Failed to truncate \"%s\" (%s).", jpath, strerror(errno));
+            rc = SR_ERR_SYS;
+            goto cleanup;
+        }
+        hdr.magic = SRPDS_JSON_JOURNAL_MAGIC;
+        hdr.version = SRPDS_JSON_JOURNAL_VERSION;
+        hdr.data_size = st.st_size;
+        hdr.data_mtime_sec = st.st_mtim.tv_sec;
+        hdr.data_mtime_nsec = st.st_mtim.tv_nsec;
+        if ((rc = srpds_json_journal_data_checksum(dfd, &st, &hdr.data_checksum))) {
+            goto cleanup;
+        }
+        iov[iov_count].iov_base = &hdr;
+        iov[iov_count].iov_len = sizeof hdr;
+        ++iov_count;
+    }
+    if (lseek(fd, jsize, SEEK_SET) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Failed to seek in \"%s\" (%s).", jpath, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+
+    /* append the record, including the terminating zero */
+    iov[iov_count].iov_base = &len;
+    iov[iov_count].iov_len = sizeof len;
+    ++iov_count;
+    iov[iov_count].iov_base = diff_str;
+    iov[iov_count].iov_len = len;
+    ++iov_count;
+    if ((rc = srpjson_writev(srpds_name, fd, iov, iov_count))) {
+        goto cleanup;
+    }
+
+    /* update modification time, same as for the data file */
+    times[0].tv_nsec = UTIME_OMIT;
+    clock_gettime(CLOCK_REALTIME, &times[1]);
+    if (futimens(fd, times) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Failed to update file \"%s\" modification time (%s).", jpath, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+
+    *appended = 1;
+
+cleanup:
+    if (fd > -1) {
+        close(fd);
+    }
+    if (dfd > -1) {
+        close(dfd);
+    }
+    free(path);
+    free(jpath);
+    free(diff_str);
+    return rc;
+}
+
+/**
+ * @brief Apply all the diffs from the diff journal of a datastore file on the loaded data.
+ *
+ * A journal that does not match the data file is obsolete and ignored, same as an incomplete last record
+ * of an interrupted append.
+ *
+ * @param[in] mod Module.
+ * @param[in] ds Datastore.
+ * @param[in] data_fd Opened data file descriptor.
+ * @param[in,out] mod_data Module data to update.
+ * @return SR err value.
+ */
+static int
+srpds_json_journal_replay(const struct lys_module *mod, sr_datastore_t ds, int data_fd, struct lyd_node **mod_data)
+{
+    int rc = SR_ERR_OK, fd = -1, match;
+    char *jpath = NULL, *buf = NULL;
+    struct srpds_json_journal_hdr hdr;
+    struct lyd_node *diff = NULL;
+    struct stat st, dst;
+    uint32_t len;
+    off_t off;
+
+    if ((rc = srpds_json_get_journal_path(mod, ds, &jpath))) {
+        goto cleanup;
+    }
+
+    /* open the journal */
+    if ((fd = srpjson_open(jpath, O_RDONLY, 0)) == -1) {
+        if (errno == ENOENT) {
+            /* no changes */
+            goto cleanup;
+        }
+        rc = srpjson_open_error(srpds_name, jpath);
+        goto cleanup;
+    }
+
+    /* read it whole */
+    if (fstat(fd, &st) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Stat of \"%s\" failed (%s).", jpath, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+    if ((size_t)st.st_size < sizeof hdr) {
+        /* no changes */
+        goto cleanup;
+    }
+    if (!(buf = malloc(st.st_size))) {
+        SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
+        rc = SR_ERR_NO_MEMORY;
+        goto cleanup;
+    }
+    if ((rc = srpjson_read(srpds_name, fd, buf, st.st_size))) {
+        goto cleanup;
+    }
+
+    /* check the journal belongs to the data file */
+    if (fstat(data_fd, &dst) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Stat of \"%s\" data failed (%s).", mod->name, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+    memcpy(&hdr, buf, sizeof hdr);
+    if ((rc = srpds_json_journal_hdr_match(&hdr, data_fd, &dst, &match))) {
+        goto cleanup;
+    }
+    if (!match) {
+        /* obsolete journal, full data were stored after it */
+        goto cleanup;
+    }
+
+    /* apply all the diffs in order */
+    for (off = sizeof hdr; off < st.st_size; off += len) {
+        if ((size_t)(st.st_size - off) < sizeof len) {
+            break;
+        }
+        memcpy(&len, buf + off, sizeof len);
+        off += sizeof len;
+        if (!len || (len > st.st_size - off) || buf[off + len - 1]) {
+            break;
+        }
+
+        if (lyd_parse_data_mem(mod->ctx, buf + off, LYD_JSON, LYD_PARSE_ONLY | LYD_PARSE_STRICT, 0, &diff)) {
+            if (off + len == st.st_size) {
+                /* incomplete last record */
+                break;
+            }
+            srpjson_log_err_ly(srpds_name, mod->ctx);
+            rc = SR_ERR_LY;
+            goto cleanup;
+        }
+        if (lyd_diff_apply_module(mod_data, diff, mod, NULL, NULL)) {
+            srpjson_log_err_ly(srpds_name, mod->ctx);
+            rc = SR_ERR_LY;
+            goto cleanup;
+        }
+        lyd_free_siblings(diff);
+        diff = NULL;
+    }
+    if (off < st.st_size) {
+        /* the append of the last record was interrupted and the change never stored */
+        SRPLG_LOG_WRN(srpds_name, "Ignoring incomplete last record of journal \"%s\".", jpath);
+    }
+
+cleanup:
+    if (fd > -1) {
+        close(fd);
+    }
+    free(jpath);
+    free(buf);
+    lyd_free_siblings(diff);
+    return rc;
+}
+
+/**
+ * @brief Learn whether an XPath can be evaluated on module data loaded using an index.
+ *
+ * @param[in] mod Module.
+ * @param[in] xpath XPath to examine.
+ * @param[out] name Module-qualified name of the selected top-level node.
+ * @param[out] name_len Length of @p name.
+ * @param[out] preds Predicates of the top-level node, NULL if none.
+ * @return Whether the XPath selects only the top-level node and its descendants.
+ */
+static int
+srpds_json_xpath_split(const struct lys_module *mod, const char *xpath, const char **name, uint32_t *name_len,
+        const char **preds)
+{
+    const char *ptr;
+    size_t mod_len = strlen(mod->name);
+    uint32_t depth = 0;
+    char quot = 0;
+
+    /* absolute path starting with a node of this module */
+    if ((xpath[0] != '/') || strncmp(xpath + 1, mod->name, mod_len) || (xpath[mod_len + 1] != ':')) {
+        return 0;
+    }
+    *name = xpath + 1;
+    for (ptr = xpath + mod_len + 2; isalnum(*ptr) || (*ptr == '_') || (*ptr == '-') || (*ptr == '.'); ++ptr) {}
+    *name_len = ptr - *name;
+    if ((*name_len == mod_len + 1) || (*ptr && (*ptr != '[') && (*ptr != '/'))) {
+        return 0;
+    }
+    *preds = (*ptr == '[') ? ptr : NULL;
+
+    /* the rest must not refer to any other data */
+    for ( ; *ptr; ++ptr) {
+        if (quot) {
+            if (*ptr == quot) {
+                quot = 0;
+            }
+            continue;
+        }
+
+        switch (*ptr) {
+        case '\'':
+        case '"':
+            quot = *ptr;
+            break;
+        case '[':
+            ++depth;
+            break;
+        case ']':
+            if (!depth) {
+                return 0;
+            }
+            --depth;
+            break;
+        case '/':
+            if (depth || (ptr[1] == '/')) {
+                /* absolute path in a predicate or any descendant */
+                return 0;
+            }
+            break;
+        case '.':
+        case ':':
+            if (ptr[1] == *ptr) {
+                /* parent or an axis */
+                return 0;
+            }
+            break;
+        case '|':
+        case '(':
+        case '$':
+            /* union, function, or variable */
+            return 0;
+        }
+    }
+
+    return !quot && !depth;
+}
+
+/**
+ * @brief Parse predicates selecting a single list instance by all its keys.
+ *
+ * @param[in] preds Predicates to parse.
+ * @param[in] slist List schema node.
+ * @param[in] key_count Number of @p slist keys.
+ * @param[out] values Key values in the schema order pointing to @p preds, must be zeroed.
+ * @param[out] value_lens Lengths of @p values.
+ * @return Whether the predicates can be compared to stored canonical key values.
+ */
+static int
+srpds_json_parse_key_preds(const char *preds, const struct lysc_node *slist, uint32_t key_count, const char **values,
+        uint32_t *value_lens)
+{
+    const struct lysc_node *skey;
+    const char *ptr = preds, *name, *end;
+    uint32_t i, name_len, found = 0;
+
+    while (*ptr == '[') {
+        /* key name, the prefix can only be the module name */
+        for (++ptr; isspace(*ptr); ++ptr) {}
+        for (name = ptr; isalnum(*ptr) || (*ptr == '_') || (*ptr == '-') || (*ptr == '.') || (*ptr == ':'); ++ptr) {}
+        if ((end = memchr(name, ':', ptr - name))) {
+            name = end + 1;
+        }
+        name_len = ptr - name;
+
+        /* find the key */
+        for (skey = lysc_node_child(slist), i = 0; skey && (skey->flags & LYS_KEY); skey = skey->next, ++i) {
+            if (!strncmp(skey->name, name, name_len) && !skey->name[name_len]) {
+                break;
+            }
+        }
+        if (!skey || !(skey->flags & LYS_KEY) || values[i]) {
+            return 0;
+        }
+        if (((struct lysc_node_leaf *)skey)->type->basetype != LY_TYPE_STRING) {
+            /* the value may not be canonical */
+            return 0;
+        }
+
+        /* value */
+        for ( ; isspace(*ptr); ++ptr) {}
+        if (*ptr != '=') {
+            return 0;
+        }
+        for (++ptr; isspace(*ptr); ++ptr) {}
+        if ((*ptr != '\'') && (*ptr != '"')) {
+            return 0;
+        }
+        if (!(end = strchr(ptr + 1, *ptr))) {
+            return 0;
+        }
+        values[i] = ptr + 1;
+        value_lens[i] = end - values[i];
+        for (ptr = end + 1; isspace(*ptr); ++ptr) {}
+        if (*ptr != ']') {
+            return 0;
+        }
+        ++ptr;
+        ++found;
+    }
+
+    return found == key_count;
+}
+
+/**
+ * @brief Get the next part of an index.
+ *
+ * @param[in] index Index.
+ * @param[in] size Size of @p index.
+ * @param[in,out] off Offset of the part, is moved after it.
+ * @param[in] len Length of the part.
+ * @return Pointer to the part, NULL if the index is truncated.
+ */
+static const char *
+srpds_json_index_get(const char *index, size_t size, size_t *off, size_t len)
+{
+    const char *ptr;
+
+    if (len > size - *off) {
+        return NULL;
+    }
+
+    ptr = index + *off;
+    *off += len;
+    return ptr;
+}
+
+/**
+ * @brief Append a range of a data file to a memory buffer.
+ *
+ * @param[in] fd Data file descriptor.
+ * @param[in] off Offset of the range.
+ * @param[in] len Length of the range.
+ * @param[in] buf Buffer to append to.
+ * @return SR err value.
+ */
+static int
+srpds_json_buf_add_range(int fd, uint64_t off, uint32_t len, struct srpds_json_buf *buf)
+{
+    int rc;
+    char *ptr;
+    ssize_t r;
+
+    if ((rc = srpds_json_buf_add(buf, NULL, len))) {
+        return rc;
+    }
+    ptr = buf->mem + buf->len - len;
+
+    while (len) {
+        r = pread(fd, ptr, len, off);
+        if (r > 0) {
+            ptr += r;
+            off += r;
+            len -= r;
+        } else if (!r) {
+            SRPLG_LOG_ERR(srpds_name, "Unexpected end of the indexed data file.");
+            return SR_ERR_INTERNAL;
+        } else if (errno != EINTR) {
+            SRPLG_LOG_ERR(srpds_name, "Reading data failed (%s).", strerror(errno));
+            return SR_ERR_SYS;
+        }
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Load only the module data selected by XPaths using the datastore file index.
+ *
+ * All the top-level members are always loaded, only the entries of top-level keyed lists are selected
+ * based on the @p xpaths.
+ *
+ * @param[in] mod Module.
+ * @param[in] ds Datastore.
+ * @param[in] path Datastore file path.
+ * @param[in] fd Datastore file descriptor.
+ * @param[in] xpaths Array of XPaths selecting the required data.
+ * @param[in] xpath_count Number of @p xpaths.
+ * @param[in] parse_opts Parse options.
+ * @param[out] mod_data Loaded module data.
+ * @param[out] loaded Whether the data were loaded, if not, all the data must be loaded.
+ * @return SR err value.
+ */
+static int
+srpds_json_load_indexed(const struct lys_module *mod, sr_datastore_t ds, const char *path, int fd, const char **xpaths,
+        uint32_t xpath_count, uint32_t parse_opts, struct lyd_node **mod_data, int *loaded)
+{
+    int rc = SR_ERR_OK, ifd = -1, sel;
+    char *index_path = NULL, *jpath = NULL, *index = NULL, *list_path = NULL;
+    const char *ptr, **names = NULL, **preds = NULL, *values[SRPDS_JSON_INDEX_MAX_KEYS];
+    const char **sel_values = NULL;
+    uint32_t *name_lens = NULL, *sel_lens = NULL, value_lens[SRPDS_JSON_INDEX_MAX_KEYS], key_count, key_len, i, j, k;
+    int *sel_all = NULL;
+    const struct lysc_node *slist;
+    struct srpds_json_index_hdr hdr;
+    struct srpds_json_index_rec seg, rec;
+    struct srpds_json_buf doc = {0};
+    struct stat st, ist;
+    uint64_t e;
+    size_t off, seg_start, doc_len;
+
+    *loaded = 0;
+
+    if (SRPDS_JSON_JOURNAL_DS(ds)) {
+        /* journaled changes are not indexed */
+        if ((rc = srpds_json_get_journal_path(mod, ds, &jpath))) {
+            goto cleanup;
+        }
+        if (srpjson_file_exists(srpds_name, jpath)) {
+            goto cleanup;
+        }
+    }
+
+    /* learn what top-level nodes the XPaths select */
+    names = malloc(xpath_count * sizeof *names);
+    name_lens = malloc(xpath_count * sizeof *name_lens);
+    preds = malloc(xpath_count * sizeof *preds);
+    sel_all = malloc(xpath_count * sizeof *sel_all);
+    sel_values = malloc(xpath_count * SRPDS_JSON_INDEX_MAX_KEYS * sizeof *sel_values);
+    sel_lens = malloc(xpath_count * SRPDS_JSON_INDEX_MAX_KEYS * sizeof *sel_lens);
+    if (!names || !name_lens || !preds || !sel_all || !sel_values || !sel_lens) {
+        SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
+        rc = SR_ERR_NO_MEMORY;
+        goto cleanup;
+    }
+    for (i = 0; i < xpath_count; ++i) {
+        if (!srpds_json_xpath_split(mod, xpaths[i], &names[i], &name_lens[i], &preds[i])) {
             goto cleanup;
         }
     }
 
-    /* print data */
-    print_opts = LYD_PRINT_SHRINK | LYD_PRINT_WITHSIBLINGS | LYD_PRINT_KEEPEMPTYCONT | LYD_PRINT_WD_IMPL_TAG;
-    if (lyd_print_fd(fd, mod_data, LYD_JSON, print_opts)) {
-        srpjson_log_err_ly(srpds_name, LYD_CTX(mod_data));
-        SRPLG_LOG_ERR(srpds_name, "Failed to store data into \"%s\".", path);
-        rc = SR_ERR_INTERNAL;
+    /* open the index */
+    if ((rc = srpds_json_get_index_path(path, &index_path))) {
+        goto cleanup;
+    }
+    if ((ifd = srpjson_open(index_path, O_RDONLY, 0)) == -1) {
+        /* no index */
         goto cleanup;
     }
 
-    /* truncate the file to the exact size (to get rid of possible following old data) */
-    if ((size = lseek(fd, 0, SEEK_CUR)) == -1) {
-        SRPLG_LOG_ERR(srpds_name, "Failed to get the size of \"%s\" (%s).", path, strerror(errno));
+    /* read it whole */
+    if ((fstat(fd, &st) == -1) || (fstat(ifd, &ist) == -1)) {
+        SRPLG_LOG_ERR(srpds_name, "Stat of \"%s\" failed (%s).", index_path, strerror(errno));
         rc = SR_ERR_SYS;
         goto cleanup;
     }
-    if (ftruncate(fd, size) == -1) {
-        SRPLG_LOG_ERR(srpds_name, "Failed to truncate \"%s\" (%s).", path, strerror(errno));
-        rc = SR_ERR_SYS;
+    if ((size_t)ist.st_size < sizeof hdr) {
+        goto cleanup;
+    }
+    if (!(index = malloc(ist.st_size))) {
+        SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
+        rc = SR_ERR_NO_MEMORY;
+        goto cleanup;
+    }
+    if ((rc = srpjson_read(srpds_name, ifd, index, ist.st_size))) {
         goto cleanup;
     }
 
-    /* manually update modification time to get maximum supported frequency updates (by default, some cached timestamp
-     * is used that has a really poor update period) */
-    times[0].tv_nsec = UTIME_OMIT;
-    clock_gettime(CLOCK_REALTIME, &times[1]);
-    if (futimens(fd, times) == -1) {
-        SRPLG_LOG_ERR(srpds_name, "Failed to update file \"%s\" modification time (%s).", path, strerror(errno));
-        rc = SR_ERR_SYS;
+    /* check it is the index of this exact data file */
+    off = 0;
+    memcpy(&hdr, srpds_json_index_get(index, ist.st_size, &off, sizeof hdr), sizeof hdr);
+    if ((hdr.magic != SRPDS_JSON_INDEX_MAGIC) || (hdr.data_size != (uint64_t)st.st_size) ||
+            (hdr.data_mtime_sec != st.st_mtim.tv_sec) || (hdr.data_mtime_nsec != st.st_mtim.tv_nsec)) {
         goto cleanup;
     }
 
-cleanup:
-    /* delete the backup file */
-    if (backup && (unlink(bck_path) == -1)) {
-        SRPLG_LOG_ERR(srpds_name, "Failed to remove backup \"%s\" (%s).", bck_path, strerror(errno));
-        if (!rc) {
-            rc = SR_ERR_SYS;
+    /* build the document from all the segments in their original order */
+    if ((rc = srpds_json_buf_add(&doc, "{", 1))) {
+        goto cleanup;
+    }
+    for (i = 0; i < hdr.seg_count; ++i) {
+        if (!(ptr = srpds_json_index_get(index, ist.st_size, &off, sizeof seg))) {
+            goto corrupted;
+        }
+        memcpy(&seg, ptr, sizeof seg);
+
+        if (seg.type == SRPDS_JSON_INDEX_SEG_MEMBER) {
+            /* always loaded */
+            if ((doc.len > 1) && (rc = srpds_json_buf_add(&doc, ",", 1))) {
+                goto cleanup;
+            }
+            if ((rc = srpds_json_buf_add_range(fd, seg.offset, seg.len, &doc))) {
+                goto cleanup;
+            }
+            continue;
+        } else if (seg.type != SRPDS_JSON_INDEX_SEG_LIST) {
+            goto corrupted;
+        }
+
+        /* list name and keys */
+        if (!(ptr = srpds_json_index_get(index, ist.st_size, &off, seg.len))) {
+            goto corrupted;
+        }
+        free(list_path);
+        if (asprintf(&list_path, "/%.*s", (int)seg.len, ptr) == -1) {
+            list_path = NULL;
+            SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
+            rc = SR_ERR_NO_MEMORY;
+            goto cleanup;
+        }
+        if (!(ptr = srpds_json_index_get(index, ist.st_size, &off, sizeof key_count))) {
+            goto corrupted;
+        }
+        memcpy(&key_count, ptr, sizeof key_count);
+
+        /* learn how the XPaths select the entries */
+        slist = lys_find_path(mod->ctx, NULL, list_path, 0);
+        if (!slist || (slist->nodetype != LYS_LIST)) {
+            goto corrupted;
+        }
+        sel = 0;
+        for (j = 0; j < xpath_count; ++j) {
+            sel_all[j] = 0;
+            sel_values[j * SRPDS_JSON_INDEX_MAX_KEYS] = NULL;
+            if ((name_lens[j] != seg.len) || strncmp(names[j], list_path + 1, seg.len)) {
+                /* not selected */
+                continue;
+            }
+            sel = 1;
+
+            memset(values, 0, sizeof values);
+            if (!preds[j] || (key_count > SRPDS_JSON_INDEX_MAX_KEYS) ||
+                    !srpds_json_parse_key_preds(preds[j], slist, key_count, values, value_lens)) {
+                /* all the entries may be selected */
+                sel_all[j] = 1;
+                continue;
+            }
+            memcpy(&sel_values[j * SRPDS_JSON_INDEX_MAX_KEYS], values, key_count * sizeof *values);
+            memcpy(&sel_lens[j * SRPDS_JSON_INDEX_MAX_KEYS], value_lens, key_count * sizeof *value_lens);
+        }
+
+        seg_start = doc.len;
+        if (sel) {
+            if ((doc.len > 1) && (rc = srpds_json_buf_add(&doc, ",", 1))) {
+                goto cleanup;
+            }
+            if ((rc = srpds_json_buf_add(&doc, "\"", 1)) || (rc = srpds_json_buf_add(&doc, list_path + 1, seg.len)) ||
+                    (rc = srpds_json_buf_add(&doc, "\":[", 3))) {
+                goto cleanup;
+            }
+        }
+        doc_len = doc.len;
+
+        for (e = 0; e < seg.offset; ++e) {
+            if (!(ptr = srpds_json_index_get(index, ist.st_size, &off, sizeof rec))) {
+                goto corrupted;
+            }
+            memcpy(&rec, ptr, sizeof rec);
+
+            /* read the keys */
+            for (k = 0; k < key_count; ++k) {
+                if (!(ptr = srpds_json_index_get(index, ist.st_size, &off, sizeof key_len))) {
+                    goto corrupted;
+                }
+                memcpy(&key_len, ptr, sizeof key_len);
+                if (!(ptr = srpds_json_index_get(index, ist.st_size, &off, key_len))) {
+                    goto corrupted;
+                }
+                if (k < SRPDS_JSON_INDEX_MAX_KEYS) {
+                    values[k] = ptr;
+                    value_lens[k] = key_len;
+                }
+            }
+
+            /* compare them with all the selecting XPaths */
+            for (j = 0; j < xpath_count; ++j) {
+                if (sel_all[j]) {
+                    break;
+                }
+                if (!sel_values[j * SRPDS_JSON_INDEX_MAX_KEYS]) {
+                    continue;
+                }
+
+                for (k = 0; k < key_count; ++k) {
+                    if ((sel_lens[j * SRPDS_JSON_INDEX_MAX_KEYS + k] != value_lens[k]) ||
+                            strncmp(sel_values[j * SRPDS_JSON_INDEX_MAX_KEYS + k], values[k], value_lens[k])) {
+                        break;
+                    }
+                }
+                if (k == key_count) {
+                    /* all the keys match */
+                    break;
+                }
+            }
+            if (j == xpath_count) {
+                /* entry not selected */
+                continue;
+            }
+
+            /* selected */
+            if ((doc.len > doc_len) && (rc = srpds_json_buf_add(&doc, ",", 1))) {
+                goto cleanup;
+            }
+            if ((rc = srpds_json_buf_add_range(fd, rec.offset, rec.len, &doc))) {
+                goto cleanup;
+            }
+        }
+
+        if (sel) {
+            if (doc.len == doc_len) {
+                /* no entries, remove the member */
+                doc.len = seg_start;
+            } else if ((rc = srpds_json_buf_add(&doc, "]", 1))) {
+                goto cleanup;
+            }
         }
     }
+    /* including the terminating zero */
+    if ((rc = srpds_json_buf_add(&doc, "}", 2))) {
+        goto cleanup;
+    }
 
-    if (fd > -1) {
-        close(fd);
+    /* parse the selected data */
+    if (lyd_parse_data_mem(mod->ctx, doc.mem, LYD_JSON, parse_opts, 0, mod_data)) {
+        srpjson_log_err_ly(srpds_name, mod->ctx);
+        rc = SR_ERR_LY;
+        goto cleanup;
     }
-    free(path);
-    free(bck_path);
+    *loaded = 1;
+    goto cleanup;
+
+corrupted:
+    /* load all the data */
+    SRPLG_LOG_WRN(srpds_name, "Index \"%s\" is corrupted.", index_path);
+
+cleanup:
+    if (ifd > -1) {
+        close(ifd);
+    }
+    free(index_path);
+    free(jpath);
+    free(index);
+    free(list_path);
+    free(names);
+    free(name_lens);
+    free(preds);
+    free(sel_all);
+    free(sel_values);
+    free(sel_lens);
+    free(doc.mem);
     return rc;
 }
 
@@ -281,11 +1859,21 @@ srpds_json_uninstall(const struct lys_module *mod, sr_datastore_t ds)
         SRPLG_LOG_WRN(srpds_name, "Failed to unlink \"%s\" (%s).", path, strerror(errno));
     }
 
+    /* unlink index */
+    if (srpds_json_index_remove(path)) {
+        SRPLG_LOG_WRN(srpds_name, "Failed to remove \"%s\" %s index.", mod->name, srpjson_ds2str(ds));
+    }
+
     if ((ds == SR_DS_STARTUP) || (ds == SR_DS_FACTORY_DEFAULT)) {
         /* done */
         goto cleanup;
     }
 
+    /* unlink journal */
+    if (srpds_json_journal_remove(mod, ds)) {
+        SRPLG_LOG_WRN(srpds_name, "Failed to remove \"%s\" %s journal.", mod->name, srpjson_ds2str(ds));
+    }
+
     /* unlink perm file */
     free(path);
     if ((rc = srpjson_get_perm_path(srpds_name, mod->name, ds, &path))) {
@@ -333,12 +1921,17 @@ srpds_json_init(const struct lys_module *mod, sr_datastore_t ds)
         goto cleanup;
     }
 
-    /* print empty JSON file */
-    if (lyd_print_fd(fd, NULL, LYD_JSON, LYD_PRINT_SHRINK)) {
+    /* print empty data file */
+    if (lyd_print_fd(fd, NULL, SRPJSON_DS_FORMAT, LYD_PRINT_SHRINK)) {
         rc = SR_ERR_LY;
         goto cleanup;
     }
 
+    /* remove any previous journal */
+    if ((rc = srpds_json_journal_remove(mod, ds))) {
+        goto cleanup;
+    }
+
     /* update the owner/group of the file */
     if ((rc = srpjson_chmodown(srpds_name, path, owner, group, 0))) {
         goto cleanup;
@@ -354,12 +1947,159 @@ cleanup:
     return rc;
 }
 
+/**
+ * @brief Create a new candidate data file from the running data file and only journal the candidate changes.
+ *
+ * The running data file and its journal are copied (as reflinks, if supported) so that storing the first candidate
+ * changes does not require printing all the data. Running data may have been changed since the candidate changes
+ * were made so the journaled diff is generated from the copied running data and not taken from the caller. If
+ * running data are being changed while copying them, the full candidate data must be stored instead.
+ *
+ * @param[in] mod Module.
+ * @param[in] mod_data Candidate data to store.
+ * @param[in] perm Permissions of the new candidate file.
+ * @param[out] branched Whether the candidate file was created, if not, the full data must be stored.
+ * @return SR err value.
+ */
+static int
+srpds_json_candidate_branch(const struct lys_module *mod, const struct lyd_node *mod_data, mode_t perm, int *branched)
+{
+    int rc = SR_ERR_OK, fd = -1, created = 0, jcreated = 0;
+    char *run_path = NULL, *cand_path = NULL, *run_jpath = NULL, *cand_jpath = NULL;
+    struct lyd_node *base = NULL, *diff = NULL;
+    struct stat st, st2;
+    struct timespec times[2];
+
+    *branched = 0;
+
+    if (!SRPDS_JSON_JOURNAL_DS(SR_DS_CANDIDATE)) {
+        /* candidate changes cannot be journaled */
+        return SR_ERR_OK;
+    }
+
+    /* get paths */
+    if ((rc = srpjson_get_path(srpds_name, mod->name, SR_DS_RUNNING, &run_path))) {
+        goto cleanup;
+    }
+    if ((rc = srpjson_get_path(srpds_name, mod->name, SR_DS_CANDIDATE, &cand_path))) {
+        goto cleanup;
+    }
+    if ((rc = srpds_json_get_journal_path(mod, SR_DS_RUNNING, &run_jpath))) {
+        goto cleanup;
+    }
+    if ((rc = srpds_json_get_journal_path(mod, SR_DS_CANDIDATE, &cand_jpath))) {
+        goto cleanup;
+    }
+
+    if (stat(run_path, &st) == -1) {
+        if (errno == ENOENT) {
+            /* no running data file */
+            goto cleanup;
+        }
+        SRPLG_LOG_ERR(srpds_name, "Stat of \"%s\" failed (%s).", run_path, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+
+    /* copy the running data file */
+    if ((fd = srpjson_open(cand_path, O_WRONLY | O_CREAT | O_EXCL, perm)) == -1) {
+        rc = srpjson_open_error(srpds_name, cand_path);
+        goto cleanup;
+    }
+    close(fd);
+    fd = -1;
+    created = 1;
+    if ((rc = srpjson_cp_path(srpds_name, cand_path, run_path))) {
+        goto cleanup;
+    }
+
+    /* keep the running modification time so that the copied running journal matches the candidate data file */
+    times[0].tv_nsec = UTIME_OMIT;
+    times[1] = st.st_mtim;
+    if (utimensat(AT_FDCWD, cand_path, times, 0) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Failed to update file \"%s\" modification time (%s).", cand_path, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+
+    /* copy the running journal */
+    if (srpjson_file_exists(srpds_name, run_jpath)) {
+        if ((fd = srpjson_open(cand_jpath, O_WRONLY | O_CREAT | O_EXCL, perm)) == -1) {
+            rc = srpjson_open_error(srpds_name, cand_jpath);
+            goto cleanup;
+        }
+        close(fd);
+        fd = -1;
+        jcreated = 1;
+        if ((rc = srpjson_cp_path(srpds_name, cand_jpath, run_jpath))) {
+            goto cleanup;
+        }
+    }
+
+    /* check running data were not changed while copying them */
+    if (stat(run_path, &st2) == -1) {
+        if (errno == ENOENT) {
+            goto cleanup;
+        }
+        SRPLG_LOG_ERR(srpds_name, "Stat of \"%s\" failed (%s).", run_path, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+    if ((st.st_ino != st2.st_ino) || (st.st_size != st2.st_size) || (st.st_mtim.tv_sec != st2.st_mtim.tv_sec) ||
+            (st.st_mtim.tv_nsec != st2.st_mtim.tv_nsec)) {
+        /* concurrent running change */
+        goto cleanup;
+    }
+
+    /* load the copied running data, they need not be the ones the candidate changes were made on */
+    if (srpds_json_load(mod, SR_DS_CANDIDATE, NULL, 0, &base)) {
+        /* inconsistent copy */
+        goto cleanup;
+    }
+
+    /* journal the candidate changes of these data */
+    if (lyd_diff_siblings(base, mod_data, LYD_DIFF_DEFAULTS, &diff)) {
+        srpjson_log_err_ly(srpds_name, mod->ctx);
+        rc = SR_ERR_LY;
+        goto cleanup;
+    }
+    if (!diff) {
+        /* candidate data are the same as running data */
+        *branched = 1;
+        goto cleanup;
+    }
+    if ((rc = srpds_json_journal_append(mod, SR_DS_CANDIDATE, diff, branched))) {
+        goto cleanup;
+    }
+
+cleanup:
+    if (fd > -1) {
+        close(fd);
+    }
+    lyd_free_siblings(base);
+    lyd_free_siblings(diff);
+    if (!*branched) {
+        /* the full data will be stored or an error occurred, remove the partial copy */
+        if (jcreated) {
+            unlink(cand_jpath);
+        }
+        if (created) {
+            unlink(cand_path);
+        }
+    }
+    free(run_path);
+    free(cand_path);
+    free(run_jpath);
+    free(cand_jpath);
+    return rc;
+}
+
 static int
-srpds_json_store(const struct lys_module *mod, sr_datastore_t ds, const struct lyd_node *UNUSED(mod_diff),
+srpds_json_store(const struct lys_module *mod, sr_datastore_t ds, const struct lyd_node *mod_diff,
         const struct lyd_node *mod_data)
 {
     mode_t perm = 0;
-    int rc;
+    int rc, appended;
     char *path = NULL;
 
     switch (ds) {
@@ -389,11 +2129,36 @@ srpds_json_store(const struct lys_module *mod, sr_datastore_t ds, const struct l
         break;
     }
 
+    if ((ds == SR_DS_CANDIDATE) && mod_diff && perm) {
+        /* first candidate changes, try to branch it from running */
+        if ((rc = srpds_json_candidate_branch(mod, mod_data, perm, &appended))) {
+            goto cleanup;
+        }
+        if (appended) {
+            goto cleanup;
+        }
+    }
+
+    if (SRPDS_JSON_JOURNAL_DS(ds) && mod_diff && !perm) {
+        /* try to only append the diff */
+        if ((rc = srpds_json_journal_append(mod, ds, mod_diff, &appended))) {
+            goto cleanup;
+        }
+        if (appended) {
+            goto cleanup;
+        }
+    }
+
     /* store */
     if ((rc = srpds_json_store_(mod, ds, mod_data, NULL, NULL, perm, 1))) {
         goto cleanup;
     }
 
+    /* full data are stored, the journal is obsolete */
+    if (srpds_json_journal_invalidate(mod, ds)) {
+        SRPLG_LOG_WRN(srpds_name, "Failed to remove \"%s\" %s journal.", mod->name, srpjson_ds2str(ds));
+    }
+
 cleanup:
     free(path);
     return rc;
@@ -410,6 +2175,19 @@ srpds_json_recover(const struct lys_module *mod, sr_datastore_t ds)
         goto cleanup;
     }
 
+    if (ds == SR_DS_STARTUP) {
+        /* remove any unfinished new file, the data file was not replaced by it */
+        if (asprintf(&bck_path, "%s%s", path, SRPJSON_FILE_TMP_SUFFIX) == -1) {
+            SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
+            goto cleanup;
+        }
+        if ((unlink(bck_path) == -1) && (errno != ENOENT)) {
+            SRPLG_LOG_WRN(srpds_name, "Unlinking \"%s\" failed (%s).", bck_path, strerror(errno));
+        }
+        free(bck_path);
+        bck_path = NULL;
+    }
+
     /* check whether the file is valid */
     if (!srpds_json_load(mod, ds, NULL, 0, &mod_data)) {
         /* data are valid, nothing to do */
@@ -417,15 +2195,21 @@ srpds_json_recover(const struct lys_module *mod, sr_datastore_t ds)
     }
 
     if (ds == SR_DS_STARTUP) {
-        /* there must be a backup file for startup data */
-        SRPLG_LOG_WRN(srpds_name, "Recovering \"%s\" startup data from a backup.", mod->name);
-
         /* generate the backup path */
         if (asprintf(&bck_path, "%s%s", path, SRPJSON_FILE_BACKUP_SUFFIX) == -1) {
             SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
             goto cleanup;
         }
 
+        if (access(bck_path, F_OK) == -1) {
+            /* data files replaced by renaming are never left incomplete, the corruption has another cause */
+            SRPLG_LOG_ERR(srpds_name, "No backup of corrupted \"%s\" startup data to recover from.", mod->name);
+            goto cleanup;
+        }
+
+        /* there is a backup file of startup data being rewritten in place */
+        SRPLG_LOG_WRN(srpds_name, "Recovering \"%s\" startup data from a backup.", mod->name);
+
         /* restore the backup data, avoid changing permissions of the target file */
         if (srpjson_cp_path(srpds_name, path, bck_path)) {
             goto cleanup;
@@ -440,6 +2224,11 @@ srpds_json_recover(const struct lys_module *mod, sr_datastore_t ds)
         /* perform startup->running data file copy */
         SRPLG_LOG_WRN(srpds_name, "Recovering \"%s\" running data from the startup data.", mod->name);
 
+        /* the journal may be the corrupted part */
+        if (srpds_json_journal_remove(mod, ds)) {
+            goto cleanup;
+        }
+
         /* generate the startup data file path */
         if (srpjson_get_path(srpds_name, mod->name, SR_DS_STARTUP, &bck_path)) {
             goto cleanup;
@@ -458,6 +2247,9 @@ srpds_json_recover(const struct lys_module *mod, sr_datastore_t ds)
             SRPLG_LOG_ERR(srpds_name, "Unlinking \"%s\" failed (%s).", path, strerror(errno));
             goto cleanup;
         }
+        if (srpds_json_journal_remove(mod, ds)) {
+            goto cleanup;
+        }
     }
 
 cleanup:
@@ -467,10 +2259,10 @@ cleanup:
 }
 
 static int
-srpds_json_load(const struct lys_module *mod, sr_datastore_t ds, const char **UNUSED(xpaths), uint32_t UNUSED(xpath_count),
+srpds_json_load(const struct lys_module *mod, sr_datastore_t ds, const char **xpaths, uint32_t xpath_count,
         struct lyd_node **mod_data)
 {
-    int rc = SR_ERR_OK, fd = -1;
+    int rc = SR_ERR_OK, fd = -1, loaded;
     char *path = NULL;
     uint32_t parse_opts;
 
@@ -485,6 +2277,11 @@ srpds_json_load(const struct lys_module *mod, sr_datastore_t ds, const char **UN
     fd = srpjson_open(path, O_RDONLY, 0);
     if (fd == -1) {
         if (errno == ENOENT) {
+            /* the data may be stored in the other format */
+            if ((rc = srpjson_file_format_check(srpds_name, path))) {
+                goto cleanup;
+            }
+
             switch (ds) {
             case SR_DS_STARTUP:
             case SR_DS_CANDIDATE:
@@ -520,13 +2317,30 @@ srpds_json_load(const struct lys_module *mod, sr_datastore_t ds, const char **UN
         parse_opts |= LYD_PARSE_WHEN_TRUE | LYD_PARSE_NO_NEW;
     }
 
+    if ((SRPJSON_DS_FORMAT == LYD_JSON) && xpath_count && (ds != SR_DS_OPERATIONAL)) {
+        /* try to load only the selected data */
+        if ((rc = srpds_json_load_indexed(mod, ds, path, fd, xpaths, xpath_count, parse_opts, mod_data, &loaded))) {
+            goto cleanup;
+        }
+        if (loaded) {
+            goto cleanup;
+        }
+    }
+
     /* load the data */
-    if (lyd_parse_data_fd(mod->ctx, fd, LYD_JSON, parse_opts, 0, mod_data)) {
+    if (lyd_parse_data_fd(mod->ctx, fd, SRPJSON_DS_FORMAT, parse_opts, 0, mod_data)) {
         srpjson_log_err_ly(srpds_name, mod->ctx);
         rc = SR_ERR_LY;
         goto cleanup;
     }
 
+    if (SRPDS_JSON_JOURNAL_DS(ds)) {
+        /* apply the journaled changes */
+        if ((rc = srpds_json_journal_replay(mod, ds, fd, mod_data))) {
+            goto cleanup;
+        }
+    }
+
 cleanup:
     if (fd > -1) {
         close(fd);
@@ -540,6 +2354,7 @@ srpds_json_copy(const struct lys_module *mod, sr_datastore_t trg_ds, sr_datastor
 {
     int rc = SR_ERR_OK, fd = -1;
     char *src_path = NULL, *trg_path = NULL, *owner = NULL, *group = NULL;
+    struct lyd_node *mod_data = NULL;
     mode_t perm = 0;
 
     /* target path */
@@ -578,20 +2393,41 @@ srpds_json_copy(const struct lys_module *mod, sr_datastore_t trg_ds, sr_datastor
         break;
     }
 
-    /* source path */
-    if ((rc = srpjson_get_path(srpds_name, mod->name, src_ds, &src_path))) {
+    /* the target index is obsolete */
+    if ((rc = srpds_json_index_remove(trg_path))) {
         goto cleanup;
     }
 
-    /* copy contents of source to target */
-    if ((rc = srpjson_cp_path(srpds_name, trg_path, src_path))) {
-        goto cleanup;
+    if (SRPDS_JSON_JOURNAL_DS(src_ds)) {
+        /* source data file alone may not be up-to-date, copy the full data */
+        if ((rc = srpds_json_load(mod, src_ds, NULL, 0, &mod_data))) {
+            goto cleanup;
+        }
+        if ((rc = srpds_json_store_(mod, trg_ds, mod_data, NULL, NULL, 0, 1))) {
+            goto cleanup;
+        }
+    } else {
+        /* source path */
+        if ((rc = srpjson_get_path(srpds_name, mod->name, src_ds, &src_path))) {
+            goto cleanup;
+        }
+
+        /* copy contents of source to target */
+        if ((rc = srpjson_cp_path(srpds_name, trg_path, src_path))) {
+            goto cleanup;
+        }
+    }
+
+    /* full target data are stored, its journal is obsolete */
+    if (srpds_json_journal_invalidate(mod, trg_ds)) {
+        SRPLG_LOG_WRN(srpds_name, "Failed to remove \"%s\" %s journal.", mod->name, srpjson_ds2str(trg_ds));
     }
 
 cleanup:
     if (fd > -1) {
         close(fd);
     }
+    lyd_free_siblings(mod_data);
     free(trg_path);
     free(owner);
     free(group);
@@ -635,8 +2471,16 @@ srpds_json_candidate_reset(const struct lys_module *mod)
     if ((unlink(path) == -1) && (errno != ENOENT)) {
         SRPLG_LOG_WRN(srpds_name, "Failed to unlink \"%s\" (%s).", path, strerror(errno));
     }
+    if (srpds_json_index_remove(path)) {
+        SRPLG_LOG_WRN(srpds_name, "Failed to remove \"%s\" candidate index.", mod->name);
+    }
     free(path);
 
+    /* remove the journal */
+    if (srpds_json_journal_remove(mod, SR_DS_CANDIDATE)) {
+        SRPLG_LOG_WRN(srpds_name, "Failed to remove \"%s\" candidate journal.", mod->name);
+    }
+
     return rc;
 }
 
@@ -849,6 +2693,23 @@ srpds_json_last_modif(const struct lys_module *mod, sr_datastore_t ds, struct ti
     } else {
         SRPLG_LOG_ERR(srpds_name, "Stat of \"%s\" failed (%s).", path, strerror(errno));
         rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+
+    if (SRPDS_JSON_JOURNAL_DS(ds)) {
+        /* the journal is modified instead of the data file */
+        free(path);
+        if ((rc = srpds_json_get_journal_path(mod, ds, &path))) {
+            goto cleanup;
+        }
+        if (stat(path, &st) == 0) {
+            if (srpjson_time_cmp(&st.st_mtim, mtime) > 0) {
+                *mtime = st.st_mtim;
+            }
+        } else if (errno != ENOENT) {
+            SRPLG_LOG_ERR(srpds_name, "Stat of \"%s\" failed (%s).", path, strerror(errno));
+            rc = SR_ERR_SYS;
+        }
     }
 
 cleanup:
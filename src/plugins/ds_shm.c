@@ -0,0 +1,752 @@
+/**
+ * @file ds_shm.c
+ * @author Michal Vasko <mvasko@cesnet.cz>
+ * @brief internal SHM-resident LYB datastore plugin
+ *
+ * @copyright
+ * Copyright (c) 2021 - 2023 Deutsche Telekom AG.
+ * Copyright (c) 2021 - 2023 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#define _GNU_SOURCE
+
+#include "plugins_datastore.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <libyang/libyang.h>
+
+#include "common_json.h"
+#include "common_types.h"
+#include "compat.h"
+#include "sysrepo.h"
+
+#define srpds_name "LYB DS shm"  /**< plugin name */
+
+/** whether a datastore is persistent and stored by the JSON DS plugin */
+#define SRPDS_SHM_PERSISTENT_DS(ds) ((ds == SR_DS_STARTUP) || (ds == SR_DS_FACTORY_DEFAULT))
+
+/** magic number of module data SHM files */
+#define SRPDS_SHM_MAGIC 0x6d687373
+
+/**
+ * @brief Module data SHM file header, followed by the LYB data.
+ */
+struct srpds_shm_hdr {
+    uint32_t magic;             /**< SHM file magic number */
+    uint32_t writing;           /**< set while the data are being rewritten, the file is corrupted if left set */
+    uint64_t version;           /**< module data version, incremented on every change */
+    uint64_t data_len;          /**< length of the LYB data */
+    int64_t mtime_sec;          /**< time of the last change, seconds */
+    int64_t mtime_nsec;         /**< time of the last change, nanoseconds */
+};
+
+static int srpds_shm_load(const struct lys_module *mod, sr_datastore_t ds, const char **xpaths, uint32_t xpath_count,
+        struct lyd_node **mod_data);
+
+/**
+ * @brief Get path to a volatile datastore SHM file of a module.
+ *
+ * @param[in] mod_name Module name.
+ * @param[in] ds Specific volatile datastore.
+ * @param[out] path Generated file path.
+ * @return SR err value.
+ */
+static int
+srpds_shm_get_path(const char *mod_name, sr_datastore_t ds, char **path)
+{
+    int rc;
+    const char *prefix;
+
+    assert(!SRPDS_SHM_PERSISTENT_DS(ds));
+
+    if ((rc = srpjson_shm_prefix(srpds_name, &prefix))) {
+        return rc;
+    }
+
+    if (asprintf(path, "%s/%sds_%s.%s", SR_SHM_DIR, prefix, mod_name, srpjson_ds2str(ds)) == -1) {
+        *path = NULL;
+        SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
+        return SR_ERR_NO_MEMORY;
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Map a module data SHM file and check its header.
+ *
+ * @param[in] mod Module.
+ * @param[in] ds Datastore.
+ * @param[in] fd Opened SHM file.
+ * @param[out] addr Mapped SHM file.
+ * @param[out] size Size of the mapping.
+ * @return SR err value.
+ */
+static int
+srpds_shm_map(const struct lys_module *mod, sr_datastore_t ds, int fd, void **addr, size_t *size)
+{
+    struct stat st;
+    const struct srpds_shm_hdr *hdr;
+
+    *addr = MAP_FAILED;
+    *size = 0;
+
+    if (fstat(fd, &st) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Fstat of \"%s\" %s data failed (%s).", mod->name, srpjson_ds2str(ds), strerror(errno));
+        return SR_ERR_SYS;
+    }
+    if ((size_t)st.st_size < sizeof *hdr) {
+        goto corrupted;
+    }
+
+    *addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (*addr == MAP_FAILED) {
+        SRPLG_LOG_ERR(srpds_name, "Mapping \"%s\" %s data failed (%s).", mod->name, srpjson_ds2str(ds), strerror(errno));
+        return SR_ERR_SYS;
+    }
+    *size = st.st_size;
+
+    /* the data must have been written completely */
+    hdr = *addr;
+    if ((hdr->magic != SRPDS_SHM_MAGIC) || hdr->writing || (hdr->data_len != *size - sizeof *hdr)) {
+        goto corrupted;
+    }
+
+    return SR_ERR_OK;
+
+corrupted:
+    SRPLG_LOG_ERR(srpds_name, "Corrupted \"%s\" %s data.", mod->name, srpjson_ds2str(ds));
+    if (*addr != MAP_FAILED) {
+        munmap(*addr, *size);
+        *addr = MAP_FAILED;
+        *size = 0;
+    }
+    return SR_ERR_INTERNAL;
+}
+
+/**
+ * @brief Write new LYB data of a module into its SHM file.
+ *
+ * The data are rewritten in place with the header marked as being written so that an interrupted write is detected.
+ *
+ * @param[in] mod Module.
+ * @param[in] ds Volatile datastore.
+ * @param[in] lyb LYB data to write.
+ * @param[in] lyb_len Length of @p lyb.
+ * @param[in] owner Owner of a created file, may be NULL.
+ * @param[in] group Group of a created file, may be NULL.
+ * @param[in] perm Permissions of a created file, if 0 the file must exist.
+ * @return SR err value.
+ */
+static int
+srpds_shm_write(const struct lys_module *mod, sr_datastore_t ds, const char *lyb, size_t lyb_len, const char *owner,
+        const char *group, mode_t perm)
+{
+    int rc = SR_ERR_OK, fd = -1, creat = 0;
+    char *path = NULL;
+    struct srpds_shm_hdr hdr;
+    struct timespec now;
+
+    if ((rc = srpds_shm_get_path(mod->name, ds, &path))) {
+        goto cleanup;
+    }
+
+    if (perm) {
+        /* try to create the file */
+        fd = srpjson_open(path, O_RDWR | O_CREAT | O_EXCL, perm);
+        if (fd > -1) {
+            creat = 1;
+        }
+    }
+    if (fd == -1) {
+        /* open existing file */
+        fd = srpjson_open(path, O_RDWR, 0);
+    }
+    if (fd == -1) {
+        rc = srpjson_open_error(srpds_name, path);
+        goto cleanup;
+    }
+
+    if (creat && (owner || group)) {
+        /* change the owner of the created file */
+        if ((rc = srpjson_chmodown(srpds_name, path, owner, group, 0))) {
+            goto cleanup;
+        }
+    }
+
+    /* learn the current version, if any */
+    if (creat || (pread(fd, &hdr, sizeof hdr, 0) != sizeof hdr) || (hdr.magic != SRPDS_SHM_MAGIC)) {
+        memset(&hdr, 0, sizeof hdr);
+        hdr.magic = SRPDS_SHM_MAGIC;
+    }
+
+    /* mark the data as being written */
+    hdr.writing = 1;
+    if (pwrite(fd, &hdr, sizeof hdr, 0) != sizeof hdr) {
+        SRPLG_LOG_ERR(srpds_name, "Writing \"%s\" failed (%s).", path, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+
+    /* write the data and truncate any previous longer data */
+    if (lyb_len && (pwrite(fd, lyb, lyb_len, sizeof hdr) != (ssize_t)lyb_len)) {
+        SRPLG_LOG_ERR(srpds_name, "Writing \"%s\" failed (%s).", path, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+    if (ftruncate(fd, sizeof hdr + lyb_len) == -1) {
+        SRPLG_LOG_ERR(srpds_name, "Failed to truncate \"%s\" (%s).", path, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+
+    /* new version, make sure every change results in a different modification time */
+    clock_gettime(CLOCK_REALTIME, &now);
+    if ((now.tv_sec < hdr.mtime_sec) || ((now.tv_sec == hdr.mtime_sec) && (now.tv_nsec <= hdr.mtime_nsec))) {
+        now.tv_sec = hdr.mtime_sec;
+        now.tv_nsec = hdr.mtime_nsec + 1;
+        if (now.tv_nsec == 1000000000L) {
+            ++now.tv_sec;
+            now.tv_nsec = 0;
+        }
+    }
+    hdr.writing = 0;
+    ++hdr.version;
+    hdr.data_len = lyb_len;
+    hdr.mtime_sec = now.tv_sec;
+    hdr.mtime_nsec = now.tv_nsec;
+    if (pwrite(fd, &hdr, sizeof hdr, 0) != sizeof hdr) {
+        SRPLG_LOG_ERR(srpds_name, "Writing \"%s\" failed (%s).", path, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+
+cleanup:
+    if (fd > -1) {
+        close(fd);
+    }
+    if (rc && creat) {
+        unlink(path);
+    }
+    free(path);
+    return rc;
+}
+
+/**
+ * @brief Store module data into its SHM file.
+ *
+ * @param[in] mod Module.
+ * @param[in] ds Volatile datastore.
+ * @param[in] mod_data Module data to store.
+ * @param[in] owner Owner of a created file, may be NULL.
+ * @param[in] group Group of a created file, may be NULL.
+ * @param[in] perm Permissions of a created file, if 0 the file must exist.
+ * @return SR err value.
+ */
+static int
+srpds_shm_store_(const struct lys_module *mod, sr_datastore_t ds, const struct lyd_node *mod_data, const char *owner,
+        const char *group, mode_t perm)
+{
+    int rc = SR_ERR_OK;
+    struct ly_out *out = NULL;
+    char *lyb = NULL;
+
+    /* print the data */
+    if (mod_data) {
+        if (ly_out_new_memory(&lyb, 0, &out)) {
+            SRPLG_LOG_ERR(srpds_name, "Memory allocation failed.");
+            rc = SR_ERR_NO_MEMORY;
+            goto cleanup;
+        }
+        if (lyd_print_all(out, mod_data, LYD_LYB, LYD_PRINT_WITHSIBLINGS)) {
+            srpjson_log_err_ly(srpds_name, LYD_CTX(mod_data));
+            SRPLG_LOG_ERR(srpds_name, "Failed to print \"%s\" %s data.", mod->name, srpjson_ds2str(ds));
+            rc = SR_ERR_LY;
+            goto cleanup;
+        }
+    }
+
+    /* write them */
+    rc = srpds_shm_write(mod, ds, lyb, out ? ly_out_printed(out) : 0, owner, group, perm);
+
+cleanup:
+    ly_out_free(out, NULL, 0);
+    free(lyb);
+    return rc;
+}
+
+static int
+srpds_shm_install(const struct lys_module *mod, sr_datastore_t ds, const char *owner, const char *group, mode_t perm)
+{
+    /* persistent data files and the permission files of volatile datastores are kept by the JSON DS plugin */
+    return srpds_json.install_cb(mod, ds, owner, group, perm);
+}
+
+static int
+srpds_shm_uninstall(const struct lys_module *mod, sr_datastore_t ds)
+{
+    int rc;
+    char *path = NULL;
+
+    if ((rc = srpds_json.uninstall_cb(mod, ds))) {
+        return rc;
+    }
+    if (SRPDS_SHM_PERSISTENT_DS(ds)) {
+        /* done */
+        return SR_ERR_OK;
+    }
+
+    /* unlink the SHM file */
+    if ((rc = srpds_shm_get_path(mod->name, ds, &path))) {
+        return rc;
+    }
+    if ((unlink(path) == -1) && (errno != ENOENT)) {
+        SRPLG_LOG_WRN(srpds_name, "Failed to unlink \"%s\" (%s).", path, strerror(errno));
+    }
+
+    free(path);
+    return SR_ERR_OK;
+}
+
+static int
+srpds_shm_init(const struct lys_module *mod, sr_datastore_t ds)
+{
+    int rc = SR_ERR_OK;
+    char *owner = NULL, *group = NULL;
+    mode_t perm;
+
+    if (SRPDS_SHM_PERSISTENT_DS(ds)) {
+        return srpds_json.init_cb(mod, ds);
+    }
+
+    if (ds != SR_DS_RUNNING) {
+        /* candidate with operational exist only if modified */
+        return SR_ERR_OK;
+    }
+
+    if (!srpjson_module_has_data(mod, 0)) {
+        /* no data, do not create the file */
+        return SR_ERR_OK;
+    }
+
+    /* get owner/group/perms of the datastore */
+    if ((rc = srpds_json.access_get_cb(mod, ds, &owner, &group, &perm))) {
+        goto cleanup;
+    }
+
+    /* write empty data, startup data are copied into them afterwards */
+    if ((rc = srpds_shm_write(mod, ds, NULL, 0, owner, group, perm))) {
+        goto cleanup;
+    }
+
+cleanup:
+    free(owner);
+    free(group);
+    return rc;
+}
+
+static int
+srpds_shm_store(const struct lys_module *mod, sr_datastore_t ds, const struct lyd_node *mod_diff,
+        const struct lyd_node *mod_data)
+{
+    int rc;
+    char *path = NULL;
+    mode_t perm = 0;
+
+    if (SRPDS_SHM_PERSISTENT_DS(ds)) {
+        return srpds_json.store_cb(mod, ds, mod_diff, mod_data);
+    }
+
+    /* running may not exist if all the data were disabled by a feature, candidate and operational if not modified */
+    if ((rc = srpds_shm_get_path(mod->name, ds, &path))) {
+        return rc;
+    }
+    if (!srpjson_file_exists(srpds_name, path)) {
+        /* get the correct permissions to set for the new file (not owner/group because we may not have permissions
+         * to set them) */
+        if ((rc = srpds_json.access_get_cb(mod, ds, NULL, NULL, &perm))) {
+            goto cleanup;
+        }
+    }
+
+    /* store the full data, the memory copy is cheap */
+    rc = srpds_shm_store_(mod, ds, mod_data, NULL, NULL, perm);
+
+cleanup:
+    free(path);
+    return rc;
+}
+
+static void
+srpds_shm_recover(const struct lys_module *mod, sr_datastore_t ds)
+{
+    char *path = NULL;
+    struct lyd_node *mod_data = NULL;
+
+    if (SRPDS_SHM_PERSISTENT_DS(ds)) {
+        srpds_json.recover_cb(mod, ds);
+        return;
+    }
+
+    /* check whether the data are valid */
+    if (!srpds_shm_load(mod, ds, NULL, 0, &mod_data)) {
+        goto cleanup;
+    }
+
+    if (ds == SR_DS_RUNNING) {
+        /* replace the data with the startup data */
+        SRPLG_LOG_WRN(srpds_name, "Recovering \"%s\" running data from the startup data.", mod->name);
+
+        if (srpds_json.load_cb(mod, SR_DS_STARTUP, NULL, 0, &mod_data)) {
+            goto cleanup;
+        }
+        srpds_shm_store_(mod, ds, mod_data, NULL, NULL, 0);
+    } else {
+        /* there is not much to do but remove the corrupted file */
+        SRPLG_LOG_WRN(srpds_name, "Recovering \"%s\" %s data by removing the corrupted data.", mod->name,
+                srpjson_ds2str(ds));
+
+        if (srpds_shm_get_path(mod->name, ds, &path)) {
+            goto cleanup;
+        }
+        if (unlink(path) == -1) {
+            SRPLG_LOG_ERR(srpds_name, "Unlinking \"%s\" failed (%s).", path, strerror(errno));
+        }
+    }
+
+cleanup:
+    free(path);
+    lyd_free_all(mod_data);
+}
+
+static int
+srpds_shm_load(const struct lys_module *mod, sr_datastore_t ds, const char **xpaths, uint32_t xpath_count,
+        struct lyd_node **mod_data)
+{
+    int rc = SR_ERR_OK, fd = -1;
+    char *path = NULL;
+    void *addr = MAP_FAILED;
+    const struct srpds_shm_hdr *hdr;
+    size_t size = 0;
+    uint32_t parse_opts;
+
+    if (SRPDS_SHM_PERSISTENT_DS(ds)) {
+        return srpds_json.load_cb(mod, ds, xpaths, xpath_count, mod_data);
+    }
+
+    *mod_data = NULL;
+
+    /* open the SHM file */
+    if ((rc = srpds_shm_get_path(mod->name, ds, &path))) {
+        goto cleanup;
+    }
+    fd = srpjson_open(path, O_RDONLY, 0);
+    if (fd == -1) {
+        if (errno == ENOENT) {
+            if ((ds == SR_DS_OPERATIONAL) || ((ds == SR_DS_RUNNING) && !srpjson_module_has_data(mod, 0))) {
+                /* no data */
+                goto cleanup;
+            }
+        }
+
+        rc = srpjson_open_error(srpds_name, path);
+        goto cleanup;
+    }
+
+    /* map it */
+    if ((rc = srpds_shm_map(mod, ds, fd, &addr, &size))) {
+        goto cleanup;
+    }
+    hdr = addr;
+    if (!hdr->data_len) {
+        /* empty data */
+        goto cleanup;
+    }
+
+    /* set parse options */
+    parse_opts = LYD_PARSE_ONLY | LYD_PARSE_ORDERED;
+    if (ds == SR_DS_OPERATIONAL) {
+        /* edit may include opaque nodes */
+        parse_opts |= LYD_PARSE_OPAQ;
+    } else {
+        parse_opts |= LYD_PARSE_STRICT;
+    }
+    if (ds == SR_DS_RUNNING) {
+        /* always valid datastore */
+        parse_opts |= LYD_PARSE_WHEN_TRUE | LYD_PARSE_NO_NEW;
+    }
+
+    /* parse all the data directly from the SHM, the selective XPaths are only a hint */
+    if (lyd_parse_data_mem(mod->ctx, (char *)(hdr + 1), LYD_LYB, parse_opts, 0, mod_data)) {
+        srpjson_log_err_ly(srpds_name, mod->ctx);
+        rc = SR_ERR_LY;
+        goto cleanup;
+    }
+
+cleanup:
+    if (addr != MAP_FAILED) {
+        munmap(addr, size);
+    }
+    if (fd > -1) {
+        close(fd);
+    }
+    free(path);
+    return rc;
+}
+
+/**
+ * @brief Copy module LYB data from one volatile datastore SHM file to another without parsing them.
+ *
+ * @param[in] mod Module.
+ * @param[in] trg_ds Target volatile datastore.
+ * @param[in] src_ds Source volatile datastore.
+ * @param[in] owner Owner of a created file, may be NULL.
+ * @param[in] group Group of a created file, may be NULL.
+ * @param[in] perm Permissions of a created file, if 0 the file must exist.
+ * @return SR err value.
+ */
+static int
+srpds_shm_copy_lyb(const struct lys_module *mod, sr_datastore_t trg_ds, sr_datastore_t src_ds, const char *owner,
+        const char *group, mode_t perm)
+{
+    int rc = SR_ERR_OK, fd = -1;
+    char *path = NULL;
+    void *addr = MAP_FAILED;
+    const struct srpds_shm_hdr *hdr;
+    size_t size = 0;
+
+    /* map the source data */
+    if ((rc = srpds_shm_get_path(mod->name, src_ds, &path))) {
+        goto cleanup;
+    }
+    fd = srpjson_open(path, O_RDONLY, 0);
+    if (fd == -1) {
+        if ((errno == ENOENT) && ((src_ds == SR_DS_OPERATIONAL) || ((src_ds == SR_DS_RUNNING) &&
+                !srpjson_module_has_data(mod, 0)))) {
+            /* no data */
+            rc = srpds_shm_write(mod, trg_ds, NULL, 0, owner, group, perm);
+            goto cleanup;
+        }
+
+        rc = srpjson_open_error(srpds_name, path);
+        goto cleanup;
+    }
+    if ((rc = srpds_shm_map(mod, src_ds, fd, &addr, &size))) {
+        goto cleanup;
+    }
+    hdr = addr;
+
+    /* write them into the target */
+    rc = srpds_shm_write(mod, trg_ds, (char *)(hdr + 1), hdr->data_len, owner, group, perm);
+
+cleanup:
+    if (addr != MAP_FAILED) {
+        munmap(addr, size);
+    }
+    if (fd > -1) {
+        close(fd);
+    }
+    free(path);
+    return rc;
+}
+
+static int
+srpds_shm_copy(const struct lys_module *mod, sr_datastore_t trg_ds, sr_datastore_t src_ds)
+{
+    int rc = SR_ERR_OK;
+    char *path = NULL, *owner = NULL, *group = NULL;
+    struct lyd_node *mod_data = NULL;
+    mode_t perm = 0;
+
+    if (SRPDS_SHM_PERSISTENT_DS(trg_ds) && SRPDS_SHM_PERSISTENT_DS(src_ds)) {
+        return srpds_json.copy_cb(mod, trg_ds, src_ds);
+    }
+
+    if (SRPDS_SHM_PERSISTENT_DS(trg_ds)) {
+        /* store the full data into the persistent datastore */
+        if ((rc = srpds_shm_load(mod, src_ds, NULL, 0, &mod_data))) {
+            goto cleanup;
+        }
+        rc = srpds_json.store_cb(mod, trg_ds, NULL, mod_data);
+        goto cleanup;
+    }
+
+    if ((rc = srpds_shm_get_path(mod->name, trg_ds, &path))) {
+        goto cleanup;
+    }
+    if (!srpjson_file_exists(srpds_name, path)) {
+        /* get the correct owner/group/permissions to set for the new file */
+        if ((rc = srpds_json.access_get_cb(mod, trg_ds, &owner, &group, &perm))) {
+            goto cleanup;
+        }
+    }
+
+    if (SRPDS_SHM_PERSISTENT_DS(src_ds)) {
+        /* load the persistent data and store them */
+        if ((rc = srpds_json.load_cb(mod, src_ds, NULL, 0, &mod_data))) {
+            goto cleanup;
+        }
+        rc = srpds_shm_store_(mod, trg_ds, mod_data, owner, group, perm);
+    } else {
+        /* copy the LYB data as they are */
+        rc = srpds_shm_copy_lyb(mod, trg_ds, src_ds, owner, group, perm);
+    }
+
+cleanup:
+    lyd_free_siblings(mod_data);
+    free(path);
+    free(owner);
+    free(group);
+    return rc;
+}
+
+static int
+srpds_shm_candidate_modified(const struct lys_module *mod, int *modified)
+{
+    int rc;
+    char *path;
+
+    /* candidate SHM file exists only if modified */
+    if ((rc = srpds_shm_get_path(mod->name, SR_DS_CANDIDATE, &path))) {
+        return rc;
+    }
+
+    *modified = srpjson_file_exists(srpds_name, path);
+
+    free(path);
+    return SR_ERR_OK;
+}
+
+static int
+srpds_shm_candidate_reset(const struct lys_module *mod)
+{
+    int rc;
+    char *path;
+
+    if ((rc = srpds_shm_get_path(mod->name, SR_DS_CANDIDATE, &path))) {
+        return rc;
+    }
+
+    if ((unlink(path) == -1) && (errno != ENOENT)) {
+        SRPLG_LOG_WRN(srpds_name, "Failed to unlink \"%s\" (%s).", path, strerror(errno));
+    }
+
+    free(path);
+    return SR_ERR_OK;
+}
+
+static int
+srpds_shm_access_set(const struct lys_module *mod, sr_datastore_t ds, const char *owner, const char *group, mode_t perm)
+{
+    int rc;
+    char *path = NULL;
+
+    /* persistent data file or the permission file */
+    if ((rc = srpds_json.access_set_cb(mod, ds, owner, group, perm))) {
+        return rc;
+    }
+    if (SRPDS_SHM_PERSISTENT_DS(ds)) {
+        /* done */
+        return SR_ERR_OK;
+    }
+
+    /* update the SHM file, if it exists */
+    if ((rc = srpds_shm_get_path(mod->name, ds, &path))) {
+        return rc;
+    }
+    if (srpjson_file_exists(srpds_name, path)) {
+        rc = srpjson_chmodown(srpds_name, path, owner, group, perm);
+    }
+
+    free(path);
+    return rc;
+}
+
+static int
+srpds_shm_access_get(const struct lys_module *mod, sr_datastore_t ds, char **owner, char **group, mode_t *perm)
+{
+    /* permission file of volatile datastores */
+    return srpds_json.access_get_cb(mod, ds, owner, group, perm);
+}
+
+static int
+srpds_shm_access_check(const struct lys_module *mod, sr_datastore_t ds, int *read, int *write)
+{
+    /* permission file of volatile datastores */
+    return srpds_json.access_check_cb(mod, ds, read, write);
+}
+
+static int
+srpds_shm_last_modif(const struct lys_module *mod, sr_datastore_t ds, struct timespec *mtime)
+{
+    int rc = SR_ERR_OK, fd = -1;
+    char *path = NULL;
+    struct srpds_shm_hdr hdr;
+
+    if (SRPDS_SHM_PERSISTENT_DS(ds)) {
+        return srpds_json.last_modif_cb(mod, ds, mtime);
+    }
+
+    mtime->tv_sec = 0;
+    mtime->tv_nsec = 0;
+
+    if ((rc = srpds_shm_get_path(mod->name, ds, &path))) {
+        goto cleanup;
+    }
+
+    /* the file may not exist */
+    fd = srpjson_open(path, O_RDONLY, 0);
+    if (fd == -1) {
+        if (errno != ENOENT) {
+            rc = srpjson_open_error(srpds_name, path);
+        }
+        goto cleanup;
+    }
+
+    /* read the time of the last change from the header */
+    if ((pread(fd, &hdr, sizeof hdr, 0) == sizeof hdr) && (hdr.magic == SRPDS_SHM_MAGIC)) {
+        mtime->tv_sec = hdr.mtime_sec;
+        mtime->tv_nsec = hdr.mtime_nsec;
+    }
+
+cleanup:
+    if (fd > -1) {
+        close(fd);
+    }
+    free(path);
+    return rc;
+}
+
+const struct srplg_ds_s srpds_shm = {
+    .name = srpds_name,
+    .install_cb = srpds_shm_install,
+    .uninstall_cb = srpds_shm_uninstall,
+    .init_cb = srpds_shm_init,
+    .store_cb = srpds_shm_store,
+    .recover_cb = srpds_shm_recover,
+    .load_cb = srpds_shm_load,
+    .copy_cb = srpds_shm_copy,
+    .candidate_modified_cb = srpds_shm_candidate_modified,
+    .candidate_reset_cb = srpds_shm_candidate_reset,
+    .access_set_cb = srpds_shm_access_set,
+    .access_get_cb = srpds_shm_access_get,
+    .access_check_cb = srpds_shm_access_check,
+    .last_modif_cb = srpds_shm_last_modif,
+};
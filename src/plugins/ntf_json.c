@@ -22,6 +22,7 @@
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -36,11 +37,49 @@
 #include "common_json.h"
 #include "sysrepo.h"
 
+#ifdef SR_HAVE_ZLIB
+# include <sys/mman.h>
+# include <zlib.h>
+#endif
+
 #define srpntf_name "JSON notif" /**< plugin name */
 
+/** size of notification file data between two sparse index records */
+#define SRPNTF_INDEX_INTERVAL (16 * 1024)
+
+/**
+ * @brief Notification file sparse index record.
+ */
+struct srpntf_index_rec {
+    struct timespec ts;     /**< notification timestamp */
+    uint64_t offset;        /**< notification offset in the file */
+};
+
+/**
+ * @brief Cached latest notification file of a module opened for writing.
+ */
+struct srpntf_wfile {
+    char *mod_name;     /**< module name */
+    int fd;             /**< opened file descriptor, -1 if not opened */
+    time_t from_ts;     /**< file earliest stored notification */
+    time_t to_ts;       /**< file latest stored notification */
+    dev_t dev;          /**< file device */
+    ino_t ino;          /**< file inode */
+};
+
 /**
- * @brief Write notification into fd using vector IO.
+ * @brief Notification files opened for writing.
+ */
+static struct {
+    struct srpntf_wfile *files;
+    uint32_t count;
+    pthread_mutex_t lock;
+} srpntf_wfiles = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+/**
+ * @brief Write notification into fd using vector IO, is not synced.
  *
+ * @param[in] fd File descriptor to write to.
  * @param[in] notif_json Notification in JSON format.
  * @param[in] notif_json_len Length of notification in JSON format.
  * @param[in] notif_ts Notification timestamp.
@@ -69,12 +108,6 @@ srpntf_writev_notif(int fd, const char *notif_json, uint32_t notif_json_len, con
         return rc;
     }
 
-    /* fsync */
-    if (fsync(fd) == -1) {
-        SRPLG_LOG_ERR(srpntf_name, "Fsync failed (%s).", strerror(errno));
-        return SR_ERR_SYS;
-    }
-
     return SR_ERR_OK;
 }
 
@@ -166,6 +199,183 @@ srpntf_skip_notif(int notif_fd)
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Get the path to the sparse index of a notification file.
+ *
+ * @param[in] arch_dir Rotated notification files directory, NULL for the notification directory.
+ * @param[in] mod_name Module name.
+ * @param[in] from_ts Earliest stored notification.
+ * @param[in] to_ts Latest stored notification.
+ * @param[out] path Created path.
+ * @return SR err value.
+ */
+static int
+srpntf_get_index_path(const char *arch_dir, const char *mod_name, time_t from_ts, time_t to_ts, char **path)
+{
+    int rc = SR_ERR_OK, r;
+    char *notif_path;
+
+    *path = NULL;
+
+    if (arch_dir) {
+        r = asprintf(path, "%s/%s.notif.%lu-%lu%s", arch_dir, mod_name, from_ts, to_ts, SRPJSON_FILE_INDEX_SUFFIX);
+    } else {
+        if ((rc = srpjson_get_notif_path(srpntf_name, mod_name, from_ts, to_ts, &notif_path))) {
+            return rc;
+        }
+        r = asprintf(path, "%s%s", notif_path, SRPJSON_FILE_INDEX_SUFFIX);
+        free(notif_path);
+    }
+
+    if (r == -1) {
+        *path = NULL;
+        SRPLG_LOG_ERR(srpntf_name, "Memory allocation failed.");
+        rc = SR_ERR_NO_MEMORY;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Add a notification into the sparse index of its notification file if it crosses an index interval.
+ *
+ * @param[in] mod_name Module name.
+ * @param[in] from_ts Earliest stored notification.
+ * @param[in] to_ts Latest stored notification.
+ * @param[in] notif_fd Notification file descriptor.
+ * @param[in] offset Offset of the notification in the file.
+ * @param[in] notif_len Length of the whole stored notification.
+ * @param[in] notif_ts Notification timestamp.
+ * @return SR err value.
+ */
+static int
+srpntf_index_append(const char *mod_name, time_t from_ts, time_t to_ts, int notif_fd, size_t offset, size_t notif_len,
+        const struct timespec *notif_ts)
+{
+    int rc = SR_ERR_OK, fd = -1;
+    char *path = NULL;
+    struct srpntf_index_rec rec;
+    struct stat st;
+    struct iovec iov;
+
+    if (!offset || ((offset + notif_len) / SRPNTF_INDEX_INTERVAL == offset / SRPNTF_INDEX_INTERVAL)) {
+        /* not indexed, the first notification is always read directly */
+        goto cleanup;
+    }
+
+    if ((rc = srpntf_get_index_path(NULL, mod_name, from_ts, to_ts, &path))) {
+        goto cleanup;
+    }
+
+    /* open the index with the same permissions as the notification file */
+    if (fstat(notif_fd, &st) == -1) {
+        SRPLG_LOG_ERR(srpntf_name, "Fstat failed (%s).", strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+    if ((fd = srpjson_open(path, O_WRONLY | O_APPEND | O_CREAT, st.st_mode & 0007777)) == -1) {
+        rc = srpjson_open_error(srpntf_name, path);
+        goto cleanup;
+    }
+
+    /* append the record */
+    rec.ts = *notif_ts;
+    rec.offset = offset;
+    iov.iov_base = &rec;
+    iov.iov_len = sizeof rec;
+    if ((rc = srpjson_writev(srpntf_name, fd, &iov, 1))) {
+        goto cleanup;
+    }
+
+cleanup:
+    if (fd > -1) {
+        close(fd);
+    }
+    free(path);
+    return rc;
+}
+
+/**
+ * @brief Move the offset of a notification file to the latest indexed notification earlier than a timestamp.
+ *
+ * The offset is not changed if there is no such notification or the index is not valid.
+ *
+ * @param[in] arch_dir Rotated notification files directory, NULL for the notification directory.
+ * @param[in] mod_name Module name.
+ * @param[in] from_ts Earliest stored notification.
+ * @param[in] to_ts Latest stored notification.
+ * @param[in] notif_fd Notification file descriptor.
+ * @param[in] ts Timestamp to seek to.
+ * @return SR err value.
+ */
+static int
+srpntf_index_seek(const char *arch_dir, const char *mod_name, time_t from_ts, time_t to_ts, int notif_fd,
+        const struct timespec *ts)
+{
+    int rc = SR_ERR_OK, fd = -1;
+    char *path = NULL;
+    struct srpntf_index_rec *recs = NULL;
+    struct timespec notif_ts;
+    struct stat st;
+    uint32_t i, count;
+
+    if ((rc = srpntf_get_index_path(arch_dir, mod_name, from_ts, to_ts, &path))) {
+        goto cleanup;
+    }
+
+    /* open the index, if any */
+    if ((fd = srpjson_open(path, O_RDONLY, 0)) == -1) {
+        goto cleanup;
+    }
+
+    /* read all the complete records */
+    if (fstat(fd, &st) == -1) {
+        SRPLG_LOG_ERR(srpntf_name, "Fstat failed (%s).", strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+    count = st.st_size / sizeof *recs;
+    if (!count) {
+        goto cleanup;
+    }
+    if (!(recs = malloc(count * sizeof *recs))) {
+        SRPLG_LOG_ERR(srpntf_name, "Memory allocation failed.");
+        rc = SR_ERR_NO_MEMORY;
+        goto cleanup;
+    }
+    if ((rc = srpjson_read(srpntf_name, fd, recs, count * sizeof *recs))) {
+        goto cleanup;
+    }
+
+    /* find the latest earlier notification */
+    for (i = count; i && (srpjson_time_cmp(&recs[i - 1].ts, ts) > -1); --i) {}
+    if (!i) {
+        goto cleanup;
+    }
+
+    /* check the index is valid for this file */
+    if ((pread(notif_fd, &notif_ts, sizeof notif_ts, recs[i - 1].offset) != sizeof notif_ts) ||
+            srpjson_time_cmp(&notif_ts, &recs[i - 1].ts)) {
+        SRPLG_LOG_WRN(srpntf_name, "Replay file index \"%s\" is not valid.", strrchr(path, '/') + 1);
+        goto cleanup;
+    }
+
+    /* seek */
+    if (lseek(notif_fd, recs[i - 1].offset, SEEK_SET) == -1) {
+        SRPLG_LOG_ERR(srpntf_name, "Lseek failed (%s).", strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+
+cleanup:
+    if (fd > -1) {
+        close(fd);
+    }
+    free(path);
+    free(recs);
+    return rc;
+}
+
 /**
  * @brief Open notification replay file.
  *
@@ -205,34 +415,129 @@ cleanup:
 }
 
 /**
- * @brief Find specific replay notification file:
- * - from_ts = 0; to_ts = 0 - find latest file
- * - from_ts > 0; to_ts = 0 - find file possibly containing no-earlier-than from_ts (replay start_time)
- * - from_ts > 0; to_ts > 0 - find next file after this one
+ * @brief Open rotated notification replay file for reading.
+ *
+ * A compressed file is decompressed into an anonymous memory file so that it can be read and seeked the same way
+ * as a notification file.
  *
+ * @param[in] arch_dir Rotated notification files directory.
+ * @param[in] mod_name Module name.
+ * @param[in] from_ts Earliest stored notification.
+ * @param[in] to_ts Latest stored notification.
+ * @param[in] compressed Whether the file is compressed.
+ * @param[out] notif_fd Opened file descriptor.
+ * @return SR err value.
+ */
+static int
+srpntf_open_archive(const char *arch_dir, const char *mod_name, time_t from_ts, time_t to_ts, int compressed,
+        int *notif_fd)
+{
+    int rc = SR_ERR_OK;
+    char *path = NULL;
+
+#ifdef SR_HAVE_ZLIB
+    gzFile gz = NULL;
+    char buf[SRPNTF_INDEX_INTERVAL];
+    struct iovec iov;
+    int r;
+#endif
+
+    *notif_fd = -1;
+
+    if (asprintf(&path, "%s/%s.notif.%lu-%lu%s", arch_dir, mod_name, from_ts, to_ts,
+            compressed ? SRPJSON_FILE_COMPRESS_SUFFIX : "") == -1) {
+        path = NULL;
+        SRPLG_LOG_ERR(srpntf_name, "Memory allocation failed.");
+        rc = SR_ERR_NO_MEMORY;
+        goto cleanup;
+    }
+
+    if (!compressed) {
+        *notif_fd = srpjson_open(path, O_RDONLY, 0);
+        if (*notif_fd == -1) {
+            rc = srpjson_open_error(srpntf_name, path);
+        }
+        goto cleanup;
+    }
+
+#ifdef SR_HAVE_ZLIB
+    if (!(gz = gzopen(path, "rb"))) {
+        rc = srpjson_open_error(srpntf_name, path);
+        goto cleanup;
+    }
+
+    /* notification files are small, decompress the whole file */
+    if ((*notif_fd = memfd_create(mod_name, MFD_CLOEXEC)) == -1) {
+        SRPLG_LOG_ERR(srpntf_name, "Memfd_create failed (%s).", strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+    while ((r = gzread(gz, buf, sizeof buf)) > 0) {
+        iov.iov_base = buf;
+        iov.iov_len = r;
+        if ((rc = srpjson_writev(srpntf_name, *notif_fd, &iov, 1))) {
+            goto cleanup;
+        }
+    }
+    if (r == -1) {
+        SRPLG_LOG_ERR(srpntf_name, "Decompressing replay file \"%s\" failed (%s).", strrchr(path, '/') + 1,
+                gzerror(gz, NULL));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+    if (lseek(*notif_fd, 0, SEEK_SET) == -1) {
+        SRPLG_LOG_ERR(srpntf_name, "Lseek failed (%s).", strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+#else
+    SRPLG_LOG_ERR(srpntf_name, "Replay file \"%s\" is compressed, which is not supported.", strrchr(path, '/') + 1);
+    rc = SR_ERR_UNSUPPORTED;
+#endif
+
+cleanup:
+#ifdef SR_HAVE_ZLIB
+    if (gz) {
+        gzclose(gz);
+    }
+#endif
+    if (rc && (*notif_fd > -1)) {
+        close(*notif_fd);
+        *notif_fd = -1;
+    }
+    free(path);
+    return rc;
+}
+
+/**
+ * @brief Find specific replay notification file in a directory, see ::srpntf_find_file().
+ *
+ * @param[in] dir_path Directory to search in.
  * @param[in] mod_name Module name.
  * @param[in] from_ts Earliest stored notification.
  * @param[in] to_ts Latest stored notification.
  * @param[out] file_from_ts Found file earliest notification.
  * @param[out] file_to_ts Found file latest notification.
+ * @param[out] compressed If set, the directory is searched for rotated files and this is set if the found one is
+ * compressed.
  * @return SR err value.
  */
 static int
-srpntf_find_file(const char *mod_name, time_t from_ts, time_t to_ts, time_t *file_from_ts, time_t *file_to_ts)
+srpntf_find_file_dir(const char *dir_path, const char *mod_name, time_t from_ts, time_t to_ts, time_t *file_from_ts,
+        time_t *file_to_ts, int *compressed)
 {
-    int rc = SR_ERR_OK, pref_len;
+    int rc = SR_ERR_OK, pref_len, comp = 0;
     DIR *dir = NULL;
     struct dirent *dirent;
-    char *dir_path = NULL, *prefix = NULL, *ptr;
+    char *prefix = NULL, *ptr;
     time_t ts1, ts2;
 
     assert((from_ts && to_ts) || (from_ts && !to_ts) || (!from_ts && !to_ts));
 
     *file_from_ts = 0;
     *file_to_ts = 0;
-
-    if ((rc = srpjson_get_notif_dir(srpntf_name, &dir_path))) {
-        goto cleanup;
+    if (compressed) {
+        *compressed = 0;
     }
 
     dir = opendir(dir_path);
@@ -265,7 +570,21 @@ srpntf_find_file(const char *mod_name, time_t from_ts, time_t to_ts, time_t *fil
             continue;
         }
         ts2 = strtoull(ptr + 1, &ptr, 10);
-        if (errno || (ptr[0] != '\0')) {
+        if (!errno && !strcmp(ptr, SRPJSON_FILE_INDEX_SUFFIX)) {
+            /* index of a notification file */
+            continue;
+        }
+        if (compressed && !errno && (ptr[0] != '\0')) {
+#ifdef SR_HAVE_ZLIB
+            if (strcmp(ptr, SRPJSON_FILE_COMPRESS_SUFFIX)) {
+                /* some other rotated file */
+                continue;
+            }
+            comp = 1;
+#else
+            continue;
+#endif
+        } else if (errno || (ptr[0] != '\0')) {
             SRPLG_LOG_WRN(srpntf_name, "Invalid notification file \"%s\" encountered.", dirent->d_name);
             continue;
         }
@@ -306,10 +625,12 @@ srpntf_find_file(const char *mod_name, time_t from_ts, time_t to_ts, time_t *fil
         /* remember these timestamps */
         *file_from_ts = ts1;
         *file_to_ts = ts2;
+        if (compressed) {
+            *compressed = comp;
+        }
     }
 
 cleanup:
-    free(dir_path);
     free(prefix);
     if (dir) {
         closedir(dir);
@@ -317,6 +638,81 @@ cleanup:
     return rc;
 }
 
+/**
+ * @brief Find specific replay notification file:
+ * - from_ts = 0; to_ts = 0 - find latest file
+ * - from_ts > 0; to_ts = 0 - find file possibly containing no-earlier-than from_ts (replay start_time)
+ * - from_ts > 0; to_ts > 0 - find next file after this one
+ *
+ * @param[in] mod_name Module name.
+ * @param[in] from_ts Earliest stored notification.
+ * @param[in] to_ts Latest stored notification.
+ * @param[out] file_from_ts Found file earliest notification.
+ * @param[out] file_to_ts Found file latest notification.
+ * @return SR err value.
+ */
+static int
+srpntf_find_file(const char *mod_name, time_t from_ts, time_t to_ts, time_t *file_from_ts, time_t *file_to_ts)
+{
+    int rc;
+    char *dir_path;
+
+    if ((rc = srpjson_get_notif_dir(srpntf_name, &dir_path))) {
+        return rc;
+    }
+
+    rc = srpntf_find_file_dir(dir_path, mod_name, from_ts, to_ts, file_from_ts, file_to_ts, NULL);
+    free(dir_path);
+    return rc;
+}
+
+/**
+ * @brief Find specific replay notification file among notification files and rotated notification files,
+ * see ::srpntf_find_file().
+ *
+ * @param[in] arch_dir Rotated notification files directory, NULL if none.
+ * @param[in] mod_name Module name.
+ * @param[in] from_ts Earliest stored notification.
+ * @param[in] to_ts Latest stored notification.
+ * @param[out] file_from_ts Found file earliest notification.
+ * @param[out] file_to_ts Found file latest notification.
+ * @param[out] archived Whether the found file is a rotated one.
+ * @param[out] compressed Whether the found rotated file is compressed.
+ * @return SR err value.
+ */
+static int
+srpntf_find_replay_file(const char *arch_dir, const char *mod_name, time_t from_ts, time_t to_ts,
+        time_t *file_from_ts, time_t *file_to_ts, int *archived, int *compressed)
+{
+    int rc, comp;
+    time_t arch_from_ts, arch_to_ts;
+
+    *archived = 0;
+    *compressed = 0;
+
+    if ((rc = srpntf_find_file(mod_name, from_ts, to_ts, file_from_ts, file_to_ts))) {
+        return rc;
+    }
+    if (!arch_dir) {
+        return SR_ERR_OK;
+    }
+
+    if ((rc = srpntf_find_file_dir(arch_dir, mod_name, from_ts, to_ts, &arch_from_ts, &arch_to_ts, &comp))) {
+        return rc;
+    }
+
+    /* rotated files are older, but use the earlier file anyway */
+    if (arch_from_ts && (!*file_from_ts || (arch_from_ts < *file_from_ts) ||
+            ((arch_from_ts == *file_from_ts) && (arch_to_ts < *file_to_ts)))) {
+        *file_from_ts = arch_from_ts;
+        *file_to_ts = arch_to_ts;
+        *archived = 1;
+        *compressed = comp;
+    }
+
+    return SR_ERR_OK;
+}
+
 /**
  * @brief Rename notification file after new notifications were stored in it.
  *
@@ -359,12 +755,155 @@ srpntf_rename_file(const char *mod_name, time_t old_from_ts, time_t old_to_ts, t
     SRPLG_LOG_INF(srpntf_name, "Replay file \"%s\" renamed to \"%s\".", strrchr(old_path, '/') + 1,
             strrchr(new_path, '/') + 1);
 
+    /* rename its index */
+    free(old_path);
+    free(new_path);
+    new_path = NULL;
+    if ((rc = srpntf_get_index_path(NULL, mod_name, old_from_ts, old_to_ts, &old_path))) {
+        goto cleanup;
+    }
+    if ((rc = srpntf_get_index_path(NULL, mod_name, old_from_ts, new_to_ts, &new_path))) {
+        goto cleanup;
+    }
+    if ((rename(old_path, new_path) == -1) && (errno != ENOENT)) {
+        SRPLG_LOG_ERR(srpntf_name, "Renaming \"%s\" failed (%s).", old_path, strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+
 cleanup:
     free(old_path);
     free(new_path);
     return rc;
 }
 
+/**
+ * @brief Get the cached notification file of a module opened for writing, add it if not cached yet.
+ *
+ * Write files lock is expected to be held.
+ *
+ * @param[in] mod_name Module name.
+ * @param[out] wfile Cached file, its fd may not be opened.
+ * @return SR err value.
+ */
+static int
+srpntf_wfile_get(const char *mod_name, struct srpntf_wfile **wfile)
+{
+    struct srpntf_wfile *mem;
+    uint32_t i;
+
+    for (i = 0; i < srpntf_wfiles.count; ++i) {
+        if (!strcmp(srpntf_wfiles.files[i].mod_name, mod_name)) {
+            *wfile = &srpntf_wfiles.files[i];
+            return SR_ERR_OK;
+        }
+    }
+
+    /* add new item */
+    mem = realloc(srpntf_wfiles.files, (i + 1) * sizeof *mem);
+    if (!mem) {
+        SRPLG_LOG_ERR(srpntf_name, "Memory allocation failed.");
+        return SR_ERR_NO_MEMORY;
+    }
+    srpntf_wfiles.files = mem;
+
+    mem[i].mod_name = strdup(mod_name);
+    if (!mem[i].mod_name) {
+        SRPLG_LOG_ERR(srpntf_name, "Memory allocation failed.");
+        return SR_ERR_NO_MEMORY;
+    }
+    mem[i].fd = -1;
+    mem[i].from_ts = 0;
+    mem[i].to_ts = 0;
+    ++srpntf_wfiles.count;
+
+    *wfile = &mem[i];
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Close a cached notification file.
+ *
+ * @param[in] wfile Cached file to close.
+ */
+static void
+srpntf_wfile_close(struct srpntf_wfile *wfile)
+{
+    if (wfile->fd > -1) {
+        close(wfile->fd);
+    }
+    wfile->fd = -1;
+    wfile->from_ts = 0;
+    wfile->to_ts = 0;
+}
+
+/**
+ * @brief Open and cache the latest notification file of a module, if it is not opened or is no longer the latest file.
+ *
+ * Other processes may have written into the file, renamed it, or it may have been rotated so whether the cached
+ * file still exists under the same name is checked.
+ *
+ * @param[in] mod_name Module name.
+ * @param[in] wfile Cached file.
+ * @param[out] file_size Size of the file, if any opened.
+ * @return SR err value.
+ */
+static int
+srpntf_wfile_open(const char *mod_name, struct srpntf_wfile *wfile, size_t *file_size)
+{
+    int rc = SR_ERR_OK;
+    char *path = NULL;
+    struct stat st;
+
+    *file_size = 0;
+
+    if (wfile->fd > -1) {
+        /* check the cached file */
+        if ((rc = srpjson_get_notif_path(srpntf_name, mod_name, wfile->from_ts, wfile->to_ts, &path))) {
+            goto cleanup;
+        }
+        if (!stat(path, &st) && (st.st_dev == wfile->dev) && (st.st_ino == wfile->ino)) {
+            /* still valid */
+            *file_size = st.st_size;
+            goto cleanup;
+        }
+
+        /* reopen */
+        srpntf_wfile_close(wfile);
+    }
+
+    /* find the latest notification file for this module */
+    if ((rc = srpntf_find_file(mod_name, 0, 0, &wfile->from_ts, &wfile->to_ts))) {
+        goto cleanup;
+    }
+    if (!wfile->from_ts || !wfile->to_ts) {
+        /* no file */
+        goto cleanup;
+    }
+
+    /* open the file */
+    if ((rc = srpntf_open_file(mod_name, wfile->from_ts, wfile->to_ts, O_WRONLY | O_APPEND, &wfile->fd))) {
+        goto cleanup;
+    }
+
+    /* get file size */
+    if (fstat(wfile->fd, &st) == -1) {
+        SRPLG_LOG_ERR(srpntf_name, "Fstat failed (%s).", strerror(errno));
+        rc = SR_ERR_SYS;
+        goto cleanup;
+    }
+    wfile->dev = st.st_dev;
+    wfile->ino = st.st_ino;
+    *file_size = st.st_size;
+
+cleanup:
+    if (rc) {
+        srpntf_wfile_close(wfile);
+    }
+    free(path);
+    return rc;
+}
+
 static int
 srpntf_json_enable(const struct lys_module *mod)
 {
@@ -394,100 +933,199 @@ cleanup:
 static int
 srpntf_json_disable(const struct lys_module *mod)
 {
-    (void)mod;
+    struct srpntf_wfile *wfile;
+    uint32_t i;
+
+    /* WFILES LOCK */
+    pthread_mutex_lock(&srpntf_wfiles.lock);
+
+    /* close the cached file */
+    for (i = 0; i < srpntf_wfiles.count; ++i) {
+        wfile = &srpntf_wfiles.files[i];
+        if (!strcmp(wfile->mod_name, mod->name)) {
+            srpntf_wfile_close(wfile);
+            break;
+        }
+    }
+
+    /* WFILES UNLOCK */
+    pthread_mutex_unlock(&srpntf_wfiles.lock);
 
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Finish writing notifications into a cached notification file.
+ *
+ * @param[in] mod_name Module name.
+ * @param[in] wfile Cached file.
+ * @param[in] to_ts Latest notification written into the file.
+ * @return SR err value.
+ */
 static int
-srpntf_json_store(const struct lys_module *mod, const struct lyd_node *notif, const struct timespec *notif_ts)
+srpntf_wfile_flush(const char *mod_name, struct srpntf_wfile *wfile, time_t to_ts)
 {
-    int rc = SR_ERR_OK, fd = -1;
-    struct ly_out *out = NULL;
-    struct stat st;
-    char *notif_json = NULL;
-    uint32_t notif_json_len;
-    time_t from_ts, to_ts;
-    size_t file_size;
+    int rc;
 
-    /* create out */
-    if (ly_out_new_memory(&notif_json, 0, &out)) {
-        rc = SR_ERR_LY;
-        goto cleanup;
+    /* fsync */
+    if (fsync(wfile->fd) == -1) {
+        SRPLG_LOG_ERR(srpntf_name, "Fsync failed (%s).", strerror(errno));
+        return SR_ERR_SYS;
     }
 
-    /* convert notification into JSON */
-    if (lyd_print_all(out, notif, LYD_JSON, LYD_PRINT_SHRINK)) {
-        srpjson_log_err_ly(srpntf_name, mod->ctx);
-        rc = SR_ERR_LY;
-        goto cleanup;
+    /* update notification file name */
+    if ((rc = srpntf_rename_file(mod_name, wfile->from_ts, wfile->to_ts, to_ts))) {
+        return rc;
     }
+    wfile->to_ts = to_ts;
 
-    /* learn its length */
-    notif_json_len = ly_out_printed(out);
+    return SR_ERR_OK;
+}
 
-    /* find the latest notification file for this module */
-    if ((rc = srpntf_find_file(mod->name, 0, 0, &from_ts, &to_ts))) {
+/**
+ * @brief Store notifications of a module.
+ *
+ * @param[in] mod Module of the notifications.
+ * @param[in] notifs Notifications to store.
+ * @param[in] notif_tss Notification timestamps.
+ * @param[in] count Count of @p notifs.
+ * @return SR err value.
+ */
+static int
+srpntf_json_store_notifs(const struct lys_module *mod, const struct lyd_node **notifs, const struct timespec *notif_tss,
+        uint32_t count)
+{
+    int rc = SR_ERR_OK;
+    struct ly_out *out = NULL;
+    struct srpntf_wfile *wfile = NULL;
+    struct stat st;
+    char **notif_jsons = NULL;
+    uint32_t *notif_json_lens = NULL, i;
+    size_t file_size, notif_len;
+    time_t to_ts = 0;
+
+    notif_jsons = calloc(count, sizeof *notif_jsons);
+    notif_json_lens = malloc(count * sizeof *notif_json_lens);
+    if (!notif_jsons || !notif_json_lens) {
+        SRPLG_LOG_ERR(srpntf_name, "Memory allocation failed.");
+        rc = SR_ERR_NO_MEMORY;
         goto cleanup;
     }
 
-    if (from_ts && to_ts) {
-        /* open the file */
-        if ((rc = srpntf_open_file(mod->name, from_ts, to_ts, O_WRONLY | O_APPEND, &fd))) {
+    /* convert notifications into JSON */
+    for (i = 0; i < count; ++i) {
+        if (ly_out_new_memory(&notif_jsons[i], 0, &out)) {
+            rc = SR_ERR_LY;
             goto cleanup;
         }
-
-        /* get file size */
-        if (fstat(fd, &st) == -1) {
-            SRPLG_LOG_ERR(srpntf_name, "Fstat failed (%s).", strerror(errno));
-            rc = SR_ERR_SYS;
+        if (lyd_print_all(out, notifs[i], LYD_JSON, LYD_PRINT_SHRINK)) {
+            srpjson_log_err_ly(srpntf_name, mod->ctx);
+            rc = SR_ERR_LY;
             goto cleanup;
         }
-        file_size = st.st_size;
 
-        if (file_size + sizeof *notif_ts + sizeof notif_json_len + notif_json_len <= SRPJSON_NOTIF_FILE_MAX_SIZE * 1024) {
-            /* add the notification into the file if there is still space */
-            if ((rc = srpntf_writev_notif(fd, notif_json, notif_json_len, notif_ts))) {
-                goto cleanup;
-            }
+        /* learn its length */
+        notif_json_lens[i] = ly_out_printed(out);
+        ly_out_free(out, NULL, 0);
+        out = NULL;
+    }
 
-            /* update notification file name */
-            if ((rc = srpntf_rename_file(mod->name, from_ts, to_ts, notif_ts->tv_sec))) {
-                goto cleanup;
+    /* WFILES LOCK */
+    pthread_mutex_lock(&srpntf_wfiles.lock);
+
+    /* get the latest notification file for this module */
+    if ((rc = srpntf_wfile_get(mod->name, &wfile))) {
+        goto cleanup_unlock;
+    }
+    if ((rc = srpntf_wfile_open(mod->name, wfile, &file_size))) {
+        goto cleanup_unlock;
+    }
+    to_ts = wfile->to_ts;
+
+    for (i = 0; i < count; ++i) {
+        notif_len = sizeof notif_tss[i] + sizeof notif_json_lens[i] + notif_json_lens[i];
+
+        if ((wfile->fd > -1) && (file_size + notif_len > SRPJSON_NOTIF_FILE_MAX_SIZE * 1024)) {
+            /* no more space, finish and close this file */
+            if ((rc = srpntf_wfile_flush(mod->name, wfile, to_ts))) {
+                goto cleanup_unlock;
             }
+            srpntf_wfile_close(wfile);
+        }
 
-            /* we are done */
-            goto cleanup;
+        if (wfile->fd == -1) {
+            /* creating a new file */
+            if ((rc = srpntf_open_file(mod->name, notif_tss[i].tv_sec, notif_tss[i].tv_sec,
+                    O_WRONLY | O_APPEND | O_CREAT | O_EXCL, &wfile->fd))) {
+                goto cleanup_unlock;
+            }
+            wfile->from_ts = notif_tss[i].tv_sec;
+            wfile->to_ts = notif_tss[i].tv_sec;
+            if (fstat(wfile->fd, &st) == -1) {
+                SRPLG_LOG_ERR(srpntf_name, "Fstat failed (%s).", strerror(errno));
+                rc = SR_ERR_SYS;
+                goto cleanup_unlock;
+            }
+            wfile->dev = st.st_dev;
+            wfile->ino = st.st_ino;
+            file_size = 0;
         }
 
-        /* we will create a new file, close this one */
-        close(fd);
-        fd = -1;
+        /* add the notification into the file */
+        if ((rc = srpntf_writev_notif(wfile->fd, notif_jsons[i], notif_json_lens[i], &notif_tss[i]))) {
+            goto cleanup_unlock;
+        }
+        if (srpntf_index_append(mod->name, wfile->from_ts, wfile->to_ts, wfile->fd, file_size, notif_len, &notif_tss[i])) {
+            SRPLG_LOG_WRN(srpntf_name, "Failed to index a \"%s\" notification.", mod->name);
+        }
+        file_size += notif_len;
+        to_ts = notif_tss[i].tv_sec;
     }
 
-    /* creating a new file */
-    if ((rc = srpntf_open_file(mod->name, notif_ts->tv_sec, notif_ts->tv_sec, O_WRONLY | O_APPEND | O_CREAT | O_EXCL, &fd))) {
-        goto cleanup;
+    /* sync all the written notifications */
+    if ((rc = srpntf_wfile_flush(mod->name, wfile, to_ts))) {
+        goto cleanup_unlock;
     }
 
-    /* write the notification */
-    if ((rc = srpntf_writev_notif(fd, notif_json, notif_json_len, notif_ts))) {
-        goto cleanup;
+cleanup_unlock:
+    if (rc && wfile) {
+        /* the file state is unknown */
+        srpntf_wfile_close(wfile);
     }
 
+    /* WFILES UNLOCK */
+    pthread_mutex_unlock(&srpntf_wfiles.lock);
+
 cleanup:
     ly_out_free(out, NULL, 0);
-    if (fd > -1) {
-        close(fd);
+    for (i = 0; notif_jsons && (i < count); ++i) {
+        free(notif_jsons[i]);
     }
-    free(notif_json);
+    free(notif_jsons);
+    free(notif_json_lens);
     return rc;
 }
 
+static int
+srpntf_json_store(const struct lys_module *mod, const struct lyd_node *notif, const struct timespec *notif_ts)
+{
+    return srpntf_json_store_notifs(mod, &notif, notif_ts, 1);
+}
+
+static int
+srpntf_json_store_batch(const struct lys_module *mod, const struct lyd_node **notifs, const struct timespec *notif_tss,
+        uint32_t count)
+{
+    return srpntf_json_store_notifs(mod, notifs, notif_tss, count);
+}
+
 struct srpntf_rn_state {
     time_t file_from;
     time_t file_to;
     int fd;
+    char *arch_dir;
+    int archived;
+    int compressed;
 };
 
 static int
@@ -513,6 +1151,11 @@ srpntf_json_replay_next(const struct lys_module *mod, const struct timespec *sta
         st->file_from = start->tv_sec;
         st->file_to = 0;
         st->fd = -1;
+        st->archived = 0;
+        st->compressed = 0;
+        if ((rc = srpjson_get_notif_archive_dir(srpntf_name, &st->arch_dir))) {
+            goto cleanup;
+        }
 
         /* open first file */
         goto next_file;
@@ -528,7 +1171,18 @@ srpntf_json_replay_next(const struct lys_module *mod, const struct timespec *sta
         }
 
         /* open the file */
-        if ((rc = srpntf_open_file(mod->name, st->file_from, st->file_to, O_RDONLY, &st->fd))) {
+        if (st->archived) {
+            rc = srpntf_open_archive(st->arch_dir, mod->name, st->file_from, st->file_to, st->compressed, &st->fd);
+        } else {
+            rc = srpntf_open_file(mod->name, st->file_from, st->file_to, O_RDONLY, &st->fd);
+        }
+        if (rc) {
+            goto cleanup;
+        }
+
+        /* skip as many earlier notifications as possible using the index */
+        if ((rc = srpntf_index_seek(st->archived ? st->arch_dir : NULL, mod->name, st->file_from, st->file_to, st->fd,
+                start))) {
             goto cleanup;
         }
 
@@ -573,7 +1227,8 @@ next_notif:
 
 next_file:
         /* find next notification file and read from it */
-        if ((rc = srpntf_find_file(mod->name, st->file_from, st->file_to, &st->file_from, &st->file_to))) {
+        if ((rc = srpntf_find_replay_file(st->arch_dir, mod->name, st->file_from, st->file_to, &st->file_from,
+                &st->file_to, &st->archived, &st->compressed))) {
             goto cleanup;
         }
     }
@@ -587,6 +1242,7 @@ cleanup:
         if (st->fd > -1) {
             close(st->fd);
         }
+        free(st->arch_dir);
         free(st);
     }
     return rc;
@@ -595,15 +1251,19 @@ cleanup:
 static int
 srpntf_json_earliest_get(const struct lys_module *mod, struct timespec *ts)
 {
-    int rc = SR_ERR_OK, fd = -1;
+    int rc = SR_ERR_OK, fd = -1, archived, compressed;
     time_t file_from, file_to;
+    char *arch_dir = NULL;
 
     /* create directory in case does not exist */
     if ((rc = srpntf_json_enable(mod))) {
         goto cleanup;
     }
 
-    if ((rc = srpntf_find_file(mod->name, 1, 0, &file_from, &file_to))) {
+    if ((rc = srpjson_get_notif_archive_dir(srpntf_name, &arch_dir))) {
+        goto cleanup;
+    }
+    if ((rc = srpntf_find_replay_file(arch_dir, mod->name, 1, 0, &file_from, &file_to, &archived, &compressed))) {
         goto cleanup;
     }
     if (!file_from) {
@@ -613,7 +1273,12 @@ srpntf_json_earliest_get(const struct lys_module *mod, struct timespec *ts)
     }
 
     /* open the file */
-    if ((rc = srpntf_open_file(mod->name, file_from, file_to, O_RDONLY, &fd))) {
+    if (archived) {
+        rc = srpntf_open_archive(arch_dir, mod->name, file_from, file_to, compressed, &fd);
+    } else {
+        rc = srpntf_open_file(mod->name, file_from, file_to, O_RDONLY, &fd);
+    }
+    if (rc) {
         goto cleanup;
     }
 
@@ -631,6 +1296,7 @@ cleanup:
     if (fd > -1) {
         close(fd);
     }
+    free(arch_dir);
     return rc;
 }
 
@@ -798,6 +1464,7 @@ const struct srplg_ntf_s srpntf_json = {
     .enable_cb = srpntf_json_enable,
     .disable_cb = srpntf_json_disable,
     .store_cb = srpntf_json_store,
+    .store_batch_cb = srpntf_json_store_batch,
     .replay_next_cb = srpntf_json_replay_next,
     .earliest_get_cb = srpntf_json_earliest_get,
     .access_set_cb = srpntf_json_access_set,
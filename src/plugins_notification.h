@@ -40,7 +40,7 @@ extern "C" {
 /**
  * @brief Notification plugin API version
  */
-#define SRPLG_NTF_API_VERSION 2
+#define SRPLG_NTF_API_VERSION 3
 
 /**
  * @brief Initialize notification storage for a specific module.
@@ -75,6 +75,19 @@ typedef int (*srntf_disable)(const struct lys_module *mod);
  */
 typedef int (*srntf_store)(const struct lys_module *mod, const struct lyd_node *notif, const struct timespec *notif_ts);
 
+/**
+ * @brief Store several notifications of a module for replay at once.
+ *
+ * @param[in] mod Specific module.
+ * @param[in] notifs Notification data trees in the order they were generated.
+ * @param[in] notif_tss Notification timestamps.
+ * @param[in] count Count of @p notifs.
+ * @return ::SR_ERR_OK on success;
+ * @return Sysrepo error value on error.
+ */
+typedef int (*srntf_store_batch)(const struct lys_module *mod, const struct lyd_node **notifs,
+        const struct timespec *notif_tss, uint32_t count);
+
 /**
  * @brief Replay the next notification of a module.
  *
@@ -146,6 +159,8 @@ struct srplg_ntf_s {
     srntf_enable enable_cb;         /**< enable notification storage of a module */
     srntf_disable disable_cb;       /**< disable notification storage of a module */
     srntf_store store_cb;           /**< store a notification for replay */
+    srntf_store_batch store_batch_cb;   /**< optional, store several notifications for replay, ::srntf_store is
+                                             used for every notification if not set */
     srntf_replay_next replay_next_cb;   /**< replay next notification in order */
     srntf_earliest_get earliest_get_cb; /**< get the timestamp of the earliest stored notification */
     srntf_access_set access_set_cb; /**< callback for setting access rights for notification data */
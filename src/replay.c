@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/uio.h>
@@ -41,20 +42,534 @@
 #include "sysrepo.h"
 
 /**
- * @brief Store the notification for replay.
+ * @brief Notification loaded from a replay ring SHM.
+ */
+struct sr_replay_ring_notif_s {
+    struct lyd_node *notif;     /**< Notification data tree. */
+    struct timespec notif_ts;   /**< Notification timestamp. */
+};
+
+/**
+ * @brief Get the size of a replay ring SHM.
  *
- * @param[in] conn Connection to use.
- * @param[in] shm_mod Notification SHM module.
+ * @return Replay ring SHM size.
+ */
+static size_t
+sr_replay_ring_shm_size(void)
+{
+    return SR_SHM_SIZE(sizeof(sr_replay_ring_shm_t)) + SR_REPLAY_RING_SIZE * SR_REPLAY_RING_SLOT_SIZE;
+}
+
+/**
+ * @brief Get a slot of a replay ring.
+ *
+ * @param[in] ring Replay ring.
+ * @param[in] idx Index of the slot relative to the first (oldest) one.
+ * @return Replay ring slot.
+ */
+static sr_replay_ring_slot_t *
+sr_replay_ring_slot(sr_replay_ring_shm_t *ring, uint32_t idx)
+{
+    idx = (ring->first + idx) % ring->slot_count;
+    return (sr_replay_ring_slot_t *)(((char *)ring) + SR_SHM_SIZE(sizeof *ring) + idx * ring->slot_size);
+}
+
+/**
+ * @brief Get the smallest timestamp larger than a timestamp.
+ *
+ * @param[in] ts Timestamp.
+ * @return Next timestamp.
+ */
+static struct timespec
+sr_replay_ring_ts_next(const struct timespec *ts)
+{
+    struct timespec next = *ts;
+
+    if (++next.tv_nsec == 1000000000L) {
+        next.tv_nsec = 0;
+        ++next.tv_sec;
+    }
+    return next;
+}
+
+/**
+ * @brief Empty a replay ring.
+ *
+ * @param[in] ring Replay ring.
+ * @param[in] since Earliest timestamp of notifications the ring will include.
+ */
+static void
+sr_replay_ring_reset(sr_replay_ring_shm_t *ring, const struct timespec *since)
+{
+    ring->first = 0;
+    ring->count = 0;
+    ring->since = *since;
+}
+
+/**
+ * @brief Open and map the replay ring SHM of a module.
+ *
+ * @param[in] ly_mod Notification module.
+ * @param[in] ntf_plg Notification plugin of @p ly_mod to create the ring for writing, NULL to map it only for reading.
+ * @param[out] ring Mapped replay ring, NULL if there is none that could be read or we are not allowed to write it.
+ * @param[out] st Optional stat of the mapped replay ring SHM file.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_replay_ring_open(const struct lys_module *ly_mod, const struct srplg_ntf_s *ntf_plg, sr_replay_ring_shm_t **ring,
+        struct stat *st)
+{
+    sr_error_info_t *err_info = NULL;
+    char *path = NULL;
+    size_t size;
+    mode_t perm;
+    void *addr;
+    int fd = -1, rc, created = 0;
+
+    *ring = NULL;
+
+    if ((err_info = sr_path_replay_ring_shm(ly_mod->name, &path))) {
+        goto cleanup;
+    }
+
+    if (ntf_plg) {
+        /* the ring can be read by anyone allowed to read the notifications */
+        if ((rc = ntf_plg->access_get_cb(ly_mod, NULL, NULL, &perm))) {
+            SR_ERRINFO_DSPLUGIN(&err_info, rc, "access_get", ntf_plg->name, ly_mod->name);
+            goto cleanup;
+        }
+        fd = sr_open(path, O_RDWR | O_CREAT, perm);
+        if (fd == -1) {
+            if (errno != EACCES) {
+                SR_ERRINFO_SYSERRPATH(&err_info, "open", path);
+            } /* else we are not allowed to write the ring */
+            goto cleanup;
+        }
+    } else {
+        /* there may be no ring or we may not be allowed to read it */
+        fd = sr_open(path, O_RDONLY, 0);
+        if (fd == -1) {
+            goto cleanup;
+        }
+    }
+
+    if ((err_info = sr_file_get_size(fd, &size))) {
+        goto cleanup;
+    }
+    if (st && (fstat(fd, st) == -1)) {
+        SR_ERRINFO_SYSERRNO(&err_info, "fstat");
+        goto cleanup;
+    }
+    if (size != sr_replay_ring_shm_size()) {
+        if (!ntf_plg) {
+            /* not a ring we could use */
+            goto cleanup;
+        }
+
+        /* create a new empty ring */
+        if ((ftruncate(fd, 0) == -1) || (ftruncate(fd, sr_replay_ring_shm_size()) == -1)) {
+            SR_ERRINFO_SYSERRNO(&err_info, "ftruncate");
+            goto cleanup;
+        }
+        created = 1;
+    }
+
+    /* map it */
+    addr = mmap(NULL, sr_replay_ring_shm_size(), ntf_plg ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        SR_ERRINFO_SYSERRNO(&err_info, "mmap");
+        goto cleanup;
+    }
+    *ring = addr;
+
+    if (created || ((*ring)->slot_count != SR_REPLAY_RING_SIZE) || ((*ring)->slot_size != SR_REPLAY_RING_SLOT_SIZE)) {
+        if (!ntf_plg) {
+            munmap(*ring, sr_replay_ring_shm_size());
+            *ring = NULL;
+            goto cleanup;
+        }
+
+        /* initialize the ring, it will be emptied before use */
+        (*ring)->slot_count = SR_REPLAY_RING_SIZE;
+        (*ring)->slot_size = SR_REPLAY_RING_SLOT_SIZE;
+        (*ring)->content_id = 0;
+        (*ring)->count = 0;
+    }
+
+cleanup:
+    if (fd > -1) {
+        close(fd);
+    }
+    free(path);
+    return err_info;
+}
+
+/**
+ * @brief Append a notification into a replay ring, dropping the oldest one if full.
+ *
+ * @param[in] ring Replay ring.
  * @param[in] notif Notification data tree.
  * @param[in] notif_ts Notification timestamp.
+ */
+static void
+sr_replay_ring_append(sr_replay_ring_shm_t *ring, const struct lyd_node *notif, const struct timespec *notif_ts)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_replay_ring_slot_t *slot;
+    struct timespec next_ts;
+    char *lyb = NULL;
+    uint32_t lyb_len;
+
+    if (ring->count) {
+        slot = sr_replay_ring_slot(ring, ring->count - 1);
+        if (sr_time_cmp(notif_ts, &slot->notif_ts) < 0) {
+            /* out-of-order notification, the ring must stay ordered */
+            next_ts = sr_replay_ring_ts_next(&slot->notif_ts);
+            sr_replay_ring_reset(ring, &next_ts);
+        }
+    }
+    if (sr_time_cmp(notif_ts, &ring->since) < 0) {
+        /* not covered by the ring */
+        return;
+    }
+
+    /* print the notification */
+    if ((err_info = sr_lyd_print_lyb(notif, &lyb, &lyb_len)) || (sizeof *slot + lyb_len > ring->slot_size)) {
+        /* it cannot be kept, the ring can include only later notifications */
+        sr_errinfo_free(&err_info);
+        next_ts = sr_replay_ring_ts_next(notif_ts);
+        sr_replay_ring_reset(ring, &next_ts);
+        goto cleanup;
+    }
+
+    if (ring->count == ring->slot_count) {
+        /* drop the oldest notification */
+        slot = sr_replay_ring_slot(ring, 0);
+        next_ts = sr_replay_ring_ts_next(&slot->notif_ts);
+        if (sr_time_cmp(&next_ts, &ring->since) > 0) {
+            ring->since = next_ts;
+        }
+        ring->first = (ring->first + 1) % ring->slot_count;
+        --ring->count;
+    }
+
+    /* store the notification */
+    slot = sr_replay_ring_slot(ring, ring->count);
+    slot->notif_ts = *notif_ts;
+    slot->data_len = lyb_len;
+    memcpy(slot + 1, lyb, lyb_len);
+    ++ring->count;
+
+cleanup:
+    free(lyb);
+}
+
+/**
+ * @brief Get the replay ring SHM of a module mapped for writing, it is kept mapped in the connection
+ * until the ring is replaced.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] ly_mod Notification module.
+ * @param[in] ntf_plg Notification plugin of @p ly_mod.
+ * @param[out] ring Mapped replay ring, NULL if we are not allowed to write it.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_replay_ring_cache_get(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, const struct srplg_ntf_s *ntf_plg,
+        sr_replay_ring_shm_t **ring)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_replay_ring_cache_s *cache = NULL;
+    sr_replay_ring_shm_t *mapped;
+    struct stat st = {0};
+    char *path = NULL;
+    void *mem;
+    uint32_t i;
+
+    *ring = NULL;
+
+    if ((err_info = sr_path_replay_ring_shm(ly_mod->name, &path))) {
+        return err_info;
+    }
+
+    /* learn the current ring, it is replaced when its module is removed or its replay support changed */
+    if ((stat(path, &st) == -1) && (errno != ENOENT)) {
+        SR_ERRINFO_SYSERRPATH(&err_info, "stat", path);
+        free(path);
+        return err_info;
+    }
+    free(path);
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->replay_ring_cache_lock, SR_CONN_REPLAY_RING_CACHE_LOCK_TIMEOUT, __func__, NULL,
+            NULL))) {
+        return err_info;
+    }
+
+    for (i = 0; i < conn->replay_ring_cache_count; ++i) {
+        if (!strcmp(conn->replay_ring_cache[i].mod_name, ly_mod->name)) {
+            cache = &conn->replay_ring_cache[i];
+            break;
+        }
+    }
+
+    if (cache && (cache->dev == st.st_dev) && (cache->ino == st.st_ino)) {
+        /* the cached ring is still the current one */
+        *ring = cache->ring;
+        goto cleanup;
+    }
+
+    if (!cache) {
+        /* new cached ring */
+        mem = realloc(conn->replay_ring_cache, (conn->replay_ring_cache_count + 1) * sizeof *conn->replay_ring_cache);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+        conn->replay_ring_cache = mem;
+        cache = &conn->replay_ring_cache[conn->replay_ring_cache_count];
+        memset(cache, 0, sizeof *cache);
+
+        cache->mod_name = strdup(ly_mod->name);
+        SR_CHECK_MEM_GOTO(!cache->mod_name, err_info, cleanup);
+        ++conn->replay_ring_cache_count;
+    } else if (cache->ring) {
+        /* the ring was replaced */
+        munmap(cache->ring, sr_replay_ring_shm_size());
+        cache->ring = NULL;
+    }
+
+    /* map the current ring */
+    if ((err_info = sr_replay_ring_open(ly_mod, ntf_plg, &mapped, &st))) {
+        /* forget it to try again next time */
+        free(cache->mod_name);
+        --conn->replay_ring_cache_count;
+        if (cache != &conn->replay_ring_cache[conn->replay_ring_cache_count]) {
+            memcpy(cache, &conn->replay_ring_cache[conn->replay_ring_cache_count], sizeof *cache);
+        }
+        goto cleanup;
+    }
+    if (!mapped) {
+        /* remember the ring we are not allowed to write so that it is tried again only once replaced */
+        SR_LOG_WRN("Not allowed to keep notifications of module \"%s\" in the replay ring.", ly_mod->name);
+    }
+    cache->dev = st.st_dev;
+    cache->ino = st.st_ino;
+    cache->ring = mapped;
+    *ring = mapped;
+
+cleanup:
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->replay_ring_cache_lock);
+    return err_info;
+}
+
+void
+sr_replay_ring_cache_flush(sr_conn_ctx_t *conn)
+{
+    uint32_t i;
+
+    /* connection is being freed, no locking needed */
+    for (i = 0; i < conn->replay_ring_cache_count; ++i) {
+        if (conn->replay_ring_cache[i].ring) {
+            munmap(conn->replay_ring_cache[i].ring, sr_replay_ring_shm_size());
+        }
+        free(conn->replay_ring_cache[i].mod_name);
+    }
+    free(conn->replay_ring_cache);
+    conn->replay_ring_cache = NULL;
+    conn->replay_ring_cache_count = 0;
+}
+
+/**
+ * @brief Keep notifications stored for replay in the replay ring SHM of their module. Failing to update the ring
+ * is not an error, it is then not used until it is updated again.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] shm_mod Notification SHM module, with REPLAY WRITE lock.
+ * @param[in] ntf_plg Notification plugin of the module.
+ * @param[in] notifs Notification data trees.
+ * @param[in] notif_tss Notification timestamps.
+ * @param[in] count Count of @p notifs.
+ * @param[in] stored Whether all the notifications were successfully stored by @p ntf_plg.
+ */
+static void
+sr_replay_ring_store(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, const struct srplg_ntf_s *ntf_plg,
+        const struct lyd_node **notifs, const struct timespec *notif_tss, uint32_t count, int stored)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lys_module *ly_mod = lyd_owner_module(notifs[0]);
+    sr_replay_ring_shm_t *ring = NULL;
+    struct timespec since;
+    uint32_t notif_count, i;
+
+    /* every stored notification is counted so that readers can detect the ring missed some */
+    notif_count = shm_mod->replay_notif_count;
+    shm_mod->replay_notif_count += count;
+
+    if ((err_info = sr_replay_ring_cache_get(conn, ly_mod, ntf_plg, &ring)) || !ring) {
+        goto cleanup;
+    }
+
+    if ((ring->content_id != conn->content_id) || (ring->notif_count != notif_count) || !stored) {
+        /* some stored notifications may be missing in the ring, include only later ones */
+        sr_realtime_get(&since);
+        for (i = 0; !stored && (i < count); ++i) {
+            if (sr_time_cmp(&notif_tss[i], &since) > -1) {
+                since = sr_replay_ring_ts_next(&notif_tss[i]);
+            }
+        }
+        sr_replay_ring_reset(ring, &since);
+        ring->content_id = conn->content_id;
+    }
+
+    for (i = 0; stored && (i < count); ++i) {
+        sr_replay_ring_append(ring, notifs[i], &notif_tss[i]);
+    }
+    ring->notif_count = shm_mod->replay_notif_count;
+
+cleanup:
+    if (err_info) {
+        sr_errinfo_free(&err_info);
+        SR_LOG_WRN("Failed to keep notifications of module \"%s\" in the replay ring.", ly_mod->name);
+    }
+}
+
+/**
+ * @brief Load notifications to replay from the replay ring SHM of a module, if it includes all of them.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] shm_mod Notification SHM module.
+ * @param[in] ly_mod Notification module.
+ * @param[in] start_time Replay start time, notifications with this or a later timestamp are replayed.
+ * @param[in] stop_ts Replay stop timestamp, only notifications with a smaller timestamp are replayed.
+ * @param[out] notifs Loaded notifications, in order.
+ * @param[out] notif_count Count of @p notifs.
+ * @return Whether the notifications were loaded from the ring.
+ */
+static int
+sr_replay_ring_load(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, const struct lys_module *ly_mod,
+        const struct timespec *start_time, const struct timespec *stop_ts, struct sr_replay_ring_notif_s **notifs,
+        uint32_t *notif_count)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_replay_ring_shm_t *ring = NULL;
+    sr_replay_ring_slot_t *slot;
+    struct ly_in *in = NULL;
+    struct lyd_node *notif;
+    void *mem;
+    uint32_t i;
+    int loaded = 0, locked = 0;
+
+    *notifs = NULL;
+    *notif_count = 0;
+
+    /* REPLAY READ LOCK */
+    if ((err_info = sr_rwlock(&shm_mod->replay_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__, NULL,
+            NULL))) {
+        goto cleanup;
+    }
+    locked = 1;
+
+    if ((err_info = sr_replay_ring_open(ly_mod, NULL, &ring, NULL)) || !ring) {
+        goto cleanup;
+    }
+
+    /* the ring must include all the stored notifications since the start time */
+    if ((ring->content_id != conn->content_id) || (ring->notif_count != shm_mod->replay_notif_count) ||
+            (sr_time_cmp(start_time, &ring->since) < 0)) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < ring->count; ++i) {
+        slot = sr_replay_ring_slot(ring, i);
+        if (sr_time_cmp(&slot->notif_ts, start_time) < 0) {
+            continue;
+        } else if (sr_time_cmp(&slot->notif_ts, stop_ts) > -1) {
+            break;
+        }
+        SR_CHECK_INT_GOTO(sizeof *slot + slot->data_len > ring->slot_size, err_info, cleanup);
+
+        /* parse the notification directly from the SHM */
+        ly_in_new_memory((char *)(slot + 1), &in);
+        if (lyd_parse_op(ly_mod->ctx, NULL, in, LYD_LYB, LYD_TYPE_NOTIF_YANG, &notif, NULL)) {
+            sr_errinfo_new_ly(&err_info, ly_mod->ctx, NULL);
+            goto cleanup;
+        }
+        ly_in_free(in, 0);
+        in = NULL;
+
+        mem = realloc(*notifs, (*notif_count + 1) * sizeof **notifs);
+        if (!mem) {
+            lyd_free_siblings(notif);
+            SR_ERRINFO_MEM(&err_info);
+            goto cleanup;
+        }
+        *notifs = mem;
+        (*notifs)[*notif_count].notif = notif;
+        (*notifs)[*notif_count].notif_ts = slot->notif_ts;
+        ++(*notif_count);
+    }
+    loaded = 1;
+
+cleanup:
+    if (ring) {
+        munmap(ring, sr_replay_ring_shm_size());
+    }
+    if (locked) {
+        /* REPLAY READ UNLOCK */
+        sr_rwunlock(&shm_mod->replay_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+    }
+    ly_in_free(in, 0);
+    if (err_info) {
+        /* fall back to the notification plugin */
+        sr_errinfo_free(&err_info);
+        SR_LOG_WRN("Failed to load notifications of module \"%s\" from the replay ring.", ly_mod->name);
+    }
+    if (!loaded) {
+        for (i = 0; i < *notif_count; ++i) {
+            lyd_free_siblings((*notifs)[i].notif);
+        }
+        free(*notifs);
+        *notifs = NULL;
+        *notif_count = 0;
+    }
+    return loaded;
+}
+
+void
+sr_replay_ring_remove(const char *mod_name)
+{
+    sr_error_info_t *err_info = NULL;
+    char *path;
+
+    if ((err_info = sr_path_replay_ring_shm(mod_name, &path))) {
+        sr_errinfo_free(&err_info);
+        return;
+    }
+
+    if (unlink(path) && (errno != ENOENT)) {
+        SR_LOG_WRN("Failed to remove replay ring \"%s\" (%s).", path, strerror(errno));
+    }
+    free(path);
+}
+
+/**
+ * @brief Store notifications of a single module for replay.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] shm_mod Notification SHM module.
+ * @param[in] notifs Notification data trees.
+ * @param[in] notif_tss Notification timestamps.
+ * @param[in] count Count of @p notifs.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_notif_write(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, const struct lyd_node *notif, struct timespec notif_ts)
+sr_notif_write(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, const struct lyd_node **notifs, const struct timespec *notif_tss,
+        uint32_t count)
 {
     sr_error_info_t *err_info = NULL;
     const struct srplg_ntf_s *ntf_plg;
-    int rc;
+    const struct lys_module *ly_mod = lyd_owner_module(notifs[0]);
+    uint32_t i;
+    int rc, stored = 0;
 
     /* find plugin */
     if ((err_info = sr_ntf_plugin_find(conn->mod_shm.addr + shm_mod->plugins[SR_MOD_DS_NOTIF], conn, &ntf_plg))) {
@@ -66,15 +581,29 @@ sr_notif_write(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, const struct lyd_node *no
         goto cleanup;
     }
 
-    /* store the notification */
-    if ((rc = ntf_plg->store_cb(lyd_owner_module(notif), notif, &notif_ts))) {
-        SR_ERRINFO_DSPLUGIN(&err_info, rc, "store", ntf_plg->name, lyd_owner_module(notif)->name);
-        goto cleanup_unlock;
+    if ((count > 1) && ntf_plg->store_batch_cb) {
+        /* store all the notifications at once */
+        if ((rc = ntf_plg->store_batch_cb(ly_mod, notifs, notif_tss, count))) {
+            SR_ERRINFO_DSPLUGIN(&err_info, rc, "store_batch", ntf_plg->name, ly_mod->name);
+            goto cleanup_unlock;
+        }
+    } else {
+        /* store the notifications one by one */
+        for (i = 0; i < count; ++i) {
+            if ((rc = ntf_plg->store_cb(ly_mod, notifs[i], &notif_tss[i]))) {
+                SR_ERRINFO_DSPLUGIN(&err_info, rc, "store", ntf_plg->name, ly_mod->name);
+                goto cleanup_unlock;
+            }
+        }
     }
 
     /* success */
+    stored = 1;
 
 cleanup_unlock:
+    /* keep the notifications in the replay ring */
+    sr_replay_ring_store(conn, shm_mod, ntf_plg, notifs, notif_tss, count, stored);
+
     /* REPLAY WRITE UNLOCK */
     sr_rwunlock(&shm_mod->replay_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__);
 cleanup:
@@ -184,7 +713,7 @@ sr_replay_store(sr_session_ctx_t *sess, const struct lyd_node *notif, struct tim
 
     if (!has_buf) {
         /* write the notification to a replay file */
-        if ((err_info = sr_notif_write(sess->conn, shm_mod, notif, notif_ts))) {
+        if ((err_info = sr_notif_write(sess->conn, shm_mod, &notif, &notif_ts, 1))) {
             return err_info;
         }
     }
@@ -209,32 +738,76 @@ static sr_error_info_t *
 sr_notif_buf_thread_write_notifs(sr_conn_ctx_t *conn, struct sr_sess_notif_buf_node *first)
 {
     sr_error_info_t *err_info = NULL;
-    struct sr_sess_notif_buf_node *prev;
+    struct sr_sess_notif_buf_node *node, *prev, *next;
+    const struct lys_module *ly_mod;
+    const struct lyd_node **notifs = NULL;
+    struct timespec *notif_tss = NULL;
+    uint32_t count, size = 0;
     sr_mod_t *shm_mod;
+    void *mem;
 
     while (first) {
+        ly_mod = lyd_owner_module(first->notif);
+
         /* find SHM mod */
-        shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), lyd_owner_module(first->notif)->name);
-        if (!shm_mod) {
-            SR_ERRINFO_INT(&err_info);
-            return err_info;
+        shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), ly_mod->name);
+        SR_CHECK_INT_GOTO(!shm_mod, err_info, cleanup);
+
+        /* collect all the notifications of this module, in order */
+        count = 0;
+        for (node = first; node; node = node->next) {
+            if (lyd_owner_module(node->notif) != ly_mod) {
+                continue;
+            }
+
+            if (count == size) {
+                size = size ? size * 2 : 8;
+                mem = realloc(notifs, size * sizeof *notifs);
+                SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+                notifs = mem;
+                mem = realloc(notif_tss, size * sizeof *notif_tss);
+                SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+                notif_tss = mem;
+            }
+            notifs[count] = node->notif;
+            notif_tss[count] = node->notif_ts;
+            ++count;
         }
 
-        /* store the notification */
-        if ((err_info = sr_notif_write(conn, shm_mod, first->notif, first->notif_ts))) {
-            return err_info;
+        /* store them */
+        if ((err_info = sr_notif_write(conn, shm_mod, notifs, notif_tss, count))) {
+            goto cleanup;
         }
 
-        /* next iter */
-        prev = first;
-        first = first->next;
+        /* free them */
+        prev = NULL;
+        for (node = first; node; node = next) {
+            next = node->next;
+            if (lyd_owner_module(node->notif) != ly_mod) {
+                prev = node;
+                continue;
+            }
 
-        /* free prev */
-        lyd_free_siblings(prev->notif);
-        free(prev);
+            if (prev) {
+                prev->next = next;
+            } else {
+                first = next;
+            }
+            lyd_free_siblings(node->notif);
+            free(node);
+        }
     }
 
-    return NULL;
+cleanup:
+    while (first) {
+        next = first->next;
+        lyd_free_siblings(first->notif);
+        free(first);
+        first = next;
+    }
+    free(notifs);
+    free(notif_tss);
+    return err_info;
 }
 
 void *
@@ -300,94 +873,332 @@ cleanup:
     return err_info;
 }
 
-sr_error_info_t *
-sr_replay_notify(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id, const char *xpath,
-        const struct timespec *start_time, const struct timespec *stop_time, struct timespec *listen_since,
-        sr_event_notif_cb cb, sr_event_notif_tree_cb tree_cb, void *private_data)
+/**
+ * @brief Replay a single notification, if it matches the XPath filter.
+ *
+ * @param[in] ev_sess Event session to use.
+ * @param[in] sub_id Notification subscription ID.
+ * @param[in] xpath Optional XPath filter.
+ * @param[in] notif Notification data tree.
+ * @param[in] notif_ts Notification timestamp.
+ * @param[in] cb Optional notification callback.
+ * @param[in] tree_cb Optional notification tree callback.
+ * @param[in] private_data Notification callback private data.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_replay_notify_notif(sr_session_ctx_t *ev_sess, uint32_t sub_id, const char *xpath, struct lyd_node *notif,
+        const struct timespec *notif_ts, sr_event_notif_cb cb, sr_event_notif_tree_cb tree_cb, void *private_data)
 {
     sr_error_info_t *err_info = NULL;
-    const struct srplg_ntf_s *ntf_plg;
-    const struct lys_module *ly_mod;
-    sr_mod_t *shm_mod;
-    struct timespec notif_ts, stop_ts;
     struct ly_set *set = NULL;
-    struct lyd_node *notif = NULL, *notif_op;
-    sr_session_ctx_t *ev_sess = NULL;
-    void *state = NULL;
+    struct lyd_node *notif_op;
+
+    /* make sure the XPath filter matches something */
+    if (xpath) {
+        SR_CHECK_INT_GOTO(lyd_find_xpath(notif, xpath, &set), err_info, cleanup);
+        if (!set->count) {
+            goto cleanup;
+        }
+    }
+
+    /* find notification node */
+    notif_op = notif;
+    if ((err_info = sr_ly_find_last_parent(&notif_op, LYS_NOTIF))) {
+        goto cleanup;
+    }
+    SR_CHECK_INT_GOTO(notif_op->schema->nodetype != LYS_NOTIF, err_info, cleanup);
+
+    /* call callback */
+    err_info = sr_notif_call_callback(ev_sess, cb, tree_cb, private_data, SR_EV_NOTIF_REPLAY, sub_id, notif_op, notif_ts);
+
+cleanup:
+    ly_set_free(set, NULL);
+    return err_info;
+}
+
+/**
+ * @brief Replay cursor of a module, shared by all its replayed subscriptions.
+ */
+struct sr_replay_cursor_s {
+    sr_mod_t *shm_mod;                  /**< SHM module. */
+    const struct lys_module *ly_mod;    /**< Notification module. */
+    const struct srplg_ntf_s *ntf_plg;  /**< Notification plugin, NULL if replaying from the replay ring. */
+    struct timespec start_time;         /**< Earliest start time of the subscriptions. */
+    struct timespec stop_ts;            /**< Latest stop timestamp of the subscriptions. */
+    void *state;                        /**< Notification plugin replay state. */
+
+    struct sr_replay_ring_notif_s *ring_notifs; /**< Notifications loaded from the replay ring. */
+    uint32_t ring_notif_count;          /**< Count of ring_notifs. */
+    uint32_t ring_idx;                  /**< Index of the next ring notification. */
+
+    struct lyd_node *notif;             /**< Current notification, NULL if there are no more. */
+    struct timespec notif_ts;           /**< Current notification timestamp. */
+};
+
+/**
+ * @brief Move a replay cursor to its next notification.
+ *
+ * @param[in] cursor Replay cursor.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_replay_cursor_next(struct sr_replay_cursor_s *cursor)
+{
+    sr_error_info_t *err_info = NULL;
     int rc;
 
-    /* get the stop timestamp - only notifications with smaller timestamp can be replayed */
-    if (!SR_TS_IS_ZERO(*stop_time) && (sr_time_cmp(stop_time, listen_since) < 1)) {
-        stop_ts = *stop_time;
-    } else {
-        stop_ts = *listen_since;
+    if (!cursor->ntf_plg) {
+        /* replay ring notifications are all loaded */
+        cursor->notif = NULL;
+        if (cursor->ring_idx < cursor->ring_notif_count) {
+            cursor->notif = cursor->ring_notifs[cursor->ring_idx].notif;
+            cursor->notif_ts = cursor->ring_notifs[cursor->ring_idx].notif_ts;
+            ++cursor->ring_idx;
+        }
+        return NULL;
     }
 
-    /* find SHM mod for replay lock and check if replay is even supported */
-    shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), mod_name);
-    SR_CHECK_INT_GOTO(!shm_mod, err_info, cleanup);
+    lyd_free_siblings(cursor->notif);
+    cursor->notif = NULL;
 
-    if (!shm_mod->replay_supp) {
-        SR_LOG_WRN("Module \"%s\" does not support notification replay.", mod_name);
-        goto replay_complete;
+    rc = cursor->ntf_plg->replay_next_cb(cursor->ly_mod, &cursor->start_time, &cursor->stop_ts, &cursor->notif,
+            &cursor->notif_ts, &cursor->state);
+    if (rc) {
+        /* state was freed */
+        cursor->notif = NULL;
+        cursor->state = NULL;
+        if (rc != SR_ERR_NOT_FOUND) {
+            SR_ERRINFO_DSPLUGIN(&err_info, rc, "replay_next", cursor->ntf_plg->name, cursor->ly_mod->name);
+        }
     }
 
-    /* find module */
-    ly_mod = ly_ctx_get_module_implemented(conn->ly_ctx, mod_name);
-    assert(ly_mod);
+    return err_info;
+}
 
-    /* find plugin */
-    if ((err_info = sr_ntf_plugin_find(conn->mod_shm.addr + shm_mod->plugins[SR_MOD_DS_NOTIF], conn, &ntf_plg))) {
+/**
+ * @brief Compare the current notifications of 2 replay cursors.
+ *
+ * @param[in] cursors Replay cursors.
+ * @param[in] idx1 Index of the first cursor.
+ * @param[in] idx2 Index of the second cursor.
+ * @return Negative, zero, or positive value if the first notification is earlier, the same, or later.
+ */
+static int
+sr_replay_cursor_cmp(const struct sr_replay_cursor_s *cursors, uint32_t idx1, uint32_t idx2)
+{
+    int cmp;
+
+    cmp = sr_time_cmp(&cursors[idx1].notif_ts, &cursors[idx2].notif_ts);
+    if (!cmp) {
+        /* keep the order of the modules for equal timestamps */
+        cmp = (idx1 < idx2) ? -1 : (idx1 > idx2);
+    }
+
+    return cmp;
+}
+
+/**
+ * @brief Restore the min-heap property of replay cursors by moving an item down.
+ *
+ * @param[in] cursors Replay cursors.
+ * @param[in,out] heap Min-heap of cursor indices.
+ * @param[in] heap_count Count of @p heap items.
+ * @param[in] idx Index of the heap item to move down.
+ */
+static void
+sr_replay_heap_down(const struct sr_replay_cursor_s *cursors, uint32_t *heap, uint32_t heap_count, uint32_t idx)
+{
+    uint32_t child, tmp;
+
+    while ((child = 2 * idx + 1) < heap_count) {
+        if ((child + 1 < heap_count) && (sr_replay_cursor_cmp(cursors, heap[child + 1], heap[child]) < 0)) {
+            ++child;
+        }
+        if (sr_replay_cursor_cmp(cursors, heap[idx], heap[child]) < 0) {
+            break;
+        }
+
+        tmp = heap[idx];
+        heap[idx] = heap[child];
+        heap[child] = tmp;
+        idx = child;
+    }
+}
+
+/**
+ * @brief Open a replay cursor, load its first notification.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] cursor Replay cursor with the module and the time interval set.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_replay_cursor_open(sr_conn_ctx_t *conn, struct sr_replay_cursor_s *cursor)
+{
+    sr_error_info_t *err_info = NULL;
+
+    /* replay only the most recent notifications from the replay ring, if possible */
+    if (!sr_replay_ring_load(conn, cursor->shm_mod, cursor->ly_mod, &cursor->start_time, &cursor->stop_ts,
+            &cursor->ring_notifs, &cursor->ring_notif_count)) {
+        /* replay all notifications using the plugin */
+        if ((err_info = sr_ntf_plugin_find(conn->mod_shm.addr + cursor->shm_mod->plugins[SR_MOD_DS_NOTIF], conn,
+                &cursor->ntf_plg))) {
+            return err_info;
+        }
+    }
+
+    return sr_replay_cursor_next(cursor);
+}
+
+sr_error_info_t *
+sr_replay_notify(sr_conn_ctx_t *conn, const struct sr_replay_sub_s *subs, uint32_t sub_count)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_mod_t *shm_mod;
+    struct sr_replay_cursor_s *cursors = NULL, *cursor;
+    struct timespec *stop_tss = NULL;
+    sr_session_ctx_t *ev_sess = NULL;
+    uint32_t i, j, cursor_count = 0, heap_count = 0, *sub_cursors = NULL, *heap = NULL;
+    void *mem;
+
+    if (!sub_count) {
+        return NULL;
+    }
+
+    stop_tss = malloc(sub_count * sizeof *stop_tss);
+    sub_cursors = malloc(sub_count * sizeof *sub_cursors);
+    if (!stop_tss || !sub_cursors) {
+        SR_ERRINFO_MEM(&err_info);
         goto cleanup;
     }
 
+    for (i = 0; i < sub_count; ++i) {
+        /* get the stop timestamp - only notifications with smaller timestamp can be replayed */
+        if (!SR_TS_IS_ZERO(*subs[i].stop_time) && (sr_time_cmp(subs[i].stop_time, subs[i].listen_since) < 1)) {
+            stop_tss[i] = *subs[i].stop_time;
+        } else {
+            stop_tss[i] = *subs[i].listen_since;
+        }
+        sub_cursors[i] = UINT32_MAX;
+
+        /* find a cursor of the module */
+        for (j = 0; j < cursor_count; ++j) {
+            if (!strcmp(cursors[j].ly_mod->name, subs[i].mod_name)) {
+                break;
+            }
+        }
+        if (j < cursor_count) {
+            /* extend its interval */
+            cursor = &cursors[j];
+            if (sr_time_cmp(subs[i].start_time, &cursor->start_time) < 0) {
+                cursor->start_time = *subs[i].start_time;
+            }
+            if (sr_time_cmp(&stop_tss[i], &cursor->stop_ts) > 0) {
+                cursor->stop_ts = stop_tss[i];
+            }
+            sub_cursors[i] = j;
+            continue;
+        }
+
+        /* find SHM mod for replay lock and check if replay is even supported */
+        shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), subs[i].mod_name);
+        SR_CHECK_INT_GOTO(!shm_mod, err_info, cleanup);
+
+        if (!shm_mod->replay_supp) {
+            SR_LOG_WRN("Module \"%s\" does not support notification replay.", subs[i].mod_name);
+            continue;
+        }
+
+        /* new cursor */
+        mem = realloc(cursors, (cursor_count + 1) * sizeof *cursors);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+        cursors = mem;
+        cursor = &cursors[cursor_count];
+        memset(cursor, 0, sizeof *cursor);
+
+        cursor->shm_mod = shm_mod;
+        cursor->ly_mod = ly_ctx_get_module_implemented(conn->ly_ctx, subs[i].mod_name);
+        assert(cursor->ly_mod);
+        cursor->start_time = *subs[i].start_time;
+        cursor->stop_ts = stop_tss[i];
+        sub_cursors[i] = cursor_count;
+        ++cursor_count;
+    }
+
     /* create event session */
     if ((err_info = _sr_session_start(conn, SR_DS_OPERATIONAL, SR_SUB_EV_NOTIF, NULL, &ev_sess))) {
         goto cleanup;
     }
 
-    /* replay all notifications */
-    while (!(rc = ntf_plg->replay_next_cb(ly_mod, start_time, &stop_ts, &notif, &notif_ts, &state))) {
-        /* make sure the XPath filter matches something */
-        if (xpath) {
-            ly_set_free(set, NULL);
-            SR_CHECK_INT_GOTO(lyd_find_xpath(notif, xpath, &set), err_info, cleanup);
+    if (cursor_count) {
+        heap = malloc(cursor_count * sizeof *heap);
+        SR_CHECK_MEM_GOTO(!heap, err_info, cleanup);
+    }
+
+    /* open all the cursors and build a min-heap of the ones with a notification */
+    for (i = 0; i < cursor_count; ++i) {
+        if ((err_info = sr_replay_cursor_open(conn, &cursors[i]))) {
+            goto cleanup;
+        }
+        if (cursors[i].notif) {
+            heap[heap_count++] = i;
         }
+    }
+    for (i = heap_count / 2; i > 0; --i) {
+        sr_replay_heap_down(cursors, heap, heap_count, i - 1);
+    }
 
-        if (!xpath || set->count) {
-            /* find notification node */
-            notif_op = notif;
-            if ((err_info = sr_ly_find_last_parent(&notif_op, LYS_NOTIF))) {
-                goto cleanup;
+    /* replay the notifications of all the modules merged in a single pass */
+    while (heap_count) {
+        cursor = &cursors[heap[0]];
+
+        for (i = 0; i < sub_count; ++i) {
+            if ((sub_cursors[i] != heap[0]) || (sr_time_cmp(&cursor->notif_ts, subs[i].start_time) < 0) ||
+                    (sr_time_cmp(&cursor->notif_ts, &stop_tss[i]) > -1)) {
+                /* notification not of this subscription */
+                continue;
             }
-            SR_CHECK_INT_GOTO(notif_op->schema->nodetype != LYS_NOTIF, err_info, cleanup);
 
-            /* call callback */
-            if ((err_info = sr_notif_call_callback(ev_sess, cb, tree_cb, private_data, SR_EV_NOTIF_REPLAY, sub_id,
-                    notif_op, &notif_ts))) {
+            if ((err_info = sr_replay_notify_notif(ev_sess, subs[i].sub_id, subs[i].xpath, cursor->notif,
+                    &cursor->notif_ts, subs[i].cb, subs[i].tree_cb, subs[i].private_data))) {
                 goto cleanup;
             }
         }
 
         /* next */
-        lyd_free_siblings(notif);
-        notif = NULL;
-    }
-    if (rc != SR_ERR_NOT_FOUND) {
-        SR_ERRINFO_DSPLUGIN(&err_info, rc, "replay_next", ntf_plg->name, mod_name);
-        goto cleanup;
+        if ((err_info = sr_replay_cursor_next(cursor))) {
+            goto cleanup;
+        }
+        if (!cursor->notif) {
+            /* no more notifications of this module */
+            heap[0] = heap[--heap_count];
+        }
+        sr_replay_heap_down(cursors, heap, heap_count, 0);
     }
 
-replay_complete:
     /* replay is completed */
-    if ((err_info = sr_notif_call_callback(ev_sess, cb, tree_cb, private_data, SR_EV_NOTIF_REPLAY_COMPLETE, sub_id,
-            NULL, &stop_ts))) {
-        goto cleanup;
+    for (i = 0; i < sub_count; ++i) {
+        if ((err_info = sr_notif_call_callback(ev_sess, subs[i].cb, subs[i].tree_cb, subs[i].private_data,
+                SR_EV_NOTIF_REPLAY_COMPLETE, subs[i].sub_id, NULL, &stop_tss[i]))) {
+            goto cleanup;
+        }
     }
 
 cleanup:
     sr_session_stop(ev_sess);
-    lyd_free_all(notif);
-    ly_set_free(set, NULL);
+    for (i = 0; i < cursor_count; ++i) {
+        if (cursors[i].ntf_plg) {
+            lyd_free_siblings(cursors[i].notif);
+        }
+        for (j = 0; j < cursors[i].ring_notif_count; ++j) {
+            lyd_free_siblings(cursors[i].ring_notifs[j].notif);
+        }
+        free(cursors[i].ring_notifs);
+    }
+    free(cursors);
+    free(heap);
+    free(stop_tss);
+    free(sub_cursors);
     return err_info;
 }
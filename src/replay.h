@@ -33,6 +33,20 @@
  */
 sr_error_info_t *sr_replay_store(sr_session_ctx_t *sess, const struct lyd_node *notif, struct timespec notif_ts);
 
+/**
+ * @brief Remove the replay ring SHM of a module.
+ *
+ * @param[in] mod_name Module name.
+ */
+void sr_replay_ring_remove(const char *mod_name);
+
+/**
+ * @brief Unmap all the replay rings cached in a connection.
+ *
+ * @param[in] conn Connection to use.
+ */
+void sr_replay_ring_cache_flush(sr_conn_ctx_t *conn);
+
 /**
  * @brief Notification buffer thread.
  *
@@ -42,23 +56,34 @@ sr_error_info_t *sr_replay_store(sr_session_ctx_t *sess, const struct lyd_node *
 void *sr_notif_buf_thread(void *arg);
 
 /**
- * @brief Replay valid notifications.
+ * @brief Notification subscription to replay.
+ */
+struct sr_replay_sub_s {
+    const char *mod_name;               /**< Module name. */
+    uint32_t sub_id;                    /**< Subscription ID. */
+    const char *xpath;                  /**< Optional selected notifications. */
+    const struct timespec *start_time;  /**< Earliest notification of interest. */
+    const struct timespec *stop_time;   /**< Latest notification of interest. */
+    const struct timespec *listen_since;    /**< Timestamp of the subscription listening for notifications. There
+                                             must be no notification replayed with a later timestamp because it will
+                                             be received as a realtime notification. */
+    sr_event_notif_cb cb;               /**< Notification callback to call. */
+    sr_event_notif_tree_cb tree_cb;     /**< Notification tree callback to call. */
+    void *private_data;                 /**< Notification callback private data. */
+};
+
+/**
+ * @brief Replay valid notifications of several subscriptions at once.
+ *
+ * Notifications of every module are read only once, even if there are more subscriptions of the module, and
+ * the notifications of all the modules are replayed merged in the order of their timestamps. Only a single
+ * notification of every module is kept in memory, unless read from the replay ring.
  *
  * @param[in] conn Connection to use.
- * @param[in] mod_name Module name.
- * @param[in] sub_id Subscription ID.
- * @param[in] xpath Optional selected notifications.
- * @param[in] start_time Earliest notification of interest.
- * @param[in] stop_time Latest notification of interest.
- * @param[in] listen_since Timestamp of the subscription listening for notifications. There must be no notification
- * replayed with a later timestamp because it will be received as a realtime notification.
- * @param[in] callback Notification callback to call.
- * @param[in] tree_callback Notification tree callback to call.
- * @param[in] private_data Notification callback private data.
+ * @param[in] subs Subscriptions to replay.
+ * @param[in] sub_count Count of @p subs.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_replay_notify(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id, const char *xpath,
-        const struct timespec *start_time, const struct timespec *stop_time, struct timespec *listen_since,
-        sr_event_notif_cb callback, sr_event_notif_tree_cb tree_callback, void *private_data);
+sr_error_info_t *sr_replay_notify(sr_conn_ctx_t *conn, const struct sr_replay_sub_s *subs, uint32_t sub_count);
 
 #endif
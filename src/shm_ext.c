@@ -19,6 +19,7 @@
 #include "shm_ext.h"
 
 #include <assert.h>
+#include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <inttypes.h>
@@ -130,17 +131,20 @@ void
 sr_shmext_conn_remap_unlock(sr_conn_ctx_t *conn, sr_lock_mode_t mode, int ext_lock, const char *func)
 {
     sr_error_info_t *err_info = NULL;
-    sr_ext_hole_t *iter, *last = NULL;
+    sr_ext_hole_t *last;
     uint32_t last_size;
     size_t shm_file_size;
 
     /* make ext SHM smaller if there is a memory hole at its end */
     if (((mode == SR_LOCK_WRITE) || (mode == SR_LOCK_WRITE_URGE)) && ext_lock) {
-        while ((iter = sr_ext_hole_next(last, SR_CONN_EXT_SHM(conn)))) {
-            last = iter;
+        for (last = sr_ext_hole_next(NULL, SR_CONN_EXT_SHM(conn)); last;
+                last = sr_ext_hole_next(last, SR_CONN_EXT_SHM(conn))) {
+            if (((char *)last - conn->ext_shm.addr) + last->size == (signed)conn->ext_shm.size) {
+                break;
+            }
         }
 
-        if (last && (((char *)last - conn->ext_shm.addr) + last->size == (signed)conn->ext_shm.size)) {
+        if (last) {
             if ((err_info = sr_file_get_size(conn->ext_shm.fd, &shm_file_size))) {
                 goto cleanup_unlock;
             }
@@ -191,7 +195,7 @@ sr_shmext_open(sr_shm_t *shm, int zero)
         goto error;
     }
     if (zero) {
-        ((sr_ext_shm_t *)shm->addr)->first_hole_off = 0;
+        memset(shm->addr, 0, sizeof(sr_ext_shm_t));
     }
 
     return NULL;
@@ -201,6 +205,356 @@ error:
     return err_info;
 }
 
+void
+sr_shmext_stats(sr_shm_t *shm_ext, sr_ext_shm_stats_t *stats)
+{
+    sr_ext_shm_t *ext_shm = (sr_ext_shm_t *)shm_ext->addr;
+    sr_ext_hole_t *hole;
+
+    memset(stats, 0, sizeof *stats);
+    stats->size = shm_ext->size;
+
+    for (hole = sr_ext_hole_next(NULL, ext_shm); hole; hole = sr_ext_hole_next(hole, ext_shm)) {
+        ++stats->hole_count;
+        stats->hole_size += hole->size;
+        if (hole->size > stats->largest_hole) {
+            stats->largest_hole = hole->size;
+        }
+    }
+}
+
+/**
+ * @brief Subscription SHM files mapped by a connection, for collecting SHM statistics.
+ */
+struct shm_stats_conn_paths {
+    char **paths;
+    uint32_t count;
+};
+
+/**
+ * @brief Add a subscription into SHM statistics.
+ *
+ * @param[in,out] stats SHM statistics.
+ * @param[in,out] conn_paths Mapped sub SHM files of the statistics connections.
+ * @param[in,out] mod_stats Module statistics of the subscription.
+ * @param[in] cid Subscription CID, 0 if the memory is not owned by a single connection.
+ * @param[in] ext_size Size of ext SHM memory used by the subscription.
+ * @param[in] suffix1 First suffix of the sub SHM, NULL if there is none.
+ * @param[in] suffix2 Second suffix of the sub SHM, none if equals -1.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmext_shm_stats_sub_add(sr_shm_stats_t *stats, struct shm_stats_conn_paths **conn_paths,
+        sr_mod_shm_stats_t *mod_stats, sr_cid_t cid, uint64_t ext_size, const char *suffix1, int64_t suffix2)
+{
+    sr_error_info_t *err_info = NULL;
+    struct shm_stats_conn_paths *paths;
+    char *path = NULL;
+    uint32_t i;
+    void *mem;
+
+    mod_stats->ext_size += ext_size;
+    if (!cid) {
+        return NULL;
+    }
+    ++mod_stats->sub_count;
+
+    /* find the connection */
+    for (i = 0; i < stats->conn_count; ++i) {
+        if (stats->conns[i].cid == cid) {
+            break;
+        }
+    }
+    if (i == stats->conn_count) {
+        /* new connection */
+        mem = realloc(stats->conns, (i + 1) * sizeof *stats->conns);
+        SR_CHECK_MEM_RET(!mem, err_info);
+        stats->conns = mem;
+        mem = realloc(*conn_paths, (i + 1) * sizeof **conn_paths);
+        SR_CHECK_MEM_RET(!mem, err_info);
+        *conn_paths = mem;
+
+        memset(&stats->conns[i], 0, sizeof stats->conns[i]);
+        stats->conns[i].cid = cid;
+        memset(&(*conn_paths)[i], 0, sizeof (*conn_paths)[i]);
+        ++stats->conn_count;
+    }
+    ++stats->conns[i].sub_count;
+
+    if (!suffix1) {
+        return NULL;
+    }
+
+    /* remember the mapped sub SHM, once */
+    if ((err_info = sr_path_sub_shm(mod_stats->name, suffix1, suffix2, &path))) {
+        return err_info;
+    }
+    paths = &(*conn_paths)[i];
+    for (i = 0; i < paths->count; ++i) {
+        if (!strcmp(paths->paths[i], path)) {
+            free(path);
+            return NULL;
+        }
+    }
+    mem = realloc(paths->paths, (paths->count + 1) * sizeof *paths->paths);
+    if (!mem) {
+        free(path);
+        SR_ERRINFO_MEM(&err_info);
+        return err_info;
+    }
+    paths->paths = mem;
+    paths->paths[paths->count] = path;
+    ++paths->count;
+
+    return NULL;
+}
+
+/**
+ * @brief Collect the sizes of all the sub SHM and sub data SHM files.
+ *
+ * @param[in,out] stats SHM statistics.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmext_shm_stats_files(sr_shm_stats_t *stats)
+{
+    sr_error_info_t *err_info = NULL;
+    DIR *dir = NULL;
+    struct dirent *ent;
+    struct stat st;
+    const char *prefix, *name;
+    char *path;
+    size_t prefix_len, name_len;
+    uint32_t i;
+    int data;
+
+    if ((err_info = sr_shm_prefix(&prefix))) {
+        return err_info;
+    }
+    prefix_len = strlen(prefix);
+
+    dir = opendir(SR_SHM_DIR);
+    if (!dir) {
+        SR_ERRINFO_SYSERRNO(&err_info, "opendir");
+        return err_info;
+    }
+
+    while ((ent = readdir(dir))) {
+        if (strncmp(ent->d_name, prefix, prefix_len)) {
+            continue;
+        }
+
+        /* "sub_data_<mod>.<suffix>" or "sub_<mod>.<suffix>" */
+        name = ent->d_name + prefix_len;
+        if (!strncmp(name, "sub_data_", 9)) {
+            data = 1;
+            name += 9;
+        } else if (!strncmp(name, "sub_", 4)) {
+            data = 0;
+            name += 4;
+        } else {
+            continue;
+        }
+        name_len = strcspn(name, ".");
+
+        if (asprintf(&path, "%s/%s", SR_SHM_DIR, ent->d_name) == -1) {
+            SR_ERRINFO_MEM(&err_info);
+            goto cleanup;
+        }
+        if (stat(path, &st) == -1) {
+            /* removed meanwhile */
+            free(path);
+            continue;
+        }
+        free(path);
+
+        /* add to the totals */
+        if (data) {
+            ++stats->sub_data_shm_count;
+            stats->sub_data_shm_size += st.st_size;
+        } else {
+            ++stats->sub_shm_count;
+            stats->sub_shm_size += st.st_size;
+        }
+
+        /* add to the module */
+        for (i = 0; i < stats->mod_count; ++i) {
+            if (!strncmp(stats->mods[i].name, name, name_len) && !stats->mods[i].name[name_len]) {
+                if (data) {
+                    ++stats->mods[i].sub_data_shm_count;
+                    stats->mods[i].sub_data_shm_size += st.st_size;
+                } else {
+                    ++stats->mods[i].sub_shm_count;
+                    stats->mods[i].sub_shm_size += st.st_size;
+                }
+                break;
+            }
+        }
+    }
+
+cleanup:
+    closedir(dir);
+    return err_info;
+}
+
+/**
+ * @brief Get the size of serialized XPath text atoms of an operational get subscription.
+ *
+ * @param[in] ext_addr Ext SHM address.
+ * @param[in] shm_sub Operational get subscription.
+ * @return Aligned size of the atoms, 0 if there are none.
+ */
+static size_t
+sr_shmext_oper_get_sub_atoms_size(char *ext_addr, const sr_mod_oper_get_sub_t *shm_sub)
+{
+    if (!shm_sub->atoms) {
+        return 0;
+    }
+
+    return SR_SHM_SIZE(sr_xpath_sub_atoms_len(ext_addr + shm_sub->atoms));
+}
+
+sr_error_info_t *
+sr_shmext_shm_stats(sr_conn_ctx_t *conn, sr_shm_stats_t *stats)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_mod_shm_t *mod_shm = SR_CONN_MOD_SHM(conn);
+    char *ext_addr = conn->ext_shm.addr;
+    struct shm_stats_conn_paths *conn_paths = NULL;
+    sr_mod_shm_stats_t *mod_stats;
+    sr_mod_t *shm_mod;
+    sr_mod_change_sub_t *change_subs;
+    sr_mod_oper_get_sub_t *oper_get_subs;
+    sr_mod_oper_get_xpath_sub_t *xpath_subs;
+    sr_mod_oper_poll_sub_t *oper_poll_subs;
+    sr_mod_notif_sub_t *notif_subs;
+    sr_rpc_t *shm_rpc;
+    sr_mod_rpc_sub_t *rpc_subs;
+    sr_datastore_t ds;
+    struct stat st;
+    uint32_t i, j, k;
+
+    memset(stats, 0, sizeof *stats);
+    stats->main_size = conn->main_shm.size;
+    stats->mod_size = conn->mod_shm.size;
+    sr_shmext_stats(&conn->ext_shm, &stats->ext);
+
+    /* this connection first, even without subscriptions */
+    stats->conns = calloc(1, sizeof *stats->conns);
+    conn_paths = calloc(1, sizeof *conn_paths);
+    SR_CHECK_MEM_GOTO(!stats->conns || !conn_paths, err_info, cleanup);
+    stats->conns[0].cid = conn->cid;
+    stats->conn_count = 1;
+
+    stats->mods = calloc(mod_shm->mod_count, sizeof *stats->mods);
+    SR_CHECK_MEM_GOTO(mod_shm->mod_count && !stats->mods, err_info, cleanup);
+    for (i = 0; i < mod_shm->mod_count; ++i) {
+        shm_mod = SR_SHM_MOD_IDX(mod_shm, i);
+        mod_stats = &stats->mods[i];
+        mod_stats->name = strdup(((char *)mod_shm) + shm_mod->name);
+        SR_CHECK_MEM_GOTO(!mod_stats->name, err_info, cleanup);
+        ++stats->mod_count;
+
+        /* change subscriptions */
+        for (ds = 0; ds < SR_DS_COUNT; ++ds) {
+            change_subs = (sr_mod_change_sub_t *)(ext_addr + shm_mod->change_sub[ds].subs);
+            for (j = 0; j < shm_mod->change_sub[ds].sub_count; ++j) {
+                if ((err_info = sr_shmext_shm_stats_sub_add(stats, &conn_paths, mod_stats, change_subs[j].cid,
+                        sizeof *change_subs + (change_subs[j].xpath ? sr_strshmlen(ext_addr + change_subs[j].xpath) : 0),
+                        sr_ds2str(ds), -1))) {
+                    goto cleanup;
+                }
+            }
+        }
+
+        /* operational get subscriptions */
+        oper_get_subs = (sr_mod_oper_get_sub_t *)(ext_addr + shm_mod->oper_get_subs);
+        for (j = 0; j < shm_mod->oper_get_sub_count; ++j) {
+            if ((err_info = sr_shmext_shm_stats_sub_add(stats, &conn_paths, mod_stats, 0,
+                    sizeof *oper_get_subs + sr_strshmlen(ext_addr + oper_get_subs[j].xpath) +
+                    sr_shmext_oper_get_sub_atoms_size(ext_addr, &oper_get_subs[j]), NULL, -1))) {
+                goto cleanup;
+            }
+
+            xpath_subs = (sr_mod_oper_get_xpath_sub_t *)(ext_addr + oper_get_subs[j].xpath_subs);
+            for (k = 0; k < oper_get_subs[j].xpath_sub_count; ++k) {
+                if ((err_info = sr_shmext_shm_stats_sub_add(stats, &conn_paths, mod_stats, xpath_subs[k].cid,
+                        sizeof *xpath_subs, "oper", sr_str_hash(ext_addr + oper_get_subs[j].xpath, xpath_subs[k].priority)))) {
+                    goto cleanup;
+                }
+            }
+        }
+
+        /* operational poll subscriptions, no sub SHM */
+        oper_poll_subs = (sr_mod_oper_poll_sub_t *)(ext_addr + shm_mod->oper_poll_subs);
+        for (j = 0; j < shm_mod->oper_poll_sub_count; ++j) {
+            if ((err_info = sr_shmext_shm_stats_sub_add(stats, &conn_paths, mod_stats, oper_poll_subs[j].cid,
+                    sizeof *oper_poll_subs + sr_strshmlen(ext_addr + oper_poll_subs[j].xpath), NULL, -1))) {
+                goto cleanup;
+            }
+        }
+
+        /* notification subscriptions */
+        notif_subs = (sr_mod_notif_sub_t *)(ext_addr + shm_mod->notif_subs);
+        for (j = 0; j < shm_mod->notif_sub_count; ++j) {
+            if ((err_info = sr_shmext_shm_stats_sub_add(stats, &conn_paths, mod_stats, notif_subs[j].cid,
+                    sizeof *notif_subs + (notif_subs[j].xpath ? sr_strshmlen(ext_addr + notif_subs[j].xpath) : 0),
+                    "notif", -1))) {
+                goto cleanup;
+            }
+        }
+
+        /* RPC/action subscriptions */
+        shm_rpc = (sr_rpc_t *)(((char *)mod_shm) + shm_mod->rpcs);
+        for (j = 0; j < shm_mod->rpc_count; ++j) {
+            rpc_subs = (sr_mod_rpc_sub_t *)(ext_addr + shm_rpc[j].subs);
+            for (k = 0; k < shm_rpc[j].sub_count; ++k) {
+                if ((err_info = sr_shmext_shm_stats_sub_add(stats, &conn_paths, mod_stats, rpc_subs[k].cid,
+                        sizeof *rpc_subs + sr_strshmlen(ext_addr + rpc_subs[k].xpath), "rpc",
+                        sr_str_hash(((char *)mod_shm) + shm_rpc[j].path, 0)))) {
+                    goto cleanup;
+                }
+            }
+        }
+
+        /* extension RPC/action subscriptions */
+        rpc_subs = (sr_mod_rpc_sub_t *)(ext_addr + shm_mod->rpc_ext_subs);
+        for (j = 0; j < shm_mod->rpc_ext_sub_count; ++j) {
+            if ((err_info = sr_shmext_shm_stats_sub_add(stats, &conn_paths, mod_stats, rpc_subs[j].cid,
+                    sizeof *rpc_subs + sr_strshmlen(ext_addr + rpc_subs[j].xpath), NULL, -1))) {
+                goto cleanup;
+            }
+        }
+    }
+
+    /* sub SHM files */
+    if ((err_info = sr_shmext_shm_stats_files(stats))) {
+        goto cleanup;
+    }
+
+    /* mapped memory of the connections, all map the whole main, mod, and ext SHM */
+    for (i = 0; i < stats->conn_count; ++i) {
+        stats->conns[i].mapped_size = stats->main_size + stats->mod_size + stats->ext.size;
+        for (j = 0; j < conn_paths[i].count; ++j) {
+            if (!stat(conn_paths[i].paths[j], &st)) {
+                stats->conns[i].mapped_size += st.st_size;
+            }
+        }
+    }
+
+cleanup:
+    for (i = 0; i < stats->conn_count; ++i) {
+        for (j = 0; conn_paths && (j < conn_paths[i].count); ++j) {
+            free(conn_paths[i].paths[j]);
+        }
+        if (conn_paths) {
+            free(conn_paths[i].paths);
+        }
+    }
+    free(conn_paths);
+    return err_info;
+}
+
 /**
  * @brief Item holding information about a SHM object for debug printing.
  */
@@ -289,6 +643,7 @@ sr_shmext_print(sr_mod_shm_t *mod_shm, sr_shm_t *shm_ext)
     char *msg;
     sr_ext_hole_t *hole;
     sr_ext_shm_t *ext_shm = (sr_ext_shm_t *)shm_ext->addr;
+    sr_ext_shm_stats_t stats;
 
     if ((sr_stderr_ll < SR_LL_DBG) && (sr_syslog_ll < SR_LL_DBG) && !sr_lcb) {
         /* nothing to print */
@@ -353,6 +708,15 @@ sr_shmext_print(sr_mod_shm_t *mod_shm, sr_shm_t *shm_ext)
                     goto error;
                 }
 
+                if (oper_get_subs[i].atoms) {
+                    /* add xpath atoms */
+                    if (sr_shmext_print_add_item(&items, &item_count, oper_get_subs[i].atoms,
+                            sr_shmext_oper_get_sub_atoms_size(shm_ext->addr, &oper_get_subs[i]),
+                            "oper get sub xpath atoms (\"%s\")", shm_ext->addr + oper_get_subs[i].xpath)) {
+                        goto error;
+                    }
+                }
+
                 if (oper_get_subs[i].xpath_sub_count) {
                     /* add oper get XPath subscriptions */
                     if (sr_shmext_print_add_item(&items, &item_count, oper_get_subs[i].xpath_subs,
@@ -457,6 +821,12 @@ sr_shmext_print(sr_mod_shm_t *mod_shm, sr_shm_t *shm_ext)
                 (intmax_t)items[i].start, (intmax_t)(items[i].start + items[i].size), items[i].size, items[i].name);
     }
 
+    /* print fragmentation summary */
+    sr_shmext_stats(shm_ext, &stats);
+    printed += sr_sprintf(&msg, &msg_len, printed, "memory holes: %" PRIu32 ", total %" PRIu64 ", largest %" PRIu64
+            ", fragmentation %" PRIu64 "%%\n", stats.hole_count, stats.hole_size, stats.largest_hole,
+            stats.hole_size ? 100 - (stats.largest_hole * 100) / stats.hole_size : 0);
+
     /* print all the information about SHM */
     SR_LOG_DBG("#SHM:\n%s", msg);
     free(msg);
@@ -497,23 +867,30 @@ error:
     free(items);
 }
 
-sr_error_info_t *
-sr_shmext_change_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_lock_mode_t has_lock, sr_datastore_t ds,
-        uint32_t sub_id, const char *xpath, uint32_t priority, int sub_opts, uint32_t evpipe_num)
+/**
+ * @brief Add main SHM module change subscription, EXT WRITE lock is expected to be held. Ext SHM may be remapped!
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] shm_mod SHM module.
+ * @param[in] ds Datastore.
+ * @param[in] sub_id Unique sub ID.
+ * @param[in] xpath Subscription XPath.
+ * @param[in] priority Subscription priority.
+ * @param[in] sub_opts Subscription options.
+ * @param[in] evpipe_num Subscription event pipe number.
+ * @param[out] create_shm Set if it is the first subscription and sub SHM needs to be created.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmext_change_sub_add_(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_datastore_t ds, uint32_t sub_id, const char *xpath,
+        uint32_t priority, int sub_opts, uint32_t evpipe_num, int *create_shm)
 {
-    sr_error_info_t *err_info = NULL, *tmp_err;
+    sr_error_info_t *err_info = NULL;
     off_t xpath_off;
     sr_mod_change_sub_t *shm_sub;
     uint32_t i;
 
-    /* kept for possible future use */
-    assert(has_lock == SR_LOCK_WRITE);
-    (void)has_lock;
-
-    /* EXT WRITE LOCK */
-    if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_WRITE, 1, __func__))) {
-        goto cleanup;
-    }
+    *create_shm = 0;
 
     if (sub_opts & SR_SUBSCR_UPDATE) {
         /* check that there is not already an update subscription with the same priority */
@@ -523,7 +900,7 @@ sr_shmext_change_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_lock_mode_t
                 if (!sr_conn_is_alive(shm_sub[i].cid)) {
                     /* subscription is dead, recover it */
                     if ((err_info = sr_shmext_change_sub_stop(conn, shm_mod, ds, i, 1, SR_LOCK_WRITE, 1))) {
-                        goto cleanup_ext_unlock;
+                        return err_info;
                     }
 
                     /* there could not be more of such subscriptions, we have the right index for insertion */
@@ -533,7 +910,7 @@ sr_shmext_change_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_lock_mode_t
                 sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG,
                         "There already is an \"update\" subscription on module \"%s\" with priority %" PRIu32 " for %s DS.",
                         conn->mod_shm.addr + shm_mod->name, priority, sr_ds2str(ds));
-                goto cleanup_ext_unlock;
+                return err_info;
             }
         }
     }
@@ -544,7 +921,7 @@ sr_shmext_change_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_lock_mode_t
     /* allocate new subscription and its xpath, if any */
     if ((err_info = sr_shmrealloc_add(&conn->ext_shm, &shm_mod->change_sub[ds].subs, &shm_mod->change_sub[ds].sub_count,
             0, sizeof *shm_sub, -1, (void **)&shm_sub, xpath ? sr_strshmlen(xpath) : 0, &xpath_off))) {
-        goto cleanup_ext_unlock;
+        return err_info;
     }
 
     /* fill new subscription */
@@ -559,32 +936,119 @@ sr_shmext_change_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_lock_mode_t
     shm_sub->sub_id = sub_id;
     shm_sub->evpipe_num = evpipe_num;
     ATOMIC_STORE_RELAXED(shm_sub->suspended, 0);
+    ATOMIC_STORE_RELAXED(shm_sub->filtered_out, 0);
+    memset(&shm_sub->stats, 0, sizeof shm_sub->stats);
     shm_sub->cid = conn->cid;
+    if (ds == SR_DS_RUNNING) {
+        /* enabled operational data changed */
+        ATOMIC_INC_RELAXED(shm_mod->run_sub_ver);
+    }
 
     SR_LOG_DBG("#SHM after (adding change sub)");
     sr_shmext_print(SR_CONN_MOD_SHM(conn), &conn->ext_shm);
 
-    if (shm_mod->change_sub[ds].sub_count == 1) {
-        /* create the sub SHM while still holding the locks */
-        if ((err_info = sr_shmsub_create(conn->mod_shm.addr + shm_mod->name, sr_ds2str(ds), -1,
-                sizeof(sr_multi_sub_shm_t)))) {
-            goto cleanup_ext_unlock;
+    *create_shm = (shm_mod->change_sub[ds].sub_count == 1);
+    return NULL;
+}
+
+/**
+ * @brief Create change sub SHM and data sub SHM of a module.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] shm_mod SHM module.
+ * @param[in] ds Datastore.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmext_change_sub_shm_create(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_datastore_t ds)
+{
+    sr_error_info_t *err_info = NULL, *tmp_err;
+
+    /* create the sub SHM, holding only the CHANGE SUB lock so other modules are not blocked */
+    if ((err_info = sr_shmsub_create(conn->mod_shm.addr + shm_mod->name, sr_ds2str(ds), -1,
+            sizeof(sr_multi_sub_shm_t)))) {
+        return err_info;
+    }
+
+    /* create the data sub SHM */
+    if ((err_info = sr_shmsub_data_create(conn->mod_shm.addr + shm_mod->name, sr_ds2str(ds), -1))) {
+        if ((tmp_err = sr_shmsub_unlink(conn->mod_shm.addr + shm_mod->name, sr_ds2str(ds), -1))) {
+            sr_errinfo_merge(&err_info, tmp_err);
         }
+        return err_info;
+    }
 
-        /* create the data sub SHM */
-        if ((err_info = sr_shmsub_data_create(conn->mod_shm.addr + shm_mod->name, sr_ds2str(ds), -1))) {
-            if ((tmp_err = sr_shmsub_unlink(conn->mod_shm.addr + shm_mod->name, sr_ds2str(ds), -1))) {
-                sr_errinfo_merge(&err_info, tmp_err);
-            }
-            goto cleanup_ext_unlock;
+    return NULL;
+}
+
+sr_error_info_t *
+sr_shmext_change_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_lock_mode_t has_lock, sr_datastore_t ds,
+        uint32_t sub_id, const char *xpath, uint32_t priority, int sub_opts, uint32_t evpipe_num)
+{
+    sr_error_info_t *err_info = NULL;
+    int create_shm = 0;
+
+    /* kept for possible future use */
+    assert(has_lock == SR_LOCK_WRITE);
+    (void)has_lock;
+
+    /* EXT WRITE LOCK */
+    if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_WRITE, 1, __func__))) {
+        return err_info;
+    }
+
+    err_info = sr_shmext_change_sub_add_(conn, shm_mod, ds, sub_id, xpath, priority, sub_opts, evpipe_num, &create_shm);
+
+    /* EXT WRITE UNLOCK */
+    sr_shmext_conn_remap_unlock(conn, SR_LOCK_WRITE, 1, __func__);
+
+    if (!err_info && create_shm) {
+        err_info = sr_shmext_change_sub_shm_create(conn, shm_mod, ds);
+    }
+
+    return err_info;
+}
+
+sr_error_info_t *
+sr_shmext_change_sub_add_batch(sr_conn_ctx_t *conn, sr_mod_t **shm_mods, sr_datastore_t ds, const uint32_t *sub_ids,
+        const char **xpaths, const uint32_t *priorities, const int *sub_opts, uint32_t sub_count, uint32_t evpipe_num,
+        uint32_t *added_count)
+{
+    sr_error_info_t *err_info = NULL;
+    int *create_shm = NULL;
+    uint32_t i;
+
+    *added_count = 0;
+
+    create_shm = calloc(sub_count, sizeof *create_shm);
+    SR_CHECK_MEM_RET(!create_shm, err_info);
+
+    /* EXT WRITE LOCK */
+    if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_WRITE, 1, __func__))) {
+        goto cleanup;
+    }
+
+    /* add all the subscriptions at once */
+    for (i = 0; i < sub_count; ++i) {
+        if ((err_info = sr_shmext_change_sub_add_(conn, shm_mods[i], ds, sub_ids[i], xpaths[i], priorities[i],
+                sub_opts[i], evpipe_num, &create_shm[i]))) {
+            break;
         }
+        ++(*added_count);
     }
 
-cleanup_ext_unlock:
     /* EXT WRITE UNLOCK */
     sr_shmext_conn_remap_unlock(conn, SR_LOCK_WRITE, 1, __func__);
 
+    /* create sub SHMs of the modules that had no subscriptions */
+    for (i = 0; !err_info && (i < *added_count); ++i) {
+        if (create_shm[i]) {
+            err_info = sr_shmext_change_sub_shm_create(conn, shm_mods[i], ds);
+        }
+    }
+
 cleanup:
+    free(create_shm);
     return err_info;
 }
 
@@ -632,6 +1096,9 @@ sr_shmext_change_sub_modify(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_datastore
     } else {
         shm_sub[i].xpath = 0;
     }
+    if (ds == SR_DS_RUNNING) {
+        ATOMIC_INC_RELAXED(shm_mod->run_sub_ver);
+    }
 
     SR_LOG_DBG("#SHM after (modifying change sub)");
     sr_shmext_print(SR_CONN_MOD_SHM(conn), &conn->ext_shm);
@@ -672,6 +1139,9 @@ sr_shmext_change_sub_free(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_datastore_t
     /* free the subscription and its xpath, if any */
     sr_shmrealloc_del(&conn->ext_shm, &shm_mod->change_sub[ds].subs, &shm_mod->change_sub[ds].sub_count, sizeof *shm_sub,
             del_idx, shm_sub->xpath ? sr_strshmlen(conn->ext_shm.addr + shm_sub->xpath) : 0, shm_sub->xpath);
+    if (ds == SR_DS_RUNNING) {
+        ATOMIC_INC_RELAXED(shm_mod->run_sub_ver);
+    }
 
     SR_LOG_DBG("#SHM after (removing change sub)");
     sr_shmext_print(SR_CONN_MOD_SHM(conn), &conn->ext_shm);
@@ -835,12 +1305,27 @@ sr_shmext_oper_get_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t sub_
     off_t xpath_off;
     sr_mod_oper_get_sub_t *shm_sub;
     sr_mod_oper_get_xpath_sub_t *xpath_sub;
-    size_t new_len, cur_len;
+    size_t new_len, cur_len, atoms_len = 0;
+    char *atoms = NULL, *parent_xpath = NULL;
+    int parent_inst;
     uint32_t i, j;
-    int xpath_found = 0;
+    int xpath_found = 0, create_shm = 0;
 
     assert(path && sub_type);
 
+    /* split the XPath into text atoms once so that they need not be parsed for every get request */
+    if ((err_info = sr_xpath_get_sub_atoms(path, &atoms, &atoms_len))) {
+        return err_info;
+    }
+
+    /* learn whether the parent data can be found directly, without evaluating the XPath */
+    if ((err_info = sr_xpath_trim_last_node(path, &parent_xpath))) {
+        free(atoms);
+        return err_info;
+    }
+    parent_inst = parent_xpath ? sr_xpath_is_instance(conn->ly_ctx, parent_xpath) : 0;
+    free(parent_xpath);
+
     /* OPER GET SUB WRITE LOCK */
     if ((err_info = sr_rwlock(&shm_mod->oper_get_lock, SR_SHMEXT_SUB_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__,
             NULL, NULL))) {
@@ -905,16 +1390,24 @@ sr_shmext_oper_get_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t sub_
         SR_LOG_DBG("#SHM before (adding oper get sub)");
         sr_shmext_print(SR_CONN_MOD_SHM(conn), &conn->ext_shm);
 
-        /* allocate new subscription and its xpath */
+        /* allocate new subscription and its xpath followed by its atoms */
         if ((err_info = sr_shmrealloc_add(&conn->ext_shm, &shm_mod->oper_get_subs, &shm_mod->oper_get_sub_count, 0,
-                sizeof *shm_sub, i, (void **)&shm_sub, sr_strshmlen(path), &xpath_off))) {
+                sizeof *shm_sub, i, (void **)&shm_sub, sr_strshmlen(path) + (atoms ? SR_SHM_SIZE(atoms_len) : 0),
+                &xpath_off))) {
             goto cleanup_opergetsub_ext_unlock;
         }
 
         /* fill new oper subscription */
         strcpy(conn->ext_shm.addr + xpath_off, path);
         shm_sub->xpath = xpath_off;
+        if (atoms) {
+            shm_sub->atoms = xpath_off + sr_strshmlen(path);
+            memcpy(conn->ext_shm.addr + shm_sub->atoms, atoms, atoms_len);
+        } else {
+            shm_sub->atoms = 0;
+        }
         shm_sub->sub_type = sub_type;
+        shm_sub->parent_inst = parent_inst;
         shm_sub->xpath_subs = 0;
         shm_sub->xpath_sub_count = 0;
 
@@ -937,33 +1430,39 @@ sr_shmext_oper_get_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t sub_
     xpath_sub->evpipe_num = evpipe_num;
     xpath_sub->priority = *prio;
     ATOMIC_STORE_RELAXED(xpath_sub->suspended, 0);
+    memset(&xpath_sub->stats, 0, sizeof xpath_sub->stats);
     xpath_sub->cid = conn->cid;
 
     SR_LOG_DBG("#SHM after (adding oper get xpath sub)");
     sr_shmext_print(SR_CONN_MOD_SHM(conn), &conn->ext_shm);
 
-    /* create the sub SHM while still holding the locks */
-    if ((err_info = sr_shmsub_create(conn->mod_shm.addr + shm_mod->name, "oper", sr_str_hash(path, *prio),
-            sizeof(sr_sub_shm_t)))) {
-        goto cleanup_opergetsub_ext_unlock;
-    }
-
-    /* create the data sub SHM */
-    if ((err_info = sr_shmsub_data_create(conn->mod_shm.addr + shm_mod->name, "oper", sr_str_hash(path, *prio)))) {
-        if ((tmp_err = sr_shmsub_unlink(conn->mod_shm.addr + shm_mod->name, "oper", sr_str_hash(path, *prio)))) {
-            sr_errinfo_merge(&err_info, tmp_err);
-        }
-        goto cleanup_opergetsub_ext_unlock;
-    }
+    create_shm = 1;
 
 cleanup_opergetsub_ext_unlock:
     /* EXT WRITE UNLOCK */
     sr_shmext_conn_remap_unlock(conn, SR_LOCK_WRITE, 1, __func__);
 
+    if (create_shm) {
+        /* create the sub SHM, holding only the OPER GET SUB lock so other modules are not blocked */
+        if ((err_info = sr_shmsub_create(conn->mod_shm.addr + shm_mod->name, "oper", sr_str_hash(path, *prio),
+                sizeof(sr_sub_shm_t)))) {
+            goto cleanup_opergetsub_unlock;
+        }
+
+        /* create the data sub SHM */
+        if ((err_info = sr_shmsub_data_create(conn->mod_shm.addr + shm_mod->name, "oper", sr_str_hash(path, *prio)))) {
+            if ((tmp_err = sr_shmsub_unlink(conn->mod_shm.addr + shm_mod->name, "oper", sr_str_hash(path, *prio)))) {
+                sr_errinfo_merge(&err_info, tmp_err);
+            }
+            goto cleanup_opergetsub_unlock;
+        }
+    }
+
 cleanup_opergetsub_unlock:
     /* OPER GET SUB WRITE UNLOCK */
     sr_rwunlock(&shm_mod->oper_get_lock, 0, SR_LOCK_WRITE, conn->cid, __func__);
 
+    free(atoms);
     return err_info;
 }
 
@@ -1013,7 +1512,8 @@ sr_shmext_oper_get_sub_free(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t del
 
         /* last XPath subscription deleted, free the oper subscription */
         sr_shmrealloc_del(&conn->ext_shm, &shm_mod->oper_get_subs, &shm_mod->oper_get_sub_count, sizeof *shm_sub,
-                del_idx1, sr_strshmlen(conn->ext_shm.addr + shm_sub->xpath), shm_sub->xpath);
+                del_idx1, sr_strshmlen(conn->ext_shm.addr + shm_sub->xpath) +
+                sr_shmext_oper_get_sub_atoms_size(conn->ext_shm.addr, shm_sub), shm_sub->xpath);
 
         SR_LOG_DBG("#SHM after (removing oper get sub)");
         sr_shmext_print(SR_CONN_MOD_SHM(conn), &conn->ext_shm);
@@ -1395,6 +1895,28 @@ sr_shmext_oper_poll_sub_stop(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t de
     return err_info;
 }
 
+/**
+ * @brief Learn the request ID of the last notification written into notification sub SHM of a module.
+ *
+ * @param[in] mod_name Module name.
+ * @param[out] request_id Request ID of the last notification.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmext_notif_last_request_id(const char *mod_name, uint32_t *request_id)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_shm_t shm_sub = SR_SHM_INITIALIZER;
+
+    if ((err_info = sr_shmsub_open_map(mod_name, "notif", -1, &shm_sub))) {
+        return err_info;
+    }
+    *request_id = ATOMIC_LOAD_RELAXED(((sr_multi_sub_shm_t *)shm_sub.addr)->request_id);
+    sr_shm_clear(&shm_sub);
+
+    return NULL;
+}
+
 sr_error_info_t *
 sr_shmext_notif_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t sub_id, const char *xpath, uint32_t evpipe_num,
         struct timespec *listen_since)
@@ -1402,6 +1924,8 @@ sr_shmext_notif_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t sub_id,
     sr_error_info_t *err_info = NULL, *tmp_err;
     off_t xpath_off;
     sr_mod_notif_sub_t *shm_sub;
+    uint32_t cursor = 0;
+    int create_shm = 0;
 
     /* NOTIF SUB WRITE LOCK */
     if ((err_info = sr_rwlock(&shm_mod->notif_lock, SR_SHMEXT_SUB_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__,
@@ -1417,6 +1941,13 @@ sr_shmext_notif_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t sub_id,
         goto cleanup_notifsub_unlock;
     }
 
+    if (shm_mod->notif_sub_count) {
+        /* the subscription processes only the notifications sent after it was added */
+        if ((err_info = sr_shmext_notif_last_request_id(conn->mod_shm.addr + shm_mod->name, &cursor))) {
+            goto cleanup_notifsub_ext_unlock;
+        }
+    }
+
     SR_LOG_DBG("#SHM before (adding notif sub)");
     sr_shmext_print(SR_CONN_MOD_SHM(conn), &conn->ext_shm);
 
@@ -1436,15 +1967,23 @@ sr_shmext_notif_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t sub_id,
     shm_sub->sub_id = sub_id;
     shm_sub->evpipe_num = evpipe_num;
     ATOMIC_STORE_RELAXED(shm_sub->suspended, 0);
+    ATOMIC_STORE_RELAXED(shm_sub->cursor, cursor);
+    memset(&shm_sub->stats, 0, sizeof shm_sub->stats);
     shm_sub->cid = conn->cid;
 
     SR_LOG_DBG("#SHM after (adding notif sub)");
     sr_shmext_print(SR_CONN_MOD_SHM(conn), &conn->ext_shm);
 
-    if (shm_mod->notif_sub_count == 1) {
-        /* create the sub SHM while still holding the locks */
-        if ((err_info = sr_shmsub_create(conn->mod_shm.addr + shm_mod->name, "notif", -1, sizeof(sr_sub_shm_t)))) {
-            goto cleanup_notifsub_ext_unlock;
+    create_shm = (shm_mod->notif_sub_count == 1);
+
+cleanup_notifsub_ext_unlock:
+    /* EXT WRITE UNLOCK */
+    sr_shmext_conn_remap_unlock(conn, SR_LOCK_WRITE, 1, __func__);
+
+    if (create_shm) {
+        /* create the sub SHM, holding only the NOTIF SUB lock so other modules are not blocked */
+        if ((err_info = sr_shmsub_create(conn->mod_shm.addr + shm_mod->name, "notif", -1, sizeof(sr_multi_sub_shm_t)))) {
+            goto cleanup_notifsub_unlock;
         }
 
         /* create the data sub SHM */
@@ -1452,14 +1991,10 @@ sr_shmext_notif_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, uint32_t sub_id,
             if ((tmp_err = sr_shmsub_unlink(conn->mod_shm.addr + shm_mod->name, "notif", -1))) {
                 sr_errinfo_merge(&err_info, tmp_err);
             }
-            goto cleanup_notifsub_ext_unlock;
+            goto cleanup_notifsub_unlock;
         }
     }
 
-cleanup_notifsub_ext_unlock:
-    /* EXT WRITE UNLOCK */
-    sr_shmext_conn_remap_unlock(conn, SR_LOCK_WRITE, 1, __func__);
-
 cleanup_notifsub_unlock:
     /* NOTIF SUB WRITE UNLOCK */
     sr_rwunlock(&shm_mod->notif_lock, 0, SR_LOCK_WRITE, conn->cid, __func__);
@@ -1643,7 +2178,7 @@ sr_shmext_rpc_sub_add(sr_conn_ctx_t *conn, sr_rwlock_t *sub_lock, off_t *subs, u
     sr_mod_rpc_sub_t *shm_sub;
     uint32_t i;
     char *mod_name = NULL, *p = NULL;
-    int r, path_found = 0;
+    int r, path_found = 0, create_shm = 0;
 
     assert(xpath);
 
@@ -1711,16 +2246,23 @@ sr_shmext_rpc_sub_add(sr_conn_ctx_t *conn, sr_rwlock_t *sub_lock, off_t *subs, u
     shm_sub->sub_id = sub_id;
     shm_sub->evpipe_num = evpipe_num;
     ATOMIC_STORE_RELAXED(shm_sub->suspended, 0);
+    memset(&shm_sub->stats, 0, sizeof shm_sub->stats);
     shm_sub->cid = sub_cid;
 
     SR_LOG_DBG("#SHM after (adding rpc sub)");
     sr_shmext_print(SR_CONN_MOD_SHM(conn), &conn->ext_shm);
 
-    if (!path_found && sub_cid) {
-        /* create the sub SHM while still holding the locks */
+    create_shm = (!path_found && sub_cid);
+
+cleanup_rpcsub_ext_unlock:
+    /* EXT WRITE UNLOCK */
+    sr_shmext_conn_remap_unlock(conn, SR_LOCK_WRITE, 1, __func__);
+
+    if (create_shm) {
+        /* create the sub SHM, holding only the RPC SUB lock so other RPCs are not blocked */
         mod_name = sr_get_first_ns(path);
         if ((err_info = sr_shmsub_create(mod_name, "rpc", sr_str_hash(path, 0), sizeof(sr_multi_sub_shm_t)))) {
-            goto cleanup_rpcsub_ext_unlock;
+            goto cleanup_rpcsub_unlock;
         }
 
         /* create the data sub SHM */
@@ -1728,14 +2270,10 @@ sr_shmext_rpc_sub_add(sr_conn_ctx_t *conn, sr_rwlock_t *sub_lock, off_t *subs, u
             if ((tmp_err = sr_shmsub_unlink(mod_name, "rpc", sr_str_hash(path, 0)))) {
                 sr_errinfo_merge(&err_info, tmp_err);
             }
-            goto cleanup_rpcsub_ext_unlock;
+            goto cleanup_rpcsub_unlock;
         }
     }
 
-cleanup_rpcsub_ext_unlock:
-    /* EXT WRITE UNLOCK */
-    sr_shmext_conn_remap_unlock(conn, SR_LOCK_WRITE, 1, __func__);
-
 cleanup_rpcsub_unlock:
     /* RPC SUB WRITE UNLOCK */
     sr_rwunlock(sub_lock, 0, SR_LOCK_WRITE, conn->cid, __func__);
@@ -2372,6 +2910,198 @@ cleanup_changesub_unlock:
     return err_info;
 }
 
+/**
+ * @brief Add the times of an event processed by a subscription into its statistics.
+ *
+ * @param[in] stats Subscription statistics.
+ * @param[in] event_ts Time the event was published.
+ * @param[in] cb_start Time the subscription callback was called.
+ */
+static void
+sr_shmext_sub_stats_add(sr_sub_stats_t *stats, const struct timespec *event_ts, const struct timespec *cb_start)
+{
+    struct timespec cb_end;
+
+    sr_timeouttime_get(&cb_end, 0);
+
+    if (!SR_TS_IS_ZERO(*event_ts)) {
+        sr_latency_stats_add(&stats->queue, sr_time_sub_us(cb_start, event_ts));
+    }
+    sr_latency_stats_add(&stats->callback, sr_time_sub_us(&cb_end, cb_start));
+}
+
+void
+sr_shmext_change_sub_stats(sr_conn_ctx_t *conn, const char *mod_name, sr_datastore_t ds, uint32_t sub_id,
+        const struct timespec *event_ts, const struct timespec *cb_start)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_mod_t *shm_mod;
+    sr_mod_change_sub_t *shm_subs;
+    uint32_t i;
+
+    shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), mod_name);
+    if (!shm_mod) {
+        return;
+    }
+
+    /* EXT READ LOCK */
+    if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        sr_errinfo_free(&err_info);
+        return;
+    }
+
+    /* find the subscription in ext SHM, it may have just been removed */
+    shm_subs = (sr_mod_change_sub_t *)(conn->ext_shm.addr + shm_mod->change_sub[ds].subs);
+    for (i = 0; i < shm_mod->change_sub[ds].sub_count; ++i) {
+        if (shm_subs[i].sub_id == sub_id) {
+            sr_shmext_sub_stats_add(&shm_subs[i].stats, event_ts, cb_start);
+            break;
+        }
+    }
+
+    /* EXT READ UNLOCK */
+    sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 0, __func__);
+}
+
+void
+sr_shmext_oper_get_sub_stats(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id,
+        const struct timespec *event_ts, const struct timespec *cb_start)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_mod_t *shm_mod;
+    sr_mod_oper_get_sub_t *shm_subs;
+    sr_mod_oper_get_xpath_sub_t *xpath_subs;
+    uint32_t i, j;
+
+    shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), mod_name);
+    if (!shm_mod) {
+        return;
+    }
+
+    /* EXT READ LOCK */
+    if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        sr_errinfo_free(&err_info);
+        return;
+    }
+
+    /* find the subscription in ext SHM, it may have just been removed */
+    shm_subs = (sr_mod_oper_get_sub_t *)(conn->ext_shm.addr + shm_mod->oper_get_subs);
+    for (i = 0; i < shm_mod->oper_get_sub_count; ++i) {
+        xpath_subs = (sr_mod_oper_get_xpath_sub_t *)(conn->ext_shm.addr + shm_subs[i].xpath_subs);
+        for (j = 0; j < shm_subs[i].xpath_sub_count; ++j) {
+            if (xpath_subs[j].sub_id == sub_id) {
+                sr_shmext_sub_stats_add(&xpath_subs[j].stats, event_ts, cb_start);
+                goto cleanup_ext_unlock;
+            }
+        }
+    }
+
+cleanup_ext_unlock:
+    /* EXT READ UNLOCK */
+    sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 0, __func__);
+}
+
+void
+sr_shmext_notif_sub_stats(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id, const struct timespec *event_ts,
+        const struct timespec *cb_start)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_mod_t *shm_mod;
+    sr_mod_notif_sub_t *shm_subs;
+    uint32_t i;
+
+    shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), mod_name);
+    if (!shm_mod) {
+        return;
+    }
+
+    /* EXT READ LOCK */
+    if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        sr_errinfo_free(&err_info);
+        return;
+    }
+
+    /* find the subscription in ext SHM, it may have just been removed */
+    shm_subs = (sr_mod_notif_sub_t *)(conn->ext_shm.addr + shm_mod->notif_subs);
+    for (i = 0; i < shm_mod->notif_sub_count; ++i) {
+        if (shm_subs[i].sub_id == sub_id) {
+            sr_shmext_sub_stats_add(&shm_subs[i].stats, event_ts, cb_start);
+            break;
+        }
+    }
+
+    /* EXT READ UNLOCK */
+    sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 0, __func__);
+}
+
+void
+sr_shmext_rpc_sub_stats(sr_conn_ctx_t *conn, const char *path, uint32_t sub_id, const struct timespec *event_ts,
+        const struct timespec *cb_start)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_rpc_t *shm_rpc;
+    sr_mod_rpc_sub_t *shm_subs;
+    uint32_t i;
+
+    shm_rpc = sr_shmmod_find_rpc(SR_CONN_MOD_SHM(conn), path);
+    if (!shm_rpc) {
+        return;
+    }
+
+    /* EXT READ LOCK */
+    if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        sr_errinfo_free(&err_info);
+        return;
+    }
+
+    /* find the subscription in ext SHM, it may have just been removed */
+    shm_subs = (sr_mod_rpc_sub_t *)(conn->ext_shm.addr + shm_rpc->subs);
+    for (i = 0; i < shm_rpc->sub_count; ++i) {
+        if (shm_subs[i].sub_id == sub_id) {
+            sr_shmext_sub_stats_add(&shm_subs[i].stats, event_ts, cb_start);
+            break;
+        }
+    }
+
+    /* EXT READ UNLOCK */
+    sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 0, __func__);
+}
+
+sr_error_info_t *
+sr_shmext_change_sub_filtered_out(sr_conn_ctx_t *conn, const char *mod_name, sr_datastore_t ds, uint32_t sub_id,
+        uint32_t *filtered_out)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_mod_t *shm_mod;
+    sr_mod_change_sub_t *shm_subs;
+    uint32_t i;
+
+    shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), mod_name);
+    SR_CHECK_INT_RET(!shm_mod, err_info);
+
+    /* EXT READ LOCK */
+    if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        return err_info;
+    }
+
+    /* find the subscription in ext SHM */
+    shm_subs = (sr_mod_change_sub_t *)(conn->ext_shm.addr + shm_mod->change_sub[ds].subs);
+    for (i = 0; i < shm_mod->change_sub[ds].sub_count; ++i) {
+        if (shm_subs[i].sub_id == sub_id) {
+            break;
+        }
+    }
+    SR_CHECK_INT_GOTO(i == shm_mod->change_sub[ds].sub_count, err_info, cleanup_ext_unlock);
+
+    *filtered_out = ATOMIC_LOAD_RELAXED(shm_subs[i].filtered_out);
+
+cleanup_ext_unlock:
+    /* EXT READ UNLOCK */
+    sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 0, __func__);
+
+    return err_info;
+}
+
 sr_error_info_t *
 sr_shmext_oper_get_sub_suspended(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id, int set_suspended,
         int *get_suspended)
@@ -2526,7 +3256,7 @@ sr_shmext_notif_sub_suspended(sr_conn_ctx_t *conn, const char *mod_name, uint32_
     sr_error_info_t *err_info = NULL;
     sr_mod_t *shm_mod;
     sr_mod_notif_sub_t *shm_sub;
-    uint32_t i;
+    uint32_t i, cursor;
 
     shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), mod_name);
     SR_CHECK_INT_RET(!shm_mod, err_info);
@@ -2566,6 +3296,14 @@ sr_shmext_notif_sub_suspended(sr_conn_ctx_t *conn, const char *mod_name, uint32_
             goto cleanup_notifsub_ext_unlock;
         }
 
+        if (!set_suspended) {
+            /* skip all the notifications sent while the subscription was suspended */
+            if ((err_info = sr_shmext_notif_last_request_id(mod_name, &cursor))) {
+                goto cleanup_notifsub_ext_unlock;
+            }
+            ATOMIC_STORE_RELAXED(shm_sub[i].cursor, cursor);
+        }
+
         /* set the flag */
         ATOMIC_STORE_RELAXED(shm_sub[i].suspended, set_suspended);
     }
@@ -2588,6 +3326,49 @@ cleanup_notifsub_unlock:
     return err_info;
 }
 
+sr_error_info_t *
+sr_shmext_notif_sub_cursor(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id, int64_t set_cursor,
+        uint32_t *get_cursor, int *get_suspended)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_mod_t *shm_mod;
+    sr_mod_notif_sub_t *shm_sub;
+    uint32_t i;
+
+    shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), mod_name);
+    SR_CHECK_INT_RET(!shm_mod, err_info);
+
+    /* EXT READ LOCK */
+    if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        return err_info;
+    }
+
+    /* find the subscription in ext SHM */
+    shm_sub = (sr_mod_notif_sub_t *)(conn->ext_shm.addr + shm_mod->notif_subs);
+    for (i = 0; i < shm_mod->notif_sub_count; ++i) {
+        if (shm_sub[i].sub_id == sub_id) {
+            break;
+        }
+    }
+    SR_CHECK_INT_GOTO(i == shm_mod->notif_sub_count, err_info, cleanup_ext_unlock);
+
+    if (set_cursor > -1) {
+        ATOMIC_STORE_RELAXED(shm_sub[i].cursor, (uint32_t)set_cursor);
+    }
+    if (get_cursor) {
+        *get_cursor = ATOMIC_LOAD_RELAXED(shm_sub[i].cursor);
+    }
+    if (get_suspended) {
+        *get_suspended = ATOMIC_LOAD_RELAXED(shm_sub[i].suspended);
+    }
+
+cleanup_ext_unlock:
+    /* EXT READ UNLOCK */
+    sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 0, __func__);
+
+    return err_info;
+}
+
 sr_error_info_t *
 sr_shmext_rpc_sub_suspended(sr_conn_ctx_t *conn, const char *path, uint32_t sub_id, int set_suspended, int *get_suspended)
 {
@@ -50,6 +50,24 @@ void sr_shmext_conn_remap_unlock(sr_conn_ctx_t *conn, sr_lock_mode_t mode, int e
  */
 sr_error_info_t *sr_shmext_open(sr_shm_t *shm, int zero);
 
+/**
+ * @brief Collect memory usage and fragmentation statistics of ext SHM.
+ *
+ * @param[in] shm_ext Ext SHM.
+ * @param[out] stats Ext SHM statistics.
+ */
+void sr_shmext_stats(sr_shm_t *shm_ext, sr_ext_shm_stats_t *stats);
+
+/**
+ * @brief Collect memory usage of all the SHM segments, per module and per connection.
+ * Ext SHM is expected to be READ locked.
+ *
+ * @param[in] conn Connection to use.
+ * @param[out] stats SHM statistics, must be freed on error as well.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmext_shm_stats(sr_conn_ctx_t *conn, sr_shm_stats_t *stats);
+
 /**
  * @brief Debug print the contents of ext SHM.
  *
@@ -76,6 +94,28 @@ void sr_shmext_print(sr_mod_shm_t *mod_shm, sr_shm_t *shm_ext);
 sr_error_info_t *sr_shmext_change_sub_add(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, sr_lock_mode_t has_lock,
         sr_datastore_t ds, uint32_t sub_id, const char *xpath, uint32_t priority, int sub_opts, uint32_t evpipe_num);
 
+/**
+ * @brief Add many main SHM module change subscriptions holding EXT lock only once and create sub SHMs
+ * of modules that had no subscriptions. Ext SHM may be remapped!
+ *
+ * CHANGE SUB lock of all the modules is expected to be held.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] shm_mods Array of SHM modules of the subscriptions.
+ * @param[in] ds Datastore.
+ * @param[in] sub_ids Array of unique sub IDs.
+ * @param[in] xpaths Array of subscription XPaths, may be NULL.
+ * @param[in] priorities Array of subscription priorities.
+ * @param[in] sub_opts Array of subscription options.
+ * @param[in] sub_count Count of all the subscriptions.
+ * @param[in] evpipe_num Subscription event pipe number.
+ * @param[out] added_count Number of subscriptions added, from the beginning, even on error.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmext_change_sub_add_batch(sr_conn_ctx_t *conn, sr_mod_t **shm_mods, sr_datastore_t ds,
+        const uint32_t *sub_ids, const char **xpaths, const uint32_t *priorities, const int *sub_opts, uint32_t sub_count,
+        uint32_t evpipe_num, uint32_t *added_count);
+
 /**
  * @brief Modify existing main SHM module change subscription.
  * Ext SHM may be remapped!
@@ -320,6 +360,72 @@ sr_error_info_t *sr_shmext_check_sub_all(sr_conn_ctx_t *conn, const struct ly_ct
 sr_error_info_t *sr_shmext_change_sub_suspended(sr_conn_ctx_t *conn, const char *mod_name, sr_datastore_t ds,
         uint32_t sub_id, int set_suspended, int *get_suspended);
 
+/**
+ * @brief Get the number of change events filtered out for a change subscription by the originators.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mod_name Module name.
+ * @param[in] ds Subscription datastore.
+ * @param[in] sub_id Subscription ID.
+ * @param[out] filtered_out Number of filtered-out change events.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmext_change_sub_filtered_out(sr_conn_ctx_t *conn, const char *mod_name, sr_datastore_t ds,
+        uint32_t sub_id, uint32_t *filtered_out);
+
+/**
+ * @brief Add the queueing and callback times of a processed event to change subscription statistics.
+ * Does nothing if the subscription is not found.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mod_name Module name.
+ * @param[in] ds Subscription datastore.
+ * @param[in] sub_id Subscription ID.
+ * @param[in] event_ts Time the event was published.
+ * @param[in] cb_start Time the callback was called.
+ */
+void sr_shmext_change_sub_stats(sr_conn_ctx_t *conn, const char *mod_name, sr_datastore_t ds, uint32_t sub_id,
+        const struct timespec *event_ts, const struct timespec *cb_start);
+
+/**
+ * @brief Add the queueing and callback times of a processed event to operational get subscription statistics.
+ * Does nothing if the subscription is not found.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mod_name Module name.
+ * @param[in] sub_id Subscription ID.
+ * @param[in] event_ts Time the event was published.
+ * @param[in] cb_start Time the callback was called.
+ */
+void sr_shmext_oper_get_sub_stats(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id,
+        const struct timespec *event_ts, const struct timespec *cb_start);
+
+/**
+ * @brief Add the queueing and callback times of a processed event to notification subscription statistics.
+ * Does nothing if the subscription is not found.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mod_name Module name.
+ * @param[in] sub_id Subscription ID.
+ * @param[in] event_ts Time the event was published.
+ * @param[in] cb_start Time the callback was called.
+ */
+void sr_shmext_notif_sub_stats(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id, const struct timespec *event_ts,
+        const struct timespec *cb_start);
+
+/**
+ * @brief Add the queueing and callback times of a processed event to RPC/action subscription statistics.
+ * Does nothing if the subscription is not found.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] path RPC/action path.
+ * @param[in] sub_id Subscription ID.
+ * @param[in] event_ts Time the event was published.
+ * @param[in] cb_start Time the callback was called.
+ */
+void sr_shmext_rpc_sub_stats(sr_conn_ctx_t *conn, const char *path, uint32_t sub_id, const struct timespec *event_ts,
+        const struct timespec *cb_start);
+
 /**
  * @brief Get or set operational get subscription suspended state (flag).
  *
@@ -359,6 +465,20 @@ sr_error_info_t *sr_shmext_oper_poll_sub_suspended(sr_conn_ctx_t *conn, const ch
 sr_error_info_t *sr_shmext_notif_sub_suspended(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id,
         int set_suspended, int *get_suspended);
 
+/**
+ * @brief Get or set notification subscription cursor, the request ID of the last processed notification.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mod_name Module name.
+ * @param[in] sub_id Subscription ID.
+ * @param[in] set_cursor Set cursor to this value, leave unmodified if -1.
+ * @param[out] get_cursor Optional current cursor.
+ * @param[out] get_suspended Optional current suspended state.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmext_notif_sub_cursor(sr_conn_ctx_t *conn, const char *mod_name, uint32_t sub_id,
+        int64_t set_cursor, uint32_t *get_cursor, int *get_suspended);
+
 /**
  * @brief Get or set RPC/action subscription suspended state (flag).
  *
@@ -67,6 +67,13 @@ static struct {
     } *list_head;                       /**< process connection list head */
 
     pthread_mutex_t create_lock;        /**< lock used for synchronizing new connection creation within the process */
+
+    struct sr_conn_alive_s {
+        sr_cid_t cid;                   /**< CID of a checked foreign connection, 0 if unused */
+        int alive;                      /**< whether the connection was alive */
+        pid_t pid;                      /**< PID of the connection owner, if alive */
+        struct timespec valid_ts;       /**< time (monotonic) until the check result is considered valid */
+    } alive_cache[SR_CONN_ALIVE_CACHE_SIZE];    /**< recent foreign connection checks, accessed with list_lock */
 } conn_proc = {.list_lock = PTHREAD_MUTEX_INITIALIZER, .list_head = NULL, .create_lock = PTHREAD_MUTEX_INITIALIZER};
 
 sr_error_info_t *
@@ -180,9 +187,12 @@ sr_shmmain_conn_check(sr_cid_t cid, int *conn_alive, pid_t *pid)
 {
     sr_error_info_t *err_info = NULL;
     struct flock fl = {0};
-    int fd, rc;
+    int fd, rc, alive;
     char *path = NULL;
     struct sr_conn_list_s *ptr;
+    struct sr_conn_alive_s *alive_c;
+    struct timespec cur_ts;
+    pid_t owner_pid;
 
     assert(cid && conn_alive);
 
@@ -212,6 +222,22 @@ sr_shmmain_conn_check(sr_cid_t cid, int *conn_alive, pid_t *pid)
         }
     }
 
+    /* check whether the connection was checked recently */
+    alive_c = &conn_proc.alive_cache[cid % SR_CONN_ALIVE_CACHE_SIZE];
+    if (alive_c->cid == cid) {
+        sr_timeouttime_get(&cur_ts, 0);
+        if (sr_time_cmp(&cur_ts, &alive_c->valid_ts) < 0) {
+            *conn_alive = alive_c->alive;
+            if (pid) {
+                *pid = alive_c->pid;
+            }
+
+            /* CONN LIST UNLOCK */
+            sr_munlock(&conn_proc.list_lock);
+            goto cleanup;
+        }
+    }
+
     /* CONN LIST UNLOCK */
     sr_munlock(&conn_proc.list_lock);
 
@@ -223,11 +249,9 @@ sr_shmmain_conn_check(sr_cid_t cid, int *conn_alive, pid_t *pid)
     if (fd == -1) {
         if (errno == ENOENT) {
             /* the file does not exist in which case there is no connection established */
-            *conn_alive = 0;
-            if (pid) {
-                *pid = 0;
-            }
-            goto cleanup;
+            alive = 0;
+            owner_pid = 0;
+            goto cache;
         }
         SR_ERRINFO_SYSERRPATH(&err_info, "open", path);
         goto cleanup;
@@ -249,10 +273,8 @@ sr_shmmain_conn_check(sr_cid_t cid, int *conn_alive, pid_t *pid)
     }
     if (fl.l_type == F_UNLCK) {
         /* leftover unlocked file */
-        *conn_alive = 0;
-        if (pid) {
-            *pid = 0;
-        }
+        alive = 0;
+        owner_pid = 0;
 
         /* delete the file */
         if (!unlink(path)) {
@@ -264,10 +286,27 @@ sr_shmmain_conn_check(sr_cid_t cid, int *conn_alive, pid_t *pid)
         }
     } else {
         /* we cannot get the lock, it must be held by a live connection */
-        *conn_alive = 1;
-        if (pid) {
-            *pid = fl.l_pid;
-        }
+        alive = 1;
+        owner_pid = fl.l_pid;
+    }
+
+cache:
+    *conn_alive = alive;
+    if (pid) {
+        *pid = owner_pid;
+    }
+
+    /* CONN LIST LOCK */
+    if (!sr_mlock(&conn_proc.list_lock, SR_CONN_LIST_LOCK_TIMEOUT, __func__, NULL, NULL)) {
+        /* remember the result, it would just be checked again on failure */
+        alive_c = &conn_proc.alive_cache[cid % SR_CONN_ALIVE_CACHE_SIZE];
+        alive_c->cid = cid;
+        alive_c->alive = alive;
+        alive_c->pid = owner_pid;
+        sr_timeouttime_get(&alive_c->valid_ts, SR_CONN_ALIVE_CACHE_TIMEOUT);
+
+        /* CONN LIST UNLOCK */
+        sr_munlock(&conn_proc.list_lock);
     }
 
 cleanup:
@@ -54,6 +54,8 @@ void sr_shmmain_createunlock(int shm_lock);
 /**
  * @brief Check if the connection is alive.
  *
+ * Result of checking a connection of another process is remembered for ::SR_CONN_ALIVE_CACHE_TIMEOUT.
+ *
  * @param[in] cid The connection ID to check.
  * @param[out] conn_alive Will be set to non-zero if the connection is alive, zero otherwise.
  * @param[out] pid Optional PID set if the connection is alive.
@@ -21,6 +21,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -38,6 +39,7 @@
 #include "log.h"
 #include "modinfo.h"
 #include "plugins_datastore.h"
+#include "replay.h"
 
 sr_error_info_t *
 sr_shmmod_open(sr_shm_t *shm, int zero)
@@ -75,7 +77,7 @@ sr_shmmod_open(sr_shm_t *shm, int zero)
         goto error;
     }
     if (zero) {
-        ((sr_mod_shm_t *)shm->addr)->mod_count = 0;
+        memset(shm->addr, 0, sizeof(sr_mod_shm_t));
     }
 
     return NULL;
@@ -85,17 +87,64 @@ error:
     return err_info;
 }
 
-sr_mod_t *
-sr_shmmod_find_module(sr_mod_shm_t *mod_shm, const char *name)
+/**
+ * @brief Get the hash of a module name for the mod SHM module hash index.
+ *
+ * @param[in] name Module name, does not have to be terminated.
+ * @param[in] len Length of @p name.
+ * @return Name hash.
+ */
+static uint32_t
+sr_shmmod_name_hash(const char *name, size_t len)
 {
-    sr_mod_t *shm_mod;
-    uint32_t i;
+    uint32_t hash;
+    size_t i;
+
+    for (hash = i = 0; i < len; ++i) {
+        hash += name[i];
+        hash += (hash << 10);
+        hash ^= (hash >> 6);
+    }
+    hash += (hash << 3);
+    hash ^= (hash >> 11);
+    hash += (hash << 15);
+    return hash;
+}
 
-    assert(name);
+/**
+ * @brief Find a specific SHM module.
+ *
+ * @param[in] mod_shm Mod SHM.
+ * @param[in] name Name of the module, does not have to be terminated.
+ * @param[in] len Length of @p name.
+ * @return Found SHM module, NULL if not found.
+ */
+static sr_mod_t *
+sr_shmmod_find_module_len(sr_mod_shm_t *mod_shm, const char *name, size_t len)
+{
+    sr_mod_t *shm_mod;
+    const char *shm_name;
+    uint32_t *mod_idx, i, mask;
+
+    if (mod_shm->mod_idx_size) {
+        /* hash index lookup */
+        mod_idx = (uint32_t *)(((char *)mod_shm) + mod_shm->mod_idx);
+        mask = mod_shm->mod_idx_size - 1;
+        for (i = sr_shmmod_name_hash(name, len) & mask; mod_idx[i]; i = (i + 1) & mask) {
+            shm_mod = SR_SHM_MOD_IDX(mod_shm, mod_idx[i] - 1);
+            shm_name = ((char *)mod_shm) + shm_mod->name;
+            if (!strncmp(shm_name, name, len) && !shm_name[len]) {
+                return shm_mod;
+            }
+        }
+        return NULL;
+    }
 
+    /* the index is being built */
     for (i = 0; i < mod_shm->mod_count; ++i) {
         shm_mod = SR_SHM_MOD_IDX(mod_shm, i);
-        if (!strcmp(((char *)mod_shm) + shm_mod->name, name)) {
+        shm_name = ((char *)mod_shm) + shm_mod->name;
+        if (!strncmp(shm_name, name, len) && !shm_name[len]) {
             return shm_mod;
         }
     }
@@ -103,20 +152,33 @@ sr_shmmod_find_module(sr_mod_shm_t *mod_shm, const char *name)
     return NULL;
 }
 
+sr_mod_t *
+sr_shmmod_find_module(sr_mod_shm_t *mod_shm, const char *name)
+{
+    assert(name);
+
+    return sr_shmmod_find_module_len(mod_shm, name, strlen(name));
+}
+
 sr_rpc_t *
 sr_shmmod_find_rpc(sr_mod_shm_t *mod_shm, const char *path)
 {
     sr_mod_t *shm_mod;
     sr_rpc_t *shm_rpc;
-    char *mod_name;
+    const char *mod_name, *ptr;
     uint16_t i;
 
     assert(path);
 
-    /* find module first */
-    mod_name = sr_get_first_ns(path);
-    shm_mod = sr_shmmod_find_module(mod_shm, mod_name);
-    free(mod_name);
+    /* find module first, the path is always absolute */
+    if (path[0] != '/') {
+        return NULL;
+    }
+    mod_name = path + 1;
+    if (!(ptr = strchr(mod_name, ':'))) {
+        return NULL;
+    }
+    shm_mod = sr_shmmod_find_module_len(mod_shm, mod_name, ptr - mod_name);
     if (!shm_mod) {
         return NULL;
     }
@@ -133,6 +195,51 @@ sr_shmmod_find_rpc(sr_mod_shm_t *mod_shm, const char *path)
     return NULL;
 }
 
+/**
+ * @brief Build the module hash index of mod SHM and add it at its end.
+ *
+ * @param[in] shm_mod Mod SHM structure with all the modules filled.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmmod_build_idx(sr_shm_t *shm_mod)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_mod_shm_t *mod_shm;
+    sr_mod_t *smod;
+    const char *name;
+    uint32_t *mod_idx, i, j, size, mask;
+    size_t old_shm_size;
+
+    /* keep the buckets at most half-full */
+    mod_shm = (sr_mod_shm_t *)shm_mod->addr;
+    for (size = 1; size < 2 * mod_shm->mod_count; size <<= 1) {}
+
+    /* enlarge mod SHM */
+    old_shm_size = shm_mod->size;
+    if ((err_info = sr_shm_remap(shm_mod, old_shm_size + SR_SHM_SIZE(size * sizeof *mod_idx)))) {
+        return err_info;
+    }
+    mod_shm = (sr_mod_shm_t *)shm_mod->addr;
+    mod_idx = (uint32_t *)(shm_mod->addr + old_shm_size);
+    memset(mod_idx, 0, size * sizeof *mod_idx);
+
+    /* add all the modules */
+    mask = size - 1;
+    for (i = 0; i < mod_shm->mod_count; ++i) {
+        smod = SR_SHM_MOD_IDX(mod_shm, i);
+        name = shm_mod->addr + smod->name;
+        for (j = sr_shmmod_name_hash(name, strlen(name)) & mask; mod_idx[j]; j = (j + 1) & mask) {}
+        mod_idx[j] = i + 1;
+    }
+
+    /* use the index */
+    mod_shm->mod_idx = old_shm_size;
+    mod_shm->mod_idx_size = size;
+
+    return NULL;
+}
+
 /**
  * @brief Fill a new SHM module and add its name and enabled features into mod SHM.
  * Does not add data/op/inverse dependencies.
@@ -166,6 +273,9 @@ sr_shmmod_fill(sr_shm_t *shm_mod, size_t shm_mod_idx, const struct lyd_node *sr_
         if ((err_info = sr_mutex_init(&smod->data_lock_info[ds].ds_lock, 1))) {
             return err_info;
         }
+        if ((err_info = sr_cond_init(&smod->data_lock_info[ds].ds_lock_cond, 1, 1))) {
+            return err_info;
+        }
     }
     if ((err_info = sr_rwlock_init(&smod->replay_lock, 1))) {
         return err_info;
@@ -417,7 +527,7 @@ cleanup:
 }
 
 /**
- * @brief Add module (data and inverse) dependencies into mod SHM.
+ * @brief Add module (data and inverse) dependencies and imports into mod SHM.
  *
  * @param[in] shm_mod Mod SHM structure to remap and append the data to.
  * @param[in] shm_mod_idx Mod SHM mod index of @p sr_mod.
@@ -431,18 +541,20 @@ sr_shmmod_add_deps(sr_shm_t *shm_mod, size_t shm_mod_idx, const struct lyd_node
     struct lyd_node *sr_child, *sr_dep;
     sr_mod_t *smod, *ref_smod;
     sr_dep_t *shm_deps;
-    off_t *shm_inv_deps;
+    off_t *shm_inv_deps, *shm_imports;
     sr_mod_shm_t *mod_shm;
     char *shm_end;
-    size_t paths_len, dep_i, inv_dep_i, old_shm_size;
+    size_t paths_len, imp_names_len, dep_i, inv_dep_i, imp_i, old_shm_size;
 
     smod = SR_SHM_MOD_IDX(shm_mod->addr, shm_mod_idx);
 
     assert(!smod->dep_count);
     assert(!smod->inv_dep_count);
+    assert(!smod->imp_count);
 
     /* count arrays and paths length */
     paths_len = 0;
+    imp_names_len = 0;
     LY_LIST_FOR(lyd_child(sr_mod), sr_child) {
         if (!strcmp(sr_child->schema->name, "deps")) {
             LY_LIST_FOR(lyd_child(sr_child), sr_dep) {
@@ -455,6 +567,10 @@ sr_shmmod_add_deps(sr_shm_t *shm_mod, size_t shm_mod_idx, const struct lyd_node
         } else if (!strcmp(sr_child->schema->name, "inverse-deps")) {
             /* another inverse data dependency */
             ++smod->inv_dep_count;
+        } else if (!strcmp(sr_child->schema->name, "imports")) {
+            /* another import, it may not be installed */
+            ++smod->imp_count;
+            imp_names_len += sr_strshmlen(lyd_get_value(sr_child));
         }
     }
 
@@ -463,7 +579,8 @@ sr_shmmod_add_deps(sr_shm_t *shm_mod, size_t shm_mod_idx, const struct lyd_node
 
     /* enlarge and possibly remap mod SHM */
     if ((err_info = sr_shm_remap(shm_mod, shm_mod->size + paths_len + SR_SHM_SIZE(smod->dep_count * sizeof(sr_dep_t)) +
-            SR_SHM_SIZE(smod->inv_dep_count * sizeof(off_t))))) {
+            SR_SHM_SIZE(smod->inv_dep_count * sizeof(off_t)) + SR_SHM_SIZE(smod->imp_count * sizeof(off_t)) +
+            imp_names_len))) {
         return err_info;
     }
     smod = SR_SHM_MOD_IDX(shm_mod->addr, shm_mod_idx);
@@ -479,6 +596,10 @@ sr_shmmod_add_deps(sr_shm_t *shm_mod, size_t shm_mod_idx, const struct lyd_node
     shm_inv_deps = (off_t *)(shm_mod->addr + smod->inv_deps);
     inv_dep_i = 0;
 
+    smod->imports = sr_shmcpy(shm_mod->addr, NULL, smod->imp_count * sizeof(off_t), &shm_end);
+    shm_imports = (off_t *)(shm_mod->addr + smod->imports);
+    imp_i = 0;
+
     LY_LIST_FOR(lyd_child(sr_mod), sr_child) {
         if (!strcmp(sr_child->schema->name, "deps")) {
             /* now fill the dependency array */
@@ -492,10 +613,16 @@ sr_shmmod_add_deps(sr_shm_t *shm_mod, size_t shm_mod_idx, const struct lyd_node
             shm_inv_deps[inv_dep_i] = ref_smod->name;
 
             ++inv_dep_i;
+        } else if (!strcmp(sr_child->schema->name, "imports")) {
+            /* copy imported module name */
+            shm_imports[imp_i] = sr_shmstrcpy(shm_mod->addr, lyd_get_value(sr_child), &shm_end);
+
+            ++imp_i;
         }
     }
     SR_CHECK_INT_RET(dep_i != smod->dep_count, err_info);
     SR_CHECK_INT_RET(inv_dep_i != smod->inv_dep_count, err_info);
+    SR_CHECK_INT_RET(imp_i != smod->imp_count, err_info);
 
     /* mod SHM size must be exactly what we allocated */
     assert(shm_end == shm_mod->addr + shm_mod->size);
@@ -776,8 +903,10 @@ sr_shmmod_store_modules(sr_shm_t *shm_mod, const struct lyd_node *sr_mods)
         goto cleanup;
     }
 
-    /* set module count */
+    /* set module count, the module index is built once all the modules are stored */
     ((sr_mod_shm_t *)shm_mod->addr)->mod_count = mod_count;
+    ((sr_mod_shm_t *)shm_mod->addr)->mod_idx = 0;
+    ((sr_mod_shm_t *)shm_mod->addr)->mod_idx_size = 0;
 
     /* add all modules into SHM */
     i = 0;
@@ -827,6 +956,11 @@ sr_shmmod_store_modules(sr_shm_t *shm_mod, const struct lyd_node *sr_mods)
         sr_mod = sr_mod->next;
     }
 
+    /* build the module index */
+    if ((err_info = sr_shmmod_build_idx(shm_mod))) {
+        goto cleanup;
+    }
+
 cleanup:
     free(shm_mod_old);
     return err_info;
@@ -859,14 +993,46 @@ sr_shmmod_features2array(char *mod_shm_addr, off_t *shm_features, uint16_t feat_
     return NULL;
 }
 
+/**
+ * @brief Load a module stored in mod SHM into a context.
+ *
+ * @param[in] mod_shm Mod SHM.
+ * @param[in,out] ly_ctx libyang context to update.
+ * @param[in] smod SHM module to load.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmmod_ctx_load_module(sr_mod_shm_t *mod_shm, struct ly_ctx *ly_ctx, sr_mod_t *smod)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lys_module *ly_mod;
+    off_t *shm_features;
+    const char **features;
+
+    /* create the features array */
+    shm_features = (off_t *)((char *)mod_shm + smod->features);
+    if ((err_info = sr_shmmod_features2array((char *)mod_shm, shm_features, smod->feat_count, &features))) {
+        return err_info;
+    }
+
+    /* load the module */
+    ly_mod = ly_ctx_load_module(ly_ctx, (char *)mod_shm + smod->name, smod->rev[0] ? smod->rev : NULL, features);
+    free(features);
+    if (!ly_mod) {
+        sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+        return err_info;
+    }
+
+    return NULL;
+}
+
 sr_error_info_t *
 sr_shmmod_ctx_load_modules(sr_mod_shm_t *mod_shm, struct ly_ctx *ly_ctx, const struct ly_set *skip_mod_set)
 {
     sr_error_info_t *err_info = NULL;
     sr_mod_t *smod;
-    const struct lys_module *skip_mod, *ly_mod;
-    off_t *shm_features;
-    const char *mod_name, **features;
+    const struct lys_module *skip_mod;
+    const char *mod_name;
     uint32_t i, j;
 
     for (i = 0; i < mod_shm->mod_count; ++i) {
@@ -886,17 +1052,8 @@ sr_shmmod_ctx_load_modules(sr_mod_shm_t *mod_shm, struct ly_ctx *ly_ctx, const s
             }
         }
 
-        /* create the features array */
-        shm_features = (off_t *)((char *)mod_shm + smod->features);
-        if ((err_info = sr_shmmod_features2array((char *)mod_shm, shm_features, smod->feat_count, &features))) {
-            return err_info;
-        }
-
         /* load the module */
-        ly_mod = ly_ctx_load_module(ly_ctx, mod_name, smod->rev[0] ? smod->rev : NULL, features);
-        free(features);
-        if (!ly_mod) {
-            sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+        if ((err_info = sr_shmmod_ctx_load_module(mod_shm, ly_ctx, smod))) {
             return err_info;
         }
     }
@@ -910,6 +1067,221 @@ sr_shmmod_ctx_load_modules(sr_mod_shm_t *mod_shm, struct ly_ctx *ly_ctx, const s
     return NULL;
 }
 
+/**
+ * @brief Mark a module to be loaded into a lazy context.
+ *
+ * @param[in] mod_shm Mod SHM.
+ * @param[in] mod_name Module name.
+ * @param[in] flag Flag to set, 1 for a module whose importing modules are loaded as well, 2 for an internal module.
+ * @param[in,out] load Array of flags for all the modules in @p mod_shm whether to load them.
+ * @param[in,out] changed Set if a module flag was changed.
+ */
+static void
+sr_shmmod_lazy_mark_module(sr_mod_shm_t *mod_shm, const char *mod_name, char flag, char *load, int *changed)
+{
+    sr_mod_t *smod;
+    uint32_t idx;
+
+    if (!(smod = sr_shmmod_find_module(mod_shm, mod_name))) {
+        return;
+    }
+
+    /* the modules are stored in an array */
+    idx = smod - SR_SHM_MOD_IDX(mod_shm, 0);
+    if (!load[idx] || (load[idx] > flag)) {
+        load[idx] = flag;
+        *changed = 1;
+    }
+}
+
+/**
+ * @brief Mark all the modules of dependencies to be loaded into a lazy context.
+ *
+ * @param[in] mod_shm Mod SHM.
+ * @param[in] shm_deps Array of SHM dependencies.
+ * @param[in] dep_count Count of @p shm_deps.
+ * @param[in] flag Flag to set, see ::sr_shmmod_lazy_mark_module().
+ * @param[in,out] load Array of flags for all the modules in @p mod_shm whether to load them.
+ * @param[in,out] changed Set if a module flag was changed.
+ */
+static void
+sr_shmmod_lazy_mark_deps(sr_mod_shm_t *mod_shm, sr_dep_t *shm_deps, uint16_t dep_count, char flag, char *load,
+        int *changed)
+{
+    off_t *target_mods;
+    uint16_t i, j;
+
+    for (i = 0; i < dep_count; ++i) {
+        switch (shm_deps[i].type) {
+        case SR_DEP_LREF:
+            sr_shmmod_lazy_mark_module(mod_shm, (char *)mod_shm + shm_deps[i].lref.target_module, flag, load, changed);
+            break;
+        case SR_DEP_XPATH:
+            target_mods = (off_t *)((char *)mod_shm + shm_deps[i].xpath.target_modules);
+            for (j = 0; j < shm_deps[i].xpath.target_mod_count; ++j) {
+                sr_shmmod_lazy_mark_module(mod_shm, (char *)mod_shm + target_mods[j], flag, load, changed);
+            }
+            break;
+        case SR_DEP_INSTID:
+            /* target not known in advance */
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Collect all the installed modules imported by a module or its submodules.
+ *
+ * @param[in] mod_shm Mod SHM.
+ * @param[in] smod SHM module to check.
+ * @param[out] imp_idx Array of mod SHM indices of the imported modules.
+ * @param[out] imp_count Count of @p imp_idx.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmmod_lazy_imports(sr_mod_shm_t *mod_shm, sr_mod_t *smod, uint32_t **imp_idx, uint32_t *imp_count)
+{
+    sr_error_info_t *err_info = NULL;
+    off_t *shm_imports;
+    sr_mod_t *imp_mod;
+    uint16_t i;
+
+    *imp_idx = NULL;
+    *imp_count = 0;
+
+    if (!smod->imp_count) {
+        return NULL;
+    }
+
+    *imp_idx = malloc(smod->imp_count * sizeof **imp_idx);
+    SR_CHECK_MEM_RET(!*imp_idx, err_info);
+
+    shm_imports = (off_t *)((char *)mod_shm + smod->imports);
+    for (i = 0; i < smod->imp_count; ++i) {
+        if (!(imp_mod = sr_shmmod_find_module(mod_shm, (char *)mod_shm + shm_imports[i]))) {
+            /* not installed */
+            continue;
+        }
+
+        (*imp_idx)[*imp_count] = imp_mod - SR_SHM_MOD_IDX(mod_shm, 0);
+        ++(*imp_count);
+    }
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_shmmod_ctx_load_lazy_modules(sr_mod_shm_t *mod_shm, struct ly_ctx *ly_ctx, char **mod_names, uint32_t mod_name_count)
+{
+    sr_error_info_t *err_info = NULL;
+    const char *int_mods[] = {"ietf-yang-library", "ietf-netconf-acm", "sysrepo-monitoring", "sysrepo-plugind",
+        "ietf-netconf", "ietf-netconf-with-defaults", "ietf-netconf-notifications", "ietf-origin", NULL};
+    sr_mod_t *smod;
+    sr_rpc_t *shm_rpcs;
+    sr_notif_t *shm_notifs;
+    off_t *inv_deps;
+    char *load = NULL;
+    uint32_t i, j, **imp_idx = NULL, *imp_count = NULL;
+    int changed = 0;
+
+    for (i = 0; i < mod_shm->mod_count; ++i) {
+        if (SR_SHM_MOD_IDX(mod_shm, i)->imp_count) {
+            break;
+        }
+    }
+    if (i == mod_shm->mod_count) {
+        /* module data stored before imports were recorded (even internal modules import others), load all */
+        return sr_shmmod_ctx_load_modules(mod_shm, ly_ctx, NULL);
+    }
+
+    load = calloc(mod_shm->mod_count, 1);
+    imp_idx = calloc(mod_shm->mod_count, sizeof *imp_idx);
+    imp_count = calloc(mod_shm->mod_count, sizeof *imp_count);
+    SR_CHECK_MEM_GOTO(!load || !imp_idx || !imp_count, err_info, cleanup);
+
+    /* sysrepo internal modules and the requested modules */
+    for (i = 0; int_mods[i]; ++i) {
+        sr_shmmod_lazy_mark_module(mod_shm, int_mods[i], 2, load, &changed);
+    }
+    for (i = 0; i < mod_name_count; ++i) {
+        sr_shmmod_lazy_mark_module(mod_shm, mod_names[i], 1, load, &changed);
+    }
+
+    /* learn the imports of all the other modules, they may augment, deviate, or derive identities of loaded modules */
+    for (i = 0; i < mod_shm->mod_count; ++i) {
+        if (!load[i] && (err_info = sr_shmmod_lazy_imports(mod_shm, SR_SHM_MOD_IDX(mod_shm, i), &imp_idx[i],
+                &imp_count[i]))) {
+            goto cleanup;
+        }
+    }
+
+    /* add all their dependencies, inverse dependencies, and importing modules, recursively */
+    while (changed) {
+        changed = 0;
+        for (i = 0; i < mod_shm->mod_count; ++i) {
+            if (!load[i]) {
+                for (j = 0; j < imp_count[i]; ++j) {
+                    if (load[imp_idx[i][j]] == 1) {
+                        load[i] = 1;
+                        changed = 1;
+                        break;
+                    }
+                }
+                if (!load[i]) {
+                    continue;
+                }
+            }
+            smod = SR_SHM_MOD_IDX(mod_shm, i);
+
+            sr_shmmod_lazy_mark_deps(mod_shm, (sr_dep_t *)((char *)mod_shm + smod->deps), smod->dep_count, load[i],
+                    load, &changed);
+
+            inv_deps = (off_t *)((char *)mod_shm + smod->inv_deps);
+            for (j = 0; j < smod->inv_dep_count; ++j) {
+                sr_shmmod_lazy_mark_module(mod_shm, (char *)mod_shm + inv_deps[j], load[i], load, &changed);
+            }
+
+            shm_rpcs = (sr_rpc_t *)((char *)mod_shm + smod->rpcs);
+            for (j = 0; j < smod->rpc_count; ++j) {
+                sr_shmmod_lazy_mark_deps(mod_shm, (sr_dep_t *)((char *)mod_shm + shm_rpcs[j].in_deps),
+                        shm_rpcs[j].in_dep_count, load[i], load, &changed);
+                sr_shmmod_lazy_mark_deps(mod_shm, (sr_dep_t *)((char *)mod_shm + shm_rpcs[j].out_deps),
+                        shm_rpcs[j].out_dep_count, load[i], load, &changed);
+            }
+
+            shm_notifs = (sr_notif_t *)((char *)mod_shm + smod->notifs);
+            for (j = 0; j < smod->notif_count; ++j) {
+                sr_shmmod_lazy_mark_deps(mod_shm, (sr_dep_t *)((char *)mod_shm + shm_notifs[j].deps),
+                        shm_notifs[j].dep_count, load[i], load, &changed);
+            }
+        }
+    }
+
+    /* load the marked modules */
+    for (i = 0; i < mod_shm->mod_count; ++i) {
+        if (load[i] && (err_info = sr_shmmod_ctx_load_module(mod_shm, ly_ctx, SR_SHM_MOD_IDX(mod_shm, i)))) {
+            goto cleanup;
+        }
+    }
+
+    /* compile */
+    if (ly_ctx_compile(ly_ctx)) {
+        sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+        goto cleanup;
+    }
+
+cleanup:
+    if (imp_idx) {
+        for (i = 0; i < mod_shm->mod_count; ++i) {
+            free(imp_idx[i]);
+        }
+    }
+    free(imp_idx);
+    free(imp_count);
+    free(load);
+    return err_info;
+}
+
 sr_error_info_t *
 sr_shmmod_get_rpc_deps(sr_mod_shm_t *mod_shm, const char *path, int output, sr_dep_t **shm_deps, uint16_t *shm_dep_count)
 {
@@ -983,15 +1355,27 @@ sr_shmmod_collect_deps_lref(const char *target_path, const char *target_module,
 
 sr_error_info_t *
 sr_shmmod_collect_deps_instid(const char *source_path, const char *default_target_path, const struct lyd_node *data,
-        struct sr_mod_info_s *mod_info)
+        const struct lys_module *src_mod, uint32_t src_run_data_ver, struct sr_mod_info_s *mod_info)
 {
     sr_error_info_t *err_info = NULL;
     const struct lys_module *ly_mod;
     struct ly_set *set = NULL;
+    struct sr_instid_cache_target_s *targets = NULL;
+    uint32_t target_count = 0;
     const char *val_str;
     char *str;
     uint32_t i;
+    int use_cache = 0;
     LY_ERR lyrc;
+    void *mem;
+
+    if (src_mod && (mod_info->ds == SR_DS_RUNNING) && !sr_instid_diff_changed(mod_info->diff, source_path)) {
+        /* the instance-identifiers are the same as in the stored data, the targets may be cached */
+        if (sr_conn_instid_cache_get(mod_info->conn, src_mod, source_path, src_run_data_ver, mod_info, &err_info)) {
+            return err_info;
+        }
+        use_cache = 1;
+    }
 
     if (data) {
         lyrc = lyd_find_xpath(data, source_path, &set);
@@ -1024,6 +1408,17 @@ sr_shmmod_collect_deps_instid(const char *source_path, const char *default_targe
             if ((err_info = sr_modinfo_add(ly_mod, val_str, 0, 0, mod_info))) {
                 goto cleanup;
             }
+
+            if (use_cache) {
+                /* remember the target for the cache */
+                mem = realloc(targets, (target_count + 1) * sizeof *targets);
+                SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+                targets = mem;
+                targets[target_count].ly_mod = ly_mod;
+                targets[target_count].xpath = strdup(val_str);
+                SR_CHECK_MEM_GOTO(!targets[target_count].xpath, err_info, cleanup);
+                ++target_count;
+            }
         }
     } else if (default_target_path) {
         /* assume a default value will be used even though it may not be */
@@ -1035,9 +1430,29 @@ sr_shmmod_collect_deps_instid(const char *source_path, const char *default_targe
         if ((err_info = sr_modinfo_add(ly_mod, default_target_path, 0, 0, mod_info))) {
             goto cleanup;
         }
+
+        if (use_cache) {
+            targets = malloc(sizeof *targets);
+            SR_CHECK_MEM_GOTO(!targets, err_info, cleanup);
+            targets[0].ly_mod = ly_mod;
+            targets[0].xpath = strdup(default_target_path);
+            SR_CHECK_MEM_GOTO(!targets[0].xpath, err_info, cleanup);
+            target_count = 1;
+        }
+    }
+
+    if (use_cache) {
+        /* cache the targets for the next commits */
+        sr_conn_instid_cache_store(mod_info->conn, src_mod, source_path, src_run_data_ver, targets, target_count);
+        targets = NULL;
+        target_count = 0;
     }
 
 cleanup:
+    for (i = 0; i < target_count; ++i) {
+        free(targets[i].xpath);
+    }
+    free(targets);
     ly_set_free(set, NULL);
     return err_info;
 }
@@ -1077,7 +1492,7 @@ sr_shmmod_collect_deps_xpath(const char *expr, char *mod_shm_addr, off_t *target
 
 sr_error_info_t *
 sr_shmmod_collect_deps(sr_mod_shm_t *mod_shm, sr_dep_t *shm_deps, uint16_t shm_dep_count, const struct lyd_node *data,
-        struct sr_mod_info_s *mod_info)
+        const struct lys_module *src_mod, uint32_t src_run_data_ver, struct sr_mod_info_s *mod_info)
 {
     sr_error_info_t *err_info = NULL;
     uint32_t i;
@@ -1098,7 +1513,7 @@ sr_shmmod_collect_deps(sr_mod_shm_t *mod_shm, sr_dep_t *shm_deps, uint16_t shm_d
             str1 = (char *)mod_shm + shm_deps[i].instid.source_path;
             str2 = shm_deps[i].instid.default_target_path ? (char *)mod_shm +
                     shm_deps[i].instid.default_target_path : NULL;
-            if ((err_info = sr_shmmod_collect_deps_instid(str1, str2, data, mod_info))) {
+            if ((err_info = sr_shmmod_collect_deps_instid(str1, str2, data, src_mod, src_run_data_ver, mod_info))) {
                 goto cleanup;
             }
             break;
@@ -1141,6 +1556,51 @@ sr_shmmod_recover_cb(sr_lock_mode_t mode, sr_cid_t cid, void *data)
     cb_data->ds_plg->recover_cb(ly_mod, cb_data->ds);
 }
 
+/**
+ * @brief Wait until a module DS lock held by another session is released.
+ *
+ * @param[in] shm_lock Module lock with the DS lock.
+ * @param[in] sid Sysrepo session ID of the waiting session.
+ * @param[in,out] ds_timeout_ms Timeout for the DS lock to be released, remaining timeout on return.
+ * @return err_info, NULL on success (also if the timeout elapsed).
+ */
+static sr_error_info_t *
+sr_shmmod_ds_lock_wait(struct sr_mod_lock_s *shm_lock, uint32_t sid, uint32_t *ds_timeout_ms)
+{
+    sr_error_info_t *err_info = NULL;
+    struct timespec timeout_abs, cur_ts;
+    int ret, left_ms;
+
+    sr_timeouttime_get(&timeout_abs, *ds_timeout_ms);
+
+    /* DS LOCK */
+    if ((err_info = sr_mlock(&shm_lock->ds_lock, SR_DS_LOCK_MUTEX_TIMEOUT, __func__, NULL, NULL))) {
+        return err_info;
+    }
+
+    ret = 0;
+    while (!ret && shm_lock->ds_lock_sid && (shm_lock->ds_lock_sid != sid)) {
+        /* COND WAIT */
+        ret = sr_cond_clockwait(&shm_lock->ds_lock_cond, &shm_lock->ds_lock, COMPAT_CLOCK_ID, &timeout_abs);
+    }
+
+    /* DS UNLOCK */
+    sr_munlock(&shm_lock->ds_lock);
+
+    if (ret == ETIMEDOUT) {
+        *ds_timeout_ms = 0;
+    } else if (ret) {
+        SR_ERRINFO_COND(&err_info, __func__, ret);
+    } else {
+        /* released, the lock may be acquired by someone else again before retrying */
+        sr_timeouttime_get(&cur_ts, 0);
+        left_ms = sr_time_sub_ms(&timeout_abs, &cur_ts);
+        *ds_timeout_ms = (left_ms > 0) ? left_ms : 0;
+    }
+
+    return err_info;
+}
+
 /**
  * @brief Lock or relock a mod SHM module.
  *
@@ -1149,6 +1609,7 @@ sr_shmmod_recover_cb(sr_lock_mode_t mode, sr_cid_t cid, void *data)
  * @param[in] shm_lock Main SHM module lock.
  * @param[in] timeout_ms Timeout in ms. If 0, the default timeout is used.
  * @param[in] mode Lock mode of the module.
+ * @param[in] prio Priority of a ::SR_LOCK_READ_UPGR lock.
  * @param[in] ds_timeout_ms Timeout in ms for DS-lock in case it is required and locked, if 0 no waiting is performed.
  * @param[in] cid Connection ID.
  * @param[in] sid Sysrepo session ID to store.
@@ -1157,12 +1618,12 @@ sr_shmmod_recover_cb(sr_lock_mode_t mode, sr_cid_t cid, void *data)
  */
 static sr_error_info_t *
 sr_shmmod_lock(const struct lys_module *ly_mod, sr_datastore_t ds, struct sr_mod_lock_s *shm_lock, uint32_t timeout_ms,
-        sr_lock_mode_t mode, uint32_t ds_timeout_ms, sr_cid_t cid, uint32_t sid, const struct srplg_ds_s *ds_plg, int relock)
+        sr_lock_mode_t mode, uint32_t prio, uint32_t ds_timeout_ms, sr_cid_t cid, uint32_t sid,
+        const struct srplg_ds_s *ds_plg, int relock)
 {
     sr_error_info_t *err_info = NULL, *tmp_err;
     struct sr_shmmod_recover_cb_s cb_data;
     int ds_locked;
-    uint32_t sleep_ms;
 
     if (!timeout_ms) {
         /* default timeout */
@@ -1182,7 +1643,8 @@ ds_lock_retry:
         err_info = sr_rwrelock(&shm_lock->data_lock, timeout_ms, mode, cid, __func__, sr_shmmod_recover_cb, &cb_data);
     } else {
         /* LOCK */
-        err_info = sr_rwlock(&shm_lock->data_lock, timeout_ms, mode, cid, __func__, sr_shmmod_recover_cb, &cb_data);
+        err_info = sr_rwlock_prio(&shm_lock->data_lock, timeout_ms, mode, prio, cid, __func__, sr_shmmod_recover_cb,
+                &cb_data);
     }
     if (err_info) {
         goto cleanup;
@@ -1234,12 +1696,10 @@ revert_lock:
 
     assert(ds_locked);
     if (ds_timeout_ms) {
-        /* sleep for the step/whatever is left and retry */
-        sleep_ms = (ds_timeout_ms >= SR_DS_LOCK_TIMEOUT_STEP) ? SR_DS_LOCK_TIMEOUT_STEP : ds_timeout_ms;
-        if ((err_info = sr_msleep(sleep_ms))) {
+        /* wait for the DS lock to be released and retry */
+        if ((err_info = sr_shmmod_ds_lock_wait(shm_lock, sid, &ds_timeout_ms))) {
             goto cleanup;
         }
-        ds_timeout_ms -= sleep_ms;
         goto ds_lock_retry;
     } else {
         /* timeout elapsed */
@@ -1289,8 +1749,8 @@ sr_shmmod_modinfo_lock(struct sr_mod_info_s *mod_info, sr_datastore_t ds, uint32
         }
 
         /* MOD LOCK */
-        if ((err_info = sr_shmmod_lock(mod->ly_mod, ds, shm_lock, timeout_ms, mode, ds_timeout_ms,
-                mod_info->conn->cid, sid, mod->ds_plg[ds], 0))) {
+        if ((err_info = sr_shmmod_lock(mod->ly_mod, ds, shm_lock, timeout_ms, mode, mod_info->commit_prio,
+                ds_timeout_ms, mod_info->conn->cid, sid, mod->ds_plg[ds], 0))) {
             return err_info;
         }
 
@@ -1370,7 +1830,7 @@ sr_shmmod_modinfo_rdlock_upgrade(struct sr_mod_info_s *mod_info, uint32_t sid, u
          * causing potential dead-lock */
         if ((mod->state & (MOD_INFO_RLOCK_UPGR | MOD_INFO_REQ)) == (MOD_INFO_RLOCK_UPGR | MOD_INFO_REQ)) {
             /* MOD WRITE UPGRADE */
-            if ((err_info = sr_shmmod_lock(mod->ly_mod, mod_info->ds, shm_lock, timeout_ms, SR_LOCK_WRITE_URGE,
+            if ((err_info = sr_shmmod_lock(mod->ly_mod, mod_info->ds, shm_lock, timeout_ms, SR_LOCK_WRITE_URGE, 0,
                     ds_timeout_ms, mod_info->conn->cid, sid, mod->ds_plg[mod_info->ds], 1))) {
                 return err_info;
             }
@@ -1399,7 +1859,7 @@ sr_shmmod_modinfo_wrlock_downgrade(struct sr_mod_info_s *mod_info, uint32_t sid,
         /* downgrade only write-locked modules */
         if (mod->state & MOD_INFO_WLOCK) {
             /* MOD READ DOWNGRADE */
-            if ((err_info = sr_shmmod_lock(mod->ly_mod, mod_info->ds, shm_lock, timeout_ms, SR_LOCK_READ_UPGR,
+            if ((err_info = sr_shmmod_lock(mod->ly_mod, mod_info->ds, shm_lock, timeout_ms, SR_LOCK_READ_UPGR, 0,
                     0, mod_info->conn->cid, sid, mod->ds_plg[mod_info->ds], 1))) {
                 return err_info;
             }
@@ -1487,6 +1947,9 @@ sr_shmmod_release_locks(sr_conn_ctx_t *conn, uint32_t sid)
                 /* clear DS lock information */
                 shm_lock->ds_lock_sid = 0;
                 memset(&shm_lock->ds_lock_ts, 0, sizeof shm_lock->ds_lock_ts);
+
+                /* wake up any waiters */
+                sr_cond_broadcast(&shm_lock->ds_lock_cond);
             }
 
             /* DS UNLOCK */
@@ -1500,8 +1963,8 @@ sr_shmmod_release_locks(sr_conn_ctx_t *conn, uint32_t sid)
                 }
 
                 /* MOD WRITE LOCK */
-                if ((err_info = sr_shmmod_lock(ly_mod, ds, shm_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_WRITE, 0, conn->cid,
-                        sid, ds_plg, 0))) {
+                if ((err_info = sr_shmmod_lock(ly_mod, ds, shm_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_WRITE, 0, 0,
+                        conn->cid, sid, ds_plg, 0))) {
                     sr_errinfo_free(&err_info);
                 } else {
                     /* reset candidate */
@@ -1535,6 +1998,10 @@ sr_shmmod_update_replay_support(sr_mod_shm_t *mod_shm, const struct ly_set *mod_
 
         /* update flag */
         smod->replay_supp = enable;
+        if (!enable) {
+            /* the notifications are no longer stored */
+            sr_replay_ring_remove(ly_mod->name);
+        }
     }
 
     return NULL;
@@ -1594,46 +2061,158 @@ cleanup:
     return err_info;
 }
 
-sr_error_info_t *
-sr_shmmod_reboot_init(sr_conn_ctx_t *conn, int initialized)
+/**
+ * @brief Initialize DS plugins of a module and copy its startup data into running after a reboot.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] smod SHM module.
+ * @param[in] initialized Whether the DS plugins were already initialized.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmmod_reboot_init_mod(sr_conn_ctx_t *conn, sr_mod_t *smod, int initialized)
 {
     sr_error_info_t *err_info = NULL;
-    sr_mod_shm_t *mod_shm;
-    sr_mod_t *smod;
+    sr_mod_shm_t *mod_shm = SR_CONN_MOD_SHM(conn);
     const struct lys_module *ly_mod;
     const struct srplg_ds_s *ds_plg[SR_DS_READ_COUNT];
     sr_datastore_t ds;
-    uint32_t i;
     int rc;
 
-    mod_shm = SR_CONN_MOD_SHM(conn);
+    /* find LY module */
+    ly_mod = ly_ctx_get_module_implemented(conn->ly_ctx, ((char *)mod_shm) + smod->name);
+    assert(ly_mod);
 
-    for (i = 0; i < mod_shm->mod_count; ++i) {
-        smod = SR_SHM_MOD_IDX(mod_shm, i);
+    /* any running data snapshot is from before the reboot */
+    sr_run_snapshot_remove(ly_mod->name);
 
-        /* find LY module */
-        ly_mod = ly_ctx_get_module_implemented(conn->ly_ctx, ((char *)mod_shm) + smod->name);
-        assert(ly_mod);
+    /* find DS plugins and init them */
+    for (ds = 0; ds < SR_DS_READ_COUNT; ++ds) {
+        if ((err_info = sr_ds_plugin_find(((char *)mod_shm) + smod->plugins[ds], conn, &ds_plg[ds]))) {
+            return err_info;
+        }
+        if (!initialized && (rc = ds_plg[ds]->init_cb(ly_mod, ds))) {
+            SR_ERRINFO_DSPLUGIN(&err_info, rc, "init", ds_plg[ds]->name, ly_mod->name);
+            return err_info;
+        }
+    }
 
-        /* find DS plugins and init them */
-        for (ds = 0; ds < SR_DS_READ_COUNT; ++ds) {
-            if ((err_info = sr_ds_plugin_find(((char *)mod_shm) + smod->plugins[ds], conn, &ds_plg[ds]))) {
-                return err_info;
-            }
-            if (!initialized && (rc = ds_plg[ds]->init_cb(ly_mod, ds))) {
-                SR_ERRINFO_DSPLUGIN(&err_info, rc, "init", ds_plg[ds]->name, ly_mod->name);
-                return err_info;
-            }
+    if (!sr_module_has_data(ly_mod, 0)) {
+        /* skip copying for modules without configuration data */
+        return NULL;
+    }
+
+    /* copy startup to running */
+    return sr_shmmod_copy_mod(ly_mod, ds_plg[SR_DS_STARTUP], SR_DS_STARTUP, ds_plg[SR_DS_RUNNING], SR_DS_RUNNING);
+}
+
+#if SR_DATA_LOAD_THREADS > 0
+
+/**
+ * @brief Shared state of the parallel reboot init threads.
+ */
+struct sr_shmmod_reboot_pool_s {
+    sr_conn_ctx_t *conn;            /**< Connection to use. */
+    int initialized;                /**< Whether the DS plugins were already initialized. */
+    uint32_t count;                 /**< Count of SHM modules. */
+    sr_error_info_t **err_info;     /**< Error info of each module init. */
+    ATOMIC_T next;                  /**< Index of the next module to init. */
+};
+
+/**
+ * @brief Thread initializing the modules that are not yet taken by another thread.
+ *
+ * @param[in] arg Reboot init pool.
+ * @return Always NULL.
+ */
+static void *
+sr_shmmod_reboot_init_thread(void *arg)
+{
+    struct sr_shmmod_reboot_pool_s *pool = arg;
+    uint32_t i;
+
+    while ((i = ATOMIC_INC_RELAXED(pool->next)) < pool->count) {
+        pool->err_info[i] = sr_shmmod_reboot_init_mod(pool->conn, SR_SHM_MOD_IDX(SR_CONN_MOD_SHM(pool->conn), i),
+                pool->initialized);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Initialize all the modules after a reboot in parallel.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] initialized Whether the DS plugins were already initialized.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmmod_reboot_init_parallel(sr_conn_ctx_t *conn, int initialized)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_shmmod_reboot_pool_s pool = {0};
+    pthread_t tids[SR_DATA_LOAD_THREADS - 1];
+    uint32_t i, tid_count = 0;
+
+    pool.conn = conn;
+    pool.initialized = initialized;
+    pool.count = SR_CONN_MOD_SHM(conn)->mod_count;
+    pool.err_info = calloc(pool.count, sizeof *pool.err_info);
+    SR_CHECK_MEM_RET(!pool.err_info, err_info);
+    ATOMIC_STORE_RELAXED(pool.next, 0);
+
+    /* start the threads, if any fails to start, the remaining ones (including this one) init its share */
+    while ((tid_count < SR_DATA_LOAD_THREADS - 1) && (tid_count < pool.count - 1)) {
+        if (pthread_create(&tids[tid_count], NULL, sr_shmmod_reboot_init_thread, &pool)) {
+            break;
         }
+        ++tid_count;
+    }
 
-        if (!sr_module_has_data(ly_mod, 0)) {
-            /* skip copying for modules without configuration data */
-            continue;
+    /* init in this thread as well */
+    sr_shmmod_reboot_init_thread(&pool);
+
+    /* wait for all the threads */
+    for (i = 0; i < tid_count; ++i) {
+        pthread_join(tids[i], NULL);
+    }
+
+    /* collect errors */
+    for (i = 0; i < pool.count; ++i) {
+        if (pool.err_info[i]) {
+            sr_errinfo_merge(&err_info, pool.err_info[i]);
+        }
+    }
+    free(pool.err_info);
+
+    return err_info;
+}
+
+#endif
+
+sr_error_info_t *
+sr_shmmod_reboot_init(sr_conn_ctx_t *conn, int initialized)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_mod_shm_t *mod_shm;
+    uint32_t i;
+
+    mod_shm = SR_CONN_MOD_SHM(conn);
+
+#if SR_DATA_LOAD_THREADS > 0
+    if (mod_shm->mod_count > 1) {
+        /* modules are independent of each other */
+        if ((err_info = sr_shmmod_reboot_init_parallel(conn, initialized))) {
+            return err_info;
         }
 
-        /* copy startup to running */
-        if ((err_info = sr_shmmod_copy_mod(ly_mod, ds_plg[SR_DS_STARTUP], SR_DS_STARTUP, ds_plg[SR_DS_RUNNING],
-                SR_DS_RUNNING))) {
+        SR_LOG_INF("Datastore copied from <startup> to <running>.");
+        return NULL;
+    }
+#endif
+
+    for (i = 0; i < mod_shm->mod_count; ++i) {
+        if ((err_info = sr_shmmod_reboot_init_mod(conn, SR_SHM_MOD_IDX(mod_shm, i), initialized))) {
             return err_info;
         }
     }
@@ -1667,7 +2246,7 @@ sr_shmmod_change_prio(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, sr_d
 
     /* SHM MOD LOCK */
     if ((err_info = sr_shmmod_lock(ly_mod, ds, shm_lock, SR_CHANGE_CB_TIMEOUT, prio_p ? SR_LOCK_READ : SR_LOCK_WRITE,
-            SR_CHANGE_CB_TIMEOUT, conn->cid, 0, ds_plg, 0))) {
+            0, SR_CHANGE_CB_TIMEOUT, conn->cid, 0, ds_plg, 0))) {
         return err_info;
     }
 
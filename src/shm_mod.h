@@ -78,6 +78,21 @@ sr_error_info_t *sr_shmmod_store_modules(sr_shm_t *shm_mod, const struct lyd_nod
  */
 sr_error_info_t *sr_shmmod_ctx_load_modules(sr_mod_shm_t *mod_shm, struct ly_ctx *ly_ctx, const struct ly_set *skip_mod_set);
 
+/**
+ * @brief Load only some modules stored in mod SHM into a context, for a lazy context.
+ *
+ * Loaded are the sysrepo internal modules, @p mod_names, and all the modules they depend on, that depend on them,
+ * or that import them in the module itself or any of its submodules.
+ *
+ * @param[in] mod_shm Mod SHM.
+ * @param[in,out] ly_ctx libyang context to update.
+ * @param[in] mod_names Array of module names to load, not installed modules are ignored.
+ * @param[in] mod_name_count Count of @p mod_names.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmmod_ctx_load_lazy_modules(sr_mod_shm_t *mod_shm, struct ly_ctx *ly_ctx, char **mod_names,
+        uint32_t mod_name_count);
+
 /**
  * @brief Get SHM dependencies of an RPC/action.
  *
@@ -121,11 +136,15 @@ sr_error_info_t *sr_shmmod_collect_deps_lref(const char *target_path, const char
  * @param[in] source_path Source inst-id path.
  * @param[in] default_target_path Optional inst-id default value.
  * @param[in] data Instantiated data.
+ * @param[in] src_mod Module of @p data with the inst-ids, NULL if @p data are not its running data being validated.
+ * Resolved targets of unchanged running inst-ids are cached for it.
+ * @param[in] src_run_data_ver Running data version of @p src_mod the data were loaded from.
  * @param[in,out] mod_info Mod info to add to.
  * @return err_info, NULL on success.
  */
 sr_error_info_t *sr_shmmod_collect_deps_instid(const char *source_path, const char *default_target_path,
-        const struct lyd_node *data, struct sr_mod_info_s *mod_info);
+        const struct lyd_node *data, const struct lys_module *src_mod, uint32_t src_run_data_ver,
+        struct sr_mod_info_s *mod_info);
 
 /**
  * @brief Collect required module dependencies from a SHM dependency array.
@@ -134,11 +153,14 @@ sr_error_info_t *sr_shmmod_collect_deps_instid(const char *source_path, const ch
  * @param[in] shm_deps Array of SHM dependencies.
  * @param[in] shm_dep_count Number of @p shm_deps.
  * @param[in] data Data to look for instance-identifiers in.
+ * @param[in] src_mod Module with the dependencies if @p data are its running data being validated, NULL otherwise.
+ * @param[in] src_run_data_ver Running data version of @p src_mod.
  * @param[in,out] mod_info Mod info to add to.
  * @return err_info, NULL on success.
  */
 sr_error_info_t *sr_shmmod_collect_deps(sr_mod_shm_t *mod_shm, sr_dep_t *shm_deps, uint16_t shm_dep_count,
-        const struct lyd_node *data, struct sr_mod_info_s *mod_info);
+        const struct lyd_node *data, const struct lys_module *src_mod, uint32_t src_run_data_ver,
+        struct sr_mod_info_s *mod_info);
 
 /**
  * @brief Information structure for the SHM module recovery callback.
@@ -246,6 +268,8 @@ sr_error_info_t *sr_shmmod_copy_mod(const struct lys_module *ly_mod, const struc
 /**
  * @brief Initialize datastores after a reboot. Includes calling init callbacks and copying startup DS to running DS.
  *
+ * Modules are initialized in parallel by up to ::SR_DATA_LOAD_THREADS threads, if enabled.
+ *
  * @param[in] conn Connection to use.
  * @param[in] initialized Whether installed modules have already been initialized or not.
  * @return err_info, NULL on success.
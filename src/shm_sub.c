@@ -22,8 +22,12 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/mman.h>
 #include <sys/select.h>
 #include <sys/stat.h>
@@ -58,6 +62,15 @@ struct sr_shmsub_many_info_s {
     sr_error_info_t *cb_err_info;
 };
 
+/**
+ * @brief Results of the XPath filters of change subscriptions evaluated on the diff of an event.
+ */
+struct sr_shmsub_change_filter_s {
+    uint32_t *sub_ids;          /**< IDs of subscriptions with an evaluated filter, indexed as in ext SHM, 0 if none. */
+    uint8_t *valid;             /**< Whether there are some changes for the filter, indexed the same way. */
+    uint32_t count;             /**< Count of the results. */
+};
+
 /**
  * @brief Structure for parallel (for all the modules) module change notifications.
  */
@@ -77,6 +90,7 @@ struct sr_shmsub_many_info_change_s {
     int change_error;
     uint32_t err_priority;
     uint32_t err_subscriber_count;
+    struct sr_shmsub_change_filter_s filter;
 };
 
 /**
@@ -93,6 +107,8 @@ struct sr_shmsub_many_info_oper_get_s {
     sr_error_info_t *cb_err_info;
 
     sr_mod_oper_get_xpath_sub_t *xpath_sub;
+    uint32_t xpath_idx;
+    uint32_t sub_idx;
 };
 
 sr_error_info_t *
@@ -230,7 +246,8 @@ cleanup:
  * @param[in] suffix1 First suffix.
  * @param[in] suffix2 Second suffix, none if set to -1.
  * @param[in,out] shm Mapped SHM.
- * @param[in] new_shm_size Resize SHM to this size, if 0 read the size of the SHM file.
+ * @param[in] new_shm_size Required SHM size, if 0 read the size of the SHM file. The SHM is only resized if it
+ * is too small or unnecessarily big, to a size class so that alternating sizes of the data do not cause remaps.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
@@ -238,6 +255,7 @@ sr_shmsub_data_open_remap(const char *name, const char *suffix1, int64_t suffix2
 {
     sr_error_info_t *err_info = NULL;
     char *path = NULL;
+    size_t cur_size, class_size;
 
     if (shm->fd == -1) {
         assert(name && suffix1);
@@ -255,6 +273,25 @@ sr_shmsub_data_open_remap(const char *name, const char *suffix1, int64_t suffix2
         }
     }
 
+    if (new_shm_size) {
+        /* learn the current size */
+        if (shm->addr) {
+            cur_size = shm->size;
+        } else if ((err_info = sr_file_get_size(shm->fd, &cur_size))) {
+            goto cleanup;
+        }
+
+        /* size class of the required size */
+        for (class_size = SR_SUB_DATA_SHM_MIN_SIZE; class_size < new_shm_size; class_size *= 2) {}
+
+        if ((cur_size >= new_shm_size) && (cur_size / SR_SUB_DATA_SHM_SHRINK_RATIO < class_size)) {
+            /* big enough and not too big, keep the current size */
+            new_shm_size = shm->addr ? shm->size : 0;
+        } else {
+            new_shm_size = class_size;
+        }
+    }
+
     /* map it */
     if ((err_info = sr_shm_remap(shm, new_shm_size))) {
         goto cleanup;
@@ -723,6 +760,7 @@ sr_shmsub_notify_write_event(sr_sub_shm_t *sub_shm, sr_cid_t orig_cid, uint32_t
     }
 
     sub_shm->orig_cid = orig_cid;
+    sr_timeouttime_get(&sub_shm->event_ts, 0);
     ATOMIC_STORE_RELAXED(sub_shm->request_id, request_id);
     ATOMIC_STORE_RELAXED(sub_shm->event, event);
 
@@ -753,6 +791,7 @@ sr_shmsub_notify_write_event(sr_sub_shm_t *sub_shm, sr_cid_t orig_cid, uint32_t
         memcpy(shm_data_ptr, data, data_len);
     }
 
+    SR_TRACE(event_publish, request_id, event, event_desc);
     if (event && event_desc) {
         SR_LOG_INF("EV ORIGIN: \"%s\" \"%s\" ID %" PRIu32 " published.", event_desc, sr_ev2str(event), request_id);
     }
@@ -801,6 +840,7 @@ sr_shmsub_multi_notify_write_event(sr_multi_sub_shm_t *multi_sub_shm, sr_cid_t o
     }
 
     multi_sub_shm->orig_cid = orig_cid;
+    sr_timeouttime_get(&multi_sub_shm->event_ts, 0);
     ATOMIC_STORE_RELAXED(multi_sub_shm->request_id, request_id);
     ATOMIC_STORE_RELAXED(multi_sub_shm->event, event);
     ATOMIC_STORE_RELAXED(multi_sub_shm->priority, priority);
@@ -834,6 +874,7 @@ sr_shmsub_multi_notify_write_event(sr_multi_sub_shm_t *multi_sub_shm, sr_cid_t o
         shm_data_ptr += data_len;
     }
 
+    SR_TRACE(event_publish, request_id, event, event_desc);
     if (event && event_desc) {
         SR_LOG_INF("EV ORIGIN: \"%s\" \"%s\" ID %" PRIu32 " priority %" PRIu32 " for %" PRIu32 " subscribers published.",
                 event_desc, sr_ev2str(event), request_id, priority, subscriber_count);
@@ -877,6 +918,121 @@ sr_shmsub_change_listen_event_is_valid(sr_sub_event_t ev, sr_subscr_options_t su
     return 1;
 }
 
+/**
+ * @brief Whether there is a change (some diff) for a change subscription XPath filter. Evaluated the same way
+ * by the originator and the listener so that both agree on the subscribers of an event.
+ *
+ * @param[in] xpath Subscription XPath, NULL if none.
+ * @param[in] filter Optional compiled filter of @p xpath.
+ * @param[in] diff Full diff for the module.
+ * @return 0 if not, non-zero if there is.
+ */
+static int
+sr_shmsub_change_filter_is_valid(const char *xpath, const sr_xpath_filter_t *filter, const struct lyd_node *diff)
+{
+    sr_error_info_t *err_info = NULL;
+    struct ly_set *set;
+    const struct lyd_node *elem;
+    uint32_t i;
+    enum edit_op op;
+    int ret = 0;
+
+    if (!xpath) {
+        return 1;
+    }
+
+    if ((err_info = sr_xpath_filter_find(filter, xpath, diff, &set))) {
+        /* cannot be decided, the subscriber is notified */
+        sr_errinfo_free(&err_info);
+        return 1;
+    }
+
+    for (i = 0; i < set->count; ++i) {
+        LYD_TREE_DFS_BEGIN(set->dnodes[i], elem) {
+            op = sr_edit_diff_find_oper(elem, 1, NULL);
+            assert(op);
+            if (op != EDIT_NONE) {
+                ret = 1;
+                break;
+            }
+            LYD_TREE_DFS_END(set->dnodes[i], elem);
+        }
+        if (ret) {
+            break;
+        }
+    }
+    ly_set_free(set, NULL);
+
+    return ret;
+}
+
+/**
+ * @brief Whether there is a change (some diff) for an ext SHM change subscription.
+ *
+ * The filter of each subscription is evaluated only once for an event, the result is cached in @p filter.
+ * EXT READ lock is expected to be held.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] shm_subs Ext SHM change subscriptions.
+ * @param[in] idx Index of the subscription in @p shm_subs.
+ * @param[in] diff Full diff for the module.
+ * @param[in,out] filter Filter results of @p diff.
+ * @return 0 if not, non-zero if there is.
+ */
+static int
+sr_shmsub_change_notify_filter_is_valid(sr_conn_ctx_t *conn, const sr_mod_change_sub_t *shm_subs, uint32_t idx,
+        const struct lyd_node *diff, struct sr_shmsub_change_filter_s *filter)
+{
+    const sr_mod_change_sub_t *shm_sub = &shm_subs[idx];
+    uint32_t *sub_ids;
+    uint8_t *valid;
+    int ret;
+
+    if (!shm_sub->xpath) {
+        return 1;
+    }
+
+    if ((idx < filter->count) && (filter->sub_ids[idx] == shm_sub->sub_id)) {
+        /* already evaluated */
+        return filter->valid[idx];
+    }
+
+    ret = sr_shmsub_change_filter_is_valid(conn->ext_shm.addr + shm_sub->xpath, NULL, diff);
+
+    if (idx >= filter->count) {
+        /* make room for the result, it is just not cached on failure */
+        sub_ids = realloc(filter->sub_ids, (idx + 1) * sizeof *sub_ids);
+        if (!sub_ids) {
+            return ret;
+        }
+        filter->sub_ids = sub_ids;
+        valid = realloc(filter->valid, (idx + 1) * sizeof *valid);
+        if (!valid) {
+            return ret;
+        }
+        filter->valid = valid;
+        memset(filter->sub_ids + filter->count, 0, (idx + 1 - filter->count) * sizeof *sub_ids);
+        filter->count = idx + 1;
+    }
+    filter->sub_ids[idx] = shm_sub->sub_id;
+    filter->valid[idx] = ret;
+
+    return ret;
+}
+
+/**
+ * @brief Free the cached filter results of an event.
+ *
+ * @param[in] filter Filter results to free.
+ */
+static void
+sr_shmsub_change_notify_filter_clear(struct sr_shmsub_change_filter_s *filter)
+{
+    free(filter->sub_ids);
+    free(filter->valid);
+    memset(filter, 0, sizeof *filter);
+}
+
 /**
  * @brief Learn whether there is a subscription for a change event.
  *
@@ -884,12 +1040,16 @@ sr_shmsub_change_listen_event_is_valid(sr_sub_event_t ev, sr_subscr_options_t su
  * @param[in] mod Mod info module to use.
  * @param[in] ds Datastore.
  * @param[in] ev Event.
+ * @param[in] diff Full diff of the event, subscriptions with no changes for their XPath filter are skipped.
+ * @param[in,out] filter Filter results of @p diff.
+ * @param[in] count_filtered Whether to count the skipped subscriptions as filtered-out.
  * @param[out] max_priority_p Highest priority among the valid subscribers.
  * @return 0 if not, non-zero if there is.
  */
 static int
 sr_shmsub_change_notify_has_subscription(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod, sr_datastore_t ds,
-        sr_sub_event_t ev, uint32_t *max_priority_p)
+        sr_sub_event_t ev, const struct lyd_node *diff, struct sr_shmsub_change_filter_s *filter, int count_filtered,
+        uint32_t *max_priority_p)
 {
     sr_error_info_t *err_info = NULL;
     int has_sub = 0;
@@ -923,6 +1083,15 @@ sr_shmsub_change_notify_has_subscription(sr_conn_ctx_t *conn, struct sr_mod_info
 
         /* check whether the event is valid for the specific subscription or will be ignored */
         if (sr_shmsub_change_listen_event_is_valid(ev, shm_sub[i].opts)) {
+            if (!sr_shmsub_change_notify_filter_is_valid(conn, shm_sub, i, diff, filter)) {
+                /* filtered out, the subscriber is not notified at all */
+                if (count_filtered) {
+                    ATOMIC_INC_RELAXED(shm_sub[i].filtered_out);
+                }
+                ++i;
+                continue;
+            }
+
             has_sub = 1;
             if (shm_sub[i].priority > *max_priority_p) {
                 *max_priority_p = shm_sub[i].priority;
@@ -945,20 +1114,24 @@ sr_shmsub_change_notify_has_subscription(sr_conn_ctx_t *conn, struct sr_mod_info
  * @param[in] mod Mod info module to use.
  * @param[in] ds Datastore.
  * @param[in] ev Change event.
+ * @param[in] diff Full diff of the event, subscriptions with no changes for their XPath filter are skipped.
+ * @param[in,out] filter Filter results of @p diff.
  * @param[in] last_priority Last priorty of a subscriber.
  * @param[out] next_priorty_p Next priorty of a subsciber(s).
  * @param[out] sub_count_p Number of subscribers with this priority.
  * @param[out] opts_p Optional options of all subscribers with this priority.
+ * @param[out] parallel_p Optional flag whether the parallel group of subscribers is notified with this priority.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
 sr_shmsub_change_notify_next_subscription(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod, sr_datastore_t ds,
-        sr_sub_event_t ev, uint32_t last_priority, uint32_t *next_priority_p, uint32_t *sub_count_p, int *opts_p)
+        sr_sub_event_t ev, const struct lyd_node *diff, struct sr_shmsub_change_filter_s *filter,
+        uint32_t last_priority, uint32_t *next_priority_p, uint32_t *sub_count_p, int *opts_p, int *parallel_p)
 {
     sr_error_info_t *err_info = NULL;
-    uint32_t i;
+    uint32_t i, group_priority = 0, group_count = 0;
     sr_mod_change_sub_t *shm_sub;
-    int opts = 0;
+    int opts = 0, group_opts = 0, parallel = 0;
 
     /* EXT READ LOCK */
     if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_READ, 0, __func__))) {
@@ -984,8 +1157,23 @@ sr_shmsub_change_notify_next_subscription(sr_conn_ctx_t *conn, struct sr_mod_inf
             continue;
         }
 
+        if (shm_sub[i].opts & SR_SUBSCR_PARALLEL) {
+            /* member of the parallel group, notified all at once with the highest priority of the group */
+            if (sr_shmsub_change_listen_event_is_valid(ev, shm_sub[i].opts) &&
+                    sr_shmsub_change_notify_filter_is_valid(conn, shm_sub, i, diff, filter)) {
+                if (!group_count || (group_priority < shm_sub[i].priority)) {
+                    group_priority = shm_sub[i].priority;
+                }
+                ++group_count;
+                group_opts |= shm_sub[i].opts;
+            }
+            ++i;
+            continue;
+        }
+
         /* valid subscription */
-        if (sr_shmsub_change_listen_event_is_valid(ev, shm_sub[i].opts) && (last_priority > shm_sub[i].priority)) {
+        if (sr_shmsub_change_listen_event_is_valid(ev, shm_sub[i].opts) && (last_priority > shm_sub[i].priority) &&
+                sr_shmsub_change_notify_filter_is_valid(conn, shm_sub, i, diff, filter)) {
             /* a subscription that was not notified yet */
             if (*sub_count_p) {
                 if (*next_priority_p < shm_sub[i].priority) {
@@ -1009,9 +1197,28 @@ sr_shmsub_change_notify_next_subscription(sr_conn_ctx_t *conn, struct sr_mod_inf
         ++i;
     }
 
+    if (group_count && (last_priority > group_priority)) {
+        /* the parallel group was not notified yet */
+        if (!*sub_count_p || (*next_priority_p < group_priority)) {
+            /* the group is notified alone */
+            *next_priority_p = group_priority;
+            *sub_count_p = group_count;
+            opts = group_opts;
+            parallel = 1;
+        } else if (*next_priority_p == group_priority) {
+            /* the group is notified together with the subscriptions of the same priority */
+            *sub_count_p += group_count;
+            opts |= group_opts;
+            parallel = 1;
+        }
+    }
+
     if (opts_p) {
         *opts_p = opts;
     }
+    if (parallel_p) {
+        *parallel_p = parallel;
+    }
 
     /* EXT READ UNLOCK */
     sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 0, __func__);
@@ -1019,36 +1226,156 @@ sr_shmsub_change_notify_next_subscription(sr_conn_ctx_t *conn, struct sr_mod_inf
     return NULL;
 }
 
+/**
+ * @brief Event pipes kept opened for writing.
+ */
+static struct {
+    struct {
+        uint32_t evpipe_num;    /**< event pipe number */
+        int fd;                 /**< event pipe opened for writing */
+    } pipes[SR_EVPIPE_CACHE_SIZE];
+    uint32_t count;             /**< number of cached pipes */
+    uint32_t next;              /**< index of the cached pipe to replace next */
+    pthread_mutex_t lock;       /**< cache lock */
+} sr_evpipe_cache = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+/**
+ * @brief Ignore SIGPIPE if it has the default disposition.
+ */
+static void
+sr_shmsub_evpipe_sigpipe_ignore(void)
+{
+    struct sigaction action;
+
+    if (sigaction(SIGPIPE, NULL, &action) == -1) {
+        SR_LOG_WRN("Failed to learn SIGPIPE disposition (%s).", strerror(errno));
+        return;
+    }
+
+    if (!(action.sa_flags & SA_SIGINFO) && (action.sa_handler == SIG_DFL)) {
+        /* writing into an event pipe without a reader must not terminate the process */
+        action.sa_handler = SIG_IGN;
+        if (sigaction(SIGPIPE, &action, NULL) == -1) {
+            SR_LOG_WRN("Failed to ignore SIGPIPE (%s).", strerror(errno));
+        }
+    }
+}
+
+void
+sr_shmsub_evpipe_init(void)
+{
+    static pthread_once_t sigpipe_once = PTHREAD_ONCE_INIT;
+
+    pthread_once(&sigpipe_once, sr_shmsub_evpipe_sigpipe_ignore);
+}
+
+/**
+ * @brief Write one byte with the event kinds into an event pipe.
+ *
+ * @param[in] fd Event pipe opened for writing.
+ * @param[in] events Kinds of the new events, bitwise OR-ed SR_EVPIPE_EV_* flags.
+ * @param[out] closed Set if the pipe has no reader anymore.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_evpipe_write(int fd, uint8_t events, int *closed)
+{
+    sr_error_info_t *err_info = NULL;
+    char buf[1];
+    int ret;
+
+    *closed = 0;
+    buf[0] = (char)events;
+
+    do {
+        ret = write(fd, buf, 1);
+    } while (!ret);
+    if (ret == -1) {
+        if (errno == EPIPE) {
+            *closed = 1;
+        } else {
+            SR_ERRINFO_SYSERRNO(&err_info, "write");
+        }
+    }
+
+    return err_info;
+}
+
 sr_error_info_t *
-sr_shmsub_notify_evpipe(uint32_t evpipe_num)
+sr_shmsub_notify_evpipe(uint32_t evpipe_num, uint8_t events)
 {
     sr_error_info_t *err_info = NULL;
-    char *path = NULL, buf[1] = {0};
-    int fd = -1, ret;
+    char *path = NULL;
+    int fd = -1, closed;
+    uint32_t i;
+
+    SR_TRACE(event_wakeup, evpipe_num);
+
+    /* CACHE LOCK */
+    pthread_mutex_lock(&sr_evpipe_cache.lock);
+
+    /* try to use a cached pipe */
+    for (i = 0; i < sr_evpipe_cache.count; ++i) {
+        if (sr_evpipe_cache.pipes[i].evpipe_num == evpipe_num) {
+            break;
+        }
+    }
+    if (i < sr_evpipe_cache.count) {
+        if ((err_info = sr_shmsub_evpipe_write(sr_evpipe_cache.pipes[i].fd, events, &closed))) {
+            goto cleanup;
+        }
+        if (!closed) {
+            /* success */
+            goto cleanup;
+        }
+
+        /* the subscriber is gone, the pipe may have been created again so remove it and try to open it */
+        close(sr_evpipe_cache.pipes[i].fd);
+        --sr_evpipe_cache.count;
+        if (i < sr_evpipe_cache.count) {
+            sr_evpipe_cache.pipes[i] = sr_evpipe_cache.pipes[sr_evpipe_cache.count];
+        }
+        if (sr_evpipe_cache.next > sr_evpipe_cache.count) {
+            sr_evpipe_cache.next = 0;
+        }
+    }
 
     /* get path to the pipe */
     if ((err_info = sr_path_evpipe(evpipe_num, &path))) {
         goto cleanup;
     }
 
-    /* open pipe for writing */
-    if ((fd = sr_open(path, O_WRONLY | O_NONBLOCK, 0)) == -1) {
+    /* open pipe for writing, it is cached so it must not leak into executed child processes */
+    if ((fd = sr_open(path, O_WRONLY | O_NONBLOCK | O_CLOEXEC, 0)) == -1) {
         sr_errinfo_new(&err_info, SR_ERR_SYS, "Opening \"%s\" for writing failed (%s).", path, strerror(errno));
         goto cleanup;
     }
 
-    /* write one arbitrary byte */
-    do {
-        ret = write(fd, buf, 1);
-    } while (!ret);
-    if (ret == -1) {
-        SR_ERRINFO_SYSERRNO(&err_info, "write");
+    /* write */
+    if ((err_info = sr_shmsub_evpipe_write(fd, events, &closed))) {
+        goto cleanup;
+    }
+    if (closed) {
+        sr_errinfo_new(&err_info, SR_ERR_SYS, "Event pipe \"%s\" closed by the reader.", path);
         goto cleanup;
     }
 
-    /* success */
+    /* cache it */
+    if (sr_evpipe_cache.count < SR_EVPIPE_CACHE_SIZE) {
+        i = sr_evpipe_cache.count++;
+    } else {
+        i = sr_evpipe_cache.next;
+        sr_evpipe_cache.next = (sr_evpipe_cache.next + 1) % SR_EVPIPE_CACHE_SIZE;
+        close(sr_evpipe_cache.pipes[i].fd);
+    }
+    sr_evpipe_cache.pipes[i].evpipe_num = evpipe_num;
+    sr_evpipe_cache.pipes[i].fd = fd;
+    fd = -1;
 
 cleanup:
+    /* CACHE UNLOCK */
+    pthread_mutex_unlock(&sr_evpipe_cache.lock);
+
     if (fd > -1) {
         close(fd);
     }
@@ -1063,12 +1390,15 @@ cleanup:
  * @param[in] mod Mod info module to use.
  * @param[in] ds Datastore.
  * @param[in] ev Change event.
- * @param[in] priority Priority of the subscribers with new event.
+ * @param[in] diff Full diff of the event, subscriptions with no changes for their XPath filter are not notified.
+ * @param[in,out] filter Filter results of @p diff.
+ * @param[in] priority Priority of the subscribers with new event, NULL for all the subscribers.
+ * @param[in] parallel Whether the parallel group of subscribers has the new event, too.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
 sr_shmsub_change_notify_evpipe(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod, sr_datastore_t ds, sr_sub_event_t ev,
-        uint32_t priority)
+        const struct lyd_node *diff, struct sr_shmsub_change_filter_s *filter, const uint32_t *priority, int parallel)
 {
     sr_error_info_t *err_info = NULL;
     sr_mod_change_sub_t *shm_sub;
@@ -1091,8 +1421,9 @@ sr_shmsub_change_notify_evpipe(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mo
         }
 
         /* valid subscription */
-        if (shm_sub[i].priority == priority) {
-            if ((err_info = sr_shmsub_notify_evpipe(shm_sub[i].evpipe_num))) {
+        if ((!priority || ((shm_sub[i].opts & SR_SUBSCR_PARALLEL) ? parallel : (shm_sub[i].priority == *priority))) &&
+                sr_shmsub_change_notify_filter_is_valid(conn, shm_sub, i, diff, filter)) {
+            if ((err_info = sr_shmsub_notify_evpipe(shm_sub[i].evpipe_num, SR_EVPIPE_EV_CHANGE))) {
                 goto cleanup;
             }
         }
@@ -1105,6 +1436,31 @@ cleanup:
     return err_info;
 }
 
+/**
+ * @brief Print a diff to be written into change subscription SHM.
+ *
+ * @param[in] mod_info Mod info with the connection and datastore.
+ * @param[in] diff Diff to print.
+ * @param[out] data Printed change log or LYB diff.
+ * @param[out] data_len Length of @p data.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_change_notify_print_diff(const struct sr_mod_info_s *mod_info, const struct lyd_node *diff, char **data,
+        uint32_t *data_len)
+{
+    sr_error_info_t *err_info = NULL;
+
+    if ((mod_info->conn->opts & SR_CONN_CHANGE_LOG) && SR_IS_CONVENTIONAL_DS(mod_info->ds)) {
+        /* compact change log */
+        if ((err_info = sr_change_log_print(diff, data, data_len)) || *data) {
+            return err_info;
+        }
+    }
+
+    return sr_lyd_print_lyb(diff, data, data_len);
+}
+
 /**
  * @brief Learn whether the diff for the module includes some node changes and not just dflt flag modifications.
  *
@@ -1142,13 +1498,14 @@ sr_shmsub_change_notify_update(struct sr_mod_info_s *mod_info, const char *orig_
         uint32_t timeout_ms, struct lyd_node **update_edit, sr_error_info_t **cb_err_info)
 {
     sr_error_info_t *err_info = NULL;
-    sr_multi_sub_shm_t *multi_sub_shm;
+    struct sr_shmsub_many_info_change_s *notify_subs = NULL, *nsub;
+    struct sr_shmsub_change_filter_s filter = {0};
     struct sr_mod_info_mod_s *mod = NULL;
     struct lyd_node *edit;
-    uint32_t cur_priority, subscriber_count, diff_lyb_len, *aux = NULL;
+    uint32_t notify_count = 0, max_priority, subscriber_count, diff_lyb_len, *aux = NULL, i;
     char *diff_lyb = NULL;
+    int pending_events;
     struct ly_ctx *ly_ctx;
-    sr_shm_t shm_sub = SR_SHM_INITIALIZER, shm_data_sub = SR_SHM_INITIALIZER;
     sr_cid_t cid;
 
     assert(mod_info->diff);
@@ -1163,134 +1520,180 @@ sr_shmsub_change_notify_update(struct sr_mod_info_s *mod_info, const char *orig_
         }
 
         /* just find out whether there are any subscriptions and if so, what is the highest priority */
-        if (!sr_shmsub_change_notify_has_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_UPDATE, &cur_priority)) {
+        if (!sr_shmsub_change_notify_has_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_UPDATE,
+                mod_info->diff, &filter, 1, &max_priority)) {
+            sr_shmsub_change_notify_filter_clear(&filter);
             continue;
         }
 
-        /* correctly start the loop, with fake last priority 1 higher than the actual highest */
-        if ((err_info = sr_shmsub_change_notify_next_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_UPDATE,
-                cur_priority + 1, &cur_priority, &subscriber_count, NULL))) {
-            goto cleanup;
-        }
+        notify_subs = sr_realloc(notify_subs, (notify_count + 1) * sizeof *notify_subs);
+        SR_CHECK_MEM_GOTO(!notify_subs, err_info, cleanup);
 
-        if (!subscriber_count) {
-            /* the subscription(s) was recovered just now so there are not any */
-            continue;
-        }
+        /* init, set max priority + 1 so that max priority subscription is the first returned */
+        memset(&notify_subs[notify_count], 0, sizeof *notify_subs);
+        notify_subs[notify_count].mod = mod;
+        notify_subs[notify_count].cur_priority = max_priority + 1;
+        notify_subs[notify_count].shm_sub.fd = -1;
+        notify_subs[notify_count].shm_data_sub.fd = -1;
+        notify_subs[notify_count].filter = filter;
+        memset(&filter, 0, sizeof filter);
+        ++notify_count;
+    }
 
-        /* prepare diff to write into SHM */
-        if (!diff_lyb && lyd_print_mem(&diff_lyb, mod_info->diff, LYD_LYB, LYD_PRINT_SHRINK | LYD_PRINT_WITHSIBLINGS)) {
-            sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
-            SR_ERRINFO_INT(&err_info);
-            goto cleanup;
-        }
-        diff_lyb_len = lyd_lyb_data_length(diff_lyb);
+    if (!notify_count) {
+        /* nothing to do */
+        goto cleanup;
+    }
 
-        /* open sub SHM and map it */
-        if ((err_info = sr_shmsub_open_map(mod->ly_mod->name, sr_ds2str(mod_info->ds), -1, &shm_sub))) {
-            goto cleanup;
-        }
-        multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub.addr;
+    /* prepare diff to write into SHM */
+    if ((err_info = sr_shmsub_change_notify_print_diff(mod_info, mod_info->diff, &diff_lyb, &diff_lyb_len))) {
+        goto cleanup;
+    }
 
-        /* SUB WRITE LOCK */
-        if ((err_info = sr_shmsub_notify_new_wrlock((sr_sub_shm_t *)multi_sub_shm, mod->ly_mod->name, 0, cid))) {
-            goto cleanup;
-        }
+    do {
+        /* the "update" events of all the modules are independent so generate them at once */
+        pending_events = 0;
+        for (i = 0; i < notify_count; ++i) {
+            nsub = &notify_subs[i];
 
-        /* open sub data SHM */
-        if ((err_info = sr_shmsub_data_open_remap(mod->ly_mod->name, sr_ds2str(mod_info->ds), -1, &shm_data_sub, 0))) {
-            goto cleanup_wrunlock;
-        }
+            /* find out what is the next priority and how many subscribers have it */
+            if ((err_info = sr_shmsub_change_notify_next_subscription(mod_info->conn, nsub->mod, mod_info->ds,
+                    SR_SUB_EV_UPDATE, mod_info->diff, &nsub->filter, nsub->cur_priority, &nsub->cur_priority,
+                    &subscriber_count, NULL, NULL))) {
+                goto cleanup;
+            }
+
+            if (!subscriber_count) {
+                /* no more subscriptions (or recovered just now) */
+                continue;
+            }
 
-        do {
             /* there cannot be more subscribers on one module with the same priority */
             assert(subscriber_count == 1);
+            nsub->pending_event = 1;
+            pending_events = 1;
 
-            /* write "update" event */
-            if (!mod->request_id) {
-                mod->request_id = ++multi_sub_shm->request_id;
-            }
-            if ((err_info = sr_shmsub_multi_notify_write_event(multi_sub_shm, cid, mod->request_id, cur_priority,
-                    SR_SUB_EV_UPDATE, orig_name, orig_data, subscriber_count, &shm_data_sub, NULL, diff_lyb, diff_lyb_len,
-                    mod->ly_mod->name))) {
-                goto cleanup_wrunlock;
+            if (nsub->shm_sub.fd == -1) {
+                /* open sub SHM and map it */
+                if ((err_info = sr_shmsub_open_map(nsub->mod->ly_mod->name, sr_ds2str(mod_info->ds), -1, &nsub->shm_sub))) {
+                    goto cleanup;
+                }
+                nsub->sub_shm = (sr_sub_shm_t *)nsub->shm_sub.addr;
             }
 
-            /* notify using event pipe and wait until all the subscribers have processed the event */
-            if ((err_info = sr_shmsub_change_notify_evpipe(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_UPDATE,
-                    cur_priority))) {
-                goto cleanup_wrunlock;
+            /* SUB WRITE LOCK */
+            if ((err_info = sr_shmsub_notify_new_wrlock(nsub->sub_shm, nsub->mod->ly_mod->name, 0, cid))) {
+                goto cleanup;
             }
+            nsub->lock = SR_LOCK_WRITE;
 
-            /* wait until the event is processed */
-            if ((err_info = sr_shmsub_notify_wait_wr((sr_sub_shm_t *)multi_sub_shm, SR_SUB_EV_ERROR, 0, cid,
-                    &shm_data_sub, timeout_ms, cb_err_info))) {
-                if (err_info->err[0].err_code == SR_ERR_TIME_OUT) {
+            if (nsub->shm_data_sub.fd == -1) {
+                /* open sub data SHM */
+                if ((err_info = sr_shmsub_data_open_remap(nsub->mod->ly_mod->name, sr_ds2str(mod_info->ds), -1,
+                        &nsub->shm_data_sub, 0))) {
                     goto cleanup;
-                } else {
-                    goto cleanup_wrunlock;
                 }
             }
 
-            if (*cb_err_info) {
-                /* failed callback or timeout */
-                SR_LOG_WRN("EV ORIGIN: \"%s\" \"%s\" ID %" PRIu32 " priority %" PRIu32 " failed (%s).", mod->ly_mod->name,
-                        sr_ev2str(SR_SUB_EV_UPDATE), mod->request_id, cur_priority, sr_strerror((*cb_err_info)->err[0].err_code));
-                goto cleanup_wrunlock;
-            } else {
-                SR_LOG_INF("EV ORIGIN: \"%s\" \"%s\" ID %" PRIu32 " priority %" PRIu32 " succeeded.", mod->ly_mod->name,
-                        sr_ev2str(SR_SUB_EV_UPDATE), mod->request_id, cur_priority);
+            /* write "update" event */
+            if (!nsub->mod->request_id) {
+                nsub->mod->request_id = ++nsub->sub_shm->request_id;
             }
-
-            assert(multi_sub_shm->event == SR_SUB_EV_SUCCESS);
-
-            /* parse updated edit */
-            if (lyd_parse_data_mem(ly_ctx, shm_data_sub.addr, LYD_LYB, LYD_PARSE_STRICT | LYD_PARSE_OPAQ | LYD_PARSE_ONLY,
-                    0, &edit)) {
-                sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
-                sr_errinfo_new(&err_info, SR_ERR_VALIDATION_FAILED, "Failed to parse \"update\" edit.");
-                goto cleanup_wrunlock;
+            ATOMIC_STORE_RELAXED(((sr_multi_sub_shm_t *)nsub->shm_sub.addr)->parallel, 0);
+            ATOMIC_STORE_RELAXED(((sr_multi_sub_shm_t *)nsub->shm_sub.addr)->async, 0);
+            if ((err_info = sr_shmsub_multi_notify_write_event((sr_multi_sub_shm_t *)nsub->shm_sub.addr, cid,
+                    nsub->mod->request_id, nsub->cur_priority, SR_SUB_EV_UPDATE, orig_name, orig_data, subscriber_count,
+                    &nsub->shm_data_sub, NULL, diff_lyb, diff_lyb_len, nsub->mod->ly_mod->name))) {
+                goto cleanup;
             }
 
-            /* event fully processed */
-            multi_sub_shm->event = SR_SUB_EV_NONE;
-
-            /* collect new edits (there may not be any) */
-            if (!*update_edit) {
-                *update_edit = edit;
-            } else if (edit) {
-                if (lyd_insert_sibling(*update_edit, edit, update_edit)) {
-                    sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
-                    goto cleanup_wrunlock;
-                }
+            /* notify the subscribers using an event pipe */
+            if ((err_info = sr_shmsub_change_notify_evpipe(mod_info->conn, nsub->mod, mod_info->ds, SR_SUB_EV_UPDATE,
+                    mod_info->diff, &nsub->filter, &nsub->cur_priority, 0))) {
+                goto cleanup;
             }
+        }
+        if (!pending_events) {
+            /* all the events processed */
+            break;
+        }
 
-            /* find out what is the next priority and how many subscribers have it */
-            if ((err_info = sr_shmsub_change_notify_next_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_UPDATE,
-                    cur_priority, &cur_priority, &subscriber_count, NULL))) {
-                goto cleanup_wrunlock;
+        /* wait until the events are processed */
+        if ((err_info = sr_shmsub_notify_many_wait_wr((struct sr_shmsub_many_info_s *)notify_subs, sizeof *notify_subs,
+                notify_count, SR_SUB_EV_ERROR, 0, cid, timeout_ms))) {
+            goto cleanup;
+        }
+
+        for (i = 0; i < notify_count; ++i) {
+            nsub = &notify_subs[i];
+            if (!nsub->pending_event) {
+                continue;
             }
-        } while (subscriber_count);
 
-        /* SUB WRITE UNLOCK */
-        sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, cid, __func__);
+            assert(nsub->lock == SR_LOCK_WRITE);
 
-        sr_shm_clear(&shm_sub);
-        sr_shm_clear(&shm_data_sub);
-    }
+            if (nsub->cb_err_info) {
+                /* failed callback or timeout */
+                SR_LOG_WRN("EV ORIGIN: \"%s\" \"%s\" ID %" PRIu32 " priority %" PRIu32 " failed (%s).",
+                        nsub->mod->ly_mod->name, sr_ev2str(SR_SUB_EV_UPDATE), nsub->mod->request_id, nsub->cur_priority,
+                        sr_strerror(nsub->cb_err_info->err[0].err_code));
 
-    /* success */
-    goto cleanup;
+                /* merge the error */
+                sr_errinfo_merge(cb_err_info, nsub->cb_err_info);
+                nsub->cb_err_info = NULL;
+            } else {
+                SR_LOG_INF("EV ORIGIN: \"%s\" \"%s\" ID %" PRIu32 " priority %" PRIu32 " succeeded.",
+                        nsub->mod->ly_mod->name, sr_ev2str(SR_SUB_EV_UPDATE), nsub->mod->request_id, nsub->cur_priority);
 
-cleanup_wrunlock:
-    /* SUB WRITE UNLOCK */
-    sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, cid, __func__);
+                assert(nsub->sub_shm->event == SR_SUB_EV_SUCCESS);
+
+                /* parse updated edit */
+                if (lyd_parse_data_mem(ly_ctx, nsub->shm_data_sub.addr, LYD_LYB,
+                        LYD_PARSE_STRICT | LYD_PARSE_OPAQ | LYD_PARSE_ONLY, 0, &edit)) {
+                    sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+                    sr_errinfo_new(&err_info, SR_ERR_VALIDATION_FAILED, "Failed to parse \"update\" edit.");
+                    goto cleanup;
+                }
+
+                /* event fully processed */
+                nsub->sub_shm->event = SR_SUB_EV_NONE;
+
+                /* collect new edits (there may not be any) */
+                if (!*update_edit) {
+                    *update_edit = edit;
+                } else if (edit) {
+                    if (lyd_insert_sibling(*update_edit, edit, update_edit)) {
+                        sr_errinfo_new_ly(&err_info, ly_ctx, NULL);
+                        goto cleanup;
+                    }
+                }
+            }
+
+            /* SUB WRITE UNLOCK */
+            sr_rwunlock(&nsub->sub_shm->lock, 0, SR_LOCK_WRITE, cid, __func__);
+            nsub->lock = SR_LOCK_NONE;
+            nsub->pending_event = 0;
+        }
+
+        /* stop processing if an error occurred */
+    } while (!*cb_err_info);
 
 cleanup:
+    for (i = 0; i < notify_count; ++i) {
+        if (notify_subs[i].lock) {
+            /* SUB UNLOCK */
+            sr_rwunlock(&notify_subs[i].sub_shm->lock, 0, notify_subs[i].lock, cid, __func__);
+        }
+        sr_errinfo_free(&notify_subs[i].cb_err_info);
+        sr_shm_clear(&notify_subs[i].shm_sub);
+        sr_shm_clear(&notify_subs[i].shm_data_sub);
+        sr_shmsub_change_notify_filter_clear(&notify_subs[i].filter);
+    }
+    sr_shmsub_change_notify_filter_clear(&filter);
+
     free(aux);
     free(diff_lyb);
-    sr_shm_clear(&shm_sub);
-    sr_shm_clear(&shm_data_sub);
+    free(notify_subs);
     if (err_info || *cb_err_info) {
         lyd_free_all(*update_edit);
         *update_edit = NULL;
@@ -1410,9 +1813,10 @@ sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info, const char *orig_
     sr_error_info_t *err_info = NULL;
     uint32_t notify_count = 0, max_priority, cur_mpriority, diff_lyb_len, *aux = NULL, i, subscriber_count;
     struct sr_shmsub_many_info_change_s *notify_subs = NULL, *nsub;
+    struct sr_shmsub_change_filter_s filter = {0};
     struct sr_mod_info_mod_s *mod = NULL;
     char *diff_lyb = NULL;
-    int opts, pending_events;
+    int opts, parallel, pending_events;
     sr_cid_t cid;
 
     cid = mod_info->conn->cid;
@@ -1424,14 +1828,16 @@ sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info, const char *orig_
         }
 
         /* find out whether there are any subscriptions and if so, what is the highest priority */
-        if (!sr_shmsub_change_notify_has_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_CHANGE, &max_priority)) {
+        if (!sr_shmsub_change_notify_has_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_CHANGE,
+                mod_info->diff, &filter, 1, &max_priority)) {
             if (!sr_shmsub_change_notify_has_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_DONE,
-                    &max_priority)) {
+                    mod_info->diff, &filter, 0, &max_priority)) {
                 if (mod_info->ds == SR_DS_RUNNING) {
                     SR_LOG_INF("There are no subscribers for changes of the module \"%s\" in %s DS.",
                             mod->ly_mod->name, sr_ds2str(mod_info->ds));
                 }
             }
+            sr_shmsub_change_notify_filter_clear(&filter);
             continue;
         }
 
@@ -1444,6 +1850,8 @@ sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info, const char *orig_
         notify_subs[notify_count].cur_priority = max_priority + 1;
         notify_subs[notify_count].shm_sub.fd = -1;
         notify_subs[notify_count].shm_data_sub.fd = -1;
+        notify_subs[notify_count].filter = filter;
+        memset(&filter, 0, sizeof filter);
         ++notify_count;
     }
 
@@ -1456,7 +1864,7 @@ sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info, const char *orig_
     sr_shmsub_change_notify_nsubs_set_mod_prio(notify_subs, notify_count, mod_info->ds, &cur_mpriority);
 
     /* prepare the diff to write into subscription SHM */
-    if ((err_info = sr_lyd_print_lyb(mod_info->diff, &diff_lyb, &diff_lyb_len))) {
+    if ((err_info = sr_shmsub_change_notify_print_diff(mod_info, mod_info->diff, &diff_lyb, &diff_lyb_len))) {
         goto cleanup;
     }
 
@@ -1471,7 +1879,8 @@ sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info, const char *orig_
 
             /* get next subscriber(s) priority and subscriber count */
             if ((err_info = sr_shmsub_change_notify_next_subscription(mod_info->conn, nsub->mod, mod_info->ds,
-                    SR_SUB_EV_CHANGE, nsub->cur_priority, &nsub->cur_priority, &subscriber_count, &opts))) {
+                    SR_SUB_EV_CHANGE, mod_info->diff, &nsub->filter, nsub->cur_priority, &nsub->cur_priority,
+                    &subscriber_count, &opts, &parallel))) {
                 goto cleanup;
             }
 
@@ -1504,6 +1913,8 @@ sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info, const char *orig_
             if (!nsub->mod->request_id) {
                 nsub->mod->request_id = ++nsub->sub_shm->request_id;
             }
+            ATOMIC_STORE_RELAXED(((sr_multi_sub_shm_t *)nsub->shm_sub.addr)->parallel, parallel);
+            ATOMIC_STORE_RELAXED(((sr_multi_sub_shm_t *)nsub->shm_sub.addr)->async, 0);
             if ((err_info = sr_shmsub_multi_notify_write_event((sr_multi_sub_shm_t *)nsub->shm_sub.addr, cid,
                     nsub->mod->request_id, nsub->cur_priority, SR_SUB_EV_CHANGE, orig_name, orig_data, subscriber_count,
                     &nsub->shm_data_sub, NULL, diff_lyb, diff_lyb_len, nsub->mod->ly_mod->name))) {
@@ -1512,7 +1923,7 @@ sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info, const char *orig_
 
             /* notify the subscribers using an event pipe */
             if ((err_info = sr_shmsub_change_notify_evpipe(mod_info->conn, nsub->mod, mod_info->ds, SR_SUB_EV_CHANGE,
-                    nsub->cur_priority))) {
+                    mod_info->diff, &nsub->filter, &nsub->cur_priority, parallel))) {
                 goto cleanup;
             }
         }
@@ -1572,7 +1983,9 @@ cleanup:
         }
         sr_shm_clear(&notify_subs[i].shm_sub);
         sr_shm_clear(&notify_subs[i].shm_data_sub);
+        sr_shmsub_change_notify_filter_clear(&notify_subs[i].filter);
     }
+    sr_shmsub_change_notify_filter_clear(&filter);
 
     free(aux);
     free(diff_lyb);
@@ -1588,11 +2001,14 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, const char *
     struct sr_mod_info_mod_s *mod = NULL;
     uint32_t notify_count = 0, max_priority, cur_mpriority, diff_lyb_len, *aux = NULL, i, subscriber_count;
     struct sr_shmsub_many_info_change_s *notify_subs = NULL, *nsub;
+    struct sr_shmsub_change_filter_s filter = {0};
     char *diff_lyb = NULL;
-    int opts, pending_events;
+    uint32_t priority, count;
+    int opts, parallel, async, pending_events;
     sr_cid_t cid;
 
     cid = mod_info->conn->cid;
+    async = (mod_info->conn->opts & SR_CONN_ASYNC_DONE) ? 1 : 0;
 
     while ((mod = sr_modinfo_next_mod(mod, mod_info, mod_info->diff, &aux))) {
         /* first check that there actually are some value changes (and not only dflt changes) */
@@ -1600,8 +2016,10 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, const char *
             continue;
         }
 
-        if (!sr_shmsub_change_notify_has_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_DONE, &max_priority)) {
+        if (!sr_shmsub_change_notify_has_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_DONE,
+                mod_info->diff, &filter, 1, &max_priority)) {
             /* no subscriptions interested in this event */
+            sr_shmsub_change_notify_filter_clear(&filter);
             continue;
         }
 
@@ -1614,6 +2032,8 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, const char *
         notify_subs[notify_count].cur_priority = max_priority + 1;
         notify_subs[notify_count].shm_sub.fd = -1;
         notify_subs[notify_count].shm_data_sub.fd = -1;
+        notify_subs[notify_count].filter = filter;
+        memset(&filter, 0, sizeof filter);
         ++notify_count;
     }
 
@@ -1626,7 +2046,7 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, const char *
     sr_shmsub_change_notify_nsubs_set_mod_prio(notify_subs, notify_count, mod_info->ds, &cur_mpriority);
 
     /* prepare the diff to write into subscription SHM */
-    if (!diff_lyb && (err_info = sr_lyd_print_lyb(mod_info->diff, &diff_lyb, &diff_lyb_len))) {
+    if (!diff_lyb && (err_info = sr_shmsub_change_notify_print_diff(mod_info, mod_info->diff, &diff_lyb, &diff_lyb_len))) {
         goto cleanup;
     }
 
@@ -1641,15 +2061,29 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, const char *
 
             /* get next subscriber(s) priority and subscriber count */
             if ((err_info = sr_shmsub_change_notify_next_subscription(mod_info->conn, nsub->mod, mod_info->ds,
-                    SR_SUB_EV_DONE, nsub->cur_priority, &nsub->cur_priority, &subscriber_count, &opts))) {
+                    SR_SUB_EV_DONE, mod_info->diff, &nsub->filter, nsub->cur_priority, &nsub->cur_priority,
+                    &subscriber_count, &opts, &parallel))) {
                 goto cleanup;
             }
 
             if (!subscriber_count) {
                 continue;
             }
-            nsub->pending_event = 1;
-            pending_events = 1;
+
+            if (async) {
+                /* all the remaining subscribers are notified at once with the highest priority */
+                priority = nsub->cur_priority;
+                do {
+                    if ((err_info = sr_shmsub_change_notify_next_subscription(mod_info->conn, nsub->mod, mod_info->ds,
+                            SR_SUB_EV_DONE, mod_info->diff, &nsub->filter, priority, &priority, &count, NULL, NULL))) {
+                        goto cleanup;
+                    }
+                    subscriber_count += count;
+                } while (count);
+            } else {
+                nsub->pending_event = 1;
+                pending_events = 1;
+            }
 
             /* open sub SHM and map it */
             if ((err_info = sr_shmsub_open_map(nsub->mod->ly_mod->name, sr_ds2str(mod_info->ds), -1, &nsub->shm_sub))) {
@@ -1673,6 +2107,8 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, const char *
             if (!nsub->mod->request_id) {
                 nsub->mod->request_id = ++nsub->sub_shm->request_id;
             }
+            ATOMIC_STORE_RELAXED(((sr_multi_sub_shm_t *)nsub->shm_sub.addr)->parallel, parallel);
+            ATOMIC_STORE_RELAXED(((sr_multi_sub_shm_t *)nsub->shm_sub.addr)->async, async);
             if ((err_info = sr_shmsub_multi_notify_write_event((sr_multi_sub_shm_t *)nsub->shm_sub.addr, cid,
                     nsub->mod->request_id, nsub->cur_priority, SR_SUB_EV_DONE, orig_name, orig_data, subscriber_count,
                     &nsub->shm_data_sub, NULL, diff_lyb, diff_lyb_len, nsub->mod->ly_mod->name))) {
@@ -1681,9 +2117,21 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, const char *
 
             /* notify the subscribers using an event pipe */
             if ((err_info = sr_shmsub_change_notify_evpipe(mod_info->conn, nsub->mod, mod_info->ds, SR_SUB_EV_DONE,
-                    nsub->cur_priority))) {
+                    mod_info->diff, &nsub->filter, async ? NULL : &nsub->cur_priority, parallel))) {
                 goto cleanup;
             }
+
+            if (async) {
+                /* SUB WRITE UNLOCK, the next event waits until this one is processed */
+                sr_rwunlock(&nsub->sub_shm->lock, 0, SR_LOCK_WRITE, cid, __func__);
+                nsub->lock = SR_LOCK_NONE;
+
+                SR_LOG_INF("EV ORIGIN: \"%s\" \"%s\" ID %" PRIu32 " priority %" PRIu32 " published asynchronously.",
+                        nsub->mod->ly_mod->name, sr_ev2str(SR_SUB_EV_DONE), nsub->mod->request_id, nsub->cur_priority);
+
+                /* no more subscribers to notify */
+                nsub->cur_priority = 0;
+            }
         }
         if (!pending_events) {
             /* all module events generated and processed, next module priority, if any */
@@ -1732,7 +2180,9 @@ cleanup:
         }
         sr_shm_clear(&notify_subs[i].shm_sub);
         sr_shm_clear(&notify_subs[i].shm_data_sub);
+        sr_shmsub_change_notify_filter_clear(&notify_subs[i].filter);
     }
+    sr_shmsub_change_notify_filter_clear(&filter);
 
     free(aux);
     free(diff_lyb);
@@ -1750,8 +2200,9 @@ sr_shmsub_change_notify_change_abort(struct sr_mod_info_s *mod_info, const char
     struct sr_mod_info_mod_s *mod = NULL;
     uint32_t notify_count = 0, max_priority, cur_mpriority, subscriber_count, diff_lyb_len, *aux = NULL, i;
     struct sr_shmsub_many_info_change_s *notify_subs = NULL, *nsub;
+    struct sr_shmsub_change_filter_s filter = {0};
     char *diff_lyb = NULL;
-    int last_priority = 0, pending_events;
+    int last_priority = 0, parallel, pending_events;
     sr_cid_t cid;
 
     cid = mod_info->conn->cid;
@@ -1762,13 +2213,16 @@ sr_shmsub_change_notify_change_abort(struct sr_mod_info_s *mod_info, const char
             continue;
         }
 
-        if (!sr_shmsub_change_notify_has_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_CHANGE, &max_priority)) {
+        if (!sr_shmsub_change_notify_has_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_CHANGE,
+                mod_info->diff, &filter, 0, &max_priority)) {
             /* no subscriptions whatsoever */
+            sr_shmsub_change_notify_filter_clear(&filter);
             continue;
         }
 
         /* whether there are some "abort" subscriptions or not, create the notify_sub */
-        sr_shmsub_change_notify_has_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_ABORT, &max_priority);
+        sr_shmsub_change_notify_has_subscription(mod_info->conn, mod, mod_info->ds, SR_SUB_EV_ABORT, mod_info->diff,
+                &filter, 0, &max_priority);
 
         notify_subs = sr_realloc(notify_subs, (notify_count + 1) * sizeof *notify_subs);
         SR_CHECK_MEM_GOTO(!notify_subs, err_info, cleanup);
@@ -1779,6 +2233,8 @@ sr_shmsub_change_notify_change_abort(struct sr_mod_info_s *mod_info, const char
         notify_subs[notify_count].cur_priority = max_priority + 1;
         notify_subs[notify_count].shm_sub.fd = -1;
         notify_subs[notify_count].shm_data_sub.fd = -1;
+        notify_subs[notify_count].filter = filter;
+        memset(&filter, 0, sizeof filter);
         ++notify_count;
     }
     assert(notify_count);
@@ -1834,7 +2290,7 @@ sr_shmsub_change_notify_change_abort(struct sr_mod_info_s *mod_info, const char
     }
 
     /* prepare the diff to write into subscription SHM */
-    err_info = sr_lyd_print_lyb(abort_diff, &diff_lyb, &diff_lyb_len);
+    err_info = sr_shmsub_change_notify_print_diff(mod_info, abort_diff, &diff_lyb, &diff_lyb_len);
     lyd_free_all(abort_diff);
     if (err_info) {
         goto cleanup;
@@ -1851,7 +2307,8 @@ sr_shmsub_change_notify_change_abort(struct sr_mod_info_s *mod_info, const char
 
             /* get next subscriber(s) priority and subscriber count */
             if ((err_info = sr_shmsub_change_notify_next_subscription(mod_info->conn, nsub->mod, mod_info->ds,
-                    SR_SUB_EV_ABORT, nsub->cur_priority, &nsub->cur_priority, &subscriber_count, NULL))) {
+                    SR_SUB_EV_ABORT, mod_info->diff, &nsub->filter, nsub->cur_priority, &nsub->cur_priority, &subscriber_count,
+                    NULL, &parallel))) {
                 goto cleanup;
             }
 
@@ -1885,6 +2342,8 @@ sr_shmsub_change_notify_change_abort(struct sr_mod_info_s *mod_info, const char
             }
 
             /* write the event */
+            ATOMIC_STORE_RELAXED(multi_sub_shm->parallel, parallel);
+            ATOMIC_STORE_RELAXED(multi_sub_shm->async, 0);
             if ((err_info = sr_shmsub_multi_notify_write_event(multi_sub_shm, cid, nsub->mod->request_id,
                     nsub->cur_priority, SR_SUB_EV_ABORT, orig_name, orig_data, subscriber_count, &nsub->shm_data_sub,
                     NULL, diff_lyb, diff_lyb_len, nsub->mod->ly_mod->name))) {
@@ -1893,7 +2352,7 @@ sr_shmsub_change_notify_change_abort(struct sr_mod_info_s *mod_info, const char
 
             /* notify the subscribers using an event pipe */
             if ((err_info = sr_shmsub_change_notify_evpipe(mod_info->conn, nsub->mod, mod_info->ds, SR_SUB_EV_ABORT,
-                    nsub->cur_priority))) {
+                    mod_info->diff, &nsub->filter, &nsub->cur_priority, parallel))) {
                 goto cleanup;
             }
         }
@@ -1950,7 +2409,9 @@ cleanup:
         }
         sr_shm_clear(&notify_subs[i].shm_sub);
         sr_shm_clear(&notify_subs[i].shm_data_sub);
+        sr_shmsub_change_notify_filter_clear(&notify_subs[i].filter);
     }
+    sr_shmsub_change_notify_filter_clear(&filter);
 
     free(aux);
     free(diff_lyb);
@@ -1959,23 +2420,33 @@ cleanup:
 }
 
 sr_error_info_t *
-sr_shmsub_oper_get_notify(struct sr_mod_info_mod_s *mod, const char *xpath, const char *request_xpath,
-        const struct lyd_node *parent, const char *orig_name, const void *orig_data, sr_mod_oper_get_sub_t *oper_get_subs,
-        uint32_t idx1, uint32_t timeout_ms, sr_conn_ctx_t *conn, struct lyd_node **data, sr_error_info_t **cb_err_info)
+sr_shmsub_oper_get_notify_batch_add(struct sr_shmsub_oper_get_batch_s *batch, struct sr_mod_info_mod_s *mod,
+        const char *xpath, const char *request_xpath, const sr_oper_get_hints_t *hints, const struct lyd_node *parent,
+        const char *orig_name, const void *orig_data, sr_mod_oper_get_sub_t *oper_get_subs, uint32_t idx1,
+        sr_conn_ctx_t *conn)
 {
     sr_error_info_t *err_info = NULL;
-    uint32_t i, notify_count = 0, parent_lyb_len, request_id;
-    struct sr_shmsub_many_info_oper_get_s *notify_subs = NULL, *nsub;
+    uint32_t i, first, parent_lyb_len, ev_data_len, request_id;
+    struct sr_shmsub_many_info_oper_get_s *nsub;
     sr_mod_oper_get_xpath_sub_t *xpath_sub;
-    char *parent_lyb = NULL;
-    struct lyd_node *oper_data;
+    const char **xpaths;
+    char *parent_lyb = NULL, *ev_data = NULL;
     sr_cid_t cid;
+    void *mem;
 
     if (!request_xpath) {
         request_xpath = "";
     }
     cid = conn->cid;
 
+    /* add the XPath */
+    xpaths = realloc(batch->xpaths, (batch->xpath_count + 1) * sizeof *batch->xpaths);
+    SR_CHECK_MEM_RET(!xpaths, err_info);
+    batch->xpaths = xpaths;
+    batch->xpaths[batch->xpath_count] = xpath;
+    ++batch->xpath_count;
+
+    first = batch->notify_count;
     i = 0;
     while (i < oper_get_subs[idx1].xpath_sub_count) {
         xpath_sub = &((sr_mod_oper_get_xpath_sub_t *)(conn->ext_shm.addr + oper_get_subs[idx1].xpath_subs))[i];
@@ -2000,15 +2471,20 @@ sr_shmsub_oper_get_notify(struct sr_mod_info_mod_s *mod, const char *xpath, cons
             continue;
         }
 
-        notify_subs = sr_realloc(notify_subs, (notify_count + 1) * sizeof *notify_subs);
-        SR_CHECK_MEM_GOTO(!notify_subs, err_info, cleanup);
+        /* keep the previous subscriptions on error, they may be locked */
+        mem = realloc(batch->notify_subs, (batch->notify_count + 1) * sizeof *batch->notify_subs);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+        batch->notify_subs = mem;
 
         /* init */
-        memset(&notify_subs[notify_count], 0, sizeof *notify_subs);
-        notify_subs[notify_count].xpath_sub = xpath_sub;
-        notify_subs[notify_count].shm_sub.fd = -1;
-        notify_subs[notify_count].shm_data_sub.fd = -1;
-        ++notify_count;
+        nsub = &batch->notify_subs[batch->notify_count];
+        memset(nsub, 0, sizeof *nsub);
+        nsub->xpath_sub = xpath_sub;
+        nsub->xpath_idx = batch->xpath_count - 1;
+        nsub->sub_idx = batch->notify_count - first;
+        nsub->shm_sub.fd = -1;
+        nsub->shm_data_sub.fd = -1;
+        ++batch->notify_count;
 
         ++i;
     }
@@ -2020,8 +2496,15 @@ sr_shmsub_oper_get_notify(struct sr_mod_info_mod_s *mod, const char *xpath, cons
     }
     parent_lyb_len = lyd_lyb_data_length(parent_lyb);
 
-    for (i = 0; i < notify_count; ++i) {
-        nsub = &notify_subs[i];
+    /* event data are the hints followed by the parent */
+    ev_data_len = SR_SHM_SIZE(sizeof *hints) + parent_lyb_len;
+    ev_data = calloc(1, ev_data_len);
+    SR_CHECK_MEM_GOTO(!ev_data, err_info, cleanup);
+    memcpy(ev_data, hints, sizeof *hints);
+    memcpy(ev_data + SR_SHM_SIZE(sizeof *hints), parent_lyb, parent_lyb_len);
+
+    for (i = first; i < batch->notify_count; ++i) {
+        nsub = &batch->notify_subs[i];
 
         /* open sub SHM and map it */
         if ((err_info = sr_shmsub_open_map(mod->ly_mod->name, "oper", sr_str_hash(xpath, nsub->xpath_sub->priority),
@@ -2045,36 +2528,57 @@ sr_shmsub_oper_get_notify(struct sr_mod_info_mod_s *mod, const char *xpath, cons
         /* write the request for state data */
         request_id = ATOMIC_LOAD_RELAXED(nsub->sub_shm->request_id) + 1;
         if ((err_info = sr_shmsub_notify_write_event(nsub->sub_shm, cid, request_id, SR_SUB_EV_OPER, orig_name,
-                orig_data, &nsub->shm_data_sub, request_xpath, parent_lyb, parent_lyb_len, NULL))) {
+                orig_data, &nsub->shm_data_sub, request_xpath, ev_data, ev_data_len, NULL))) {
             goto cleanup;
         }
         SR_LOG_INF("EV ORIGIN: \"%s\" \"%s\" index %" PRIu32 " ID %" PRIu32 " published.", xpath,
-                sr_ev2str(SR_SUB_EV_OPER), i, request_id);
+                sr_ev2str(SR_SUB_EV_OPER), nsub->sub_idx, request_id);
 
         /* notify using event pipe */
-        if ((err_info = sr_shmsub_notify_evpipe(nsub->xpath_sub->evpipe_num))) {
+        if ((err_info = sr_shmsub_notify_evpipe(nsub->xpath_sub->evpipe_num, SR_EVPIPE_EV_OPER_GET))) {
             goto cleanup;
         }
 
         nsub->pending_event = 1;
     }
 
+cleanup:
+    free(parent_lyb);
+    free(ev_data);
+    return err_info;
+}
+
+sr_error_info_t *
+sr_shmsub_oper_get_notify_batch_wait(struct sr_shmsub_oper_get_batch_s *batch, struct sr_mod_info_mod_s *mod,
+        uint32_t timeout_ms, sr_conn_ctx_t *conn, struct lyd_node **data, sr_error_info_t **cb_err_info)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_shmsub_many_info_oper_get_s *nsub;
+    struct lyd_node *oper_data;
+    const char *xpath;
+    uint32_t i;
+    sr_cid_t cid;
+
+    cid = conn->cid;
+
     /* wait until the events are processed */
-    if ((err_info = sr_shmsub_notify_many_wait_wr((struct sr_shmsub_many_info_s *)notify_subs, sizeof *notify_subs,
-            notify_count, SR_SUB_EV_ERROR, 1, cid, timeout_ms))) {
-        goto cleanup;
+    if ((err_info = sr_shmsub_notify_many_wait_wr((struct sr_shmsub_many_info_s *)batch->notify_subs,
+            sizeof *batch->notify_subs, batch->notify_count, SR_SUB_EV_ERROR, 1, cid, timeout_ms))) {
+        return err_info;
     }
 
-    for (i = 0; i < notify_count; ++i) {
-        nsub = &notify_subs[i];
+    for (i = 0; i < batch->notify_count; ++i) {
+        nsub = &batch->notify_subs[i];
         if (!nsub->pending_event) {
             continue;
         }
+        xpath = batch->xpaths[nsub->xpath_idx];
 
         if (nsub->cb_err_info) {
             /* failed callback */
             SR_LOG_WRN("EV ORIGIN: \"%s\" \"%s\" index %" PRIu32 " ID %" PRIu32 " failed (%s).", xpath,
-                    sr_ev2str(SR_SUB_EV_OPER), i, nsub->request_id, sr_strerror(nsub->cb_err_info->err[0].err_code));
+                    sr_ev2str(SR_SUB_EV_OPER), nsub->sub_idx, nsub->request_id,
+                    sr_strerror(nsub->cb_err_info->err[0].err_code));
 
             /* merge the error and continue */
             sr_errinfo_merge(cb_err_info, nsub->cb_err_info);
@@ -2083,7 +2587,7 @@ sr_shmsub_oper_get_notify(struct sr_mod_info_mod_s *mod, const char *xpath, cons
             continue;
         } else {
             SR_LOG_INF("EV ORIGIN: \"%s\" \"%s\" index %" PRIu32 " ID %" PRIu32 " succeeded.", xpath,
-                    sr_ev2str(SR_SUB_EV_OPER), i, nsub->request_id);
+                    sr_ev2str(SR_SUB_EV_OPER), nsub->sub_idx, nsub->request_id);
         }
 
         assert(ATOMIC_LOAD_RELAXED(nsub->sub_shm->event) == SR_SUB_EV_SUCCESS);
@@ -2093,7 +2597,7 @@ sr_shmsub_oper_get_notify(struct sr_mod_info_mod_s *mod, const char *xpath, cons
                 &oper_data)) {
             sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, NULL);
             sr_errinfo_new(&err_info, SR_ERR_VALIDATION_FAILED, "Failed to parse returned \"operational\" data.");
-            goto cleanup;
+            return err_info;
         }
 
         /* event processed */
@@ -2103,28 +2607,61 @@ sr_shmsub_oper_get_notify(struct sr_mod_info_mod_s *mod, const char *xpath, cons
         sr_rwunlock(&nsub->sub_shm->lock, 0, SR_LOCK_WRITE, cid, __func__);
         nsub->lock = SR_LOCK_NONE;
 
-        /* merge returned data into data tree */
-        if (lyd_merge_siblings(data, oper_data, LYD_MERGE_DESTRUCT | LYD_MERGE_WITH_FLAGS)) {
+        /* merge returned data into data tree of the XPath */
+        if (lyd_merge_siblings(&data[nsub->xpath_idx], oper_data, LYD_MERGE_DESTRUCT | LYD_MERGE_WITH_FLAGS)) {
             sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx, NULL);
-            goto cleanup;
+            return err_info;
         }
 
         nsub->pending_event = 0;
     }
 
-cleanup:
-    for (i = 0; i < notify_count; ++i) {
-        if (notify_subs[i].lock) {
+    return NULL;
+}
+
+void
+sr_shmsub_oper_get_notify_batch_clear(struct sr_shmsub_oper_get_batch_s *batch, sr_cid_t cid)
+{
+    uint32_t i;
+
+    for (i = 0; i < batch->notify_count; ++i) {
+        if (batch->notify_subs[i].lock) {
             /* SUB UNLOCK */
-            sr_rwunlock(&notify_subs[i].sub_shm->lock, 0, notify_subs[i].lock, cid, __func__);
-            notify_subs[i].lock = SR_LOCK_NONE;
+            sr_rwunlock(&batch->notify_subs[i].sub_shm->lock, 0, batch->notify_subs[i].lock, cid, __func__);
+            batch->notify_subs[i].lock = SR_LOCK_NONE;
         }
-        sr_shm_clear(&notify_subs[i].shm_sub);
-        sr_shm_clear(&notify_subs[i].shm_data_sub);
+        sr_shm_clear(&batch->notify_subs[i].shm_sub);
+        sr_shm_clear(&batch->notify_subs[i].shm_data_sub);
+        sr_errinfo_free(&batch->notify_subs[i].cb_err_info);
     }
 
-    free(parent_lyb);
-    free(notify_subs);
+    free(batch->notify_subs);
+    free(batch->xpaths);
+    memset(batch, 0, sizeof *batch);
+}
+
+sr_error_info_t *
+sr_shmsub_oper_get_notify(struct sr_mod_info_mod_s *mod, const char *xpath, const char *request_xpath,
+        const sr_oper_get_hints_t *hints, const struct lyd_node *parent, const char *orig_name, const void *orig_data,
+        sr_mod_oper_get_sub_t *oper_get_subs, uint32_t idx1, uint32_t timeout_ms, sr_conn_ctx_t *conn,
+        struct lyd_node **data, sr_error_info_t **cb_err_info)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_shmsub_oper_get_batch_s batch = {0};
+
+    /* write the events for all the subscribers */
+    if ((err_info = sr_shmsub_oper_get_notify_batch_add(&batch, mod, xpath, request_xpath, hints, parent, orig_name,
+            orig_data, oper_get_subs, idx1, conn))) {
+        goto cleanup;
+    }
+
+    /* wait for them and get the data */
+    if ((err_info = sr_shmsub_oper_get_notify_batch_wait(&batch, mod, timeout_ms, conn, data, cb_err_info))) {
+        goto cleanup;
+    }
+
+cleanup:
+    sr_shmsub_oper_get_notify_batch_clear(&batch, conn->cid);
     return err_info;
 }
 
@@ -2189,6 +2726,7 @@ sr_shmsub_rpc_internal_call_callback(sr_conn_ctx_t *conn, const struct lyd_node
         if ((err_info = sr_shmmod_copy_mod(ly_mod, ds_plg[ds], ds, ds_plg[SR_DS_RUNNING], SR_DS_RUNNING))) {
             goto cleanup;
         }
+        ATOMIC_INC_RELAXED(shm_mod->run_data_ver);
 
         /* reset candidate */
         if ((rc = ds_plg[SR_DS_CANDIDATE]->candidate_reset_cb(ly_mod))) {
@@ -2499,7 +3037,7 @@ first_sub:
 
         /* notify using event pipe */
         for (i = 0; i < subscriber_count; ++i) {
-            if ((err_info = sr_shmsub_notify_evpipe(evpipes[i]))) {
+            if ((err_info = sr_shmsub_notify_evpipe(evpipes[i], SR_EVPIPE_EV_RPC))) {
                 goto cleanup_wrunlock;
             }
         }
@@ -2650,7 +3188,7 @@ clear_shm:
 
         /* notify using event pipe */
         for (i = 0; i < subscriber_count; ++i) {
-            if ((err_info = sr_shmsub_notify_evpipe(evpipes[i]))) {
+            if ((err_info = sr_shmsub_notify_evpipe(evpipes[i], SR_EVPIPE_EV_RPC))) {
                 goto cleanup_wrunlock;
             }
         }
@@ -2690,42 +3228,235 @@ cleanup:
     return err_info;
 }
 
+/**
+ * @brief Learn how far behind the last written notification the slowest notification subscription is.
+ *
+ * @param[in] notif_subs Notification subscriptions in ext SHM.
+ * @param[in] notif_sub_count Count of @p notif_subs.
+ * @param[in] last_request_id Request ID of the last written notification.
+ * @return Number of notifications not yet processed by the slowest (not suspended) subscription.
+ */
+static uint32_t
+sr_shmsub_notif_ring_max_lag(const sr_mod_notif_sub_t *notif_subs, uint32_t notif_sub_count, uint32_t last_request_id)
+{
+    uint32_t i, lag, max_lag = 0;
+
+    for (i = 0; i < notif_sub_count; ++i) {
+        if (ATOMIC_LOAD_RELAXED(notif_subs[i].suspended)) {
+            /* suspended subscriptions skip the notifications */
+            continue;
+        }
+
+        lag = last_request_id - ATOMIC_LOAD_RELAXED(notif_subs[i].cursor);
+        if (lag > max_lag) {
+            max_lag = lag;
+        }
+    }
+
+    return max_lag;
+}
+
+/**
+ * @brief Get the ring entry at an offset, skipping the end of the ring.
+ *
+ * @param[in] ring Notification ring.
+ * @param[in,out] off Offset of the entry, moved to the ring start if the end was reached.
+ * @return Ring entry.
+ */
+static sr_notif_ring_entry_t *
+sr_shmsub_notif_ring_entry(sr_notif_ring_t *ring, uint32_t *off)
+{
+    sr_notif_ring_entry_t *entry;
+
+    if (ring->size - *off < sizeof *entry) {
+        /* no space for another entry at the end */
+        *off = 0;
+    }
+    entry = (sr_notif_ring_entry_t *)(((char *)(ring + 1)) + *off);
+    if (!entry->request_id) {
+        /* end marker */
+        *off = 0;
+        entry = (sr_notif_ring_entry_t *)(ring + 1);
+    }
+
+    return entry;
+}
+
+/**
+ * @brief Remove all the oldest notifications processed by all the subscriptions from a ring.
+ *
+ * @param[in] ring Notification ring.
+ * @param[in] last_request_id Request ID of the last written notification.
+ * @param[in] max_lag Number of notifications not yet processed by the slowest subscription.
+ */
+static void
+sr_shmsub_notif_ring_reclaim(sr_notif_ring_t *ring, uint32_t last_request_id, uint32_t max_lag)
+{
+    sr_notif_ring_entry_t *entry;
+
+    while (ring->count) {
+        entry = sr_shmsub_notif_ring_entry(ring, &ring->tail);
+        if ((uint32_t)(last_request_id - entry->request_id) < max_lag) {
+            /* not processed by all the subscriptions */
+            break;
+        }
+
+        ring->tail += entry->size;
+        --ring->count;
+    }
+
+    if (!ring->count) {
+        ring->head = 0;
+        ring->tail = 0;
+    }
+}
+
+/**
+ * @brief Allocate space for a new entry in a notification ring.
+ *
+ * @param[in] ring Notification ring.
+ * @param[in] size Size of the entry.
+ * @param[out] off Offset of the allocated entry.
+ * @return 0 if the ring is full, non-zero on success.
+ */
+static int
+sr_shmsub_notif_ring_alloc(sr_notif_ring_t *ring, uint32_t size, uint32_t *off)
+{
+    sr_notif_ring_entry_t *entry;
+
+    if (!ring->count || (ring->head > ring->tail)) {
+        /* free space after the head and before the tail */
+        if (ring->size - ring->head >= size) {
+            *off = ring->head;
+        } else if (ring->count && (ring->tail >= size)) {
+            if (ring->size - ring->head >= sizeof *entry) {
+                /* mark the end of the ring */
+                entry = (sr_notif_ring_entry_t *)(((char *)(ring + 1)) + ring->head);
+                entry->request_id = 0;
+                entry->size = 0;
+            }
+            *off = 0;
+        } else {
+            return 0;
+        }
+    } else if (ring->tail - ring->head >= size) {
+        /* free space between the head and the tail */
+        *off = ring->head;
+    } else {
+        return 0;
+    }
+
+    ring->head = *off + size;
+    ++ring->count;
+    return 1;
+}
+
+/**
+ * @brief Having WRITE lock, wait until a notification subscriber announces some progress or a timeout elapses.
+ * WRITE lock is held again on return.
+ *
+ * @param[in] multi_sub_shm Notification sub SHM.
+ * @param[in] cid Connection ID.
+ * @param[in] timeout_abs Absolute timeout of the wait.
+ * @return 0 on success or timeout, error code otherwise.
+ */
+static int
+sr_shmsub_notif_ring_wait(sr_multi_sub_shm_t *multi_sub_shm, sr_cid_t cid, struct timespec *timeout_abs)
+{
+    int ret;
+
+    assert(multi_sub_shm->lock.writer == cid);
+    /* FAKE WRITE UNLOCK */
+    multi_sub_shm->lock.writer = 0;
+
+    /* COND WAIT */
+    ret = sr_cond_clockwait(&multi_sub_shm->lock.cond, &multi_sub_shm->lock.mutex, COMPAT_CLOCK_ID, timeout_abs);
+
+    /* wait until there are no readers or another writer (just like write lock) */
+    while (!ret && (multi_sub_shm->lock.readers[0] || multi_sub_shm->lock.writer)) {
+        /* COND WAIT */
+        ret = sr_cond_clockwait(&multi_sub_shm->lock.cond, &multi_sub_shm->lock.mutex, COMPAT_CLOCK_ID, timeout_abs);
+    }
+    /* we are holding the mutex, the caller checks the ring again even if some readers are left */
+
+    /* FAKE WRITE LOCK */
+    multi_sub_shm->lock.writer = cid;
+
+    return (ret == ETIMEDOUT) ? 0 : ret;
+}
+
 sr_error_info_t *
-sr_shmsub_notif_notify(sr_conn_ctx_t *conn, const struct lyd_node *notif, struct timespec notif_ts, const char *orig_name,
-        const void *orig_data, uint32_t timeout_ms, int wait)
+sr_shmsub_notif_notify(sr_conn_ctx_t *conn, struct lyd_node **notifs, const struct timespec *notif_ts,
+        uint32_t notif_count, const char *orig_name, const void *orig_data, uint32_t timeout_ms, int wait)
 {
-    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
+    sr_error_info_t *err_info = NULL;
     const struct lys_module *ly_mod;
     sr_mod_notif_sub_t *notif_subs;
-    char *notif_lyb = NULL;
-    uint32_t notif_sub_count, notif_lyb_len, request_id, i;
-    sr_cid_t sub_cid;
-    sr_multi_sub_shm_t *multi_sub_shm;
+    sr_multi_sub_shm_t *multi_sub_shm = NULL;
     sr_shm_t shm_sub = SR_SHM_INITIALIZER, shm_data_sub = SR_SHM_INITIALIZER;
+    sr_notif_ring_t *ring;
+    sr_notif_ring_entry_t *entry;
+    struct timespec full_timeout_abs, wait_timeout_abs, step_abs;
+    struct timespec *timeout_abs;
+    const uint32_t empty_data[] = {0};
+    char **notif_lybs = NULL, *shm_data_ptr;
+    uint32_t notif_sub_count, sub_count, *notif_lyb_lens = NULL, written = 0, request_id = 0, last_request_id, max_lag,
+            entry_size, off, i;
+    sr_cid_t sub_cid;
+    sr_mod_t *shm_mod;
+    int ret = 0, wait_ms;
 
-    assert(!notif->parent);
+    assert(notif_count);
+
+    ly_mod = lyd_owner_module(notifs[0]);
+    if (!orig_name) {
+        orig_name = "";
+    }
+    if (!orig_data) {
+        orig_data = empty_data;
+    }
 
-    ly_mod = lyd_owner_module(notif);
+    /* the ring may stay full only for a limited time */
+    sr_timeouttime_get(&full_timeout_abs, SR_SUBSHM_LOCK_TIMEOUT);
+    if (wait) {
+        sr_timeouttime_get(&wait_timeout_abs, timeout_ms);
+    }
 
+retry:
     /* EXT READ LOCK */
     if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_READ, 0, __func__))) {
         goto cleanup;
     }
 
     /* check that there is a subscriber */
-    if ((err_info = sr_notif_find_subscriber(conn, ly_mod->name, &notif_subs, &notif_sub_count, &sub_cid))) {
+    if ((err_info = sr_notif_find_subscriber(conn, ly_mod->name, &notif_subs, &sub_count, &sub_cid))) {
         goto cleanup_ext_unlock;
     }
 
-    if (!notif_sub_count) {
+    if (!sub_count) {
         /* nothing to do */
-        SR_LOG_INF("There are no subscribers for \"%s\" notifications.", ly_mod->name);
+        if (!written) {
+            SR_LOG_INF("There are no subscribers for \"%s\" notifications.", ly_mod->name);
+        }
         goto cleanup_ext_unlock;
     }
 
-    /* print the notification into LYB */
-    if ((err_info = sr_lyd_print_lyb(notif, &notif_lyb, &notif_lyb_len))) {
-        goto cleanup_ext_unlock;
+    /* all the subscriptions, including the suspended ones */
+    shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), ly_mod->name);
+    SR_CHECK_INT_GOTO(!shm_mod, err_info, cleanup_ext_unlock);
+    notif_sub_count = shm_mod->notif_sub_count;
+
+    if (!notif_lybs) {
+        /* print the notifications into LYB */
+        notif_lybs = calloc(notif_count, sizeof *notif_lybs);
+        notif_lyb_lens = malloc(notif_count * sizeof *notif_lyb_lens);
+        SR_CHECK_MEM_GOTO(!notif_lybs || !notif_lyb_lens, err_info, cleanup_ext_unlock);
+        for (i = 0; i < notif_count; ++i) {
+            assert(!notifs[i]->parent && (lyd_owner_module(notifs[i]) == ly_mod));
+            if ((err_info = sr_lyd_print_lyb(notifs[i], &notif_lybs[i], &notif_lyb_lens[i]))) {
+                goto cleanup_ext_unlock;
+            }
+        }
     }
 
     /* open sub SHM and map it */
@@ -2735,7 +3466,8 @@ sr_shmsub_notif_notify(sr_conn_ctx_t *conn, const struct lyd_node *notif, struct
     multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub.addr;
 
     /* SUB WRITE LOCK */
-    if ((err_info = sr_shmsub_notify_new_wrlock((sr_sub_shm_t *)multi_sub_shm, ly_mod->name, 0, conn->cid))) {
+    if ((err_info = sr_rwlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__,
+            NULL, NULL))) {
         goto cleanup_ext_unlock;
     }
 
@@ -2744,51 +3476,126 @@ sr_shmsub_notif_notify(sr_conn_ctx_t *conn, const struct lyd_node *notif, struct
         goto cleanup_ext_sub_unlock;
     }
 
-    /* write the notification, use first subscriber CID - works better than the originator */
-    request_id = multi_sub_shm->request_id + 1;
-    if ((err_info = sr_shmsub_multi_notify_write_event(multi_sub_shm, sub_cid, request_id, 0, SR_SUB_EV_NOTIF,
-            orig_name, orig_data, notif_sub_count, &shm_data_sub, &notif_ts, notif_lyb, notif_lyb_len, ly_mod->name))) {
-        goto cleanup_ext_sub_unlock;
-    }
-
-    /* notify all subscribers using event pipe */
-    for (i = 0; i < notif_sub_count; ) {
-        if (ATOMIC_LOAD_RELAXED(notif_subs[i].suspended)) {
-            /* skip suspended subscribers */
-            continue;
-        }
+    last_request_id = ATOMIC_LOAD_RELAXED(multi_sub_shm->request_id);
+    max_lag = sr_shmsub_notif_ring_max_lag(notif_subs, notif_sub_count, last_request_id);
 
-        if ((err_info = sr_shmsub_notify_evpipe(notif_subs[i].evpipe_num))) {
+    if (written == notif_count) {
+        /* all the notifications were written, wait for the subscribers */
+        if ((uint32_t)(last_request_id - request_id) >= max_lag) {
+            /* processed by all the subscribers */
             goto cleanup_ext_sub_unlock;
         }
+        timeout_abs = &wait_timeout_abs;
+    } else {
+        /* remove the processed notifications */
+        ring = (shm_data_sub.size < sizeof *ring) ? NULL : (sr_notif_ring_t *)shm_data_sub.addr;
+        if (ring && ring->size) {
+            sr_shmsub_notif_ring_reclaim(ring, last_request_id, max_lag);
+        }
+
+        /* write as many notifications as fit, request ID 0 is reserved */
+        request_id = last_request_id;
+        for (i = written; i < notif_count; ++i) {
+            entry_size = SR_SHM_SIZE(sizeof *entry + sr_strshmlen(orig_name) + SR_SHM_SIZE(sr_ev_data_size(orig_data)) +
+                    sizeof *notif_ts + notif_lyb_lens[i]);
+
+            if (!ring || !ring->size || (!ring->count && (ring->size < entry_size))) {
+                /* (re)initialize an empty ring big enough for the notification */
+                if ((err_info = sr_shmsub_data_open_remap(ly_mod->name, "notif", -1, &shm_data_sub,
+                        sizeof *ring + ((entry_size > SR_NOTIF_RING_SIZE) ? entry_size : SR_NOTIF_RING_SIZE)))) {
+                    goto cleanup_ext_sub_unlock;
+                }
+                ring = (sr_notif_ring_t *)shm_data_sub.addr;
+                ring->size = shm_data_sub.size - sizeof *ring;
+                ring->head = 0;
+                ring->tail = 0;
+                ring->count = 0;
+            }
 
-        ++i;
-    }
+            if (!sr_shmsub_notif_ring_alloc(ring, entry_size, &off)) {
+                /* the ring is full */
+                break;
+            }
 
-    /* EXT READ UNLOCK */
-    sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 0, __func__);
+            if (!++request_id) {
+                ++request_id;
+            }
+            entry = (sr_notif_ring_entry_t *)(((char *)(ring + 1)) + off);
+            entry->size = entry_size;
+            entry->request_id = request_id;
+            sr_timeouttime_get(&entry->event_ts, 0);
+            shm_data_ptr = (char *)(entry + 1);
+            strcpy(shm_data_ptr, orig_name);
+            shm_data_ptr += sr_strshmlen(orig_name);
+            memcpy(shm_data_ptr, orig_data, sr_ev_data_size(orig_data));
+            shm_data_ptr += SR_SHM_SIZE(sr_ev_data_size(orig_data));
+            memcpy(shm_data_ptr, &notif_ts[i], sizeof *notif_ts);
+            shm_data_ptr += sizeof *notif_ts;
+            memcpy(shm_data_ptr, notif_lybs[i], notif_lyb_lens[i]);
+        }
+
+        if (i > written) {
+            written = i;
+
+            /* publish them, use first subscriber CID - works better than the originator */
+            if ((err_info = sr_shmsub_multi_notify_write_event(multi_sub_shm, sub_cid, request_id, 0, SR_SUB_EV_NOTIF,
+                    NULL, NULL, sub_count, NULL, NULL, NULL, 0, ly_mod->name))) {
+                goto cleanup_ext_sub_unlock;
+            }
 
-    if (wait) {
-        /* wait until the event is processed */
-        if ((err_info = sr_shmsub_notify_wait_wr((sr_sub_shm_t *)multi_sub_shm, SR_SUB_EV_NONE, 1, conn->cid,
-                &shm_data_sub, timeout_ms, &cb_err_info))) {
-            if (err_info->err[0].err_code == SR_ERR_TIME_OUT) {
-                goto cleanup;
-            } else {
-                goto cleanup_sub_unlock;
+            /* notify all subscribers using event pipe, once for all the notifications */
+            for (i = 0; i < notif_sub_count; ++i) {
+                if (ATOMIC_LOAD_RELAXED(notif_subs[i].suspended)) {
+                    /* skip suspended subscribers */
+                    continue;
+                }
+
+                if ((err_info = sr_shmsub_notify_evpipe(notif_subs[i].evpipe_num, SR_EVPIPE_EV_NOTIF))) {
+                    goto cleanup_ext_sub_unlock;
+                }
             }
         }
 
-        /* we do not care about an error */
-        sr_errinfo_free(&cb_err_info);
+        if (written < notif_count) {
+            /* the ring is full */
+            timeout_abs = &full_timeout_abs;
+        } else if (wait) {
+            timeout_abs = &wait_timeout_abs;
+        } else {
+            /* done */
+            goto cleanup_ext_sub_unlock;
+        }
+    }
+
+    /* EXT READ UNLOCK */
+    sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 0, __func__);
+
+    /* wait for the subscribers, but check the subscriptions periodically in case some of them die */
+    sr_timeouttime_get(&step_abs, 0);
+    wait_ms = sr_time_sub_ms(timeout_abs, &step_abs);
+    if (wait_ms > 0) {
+        sr_timeouttime_get(&step_abs, (wait_ms < SR_NOTIF_RING_WAIT_STEP) ? wait_ms : SR_NOTIF_RING_WAIT_STEP);
+        ret = sr_shmsub_notif_ring_wait(multi_sub_shm, conn->cid, &step_abs);
     }
 
-cleanup_sub_unlock:
     /* SUB WRITE UNLOCK */
     sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, conn->cid, __func__);
 
-    /* success */
-    goto cleanup;
+    if (wait_ms <= 0) {
+        if (written == notif_count) {
+            sr_errinfo_new(&err_info, SR_ERR_TIME_OUT, "Waiting for \"%s\" notification ID %" PRIu32
+                    " to be processed timed out.", ly_mod->name, request_id);
+        } else {
+            sr_errinfo_new(&err_info, SR_ERR_TIME_OUT, "Waiting for subscribers of \"%s\" notifications timed out, "
+                    "the notification ring is full (%" PRIu32 " of %" PRIu32 " notifications sent).", ly_mod->name,
+                    written, notif_count);
+        }
+        goto cleanup;
+    } else if (ret) {
+        SR_ERRINFO_COND(&err_info, __func__, ret);
+        goto cleanup;
+    }
+    goto retry;
 
 cleanup_ext_sub_unlock:
     /* SUB WRITE UNLOCK */
@@ -2799,7 +3606,11 @@ cleanup_ext_unlock:
     sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 0, __func__);
 
 cleanup:
-    free(notif_lyb);
+    for (i = 0; notif_lybs && (i < notif_count); ++i) {
+        free(notif_lybs[i]);
+    }
+    free(notif_lybs);
+    free(notif_lyb_lens);
     sr_shm_clear(&shm_sub);
     sr_shm_clear(&shm_data_sub);
     return err_info;
@@ -2837,9 +3648,15 @@ sr_shmsub_change_listen_is_new_event(sr_multi_sub_shm_t *multi_sub_shm, struct m
         return 0;
     }
 
-    /* priority */
-    if (priority != sub->priority) {
-        return 0;
+    /* priority, the parallel group and asynchronous events are notified regardless of it */
+    if (!ATOMIC_LOAD_RELAXED(multi_sub_shm->async)) {
+        if (sub->opts & SR_SUBSCR_PARALLEL) {
+            if (!ATOMIC_LOAD_RELAXED(multi_sub_shm->parallel)) {
+                return 0;
+            }
+        } else if (priority != sub->priority) {
+            return 0;
+        }
     }
 
     /* subscription options and event */
@@ -2850,50 +3667,6 @@ sr_shmsub_change_listen_is_new_event(sr_multi_sub_shm_t *multi_sub_shm, struct m
     return 1;
 }
 
-/**
- * @brief Whether there is a change (some diff) for the subscription.
- *
- * @param[in] sub Change subscription.
- * @param[in] diff Full diff for the module.
- * @return 0 if not, non-zero if there is.
- */
-static int
-sr_shmsub_change_listen_filter_is_valid(struct modsub_changesub_s *sub, const struct lyd_node *diff)
-{
-    struct ly_set *set;
-    const struct lyd_node *elem;
-    uint32_t i;
-    enum edit_op op;
-    int ret = 0;
-    LY_ERR lyrc;
-
-    if (!sub->xpath) {
-        return 1;
-    }
-
-    lyrc = lyd_find_xpath(diff, sub->xpath, &set);
-    assert(!lyrc);
-    (void)lyrc;
-
-    for (i = 0; i < set->count; ++i) {
-        LYD_TREE_DFS_BEGIN(set->dnodes[i], elem) {
-            op = sr_edit_diff_find_oper(elem, 1, NULL);
-            assert(op);
-            if (op != EDIT_NONE) {
-                ret = 1;
-                break;
-            }
-            LYD_TREE_DFS_END(set->dnodes[i], elem);
-        }
-        if (ret) {
-            break;
-        }
-    }
-    ly_set_free(set, NULL);
-
-    return ret;
-}
-
 /**
  * @brief Write the result of having processed a multi-subscriber event.
  *
@@ -3044,6 +3817,7 @@ struct info_sub_s {
     sr_sub_event_t event;
     uint32_t request_id;
     uint32_t priority;
+    struct timespec event_ts;
 };
 
 /**
@@ -3091,6 +3865,9 @@ sr_shmsub_change_listen_relock(sr_multi_sub_shm_t *multi_sub_shm, sr_lock_mode_t
                 sr_shmsub_change_listen_event_is_valid(SR_SUB_EV_ABORT, sub->opts)) {
             /* update session */
             ev_sess->ev = SR_SUB_EV_ABORT;
+            if ((*err_info = sr_change_log_session_diff(ev_sess))) {
+                return 1;
+            }
             if (lyd_diff_reverse_all(ev_sess->dt[ev_sess->ds].diff, &abort_diff)) {
                 sr_errinfo_new_ly(err_info, ev_sess->conn->ly_ctx, NULL);
                 SR_ERRINFO_INT(err_info);
@@ -3098,6 +3875,8 @@ sr_shmsub_change_listen_relock(sr_multi_sub_shm_t *multi_sub_shm, sr_lock_mode_t
             }
             lyd_free_all(ev_sess->dt[ev_sess->ds].diff);
             ev_sess->dt[ev_sess->ds].diff = abort_diff;
+            free(ev_sess->dt[ev_sess->ds].change_log);
+            ev_sess->dt[ev_sess->ds].change_log = NULL;
 
             SR_LOG_INF("EV LISTEN: \"%s\" \"%s\" ID %" PRIu32 " priority %" PRIu32 " processing (self-generated).",
                     module_name, sr_ev2str(SR_SUB_EV_ABORT), sub_info->request_id, sub_info->priority);
@@ -3154,16 +3933,18 @@ sr_shmsub_change_listen_process_module_events(struct modsub_change_s *change_sub
     sr_error_info_t *err_info = NULL;
     uint32_t i, data_len = 0, valid_subscr_count;
     char *data = NULL, *shm_data_ptr;
-    int ret = SR_ERR_OK;
+    int ret = SR_ERR_OK, processed = 0, diff_lyb_len = 0;
+    char *diff_lyb = NULL, *change_log;
     sr_lock_mode_t sub_lock = SR_LOCK_NONE;
-    struct lyd_node *diff;
+    struct lyd_node *diff = NULL;
     sr_data_t *edit_data;
     sr_error_t err_code = SR_ERR_OK;
     struct modsub_changesub_s *change_sub;
     sr_multi_sub_shm_t *multi_sub_shm;
     sr_shm_t shm_data_sub = SR_SHM_INITIALIZER;
     sr_session_ctx_t *ev_sess = NULL;
-    struct info_sub_s sub_info;
+    struct info_sub_s sub_info = {0};
+    struct timespec cb_start;
 
     multi_sub_shm = (sr_multi_sub_shm_t *)change_subs->sub_shm.addr;
 
@@ -3204,22 +3985,48 @@ sr_shmsub_change_listen_process_module_events(struct modsub_change_s *change_sub
     sub_info.event = ATOMIC_LOAD_RELAXED(multi_sub_shm->event);
     sub_info.request_id = ATOMIC_LOAD_RELAXED(multi_sub_shm->request_id);
     sub_info.priority = ATOMIC_LOAD_RELAXED(multi_sub_shm->priority);
+    sub_info.event_ts = multi_sub_shm->event_ts;
 
     /* parse originator name and data (while creating the event session) */
     if ((err_info = _sr_session_start(conn, change_subs->ds, sub_info.event, &shm_data_ptr, &ev_sess))) {
         goto cleanup;
     }
 
-    /* parse event diff */
-    if (lyd_parse_data_mem(conn->ly_ctx, shm_data_ptr, LYD_LYB, LYD_PARSE_ONLY | LYD_PARSE_STRICT, 0, &diff)) {
-        sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
-        SR_ERRINFO_INT(&err_info);
-        goto cleanup;
+    if (sr_change_log_is(shm_data_ptr)) {
+        /* changes published as a change log, the diff is built only if needed */
+        change_log = malloc(sr_change_log_size(shm_data_ptr));
+        SR_CHECK_MEM_GOTO(!change_log, err_info, cleanup);
+        memcpy(change_log, shm_data_ptr, sr_change_log_size(shm_data_ptr));
+        ev_sess->dt[ev_sess->ds].change_log = change_log;
+        goto process_log;
+    }
+
+    /* reuse the diff parsed by a previous event of the same request, if unchanged */
+    diff_lyb_len = lyd_lyb_data_length(shm_data_ptr);
+    SR_CHECK_INT_GOTO(diff_lyb_len < 0, err_info, cleanup);
+    sr_conn_change_diff_cache_take(conn, change_subs->module_name, change_subs->ds, sub_info.request_id, shm_data_ptr,
+            diff_lyb_len, &diff, &diff_lyb);
+    if (!diff) {
+        /* parse event diff */
+        if (lyd_parse_data_mem(conn->ly_ctx, shm_data_ptr, LYD_LYB, LYD_PARSE_ONLY | LYD_PARSE_STRICT, 0, &diff)) {
+            sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
+            SR_ERRINFO_INT(&err_info);
+            goto cleanup;
+        }
+
+        if ((sub_info.event == SR_SUB_EV_UPDATE) || (sub_info.event == SR_SUB_EV_CHANGE)) {
+            /* the diff may be cached for the next event, keep the LYB to compare */
+            diff_lyb = malloc(diff_lyb_len);
+            if (diff_lyb) {
+                memcpy(diff_lyb, shm_data_ptr, diff_lyb_len);
+            }
+        }
     }
 
     /* assign to session */
     ev_sess->dt[ev_sess->ds].diff = diff;
 
+process_log:
     /* process event */
     SR_LOG_INF("EV LISTEN: \"%s\" \"%s\" ID %" PRIu32 " priority %" PRIu32 " processing (remaining %" PRIu32 " subscribers).",
             change_subs->module_name, sr_ev2str(sub_info.event), sub_info.request_id, sub_info.priority,
@@ -3237,18 +4044,29 @@ sr_shmsub_change_listen_process_module_events(struct modsub_change_s *change_sub
         }
 
 process_event:
+        if (change_sub->xpath && (err_info = sr_change_log_session_diff(ev_sess))) {
+            goto cleanup;
+        }
+        if (!sr_shmsub_change_filter_is_valid(change_sub->xpath, &change_sub->filter, ev_sess->dt[ev_sess->ds].diff)) {
+            /* filtered out and not counted by the originator, just remember the event was processed */
+            ATOMIC_STORE_RELAXED(change_sub->request_id, sub_info.request_id);
+            ATOMIC_STORE_RELAXED(change_sub->event, sub_info.event);
+            continue;
+        }
+        processed = 1;
+
         /* SUB UNLOCK */
         sr_rwunlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, sub_lock, conn->cid, __func__);
         sub_lock = SR_LOCK_NONE;
 
-        /* call callback if there are some changes */
-        if (sr_shmsub_change_listen_filter_is_valid(change_sub, diff)) {
-            ret = change_sub->cb(ev_sess, change_sub->sub_id, change_subs->module_name, change_sub->xpath,
-                    sr_ev2api(sub_info.event), sub_info.request_id, change_sub->private_data);
-        } else {
-            /* filtered out */
-            ATOMIC_INC_RELAXED(change_sub->filtered_out);
-        }
+        /* call callback, there are some changes */
+        SR_TRACE(sub_process_start, change_subs->module_name, change_sub->sub_id, sub_info.request_id, sub_info.event);
+        sr_timeouttime_get(&cb_start, 0);
+        ret = change_sub->cb(ev_sess, change_sub->sub_id, change_subs->module_name, change_sub->xpath,
+                sr_ev2api(sub_info.event), sub_info.request_id, change_sub->private_data);
+        SR_TRACE(sub_process_end, change_subs->module_name, change_sub->sub_id, sub_info.request_id, ret);
+        sr_shmext_change_sub_stats(conn, change_subs->module_name, change_subs->ds, change_sub->sub_id,
+                &sub_info.event_ts, &cb_start);
 
         /* SUB READ LOCK */
         if (sr_shmsub_change_listen_relock(multi_sub_shm, SR_LOCK_READ, &sub_info, change_sub,
@@ -3283,6 +4101,11 @@ process_event:
         ATOMIC_STORE_RELAXED(change_sub->event, ATOMIC_LOAD_RELAXED(multi_sub_shm->event));
     }
 
+    if (!processed) {
+        /* all the subscriptions were filtered out, the event is not ours to finish */
+        goto cleanup;
+    }
+
     /*
      * prepare additional event data written into subscription data SHM
      */
@@ -3345,12 +4168,92 @@ cleanup:
         sr_rwunlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, sub_lock, conn->cid, __func__);
     }
 
+    if (diff_lyb && ev_sess && ((sub_info.event == SR_SUB_EV_UPDATE) || (sub_info.event == SR_SUB_EV_CHANGE))) {
+        /* cache the diff for the next event of this request, it is parsed only once if not changed */
+        sr_conn_change_diff_cache_store(conn, change_subs->module_name, change_subs->ds, sub_info.request_id, diff_lyb,
+                diff_lyb_len, ev_sess->dt[ev_sess->ds].diff);
+        ev_sess->dt[ev_sess->ds].diff = NULL;
+    } else {
+        free(diff_lyb);
+    }
+
     free(data);
     sr_session_stop(ev_sess);
     sr_shm_clear(&shm_data_sub);
     return err_info;
 }
 
+/**
+ * @brief Sub data SHM output of printed data.
+ */
+struct sr_shmsub_data_out_s {
+    sr_shm_t *shm_data_sub;         /**< Sub data SHM to print into. */
+    size_t len;                     /**< Length of the data printed so far. */
+    sr_error_info_t *err_info;      /**< Error info of a failed remap. */
+};
+
+/**
+ * @brief Write callback printing data directly into sub data SHM, which is grown as needed.
+ *
+ * @param[in] user_data Sub data SHM output.
+ * @param[in] buf Data to write.
+ * @param[in] count Length of @p buf.
+ * @return Number of written bytes, -1 on error.
+ */
+static ssize_t
+sr_shmsub_data_out_write(void *user_data, const void *buf, size_t count)
+{
+    struct sr_shmsub_data_out_s *dout = user_data;
+
+    /* only grow the SHM while printing, the size classes make it grow exponentially */
+    if ((dout->len + count > dout->shm_data_sub->size) &&
+            (dout->err_info = sr_shmsub_data_open_remap(NULL, NULL, -1, dout->shm_data_sub, dout->len + count))) {
+        return -1;
+    }
+
+    memcpy(dout->shm_data_sub->addr + dout->len, buf, count);
+    dout->len += count;
+    return count;
+}
+
+/**
+ * @brief Print data in LYB directly into sub data SHM, without an intermediate buffer.
+ *
+ * @param[in] shm_data_sub Opened and mapped sub data SHM.
+ * @param[in] data Data to print.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_data_print_lyb(sr_shm_t *shm_data_sub, const struct lyd_node *data)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_shmsub_data_out_s dout = {0};
+    struct ly_out *out = NULL;
+
+    dout.shm_data_sub = shm_data_sub;
+    if (ly_out_new_clb(sr_shmsub_data_out_write, &dout, &out)) {
+        SR_ERRINFO_MEM(&err_info);
+        goto cleanup;
+    }
+
+    if (lyd_print_all(out, data, LYD_LYB, 0)) {
+        if (dout.err_info) {
+            err_info = dout.err_info;
+            dout.err_info = NULL;
+        } else if (data) {
+            sr_errinfo_new_ly(&err_info, LYD_CTX(data), NULL);
+        } else {
+            SR_ERRINFO_INT(&err_info);
+        }
+        goto cleanup;
+    }
+
+cleanup:
+    ly_out_free(out, NULL, 0);
+    sr_errinfo_free(&dout.err_info);
+    return err_info;
+}
+
 /**
  * @brief Write the result of having processed a single-subscriber event.
  *
@@ -3449,6 +4352,8 @@ sr_shmsub_oper_get_listen_process_module_events(struct modsub_operget_s *oper_ge
     uint32_t i, data_len = 0, request_id;
     char *data = NULL, *request_xpath = NULL, *shm_data_ptr, *origin;
     sr_error_t err_code = SR_ERR_OK;
+    sr_oper_get_hints_t hints;
+    struct timespec event_ts, cb_start;
     struct modsub_opergetsub_s *oper_get_sub;
     struct lyd_node *parent = NULL, *orig_parent, *node;
     sr_sub_shm_t *sub_shm;
@@ -3479,6 +4384,7 @@ sr_shmsub_oper_get_listen_process_module_events(struct modsub_operget_s *oper_ge
             continue;
         }
         request_id = ATOMIC_LOAD_RELAXED(sub_shm->request_id);
+        event_ts = sub_shm->event_ts;
 
         /* open sub data SHM */
         if ((err_info = sr_shmsub_data_open_remap(oper_get_subs->module_name, "oper", sr_str_hash(oper_get_sub->path,
@@ -3497,6 +4403,13 @@ sr_shmsub_oper_get_listen_process_module_events(struct modsub_operget_s *oper_ge
         SR_CHECK_MEM_GOTO(!request_xpath, err_info, error_rdunlock);
         shm_data_ptr += sr_strshmlen(request_xpath);
 
+        /* parse hints */
+        memcpy(&hints, shm_data_ptr, sizeof hints);
+        shm_data_ptr += SR_SHM_SIZE(sizeof hints);
+        ev_sess->ev_data.oper_max_depth = hints.max_depth;
+        ev_sess->ev_data.oper_limit = hints.limit;
+        ev_sess->ev_data.oper_opts = hints.get_oper_opts;
+
         /* parse data parent */
         if (lyd_parse_data_mem(conn->ly_ctx, shm_data_ptr, LYD_LYB, LYD_PARSE_ONLY | LYD_PARSE_STRICT, 0, &parent)) {
             sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
@@ -3517,8 +4430,12 @@ sr_shmsub_oper_get_listen_process_module_events(struct modsub_operget_s *oper_ge
 
         /* call callback */
         orig_parent = parent;
+        SR_TRACE(sub_process_start, oper_get_subs->module_name, oper_get_sub->sub_id, request_id, SR_SUB_EV_OPER);
+        sr_timeouttime_get(&cb_start, 0);
         err_code = oper_get_sub->cb(ev_sess, oper_get_sub->sub_id, oper_get_subs->module_name, oper_get_sub->path,
                 request_xpath[0] ? request_xpath : NULL, request_id, &parent, oper_get_sub->private_data);
+        SR_TRACE(sub_process_end, oper_get_subs->module_name, oper_get_sub->sub_id, request_id, err_code);
+        sr_shmext_oper_get_sub_stats(conn, oper_get_subs->module_name, oper_get_sub->sub_id, &event_ts, &cb_start);
 
         /* go again to the top-level root for printing */
         if (parent) {
@@ -3548,16 +4465,11 @@ sr_shmsub_oper_get_listen_process_module_events(struct modsub_operget_s *oper_ge
         ATOMIC_STORE_RELAXED(oper_get_sub->request_id, request_id);
 
         /*
-         * prepare additional event data written into subscription SHM (after the structure)
+         * prepare additional event data written into subscription SHM (after the structure),
+         * the data are printed directly into it once locked
          */
-        if (err_code) {
-            if ((err_info = sr_shmsub_prepare_error(err_code, ev_sess, &data, &data_len))) {
-                goto error;
-            }
-        } else {
-            if ((err_info = sr_lyd_print_lyb(parent, &data, &data_len))) {
-                goto error;
-            }
+        if (err_code && (err_info = sr_shmsub_prepare_error(err_code, ev_sess, &data, &data_len))) {
+            goto error;
         }
 
         /* SUB WRITE LOCK */
@@ -3566,6 +4478,10 @@ sr_shmsub_oper_get_listen_process_module_events(struct modsub_operget_s *oper_ge
             goto error;
         }
 
+        if (!err_code && (err_info = sr_shmsub_data_print_lyb(&shm_data_sub, parent))) {
+            goto error_wrunlock;
+        }
+
         /* finish event */
         if ((err_info = sr_shmsub_listen_write_event(sub_shm, err_code, &shm_data_sub, data, data_len,
                 oper_get_sub->path, err_code ? "fail" : "success"))) {
@@ -3672,26 +4588,46 @@ cleanup:
 }
 
 /**
- * @brief Check whether particular cached data are still valid.
+ * @brief Get the time operational poll cached data are refreshed after. The data are refreshed in advance so that
+ * they are replaced before their validity period elapses.
+ *
+ * @param[in] valid_ms Validity period of the data.
+ * @return Refresh period of the data in milliseconds.
+ */
+static uint32_t
+sr_shmsub_oper_poll_refresh_ms(uint32_t valid_ms)
+{
+    uint32_t prefetch_ms;
+
+    prefetch_ms = valid_ms / 4;
+    if (prefetch_ms > SR_OPER_POLL_PREFETCH_TIMEOUT) {
+        prefetch_ms = SR_OPER_POLL_PREFETCH_TIMEOUT;
+    }
+
+    return valid_ms - prefetch_ms;
+}
+
+/**
+ * @brief Check whether particular cached data are still valid and need not be refreshed yet.
  *
- * @param[in] cache Cached data to check.
+ * @param[in] timestamp Timestamp of the cached data to check.
  * @param[in] valid_ms Validity period of the data.
- * @param[out] invalid_in Optional relative time when the cache will become invalid, set only if valid.
+ * @param[out] invalid_in Optional relative time when the cache will need to be refreshed, set only if valid.
  * @return Whether the cache data are valid or not.
  */
 static int
-sr_shmsub_oper_poll_listen_is_cache_valid(const struct sr_oper_poll_cache_s *cache, uint32_t valid_ms,
+sr_shmsub_oper_poll_listen_is_cache_valid(const struct timespec *timestamp, uint32_t valid_ms,
         struct timespec *invalid_in)
 {
     struct timespec cur_ts, timeout_ts;
 
-    if (!cache->timestamp.tv_sec) {
+    if (!timestamp->tv_sec) {
         /* uninitialized */
         return 0;
     }
 
     sr_realtime_get(&cur_ts);
-    timeout_ts = sr_time_ts_add(&cache->timestamp, valid_ms);
+    timeout_ts = sr_time_ts_add(timestamp, sr_shmsub_oper_poll_refresh_ms(valid_ms));
     if (sr_time_cmp(&timeout_ts, &cur_ts) <= 0) {
         /* not valid */
         return 0;
@@ -3711,12 +4647,13 @@ sr_shmsub_oper_poll_listen_process_module_events(struct modsub_operpoll_s *oper_
     sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
     uint32_t i, j;
     sr_data_t *data = NULL;
+    struct lyd_node *new_data;
     const struct lys_module *ly_mod;
     struct sr_mod_info_s mod_info = {0};
     sr_lock_mode_t change_sub_lock = SR_LOCK_NONE;
     struct sr_oper_poll_cache_s *cache;
     struct modsub_operpollsub_s *oper_poll_sub;
-    struct timespec invalid_in;
+    struct timespec invalid_in, timestamp;
     int found;
     sr_session_ctx_t *ev_sess = NULL;
     sr_get_options_t get_opts;
@@ -3749,6 +4686,7 @@ sr_shmsub_oper_poll_listen_process_module_events(struct modsub_operpoll_s *oper_
 
     for (i = 0; i < oper_poll_subs->sub_count; ++i) {
         oper_poll_sub = &oper_poll_subs->subs[i];
+        new_data = NULL;
 
         /* find the oper cache entry */
         cache = NULL;
@@ -3777,12 +4715,16 @@ sr_shmsub_oper_poll_listen_process_module_events(struct modsub_operpoll_s *oper_
             cache->data = NULL;
             memset(&cache->timestamp, 0, sizeof cache->timestamp);
 
+            if (oper_poll_sub->opts & SR_SUBSCR_OPER_POLL_SHARED) {
+                sr_oper_poll_shm_remove(oper_poll_subs->module_name, oper_poll_sub->path, conn->cid);
+            }
+
             SR_LOG_INF("No oper get subscription \"%s\" to cache.", oper_poll_sub->path);
             goto finish_iter;
         }
 
         /* 2) check cache validity */
-        if (sr_shmsub_oper_poll_listen_is_cache_valid(cache, oper_poll_sub->valid_ms, &invalid_in)) {
+        if (sr_shmsub_oper_poll_listen_is_cache_valid(&cache->timestamp, oper_poll_sub->valid_ms, &invalid_in)) {
             /* update when to wake up */
             if (wake_up_in && (!wake_up_in->tv_sec || (sr_time_cmp(&invalid_in, wake_up_in) < 0))) {
                 *wake_up_in = invalid_in;
@@ -3790,6 +4732,16 @@ sr_shmsub_oper_poll_listen_process_module_events(struct modsub_operpoll_s *oper_
             goto finish_iter;
         }
 
+        /* 3) try to use the data shared by another subscription, if retrieved recently enough */
+        if ((oper_poll_sub->opts & SR_SUBSCR_OPER_POLL_SHARED) &&
+                sr_oper_poll_shm_load(ly_mod, oper_poll_sub->path, conn->content_id, &new_data, &timestamp)) {
+            if ((sr_time_cmp(&timestamp, &cache->timestamp) > 0) &&
+                    sr_shmsub_oper_poll_listen_is_cache_valid(&timestamp, oper_poll_sub->valid_ms, NULL)) {
+                goto update_cache;
+            }
+            lyd_free_siblings(new_data);
+        }
+
         /* create a session */
         if ((err_info = _sr_session_start(conn, SR_DS_OPERATIONAL, SR_SUB_EV_NONE, NULL, &ev_sess))) {
             goto finish_iter;
@@ -3805,13 +4757,28 @@ sr_shmsub_oper_poll_listen_process_module_events(struct modsub_operpoll_s *oper_
         if (err_info) {
             goto finish_iter;
         }
+        new_data = NULL;
+        if (data) {
+            new_data = data->tree;
+            data->tree = NULL;
+        }
+        sr_release_data(data);
+        data = NULL;
+        sr_realtime_get(&timestamp);
+
+        if (oper_poll_sub->opts & SR_SUBSCR_OPER_POLL_SHARED) {
+            /* share the data */
+            sr_oper_poll_shm_store(ly_mod, mod_info.mods[0].ds_plg[SR_DS_OPERATIONAL], oper_poll_sub->path,
+                    conn->cid, conn->content_id, oper_poll_sub->valid_ms, &timestamp, new_data);
+        }
+
+update_cache:
 
         /* generate diff if supported */
         if (oper_poll_sub->opts & SR_SUBSCR_OPER_POLL_DIFF) {
             /* prepare mod info */
             mod_info.data = cache->data;
-            if (lyd_diff_siblings(cache->data, data->tree, LYD_DIFF_DEFAULTS, &mod_info.diff)) {
-                sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
+            if ((err_info = sr_diff_siblings_fast(cache->data, new_data, &mod_info.diff))) {
                 goto finish_iter;
             }
 
@@ -3833,16 +4800,15 @@ sr_shmsub_oper_poll_listen_process_module_events(struct modsub_operpoll_s *oper_
 
         /* store in cache and update the timestamp */
         lyd_free_siblings(cache->data);
-        cache->data = mod_info.data = NULL;
-        if (data) {
-            cache->data = mod_info.data = data->tree;
-            data->tree = NULL;
-        }
-        sr_release_data(data);
-        sr_realtime_get(&cache->timestamp);
+        cache->data = mod_info.data = new_data;
+        new_data = NULL;
+        cache->timestamp = timestamp;
 
         /* update when to wake up */
-        invalid_in = sr_time_ts_add(NULL, oper_poll_sub->valid_ms);
+        if (!sr_shmsub_oper_poll_listen_is_cache_valid(&cache->timestamp, oper_poll_sub->valid_ms, &invalid_in)) {
+            /* refresh right away */
+            invalid_in = sr_time_ts_add(NULL, 1);
+        }
         if (wake_up_in && (!wake_up_in->tv_sec || (sr_time_cmp(&invalid_in, wake_up_in) < 0))) {
             *wake_up_in = invalid_in;
         }
@@ -3850,6 +4816,8 @@ sr_shmsub_oper_poll_listen_process_module_events(struct modsub_operpoll_s *oper_
         SR_LOG_INF("Successful \"%s\" \"oper poll\" cache update.", oper_poll_sub->path);
 
 finish_iter:
+        lyd_free_siblings(new_data);
+
         /* CACHE DATA WRITE UNLOCK */
         sr_rwunlock(&cache->data_lock, SR_CONN_OPER_CACHE_DATA_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__);
 
@@ -3918,7 +4886,7 @@ sr_shmsub_oper_poll_get_sub_change_notify_evpipe(sr_conn_ctx_t *conn, const char
     for (i = 0; i < shm_mod->oper_poll_sub_count; ++i) {
         if (!strcmp(oper_get_path, conn->ext_shm.addr + shm_subs[i].xpath)) {
             /* relevant oper get subscriptions change for this oper poll subscription */
-            if ((err_info = sr_shmsub_notify_evpipe(shm_subs[i].evpipe_num))) {
+            if ((err_info = sr_shmsub_notify_evpipe(shm_subs[i].evpipe_num, SR_EVPIPE_EV_OPER_POLL))) {
                 goto cleanup_opergetsub_ext_unlock;
             }
         }
@@ -4183,6 +5151,7 @@ sr_shmsub_rpc_listen_process_rpc_events(struct opsub_rpc_s *rpc_subs, sr_conn_ct
     sr_shm_t shm_data_sub = SR_SHM_INITIALIZER;
     sr_session_ctx_t *ev_sess = NULL;
     struct info_sub_s sub_info;
+    struct timespec cb_start;
 
     multi_sub_shm = (sr_multi_sub_shm_t *)rpc_subs->sub_shm.addr;
 
@@ -4246,6 +5215,7 @@ sr_shmsub_rpc_listen_process_rpc_events(struct opsub_rpc_s *rpc_subs, sr_conn_ct
     sub_info.event = ATOMIC_LOAD_RELAXED(multi_sub_shm->event);
     sub_info.request_id = ATOMIC_LOAD_RELAXED(multi_sub_shm->request_id);
     sub_info.priority = ATOMIC_LOAD_RELAXED(multi_sub_shm->priority);
+    sub_info.event_ts = multi_sub_shm->event_ts;
 
     /* go to the operation, not the root */
     input_op = input;
@@ -4278,10 +5248,14 @@ process_event:
         lyd_free_all(output);
 
         /* call callback */
+        SR_TRACE(sub_process_start, rpc_subs->path, rpc_sub->sub_id, sub_info.request_id, sub_info.event);
+        sr_timeouttime_get(&cb_start, 0);
         if ((err_info = sr_shmsub_rpc_listen_call_callback(rpc_sub, ev_sess, input_op, sub_info.event,
                 sub_info.request_id, &output, &ret))) {
             goto cleanup;
         }
+        SR_TRACE(sub_process_end, rpc_subs->path, rpc_sub->sub_id, sub_info.request_id, ret);
+        sr_shmext_rpc_sub_stats(conn, rpc_subs->path, rpc_sub->sub_id, &sub_info.event_ts, &cb_start);
 
         /* SUB READ LOCK */
         if (sr_shmsub_rpc_listen_relock(multi_sub_shm, SR_LOCK_READ, &sub_info, rpc_sub, rpc_subs->path, ret,
@@ -4367,20 +5341,33 @@ cleanup:
 /**
  * @brief Whether a notification is valid (not filtered out) for a notif subscription.
  *
- * @param[in] input Operation input data tree.
+ * @param[in] notif Notification data tree.
+ * @param[in] filter Compiled subscription XPath filter.
  * @param[in] xpath Full subscription XPath.
  * @return 0 if not, non-zero is it is.
  */
 static int
-sr_shmsub_notif_listen_filter_is_valid(const struct lyd_node *notif, const char *xpath)
+sr_shmsub_notif_listen_filter_is_valid(const struct lyd_node *notif, const sr_xpath_filter_t *filter, const char *xpath)
 {
     sr_error_info_t *err_info = NULL;
+    struct ly_set *set;
     ly_bool result;
 
     if (!xpath) {
         return 1;
     }
 
+    if (filter->steps) {
+        /* compiled simple path */
+        if ((err_info = sr_xpath_filter_find(filter, xpath, notif, &set))) {
+            sr_errinfo_free(&err_info);
+            return 0;
+        }
+        result = set->count ? 1 : 0;
+        ly_set_free(set, NULL);
+        return result;
+    }
+
     if (lyd_eval_xpath(notif, xpath, &result)) {
         SR_ERRINFO_INT(&err_info);
         sr_errinfo_free(&err_info);
@@ -4397,16 +5384,28 @@ sr_error_info_t *
 sr_shmsub_notif_listen_process_module_events(struct modsub_notif_s *notif_subs, sr_conn_ctx_t *conn)
 {
     sr_error_info_t *err_info = NULL;
-    uint32_t i, request_id;
-    struct lyd_node *orig_notif = NULL, *notif_dup = NULL, *notif, *notif_op;
-    const struct lyd_node *denied_node;
+    uint32_t i, j, request_id, min_cursor = 0, notif_count = 0, off, *cursors = NULL;
+    int *suspended = NULL, valid_sub = 0;
+    struct {
+        uint32_t request_id;
+        sr_session_ctx_t *ev_sess;
+        struct lyd_node *notif;
+        struct timespec notif_ts;
+        struct timespec event_ts;
+    } *notifs = NULL;
+    struct lyd_node *orig_notif;
+    struct lyd_node *notif_op = NULL;
+    const struct lyd_node *notif;
+    struct sr_nacm_notif_cache nacm_cache = {0};
     struct ly_in *in = NULL;
-    struct timespec notif_ts;
     char *shm_data_ptr;
+    void *mem;
     sr_multi_sub_shm_t *multi_sub_shm;
     sr_shm_t shm_data_sub = SR_SHM_INITIALIZER;
-    sr_session_ctx_t *ev_sess = NULL;
+    sr_notif_ring_t *ring;
+    sr_notif_ring_entry_t *entry;
     struct modsub_notifsub_s *sub;
+    struct timespec cb_start;
 
     multi_sub_shm = (sr_multi_sub_shm_t *)notif_subs->sub_shm.addr;
 
@@ -4416,6 +5415,22 @@ sr_shmsub_notif_listen_process_module_events(struct modsub_notif_s *notif_subs,
         goto cleanup;
     }
 
+    /* learn the last notification processed by each subscription */
+    cursors = malloc(notif_subs->sub_count * sizeof *cursors);
+    suspended = malloc(notif_subs->sub_count * sizeof *suspended);
+    SR_CHECK_MEM_GOTO(notif_subs->sub_count && (!cursors || !suspended), err_info, cleanup);
+    for (i = 0; i < notif_subs->sub_count; ++i) {
+        if ((err_info = sr_shmext_notif_sub_cursor(conn, notif_subs->module_name, notif_subs->subs[i].sub_id, -1,
+                &cursors[i], &suspended[i]))) {
+            goto cleanup;
+        }
+
+        if (!suspended[i] && (!valid_sub || ((int32_t)(cursors[i] - min_cursor) < 0))) {
+            min_cursor = cursors[i];
+            valid_sub = 1;
+        }
+    }
+
     /* SUB READ LOCK */
     if ((err_info = sr_rwlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__,
             NULL, NULL))) {
@@ -4433,126 +5448,139 @@ sr_shmsub_notif_listen_process_module_events(struct modsub_notif_s *notif_subs,
     if ((err_info = sr_shmsub_data_open_remap(notif_subs->module_name, "notif", -1, &shm_data_sub, 0))) {
         goto cleanup_rdunlock;
     }
-    shm_data_ptr = shm_data_sub.addr;
+    ring = (shm_data_sub.size < sizeof *ring) ? NULL : (sr_notif_ring_t *)shm_data_sub.addr;
 
-    /* parse originator name and data (while creating the event session) */
-    if ((err_info = _sr_session_start(conn, SR_DS_OPERATIONAL, SR_SUB_EV_NOTIF, &shm_data_ptr, &ev_sess))) {
-        goto cleanup_rdunlock;
-    }
+    /* parse all the notifications not yet processed by some subscription, from the oldest */
+    off = ring ? ring->tail : 0;
+    for (j = 0; valid_sub && ring && (j < ring->count); ++j) {
+        entry = sr_shmsub_notif_ring_entry(ring, &off);
+        off += entry->size;
+        if ((int32_t)(entry->request_id - min_cursor) <= 0) {
+            /* processed by all our subscriptions */
+            continue;
+        }
 
-    /* parse timestamp */
-    memcpy(&notif_ts, shm_data_ptr, sizeof notif_ts);
-    shm_data_ptr += sizeof notif_ts;
+        mem = realloc(notifs, (notif_count + 1) * sizeof *notifs);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup_rdunlock);
+        notifs = mem;
+        memset(&notifs[notif_count], 0, sizeof *notifs);
+        notifs[notif_count].request_id = entry->request_id;
+        notifs[notif_count].event_ts = entry->event_ts;
+        ++notif_count;
 
-    /* parse notification */
-    ly_in_new_memory(shm_data_ptr, &in);
-    if (lyd_parse_op(conn->ly_ctx, NULL, in, LYD_LYB, LYD_TYPE_NOTIF_YANG, &orig_notif, NULL)) {
-        sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
-        SR_ERRINFO_INT(&err_info);
-        goto cleanup_rdunlock;
+        /* parse originator name and data (while creating the event session) */
+        shm_data_ptr = (char *)(entry + 1);
+        if ((err_info = _sr_session_start(conn, SR_DS_OPERATIONAL, SR_SUB_EV_NOTIF, &shm_data_ptr,
+                &notifs[notif_count - 1].ev_sess))) {
+            goto cleanup_rdunlock;
+        }
+
+        /* parse timestamp */
+        memcpy(&notifs[notif_count - 1].notif_ts, shm_data_ptr, sizeof notifs[notif_count - 1].notif_ts);
+        shm_data_ptr += sizeof notifs[notif_count - 1].notif_ts;
+
+        /* parse notification */
+        ly_in_new_memory(shm_data_ptr, &in);
+        if (lyd_parse_op(conn->ly_ctx, NULL, in, LYD_LYB, LYD_TYPE_NOTIF_YANG, &notifs[notif_count - 1].notif, NULL)) {
+            sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
+            SR_ERRINFO_INT(&err_info);
+            goto cleanup_rdunlock;
+        }
+        ly_in_free(in, 0);
+        in = NULL;
     }
 
     /* SUB READ UNLOCK */
     sr_rwunlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
 
-    /* process event */
-    SR_LOG_INF("EV LISTEN: \"%s\" \"notif\" ID %" PRIu32 " processing.", notif_subs->module_name, request_id);
+    /* process events */
+    for (j = 0; j < notif_count; ++j) {
+        SR_LOG_INF("EV LISTEN: \"%s\" \"notif\" ID %" PRIu32 " processing.", notif_subs->module_name,
+                notifs[j].request_id);
+        orig_notif = notifs[j].notif;
 
-    for (i = 0; i < notif_subs->sub_count; ++i) {
-        sub = &notif_subs->subs[i];
-        denied_node = NULL;
+        for (i = 0; i < notif_subs->sub_count; ++i) {
+            sub = &notif_subs->subs[i];
 
-        if (sub->sess->nacm_user && !strcmp(orig_notif->schema->module->name, "ietf-yang-push") &&
-                !strcmp(LYD_NAME(orig_notif), "push-change-update")) {
-            if (i == notif_subs->sub_count) {
-                /* last subscription, we can modify the notification */
-                notif = orig_notif;
-            } else {
-                if (!notif_dup) {
-                    /* create notification duplicate */
-                    if (lyd_dup_single(orig_notif, NULL, LYD_DUP_RECURSIVE, &notif_dup)) {
-                        sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
-                        goto cleanup;
-                    }
-                }
-                notif = notif_dup;
+            if (suspended[i] || ((int32_t)(notifs[j].request_id - cursors[i]) <= 0)) {
+                /* suspended or already processed by this subscription */
+                continue;
             }
 
-            /* push-change-update notif is filtered specially by NACM */
-            if ((err_info = sr_nacm_check_push_update_notif(sub->sess->nacm_user, notif, &denied_node))) {
-                goto cleanup;
+            if (sub->sess->nacm_user) {
+                /* check NACM, the decision is shared by all the subscriptions with the same NACM groups */
+                if ((err_info = sr_nacm_check_notif(&nacm_cache, sub->sess->nacm_user, orig_notif, &notif))) {
+                    goto cleanup;
+                }
+            } else {
+                /* use notif directly */
+                notif = orig_notif;
             }
-        } else {
-            /* use notif directly */
-            notif = orig_notif;
 
-            /* check NACM */
-            if (sub->sess->nacm_user && (err_info = sr_nacm_check_operation(sub->sess->nacm_user, notif, &denied_node))) {
-                goto cleanup;
+            if (notif) {
+                /* find the notification */
+                notif_op = (struct lyd_node *)notif;
+                if ((err_info = sr_ly_find_last_parent(&notif_op, LYS_NOTIF))) {
+                    goto cleanup;
+                }
             }
-        }
 
-        /* find the notification */
-        notif_op = notif;
-        if ((err_info = sr_ly_find_last_parent(&notif_op, LYS_NOTIF))) {
-            goto cleanup;
-        }
-
-        /* NACM and xpath filter */
-        if (!denied_node && sr_shmsub_notif_listen_filter_is_valid(notif_op, sub->xpath)) {
-            /* call callback */
-            if ((err_info = sr_notif_call_callback(ev_sess, sub->cb, sub->tree_cb, sub->private_data,
-                    SR_EV_NOTIF_REALTIME, sub->sub_id, notif_op, &notif_ts))) {
-                goto cleanup;
+            /* NACM and xpath filter */
+            if (notif && sr_shmsub_notif_listen_filter_is_valid(notif_op, &sub->filter, sub->xpath)) {
+                /* call callback */
+                SR_TRACE(sub_process_start, notif_subs->module_name, sub->sub_id, notifs[j].request_id, SR_SUB_EV_NOTIF);
+                sr_timeouttime_get(&cb_start, 0);
+                if ((err_info = sr_notif_call_callback(notifs[j].ev_sess, sub->cb, sub->tree_cb, sub->private_data,
+                        SR_EV_NOTIF_REALTIME, sub->sub_id, notif_op, &notifs[j].notif_ts))) {
+                    goto cleanup;
+                }
+                SR_TRACE(sub_process_end, notif_subs->module_name, sub->sub_id, notifs[j].request_id, 0);
+                sr_shmext_notif_sub_stats(conn, notif_subs->module_name, sub->sub_id, &notifs[j].event_ts, &cb_start);
+            } else {
+                /* filtered out */
+                ATOMIC_INC_RELAXED(notif_subs->subs[i].filtered_out);
             }
-        } else {
-            /* filtered out */
-            ATOMIC_INC_RELAXED(notif_subs->subs[i].filtered_out);
         }
 
-        if (!denied_node) {
-            /* may have been modified and is useless now */
-            lyd_free_all(notif_dup);
-            notif_dup = NULL;
-        }
+        /* the cached NACM decisions are only valid for this notification */
+        sr_nacm_notif_cache_clear(&nacm_cache);
     }
 
     /* remember request ID so that we do not process it again */
     ATOMIC_STORE_RELAXED(notif_subs->request_id, request_id);
 
-    /* SUB WRITE LOCK */
-    if ((err_info = sr_rwlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid, __func__,
-            NULL, NULL))) {
-        goto cleanup;
-    }
+    /* move the cursors so that the notifications can be removed from the ring */
+    for (i = 0; i < notif_subs->sub_count; ++i) {
+        if (suspended[i]) {
+            continue;
+        }
 
-    /* no error/timeout should be possible */
-    if ((ATOMIC_LOAD_RELAXED(multi_sub_shm->event) != SR_SUB_EV_NOTIF) ||
-            (ATOMIC_LOAD_RELAXED(multi_sub_shm->request_id) != ATOMIC_LOAD_RELAXED(notif_subs->request_id))) {
-        SR_ERRINFO_INT(&err_info);
-        goto cleanup_wrunlock;
+        if ((err_info = sr_shmext_notif_sub_cursor(conn, notif_subs->module_name, notif_subs->subs[i].sub_id, request_id,
+                NULL, NULL))) {
+            goto cleanup;
+        }
     }
 
-    /* finish event */
-    if ((err_info = sr_shmsub_multi_listen_write_event(multi_sub_shm, notif_subs->sub_count, 0, &shm_data_sub, NULL, 0,
-            notif_subs->module_name, "success"))) {
-        goto cleanup_wrunlock;
+    /* SUB READ LOCK, only to wake up the notifier possibly waiting for the ring */
+    if ((err_info = sr_rwlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__,
+            NULL, NULL))) {
+        goto cleanup;
     }
 
-cleanup_wrunlock:
-    /* SUB WRITE UNLOCK */
-    sr_rwunlock(&multi_sub_shm->lock, 0, SR_LOCK_WRITE, conn->cid, __func__);
-    goto cleanup;
-
 cleanup_rdunlock:
     /* SUB READ UNLOCK */
     sr_rwunlock(&multi_sub_shm->lock, SR_SUBSHM_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
 
 cleanup:
     ly_in_free(in, 0);
-    sr_session_stop(ev_sess);
-    lyd_free_all(orig_notif);
-    lyd_free_all(notif_dup);
+    for (j = 0; j < notif_count; ++j) {
+        sr_session_stop(notifs[j].ev_sess);
+        lyd_free_all(notifs[j].notif);
+    }
+    free(notifs);
+    free(cursors);
+    free(suspended);
+    sr_nacm_notif_cache_clear(&nacm_cache);
     sr_shm_clear(&shm_data_sub);
     return err_info;
 }
@@ -4683,28 +5711,64 @@ cleanup:
 }
 
 sr_error_info_t *
-sr_shmsub_notif_listen_module_replay(struct modsub_notif_s *notif_subs, sr_subscription_ctx_t *subscr)
+sr_shmsub_notif_listen_replay(sr_subscription_ctx_t *subscr)
 {
     sr_error_info_t *err_info = NULL;
+    struct modsub_notif_s *notif_subs;
     struct modsub_notifsub_s *notif_sub;
-    uint32_t i;
+    struct sr_replay_sub_s *replay_subs = NULL;
+    uint32_t i, j, replay_count = 0;
+    void *mem;
 
-    for (i = 0; i < notif_subs->sub_count; ++i) {
-        notif_sub = &notif_subs->subs[i];
-        if (!SR_TS_IS_ZERO(notif_sub->start_time) && !notif_sub->replayed) {
-            /* we need to perform the requested replay */
-            if ((err_info = sr_replay_notify(subscr->conn, notif_subs->module_name, notif_sub->sub_id, notif_sub->xpath,
-                    &notif_sub->start_time, &notif_sub->stop_time, &notif_sub->listen_since, notif_sub->cb,
-                    notif_sub->tree_cb, notif_sub->private_data))) {
-                return err_info;
+    /* collect all the requested replays of all the modules */
+    for (i = 0; i < subscr->notif_sub_count; ++i) {
+        notif_subs = &subscr->notif_subs[i];
+        for (j = 0; j < notif_subs->sub_count; ++j) {
+            notif_sub = &notif_subs->subs[j];
+            if (SR_TS_IS_ZERO(notif_sub->start_time) || notif_sub->replayed) {
+                continue;
             }
 
-            /* all notifications were replayed and it is now a standard subscription */
-            notif_sub->replayed = 1;
+            mem = realloc(replay_subs, (replay_count + 1) * sizeof *replay_subs);
+            SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+            replay_subs = mem;
+
+            replay_subs[replay_count].mod_name = notif_subs->module_name;
+            replay_subs[replay_count].sub_id = notif_sub->sub_id;
+            replay_subs[replay_count].xpath = notif_sub->xpath;
+            replay_subs[replay_count].start_time = &notif_sub->start_time;
+            replay_subs[replay_count].stop_time = &notif_sub->stop_time;
+            replay_subs[replay_count].listen_since = &notif_sub->listen_since;
+            replay_subs[replay_count].cb = notif_sub->cb;
+            replay_subs[replay_count].tree_cb = notif_sub->tree_cb;
+            replay_subs[replay_count].private_data = notif_sub->private_data;
+            ++replay_count;
         }
     }
 
-    return NULL;
+    if (!replay_count) {
+        goto cleanup;
+    }
+
+    /* perform the replays together, merged in a single pass */
+    if ((err_info = sr_replay_notify(subscr->conn, replay_subs, replay_count))) {
+        goto cleanup;
+    }
+
+    /* all notifications were replayed and they are now standard subscriptions */
+    for (i = 0; i < subscr->notif_sub_count; ++i) {
+        notif_subs = &subscr->notif_subs[i];
+        for (j = 0; j < notif_subs->sub_count; ++j) {
+            notif_sub = &notif_subs->subs[j];
+            if (!SR_TS_IS_ZERO(notif_sub->start_time)) {
+                notif_sub->replayed = 1;
+            }
+        }
+    }
+
+cleanup:
+    free(replay_subs);
+    return err_info;
 }
 
 void *
@@ -4775,3 +5839,680 @@ error:
     pthread_detach(pthread_self());
     return NULL;
 }
+
+/**
+ * @brief Arm the event pipe of a subscription in the shared event loop for a single event.
+ *
+ * @param[in] subscr Subscription structure.
+ * @param[in] op epoll operation.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_evloop_ctl(sr_subscription_ctx_t *subscr, int op)
+{
+    sr_error_info_t *err_info = NULL;
+    struct epoll_event ev = {0};
+
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.ptr = subscr;
+    if (epoll_ctl(subscr->conn->evloop.epoll_fd, op, subscr->evpipe, &ev) == -1) {
+        SR_ERRINFO_SYSERRNO(&err_info, "epoll_ctl");
+    }
+
+    return err_info;
+}
+
+/**
+ * @brief Notify subscriptions with an elapsed scheduled event and learn the time until the nearest one.
+ *
+ * Shared event loop lock is expected to be held.
+ *
+ * @param[in] evloop Shared event loop.
+ * @return Timeout in ms until the nearest scheduled event, -1 if there is none.
+ */
+static int
+sr_shmsub_evloop_timers(struct sr_evloop_s *evloop)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_subscription_ctx_t *subscr;
+    struct timespec now;
+    int timeout_ms = -1, ms;
+    uint32_t i;
+
+    sr_timeouttime_get(&now, 0);
+
+    for (i = 0; i < evloop->sub_count; ++i) {
+        subscr = evloop->subs[i];
+        if (SR_TS_IS_ZERO(subscr->evloop_wake_up)) {
+            continue;
+        }
+
+        ms = sr_time_sub_ms(&subscr->evloop_wake_up, &now);
+        if (ms <= 0) {
+            /* generate an event for the subscription to handle its scheduled event */
+            memset(&subscr->evloop_wake_up, 0, sizeof subscr->evloop_wake_up);
+            if ((err_info = sr_shmsub_notify_evpipe(subscr->evpipe_num, SR_EVPIPE_EV_ANY))) {
+                sr_errinfo_free(&err_info);
+            }
+        } else if ((timeout_ms == -1) || (ms < timeout_ms)) {
+            timeout_ms = ms;
+        }
+    }
+
+    return timeout_ms;
+}
+
+/**
+ * @brief Worker thread of the shared event loop.
+ *
+ * @param[in] arg Pointer to the connection.
+ * @return Always NULL.
+ */
+static void *
+sr_shmsub_evloop_thread(void *arg)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_evloop_s *evloop = &((sr_conn_ctx_t *)arg)->evloop;
+    sr_subscription_ctx_t *subscr;
+    struct epoll_event ev;
+    struct timespec wake_up_in;
+    int timeout_ms, ret, rearm;
+    uint32_t i;
+
+    while (ATOMIC_LOAD_RELAXED(evloop->running)) {
+        /* EVLOOP LOCK */
+        pthread_mutex_lock(&evloop->lock);
+        timeout_ms = sr_shmsub_evloop_timers(evloop);
+        /* EVLOOP UNLOCK */
+        pthread_mutex_unlock(&evloop->lock);
+
+        /* wait for an event of any subscription */
+        ret = epoll_wait(evloop->epoll_fd, &ev, 1, timeout_ms);
+        if (ret == -1) {
+            if (errno != EINTR) {
+                SR_ERRINFO_SYSERRNO(&err_info, "epoll_wait");
+                sr_errinfo_free(&err_info);
+            }
+            continue;
+        } else if (!ret || !ev.data.ptr) {
+            /* timeout or quitting */
+            continue;
+        }
+        subscr = ev.data.ptr;
+
+        /* EVLOOP LOCK */
+        pthread_mutex_lock(&evloop->lock);
+
+        /* the subscription could have been removed meanwhile */
+        for (i = 0; i < evloop->sub_count; ++i) {
+            if (evloop->subs[i] == subscr) {
+                break;
+            }
+        }
+        if ((i == evloop->sub_count) || subscr->evloop_busy) {
+            /* removed or being processed, it will be rearmed by the other worker */
+            pthread_mutex_unlock(&evloop->lock);
+            continue;
+        }
+        subscr->evloop_busy = 1;
+        subscr->tid = pthread_self();
+
+        /* EVLOOP UNLOCK */
+        pthread_mutex_unlock(&evloop->lock);
+
+        rearm = 1;
+        memset(&wake_up_in, 0, sizeof wake_up_in);
+        if (ATOMIC_LOAD_RELAXED(subscr->thread_running) == 2) {
+            /* suspended, do not process events until resumed */
+            rearm = 0;
+        } else if (ATOMIC_LOAD_RELAXED(subscr->thread_running)) {
+            /* process the new event (or handle a scheduled event) */
+            ret = sr_subscription_process_events(subscr, NULL, &wake_up_in);
+            if (ret == SR_ERR_TIME_OUT) {
+                /* try again to actually process the current event */
+                if ((err_info = sr_shmsub_notify_evpipe(subscr->evpipe_num, SR_EVPIPE_EV_ANY))) {
+                    sr_errinfo_free(&err_info);
+                }
+            } else if (ret) {
+                /* stop handling this subscription */
+                ATOMIC_STORE_RELAXED(subscr->thread_running, 0);
+                rearm = 0;
+            }
+        }
+
+        /* EVLOOP LOCK */
+        pthread_mutex_lock(&evloop->lock);
+
+        if (!SR_TS_IS_ZERO(wake_up_in)) {
+            /* schedule the next event */
+            sr_timeouttime_get(&subscr->evloop_wake_up, wake_up_in.tv_sec * 1000 + wake_up_in.tv_nsec / 1000000);
+        } else {
+            memset(&subscr->evloop_wake_up, 0, sizeof subscr->evloop_wake_up);
+        }
+        if (rearm && (err_info = sr_shmsub_evloop_ctl(subscr, EPOLL_CTL_MOD))) {
+            sr_errinfo_free(&err_info);
+        }
+        subscr->evloop_busy = 0;
+        sr_cond_broadcast(&evloop->cond);
+
+        /* EVLOOP UNLOCK */
+        pthread_mutex_unlock(&evloop->lock);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Start the shared event loop of a connection.
+ *
+ * Shared event loop lock is expected to be held.
+ *
+ * @param[in] conn Connection to use.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_evloop_start(sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_evloop_s *evloop = &conn->evloop;
+    struct epoll_event ev = {0};
+    uint32_t i = 0, worker_count;
+
+    assert(evloop->epoll_fd == -1);
+
+    /* create epoll instance and the event FD for waking up all the workers */
+    evloop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (evloop->epoll_fd == -1) {
+        SR_ERRINFO_SYSERRNO(&err_info, "epoll_create1");
+        goto cleanup;
+    }
+    evloop->wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (evloop->wake_fd == -1) {
+        SR_ERRINFO_SYSERRNO(&err_info, "eventfd");
+        goto cleanup;
+    }
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    if (epoll_ctl(evloop->epoll_fd, EPOLL_CTL_ADD, evloop->wake_fd, &ev) == -1) {
+        SR_ERRINFO_SYSERRNO(&err_info, "epoll_ctl");
+        goto cleanup;
+    }
+
+    evloop->tids = calloc(evloop->worker_count, sizeof *evloop->tids);
+    SR_CHECK_MEM_GOTO(!evloop->tids, err_info, cleanup);
+
+    /* start the workers */
+    ATOMIC_STORE_RELAXED(evloop->running, 1);
+    for (i = 0; i < evloop->worker_count; ++i) {
+        if ((err_info = sr_conn_thread_create(conn, SR_THREAD_SUBSCR, &evloop->tids[i], sr_shmsub_evloop_thread,
+                conn))) {
+            break;
+        }
+    }
+
+cleanup:
+    if (err_info) {
+        /* EVLOOP UNLOCK */
+        pthread_mutex_unlock(&evloop->lock);
+
+        /* stop the started workers and free the resources */
+        worker_count = evloop->worker_count;
+        evloop->worker_count = evloop->tids ? i : 0;
+        sr_shmsub_evloop_stop(conn);
+        evloop->worker_count = worker_count;
+
+        /* EVLOOP LOCK */
+        pthread_mutex_lock(&evloop->lock);
+    }
+    return err_info;
+}
+
+sr_error_info_t *
+sr_shmsub_evloop_add(sr_subscription_ctx_t *subscr)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_evloop_s *evloop = &subscr->conn->evloop;
+    void *mem;
+
+    /* EVLOOP LOCK */
+    pthread_mutex_lock(&evloop->lock);
+
+    if ((evloop->epoll_fd == -1) && (err_info = sr_shmsub_evloop_start(subscr->conn))) {
+        goto cleanup;
+    }
+
+    /* add the subscription */
+    mem = realloc(evloop->subs, (evloop->sub_count + 1) * sizeof *evloop->subs);
+    SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+    evloop->subs = mem;
+    if ((err_info = sr_shmsub_evloop_ctl(subscr, EPOLL_CTL_ADD))) {
+        goto cleanup;
+    }
+    evloop->subs[evloop->sub_count] = subscr;
+    ++evloop->sub_count;
+    subscr->evloop = 1;
+
+cleanup:
+    /* EVLOOP UNLOCK */
+    pthread_mutex_unlock(&evloop->lock);
+    return err_info;
+}
+
+sr_error_info_t *
+sr_shmsub_evloop_resume(sr_subscription_ctx_t *subscr)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_evloop_s *evloop = &subscr->conn->evloop;
+
+    /* EVLOOP LOCK */
+    pthread_mutex_lock(&evloop->lock);
+
+    if (!subscr->evloop_busy) {
+        /* rearm, a busy subscription is rearmed by the worker */
+        err_info = sr_shmsub_evloop_ctl(subscr, EPOLL_CTL_MOD);
+    }
+
+    /* EVLOOP UNLOCK */
+    pthread_mutex_unlock(&evloop->lock);
+    return err_info;
+}
+
+int
+sr_shmsub_evloop_processing(sr_subscription_ctx_t *subscr)
+{
+    struct sr_evloop_s *evloop = &subscr->conn->evloop;
+    int processing;
+
+    /* EVLOOP LOCK */
+    pthread_mutex_lock(&evloop->lock);
+
+    processing = subscr->evloop_busy && pthread_equal(subscr->tid, pthread_self());
+
+    /* EVLOOP UNLOCK */
+    pthread_mutex_unlock(&evloop->lock);
+    return processing;
+}
+
+void
+sr_shmsub_evloop_del(sr_subscription_ctx_t *subscr)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_evloop_s *evloop = &subscr->conn->evloop;
+    struct timespec timeout_abs;
+    uint32_t i;
+
+    /* EVLOOP LOCK */
+    pthread_mutex_lock(&evloop->lock);
+
+    for (i = 0; i < evloop->sub_count; ++i) {
+        if (evloop->subs[i] == subscr) {
+            break;
+        }
+    }
+    if (i < evloop->sub_count) {
+        /* remove the subscription */
+        if (epoll_ctl(evloop->epoll_fd, EPOLL_CTL_DEL, subscr->evpipe, NULL) == -1) {
+            SR_ERRINFO_SYSERRNO(&err_info, "epoll_ctl");
+            sr_errinfo_free(&err_info);
+        }
+        --evloop->sub_count;
+        if (i < evloop->sub_count) {
+            evloop->subs[i] = evloop->subs[evloop->sub_count];
+        }
+    }
+
+    /* wait for any worker processing the subscription to finish, it is never us */
+    assert(!subscr->evloop_busy || !pthread_equal(subscr->tid, pthread_self()));
+    while (subscr->evloop_busy) {
+        sr_timeouttime_get(&timeout_abs, SR_SUBSCR_LOCK_TIMEOUT);
+        sr_cond_clockwait(&evloop->cond, &evloop->lock, COMPAT_CLOCK_ID, &timeout_abs);
+    }
+
+    /* EVLOOP UNLOCK */
+    pthread_mutex_unlock(&evloop->lock);
+}
+
+void
+sr_shmsub_evloop_stop(sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_evloop_s *evloop = &conn->evloop;
+    uint64_t val = 1;
+    uint32_t i;
+    int ret;
+
+    if (ATOMIC_LOAD_RELAXED(evloop->running)) {
+        /* signal all the workers to quit, the event FD stays readable */
+        ATOMIC_STORE_RELAXED(evloop->running, 0);
+        if (write(evloop->wake_fd, &val, sizeof val) == -1) {
+            SR_ERRINFO_SYSERRNO(&err_info, "write");
+            sr_errinfo_free(&err_info);
+        }
+
+        /* join the workers */
+        for (i = 0; i < evloop->worker_count; ++i) {
+            if ((ret = pthread_join(evloop->tids[i], NULL))) {
+                sr_errinfo_new(&err_info, SR_ERR_SYS, "Joining the event loop thread failed (%s).", strerror(ret));
+                sr_errinfo_free(&err_info);
+            }
+        }
+    }
+
+    /* free the resources */
+    if (evloop->wake_fd > -1) {
+        close(evloop->wake_fd);
+        evloop->wake_fd = -1;
+    }
+    if (evloop->epoll_fd > -1) {
+        close(evloop->epoll_fd);
+        evloop->epoll_fd = -1;
+    }
+    free(evloop->tids);
+    evloop->tids = NULL;
+    free(evloop->subs);
+    evloop->subs = NULL;
+    evloop->sub_count = 0;
+}
+
+/**
+ * @brief Check whether the calling thread is one of the current workers of a subscription structure.
+ * Workers lock is expected to be held.
+ *
+ * @param[in] workers Workers of a subscription structure.
+ * @return Whether the thread is a current worker.
+ */
+static int
+sr_shmsub_workers_is_current(struct sr_subscr_workers_s *workers)
+{
+    uint32_t i;
+
+    for (i = 0; i < workers->count; ++i) {
+        if (pthread_equal(workers->tids[i], pthread_self())) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Find the next queued task, a module (RPC) subscription that is not being processed by another worker.
+ * Workers lock is expected to be held.
+ *
+ * @param[in] subscr Subscription structure.
+ * @param[out] type Task type.
+ * @param[out] task Task state of the found subscription.
+ * @return Found module (RPC) subscription, NULL if there is none.
+ */
+static void *
+sr_shmsub_workers_task_next(sr_subscription_ctx_t *subscr, int *type, uint8_t **task)
+{
+    uint32_t i;
+
+    for (i = 0; i < subscr->change_sub_count; ++i) {
+        if (subscr->change_subs[i].task == SR_SUB_TASK_QUEUED) {
+            *type = SR_SUB_TASK_CHANGE;
+            *task = &subscr->change_subs[i].task;
+            return &subscr->change_subs[i];
+        }
+    }
+    for (i = 0; i < subscr->oper_get_sub_count; ++i) {
+        if (subscr->oper_get_subs[i].task == SR_SUB_TASK_QUEUED) {
+            *type = SR_SUB_TASK_OPER_GET;
+            *task = &subscr->oper_get_subs[i].task;
+            return &subscr->oper_get_subs[i];
+        }
+    }
+    for (i = 0; i < subscr->rpc_sub_count; ++i) {
+        if (subscr->rpc_subs[i].task == SR_SUB_TASK_QUEUED) {
+            *type = SR_SUB_TASK_RPC;
+            *task = &subscr->rpc_subs[i].task;
+            return &subscr->rpc_subs[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Process all the queued tasks of a subscription structure that are not being processed by other workers.
+ *
+ * @param[in] subscr Subscription structure.
+ */
+static void
+sr_shmsub_workers_process_tasks(sr_subscription_ctx_t *subscr)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_subscr_workers_s *workers = &subscr->workers;
+    void *sub;
+    uint8_t *task;
+    int type;
+
+    /* SUBS READ LOCK, the subscriptions are not modified while processed */
+    if ((err_info = sr_rwlock(&subscr->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_READ, subscr->conn->cid, __func__,
+            NULL, NULL))) {
+        sr_errinfo_free(&err_info);
+        return;
+    }
+
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(subscr->conn, SR_LOCK_READ, 0, __func__))) {
+        sr_errinfo_free(&err_info);
+        goto cleanup_subs_unlock;
+    }
+
+    /* WORKERS LOCK */
+    pthread_mutex_lock(&workers->lock);
+
+    while (sr_shmsub_workers_is_current(workers) && (sub = sr_shmsub_workers_task_next(subscr, &type, &task))) {
+        /* only this thread processes the events of the subscription now, so they are processed in order */
+        *task = SR_SUB_TASK_RUNNING;
+
+        /* WORKERS UNLOCK */
+        pthread_mutex_unlock(&workers->lock);
+
+        switch (type) {
+        case SR_SUB_TASK_CHANGE:
+            err_info = sr_shmsub_change_listen_process_module_events(sub, subscr->conn);
+            break;
+        case SR_SUB_TASK_OPER_GET:
+            err_info = sr_shmsub_oper_get_listen_process_module_events(sub, subscr->conn);
+            break;
+        case SR_SUB_TASK_RPC:
+            err_info = sr_shmsub_rpc_listen_process_rpc_events(sub, subscr->conn);
+            break;
+        }
+        sr_errinfo_free(&err_info);
+
+        /* WORKERS LOCK */
+        pthread_mutex_lock(&workers->lock);
+
+        *task &= ~SR_SUB_TASK_RUNNING;
+        if (*task) {
+            /* new events arrived meanwhile, let any worker process them */
+            ++workers->queued;
+            sr_cond_broadcast(&workers->cond);
+        }
+    }
+
+    /* WORKERS UNLOCK */
+    pthread_mutex_unlock(&workers->lock);
+
+    /* CONTEXT UNLOCK */
+    sr_lycc_unlock(subscr->conn, SR_LOCK_READ, 0, __func__);
+
+cleanup_subs_unlock:
+    /* SUBS READ UNLOCK */
+    sr_rwunlock(&subscr->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_READ, subscr->conn->cid, __func__);
+}
+
+/**
+ * @brief Worker thread processing tasks of a subscription structure.
+ *
+ * @param[in] arg Subscription structure.
+ * @return NULL.
+ */
+static void *
+sr_shmsub_workers_thread(void *arg)
+{
+    sr_subscription_ctx_t *subscr = arg;
+    struct sr_subscr_workers_s *workers = &subscr->workers;
+    uint32_t queued;
+
+    /* WORKERS LOCK */
+    pthread_mutex_lock(&workers->lock);
+
+    while (sr_shmsub_workers_is_current(workers)) {
+        queued = workers->queued;
+
+        /* WORKERS UNLOCK */
+        pthread_mutex_unlock(&workers->lock);
+
+        sr_shmsub_workers_process_tasks(subscr);
+
+        /* WORKERS LOCK */
+        pthread_mutex_lock(&workers->lock);
+
+        /* wait for new tasks */
+        while ((queued == workers->queued) && sr_shmsub_workers_is_current(workers)) {
+            sr_cond_wait(&workers->cond, &workers->lock);
+        }
+    }
+
+    /* WORKERS UNLOCK */
+    pthread_mutex_unlock(&workers->lock);
+
+    return NULL;
+}
+
+void
+sr_shmsub_workers_detach(sr_subscription_ctx_t *subscr, pthread_t **tids, uint32_t *count)
+{
+    struct sr_subscr_workers_s *workers = &subscr->workers;
+
+    /* WORKERS LOCK */
+    pthread_mutex_lock(&workers->lock);
+
+    /* the workers quit once they are not the current ones */
+    *tids = workers->tids;
+    *count = workers->count;
+    workers->tids = NULL;
+    workers->count = 0;
+    sr_cond_broadcast(&workers->cond);
+
+    /* WORKERS UNLOCK */
+    pthread_mutex_unlock(&workers->lock);
+}
+
+void
+sr_shmsub_workers_join(pthread_t *tids, uint32_t count)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+    int ret;
+
+    for (i = 0; i < count; ++i) {
+        if ((ret = pthread_join(tids[i], NULL))) {
+            sr_errinfo_new(&err_info, SR_ERR_SYS, "Joining the subscription worker thread failed (%s).", strerror(ret));
+            sr_errinfo_free(&err_info);
+        }
+    }
+
+    free(tids);
+}
+
+void
+sr_shmsub_workers_stop(sr_subscription_ctx_t *subscr)
+{
+    pthread_t *tids;
+    uint32_t count;
+
+    sr_shmsub_workers_detach(subscr, &tids, &count);
+    sr_shmsub_workers_join(tids, count);
+}
+
+sr_error_info_t *
+sr_shmsub_workers_start(sr_subscription_ctx_t *subscr, uint32_t worker_count)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_subscr_workers_s *workers = &subscr->workers;
+
+    if (!worker_count) {
+        return NULL;
+    }
+
+    /* WORKERS LOCK, the workers learn they are the current ones only once all are started */
+    pthread_mutex_lock(&workers->lock);
+
+    assert(!workers->count);
+
+    workers->tids = calloc(worker_count, sizeof *workers->tids);
+    if (!workers->tids) {
+        SR_ERRINFO_MEM(&err_info);
+        goto cleanup;
+    }
+
+    for (workers->count = 0; workers->count < worker_count; ++workers->count) {
+        if ((err_info = sr_conn_thread_create(subscr->conn, SR_THREAD_SUBSCR, &workers->tids[workers->count],
+                sr_shmsub_workers_thread, subscr))) {
+            break;
+        }
+    }
+
+    /* process any tasks queued while there were no workers */
+    ++workers->queued;
+
+cleanup:
+    /* WORKERS UNLOCK */
+    pthread_mutex_unlock(&workers->lock);
+
+    if (err_info) {
+        /* stop the created workers */
+        sr_shmsub_workers_stop(subscr);
+    }
+    return err_info;
+}
+
+int
+sr_shmsub_workers_processing(sr_subscription_ctx_t *subscr)
+{
+    struct sr_subscr_workers_s *workers = &subscr->workers;
+    int processing;
+
+    /* WORKERS LOCK */
+    pthread_mutex_lock(&workers->lock);
+
+    processing = sr_shmsub_workers_is_current(workers);
+
+    /* WORKERS UNLOCK */
+    pthread_mutex_unlock(&workers->lock);
+    return processing;
+}
+
+void
+sr_shmsub_workers_queue_events(sr_subscription_ctx_t *subscr, uint8_t events)
+{
+    struct sr_subscr_workers_s *workers = &subscr->workers;
+    uint32_t i;
+
+    /* WORKERS LOCK */
+    pthread_mutex_lock(&workers->lock);
+
+    /* queue a task for every module/RPC subscription, its events are processed in order by a single worker */
+    for (i = 0; (events & SR_EVPIPE_EV_CHANGE) && (i < subscr->change_sub_count); ++i) {
+        subscr->change_subs[i].task |= SR_SUB_TASK_QUEUED;
+    }
+    for (i = 0; (events & SR_EVPIPE_EV_OPER_GET) && (i < subscr->oper_get_sub_count); ++i) {
+        subscr->oper_get_subs[i].task |= SR_SUB_TASK_QUEUED;
+    }
+    for (i = 0; (events & SR_EVPIPE_EV_RPC) && (i < subscr->rpc_sub_count); ++i) {
+        subscr->rpc_subs[i].task |= SR_SUB_TASK_QUEUED;
+    }
+
+    /* wake up the workers, do not wait for them */
+    ++workers->queued;
+    sr_cond_broadcast(&workers->cond);
+
+    /* WORKERS UNLOCK */
+    pthread_mutex_unlock(&workers->lock);
+}
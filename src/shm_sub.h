@@ -91,17 +91,27 @@ sr_error_info_t *sr_shmsub_data_create(const char *name, const char *suffix1, in
  */
 sr_error_info_t *sr_shmsub_data_unlink(const char *name, const char *suffix1, int64_t suffix2);
 
+/**
+ * @brief Prepare the process for writing into event pipes, SIGPIPE is ignored unless handled by the application.
+ */
+void sr_shmsub_evpipe_init(void);
+
 /**
  * @brief Write into a subscriber event pipe to notify it there is a new event.
  *
+ * A limited number of event pipes is kept opened for writing for the next events.
+ *
  * @param[in] evpipe_num Subscriber event pipe number.
+ * @param[in] events Kinds of the new events, bitwise OR-ed SR_EVPIPE_EV_* flags, ::SR_EVPIPE_EV_ANY if unknown.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_shmsub_notify_evpipe(uint32_t evpipe_num);
+sr_error_info_t *sr_shmsub_notify_evpipe(uint32_t evpipe_num, uint8_t events);
 
 /**
  * @brief Notify about (generate) a change "update" event.
  *
+ * Events for all the modules are generated at once, subscribers of each module are notified in their priority order.
+ *
  * @param[in] mod_info Mod info to use.
  * @param[in] orig_name Event originator name.
  * @param[in] orig_data Event originator data.
@@ -158,12 +168,68 @@ sr_error_info_t *sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_i
 sr_error_info_t *sr_shmsub_change_notify_change_abort(struct sr_mod_info_s *mod_info, const char *orig_name,
         const void *orig_data, uint32_t timeout_ms);
 
+/**
+ * @brief Operational get events of several subscriptions generated together and then waited for at once.
+ */
+struct sr_shmsub_oper_get_batch_s {
+    struct sr_shmsub_many_info_oper_get_s *notify_subs; /**< Notified subscribers of all the XPaths. */
+    uint32_t notify_count;      /**< Count of notified subscribers. */
+    const char **xpaths;        /**< Subscription XPaths of the generated events. */
+    uint32_t xpath_count;       /**< Count of XPaths. */
+};
+
+/**
+ * @brief Generate operational get events for all the subscribers of an XPath and add them into a batch.
+ * The batch must always be cleared using ::sr_shmsub_oper_get_notify_batch_clear().
+ *
+ * @param[in] batch Batch to add to.
+ * @param[in] mod Modinfo structure.
+ * @param[in] xpath Subscription XPath.
+ * @param[in] request_xpath Requested XPath.
+ * @param[in] hints Hints of the request.
+ * @param[in] parent Existing parent to append the data to.
+ * @param[in] orig_name Event originator name.
+ * @param[in] orig_data Event originator data.
+ * @param[in] oper_get_subs An array of operational get subscriptions.
+ * @param[in] idx1 Index of the array where operational subscriptions with the same XPath are.
+ * @param[in] conn Connection.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmsub_oper_get_notify_batch_add(struct sr_shmsub_oper_get_batch_s *batch,
+        struct sr_mod_info_mod_s *mod, const char *xpath, const char *request_xpath, const sr_oper_get_hints_t *hints,
+        const struct lyd_node *parent, const char *orig_name, const void *orig_data,
+        sr_mod_oper_get_sub_t *oper_get_subs, uint32_t idx1, sr_conn_ctx_t *conn);
+
+/**
+ * @brief Wait for all the operational get events in a batch to be processed and collect the data.
+ *
+ * @param[in] batch Batch to wait for.
+ * @param[in] mod Modinfo structure.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds.
+ * @param[in] conn Connection.
+ * @param[in,out] data Array of data trees provided by the subscribers, one for every XPath in @p batch.
+ * @param[out] cb_err_info Callback error information generated by a subscriber, if any.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmsub_oper_get_notify_batch_wait(struct sr_shmsub_oper_get_batch_s *batch,
+        struct sr_mod_info_mod_s *mod, uint32_t timeout_ms, sr_conn_ctx_t *conn, struct lyd_node **data,
+        sr_error_info_t **cb_err_info);
+
+/**
+ * @brief Release all the subscriptions locked in a batch and clear it.
+ *
+ * @param[in] batch Batch to clear.
+ * @param[in] cid Connection ID.
+ */
+void sr_shmsub_oper_get_notify_batch_clear(struct sr_shmsub_oper_get_batch_s *batch, sr_cid_t cid);
+
 /**
  * @brief Notify about (generate) an operational get event.
  *
  * @param[in] mod Modinfo structure.
  * @param[in] xpath Subscription XPath.
  * @param[in] request_xpath Requested XPath.
+ * @param[in] hints Hints of the request.
  * @param[in] parent Existing parent to append the data to.
  * @param[in] orig_name Event originator name.
  * @param[in] orig_data Event originator data.
@@ -176,8 +242,9 @@ sr_error_info_t *sr_shmsub_change_notify_change_abort(struct sr_mod_info_s *mod_
  * @return err_info, NULL on success.
  */
 sr_error_info_t *sr_shmsub_oper_get_notify(struct sr_mod_info_mod_s *mod, const char *xpath, const char *request_xpath,
-        const struct lyd_node *parent, const char *orig_name, const void *orig_data, sr_mod_oper_get_sub_t *oper_get_subs,
-        uint32_t idx1, uint32_t timeout_ms, sr_conn_ctx_t *conn, struct lyd_node **data, sr_error_info_t **cb_err_info);
+        const sr_oper_get_hints_t *hints, const struct lyd_node *parent, const char *orig_name, const void *orig_data,
+        sr_mod_oper_get_sub_t *oper_get_subs, uint32_t idx1, uint32_t timeout_ms, sr_conn_ctx_t *conn,
+        struct lyd_node **data, sr_error_info_t **cb_err_info);
 
 /**
  * @brief Notify about (generate) an RPC/action event.
@@ -221,19 +288,21 @@ sr_error_info_t *sr_shmsub_rpc_notify_abort(sr_conn_ctx_t *conn, sr_rwlock_t *su
         uint32_t request_id);
 
 /**
- * @brief Notify about (generate) a notification event.
+ * @brief Notify about (generate) notification events of a single module. They are added into the notification
+ * ring, the subscribers are woken up once for all of them, and it waits for the subscribers only if the ring is full.
  *
  * @param[in] conn Connection to use.
- * @param[in] notif Notification data tree.
- * @param[in] notif_ts Notification timestamp.
+ * @param[in] notifs Array of notification data trees.
+ * @param[in] notif_ts Array of notification timestamps.
+ * @param[in] notif_count Count of @p notifs and @p notif_ts.
  * @param[in] orig_name Event originator name.
  * @param[in] orig_data Event originator data.
  * @param[in] timeout_ms Notification callback timeout in milliseconds. Used only if @p wait is set.
  * @param[in] wait Whether to wait for the callbacks or not.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_shmsub_notif_notify(sr_conn_ctx_t *conn, const struct lyd_node *notif, struct timespec notif_ts,
-        const char *orig_name, const void *orig_data, uint32_t timeout_ms, int wait);
+sr_error_info_t *sr_shmsub_notif_notify(sr_conn_ctx_t *conn, struct lyd_node **notifs, const struct timespec *notif_ts,
+        uint32_t notif_count, const char *orig_name, const void *orig_data, uint32_t timeout_ms, int wait);
 
 /**
  * @brief Process all module change events, if any.
@@ -315,13 +384,12 @@ sr_error_info_t *sr_shmsub_notif_listen_module_stop_time(uint32_t notif_subs_idx
         sr_subscription_ctx_t *subscr, int *module_finished);
 
 /**
- * @brief Check notification subscription replay state and perform it if requested.
+ * @brief Check notification subscription replay state of all the modules and perform the replays if requested.
  *
- * @param[in] notif_subs Module notification subscriptions.
  * @param[in] subscr Subscriptions structure.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_shmsub_notif_listen_module_replay(struct modsub_notif_s *notif_subs, sr_subscription_ctx_t *subscr);
+sr_error_info_t *sr_shmsub_notif_listen_replay(sr_subscription_ctx_t *subscr);
 
 /**
  * @brief Listener handler thread of all subscriptions.
@@ -331,4 +399,98 @@ sr_error_info_t *sr_shmsub_notif_listen_module_replay(struct modsub_notif_s *not
  */
 void *sr_shmsub_listen_thread(void *arg);
 
+/**
+ * @brief Add a subscription structure to the shared event loop of its connection, start it if not running.
+ *
+ * @param[in] subscr Subscription structure.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmsub_evloop_add(sr_subscription_ctx_t *subscr);
+
+/**
+ * @brief Make the shared event loop handle events of a resumed subscription structure.
+ *
+ * @param[in] subscr Subscription structure.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmsub_evloop_resume(sr_subscription_ctx_t *subscr);
+
+/**
+ * @brief Learn whether the calling thread is the shared event loop worker processing a subscription structure.
+ *
+ * @param[in] subscr Subscription structure.
+ * @return Whether the subscription structure is being processed by the calling thread.
+ */
+int sr_shmsub_evloop_processing(sr_subscription_ctx_t *subscr);
+
+/**
+ * @brief Remove a subscription structure from the shared event loop of its connection.
+ *
+ * Waits until no worker is processing events of the subscription structure, must not be called by such a worker.
+ *
+ * @param[in] subscr Subscription structure.
+ */
+void sr_shmsub_evloop_del(sr_subscription_ctx_t *subscr);
+
+/**
+ * @brief Stop the shared event loop of a connection, if running, and free its resources.
+ *
+ * @param[in] conn Connection to use.
+ */
+void sr_shmsub_evloop_stop(sr_conn_ctx_t *conn);
+
+/**
+ * @brief Start worker threads of a subscription structure processing independent subscriptions in parallel.
+ *
+ * @param[in] subscr Subscription structure with no workers.
+ * @param[in] worker_count Number of worker threads, 0 for none.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmsub_workers_start(sr_subscription_ctx_t *subscr, uint32_t worker_count);
+
+/**
+ * @brief Detach the current worker threads of a subscription structure so that they quit.
+ *
+ * They may still be waiting for the subscription lock so they must be joined only once it is not held.
+ *
+ * @param[in] subscr Subscription structure.
+ * @param[out] tids Detached worker thread IDs to join.
+ * @param[out] count Count of @p tids.
+ */
+void sr_shmsub_workers_detach(sr_subscription_ctx_t *subscr, pthread_t **tids, uint32_t *count);
+
+/**
+ * @brief Join detached worker threads.
+ *
+ * @param[in] tids Worker thread IDs, are freed.
+ * @param[in] count Count of @p tids.
+ */
+void sr_shmsub_workers_join(pthread_t *tids, uint32_t count);
+
+/**
+ * @brief Stop worker threads of a subscription structure, if any. Subscription lock must not be held.
+ *
+ * @param[in] subscr Subscription structure.
+ */
+void sr_shmsub_workers_stop(sr_subscription_ctx_t *subscr);
+
+/**
+ * @brief Check whether the calling thread is a worker of a subscription structure.
+ *
+ * @param[in] subscr Subscription structure.
+ * @return Whether the thread is a worker of @p subscr.
+ */
+int sr_shmsub_workers_processing(sr_subscription_ctx_t *subscr);
+
+/**
+ * @brief Queue change, operational get, and RPC events of a subscription structure for its workers.
+ *
+ * Events of each module (RPC) subscription are processed by a single worker at a time so their order is kept,
+ * returns without waiting for the events to be processed.
+ *
+ * @param[in] subscr Subscription structure with workers.
+ * @param[in] events Kinds of pending events, only these subscriptions are queued.
+ */
+void sr_shmsub_workers_queue_events(sr_subscription_ctx_t *subscr, uint8_t events);
+
 #endif /* _SHM_SUB_H */
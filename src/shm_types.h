@@ -25,7 +25,7 @@
 #include "common_types.h"
 #include "sysrepo_types.h"
 
-#define SR_SHM_VER 14   /**< Main, mod, and ext SHM version of their expected content structures. */
+#define SR_SHM_VER 31   /**< Main, mod, and ext SHM version of their expected content structures. */
 #define SR_MAIN_SHM_LOCK "sr_main_lock"     /**< Main SHM file lock name. */
 
 /**
@@ -102,6 +102,41 @@ typedef struct {
     uint16_t dep_count;         /**< Number of dependencies. */
 } sr_notif_t;
 
+#define SR_LATENCY_BUCKET_COUNT 7   /**< Number of latency histogram buckets, the upper bound of the first is 100 us
+                                         and it grows 10 times with every next one, the last has no bound. */
+
+/**
+ * @brief Latency statistics.
+ */
+typedef struct {
+    ATOMIC64_T count;           /**< Number of measured durations. */
+    ATOMIC64_T sum_usec;        /**< Total of all the durations in usec. */
+    ATOMIC_T max_usec;          /**< Longest duration in usec. */
+    ATOMIC64_T buckets[SR_LATENCY_BUCKET_COUNT];    /**< Latency histogram. */
+} sr_latency_stats_t;
+
+/**
+ * @brief Subscription event processing statistics.
+ */
+typedef struct {
+    sr_latency_stats_t queue;   /**< Time from publishing events to the subscription starting to process them. */
+    sr_latency_stats_t callback;    /**< Duration of the subscription callback processing events. */
+} sr_sub_stats_t;
+
+/**
+ * @brief Phases of applying changes with measured latency.
+ */
+typedef enum {
+    SR_COMMIT_PHASE_EDIT,       /**< Applying the edit on the current data. */
+    SR_COMMIT_PHASE_VALIDATE,   /**< Validating the new data. */
+    SR_COMMIT_PHASE_UPDATE,     /**< Waiting for "update" event subscribers. */
+    SR_COMMIT_PHASE_CHANGE,     /**< Waiting for "change" event subscribers. */
+    SR_COMMIT_PHASE_DONE,       /**< Waiting for "done" event subscribers, if any were waited for. */
+    SR_COMMIT_PHASE_STORE,      /**< Storing the new data by the datastore plugin. */
+    SR_COMMIT_PHASE_COUNT       /**< Phase count. */
+} sr_commit_phase_t;
+
+
 /**
  * @brief Mod SHM module.
  */
@@ -110,12 +145,26 @@ typedef struct {
         sr_rwlock_t data_lock;  /**< Process-shared lock for accessing module instance data. */
 
         pthread_mutex_t ds_lock;    /**< Process-shared lock for accessing DS lock information. */
+        sr_cond_t ds_lock_cond;     /**< Process-shared condition broadcast when the DS lock is released. */
         uint32_t ds_lock_sid;   /**< SID of the module data datastore lock (NETCONF lock), the data can be modified only
                                      by this session. If 0, the DS lock is not held. */
         struct timespec ds_lock_ts; /**< Timestamp of the datastore lock. */
         uint32_t prio;              /**< Module change priority synchronized with applying data changes. */
     } data_lock_info[SR_DS_COUNT];  /**< Module data lock information for each datastore. */
+    ATOMIC_T run_data_ver;      /**< Version of the module running data, incremented on every change. */
+    ATOMIC_T oper_data_ver;     /**< Version of the module stored operational data, incremented on every change. */
+    ATOMIC_T run_sub_ver;       /**< Version of the module running change subscriptions, incremented on every change
+                                     of the enabled operational data. */
     sr_rwlock_t replay_lock;    /**< Process-shared lock for accessing stored notifications for replay. */
+    uint32_t replay_notif_count;    /**< Number of notifications stored for replay, detects replay ring SHM
+                                         updates that were missed. */
+
+    sr_latency_stats_t commit_stats[SR_COMMIT_PHASE_COUNT]; /**< Module latency statistics of every phase of applying
+                                                                 changes. */
+    struct {
+        sr_latency_stats_t load;    /**< Latency of DS plugin load calls. */
+        sr_latency_stats_t store;   /**< Latency of DS plugin store calls. */
+    } ds_stats[SR_DS_COUNT];    /**< Module DS plugin call statistics for each datastore. */
 
     off_t name;                 /**< Module name (offset in mod SHM). */
     char rev[11];               /**< Module revision. */
@@ -133,6 +182,8 @@ typedef struct {
     uint16_t dep_count;         /**< Number of module data dependencies. */
     off_t inv_deps;             /**< Array of inverse module data dependencies (off_t *) (offset in mod SHM). */
     uint16_t inv_dep_count;     /**< Number of inverse module data dependencies. */
+    off_t imports;              /**< Array of imported module names, also by submodules (off_t *) (offset in mod SHM). */
+    uint16_t imp_count;         /**< Number of imported modules. */
 
     struct {
         sr_rwlock_t lock;       /**< Process-shared lock for reading or preventing changes (READ) or modifying (WRITE)
@@ -162,11 +213,58 @@ typedef struct {
     uint32_t rpc_ext_sub_count; /**< Number of ext RPC subscriptions. */
 } sr_mod_t;
 
+/**
+ * @brief Running data snapshot SHM header, followed by LYB data of the module.
+ */
+typedef struct {
+    uint32_t content_id;        /**< Context content ID of the context used for printing the data. */
+    uint32_t run_data_ver;      /**< Module running data version (of ::sr_mod_t) of the data. */
+    uint64_t data_len;          /**< Length of the LYB data stored after this structure, 0 if there are no data. */
+} sr_run_snapshot_shm_t;
+
+/**
+ * @brief Shared operational poll cache SHM header, followed by LYB data of the cached subscription.
+ */
+typedef struct {
+    uint32_t content_id;        /**< Context content ID of the context used for printing the data. */
+    sr_cid_t cid;               /**< Connection ID of the oper poll subscription that stored the data. */
+    uint32_t valid_ms;          /**< Validity period of the data. */
+    struct timespec timestamp;  /**< Realtime timestamp of the data retrieval. */
+    uint64_t data_len;          /**< Length of the LYB data stored after this structure, 0 if there are no data. */
+} sr_oper_poll_shm_t;
+
+/**
+ * @brief Replay ring SHM header, followed by slots with the most recent notifications of a module stored for replay.
+ * Every slot starts with ::sr_replay_ring_slot_t followed by LYB data of the notification.
+ */
+typedef struct {
+    uint32_t slot_count;        /**< Number of slots. */
+    uint32_t slot_size;         /**< Size of each slot. */
+    uint32_t content_id;        /**< Context content ID of the context used for printing the notifications. */
+    uint32_t notif_count;       /**< Value of the module replay notification count including all the stored
+                                     notifications. */
+    uint32_t first;             /**< Index of the slot with the oldest notification. */
+    uint32_t count;             /**< Number of notifications in the ring. */
+    struct timespec since;      /**< All the notifications with this or a later timestamp stored for replay
+                                     are in the ring. */
+} sr_replay_ring_shm_t;
+
+/**
+ * @brief Replay ring SHM slot.
+ */
+typedef struct {
+    struct timespec notif_ts;   /**< Notification timestamp. */
+    uint32_t data_len;          /**< Length of the LYB data stored after this structure. */
+} sr_replay_ring_slot_t;
+
 /**
  * @brief Mod SHM structure
  */
 typedef struct {
     uint32_t mod_count;         /**< Number of installed modules stored after this structure. */
+    off_t mod_idx;              /**< Hash index of the installed modules by their names (offset in mod SHM), array
+                                     of module indices increased by one, 0 for an empty bucket. */
+    uint32_t mod_idx_size;      /**< Number of buckets of the module hash index, 0 if not built. */
 } sr_mod_shm_t;
 
 /**
@@ -198,6 +296,8 @@ typedef struct {
     uint32_t sub_id;            /**< Unique subscription ID. */
     uint32_t evpipe_num;        /**< Event pipe number. */
     ATOMIC_T suspended;         /**< Whether the subscription is suspended. */
+    ATOMIC_T filtered_out;      /**< Number of change events filtered out by the originators. */
+    sr_sub_stats_t stats;       /**< Event processing statistics. */
     sr_cid_t cid;               /**< Connection ID. */
 } sr_mod_change_sub_t;
 
@@ -220,6 +320,7 @@ typedef struct {
     uint32_t evpipe_num;        /**< Event pipe number. */
     uint32_t priority;          /**< Priority of the subscription (automatically generated). */
     ATOMIC_T suspended;         /**< Whether the subscription is suspended. */
+    sr_sub_stats_t stats;       /**< Event processing statistics. */
     sr_cid_t cid;               /**< Connection ID. */
 } sr_mod_oper_get_xpath_sub_t;
 
@@ -228,7 +329,10 @@ typedef struct {
  */
 typedef struct {
     off_t xpath;                /**< XPath of the subscription (offset in ext SHM). */
+    off_t atoms;                /**< Serialized text atoms of the XPath allocated together with it (offset in ext SHM),
+                                     0 if the XPath cannot be split into atoms. */
     sr_mod_oper_get_sub_type_t sub_type; /**< Type of the subscription. */
+    int parent_inst;            /**< Whether the parent of the XPath is a single instance identified by its keys. */
 
     off_t xpath_subs;           /**< Subscriptions array of the given XPath (offset in ext SHM) */
     uint32_t xpath_sub_count;   /**< Number of subscriptions for given XPath */
@@ -254,6 +358,8 @@ typedef struct {
     uint32_t sub_id;            /**< Unique subscription ID. */
     uint32_t evpipe_num;        /**< Event pipe number. */
     ATOMIC_T suspended;         /**< Whether the subscription is suspended. */
+    ATOMIC_T cursor;            /**< Request ID of the last notification processed by the subscription. */
+    sr_sub_stats_t stats;       /**< Event processing statistics. */
     sr_cid_t cid;               /**< Connection ID. */
 } sr_mod_notif_sub_t;
 
@@ -267,14 +373,21 @@ typedef struct {
     uint32_t sub_id;            /**< Unique subscription ID. */
     uint32_t evpipe_num;        /**< Event pipe number. */
     ATOMIC_T suspended;         /**< Whether the subscription is suspended. */
+    sr_sub_stats_t stats;       /**< Event processing statistics. */
     sr_cid_t cid;               /**< Connection ID. */
 } sr_mod_rpc_sub_t;
 
+/**
+ * @brief Count of ext SHM memory hole size classes.
+ */
+#define SR_EXT_HOLE_CLASS_COUNT 16
+
 /**
  * @brief Ext SHM structure.
  */
 typedef struct {
-    uint32_t first_hole_off;    /**< Offset of the first memory hole, 0 if there is none. */
+    uint32_t first_hole_off[SR_EXT_HOLE_CLASS_COUNT];   /**< Offsets of the first memory hole of each size class
+                                                             (holes ordered by their offset), 0 if there is none. */
 } sr_ext_shm_t;
 
 /**
@@ -301,13 +414,35 @@ typedef struct {
 /*
  * notification subscription SHM (multi)
  *
+ * event SR_SUB_EV_NOTIF is set once the first notification is written, request_id is the ID of the last written
+ * notification, subscriber_count is not used
+ *
  * data SHM contents
  *
- * FOR SUBSCRIBERS
- * followed by:
- * event SR_SUB_EV_NOTIF - char *user; time_t notif_timestamp; char *notif_lyb - notification
+ * sr_notif_ring_t ring; followed by ring entries, each
+ * sr_notif_ring_entry_t entry; char *user; time_t notif_timestamp; char *notif_lyb - notification
  */
 
+/**
+ * @brief Ring of notifications in notification sub data SHM, followed by the entries.
+ */
+typedef struct {
+    uint32_t size;              /**< Size of the entry area following this structure. */
+    uint32_t head;              /**< Offset of the next entry to be written. */
+    uint32_t tail;              /**< Offset of the oldest entry. */
+    uint32_t count;             /**< Number of entries. */
+} sr_notif_ring_t;
+
+/**
+ * @brief Header of a notification ring entry. Entries are removed by the originators once all the subscribers
+ * have processed them, which they announce by their cursors (::sr_mod_notif_sub_t).
+ */
+typedef struct {
+    uint32_t request_id;        /**< Request ID of the notification, 0 for an entry marking the end of the ring. */
+    uint32_t size;              /**< Size of the whole entry. */
+    struct timespec event_ts;   /**< Time the notification was written (::COMPAT_CLOCK_ID). */
+} sr_notif_ring_entry_t;
+
 /*
  * operational subscription SHM (generic)
  *
@@ -315,7 +450,8 @@ typedef struct {
  *
  * FOR SUBSCRIBER
  * followed by:
- * event SR_SUB_EV_OPER - char *user; char *request_xpath; char *parent_lyb - existing data tree parent
+ * event SR_SUB_EV_OPER - char *user; char *request_xpath; sr_oper_get_hints_t hints;
+ *                        char *parent_lyb - existing data tree parent
  *
  * FOR ORIGINATOR
  * followed by:
@@ -323,6 +459,15 @@ typedef struct {
  * event SR_SUB_EV_ERROR - char *error_message; char *error_xpath
  */
 
+/**
+ * @brief Hints of an operational get request for the providers, written into sub data SHM.
+ */
+typedef struct {
+    uint32_t max_depth;         /**< Maximum depth of the requested subtrees, 0 for unlimited. */
+    uint32_t limit;             /**< Maximum number of the requested subtrees (list instances), 0 for unlimited. */
+    uint32_t get_oper_opts;     /**< Get oper data options (::sr_get_oper_flag_t) of the request. */
+} sr_oper_get_hints_t;
+
 /*
  * RPC subscription SHM (generic)
  *
@@ -347,6 +492,7 @@ typedef struct {
     sr_cid_t orig_cid;          /**< Event originator CID. */
     ATOMIC_T request_id;        /**< Request ID. */
     ATOMIC_T event;             /**< Event. */
+    struct timespec event_ts;   /**< Time the event was published (::COMPAT_CLOCK_ID). */
 } sr_sub_shm_t;
 
 /**
@@ -358,9 +504,14 @@ typedef struct {
     sr_cid_t orig_cid;          /**< Event originator CID. */
     ATOMIC_T request_id;        /**< Request ID. */
     ATOMIC_T event;             /**< Event. */
+    struct timespec event_ts;   /**< Time the event was published (::COMPAT_CLOCK_ID). */
 
     /* specific fields */
     ATOMIC_T priority;          /**< Priority of the subscriber. */
+    ATOMIC_T parallel;          /**< Whether the parallel group of change subscribers (::SR_SUBSCR_PARALLEL) is notified
+                                     together with the subscribers of the priority. */
+    ATOMIC_T async;             /**< Whether all the change subscribers are notified regardless of their priority
+                                     and the originator does not wait for them (asynchronous "done" event). */
     uint32_t subscriber_count;  /**< Number of subscribers to process this event. */
 } sr_multi_sub_shm_t;
 
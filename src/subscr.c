@@ -95,9 +95,12 @@ sr_subscr_change_sub_add(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_sess
     change_sub->subs[change_sub->sub_count].sub_id = sub_id;
     if (xpath) {
         mem[3] = strdup(xpath);
-        SR_CHECK_MEM_RET(!mem[3], err_info);
+        SR_CHECK_MEM_GOTO(!mem[3], err_info, error);
         change_sub->subs[change_sub->sub_count].xpath = mem[3];
     }
+    if ((err_info = sr_xpath_filter_compile(xpath, &change_sub->subs[change_sub->sub_count].filter))) {
+        goto error;
+    }
     change_sub->subs[change_sub->sub_count].priority = priority;
     change_sub->subs[change_sub->sub_count].opts = sub_opts;
     change_sub->subs[change_sub->sub_count].cb = change_cb;
@@ -152,6 +155,7 @@ sr_subscr_change_sub_del(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_lock
 
             /* found our subscription, replace it with the last */
             free(change_sub->subs[j].xpath);
+            sr_xpath_filter_clear(&change_sub->subs[j].filter);
             if (j < change_sub->sub_count - 1) {
                 memcpy(&change_sub->subs[j], &change_sub->subs[change_sub->sub_count - 1], sizeof *change_sub->subs);
             }
@@ -556,6 +560,9 @@ sr_subscr_notif_sub_add(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_sessi
         SR_CHECK_MEM_GOTO(!mem[3], err_info, error);
         notif_sub->subs[notif_sub->sub_count].xpath = mem[3];
     }
+    if ((err_info = sr_xpath_filter_compile(xpath, &notif_sub->subs[notif_sub->sub_count].filter))) {
+        goto error;
+    }
     notif_sub->subs[notif_sub->sub_count].listen_since = *listen_since;
     if (start_time) {
         notif_sub->subs[notif_sub->sub_count].start_time = *start_time;
@@ -645,6 +652,7 @@ sr_subscr_notif_sub_del(sr_subscription_ctx_t *subscr, uint32_t sub_id, sr_lock_
 
             /* replace the subscription with the last */
             free(sub->xpath);
+            sr_xpath_filter_clear(&sub->filter);
             if (j < notif_sub->sub_count - 1) {
                 memcpy(sub, &notif_sub->subs[notif_sub->sub_count - 1], sizeof *notif_sub->subs);
             }
@@ -54,6 +54,9 @@
 #include "utils/nacm.h"
 
 static sr_error_info_t *sr_session_notif_buf_stop(sr_session_ctx_t *session);
+static sr_error_info_t *sr_session_commit_buf_stop(sr_session_ctx_t *session);
+static void sr_rpc_async_session_wait(sr_session_ctx_t *session);
+static void sr_rpc_async_stop(sr_conn_ctx_t *conn);
 static sr_error_info_t *_sr_session_stop(sr_session_ctx_t *session);
 static sr_error_info_t *sr_changes_notify_store(struct sr_mod_info_s *mod_info, sr_session_ctx_t *session,
         uint32_t timeout_ms, sr_error_info_t **cb_err_info);
@@ -109,18 +112,86 @@ sr_conn_new(const sr_conn_options_t opts, sr_conn_ctx_t **conn_p)
     if ((err_info = sr_rwlock_init(&conn->run_cache_lock, 0))) {
         goto error8;
     }
-    if ((err_info = sr_ntf_handle_init(&conn->ntf_handles, &conn->ntf_handle_count))) {
+    if ((err_info = sr_mutex_init(&conn->oper_push_cache_lock, 0))) {
         goto error9;
     }
-    if ((err_info = sr_rwlock_init(&conn->oper_cache_lock, 0))) {
+    if ((err_info = sr_ntf_handle_init(&conn->ntf_handles, &conn->ntf_handle_count))) {
         goto error10;
     }
+    if ((err_info = sr_rwlock_init(&conn->oper_cache_lock, 0))) {
+        goto error11;
+    }
+    if ((err_info = sr_mutex_init(&conn->evloop.lock, 0))) {
+        goto error12;
+    }
+    if ((err_info = sr_cond_init(&conn->evloop.cond, 0, 0))) {
+        goto error13;
+    }
+    conn->evloop.epoll_fd = -1;
+    conn->evloop.wake_fd = -1;
+    conn->evloop.worker_count = SR_EVLOOP_DFLT_WORKER_COUNT;
+    if ((err_info = sr_mutex_init(&conn->rpc_async.lock, 0))) {
+        goto error14;
+    }
+    if ((err_info = sr_cond_init(&conn->rpc_async.cond, 0, 0))) {
+        goto error15;
+    }
+    if ((err_info = sr_mutex_init(&conn->change_diff_cache_lock, 0))) {
+        goto error16;
+    }
+    if ((err_info = sr_mutex_init(&conn->yanglib_cache_lock, 0))) {
+        goto error17;
+    }
+    if ((err_info = sr_mutex_init(&conn->ro_data_cache_lock, 0))) {
+        goto error18;
+    }
+    if ((err_info = sr_mutex_init(&conn->xpath_mods_cache_lock, 0))) {
+        goto error19;
+    }
+    if ((err_info = sr_mutex_init(&conn->instid_cache_lock, 0))) {
+        goto error20;
+    }
+    if ((err_info = sr_mutex_init(&conn->thread_attr_lock, 0))) {
+        goto error21;
+    }
+    if ((err_info = sr_mutex_init(&conn->oper_view_lock, 0))) {
+        goto error22;
+    }
+    if ((err_info = sr_mutex_init(&conn->replay_ring_cache_lock, 0))) {
+        goto error23;
+    }
 
     *conn_p = conn;
     return NULL;
 
-error10:
+error23:
+    pthread_mutex_destroy(&conn->oper_view_lock);
+error22:
+    pthread_mutex_destroy(&conn->thread_attr_lock);
+error21:
+    pthread_mutex_destroy(&conn->instid_cache_lock);
+error20:
+    pthread_mutex_destroy(&conn->xpath_mods_cache_lock);
+error19:
+    pthread_mutex_destroy(&conn->ro_data_cache_lock);
+error18:
+    pthread_mutex_destroy(&conn->yanglib_cache_lock);
+error17:
+    pthread_mutex_destroy(&conn->change_diff_cache_lock);
+error16:
+    sr_cond_destroy(&conn->rpc_async.cond);
+error15:
+    pthread_mutex_destroy(&conn->rpc_async.lock);
+error14:
+    sr_cond_destroy(&conn->evloop.cond);
+error13:
+    pthread_mutex_destroy(&conn->evloop.lock);
+error12:
+    sr_rwlock_destroy(&conn->oper_cache_lock);
+error11:
     sr_ntf_handle_free(conn->ntf_handles, conn->ntf_handle_count);
+error10:
+    pthread_mutex_destroy(&conn->oper_push_cache_lock);
 error9:
     sr_rwlock_destroy(&conn->run_cache_lock);
 error8:
@@ -161,6 +232,14 @@ sr_conn_free(sr_conn_ctx_t *conn)
     /* unlocked data destroy */
     lyd_free_siblings(conn->ly_ext_data);
     sr_conn_run_cache_flush(conn);
+    sr_conn_oper_push_cache_flush(conn);
+    sr_conn_oper_view_flush(conn);
+    sr_conn_change_diff_cache_flush(conn);
+    sr_conn_yanglib_cache_flush(conn);
+    sr_conn_ro_data_cache_flush(conn);
+    sr_conn_xpath_mods_cache_flush(conn);
+    sr_conn_instid_cache_flush(conn);
+    sr_replay_ring_cache_flush(conn);
     for (i = 0; i < conn->oper_cache_count; ++i) {
         lyd_free_siblings(conn->oper_caches[i].data);
     }
@@ -180,14 +259,36 @@ sr_conn_free(sr_conn_ctx_t *conn)
     sr_shm_clear(&conn->ext_shm);
     sr_ds_handle_free(conn->ds_handles, conn->ds_handle_count);
     sr_rwlock_destroy(&conn->run_cache_lock);
+    pthread_mutex_destroy(&conn->oper_push_cache_lock);
     sr_ntf_handle_free(conn->ntf_handles, conn->ntf_handle_count);
     sr_rwlock_destroy(&conn->oper_cache_lock);
+    pthread_mutex_destroy(&conn->evloop.lock);
+    sr_cond_destroy(&conn->evloop.cond);
+    pthread_mutex_destroy(&conn->rpc_async.lock);
+    sr_cond_destroy(&conn->rpc_async.cond);
+    pthread_mutex_destroy(&conn->change_diff_cache_lock);
+    pthread_mutex_destroy(&conn->yanglib_cache_lock);
+    pthread_mutex_destroy(&conn->ro_data_cache_lock);
+    pthread_mutex_destroy(&conn->xpath_mods_cache_lock);
+    pthread_mutex_destroy(&conn->instid_cache_lock);
+    pthread_mutex_destroy(&conn->thread_attr_lock);
+    pthread_mutex_destroy(&conn->oper_view_lock);
+    pthread_mutex_destroy(&conn->replay_ring_cache_lock);
 
     for (i = 0; i < conn->oper_push_mod_count; ++i) {
         free(conn->oper_push_mods[i]);
     }
     free(conn->oper_push_mods);
 
+    for (i = 0; i < conn->lazy_mod_count; ++i) {
+        free(conn->lazy_mods[i]);
+    }
+    free(conn->lazy_mods);
+
+    for (i = 0; i <= SR_THREAD_NOTIF_BUF; ++i) {
+        sr_thread_attr_free(conn->thread_attr[i]);
+    }
+
     free(conn);
 }
 
@@ -206,6 +307,9 @@ sr_connect(const sr_conn_options_t opts, sr_conn_ctx_t **conn_p)
 
     SR_CHECK_ARG_APIRET(!conn_p, NULL, err_info);
 
+    /* event pipes of subscribers that are gone must not terminate the process */
+    sr_shmsub_evpipe_init();
+
     /* check that all required directories exist */
     if ((err_info = sr_shmmain_check_dirs())) {
         goto cleanup;
@@ -276,7 +380,7 @@ sr_connect(const sr_conn_options_t opts, sr_conn_ctx_t **conn_p)
             if ((err_info = sr_shm_remap(&conn->ext_shm, SR_SHM_SIZE(sizeof(sr_ext_shm_t))))) {
                 goto cleanup_unlock;
             }
-            SR_CONN_EXT_SHM(conn)->first_hole_off = 0;
+            memset(SR_CONN_EXT_SHM(conn), 0, sizeof(sr_ext_shm_t));
         }
 
         /* add internal RPC subscription into ext SHM */
@@ -357,6 +461,16 @@ sr_disconnect(sr_conn_ctx_t *conn)
         return sr_api_ret(NULL, NULL);
     }
 
+    /* send all the queued asynchronous RPCs/actions while the subscriptions still exist */
+    sr_rpc_async_stop(conn);
+
+    /* stop all session commit buffer threads, the buffered edits are committed while the subscriptions still exist */
+    for (i = 0; i < conn->session_count; ++i) {
+        if ((err_info = sr_session_commit_buf_stop(conn->sessions[i]))) {
+            return sr_api_ret(NULL, err_info);
+        }
+    }
+
     /* stop all session notification buffer threads, they use read lock so they need conn state in SHM */
     for (i = 0; i < conn->session_count; ++i) {
         if ((err_info = sr_session_notif_buf_stop(conn->sessions[i]))) {
@@ -373,6 +487,9 @@ sr_disconnect(sr_conn_ctx_t *conn)
         }
     }
 
+    /* stop the shared event loop, it has no subscriptions left */
+    sr_shmsub_evloop_stop(conn);
+
     /* stop all the sessions */
     while (conn->session_count) {
         if ((err_info = _sr_session_stop(conn->sessions[0]))) {
@@ -506,6 +623,78 @@ cleanup:
     return sr_api_ret(NULL, err_info);
 }
 
+API int
+sr_get_ext_shm_stats(sr_conn_ctx_t *conn, sr_ext_shm_stats_t *stats)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!conn || !stats, NULL, err_info);
+
+    /* EXT READ LOCK */
+    if ((err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_READ, 1, __func__))) {
+        return sr_api_ret(NULL, err_info);
+    }
+
+    sr_shmext_stats(&conn->ext_shm, stats);
+
+    /* EXT READ UNLOCK */
+    sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 1, __func__);
+
+    return sr_api_ret(NULL, err_info);
+}
+
+API int
+sr_get_shm_stats(sr_conn_ctx_t *conn, sr_shm_stats_t **stats)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!conn || !stats, NULL, err_info);
+
+    *stats = calloc(1, sizeof **stats);
+    SR_CHECK_MEM_GOTO(!*stats, err_info, cleanup);
+
+    /* MOD REMAP LOCK */
+    if ((err_info = sr_rwlock(&conn->mod_remap_lock, SR_CONN_REMAP_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__,
+            NULL, NULL))) {
+        goto cleanup;
+    }
+
+    /* EXT READ LOCK */
+    if (!(err_info = sr_shmext_conn_remap_lock(conn, SR_LOCK_READ, 1, __func__))) {
+        err_info = sr_shmext_shm_stats(conn, *stats);
+
+        /* EXT READ UNLOCK */
+        sr_shmext_conn_remap_unlock(conn, SR_LOCK_READ, 1, __func__);
+    }
+
+    /* MOD REMAP UNLOCK */
+    sr_rwunlock(&conn->mod_remap_lock, SR_CONN_REMAP_LOCK_TIMEOUT, SR_LOCK_READ, conn->cid, __func__);
+
+cleanup:
+    if (err_info && *stats) {
+        sr_free_shm_stats(*stats);
+        *stats = NULL;
+    }
+    return sr_api_ret(NULL, err_info);
+}
+
+API void
+sr_free_shm_stats(sr_shm_stats_t *stats)
+{
+    uint32_t i;
+
+    if (!stats) {
+        return;
+    }
+
+    for (i = 0; i < stats->mod_count; ++i) {
+        free(stats->mods[i].name);
+    }
+    free(stats->mods);
+    free(stats->conns);
+    free(stats);
+}
+
 API uid_t
 sr_get_su_uid(void)
 {
@@ -529,6 +718,11 @@ sr_discard_oper_changes(sr_conn_ctx_t *conn, sr_session_ctx_t *session, const ch
     }
     SR_MODINFO_INIT(mod_info, conn, SR_DS_OPERATIONAL, SR_DS_OPERATIONAL);
 
+    /* load the modules into a lazy context */
+    if (xpath && (err_info = sr_lycc_lazy_load(conn, xpath, NULL))) {
+        return sr_api_ret(NULL, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
         goto cleanup;
@@ -612,6 +806,101 @@ cleanup:
     return sr_api_ret(NULL, err_info);
 }
 
+/**
+ * @brief Load data of modules into the connection caches of a datastore.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] ds Datastore to load.
+ * @param[in] module_names Names of the modules to load, all the modules with data if NULL.
+ * @param[in] module_count Count of @p module_names.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_conn_prefetch_ds(sr_conn_ctx_t *conn, sr_datastore_t ds, const char **module_names, uint32_t module_count)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_mod_info_s mod_info;
+    const struct lys_module *ly_mod;
+    uint32_t i;
+
+    SR_MODINFO_INIT(mod_info, conn, ds, ds == SR_DS_OPERATIONAL ? SR_DS_RUNNING : ds);
+
+    /* collect all required modules */
+    if (module_names) {
+        for (i = 0; i < module_count; ++i) {
+            ly_mod = ly_ctx_get_module_implemented(conn->ly_ctx, module_names[i]);
+            if (!ly_mod) {
+                sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, "Module \"%s\" was not found in sysrepo.", module_names[i]);
+                goto cleanup;
+            }
+            if ((err_info = sr_modinfo_add(ly_mod, NULL, 0, 0, &mod_info))) {
+                goto cleanup;
+            }
+        }
+    } else if ((err_info = sr_modinfo_add_all_modules_with_data(conn->ly_ctx, ds == SR_DS_OPERATIONAL, &mod_info))) {
+        goto cleanup;
+    }
+
+    /* load the data, which updates the caches, operational get subscribers are not asked for their data */
+    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_DATA_CACHE | SR_MI_DATA_RO |
+            SR_MI_PERM_READ | (module_names ? SR_MI_PERM_STRICT : 0), 0, NULL, NULL, 0, 0, SR_OPER_NO_SUBS))) {
+        goto cleanup;
+    }
+
+cleanup:
+    sr_shmmod_modinfo_unlock(&mod_info);
+    sr_modinfo_erase(&mod_info);
+    return err_info;
+}
+
+API int
+sr_conn_prefetch(sr_conn_ctx_t *conn, const char **module_names, uint32_t module_count, sr_prefetch_options_t opts)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+
+    SR_CHECK_ARG_APIRET(!conn || (module_count && !module_names) || !opts, NULL, err_info);
+
+    if ((opts & SR_PREFETCH_RUNNING) && !(conn->opts & SR_CONN_CACHE_RUNNING)) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Running data cache is not enabled for the connection.");
+        return sr_api_ret(NULL, err_info);
+    }
+    if ((opts & SR_PREFETCH_OPER) && !(conn->opts & (SR_CONN_CACHE_OPER_PUSH | SR_CONN_CACHE_OPER_VIEW))) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Operational data caches are not enabled for the connection.");
+        return sr_api_ret(NULL, err_info);
+    }
+
+    /* load the modules into a lazy context */
+    for (i = 0; i < module_count; ++i) {
+        if ((err_info = sr_lycc_lazy_load(conn, NULL, module_names[i]))) {
+            return sr_api_ret(NULL, err_info);
+        }
+    }
+
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        return sr_api_ret(NULL, err_info);
+    }
+
+    if (opts & SR_PREFETCH_RUNNING) {
+        if ((err_info = sr_conn_prefetch_ds(conn, SR_DS_RUNNING, module_names, module_count))) {
+            goto cleanup;
+        }
+    }
+
+    if (opts & SR_PREFETCH_OPER) {
+        if ((err_info = sr_conn_prefetch_ds(conn, SR_DS_OPERATIONAL, module_names, module_count))) {
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    /* CONTEXT UNLOCK */
+    sr_lycc_unlock(conn, SR_LOCK_READ, 0, __func__);
+
+    return sr_api_ret(NULL, err_info);
+}
+
 /**
  * @brief Set originator name and data for a session.
  *
@@ -691,6 +980,12 @@ _sr_session_start(sr_conn_ctx_t *conn, const sr_datastore_t datastore, sr_sub_ev
     if ((err_info = sr_rwlock_init(&(*session)->notif_buf.lock, 0))) {
         goto error;
     }
+    if ((err_info = sr_mutex_init(&(*session)->commit_buf.lock, 0))) {
+        goto error;
+    }
+    if ((err_info = sr_cond_init(&(*session)->commit_buf.cond, 0, 0))) {
+        goto error;
+    }
 
     if (!event) {
         SR_LOG_INF("Session %" PRIu32 " (user \"%s\", CID %" PRIu32 ") created.", (*session)->sid, (*session)->user,
@@ -798,6 +1093,37 @@ sr_session_notif_buf_stop(sr_session_ctx_t *session)
     return err_info;
 }
 
+/**
+ * @brief Release all the DS locks held by a session.
+ *
+ * @param[in] session Session whose locks to release.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_session_ds_locks_release(sr_session_ctx_t *session)
+{
+    sr_error_info_t *err_info = NULL;
+
+    if (!session->ds_locked) {
+        /* no need to check the locks of all the modules */
+        return NULL;
+    }
+
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
+        return err_info;
+    }
+
+    /* release any held locks */
+    sr_shmmod_release_locks(session->conn, session->sid);
+    session->ds_locked = 0;
+
+    /* CONTEXT UNLOCK */
+    sr_lycc_unlock(session->conn, SR_LOCK_READ, 0, __func__);
+
+    return NULL;
+}
+
 /**
  * @brief Unlocked stop (free) a session.
  *
@@ -813,6 +1139,14 @@ _sr_session_stop(sr_session_ctx_t *session)
     /* subscriptions need to be freed before, with a WRITE lock */
     assert(!session->subscription_count && !session->subscriptions);
 
+    /* wait for all the asynchronous RPCs/actions of the session */
+    sr_rpc_async_session_wait(session);
+
+    /* stop commit buffering thread, it may generate notifications */
+    if ((err_info = sr_session_commit_buf_stop(session))) {
+        return err_info;
+    }
+
     /* stop notification buffering thread */
     if ((err_info = sr_session_notif_buf_stop(session))) {
         return err_info;
@@ -822,17 +1156,11 @@ _sr_session_stop(sr_session_ctx_t *session)
     tmp_err = sr_ptr_del(&session->conn->ptr_lock, (void ***)&session->conn->sessions, &session->conn->session_count, session);
     sr_errinfo_merge(&err_info, tmp_err);
 
-    /* CONTEXT LOCK */
-    if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
+    /* release any held DS locks */
+    if ((err_info = sr_session_ds_locks_release(session))) {
         return err_info;
     }
 
-    /* release any held locks */
-    sr_shmmod_release_locks(session->conn, session->sid);
-
-    /* CONTEXT UNLOCK */
-    sr_lycc_unlock(session->conn, SR_LOCK_READ, 0, __func__);
-
     /* free attributes */
     free(session->user);
     free(session->nacm_user);
@@ -848,8 +1176,11 @@ _sr_session_stop(sr_session_ctx_t *session)
     for (ds = 0; ds < SR_DS_COUNT; ++ds) {
         sr_release_data(session->dt[ds].edit);
         lyd_free_all(session->dt[ds].diff);
+        free(session->dt[ds].change_log);
     }
     sr_rwlock_destroy(&session->notif_buf.lock);
+    pthread_mutex_destroy(&session->commit_buf.lock);
+    sr_cond_destroy(&session->commit_buf.cond);
     free(session);
 
     return err_info;
@@ -878,6 +1209,64 @@ sr_session_stop(sr_session_ctx_t *session)
     return sr_api_ret(NULL, NULL);
 }
 
+API int
+sr_session_reset(sr_session_ctx_t *session, const sr_datastore_t datastore)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_datastore_t ds;
+    int rc;
+
+    SR_CHECK_ARG_APIRET(!session || session->ev, session, err_info);
+
+    /* stop all subscriptions of this session */
+    if ((rc = sr_session_unsubscribe(session))) {
+        return rc;
+    }
+
+    /* wait for all the asynchronous RPCs/actions of the session */
+    sr_rpc_async_session_wait(session);
+
+    /* stop commit and notification buffering threads */
+    if ((err_info = sr_session_commit_buf_stop(session))) {
+        return sr_api_ret(session, err_info);
+    }
+    if ((err_info = sr_session_notif_buf_stop(session))) {
+        return sr_api_ret(session, err_info);
+    }
+
+    /* release any held DS locks of the previous session ID */
+    if ((err_info = sr_session_ds_locks_release(session))) {
+        return sr_api_ret(session, err_info);
+    }
+
+    /* forget all the session state but the user */
+    free(session->nacm_user);
+    session->nacm_user = NULL;
+    sr_errinfo_free(&session->err_info);
+    free(session->orig_name);
+    session->orig_name = NULL;
+    free(session->orig_data);
+    session->orig_data = NULL;
+    for (ds = 0; ds < SR_DS_COUNT; ++ds) {
+        sr_release_data(session->dt[ds].edit);
+        session->dt[ds].edit = NULL;
+        lyd_free_all(session->dt[ds].diff);
+        session->dt[ds].diff = NULL;
+        free(session->dt[ds].change_log);
+        session->dt[ds].change_log = NULL;
+    }
+    session->commit_prio = 0;
+    session->ds = datastore;
+
+    /* use new SR session ID */
+    session->sid = ATOMIC_INC_RELAXED(SR_CONN_MAIN_SHM(session->conn)->new_sr_sid);
+
+    SR_LOG_INF("Session %" PRIu32 " (user \"%s\", CID %" PRIu32 ") created by a reset.", session->sid, session->user,
+            session->conn->cid);
+
+    return sr_api_ret(session, NULL);
+}
+
 API int
 sr_session_unsubscribe(sr_session_ctx_t *session)
 {
@@ -900,7 +1289,6 @@ API int
 sr_session_notif_buffer(sr_session_ctx_t *session)
 {
     sr_error_info_t *err_info = NULL;
-    int r;
 
     if (!session || session->notif_buf.tid) {
         return sr_api_ret(NULL, NULL);
@@ -911,8 +1299,8 @@ sr_session_notif_buffer(sr_session_ctx_t *session)
     session->notif_buf.thread_running = 1;
 
     /* start the buffering thread */
-    if ((r = pthread_create(&session->notif_buf.tid, NULL, sr_notif_buf_thread, session))) {
-        sr_errinfo_new(&err_info, SR_ERR_INTERNAL, "Creating a new thread failed (%s).", strerror(r));
+    if ((err_info = sr_conn_thread_create(session->conn, SR_THREAD_NOTIF_BUF, &session->notif_buf.tid,
+            sr_notif_buf_thread, session))) {
         session->notif_buf.thread_running = 0;
         return sr_api_ret(session, err_info);
     }
@@ -1003,6 +1391,25 @@ sr_session_get_orig_data(sr_session_ctx_t *session, uint32_t idx, uint32_t *size
     return sr_ev_data_get(session->ev_data.orig_data, idx, size, (void **)data);
 }
 
+API int
+sr_session_get_oper_hints(sr_session_ctx_t *session, uint32_t *max_depth, uint32_t *limit, sr_get_oper_flag_t *opts)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!session || !session->ev, session, err_info);
+
+    if (max_depth) {
+        *max_depth = session->ev_data.oper_max_depth;
+    }
+    if (limit) {
+        *limit = session->ev_data.oper_limit;
+    }
+    if (opts) {
+        *opts = session->ev_data.oper_opts;
+    }
+    return SR_ERR_OK;
+}
+
 API int
 sr_session_get_error(sr_session_ctx_t *session, const sr_error_info_t **error_info)
 {
@@ -1174,6 +1581,18 @@ sr_session_get_user(sr_session_ctx_t *session)
     return session->user;
 }
 
+API int
+sr_session_set_commit_priority(sr_session_ctx_t *session, uint32_t priority)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!session || (priority > SR_COMMIT_PRIO_MAX), session, err_info);
+
+    session->commit_prio = priority;
+
+    return sr_api_ret(session, NULL);
+}
+
 API sr_conn_ctx_t *
 sr_session_get_connection(sr_session_ctx_t *session)
 {
@@ -1380,21 +1799,26 @@ _sr_install_modules(sr_conn_ctx_t *conn, const char *search_dirs, const char *da
     }
 
     /* check the new context can be used, optionally with initial module data */
-    if ((err_info = sr_lycc_check_add_modules(conn, new_ctx))) {
+    if ((err_info = sr_lycc_check_add_modules(conn, new_ctx, NULL))) {
         goto cleanup;
     }
     if ((err_info = sr_lycc_update_data(conn, new_ctx, mod_data, &data_info))) {
         goto cleanup;
     }
 
+    /* prepare updated lydmods data, stored only once the context is locked for writing */
+    if ((err_info = sr_lydmods_change_add_modules(new_ctx, new_mods, new_mod_count, &sr_mods))) {
+        goto cleanup;
+    }
+
     /* CONTEXT UPGRADE */
     if ((err_info = sr_lycc_relock(conn, SR_LOCK_WRITE, __func__))) {
         goto cleanup;
     }
     ctx_mode = SR_LOCK_WRITE;
 
-    /* update lydmods data */
-    if ((err_info = sr_lydmods_change_add_modules(new_ctx, new_mods, new_mod_count, &sr_mods))) {
+    /* store lydmods data */
+    if ((err_info = sr_lydmods_store(&sr_mods))) {
         goto cleanup;
     }
 
@@ -1629,14 +2053,19 @@ sr_remove_modules(sr_conn_ctx_t *conn, const char **module_names, int force)
         goto cleanup;
     }
 
+    /* prepare updated lydmods data, stored only once the context is locked for writing */
+    if ((err_info = sr_lydmods_change_del_module(conn->ly_ctx, new_ctx, &mod_set, &sr_del_mods, &sr_mods))) {
+        goto cleanup;
+    }
+
     /* CONTEXT UPGRADE */
     if ((err_info = sr_lycc_relock(conn, SR_LOCK_WRITE, __func__))) {
         goto cleanup;
     }
     ctx_mode = SR_LOCK_WRITE;
 
-    /* update lydmods data */
-    if ((err_info = sr_lydmods_change_del_module(conn->ly_ctx, new_ctx, &mod_set, &sr_del_mods, &sr_mods))) {
+    /* store lydmods data */
+    if ((err_info = sr_lydmods_store(&sr_mods))) {
         goto cleanup;
     }
 
@@ -1722,13 +2151,14 @@ sr_ly_update_module_imp_cb(const char *mod_name, const char *mod_rev, const char
  * @param[in] new_ctx New context to use for parsing.
  * @param[in] conn Connection to use.
  * @param[in] schema_paths Array of schema paths to the updated modules.
+ * @param[in] skip_mod_set Optional set of other modules not to load into @p new_ctx.
  * @param[in,out] old_mod_set Set to add old (current) modules into, only the updated ones.
  * @param[in,out] upd_mod_set Set to add updated modules into.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
 sr_update_modules_prepare(struct ly_ctx *new_ctx, sr_conn_ctx_t *conn, const char **schema_paths,
-        struct ly_set *old_mod_set, struct ly_set *upd_mod_set)
+        const struct ly_set *skip_mod_set, struct ly_set *old_mod_set, struct ly_set *upd_mod_set)
 {
     sr_error_info_t *err_info = NULL;
     sr_int_update_mod_t *upd_mods = NULL;
@@ -1736,6 +2166,9 @@ sr_update_modules_prepare(struct ly_ctx *new_ctx, sr_conn_ctx_t *conn, const cha
     const char **features = NULL, *no_features[] = {NULL};
     struct ly_in *in = NULL;
     struct lysp_feature *f = NULL;
+    struct ly_set load_skip_set = {0};
+    ly_module_imp_clb prev_imp_clb = NULL;
+    void *prev_imp_data = NULL;
     uint32_t i, j, schema_path_count = 0, feat_count = 0;
 
     /* get schema path count */
@@ -1774,10 +2207,18 @@ sr_update_modules_prepare(struct ly_ctx *new_ctx, sr_conn_ctx_t *conn, const cha
     }
 
     /* set import callback in case a module would try to import this module to be updated, to not load the old revision */
+    prev_imp_clb = ly_ctx_get_module_imp_clb(new_ctx, &prev_imp_data);
     ly_ctx_set_module_imp_clb(new_ctx, sr_ly_update_module_imp_cb, upd_mods);
 
-    /* load non-updated modules into the context */
-    if ((err_info = sr_shmmod_ctx_load_modules(SR_CONN_MOD_SHM(conn), new_ctx, old_mod_set))) {
+    /* load non-updated modules into the context, skip also any other modules */
+    if (skip_mod_set) {
+        if (ly_set_merge(&load_skip_set, old_mod_set, 1, NULL) || ly_set_merge(&load_skip_set, skip_mod_set, 1, NULL)) {
+            SR_ERRINFO_MEM(&err_info);
+            goto cleanup;
+        }
+    }
+    if ((err_info = sr_shmmod_ctx_load_modules(SR_CONN_MOD_SHM(conn), new_ctx,
+            skip_mod_set ? &load_skip_set : old_mod_set))) {
         goto cleanup;
     }
 
@@ -1820,6 +2261,11 @@ sr_update_modules_prepare(struct ly_ctx *new_ctx, sr_conn_ctx_t *conn, const cha
     }
 
 cleanup:
+    if (prev_imp_clb) {
+        /* restore the previous import callback, the data are freed */
+        ly_ctx_set_module_imp_clb(new_ctx, prev_imp_clb, prev_imp_data);
+    }
+    ly_set_erase(&load_skip_set, NULL);
     for (i = 0; i < schema_path_count; ++i) {
         free(upd_mods[i].name);
     }
@@ -1859,7 +2305,7 @@ sr_update_modules(sr_conn_ctx_t *conn, const char **schema_paths, const char *se
     ctx_mode = SR_LOCK_READ_UPGR;
 
     /* process every updated module and parse it */
-    if ((err_info = sr_update_modules_prepare(new_ctx, conn, schema_paths, &old_mod_set, &upd_mod_set))) {
+    if ((err_info = sr_update_modules_prepare(new_ctx, conn, schema_paths, NULL, &old_mod_set, &upd_mod_set))) {
         goto cleanup;
     }
 
@@ -1880,14 +2326,19 @@ sr_update_modules(sr_conn_ctx_t *conn, const char **schema_paths, const char *se
         goto cleanup;
     }
 
+    /* prepare updated lydmods data, stored only once the context is locked for writing */
+    if ((err_info = sr_lydmods_change_upd_modules(conn->ly_ctx, &upd_mod_set, &sr_mods))) {
+        goto cleanup;
+    }
+
     /* CONTEXT UPGRADE */
     if ((err_info = sr_lycc_relock(conn, SR_LOCK_WRITE, __func__))) {
         goto cleanup;
     }
     ctx_mode = SR_LOCK_WRITE;
 
-    /* update lydmods data */
-    if ((err_info = sr_lydmods_change_upd_modules(conn->ly_ctx, &upd_mod_set, &sr_mods))) {
+    /* store lydmods data */
+    if ((err_info = sr_lydmods_store(&sr_mods))) {
         goto cleanup;
     }
 
@@ -1924,6 +2375,365 @@ cleanup:
     return sr_api_ret(NULL, err_info);
 }
 
+/**
+ * @brief Check feature changes of a module set and load it with the final features into a context.
+ *
+ * @param[in,out] new_ctx Context to load the module into.
+ * @param[in] ly_mod Current module.
+ * @param[in] changes Array of all the feature changes.
+ * @param[in] change_count Count of @p changes.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_change_modules_load_features(struct ly_ctx *new_ctx, const struct lys_module *ly_mod,
+        const sr_feature_change_t *changes, uint32_t change_count)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lysp_feature *f = NULL;
+    struct ly_set feat_set = {0};
+    const char **features = NULL;
+    uint32_t i, j, idx;
+
+    /* collect currently enabled features */
+    i = 0;
+    while ((f = lysp_feature_next(f, ly_mod->parsed, &i))) {
+        if ((f->flags & LYS_FENABLED) && ly_set_add(&feat_set, (void *)f->name, 1, NULL)) {
+            SR_ERRINFO_MEM(&err_info);
+            goto cleanup;
+        }
+    }
+
+    /* apply all the changes of this module in order */
+    for (i = 0; i < change_count; ++i) {
+        if (strcmp(changes[i].module_name, ly_mod->name)) {
+            continue;
+        }
+
+        /* find the feature */
+        j = 0;
+        while ((f = lysp_feature_next(f, ly_mod->parsed, &j))) {
+            if (!strcmp(f->name, changes[i].feature_name)) {
+                break;
+            }
+        }
+        if (!f) {
+            sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, "Feature \"%s\" was not found in module \"%s\".",
+                    changes[i].feature_name, ly_mod->name);
+            goto cleanup;
+        }
+
+        if (ly_set_contains(&feat_set, (void *)f->name, &idx)) {
+            if (changes[i].enable) {
+                sr_errinfo_new(&err_info, SR_ERR_EXISTS, "Feature \"%s\" is already enabled in module \"%s\".",
+                        f->name, ly_mod->name);
+                goto cleanup;
+            }
+            ly_set_rm_index(&feat_set, idx, NULL);
+        } else {
+            if (!changes[i].enable) {
+                sr_errinfo_new(&err_info, SR_ERR_EXISTS, "Feature \"%s\" is already disabled in module \"%s\".",
+                        f->name, ly_mod->name);
+                goto cleanup;
+            }
+            if (ly_set_add(&feat_set, (void *)f->name, 1, NULL)) {
+                SR_ERRINFO_MEM(&err_info);
+                goto cleanup;
+            }
+        }
+    }
+
+    /* create features array */
+    features = calloc(feat_set.count + 1, sizeof *features);
+    SR_CHECK_MEM_GOTO(!features, err_info, cleanup);
+    for (i = 0; i < feat_set.count; ++i) {
+        features[i] = feat_set.objs[i];
+    }
+
+    /* load the module, it is compiled with all the other changes */
+    if (!ly_ctx_load_module(new_ctx, ly_mod->name, ly_mod->revision, features)) {
+        sr_errinfo_new_ly(&err_info, new_ctx, NULL);
+        goto cleanup;
+    }
+
+cleanup:
+    ly_set_erase(&feat_set, NULL);
+    free(features);
+    return err_info;
+}
+
+/**
+ * @brief Collect the modules of a module change set that are removed or have their features changed.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] changes Set of the changes.
+ * @param[in,out] del_mod_set Set of the removed modules.
+ * @param[in,out] feat_mod_set Set of the modules with changed features.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_change_modules_collect(sr_conn_ctx_t *conn, const sr_module_change_set_t *changes, struct ly_set *del_mod_set,
+        struct ly_set *feat_mod_set)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lys_module *ly_mod;
+    uint32_t i;
+
+    for (i = 0; changes->remove && changes->remove[i]; ++i) {
+        /* try to find the modules */
+        ly_mod = ly_ctx_get_module_implemented(conn->ly_ctx, changes->remove[i]);
+        if (!ly_mod) {
+            sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, "Module \"%s\" was not found in sysrepo.", changes->remove[i]);
+            return err_info;
+        }
+        if (sr_is_module_internal(ly_mod)) {
+            sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Internal module \"%s\" cannot be uninstalled.",
+                    changes->remove[i]);
+            return err_info;
+        }
+
+        if (changes->force_remove) {
+            /* collect all the removed modules for this module to be deleted */
+            if ((err_info = sr_collect_module_impl_deps(ly_mod, del_mod_set))) {
+                return err_info;
+            }
+        } else if (ly_set_add(del_mod_set, (void *)ly_mod, 1, NULL)) {
+            SR_ERRINFO_MEM(&err_info);
+            return err_info;
+        }
+
+        /* check write permission */
+        if ((err_info = sr_perm_check(conn, ly_mod, SR_DS_STARTUP, 1, NULL))) {
+            return err_info;
+        }
+    }
+
+    for (i = 0; i < changes->feature_count; ++i) {
+        /* try to find this module */
+        ly_mod = ly_ctx_get_module_implemented(conn->ly_ctx, changes->features[i].module_name);
+        if (!ly_mod) {
+            sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, "Module \"%s\" was not found in sysrepo.",
+                    changes->features[i].module_name);
+            return err_info;
+        }
+        if (ly_set_contains(del_mod_set, (void *)ly_mod, NULL)) {
+            sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Features of module \"%s\" cannot be changed because "
+                    "it is being removed.", ly_mod->name);
+            return err_info;
+        }
+
+        /* check write perm */
+        if ((err_info = sr_perm_check(conn, ly_mod, SR_DS_STARTUP, 1, NULL))) {
+            return err_info;
+        }
+
+        if (ly_set_add(feat_mod_set, (void *)ly_mod, 0, NULL)) {
+            SR_ERRINFO_MEM(&err_info);
+            return err_info;
+        }
+    }
+
+    return NULL;
+}
+
+API int
+sr_change_modules(sr_conn_ctx_t *conn, const sr_module_change_set_t *changes, const char *search_dirs)
+{
+    sr_error_info_t *err_info = NULL;
+    struct ly_ctx *new_ctx = NULL, *old_ctx = NULL;
+    struct ly_set del_mod_set = {0}, feat_mod_set = {0}, old_mod_set = {0}, upd_mod_set = {0}, mod_set = {0};
+    struct lyd_node *sr_mods = NULL, *sr_del_mods = NULL;
+    struct sr_data_update_s data_info = {0};
+    sr_int_install_mod_t *new_mods = NULL;
+    const struct lys_module *ly_mod;
+    const char *no_paths[] = {NULL};
+    sr_lock_mode_t ctx_mode = SR_LOCK_NONE;
+    uint32_t i, new_mod_count = 0, search_dir_count = 0;
+
+    SR_CHECK_ARG_APIRET(!conn || !changes || (changes->install_count && !changes->install) ||
+            (changes->feature_count && !changes->features) || (changes->replay_count && !changes->replay), NULL, err_info);
+
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ_UPGR, 1, __func__))) {
+        goto cleanup;
+    }
+    ctx_mode = SR_LOCK_READ_UPGR;
+
+    if (!changes->install_count && !(changes->remove && changes->remove[0]) && !(changes->update &&
+            changes->update[0]) && !changes->feature_count) {
+        /* no context change */
+        goto replay;
+    }
+
+    /* collect removed modules and modules with feature changes */
+    if ((err_info = sr_change_modules_collect(conn, changes, &del_mod_set, &feat_mod_set))) {
+        goto cleanup;
+    }
+    if (ly_set_merge(&mod_set, &del_mod_set, 1, NULL) || ly_set_merge(&mod_set, &feat_mod_set, 1, NULL)) {
+        SR_ERRINFO_MEM(&err_info);
+        goto cleanup;
+    }
+
+    /* create new temporary context */
+    if ((err_info = sr_ly_ctx_init(conn, &new_ctx))) {
+        goto cleanup;
+    }
+
+    /* set search dirs */
+    if ((err_info = sr_install_module_set_searchdirs(new_ctx, search_dirs, &search_dir_count))) {
+        goto cleanup;
+    }
+
+    /* load all the unchanged modules and parse the updated ones */
+    if ((err_info = sr_update_modules_prepare(new_ctx, conn, changes->update ? changes->update : no_paths, &mod_set,
+            &old_mod_set, &upd_mod_set))) {
+        goto cleanup;
+    }
+    for (i = 0; i < old_mod_set.count; ++i) {
+        if (ly_set_contains(&mod_set, old_mod_set.objs[i], NULL)) {
+            sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Module \"%s\" cannot be updated because it is being removed"
+                    " or its features changed.", ((struct lys_module *)old_mod_set.objs[i])->name);
+            goto cleanup;
+        }
+    }
+
+    /* load modules with changed features */
+    for (i = 0; i < feat_mod_set.count; ++i) {
+        if ((err_info = sr_change_modules_load_features(new_ctx, feat_mod_set.objs[i], changes->features,
+                changes->feature_count))) {
+            goto cleanup;
+        }
+    }
+
+    if (changes->install_count) {
+        /* copy all the new modules */
+        new_mods = calloc(changes->install_count, sizeof *new_mods);
+        SR_CHECK_MEM_GOTO(!new_mods, err_info, cleanup);
+        new_mod_count = changes->install_count;
+        for (i = 0; i < changes->install_count; ++i) {
+            memcpy(&new_mods[i], &changes->install[i], sizeof *changes->install);
+        }
+
+        for (i = 0; i < changes->install_count; ++i) {
+            /* process every new module and check/fill its info */
+            if ((err_info = sr_install_modules_prepare_mod(new_ctx, conn, &new_mods[i]))) {
+                goto cleanup;
+            }
+        }
+    }
+
+    /* compile the final context only once */
+    if (ly_ctx_compile(new_ctx)) {
+        sr_errinfo_new_ly(&err_info, new_ctx, NULL);
+        goto cleanup;
+    }
+
+    /* remove added search dirs */
+    ly_ctx_unset_searchdir_last(new_ctx, search_dir_count);
+
+    /* check the new context can be used */
+    if ((err_info = sr_lycc_check_add_modules(conn, new_ctx, &upd_mod_set))) {
+        goto cleanup;
+    }
+    if ((err_info = sr_lycc_check_del_module(conn, new_ctx, &del_mod_set))) {
+        goto cleanup;
+    }
+    if (upd_mod_set.count && (err_info = sr_lycc_check_upd_modules(conn, &old_mod_set, &upd_mod_set))) {
+        goto cleanup;
+    }
+    if ((err_info = sr_lycc_update_data(conn, new_ctx, NULL, &data_info))) {
+        goto cleanup;
+    }
+
+    /* prepare updated lydmods data, stored only once the context is locked for writing */
+    if ((err_info = sr_lydmods_change_modules(new_ctx, &new_mods, &new_mod_count, &del_mod_set, &upd_mod_set,
+            changes->features, changes->feature_count, &sr_del_mods, &sr_mods))) {
+        goto cleanup;
+    }
+
+    /* CONTEXT UPGRADE */
+    if ((err_info = sr_lycc_relock(conn, SR_LOCK_WRITE, __func__))) {
+        goto cleanup;
+    }
+    ctx_mode = SR_LOCK_WRITE;
+
+    /* store lydmods data */
+    if ((err_info = sr_lydmods_store(&sr_mods))) {
+        goto cleanup;
+    }
+
+    /* update SHM modules */
+    if ((err_info = sr_shmmod_store_modules(&conn->mod_shm, sr_mods))) {
+        goto cleanup;
+    }
+
+    /* finish removing, updating, and adding the modules */
+    if (del_mod_set.count && (err_info = sr_lycc_del_module(conn, new_ctx, &del_mod_set, sr_del_mods))) {
+        goto cleanup;
+    }
+    if ((err_info = sr_lycc_upd_modules(&old_mod_set, &upd_mod_set))) {
+        goto cleanup;
+    }
+    if ((err_info = sr_lycc_add_modules(conn, new_mods, new_mod_count))) {
+        goto cleanup;
+    }
+
+    /* store new data if they differ */
+    if ((err_info = sr_lycc_store_data_if_differ(conn, new_ctx, sr_mods, &data_info))) {
+        goto cleanup;
+    }
+
+    /* update content ID and safely switch the context */
+    ++SR_CONN_MAIN_SHM(conn)->content_id;
+    sr_conn_ctx_switch(conn, &new_ctx, &old_ctx);
+
+replay:
+    for (i = 0; i < changes->replay_count; ++i) {
+        ly_mod = NULL;
+        if (changes->replay[i].module_name) {
+            /* try to find this module */
+            ly_mod = ly_ctx_get_module_implemented(conn->ly_ctx, changes->replay[i].module_name);
+            if (!ly_mod) {
+                sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, "Module \"%s\" was not found in sysrepo.",
+                        changes->replay[i].module_name);
+                goto cleanup;
+            }
+        }
+
+        /* update lydmods data, mod SHM, and finish changing replay support */
+        lyd_free_siblings(sr_mods);
+        sr_mods = NULL;
+        ly_set_erase(&mod_set, NULL);
+        if ((err_info = sr_lydmods_change_chng_replay_support(conn, ly_mod, changes->replay[i].enable, &mod_set,
+                &sr_mods))) {
+            goto cleanup;
+        }
+        if ((err_info = sr_shmmod_update_replay_support(SR_CONN_MOD_SHM(conn), &mod_set, changes->replay[i].enable))) {
+            goto cleanup;
+        }
+        if ((err_info = sr_lycc_set_replay_support(conn, &mod_set, changes->replay[i].enable, sr_mods))) {
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    sr_lycc_update_data_clear(&data_info);
+    lyd_free_siblings(sr_mods);
+    lyd_free_siblings(sr_del_mods);
+    ly_ctx_destroy(old_ctx);
+    ly_ctx_destroy(new_ctx);
+
+    /* CONTEXT UNLOCK */
+    sr_lycc_unlock(conn, ctx_mode, 1, __func__);
+
+    free(new_mods);
+    ly_set_erase(&del_mod_set, NULL);
+    ly_set_erase(&feat_mod_set, NULL);
+    ly_set_erase(&old_mod_set, NULL);
+    ly_set_erase(&upd_mod_set, NULL);
+    ly_set_erase(&mod_set, NULL);
+    return sr_api_ret(NULL, err_info);
+}
+
 API int
 sr_set_module_replay_support(sr_conn_ctx_t *conn, const char *module_name, int enable)
 {
@@ -1984,6 +2794,11 @@ sr_get_module_replay_support(sr_conn_ctx_t *conn, const char *module_name, struc
 
     SR_CHECK_ARG_APIRET(!conn || !module_name || !enabled, NULL, err_info);
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(conn, NULL, module_name))) {
+        return sr_api_ret(NULL, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(NULL, err_info);
@@ -2096,6 +2911,11 @@ sr_set_module_ds_access(sr_conn_ctx_t *conn, const char *module_name, int mod_ds
         return sr_api_ret(NULL, NULL);
     }
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(conn, NULL, module_name))) {
+        return sr_api_ret(NULL, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(NULL, err_info);
@@ -2153,7 +2973,12 @@ sr_get_module_ds_access(sr_conn_ctx_t *conn, const char *module_name, int mod_ds
     SR_CHECK_ARG_APIRET(!conn || !module_name || (mod_ds >= SR_MOD_DS_PLUGIN_COUNT) || (mod_ds < 0) ||
             (!owner && !group && !perm), NULL, err_info);
 
-    /* find the module in SHM */
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(conn, NULL, module_name))) {
+        goto cleanup;
+    }
+
+    /* find the module in SHM */
     shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), module_name);
     if (!shm_mod) {
         sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, "Module \"%s\" was not found in sysrepo.", module_name);
@@ -2200,6 +3025,11 @@ sr_check_module_ds_access(sr_conn_ctx_t *conn, const char *module_name, int mod_
     SR_CHECK_ARG_APIRET(!conn || !module_name || (mod_ds >= SR_MOD_DS_PLUGIN_COUNT) || (mod_ds < 0) || (!read && !write),
             NULL, err_info);
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(conn, NULL, module_name))) {
+        goto cleanup;
+    }
+
     /* find the module in SHM */
     shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), module_name);
     if (!shm_mod) {
@@ -2385,14 +3215,19 @@ sr_change_module_feature(sr_conn_ctx_t *conn, const char *module_name, const cha
         goto cleanup;
     }
 
+    /* prepare updated lydmods data, stored only once the context is locked for writing */
+    if ((err_info = sr_lydmods_change_chng_feature(conn->ly_ctx, ly_mod, upd_ly_mod, feature_name, enable, &sr_mods))) {
+        goto cleanup;
+    }
+
     /* CONTEXT UPGRADE */
     if ((err_info = sr_lycc_relock(conn, SR_LOCK_WRITE, __func__))) {
         goto cleanup;
     }
     ctx_mode = SR_LOCK_WRITE;
 
-    /* update lydmods data */
-    if ((err_info = sr_lydmods_change_chng_feature(conn->ly_ctx, ly_mod, upd_ly_mod, feature_name, enable, &sr_mods))) {
+    /* store lydmods data */
+    if ((err_info = sr_lydmods_store(&sr_mods))) {
         goto cleanup;
     }
 
@@ -2564,6 +3399,11 @@ sr_get_item(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms, sr
     /* for operational, use operational and running datastore */
     SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds == SR_DS_OPERATIONAL ? SR_DS_RUNNING : session->ds);
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(session->conn, path, NULL))) {
+        return sr_api_ret(session, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(session, err_info);
@@ -2575,8 +3415,9 @@ sr_get_item(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms, sr
     }
 
     /* add modules into mod_info with deps, locking, and their data */
-    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_DATA_CACHE | SR_MI_PERM_READ,
-            session->sid, session->orig_name, session->orig_data, timeout_ms, 0, 0))) {
+    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ,
+            SR_MI_DATA_CACHE | SR_MI_DATA_RO | SR_MI_PERM_READ, session->sid, session->orig_name, session->orig_data,
+            timeout_ms, 0, 0))) {
         goto cleanup;
     }
 
@@ -2667,6 +3508,11 @@ sr_get_items(sr_session_ctx_t *session, const char *xpath, uint32_t timeout_ms,
     /* for operational, use operational and running datastore */
     SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds == SR_DS_OPERATIONAL ? SR_DS_RUNNING : session->ds);
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(session->conn, xpath, NULL))) {
+        return sr_api_ret(session, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(session, err_info);
@@ -2678,8 +3524,9 @@ sr_get_items(sr_session_ctx_t *session, const char *xpath, uint32_t timeout_ms,
     }
 
     /* add modules into mod_info with deps, locking, and their data */
-    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_DATA_CACHE | SR_MI_PERM_READ, session->sid,
-            session->orig_name, session->orig_data, timeout_ms, 0, opts))) {
+    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ,
+            SR_MI_DATA_CACHE | SR_MI_DATA_RO | SR_MI_PERM_READ, session->sid, session->orig_name, session->orig_data,
+            timeout_ms, 0, opts))) {
         goto cleanup;
     }
 
@@ -2688,16 +3535,23 @@ sr_get_items(sr_session_ctx_t *session, const char *xpath, uint32_t timeout_ms,
         goto cleanup;
     }
 
-    if (set->count) {
-        *values = calloc(set->count, sizeof **values);
-        SR_CHECK_MEM_GOTO(!*values, err_info, cleanup);
-    }
-
-    for (i = 0; i < set->count; ++i) {
-        if ((err_info = sr_val_ly2sr(set->dnodes[i], (*values) + i))) {
+    if (opts & SR_GET_READ_ONLY) {
+        /* all the values in a single memory block */
+        if ((err_info = sr_vals_ly2sr_block(set, values, value_cnt))) {
             goto cleanup;
         }
-        ++(*value_cnt);
+    } else {
+        if (set->count) {
+            *values = calloc(set->count, sizeof **values);
+            SR_CHECK_MEM_GOTO(!*values, err_info, cleanup);
+        }
+
+        for (i = 0; i < set->count; ++i) {
+            if ((err_info = sr_val_ly2sr(set->dnodes[i], (*values) + i))) {
+                goto cleanup;
+            }
+            ++(*value_cnt);
+        }
     }
 
 cleanup:
@@ -2722,6 +3576,75 @@ cleanup:
     return sr_api_ret(session, err_info);
 }
 
+API int
+sr_item_exists(sr_session_ctx_t *session, const char *xpath, uint32_t timeout_ms, const sr_get_options_t opts)
+{
+    sr_error_info_t *err_info = NULL;
+    struct ly_set *set = NULL;
+    int dup = 0, exists = 0;
+    struct sr_mod_info_s mod_info;
+    uint32_t i;
+
+    SR_CHECK_ARG_APIRET(!session || !xpath || ((session->ds != SR_DS_OPERATIONAL) && (opts & SR_OPER_MASK)),
+            session, err_info);
+
+    if (!timeout_ms) {
+        timeout_ms = SR_OPER_CB_TIMEOUT;
+    }
+    /* for operational, use operational and running datastore */
+    SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds == SR_DS_OPERATIONAL ? SR_DS_RUNNING : session->ds);
+
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(session->conn, xpath, NULL))) {
+        return sr_api_ret(session, err_info);
+    }
+
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
+        return sr_api_ret(session, err_info);
+    }
+
+    /* collect all required modules */
+    if ((err_info = sr_modinfo_collect_xpath(session->conn->ly_ctx, xpath, session->ds, 1, 0, &mod_info))) {
+        goto cleanup;
+    }
+
+    /* add modules into mod_info with deps, locking, and their data */
+    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ,
+            SR_MI_DATA_CACHE | SR_MI_DATA_RO | SR_MI_PERM_READ, session->sid, session->orig_name, session->orig_data,
+            timeout_ms, 0, opts))) {
+        goto cleanup;
+    }
+
+    /* filter the required data */
+    if ((err_info = sr_modinfo_get_filter(&mod_info, xpath, session, &set, &dup))) {
+        goto cleanup;
+    }
+    exists = set->count ? 1 : 0;
+
+cleanup:
+    /* MODULES UNLOCK */
+    sr_shmmod_modinfo_unlock(&mod_info);
+
+    if (dup && set) {
+        for (i = 0; i < set->count; ++i) {
+            lyd_free_tree(set->dnodes[i]);
+        }
+    }
+    ly_set_free(set, NULL);
+    sr_modinfo_erase(&mod_info);
+
+    /* CONTEXT UNLOCK */
+    sr_lycc_unlock(session->conn, SR_LOCK_READ, 0, __func__);
+
+    if (!err_info && !exists) {
+        /* expected result, no error info */
+        sr_api_ret(session, NULL);
+        return SR_ERR_NOT_FOUND;
+    }
+    return sr_api_ret(session, err_info);
+}
+
 API int
 sr_get_subtree(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms, sr_data_t **subtree)
 {
@@ -2739,6 +3662,11 @@ sr_get_subtree(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms,
     /* for operational, use operational and running datastore */
     SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds == SR_DS_OPERATIONAL ? SR_DS_RUNNING : session->ds);
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(session->conn, path, NULL))) {
+        return sr_api_ret(session, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(session, err_info);
@@ -2755,8 +3683,9 @@ sr_get_subtree(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms,
     }
 
     /* add modules into mod_info with deps, locking, and their data */
-    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_DATA_CACHE | SR_MI_PERM_READ, session->sid,
-            session->orig_name, session->orig_data, timeout_ms, 0, 0))) {
+    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ,
+            SR_MI_DATA_CACHE | SR_MI_DATA_RO | SR_MI_PERM_READ, session->sid, session->orig_name, session->orig_data,
+            timeout_ms, 0, 0))) {
         goto cleanup;
     }
 
@@ -2802,55 +3731,29 @@ cleanup:
     return sr_api_ret(session, err_info);
 }
 
-API int
-sr_get_data(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, uint32_t timeout_ms,
-        const sr_get_options_t opts, sr_data_t **data)
+/**
+ * @brief Connect some of the selected subtrees with their parents into one data tree.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] set Set with all the selected subtrees.
+ * @param[in] dup Whether the subtrees in @p set are duplicates that can be used directly, they are removed from it.
+ * @param[in] first Index of the first subtree to connect.
+ * @param[in] last Index after the last subtree to connect.
+ * @param[in] max_depth Maximum depth of the selected subtrees.
+ * @param[in,out] tree Data tree to merge the subtrees into.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_get_data_subtrees(sr_conn_ctx_t *conn, struct ly_set *set, int dup, uint32_t first, uint32_t last,
+        uint32_t max_depth, struct lyd_node **tree)
 {
     sr_error_info_t *err_info = NULL;
-    uint32_t i;
-    int dup_opts, dup = 0;
-    struct sr_mod_info_s mod_info;
-    struct ly_set *set = NULL;
     struct lyd_node *node;
-
-    SR_CHECK_ARG_APIRET(!session || !xpath || !data || ((session->ds != SR_DS_OPERATIONAL) && (opts & SR_OPER_MASK)),
-            session, err_info);
-
-    if (!timeout_ms) {
-        timeout_ms = SR_OPER_CB_TIMEOUT;
-    }
-
-    /* for operational, use operational and running datastore */
-    SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds == SR_DS_OPERATIONAL ? SR_DS_RUNNING : session->ds);
-
-    /* CONTEXT LOCK */
-    if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
-        return sr_api_ret(session, err_info);
-    }
-
-    /* prepare data wrapper */
-    if ((err_info = _sr_acquire_data(session->conn, NULL, data))) {
-        goto cleanup;
-    }
-
-    /* collect all required modules */
-    if ((err_info = sr_modinfo_collect_xpath(session->conn->ly_ctx, xpath, session->ds, 1, 0, &mod_info))) {
-        goto cleanup;
-    }
-
-    /* add modules into mod_info with deps, locking, and their data */
-    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_DATA_CACHE | SR_MI_PERM_READ, session->sid,
-            session->orig_name, session->orig_data, timeout_ms, 0, opts))) {
-        goto cleanup;
-    }
-
-    /* filter the required data */
-    if ((err_info = sr_modinfo_get_filter(&mod_info, (opts & SR_GET_NO_FILTER) ? "/*" : xpath, session, &set, &dup))) {
-        goto cleanup;
-    }
+    uint32_t i;
+    int dup_opts;
 
     /* duplicate all returned subtrees with their parents and merge into one data tree */
-    for (i = 0; i < set->count; ++i) {
+    for (i = first; i < last; ++i) {
         if (dup) {
             /* use subtree */
             node = set->dnodes[i];
@@ -2862,14 +3765,14 @@ sr_get_data(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, ui
             /* duplicate subtree */
             dup_opts = (max_depth ? 0 : LYD_DUP_RECURSIVE) | LYD_DUP_WITH_PARENTS | LYD_DUP_WITH_FLAGS;
             if (lyd_dup_single(set->dnodes[i], NULL, dup_opts, &node)) {
-                sr_errinfo_new_ly(&err_info, session->conn->ly_ctx, NULL);
-                goto cleanup;
+                sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
+                return err_info;
             }
 
             /* duplicate only to the specified depth */
             if ((err_info = sr_lyd_dup(set->dnodes[i], max_depth ? max_depth - 1 : 0, node))) {
                 lyd_free_all(node);
-                goto cleanup;
+                return err_info;
             }
         }
 
@@ -2879,47 +3782,41 @@ sr_get_data(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, ui
         }
 
         /* connect to the result */
-        if (!(*data)->tree) {
-            (*data)->tree = node;
+        if (!*tree) {
+            *tree = node;
         } else {
-            if (lyd_merge_tree(&(*data)->tree, node, LYD_MERGE_DESTRUCT)) {
-                sr_errinfo_new_ly(&err_info, session->conn->ly_ctx, NULL);
+            if (lyd_merge_tree(tree, node, LYD_MERGE_DESTRUCT)) {
+                sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
                 lyd_free_tree(node);
-                goto cleanup;
+                return err_info;
             }
         }
     }
 
-cleanup:
-    /* MODULES UNLOCK */
-    sr_shmmod_modinfo_unlock(&mod_info);
-
-    if (dup && set) {
-        for (i = 0; i < set->count; ++i) {
-            lyd_free_tree(set->dnodes[i]);
-        }
-    }
-    ly_set_free(set, NULL);
-    sr_modinfo_erase(&mod_info);
-
-    if (err_info || !(*data)->tree) {
-        sr_release_data(*data);
-        *data = NULL;
-    }
-    return sr_api_ret(session, err_info);
+    return NULL;
 }
 
-API int
-sr_get_node(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms, sr_data_t **node)
+/**
+ * @brief Retrieve a tree whose root nodes match the provided XPath.
+ *
+ * @param[in] session Session to use.
+ * @param[in] xpath XPath selecting root nodes of subtrees to be retrieved.
+ * @param[in] max_depth Maximum depth of the selected subtrees.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds.
+ * @param[in] opts Get options.
+ * @param[out] data SR data with connected top-level data trees of the requested data. NULL if none found.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+_sr_get_data(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, uint32_t timeout_ms,
+        const sr_get_options_t opts, sr_data_t **data)
 {
     sr_error_info_t *err_info = NULL;
-    struct ly_set *set = NULL;
-    int dup = 0;
+    uint32_t i, nacm_gen = 0;
+    int dup = 0, ro_share = 0;
     struct sr_mod_info_s mod_info;
-    struct lyd_node *n;
-    uint32_t i;
-
-    SR_CHECK_ARG_APIRET(!session || !path || !node, session, err_info);
+    struct ly_set *set = NULL;
+    sr_data_t *shared;
 
     if (!timeout_ms) {
         timeout_ms = SR_OPER_CB_TIMEOUT;
@@ -2928,53 +3825,70 @@ sr_get_node(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms, sr
     /* for operational, use operational and running datastore */
     SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds == SR_DS_OPERATIONAL ? SR_DS_RUNNING : session->ds);
 
+    /* let oper get subscribers know what is actually needed, only if the data they provide are selected directly,
+     * any predicates are applied on all the data so nothing can be skipped */
+    if (sr_xpath_is_plain_path(xpath) && !(opts & SR_GET_NO_FILTER)) {
+        mod_info.oper_max_depth = max_depth;
+    }
+
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(session->conn, xpath, NULL))) {
+        return err_info;
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
-        return sr_api_ret(session, err_info);
+        return err_info;
     }
 
     /* prepare data wrapper */
-    if ((err_info = _sr_acquire_data(session->conn, NULL, node))) {
+    if ((err_info = _sr_acquire_data(session->conn, NULL, data))) {
         goto cleanup;
     }
 
     /* collect all required modules */
-    if ((err_info = sr_modinfo_collect_xpath(session->conn->ly_ctx, path, session->ds, 1, 0, &mod_info))) {
+    if ((err_info = sr_modinfo_collect_xpath(session->conn->ly_ctx, xpath, session->ds, 1, 0, &mod_info))) {
         goto cleanup;
     }
 
     /* add modules into mod_info with deps, locking, and their data */
-    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_DATA_CACHE | SR_MI_PERM_READ,
-            session->sid, session->orig_name, session->orig_data, timeout_ms, 0, 0))) {
+    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ,
+            SR_MI_DATA_CACHE | SR_MI_DATA_RO | SR_MI_PERM_READ, session->sid, session->orig_name, session->orig_data,
+            timeout_ms, 0, opts))) {
         goto cleanup;
     }
 
+    if ((opts & SR_GET_READ_ONLY) && mod_info.data_cached && (session->ev == SR_SUB_EV_NONE) &&
+            !session->dt[session->ds].edit) {
+        /* the result depends only on the cached data and the NACM configuration, it can be shared */
+        ro_share = 1;
+        if (session->nacm_user) {
+            /* learn the NACM generation before filtering so that a concurrent NACM change is never missed */
+            nacm_gen = sr_nacm_get_gen();
+        }
+        if ((shared = sr_conn_ro_data_cache_get(session->conn, xpath, session->nacm_user, nacm_gen, max_depth,
+                opts))) {
+            /* use the shared result, the context lock is released with it */
+            free(*data);
+            *data = shared;
+            goto cleanup;
+        }
+    }
+
     /* filter the required data */
-    if ((err_info = sr_modinfo_get_filter(&mod_info, path, session, &set, &dup))) {
+    if ((err_info = sr_modinfo_get_filter(&mod_info, (opts & SR_GET_NO_FILTER) ? "/*" : xpath, session, &set, &dup))) {
         goto cleanup;
     }
 
-    if (set->count > 1) {
-        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "More nodes match \"%s\".", path);
-        goto cleanup;
-    } else if (!set->count) {
-        /* not found */
+    /* connect all the selected subtrees */
+    if ((err_info = sr_get_data_subtrees(session->conn, set, dup, 0, set->count, max_depth, &(*data)->tree))) {
         goto cleanup;
     }
 
-    /* return found node */
-    if (dup) {
-        /* use the node */
-        n = set->dnodes[0];
-        set->dnodes[0] = NULL;
-    } else {
-        /* duplicate the node */
-        if (lyd_dup_single(set->dnodes[0], NULL, LYD_DUP_WITH_FLAGS, &n)) {
-            sr_errinfo_new_ly(&err_info, session->conn->ly_ctx, NULL);
-            goto cleanup;
-        }
+    if (ro_share && (*data)->tree) {
+        /* share the result with the following read-only requests, while the cache is still locked */
+        sr_conn_ro_data_cache_store(session->conn, xpath, session->nacm_user, nacm_gen, max_depth, opts, *data);
     }
-    (*node)->tree = n;
 
 cleanup:
     /* MODULES UNLOCK */
@@ -2988,48 +3902,359 @@ cleanup:
     ly_set_free(set, NULL);
     sr_modinfo_erase(&mod_info);
 
-    if (err_info) {
-        /* error */
-        sr_release_data(*node);
-        *node = NULL;
-    } else if (!(*node)->tree) {
-        /* not found */
-        sr_release_data(*node);
-        *node = NULL;
-
-        sr_api_ret(session, err_info);
-        return SR_ERR_NOT_FOUND;
+    if (err_info || !(*data)->tree) {
+        sr_release_data(*data);
+        *data = NULL;
     }
-    return sr_api_ret(session, err_info);
+    return err_info;
 }
 
-API void
-sr_release_data(sr_data_t *data)
+API int
+sr_get_data(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, uint32_t timeout_ms,
+        const sr_get_options_t opts, sr_data_t **data)
 {
-    if (!data) {
-        return;
-    }
-
-    lyd_free_all(data->tree);
+    sr_error_info_t *err_info = NULL;
 
-    /* CONTEXT UNLOCK */
-    sr_lycc_unlock((sr_conn_ctx_t *)data->conn, SR_LOCK_READ, 0, __func__);
+    SR_CHECK_ARG_APIRET(!session || !xpath || !data || ((session->ds != SR_DS_OPERATIONAL) && (opts & SR_OPER_MASK)),
+            session, err_info);
 
-    free(data);
+    err_info = _sr_get_data(session, xpath, max_depth, timeout_ms, opts, data);
+    return sr_api_ret(session, err_info);
 }
 
-API void
-sr_free_val(sr_val_t *value)
+API int
+sr_get_data_serialized(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, uint32_t timeout_ms,
+        const sr_get_options_t opts, LYD_FORMAT format, uint32_t print_opts, char **str, size_t *str_len)
 {
-    if (!value) {
-        return;
-    }
+    sr_error_info_t *err_info = NULL;
+    sr_data_t *data = NULL;
+    struct ly_out *out = NULL;
 
-    free(value->xpath);
-    free(value->origin);
-    switch (value->type) {
-    case SR_BINARY_T:
-    case SR_BITS_T:
+    SR_CHECK_ARG_APIRET(!session || !xpath || ((format != LYD_XML) && (format != LYD_JSON) && (format != LYD_LYB)) ||
+            !str || !str_len || ((session->ds != SR_DS_OPERATIONAL) && (opts & SR_OPER_MASK)), session, err_info);
+
+    *str = NULL;
+    *str_len = 0;
+
+    /* the data are only printed so they can be shared */
+    if ((err_info = _sr_get_data(session, xpath, max_depth, timeout_ms, opts | SR_GET_READ_ONLY, &data))) {
+        goto cleanup;
+    }
+    if (!data) {
+        /* no data */
+        goto cleanup;
+    }
+
+    /* a shared result may have already been printed */
+    if (sr_conn_ro_data_cache_printed_get(session->conn, data, format, print_opts, str, str_len)) {
+        goto cleanup;
+    }
+
+    /* print the data */
+    if (ly_out_new_memory(str, 0, &out)) {
+        SR_ERRINFO_MEM(&err_info);
+        goto cleanup;
+    }
+    if (lyd_print_all(out, data->tree, format, print_opts)) {
+        sr_errinfo_new_ly(&err_info, session->conn->ly_ctx, NULL);
+        goto cleanup;
+    }
+    *str_len = ly_out_printed(out);
+
+    /* keep it for the following requests sharing the result */
+    sr_conn_ro_data_cache_printed_store(session->conn, data, format, print_opts, *str, *str_len);
+
+cleanup:
+    ly_out_free(out, NULL, 0);
+    sr_release_data(data);
+    if (err_info) {
+        free(*str);
+        *str = NULL;
+        *str_len = 0;
+    }
+    return sr_api_ret(session, err_info);
+}
+
+API int
+sr_get_data_iter(sr_session_ctx_t *session, const char *xpath, uint32_t chunk_size, uint32_t max_depth,
+        uint32_t timeout_ms, const sr_get_options_t opts, sr_data_iter_t **iter)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_mod_info_s mod_info;
+
+    SR_CHECK_ARG_APIRET(!session || !xpath || !chunk_size || !iter ||
+            ((session->ds != SR_DS_OPERATIONAL) && (opts & SR_OPER_MASK)), session, err_info);
+
+    if (!timeout_ms) {
+        timeout_ms = SR_OPER_CB_TIMEOUT;
+    }
+
+    /* for operational, use operational and running datastore */
+    SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds == SR_DS_OPERATIONAL ? SR_DS_RUNNING : session->ds);
+
+    /* all the selected subtrees are loaded at once, only the depth can be hinted */
+    if (sr_xpath_is_plain_path(xpath) && !(opts & SR_GET_NO_FILTER)) {
+        mod_info.oper_max_depth = max_depth;
+    }
+
+    *iter = calloc(1, sizeof **iter);
+    SR_CHECK_MEM_GOTO(!*iter, err_info, cleanup);
+
+    (*iter)->session = session;
+    (*iter)->chunk_size = chunk_size;
+    (*iter)->max_depth = max_depth;
+
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(session->conn, xpath, NULL))) {
+        goto cleanup;
+    }
+
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
+        goto cleanup;
+    }
+
+    /* prepare data wrapper keeping the context locked while the iterator exists */
+    if ((err_info = _sr_acquire_data(session->conn, NULL, &(*iter)->data))) {
+        goto cleanup;
+    }
+
+    /* collect all required modules */
+    if ((err_info = sr_modinfo_collect_xpath(session->conn->ly_ctx, xpath, session->ds, 1, 0, &mod_info))) {
+        goto cleanup;
+    }
+
+    /* add modules into mod_info with deps, locking, and their data, which are kept so they cannot be cached */
+    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_PERM_READ, session->sid,
+            session->orig_name, session->orig_data, timeout_ms, 0, opts))) {
+        goto cleanup;
+    }
+
+    /* filter the required data */
+    if ((err_info = sr_modinfo_get_filter(&mod_info, (opts & SR_GET_NO_FILTER) ? "/*" : xpath, session,
+            &(*iter)->set, &(*iter)->dup))) {
+        goto cleanup;
+    }
+
+    if (!(*iter)->dup) {
+        /* the selected subtrees are part of the loaded data, keep them */
+        (*iter)->data->tree = mod_info.data;
+        mod_info.data = NULL;
+    }
+
+cleanup:
+    /* MODULES UNLOCK */
+    sr_shmmod_modinfo_unlock(&mod_info);
+
+    sr_modinfo_erase(&mod_info);
+
+    if (err_info) {
+        sr_free_data_iter(*iter);
+        *iter = NULL;
+    }
+    return sr_api_ret(session, err_info);
+}
+
+API int
+sr_get_data_next(sr_data_iter_t *iter, sr_data_t **data)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_conn_ctx_t *conn;
+    uint32_t last;
+
+    SR_CHECK_ARG_APIRET(!iter || !data, NULL, err_info);
+
+    *data = NULL;
+    if (iter->offset >= iter->set->count) {
+        /* no more data */
+        return SR_ERR_NOT_FOUND;
+    }
+    conn = iter->session->conn;
+
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        return sr_api_ret(iter->session, err_info);
+    }
+
+    /* prepare data wrapper */
+    if ((err_info = _sr_acquire_data(conn, NULL, data))) {
+        return sr_api_ret(iter->session, err_info);
+    }
+
+    /* connect the next chunk of the selected subtrees */
+    last = iter->offset + iter->chunk_size;
+    if (last > iter->set->count) {
+        last = iter->set->count;
+    }
+    if ((err_info = sr_get_data_subtrees(conn, iter->set, iter->dup, iter->offset, last, iter->max_depth,
+            &(*data)->tree))) {
+        sr_release_data(*data);
+        *data = NULL;
+        return sr_api_ret(iter->session, err_info);
+    }
+
+    /* move the iterator */
+    iter->offset = last;
+
+    return sr_api_ret(iter->session, NULL);
+}
+
+API void
+sr_free_data_iter(sr_data_iter_t *iter)
+{
+    uint32_t i;
+
+    if (!iter) {
+        return;
+    }
+
+    if (iter->dup && iter->set) {
+        for (i = 0; i < iter->set->count; ++i) {
+            lyd_free_tree(iter->set->dnodes[i]);
+        }
+    }
+    ly_set_free(iter->set, NULL);
+
+    /* CONTEXT UNLOCK */
+    sr_release_data(iter->data);
+    free(iter);
+}
+
+API int
+sr_get_node(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms, sr_data_t **node)
+{
+    sr_error_info_t *err_info = NULL;
+    struct ly_set *set = NULL;
+    int dup = 0;
+    struct sr_mod_info_s mod_info;
+    struct lyd_node *n;
+    uint32_t i;
+
+    SR_CHECK_ARG_APIRET(!session || !path || !node, session, err_info);
+
+    if (!timeout_ms) {
+        timeout_ms = SR_OPER_CB_TIMEOUT;
+    }
+
+    /* for operational, use operational and running datastore */
+    SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds == SR_DS_OPERATIONAL ? SR_DS_RUNNING : session->ds);
+
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(session->conn, path, NULL))) {
+        return sr_api_ret(session, err_info);
+    }
+
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
+        return sr_api_ret(session, err_info);
+    }
+
+    /* prepare data wrapper */
+    if ((err_info = _sr_acquire_data(session->conn, NULL, node))) {
+        goto cleanup;
+    }
+
+    /* collect all required modules */
+    if ((err_info = sr_modinfo_collect_xpath(session->conn->ly_ctx, path, session->ds, 1, 0, &mod_info))) {
+        goto cleanup;
+    }
+
+    /* add modules into mod_info with deps, locking, and their data */
+    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ,
+            SR_MI_DATA_CACHE | SR_MI_DATA_RO | SR_MI_PERM_READ, session->sid, session->orig_name, session->orig_data,
+            timeout_ms, 0, 0))) {
+        goto cleanup;
+    }
+
+    /* filter the required data */
+    if ((err_info = sr_modinfo_get_filter(&mod_info, path, session, &set, &dup))) {
+        goto cleanup;
+    }
+
+    if (set->count > 1) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "More nodes match \"%s\".", path);
+        goto cleanup;
+    } else if (!set->count) {
+        /* not found */
+        goto cleanup;
+    }
+
+    /* return found node */
+    if (dup) {
+        /* use the node */
+        n = set->dnodes[0];
+        set->dnodes[0] = NULL;
+    } else {
+        /* duplicate the node */
+        if (lyd_dup_single(set->dnodes[0], NULL, LYD_DUP_WITH_FLAGS, &n)) {
+            sr_errinfo_new_ly(&err_info, session->conn->ly_ctx, NULL);
+            goto cleanup;
+        }
+    }
+    (*node)->tree = n;
+
+cleanup:
+    /* MODULES UNLOCK */
+    sr_shmmod_modinfo_unlock(&mod_info);
+
+    if (dup && set) {
+        for (i = 0; i < set->count; ++i) {
+            lyd_free_tree(set->dnodes[i]);
+        }
+    }
+    ly_set_free(set, NULL);
+    sr_modinfo_erase(&mod_info);
+
+    if (err_info) {
+        /* error */
+        sr_release_data(*node);
+        *node = NULL;
+    } else if (!(*node)->tree) {
+        /* not found */
+        sr_release_data(*node);
+        *node = NULL;
+
+        sr_api_ret(session, err_info);
+        return SR_ERR_NOT_FOUND;
+    }
+    return sr_api_ret(session, err_info);
+}
+
+API void
+sr_release_data(sr_data_t *data)
+{
+    if (!data) {
+        return;
+    }
+
+    if (sr_conn_ro_data_cache_release((sr_conn_ctx_t *)data->conn, data)) {
+        /* shared read-only data, freed with the cache */
+
+        /* CONTEXT UNLOCK */
+        sr_lycc_unlock((sr_conn_ctx_t *)data->conn, SR_LOCK_READ, 0, __func__);
+        return;
+    }
+
+    lyd_free_all(data->tree);
+
+    /* CONTEXT UNLOCK */
+    sr_lycc_unlock((sr_conn_ctx_t *)data->conn, SR_LOCK_READ, 0, __func__);
+
+    free(data);
+}
+
+API void
+sr_free_val(sr_val_t *value)
+{
+    if (!value) {
+        return;
+    }
+
+    free(value->xpath);
+    free(value->origin);
+    switch (value->type) {
+    case SR_BINARY_T:
+    case SR_BITS_T:
     case SR_ENUM_T:
     case SR_IDENTITYREF_T:
     case SR_INSTANCEID_T:
@@ -3055,6 +4280,12 @@ sr_free_values(sr_val_t *values, size_t count)
         return;
     }
 
+    if (sr_vals_is_block(values, count)) {
+        /* read-only values, all the strings are stored in the same memory */
+        sr_vals_block_free(values);
+        return;
+    }
+
     for (i = 0; i < count; ++i) {
         free(values[i].xpath);
         free(values[i].origin);
@@ -3091,6 +4322,11 @@ sr_set_item(sr_session_ctx_t *session, const char *path, const sr_val_t *value,
         path = value->xpath;
     }
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(session->conn, path, NULL))) {
+        return sr_api_ret(session, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(session, err_info);
@@ -3127,6 +4363,11 @@ sr_set_item_str(sr_session_ctx_t *session, const char *path, const char *value,
         }
     }
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(session->conn, path, NULL))) {
+        goto cleanup;
+    }
+
     if (!session->dt[session->ds].edit) {
         /* CONTEXT LOCK */
         if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
@@ -3162,6 +4403,11 @@ sr_delete_item(sr_session_ctx_t *session, const char *path, const sr_edit_option
 
     SR_CHECK_ARG_APIRET(!session || !path || !SR_IS_STANDARD_DS(session->ds), session, err_info);
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(session->conn, path, NULL))) {
+        goto cleanup;
+    }
+
     if (!session->dt[session->ds].edit) {
         /* CONTEXT LOCK */
         if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
@@ -3238,6 +4484,11 @@ sr_move_item(sr_session_ctx_t *session, const char *path, const sr_move_position
         }
     }
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(session->conn, path, NULL))) {
+        goto cleanup;
+    }
+
     if (!session->dt[session->ds].edit) {
         /* CONTEXT LOCK */
         if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
@@ -3264,12 +4515,58 @@ cleanup:
     return sr_api_ret(session, err_info);
 }
 
+/**
+ * @brief Prepare a batch edit to be stored in a session, add default operation and origin.
+ *
+ * @param[in] session Session to use.
+ * @param[in] edit Edit to prepare.
+ * @param[in] default_operation Default operation.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_edit_batch_prepare(sr_session_ctx_t *session, struct lyd_node *edit, const char *default_operation)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *root, *elem;
+    enum edit_op op;
+
+    LY_LIST_FOR(edit, root) {
+        if (!sr_edit_diff_find_oper(root, 0, NULL) && (err_info = sr_edit_set_oper(root, default_operation))) {
+            return err_info;
+        }
+        if (session->ds == SR_DS_OPERATIONAL) {
+            if ((err_info = sr_edit_diff_set_origin(root, SR_OPER_ORIGIN, 0))) {
+                return err_info;
+            }
+
+            /* check that no forbidden data/operations are set */
+            LYD_TREE_DFS_BEGIN(root, elem) {
+                if (!elem->schema) {
+                    sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED, "Opaque node \"%s\" is not allowed for operational "
+                            "datastore changes.", LYD_NAME(elem));
+                    return err_info;
+                }
+
+                op = sr_edit_diff_find_oper(elem, 0, NULL);
+                if (op && (op != EDIT_MERGE) && (op != EDIT_REMOVE) && (op != EDIT_PURGE) && (op != EDIT_ETHER)) {
+                    sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED, "Operation \"%s\" is not allowed for operational "
+                            "datastore changes.", sr_edit_op2str(op));
+                    return err_info;
+                }
+
+                LYD_TREE_DFS_END(root, elem);
+            }
+        }
+    }
+
+    return NULL;
+}
+
 API int
 sr_edit_batch(sr_session_ctx_t *session, const struct lyd_node *edit, const char *default_operation)
 {
     sr_error_info_t *err_info = NULL;
-    struct lyd_node *dup_edit = NULL, *root, *elem;
-    enum edit_op op;
+    struct lyd_node *dup_edit = NULL;
 
     SR_CHECK_ARG_APIRET(!session || !edit || !default_operation || !SR_IS_STANDARD_DS(session->ds), session, err_info);
     SR_CHECK_ARG_APIRET(strcmp(default_operation, "merge") && strcmp(default_operation, "replace") &&
@@ -3297,33 +4594,8 @@ sr_edit_batch(sr_session_ctx_t *session, const struct lyd_node *edit, const char
     }
 
     /* add default operation and default origin */
-    LY_LIST_FOR(dup_edit, root) {
-        if (!sr_edit_diff_find_oper(root, 0, NULL) && (err_info = sr_edit_set_oper(root, default_operation))) {
-            goto cleanup_unlock;
-        }
-        if (session->ds == SR_DS_OPERATIONAL) {
-            if ((err_info = sr_edit_diff_set_origin(root, SR_OPER_ORIGIN, 0))) {
-                goto cleanup_unlock;
-            }
-
-            /* check that no forbidden data/operations are set */
-            LYD_TREE_DFS_BEGIN(root, elem) {
-                if (!elem->schema) {
-                    sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED, "Opaque node \"%s\" is not allowed for operational "
-                            "datastore changes.", LYD_NAME(elem));
-                    goto cleanup_unlock;
-                }
-
-                op = sr_edit_diff_find_oper(elem, 0, NULL);
-                if (op && (op != EDIT_MERGE) && (op != EDIT_REMOVE) && (op != EDIT_PURGE) && (op != EDIT_ETHER)) {
-                    sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED, "Operation \"%s\" is not allowed for operational "
-                            "datastore changes.", sr_edit_op2str(op));
-                    goto cleanup_unlock;
-                }
-
-                LYD_TREE_DFS_END(root, elem);
-            }
-        }
+    if ((err_info = sr_edit_batch_prepare(session, dup_edit, default_operation))) {
+        goto cleanup_unlock;
     }
 
     /* store edit in the session, keep context lock */
@@ -3342,6 +4614,165 @@ cleanup:
     return sr_api_ret(session, err_info);
 }
 
+API int
+sr_edit_builder_new(sr_session_ctx_t *session, sr_edit_builder_t **builder)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!session || !SR_IS_STANDARD_DS(session->ds) || !builder, session, err_info);
+
+    *builder = calloc(1, sizeof **builder);
+    SR_CHECK_MEM_GOTO(!*builder, err_info, cleanup);
+    (*builder)->session = session;
+
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
+        goto cleanup;
+    }
+
+    /* prepare the edit with context lock */
+    if ((err_info = _sr_acquire_data(session->conn, NULL, &(*builder)->edit))) {
+        goto cleanup;
+    }
+
+cleanup:
+    if (err_info) {
+        free(*builder);
+        *builder = NULL;
+    }
+    return sr_api_ret(session, err_info);
+}
+
+API int
+sr_edit_builder_set_parent(sr_edit_builder_t *builder, const char *path)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *new_parent = NULL, *node = NULL;
+    sr_conn_ctx_t *conn;
+
+    SR_CHECK_ARG_APIRET(!builder, NULL, err_info);
+
+    conn = builder->session->conn;
+    builder->parent = NULL;
+    if (!path) {
+        /* top-level nodes */
+        goto cleanup;
+    }
+
+    /* use an existing node */
+    if (builder->edit->tree && !lyd_find_path(builder->edit->tree, path, 0, &node)) {
+        builder->parent = node;
+        goto cleanup;
+    }
+
+    /* create it */
+    if (lyd_new_path2(builder->edit->tree, conn->ly_ctx, path, NULL, 0, LYD_ANYDATA_STRING, 0, &new_parent, &node)) {
+        sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
+        goto cleanup;
+    }
+    builder->edit->tree = lyd_first_sibling(builder->edit->tree ? builder->edit->tree : new_parent);
+    builder->parent = node;
+
+cleanup:
+    return sr_api_ret(builder->session, err_info);
+}
+
+API int
+sr_edit_builder_add(sr_edit_builder_t *builder, const char *path, const char *value)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *new_parent = NULL, *node = NULL, *iter;
+    sr_conn_ctx_t *conn;
+    LY_ERR lyrc;
+
+    SR_CHECK_ARG_APIRET(!builder || !path, NULL, err_info);
+
+    conn = builder->session->conn;
+
+    /* create the node, no checks of previous operations needed */
+    lyrc = lyd_new_path2(builder->parent ? builder->parent : builder->edit->tree, conn->ly_ctx, path, (void *)value,
+            value ? strlen(value) : 0, LYD_ANYDATA_STRING, LYD_NEW_PATH_UPDATE, &new_parent, &node);
+    if (lyrc == LY_EEXIST) {
+        /* already in the edit */
+        goto cleanup;
+    } else if (lyrc) {
+        sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
+        goto cleanup;
+    }
+    if (!new_parent) {
+        /* only a value was updated */
+        goto cleanup;
+    }
+    if (!builder->edit->tree) {
+        builder->edit->tree = new_parent;
+    }
+    builder->edit->tree = lyd_first_sibling(builder->edit->tree);
+
+    /* check the created nodes */
+    for (iter = node; iter != lyd_parent(new_parent); iter = lyd_parent(iter)) {
+        if (iter->schema && (iter->schema->nodetype & (LYS_RPC | LYS_ACTION | LYS_NOTIF))) {
+            sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "RPC/action/notification node \"%s\" cannot be created.",
+                    iter->schema->name);
+            sr_lyd_free_tree_safe(new_parent, &builder->edit->tree);
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    return sr_api_ret(builder->session, err_info);
+}
+
+API int
+sr_edit_builder_apply(sr_edit_builder_t *builder, const char *default_operation)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_session_ctx_t *session;
+
+    SR_CHECK_ARG_APIRET(!builder, NULL, err_info);
+
+    session = builder->session;
+    if (!default_operation || (strcmp(default_operation, "merge") && strcmp(default_operation, "replace") &&
+            strcmp(default_operation, "none"))) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Invalid default operation.");
+        goto cleanup;
+    }
+
+    if (session->dt[session->ds].edit) {
+        /* do not allow merging NETCONF edits into sysrepo ones, it can cause some unexpected results */
+        sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED, "There are already some session changes.");
+        goto cleanup;
+    }
+
+    if (!builder->edit->tree) {
+        /* empty edit */
+        goto cleanup;
+    }
+
+    /* add default operation and default origin */
+    if ((err_info = sr_edit_batch_prepare(session, builder->edit->tree, default_operation))) {
+        goto cleanup;
+    }
+
+    /* store edit in the session, it keeps the context lock */
+    session->dt[session->ds].edit = builder->edit;
+    builder->edit = NULL;
+
+cleanup:
+    sr_edit_builder_free(builder);
+    return sr_api_ret(session, err_info);
+}
+
+API void
+sr_edit_builder_free(sr_edit_builder_t *builder)
+{
+    if (!builder) {
+        return;
+    }
+
+    sr_release_data(builder->edit);
+    free(builder);
+}
+
 API int
 sr_validate(sr_session_ctx_t *session, const char *module_name, uint32_t timeout_ms)
 {
@@ -3355,8 +4786,14 @@ sr_validate(sr_session_ctx_t *session, const char *module_name, uint32_t timeout
     if (!timeout_ms) {
         timeout_ms = SR_OPER_CB_TIMEOUT;
     }
-    /* for operational, use operational and running datastore */
-    SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds == SR_DS_OPERATIONAL ? SR_DS_RUNNING : session->ds);
+    /* for operational, use operational and running datastore */
+    SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds == SR_DS_OPERATIONAL ? SR_DS_RUNNING : session->ds);
+
+    /* load the modules into a lazy context, all the modules with changes in the edit are loaded */
+    if (((session->ds == SR_DS_CANDIDATE) || (session->ds == SR_DS_OPERATIONAL)) &&
+            (err_info = sr_lycc_lazy_load(session->conn, NULL, module_name))) {
+        return sr_api_ret(session, err_info);
+    }
 
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
@@ -3435,7 +4872,7 @@ sr_validate(sr_session_ctx_t *session, const char *module_name, uint32_t timeout
 
     /* collect dependencies for validation and add those to mod_info as well (after we have the final data that will
      * be validated) */
-    if ((err_info = sr_modinfo_collect_deps(&mod_info))) {
+    if ((err_info = sr_modinfo_collect_deps(&mod_info, 1))) {
         goto cleanup;
     }
     if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_NEW_DEPS | SR_MI_PERM_NO, session->sid,
@@ -3492,6 +4929,7 @@ sr_changes_notify_store(struct sr_mod_info_s *mod_info, sr_session_ctx_t *sessio
     sr_error_info_t *err_info = NULL;
     const struct lyd_node *denied_node;
     sr_lock_mode_t change_sub_lock = SR_LOCK_NONE;
+    struct timespec start;
     uint32_t sid = 0;
     char *orig_name = NULL;
     void *orig_data = NULL;
@@ -3530,7 +4968,7 @@ sr_changes_notify_store(struct sr_mod_info_s *mod_info, sr_session_ctx_t *sessio
     case SR_DS_STARTUP:
     case SR_DS_RUNNING:
         /* collect validation dependencies and add those to mod_info as well */
-        if ((err_info = sr_modinfo_collect_deps(mod_info))) {
+        if ((err_info = sr_modinfo_collect_deps(mod_info, 1))) {
             goto cleanup;
         }
         if ((err_info = sr_modinfo_consolidate(mod_info, 0, SR_LOCK_READ, SR_MI_NEW_DEPS | SR_MI_PERM_NO, sid,
@@ -3577,110 +5015,528 @@ sr_changes_notify_store(struct sr_mod_info_s *mod_info, sr_session_ctx_t *sessio
     change_sub_lock = SR_LOCK_READ;
 
     /* first publish "update" event for the diff to be updated */
+    sr_timeouttime_get(&start, 0);
     if ((err_info = sr_modinfo_change_notify_update(mod_info, session, timeout_ms, &change_sub_lock, cb_err_info)) ||
             *cb_err_info) {
         goto cleanup;
     }
+    sr_modinfo_commit_stats_add(mod_info, NULL, SR_COMMIT_PHASE_UPDATE, &start);
 
     if (!mod_info->diff) {
         SR_LOG_INF("No datastore changes to apply.");
         goto store;
     }
 
-    /* publish final diff in a "change" event for any subscribers and wait for them */
-    if ((err_info = sr_shmsub_change_notify_change(mod_info, orig_name, orig_data, timeout_ms, cb_err_info))) {
-        goto cleanup;
-    }
-    if (*cb_err_info) {
-        /* "change" event failed, publish "abort" event and finish */
-        err_info = sr_shmsub_change_notify_change_abort(mod_info, orig_name, orig_data, timeout_ms);
-        goto cleanup;
-    }
+    /* publish final diff in a "change" event for any subscribers and wait for them */
+    sr_timeouttime_get(&start, 0);
+    if ((err_info = sr_shmsub_change_notify_change(mod_info, orig_name, orig_data, timeout_ms, cb_err_info))) {
+        goto cleanup;
+    }
+    sr_modinfo_commit_stats_add(mod_info, NULL, SR_COMMIT_PHASE_CHANGE, &start);
+    if (*cb_err_info) {
+        /* "change" event failed, publish "abort" event and finish */
+        err_info = sr_shmsub_change_notify_change_abort(mod_info, orig_name, orig_data, timeout_ms);
+        goto cleanup;
+    }
+
+store:
+    if (!mod_info->diff && !sr_modinfo_is_changed(mod_info)) {
+        /* there is no diff and no changed modules, nothing to store */
+        goto cleanup;
+    }
+
+    /* MODULES WRITE LOCK (upgrade) */
+    if ((err_info = sr_shmmod_modinfo_rdlock_upgrade(mod_info, sid, timeout_ms, timeout_ms))) {
+        goto cleanup;
+    }
+
+    /* store updated datastore */
+    if ((err_info = sr_modinfo_data_store(mod_info))) {
+        goto cleanup;
+    }
+
+    /* MODULES READ LOCK (downgrade) */
+    if ((err_info = sr_shmmod_modinfo_wrlock_downgrade(mod_info, sid, timeout_ms))) {
+        goto cleanup;
+    }
+
+    /* publish "done" event, all changes were applied */
+    sr_timeouttime_get(&start, 0);
+    if ((err_info = sr_shmsub_change_notify_change_done(mod_info, orig_name, orig_data, timeout_ms))) {
+        goto cleanup;
+    }
+    sr_modinfo_commit_stats_add(mod_info, NULL, SR_COMMIT_PHASE_DONE, &start);
+
+    /* generate netconf-config-change notification */
+    if (session && (err_info = sr_modinfo_generate_config_change_notif(mod_info, session))) {
+        goto cleanup;
+    }
+
+cleanup:
+    if (change_sub_lock) {
+        assert(change_sub_lock == SR_LOCK_READ);
+
+        /* CHANGE SUB READ UNLOCK */
+        sr_modinfo_changesub_rdunlock(mod_info);
+    }
+    return err_info;
+}
+
+/**
+ * @brief Apply edits of a session in a single commit.
+ *
+ * @param[in] session Session of the edits.
+ * @param[in] ds Datastore of the edits.
+ * @param[in] edits Edits to apply, in the order they were created.
+ * @param[in] edit_count Count of @p edits.
+ * @param[in] timeout_ms Change callback timeout in milliseconds.
+ * @param[out] cb_err_info Callback error info, if any.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+_sr_apply_changes(sr_session_ctx_t *session, sr_datastore_t ds, sr_data_t **edits, uint32_t edit_count,
+        uint32_t timeout_ms, sr_error_info_t **cb_err_info)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_mod_info_s mod_info;
+    uint32_t i;
+    int mod_deps;
+
+    /* even for operational datastore, we do not need any running data */
+    SR_MODINFO_INIT(mod_info, session->conn, ds, ds);
+    mod_info.commit_prio = session->commit_prio;
+
+    if ((ds == SR_DS_OPERATIONAL) || (ds == SR_DS_CANDIDATE)) {
+        /* stored oper edit or candidate data are not validated so we do not need data from other modules */
+        mod_deps = 0;
+    } else {
+        mod_deps = MOD_INFO_INV_DEP;
+    }
+
+    /* collect all required modules */
+    for (i = 0; i < edit_count; ++i) {
+        if ((err_info = sr_modinfo_collect_edit(edits[i]->tree, &mod_info))) {
+            goto cleanup;
+        }
+    }
+
+    /* add modules into mod_info with deps, locking, and their data, inverse dependencies are loaded only if
+     * the changes can affect them */
+    if ((err_info = sr_modinfo_consolidate(&mod_info, mod_deps, SR_LOCK_READ,
+            SR_MI_LOCK_UPGRADEABLE | SR_MI_DATA_INV_DEP_LAZY | SR_MI_PERM_NO, session->sid, session->orig_name,
+            session->orig_data, 0, 0, 0))) {
+        goto cleanup;
+    }
+
+    /* create diff, the edits are applied one after another and their diffs merged */
+    for (i = 0; i < edit_count; ++i) {
+        if ((err_info = sr_modinfo_edit_apply(&mod_info, edits[i]->tree, 1))) {
+            goto cleanup;
+        }
+    }
+
+    /* notify all the subscribers and store the changes */
+    err_info = sr_changes_notify_store(&mod_info, session, timeout_ms, cb_err_info);
+
+cleanup:
+    /* MODULES UNLOCK */
+    sr_shmmod_modinfo_unlock(&mod_info);
+    sr_modinfo_erase(&mod_info);
+    return err_info;
+}
+
+API int
+sr_apply_changes(sr_session_ctx_t *session, uint32_t timeout_ms)
+{
+    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!session || !SR_IS_STANDARD_DS(session->ds), session, err_info);
+
+    if (!session->dt[session->ds].edit) {
+        return sr_api_ret(session, NULL);
+    }
+
+    if (!timeout_ms) {
+        timeout_ms = SR_CHANGE_CB_TIMEOUT;
+    }
+
+    err_info = _sr_apply_changes(session, session->ds, &session->dt[session->ds].edit, 1, timeout_ms, &cb_err_info);
+
+    if (!err_info && !cb_err_info) {
+        /* free applied edit */
+        sr_release_data(session->dt[session->ds].edit);
+        session->dt[session->ds].edit = NULL;
+    }
+    if (cb_err_info) {
+        /* return callback error if some was generated */
+        sr_errinfo_merge(&err_info, cb_err_info);
+        sr_errinfo_new(&err_info, SR_ERR_CALLBACK_FAILED, "User callback failed.");
+    }
+    return sr_api_ret(session, err_info);
+}
+
+/**
+ * @brief Commit all the edits buffered in a session commit buffer.
+ *
+ * Commit buffer MUTEX must be held and is temporarily released.
+ *
+ * @param[in] session Session with the buffered edits.
+ */
+static void
+sr_session_commit_buf_commit(sr_session_ctx_t *session)
+{
+    struct sr_sess_commit_buf *commit_buf = &session->commit_buf;
+    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
+    sr_data_t **edits;
+    sr_datastore_t ds;
+    uint32_t i, edit_count, timeout_ms;
+    sr_commit_cb cb;
+    void *cb_data;
+
+    /* take the buffered edits */
+    edits = commit_buf->edits;
+    edit_count = commit_buf->edit_count;
+    ds = commit_buf->ds;
+    timeout_ms = commit_buf->timeout_ms;
+    cb = commit_buf->cb;
+    cb_data = commit_buf->cb_data;
+    commit_buf->edits = NULL;
+    commit_buf->edit_count = 0;
+    commit_buf->committing = 1;
+
+    /* MUTEX UNLOCK */
+    pthread_mutex_unlock(&commit_buf->lock);
+
+    /* commit them all at once */
+    err_info = _sr_apply_changes(session, ds, edits, edit_count, timeout_ms, &cb_err_info);
+    if (cb_err_info) {
+        sr_errinfo_merge(&err_info, cb_err_info);
+        sr_errinfo_new(&err_info, SR_ERR_CALLBACK_FAILED, "User callback failed.");
+    }
+
+    for (i = 0; i < edit_count; ++i) {
+        sr_release_data(edits[i]);
+    }
+    free(edits);
+
+    if (cb) {
+        /* report the result */
+        cb(session, err_info, cb_data);
+        sr_errinfo_free(&err_info);
+    }
+
+    /* MUTEX LOCK, cannot fail with no timeout, the commit must be marked finished */
+    pthread_mutex_lock(&commit_buf->lock);
+
+    /* remember the error for the waiters, if not reported */
+    sr_errinfo_merge(&commit_buf->err_info, err_info);
+    commit_buf->committing = 0;
+
+    /* wake up all the waiters */
+    sr_cond_broadcast(&commit_buf->cond);
+}
+
+/**
+ * @brief Session commit buffer thread, commits the buffered edits once their coalescing window elapses.
+ *
+ * @param[in] arg Session of the commit buffer.
+ * @return NULL.
+ */
+static void *
+sr_session_commit_buf_thread(void *arg)
+{
+    sr_session_ctx_t *session = arg;
+    struct sr_sess_commit_buf *commit_buf = &session->commit_buf;
+    int r;
+
+    /* MUTEX LOCK */
+    pthread_mutex_lock(&commit_buf->lock);
+
+    while (commit_buf->thread_running || commit_buf->edit_count) {
+        if (!commit_buf->edit_count) {
+            /* COND WAIT */
+            sr_cond_wait(&commit_buf->cond, &commit_buf->lock);
+            continue;
+        }
+
+        if (commit_buf->thread_running) {
+            /* wait for the coalescing window to elapse, new edits may be added meanwhile */
+            r = sr_cond_clockwait(&commit_buf->cond, &commit_buf->lock, COMPAT_CLOCK_ID, &commit_buf->commit_ts);
+            if (!r) {
+                /* new edits were added, the window was shortened, or the thread is being stopped */
+                continue;
+            }
+        }
+
+        /* commit the buffered edits */
+        sr_session_commit_buf_commit(session);
+    }
+
+    /* MUTEX UNLOCK */
+    pthread_mutex_unlock(&commit_buf->lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Stop session commit buffer thread, any buffered edits are committed.
+ *
+ * @param[in] session Session whose commit buffer to stop.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_session_commit_buf_stop(sr_session_ctx_t *session)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_sess_commit_buf *commit_buf = &session->commit_buf;
+    int r;
+
+    if (!commit_buf->tid) {
+        return NULL;
+    }
+
+    /* MUTEX LOCK */
+    pthread_mutex_lock(&commit_buf->lock);
+
+    /* signal the thread to terminate */
+    commit_buf->thread_running = 0;
+
+    /* wake up the thread */
+    sr_cond_broadcast(&commit_buf->cond);
+
+    /* MUTEX UNLOCK */
+    pthread_mutex_unlock(&commit_buf->lock);
+
+    /* join the thread, it will commit all the buffered edits */
+    if ((r = pthread_join(commit_buf->tid, NULL))) {
+        sr_errinfo_new(&err_info, SR_ERR_SYS, "Joining the commit buffer thread failed (%s).", strerror(r));
+        return err_info;
+    }
+    commit_buf->tid = 0;
+    assert(!commit_buf->edit_count);
+
+    if (commit_buf->err_info) {
+        /* nobody is left to learn about the error */
+        SR_LOG_WRN("Session %" PRIu32 " coalesced commit failed (%s).", session->sid, commit_buf->err_info->err[0].message);
+        sr_errinfo_free(&commit_buf->err_info);
+    }
+
+    return NULL;
+}
+
+API int
+sr_apply_changes_async(sr_session_ctx_t *session, uint32_t coalesce_ms, uint32_t timeout_ms)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_sess_commit_buf *commit_buf;
+    struct timespec timeout_ts;
+    void *mem;
+    int r;
+
+    SR_CHECK_ARG_APIRET(!session || !SR_IS_STANDARD_DS(session->ds), session, err_info);
+
+    commit_buf = &session->commit_buf;
+    if (!session->dt[session->ds].edit) {
+        return sr_api_ret(session, NULL);
+    }
+
+    if (!timeout_ms) {
+        timeout_ms = SR_CHANGE_CB_TIMEOUT;
+    }
+
+    sr_timeouttime_get(&timeout_ts, SR_COMMIT_BUF_LOCK_TIMEOUT);
+
+    /* MUTEX LOCK */
+    if ((r = pthread_mutex_clocklock(&commit_buf->lock, COMPAT_CLOCK_ID, &timeout_ts))) {
+        SR_ERRINFO_LOCK(&err_info, __func__, r);
+        return sr_api_ret(session, err_info);
+    }
+
+    /* edits of a different datastore cannot be coalesced, wait for the current ones to be committed */
+    while (!r && commit_buf->edit_count && (commit_buf->ds != session->ds)) {
+        /* hurry up the commit */
+        sr_timeouttime_get(&commit_buf->commit_ts, 0);
+        sr_cond_broadcast(&commit_buf->cond);
+
+        /* COND WAIT */
+        r = sr_cond_wait(&commit_buf->cond, &commit_buf->lock);
+    }
+    if (r) {
+        SR_ERRINFO_COND(&err_info, __func__, r);
+        goto cleanup_unlock;
+    }
+
+    if (!commit_buf->tid) {
+        /* start the coalescing thread */
+        commit_buf->thread_running = 1;
+        if ((r = pthread_create(&commit_buf->tid, NULL, sr_session_commit_buf_thread, session))) {
+            sr_errinfo_new(&err_info, SR_ERR_SYS, "Creating a new thread failed (%s).", strerror(r));
+            commit_buf->thread_running = 0;
+            commit_buf->tid = 0;
+            goto cleanup_unlock;
+        }
+    }
+
+    /* buffer the edit */
+    mem = realloc(commit_buf->edits, (commit_buf->edit_count + 1) * sizeof *commit_buf->edits);
+    SR_CHECK_MEM_GOTO(!mem, err_info, cleanup_unlock);
+    commit_buf->edits = mem;
+    commit_buf->edits[commit_buf->edit_count] = session->dt[session->ds].edit;
+    session->dt[session->ds].edit = NULL;
+
+    if (!commit_buf->edit_count) {
+        /* first edit of the window */
+        commit_buf->ds = session->ds;
+        commit_buf->timeout_ms = timeout_ms;
+        sr_timeouttime_get(&commit_buf->commit_ts, coalesce_ms);
+    } else if (timeout_ms > commit_buf->timeout_ms) {
+        /* use the longest timeout of all the coalesced edits */
+        commit_buf->timeout_ms = timeout_ms;
+    }
+    ++commit_buf->edit_count;
+
+    /* wake up the thread */
+    sr_cond_broadcast(&commit_buf->cond);
+
+cleanup_unlock:
+    /* MUTEX UNLOCK */
+    pthread_mutex_unlock(&commit_buf->lock);
+
+    return sr_api_ret(session, err_info);
+}
+
+API int
+sr_session_set_commit_cb(sr_session_ctx_t *session, sr_commit_cb callback, void *private_data)
+{
+    sr_error_info_t *err_info = NULL;
+    struct timespec timeout_ts;
+    int r;
+
+    SR_CHECK_ARG_APIRET(!session, session, err_info);
+
+    sr_timeouttime_get(&timeout_ts, SR_COMMIT_BUF_LOCK_TIMEOUT);
+
+    /* MUTEX LOCK */
+    if ((r = pthread_mutex_clocklock(&session->commit_buf.lock, COMPAT_CLOCK_ID, &timeout_ts))) {
+        SR_ERRINFO_LOCK(&err_info, __func__, r);
+        return sr_api_ret(session, err_info);
+    }
+
+    session->commit_buf.cb = callback;
+    session->commit_buf.cb_data = private_data;
 
-store:
-    if (!mod_info->diff && !sr_modinfo_is_changed(mod_info)) {
-        /* there is no diff and no changed modules, nothing to store */
-        goto cleanup;
-    }
+    /* MUTEX UNLOCK */
+    pthread_mutex_unlock(&session->commit_buf.lock);
 
-    /* MODULES WRITE LOCK (upgrade) */
-    if ((err_info = sr_shmmod_modinfo_rdlock_upgrade(mod_info, sid, timeout_ms, timeout_ms))) {
-        goto cleanup;
-    }
+    return sr_api_ret(session, NULL);
+}
 
-    /* store updated datastore */
-    if ((err_info = sr_modinfo_data_store(mod_info))) {
-        goto cleanup;
+API int
+sr_apply_changes_wait(sr_session_ctx_t *session)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_sess_commit_buf *commit_buf;
+    struct timespec timeout_ts;
+    int r;
+
+    SR_CHECK_ARG_APIRET(!session, session, err_info);
+
+    commit_buf = &session->commit_buf;
+    if (!commit_buf->tid) {
+        return sr_api_ret(session, NULL);
     }
 
-    /* MODULES READ LOCK (downgrade) */
-    if ((err_info = sr_shmmod_modinfo_wrlock_downgrade(mod_info, sid, timeout_ms))) {
-        goto cleanup;
+    sr_timeouttime_get(&timeout_ts, SR_COMMIT_BUF_LOCK_TIMEOUT);
+
+    /* MUTEX LOCK */
+    if ((r = pthread_mutex_clocklock(&commit_buf->lock, COMPAT_CLOCK_ID, &timeout_ts))) {
+        SR_ERRINFO_LOCK(&err_info, __func__, r);
+        return sr_api_ret(session, err_info);
     }
 
-    /* publish "done" event, all changes were applied */
-    if ((err_info = sr_shmsub_change_notify_change_done(mod_info, orig_name, orig_data, timeout_ms))) {
-        goto cleanup;
+    /* commit the buffered edits right away */
+    if (commit_buf->edit_count) {
+        sr_timeouttime_get(&commit_buf->commit_ts, 0);
+        sr_cond_broadcast(&commit_buf->cond);
     }
 
-    /* generate netconf-config-change notification */
-    if (session && (err_info = sr_modinfo_generate_config_change_notif(mod_info, session))) {
-        goto cleanup;
+    /* wait for all the commits to finish */
+    while (!r && (commit_buf->edit_count || commit_buf->committing)) {
+        /* COND WAIT */
+        r = sr_cond_wait(&commit_buf->cond, &commit_buf->lock);
+    }
+    if (r) {
+        SR_ERRINFO_COND(&err_info, __func__, r);
+    } else {
+        /* return the commit errors */
+        err_info = commit_buf->err_info;
+        commit_buf->err_info = NULL;
     }
 
-cleanup:
-    if (change_sub_lock) {
-        assert(change_sub_lock == SR_LOCK_READ);
+    /* MUTEX UNLOCK */
+    pthread_mutex_unlock(&commit_buf->lock);
 
-        /* CHANGE SUB READ UNLOCK */
-        sr_modinfo_changesub_rdunlock(mod_info);
-    }
-    return err_info;
+    return sr_api_ret(session, err_info);
 }
 
 API int
-sr_apply_changes(sr_session_ctx_t *session, uint32_t timeout_ms)
+sr_oper_push_delta(sr_session_ctx_t *session, const char **paths, const char **values, uint32_t count,
+        uint32_t timeout_ms)
 {
     sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
     struct sr_mod_info_s mod_info;
-    int mod_deps;
-
-    SR_CHECK_ARG_APIRET(!session || !SR_IS_STANDARD_DS(session->ds), session, err_info);
+    struct sr_mod_info_mod_s *mod;
+    struct lyd_node *node;
+    uint32_t i;
+    int change;
 
-    if (!session->dt[session->ds].edit) {
-        return sr_api_ret(session, NULL);
-    }
+    SR_CHECK_ARG_APIRET(!session || (session->ds != SR_DS_OPERATIONAL) || !paths || !values || !count, session,
+            err_info);
 
     if (!timeout_ms) {
         timeout_ms = SR_CHANGE_CB_TIMEOUT;
     }
-    /* even for operational datastore, we do not need any running data */
-    SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds);
+    SR_MODINFO_INIT(mod_info, session->conn, SR_DS_OPERATIONAL, SR_DS_OPERATIONAL);
+    mod_info.commit_prio = session->commit_prio;
 
-    if ((session->ds == SR_DS_OPERATIONAL) || (session->ds == SR_DS_CANDIDATE)) {
-        /* stored oper edit or candidate data are not validated so we do not need data from other modules */
-        mod_deps = 0;
-    } else {
-        mod_deps = MOD_INFO_INV_DEP;
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
+        return sr_api_ret(session, err_info);
     }
 
     /* collect all required modules */
-    if ((err_info = sr_modinfo_collect_edit(session->dt[session->ds].edit->tree, &mod_info))) {
-        goto cleanup;
+    for (i = 0; i < count; ++i) {
+        if ((err_info = sr_modinfo_collect_xpath(session->conn->ly_ctx, paths[i], SR_DS_OPERATIONAL, 0, 0, &mod_info))) {
+            goto cleanup;
+        }
     }
 
-    /* add modules into mod_info with deps, locking, and their data */
-    if ((err_info = sr_modinfo_consolidate(&mod_info, mod_deps, SR_LOCK_READ, SR_MI_LOCK_UPGRADEABLE | SR_MI_PERM_NO,
+    /* add modules, lock, and get the stored edits */
+    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_LOCK_UPGRADEABLE | SR_MI_PERM_NO,
             session->sid, session->orig_name, session->orig_data, 0, 0, 0))) {
         goto cleanup;
     }
 
-    /* create diff */
-    if ((err_info = sr_modinfo_edit_apply(&mod_info, session->dt[session->ds].edit->tree, 1))) {
-        goto cleanup;
+    /* update all the values in place, creating a single diff */
+    for (i = 0; i < count; ++i) {
+        if ((err_info = sr_edit_oper_value_update(mod_info.data, session->conn->cid, paths[i], values[i],
+                &mod_info.diff, &change))) {
+            goto cleanup;
+        }
     }
 
-    /* notify all the subscribers and store the changes */
+    /* set changed flags */
+    for (i = 0; i < mod_info.mod_count; ++i) {
+        mod = &mod_info.mods[i];
+        LY_LIST_FOR(mod_info.diff, node) {
+            if (lyd_owner_module(node) == mod->ly_mod) {
+                mod->state |= MOD_INFO_CHANGED;
+                break;
+            }
+        }
+    }
+
+    /* notify all the subscribers and store the changes, once for all the values */
     err_info = sr_changes_notify_store(&mod_info, session, timeout_ms, &cb_err_info);
 
 cleanup:
@@ -3688,11 +5544,9 @@ cleanup:
     sr_shmmod_modinfo_unlock(&mod_info);
     sr_modinfo_erase(&mod_info);
 
-    if (!err_info && !cb_err_info) {
-        /* free applied edit */
-        sr_release_data(session->dt[session->ds].edit);
-        session->dt[session->ds].edit = NULL;
-    }
+    /* CONTEXT UNLOCK */
+    sr_lycc_unlock(session->conn, SR_LOCK_READ, 0, __func__);
+
     if (cb_err_info) {
         /* return callback error if some was generated */
         sr_errinfo_merge(&err_info, cb_err_info);
@@ -3761,6 +5615,7 @@ _sr_replace_config(sr_session_ctx_t *session, const struct lys_module *ly_mod, s
     assert(!*src_config || !(*src_config)->prev->next);
     assert(session->ds != SR_DS_OPERATIONAL);
     SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds);
+    mod_info.commit_prio = session->commit_prio;
 
     /* single module/all modules */
     if (ly_mod) {
@@ -3808,6 +5663,11 @@ sr_replace_config(sr_session_ctx_t *session, const char *module_name, struct lyd
 
     SR_CHECK_ARG_APIRET(!session || !SR_IS_CONVENTIONAL_DS(session->ds), session, err_info);
 
+    /* load the modules into a lazy context, any data tree already uses the modules so the context is kept */
+    if (!src_config && (err_info = sr_lycc_lazy_load(session->conn, NULL, module_name))) {
+        return sr_api_ret(session, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(session, err_info);
@@ -3850,12 +5710,48 @@ cleanup:
     return sr_api_ret(session, err_info);
 }
 
+/**
+ * @brief Learn whether candidate data of any required module in mod info were modified.
+ *
+ * @param[in] mod_info Mod info with the modules.
+ * @param[out] modified Whether candidate data of at least one module were modified.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_copy_config_candidate_modified(struct sr_mod_info_s *mod_info, int *modified)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_mod_info_mod_s *mod;
+    uint32_t i;
+    int rc;
+
+    *modified = 0;
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        mod = &mod_info->mods[i];
+        if (!(mod->state & MOD_INFO_REQ)) {
+            continue;
+        }
+
+        if ((rc = mod->ds_plg[SR_DS_CANDIDATE]->candidate_modified_cb(mod->ly_mod, modified))) {
+            SR_ERRINFO_DSPLUGIN(&err_info, rc, "candidate_modified", mod->ds_plg[SR_DS_CANDIDATE]->name,
+                    mod->ly_mod->name);
+            return err_info;
+        }
+        if (*modified) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
 API int
 sr_copy_config(sr_session_ctx_t *session, const char *module_name, sr_datastore_t src_datastore, uint32_t timeout_ms)
 {
     sr_error_info_t *err_info = NULL;
     struct sr_mod_info_s mod_info;
     const struct lys_module *ly_mod = NULL;
+    int modified;
 
     SR_CHECK_ARG_APIRET(!session || !SR_IS_CONVENTIONAL_DS(src_datastore) || !SR_IS_CONVENTIONAL_DS(session->ds),
             session, err_info);
@@ -3875,6 +5771,11 @@ sr_copy_config(sr_session_ctx_t *session, const char *module_name, sr_datastore_
         SR_MODINFO_INIT(mod_info, session->conn, src_datastore, src_datastore);
     }
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(session->conn, NULL, module_name))) {
+        return sr_api_ret(session, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(session, err_info);
@@ -3915,9 +5816,24 @@ sr_copy_config(sr_session_ctx_t *session, const char *module_name, sr_datastore_
         goto cleanup;
     }
 
-    /* add modules into mod_info */
-    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_PERM_NO, session->sid, session->orig_name,
-            session->orig_data, 0, 0, 0))) {
+    /* add modules into mod_info, load their data only once it is known they are needed */
+    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_DATA_NO | SR_MI_PERM_NO, session->sid,
+            session->orig_name, session->orig_data, 0, 0, 0))) {
+        goto cleanup;
+    }
+
+    if (src_datastore == SR_DS_CANDIDATE) {
+        /* unmodified candidate of all the modules is just running, nothing would change */
+        if ((err_info = sr_copy_config_candidate_modified(&mod_info, &modified))) {
+            goto cleanup;
+        }
+        if (!modified && (session->ds == SR_DS_RUNNING)) {
+            goto cleanup;
+        }
+    }
+
+    /* load the source data */
+    if ((err_info = sr_modinfo_data_load(&mod_info, 0, session->orig_name, session->orig_data, 0, 0))) {
         goto cleanup;
     }
 
@@ -4012,6 +5928,9 @@ sr_change_dslock(struct sr_mod_info_s *mod_info, uint32_t sid, int lock)
         } else {
             shm_lock->ds_lock_sid = 0;
             memset(&shm_lock->ds_lock_ts, 0, sizeof shm_lock->ds_lock_ts);
+
+            /* wake up any waiters */
+            sr_cond_broadcast(&shm_lock->ds_lock_cond);
         }
 
         /* DS UNLOCK */
@@ -4040,6 +5959,7 @@ error:
             if (lock) {
                 shm_lock->ds_lock_sid = 0;
                 memset(&shm_lock->ds_lock_ts, 0, sizeof shm_lock->ds_lock_ts);
+                sr_cond_broadcast(&shm_lock->ds_lock_cond);
             } else {
                 shm_lock->ds_lock_sid = sid;
                 sr_realtime_get(&shm_lock->ds_lock_ts);
@@ -4073,6 +5993,11 @@ _sr_un_lock(sr_session_ctx_t *session, const char *module_name, int lock, uint32
 
     SR_MODINFO_INIT(mod_info, session->conn, session->ds, session->ds);
 
+    /* load the modules into a lazy context, the unlocked modules were loaded when locking */
+    if (lock && (err_info = sr_lycc_lazy_load(session->conn, NULL, module_name))) {
+        return sr_api_ret(session, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(session, err_info);
@@ -4106,6 +6031,10 @@ _sr_un_lock(sr_session_ctx_t *session, const char *module_name, int lock, uint32
     if ((err_info = sr_change_dslock(&mod_info, session->sid, lock))) {
         goto cleanup;
     }
+    if (lock) {
+        /* all the modules need to be checked when releasing the locks */
+        session->ds_locked = 1;
+    }
 
     /* candidate datastore unlocked, reset its state */
     if (!lock && (mod_info.ds == SR_DS_CANDIDATE)) {
@@ -4159,6 +6088,11 @@ sr_get_lock(sr_conn_ctx_t *conn, sr_datastore_t datastore, const char *module_na
     }
     SR_MODINFO_INIT(mod_info, conn, datastore, datastore);
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(conn, NULL, module_name))) {
+        return sr_api_ret(NULL, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(NULL, err_info);
@@ -4260,8 +6194,9 @@ sr_subscription_process_events(sr_subscription_ctx_t *subscription, sr_session_c
 {
     sr_error_info_t *err_info = NULL;
     int ret, mod_finished;
-    char buf[1];
-    uint32_t i;
+    char buf[64];
+    uint8_t events = 0;
+    uint32_t i, read_count = 0;
     sr_lock_mode_t ctx_mode = SR_LOCK_NONE;
 
     /* session does not have to be set */
@@ -4279,15 +6214,22 @@ sr_subscription_process_events(sr_subscription_ctx_t *subscription, sr_session_c
         return sr_api_ret(session, err_info);
     }
 
-    /* read all bytes from the pipe, there can be several events by now */
-    do {
-        ret = read(subscription->evpipe, buf, 1);
-    } while (ret == 1);
+    /* read all bytes from the pipe, there can be several events by now, and learn their kinds */
+    while ((ret = read(subscription->evpipe, buf, sizeof buf)) > 0) {
+        for (i = 0; i < (unsigned)ret; ++i) {
+            events |= (buf[i] == SR_EVPIPE_EV_ANY) ? SR_EVPIPE_EV_ALL : (uint8_t)buf[i];
+        }
+        read_count += ret;
+    }
     if ((ret == -1) && (errno != EAGAIN)) {
         SR_ERRINFO_SYSERRNO(&err_info, "read");
         sr_errinfo_new(&err_info, SR_ERR_INTERNAL, "Failed to read from an event pipe.");
         goto cleanup_unlock;
     }
+    if (!read_count) {
+        /* not woken up by an event (timeout or called directly), check everything */
+        events = SR_EVPIPE_EV_ALL;
+    }
 
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(subscription->conn, SR_LOCK_READ, 0, __func__))) {
@@ -4295,21 +6237,30 @@ sr_subscription_process_events(sr_subscription_ctx_t *subscription, sr_session_c
     }
     ctx_mode = SR_LOCK_READ;
 
-    /* change subscriptions */
-    for (i = 0; i < subscription->change_sub_count; ++i) {
-        if ((err_info = sr_shmsub_change_listen_process_module_events(&subscription->change_subs[i], subscription->conn))) {
-            goto cleanup_unlock;
+    if (subscription->workers.count) {
+        /* change, operational get, and RPC/action subscriptions processed in parallel by the workers */
+        if (events & (SR_EVPIPE_EV_CHANGE | SR_EVPIPE_EV_OPER_GET | SR_EVPIPE_EV_RPC)) {
+            sr_shmsub_workers_queue_events(subscription, events);
+        }
+    } else {
+        /* change subscriptions */
+        for (i = 0; (events & SR_EVPIPE_EV_CHANGE) && (i < subscription->change_sub_count); ++i) {
+            if ((err_info = sr_shmsub_change_listen_process_module_events(&subscription->change_subs[i],
+                    subscription->conn))) {
+                goto cleanup_unlock;
+            }
         }
-    }
 
-    /* operational get subscriptions */
-    for (i = 0; i < subscription->oper_get_sub_count; ++i) {
-        if ((err_info = sr_shmsub_oper_get_listen_process_module_events(&subscription->oper_get_subs[i], subscription->conn))) {
-            goto cleanup_unlock;
+        /* operational get subscriptions */
+        for (i = 0; (events & SR_EVPIPE_EV_OPER_GET) && (i < subscription->oper_get_sub_count); ++i) {
+            if ((err_info = sr_shmsub_oper_get_listen_process_module_events(&subscription->oper_get_subs[i],
+                    subscription->conn))) {
+                goto cleanup_unlock;
+            }
         }
     }
 
-    /* operational poll subscriptions */
+    /* operational poll subscriptions, always processed because of their refresh timers */
     for (i = 0; i < subscription->oper_poll_sub_count; ++i) {
         if ((err_info = sr_shmsub_oper_poll_listen_process_module_events(&subscription->oper_poll_subs[i],
                 subscription->conn, wake_up_in))) {
@@ -4317,21 +6268,20 @@ sr_subscription_process_events(sr_subscription_ctx_t *subscription, sr_session_c
         }
     }
 
-    /* RPC/action subscriptions */
-    for (i = 0; i < subscription->rpc_sub_count; ++i) {
+    /* RPC/action subscriptions, processed by the workers otherwise */
+    for (i = 0; !subscription->workers.count && (events & SR_EVPIPE_EV_RPC) && (i < subscription->rpc_sub_count); ++i) {
         if ((err_info = sr_shmsub_rpc_listen_process_rpc_events(&subscription->rpc_subs[i], subscription->conn))) {
             goto cleanup_unlock;
         }
     }
 
-    /* notification subscriptions */
+    /* notification subscriptions, perform any replays requested */
+    if ((err_info = sr_shmsub_notif_listen_replay(subscription))) {
+        goto cleanup_unlock;
+    }
+
     i = 0;
     while (i < subscription->notif_sub_count) {
-        /* perform any replays requested */
-        if ((err_info = sr_shmsub_notif_listen_module_replay(&subscription->notif_subs[i], subscription))) {
-            goto cleanup_unlock;
-        }
-
         /* check whether a subscription did not finish */
         mod_finished = 0;
         if ((err_info = sr_shmsub_notif_listen_module_stop_time(i, SR_LOCK_READ, subscription, &mod_finished))) {
@@ -4344,7 +6294,8 @@ sr_subscription_process_events(sr_subscription_ctx_t *subscription, sr_session_c
         }
 
         /* standard event processing */
-        if ((err_info = sr_shmsub_notif_listen_process_module_events(&subscription->notif_subs[i], subscription->conn))) {
+        if ((events & SR_EVPIPE_EV_NOTIF) &&
+                (err_info = sr_shmsub_notif_listen_process_module_events(&subscription->notif_subs[i], subscription->conn))) {
             goto cleanup_unlock;
         }
 
@@ -4643,14 +6594,137 @@ sr_subscription_thread_resume(sr_subscription_ctx_t *subscription)
         return sr_api_ret(NULL, err_info);
     }
 
+    /* make the shared event loop handle the events again */
+    if (subscription->evloop && (err_info = sr_shmsub_evloop_resume(subscription))) {
+        return sr_api_ret(NULL, err_info);
+    }
+
     /* generate a new event for the thread to wake up */
-    if ((err_info = sr_shmsub_notify_evpipe(subscription->evpipe_num))) {
+    if ((err_info = sr_shmsub_notify_evpipe(subscription->evpipe_num, SR_EVPIPE_EV_ANY))) {
+        return sr_api_ret(NULL, err_info);
+    }
+
+    return sr_api_ret(NULL, NULL);
+}
+
+API int
+sr_subscription_set_workers(sr_subscription_ctx_t *subscription, uint32_t worker_count)
+{
+    sr_error_info_t *err_info = NULL;
+    pthread_t *tids = NULL;
+    uint32_t count = 0;
+
+    SR_CHECK_ARG_APIRET(!subscription, NULL, err_info);
+
+    if (sr_shmsub_workers_processing(subscription)) {
+        sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED, "Setting subscription workers from their own callback "
+                "is not supported.");
+        return sr_api_ret(NULL, err_info);
+    }
+
+    /* SUBS WRITE LOCK, no events are being processed */
+    if ((err_info = sr_rwlock(&subscription->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_WRITE, subscription->conn->cid,
+            __func__, NULL, NULL))) {
+        return sr_api_ret(NULL, err_info);
+    }
+
+    if (subscription->workers.count != worker_count) {
+        /* replace the workers, the previous ones quit without processing any more events */
+        sr_shmsub_workers_detach(subscription, &tids, &count);
+        err_info = sr_shmsub_workers_start(subscription, worker_count);
+    }
+
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subscription->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_WRITE, subscription->conn->cid, __func__);
+
+    /* join the previous workers, they may have been waiting for the lock */
+    sr_shmsub_workers_join(tids, count);
+
+    return sr_api_ret(NULL, err_info);
+}
+
+API int
+sr_set_shared_subscription_workers(sr_conn_ctx_t *conn, uint32_t worker_count)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!conn || !worker_count, NULL, err_info);
+
+    /* EVLOOP LOCK */
+    pthread_mutex_lock(&conn->evloop.lock);
+
+    if (conn->evloop.epoll_fd > -1) {
+        sr_errinfo_new(&err_info, SR_ERR_OPERATION_FAILED, "Shared event loop is already running.");
+    } else {
+        conn->evloop.worker_count = worker_count;
+    }
+
+    /* EVLOOP UNLOCK */
+    pthread_mutex_unlock(&conn->evloop.lock);
+
+    return sr_api_ret(NULL, err_info);
+}
+
+API int
+sr_conn_set_thread_attr(sr_conn_ctx_t *conn, sr_thread_type_t type, const sr_thread_attr_t *attr)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_thread_attr_t *dup = NULL;
+
+    SR_CHECK_ARG_APIRET(!conn || (type > SR_THREAD_NOTIF_BUF) || (attr && attr->cpu_count && !attr->cpus), NULL,
+            err_info);
+
+    if (attr && (err_info = sr_thread_attr_dup(attr, &dup))) {
         return sr_api_ret(NULL, err_info);
     }
 
+    /* THREAD ATTR LOCK */
+    pthread_mutex_lock(&conn->thread_attr_lock);
+
+    sr_thread_attr_free(conn->thread_attr[type]);
+    conn->thread_attr[type] = dup;
+
+    /* THREAD ATTR UNLOCK */
+    pthread_mutex_unlock(&conn->thread_attr_lock);
+
     return sr_api_ret(NULL, NULL);
 }
 
+API int
+sr_subscription_set_thread_attr(sr_subscription_ctx_t *subscription, const sr_thread_attr_t *attr)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+
+    SR_CHECK_ARG_APIRET(!subscription || !attr || (attr->cpu_count && !attr->cpus), NULL, err_info);
+
+    /* SUBS READ LOCK, the workers are not replaced */
+    if ((err_info = sr_rwlock(&subscription->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_READ, subscription->conn->cid,
+            __func__, NULL, NULL))) {
+        return sr_api_ret(NULL, err_info);
+    }
+
+    if (subscription->evloop || !ATOMIC_LOAD_RELAXED(subscription->thread_running)) {
+        sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED, "Subscription has no handler thread.");
+        goto cleanup;
+    }
+
+    if ((err_info = sr_thread_attr_apply(subscription->tid, attr))) {
+        goto cleanup;
+    }
+    for (i = 0; i < subscription->workers.count; ++i) {
+        if ((err_info = sr_thread_attr_apply(subscription->workers.tids[i], attr))) {
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    /* SUBS READ UNLOCK */
+    sr_rwunlock(&subscription->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_READ, subscription->conn->cid, __func__);
+
+    return sr_api_ret(NULL, err_info);
+}
+
 /**
  * @brief Unlocked unsubscribe (free) of all the subscriptions in a subscription structure.
  *
@@ -4666,6 +6740,15 @@ _sr_unsubscribe(sr_subscription_ctx_t *subscription)
 
     assert(subscription);
 
+    if ((subscription->evloop && sr_shmsub_evloop_processing(subscription)) || (!subscription->evloop &&
+            ATOMIC_LOAD_RELAXED(subscription->thread_running) && pthread_equal(subscription->tid, pthread_self())) ||
+            sr_shmsub_workers_processing(subscription)) {
+        /* the events of the subscription are still being processed by this thread, it cannot be freed */
+        sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED, "Unsubscribing a subscription structure from its own callback "
+                "is not supported.");
+        return err_info;
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(subscription->conn, SR_LOCK_READ, 0, __func__))) {
         return err_info;
@@ -4683,12 +6766,16 @@ _sr_unsubscribe(sr_subscription_ctx_t *subscription)
 
     /* no new events can be generated at this point */
 
-    if (ATOMIC_LOAD_RELAXED(subscription->thread_running)) {
+    if (subscription->evloop) {
+        /* stop handling the events by the shared event loop */
+        sr_shmsub_evloop_del(subscription);
+        ATOMIC_STORE_RELAXED(subscription->thread_running, 0);
+    } else if (ATOMIC_LOAD_RELAXED(subscription->thread_running)) {
         /* signal the thread to quit */
         ATOMIC_STORE_RELAXED(subscription->thread_running, 0);
 
         /* generate a new event for the thread to wake up */
-        if ((tmp_err = sr_shmsub_notify_evpipe(subscription->evpipe_num))) {
+        if ((tmp_err = sr_shmsub_notify_evpipe(subscription->evpipe_num, SR_EVPIPE_EV_ANY))) {
             sr_errinfo_merge(&err_info, tmp_err);
         } else {
             /* join the thread */
@@ -4699,6 +6786,9 @@ _sr_unsubscribe(sr_subscription_ctx_t *subscription)
         }
     }
 
+    /* stop the workers */
+    sr_shmsub_workers_stop(subscription);
+
     /* unlink event pipe */
     if ((tmp_err = sr_path_evpipe(subscription->evpipe_num, &path))) {
         /* continue */
@@ -4714,6 +6804,8 @@ _sr_unsubscribe(sr_subscription_ctx_t *subscription)
     /* free attributes */
     close(subscription->evpipe);
     sr_rwlock_destroy(&subscription->subs_lock);
+    pthread_mutex_destroy(&subscription->workers.lock);
+    sr_cond_destroy(&subscription->workers.cond);
     free(subscription);
     return err_info;
 }
@@ -4739,6 +6831,11 @@ sr_module_change_set_order(sr_conn_ctx_t *conn, const char *module_name, sr_data
 
     SR_CHECK_ARG_APIRET(!conn || !module_name, NULL, err_info);
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(conn, NULL, module_name))) {
+        goto cleanup;
+    }
+
     /* check module existence */
     if (!(ly_mod = ly_ctx_get_module_implemented(conn->ly_ctx, module_name))) {
         sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, "Module \"%s\" was not found in sysrepo.", module_name);
@@ -4765,6 +6862,11 @@ sr_module_change_get_order(sr_conn_ctx_t *conn, const char *module_name, sr_data
 
     SR_CHECK_ARG_APIRET(!conn || !module_name || !priority, NULL, err_info);
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(conn, NULL, module_name))) {
+        goto cleanup;
+    }
+
     /* check module existence */
     if (!(ly_mod = ly_ctx_get_module_implemented(conn->ly_ctx, module_name))) {
         sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, "Module \"%s\" was not found in sysrepo.", module_name);
@@ -4784,10 +6886,43 @@ cleanup:
 }
 
 /**
- * @brief Perform enabled event on a subscription.
+ * @brief Load current data of modules for enabled events of subscriptions.
  *
  * @param[in] session Session to use.
  * @param[in,out] mod_info Empty mod info structure to use. If any modules were locked, they are kept that way.
+ * @param[in] ly_mods Array of modules to load.
+ * @param[in] ly_mod_count Count of @p ly_mods.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_module_change_subscribe_enable_load(sr_session_ctx_t *session, struct sr_mod_info_s *mod_info,
+        const struct lys_module **ly_mods, uint32_t ly_mod_count)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+
+    SR_MODINFO_INIT((*mod_info), session->conn, session->ds, session->ds == SR_DS_OPERATIONAL ? SR_DS_RUNNING : session->ds);
+
+    /* create mod_info structure with these modules only, do not use cache to allow reading data in the callback
+     * (avoid dead-lock) */
+    for (i = 0; i < ly_mod_count; ++i) {
+        if ((err_info = sr_modinfo_add(ly_mods[i], NULL, 0, 0, mod_info))) {
+            return err_info;
+        }
+    }
+    if ((err_info = sr_modinfo_consolidate(mod_info, 0, SR_LOCK_READ, SR_MI_PERM_NO, session->sid, session->orig_name,
+            session->orig_data, 0, 0, SR_OPER_NO_SUBS))) {
+        return err_info;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Perform enabled event on a subscription.
+ *
+ * @param[in] session Session to use.
+ * @param[in] mod_info Mod info with the data of @p ly_mod loaded by ::sr_module_change_subscribe_enable_load().
  * @param[in] ly_mod Specific module.
  * @param[in] xpath Optional subscription xpath.
  * @param[in] callback Callback to call.
@@ -4806,18 +6941,6 @@ sr_module_change_subscribe_enable(sr_session_ctx_t *session, struct sr_mod_info_
     sr_session_ctx_t *ev_sess = NULL;
     sr_error_t err_code;
 
-    SR_MODINFO_INIT((*mod_info), session->conn, session->ds, session->ds == SR_DS_OPERATIONAL ? SR_DS_RUNNING : session->ds);
-
-    /* create mod_info structure with this module only, do not use cache to allow reading data in the callback
-     * (avoid dead-lock) */
-    if ((err_info = sr_modinfo_add(ly_mod, NULL, 0, 0, mod_info))) {
-        goto cleanup;
-    }
-    if ((err_info = sr_modinfo_consolidate(mod_info, 0, SR_LOCK_READ, SR_MI_PERM_NO, session->sid, session->orig_name,
-            session->orig_data, 0, 0, SR_OPER_NO_SUBS))) {
-        goto cleanup;
-    }
-
     /* start with any existing config NP containers */
     if ((err_info = sr_lyd_dup_module_np_cont(mod_info->data, ly_mod, 0, &enabled_data))) {
         goto cleanup;
@@ -4897,15 +7020,29 @@ sr_subscr_new(sr_conn_ctx_t *conn, sr_subscr_options_t opts, sr_subscription_ctx
 {
     sr_error_info_t *err_info = NULL;
     char *path = NULL;
-    int ret;
 
     assert(!*subs_p);
 
+    if ((opts & SR_SUBSCR_NO_THREAD) && (opts & SR_SUBSCR_SHARED_THREAD)) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Subscription cannot be both without a thread and handled by "
+                "the shared event loop.");
+        return err_info;
+    }
+
     /* allocate new subscription */
     *subs_p = calloc(1, sizeof **subs_p);
     SR_CHECK_MEM_RET(!*subs_p, err_info);
     if ((err_info = sr_rwlock_init(&(*subs_p)->subs_lock, 0))) {
-        goto error;
+        free(*subs_p);
+        *subs_p = NULL;
+        return err_info;
+    }
+    if ((err_info = sr_mutex_init(&(*subs_p)->workers.lock, 0))) {
+        goto error_rwlock;
+    }
+    if ((err_info = sr_cond_init(&(*subs_p)->workers.cond, 0, 0))) {
+        pthread_mutex_destroy(&(*subs_p)->workers.lock);
+        goto error_rwlock;
     }
     (*subs_p)->conn = conn;
     (*subs_p)->evpipe = -1;
@@ -4939,11 +7076,17 @@ sr_subscr_new(sr_conn_ctx_t *conn, sr_subscr_options_t opts, sr_subscription_ctx
             ATOMIC_STORE_RELAXED((*subs_p)->thread_running, 1);
         }
 
-        /* start the listen thread */
-        ret = pthread_create(&(*subs_p)->tid, NULL, sr_shmsub_listen_thread, *subs_p);
-        if (ret) {
-            sr_errinfo_new(&err_info, SR_ERR_INTERNAL, "Creating a new thread failed (%s).", strerror(ret));
-            goto error;
+        if (opts & SR_SUBSCR_SHARED_THREAD) {
+            /* let the shared event loop of the connection handle the events */
+            if ((err_info = sr_shmsub_evloop_add(*subs_p))) {
+                goto error;
+            }
+        } else {
+            /* start the listen thread */
+            if ((err_info = sr_conn_thread_create(conn, SR_THREAD_SUBSCR, &(*subs_p)->tid, sr_shmsub_listen_thread,
+                    *subs_p))) {
+                goto error;
+            }
         }
     }
 
@@ -4955,6 +7098,9 @@ error:
     if ((*subs_p)->evpipe > -1) {
         close((*subs_p)->evpipe);
     }
+    pthread_mutex_destroy(&(*subs_p)->workers.lock);
+    sr_cond_destroy(&(*subs_p)->workers.cond);
+error_rwlock:
     sr_rwlock_destroy(&(*subs_p)->subs_lock);
     free(*subs_p);
     *subs_p = NULL;
@@ -4979,9 +7125,19 @@ sr_module_change_subscribe(sr_session_ctx_t *session, const char *module_name, c
 
     SR_MODINFO_INIT(mod_info, session->conn, SR_DS_RUNNING, SR_DS_RUNNING);
 
+    if ((opts & SR_SUBSCR_PARALLEL) && (opts & SR_SUBSCR_UPDATE)) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Update subscriptions cannot be in a parallel group.");
+        return sr_api_ret(session, err_info);
+    }
+
     conn = session->conn;
     /* only these options are relevant outside this function and will be stored */
-    sub_opts = opts & (SR_SUBSCR_DONE_ONLY | SR_SUBSCR_PASSIVE | SR_SUBSCR_UPDATE);
+    sub_opts = opts & (SR_SUBSCR_DONE_ONLY | SR_SUBSCR_PASSIVE | SR_SUBSCR_UPDATE | SR_SUBSCR_PARALLEL);
+
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(conn, xpath, module_name))) {
+        return sr_api_ret(session, err_info);
+    }
 
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
@@ -5033,6 +7189,9 @@ sr_module_change_subscribe(sr_session_ctx_t *session, const char *module_name, c
 
     if (opts & SR_SUBSCR_ENABLED) {
         /* call the callback with the current configuration, keep any used modules locked in mod_info */
+        if ((err_info = sr_module_change_subscribe_enable_load(session, &mod_info, &ly_mod, 1))) {
+            goto cleanup_change_unlock;
+        }
         if ((err_info = sr_module_change_subscribe_enable(session, &mod_info, ly_mod, xpath, callback, private_data,
                 sub_id, opts))) {
             goto cleanup_change_unlock;
@@ -5098,12 +7257,248 @@ cleanup:
     return sr_api_ret(session, err_info);
 }
 
+/**
+ * @brief Comparator function for qsort of SHM module pointers.
+ *
+ * @param[in] ptr1 First value pointer.
+ * @param[in] ptr2 Second value pointer.
+ * @return Less than, equal to, or greater than 0 if the first value is found
+ * to be less than, equal to, or greater to the second value.
+ */
+static int
+sr_shm_mod_ptr_cmp(const void *ptr1, const void *ptr2)
+{
+    const sr_mod_t *shm_mod1 = *(const sr_mod_t **)ptr1, *shm_mod2 = *(const sr_mod_t **)ptr2;
+
+    if (shm_mod1 > shm_mod2) {
+        return 1;
+    }
+    if (shm_mod1 < shm_mod2) {
+        return -1;
+    }
+    return 0;
+}
+
+API int
+sr_module_change_subscribe_batch(sr_session_ctx_t *session, const sr_module_change_sub_t *subs, uint32_t sub_count,
+        sr_subscr_options_t opts, sr_subscription_ctx_t **subscription, uint32_t *sub_ids)
+{
+    sr_error_info_t *err_info = NULL, *tmp_err;
+    const struct lys_module **ly_mods = NULL, **en_mods = NULL;
+    struct sr_mod_info_s mod_info;
+    sr_conn_ctx_t *conn;
+    sr_mod_t **shm_mods = NULL, **lock_mods = NULL;
+    const char **xpaths = NULL;
+    uint32_t *ids = NULL, *prios = NULL, i, j, lock_count = 0, locked_count = 0, en_count = 0, added_count = 0;
+    uint32_t subscr_count = 0;
+    int *sub_opts = NULL;
+    sr_subscr_options_t s_opts;
+
+    SR_CHECK_ARG_APIRET(!session || !SR_IS_STANDARD_DS(session->ds) || SR_IS_EVENT_SESS(session) || !subs ||
+            !sub_count || !subscription, session, err_info);
+    for (i = 0; i < sub_count; ++i) {
+        SR_CHECK_ARG_APIRET(!subs[i].module_name || !subs[i].callback, session, err_info);
+        s_opts = opts | subs[i].opts;
+        if ((s_opts & SR_SUBSCR_PARALLEL) && (s_opts & SR_SUBSCR_UPDATE)) {
+            sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Update subscriptions cannot be in a parallel group.");
+            return sr_api_ret(session, err_info);
+        }
+    }
+
+    SR_MODINFO_INIT(mod_info, session->conn, SR_DS_RUNNING, SR_DS_RUNNING);
+    conn = session->conn;
+
+    /* load the modules into a lazy context */
+    for (i = 0; i < sub_count; ++i) {
+        if ((err_info = sr_lycc_lazy_load(conn, subs[i].xpath, subs[i].module_name))) {
+            return sr_api_ret(session, err_info);
+        }
+    }
+
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
+        return sr_api_ret(session, err_info);
+    }
+
+    ly_mods = calloc(sub_count, sizeof *ly_mods);
+    en_mods = calloc(sub_count, sizeof *en_mods);
+    shm_mods = calloc(sub_count, sizeof *shm_mods);
+    lock_mods = calloc(sub_count, sizeof *lock_mods);
+    xpaths = calloc(sub_count, sizeof *xpaths);
+    ids = calloc(sub_count, sizeof *ids);
+    prios = calloc(sub_count, sizeof *prios);
+    sub_opts = calloc(sub_count, sizeof *sub_opts);
+    SR_CHECK_MEM_GOTO(!ly_mods || !en_mods || !shm_mods || !lock_mods || !xpaths || !ids || !prios || !sub_opts,
+            err_info, cleanup);
+
+    for (i = 0; i < sub_count; ++i) {
+        s_opts = opts | subs[i].opts;
+
+        /* check module name and xpath */
+        ly_mods[i] = ly_ctx_get_module_implemented(conn->ly_ctx, subs[i].module_name);
+        if (!ly_mods[i]) {
+            sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, "Module \"%s\" was not found in sysrepo.", subs[i].module_name);
+            goto cleanup;
+        } else if (!strcmp(ly_mods[i]->name, "sysrepo")) {
+            sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED, "Data of internal module \"sysrepo\" cannot be subscribed to.");
+            goto cleanup;
+        }
+        if (subs[i].xpath && (err_info = sr_subscr_change_xpath_check(conn->ly_ctx, subs[i].xpath, NULL))) {
+            goto cleanup;
+        }
+
+        /* find the module in SHM */
+        shm_mods[i] = sr_shmmod_find_module(SR_CONN_MOD_SHM(conn), subs[i].module_name);
+        SR_CHECK_INT_GOTO(!shm_mods[i], err_info, cleanup);
+
+        /* collect distinct modules to lock and to load the enabled data of */
+        for (j = 0; (j < lock_count) && (lock_mods[j] != shm_mods[i]); ++j) {}
+        if (j == lock_count) {
+            /* check write/read perm, once for every module */
+            if ((err_info = sr_perm_check(conn, ly_mods[i], session->ds, (s_opts & SR_SUBSCR_PASSIVE) ? 0 : 1, NULL))) {
+                goto cleanup;
+            }
+            lock_mods[lock_count++] = shm_mods[i];
+        } else if (!(s_opts & SR_SUBSCR_PASSIVE) && (err_info = sr_perm_check(conn, ly_mods[i], session->ds, 1, NULL))) {
+            goto cleanup;
+        }
+        if (s_opts & SR_SUBSCR_ENABLED) {
+            for (j = 0; (j < en_count) && (en_mods[j] != ly_mods[i]); ++j) {}
+            if (j == en_count) {
+                en_mods[en_count++] = ly_mods[i];
+            }
+        }
+
+        /* only these options are relevant outside this function and will be stored */
+        xpaths[i] = subs[i].xpath;
+        prios[i] = subs[i].priority;
+        sub_opts[i] = s_opts & (SR_SUBSCR_DONE_ONLY | SR_SUBSCR_PASSIVE | SR_SUBSCR_UPDATE | SR_SUBSCR_PARALLEL);
+
+        /* get new sub ID */
+        ids[i] = ATOMIC_INC_RELAXED(SR_CONN_MAIN_SHM(conn)->new_sub_id);
+    }
+
+    if (!*subscription) {
+        /* create a new subscription */
+        if ((err_info = sr_subscr_new(conn, opts, subscription))) {
+            goto cleanup;
+        }
+    } else if (opts & SR_SUBSCR_THREAD_SUSPEND) {
+        /* suspend the running thread */
+        _sr_subscription_thread_suspend(*subscription);
+    }
+
+    /* keep lock order: CHANGE SUB, MODULES and CHANGE SUB, SUBS - for applying changes and processing events,
+     * lock the modules in the same order as when applying changes */
+    qsort(lock_mods, lock_count, sizeof *lock_mods, sr_shm_mod_ptr_cmp);
+    for (locked_count = 0; locked_count < lock_count; ++locked_count) {
+        /* CHANGE SUB WRITE LOCK */
+        if ((err_info = sr_rwlock(&lock_mods[locked_count]->change_sub[session->ds].lock, SR_SHMEXT_SUB_LOCK_TIMEOUT,
+                SR_LOCK_WRITE, conn->cid, __func__, NULL, NULL))) {
+            goto cleanup_change_unlock;
+        }
+    }
+
+    if (en_count) {
+        /* load the current configuration of all the modules at once, keep any used modules locked in mod_info */
+        if ((err_info = sr_module_change_subscribe_enable_load(session, &mod_info, en_mods, en_count))) {
+            goto cleanup_change_unlock;
+        }
+
+        /* call the callbacks */
+        for (i = 0; i < sub_count; ++i) {
+            s_opts = opts | subs[i].opts;
+            if ((s_opts & SR_SUBSCR_ENABLED) && (err_info = sr_module_change_subscribe_enable(session, &mod_info,
+                    ly_mods[i], subs[i].xpath, subs[i].callback, subs[i].private_data, ids[i], s_opts))) {
+                goto cleanup_change_unlock;
+            }
+        }
+    }
+
+    /* SUBS WRITE LOCK */
+    if ((err_info = sr_rwlock(&(*subscription)->subs_lock, SR_SUBSCR_LOCK_TIMEOUT, SR_LOCK_WRITE, conn->cid,
+            __func__, NULL, NULL))) {
+        goto cleanup_change_unlock;
+    }
+
+    /* add all the module subscriptions into ext SHM and create separate specific SHM segments */
+    if ((err_info = sr_shmext_change_sub_add_batch(conn, shm_mods, session->ds, ids, xpaths, prios, sub_opts, sub_count,
+            (*subscription)->evpipe_num, &added_count))) {
+        goto error;
+    }
+
+    /* add subscriptions into structure */
+    for (i = 0; i < sub_count; ++i) {
+        if ((err_info = sr_subscr_change_sub_add(*subscription, ids[i], session, subs[i].module_name, subs[i].xpath,
+                subs[i].callback, subs[i].private_data, subs[i].priority, sub_opts[i], SR_LOCK_WRITE))) {
+            goto error;
+        }
+        ++subscr_count;
+    }
+
+    /* add the subscription into session */
+    if ((err_info = sr_ptr_add(&session->ptr_lock, (void ***)&session->subscriptions, &session->subscription_count,
+            *subscription))) {
+        goto error;
+    }
+
+    if (sub_ids) {
+        memcpy(sub_ids, ids, sub_count * sizeof *sub_ids);
+    }
+    goto cleanup_subs_change_unlock;
+
+error:
+    for (i = 0; i < subscr_count; ++i) {
+        sr_subscr_change_sub_del(*subscription, ids[i], SR_LOCK_WRITE);
+    }
+    for (i = 0; i < added_count; ++i) {
+        if ((tmp_err = sr_shmext_change_sub_del(conn, shm_mods[i], SR_LOCK_WRITE, session->ds, ids[i]))) {
+            sr_errinfo_merge(&err_info, tmp_err);
+        }
+    }
+
+cleanup_subs_change_unlock:
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&(*subscription)->subs_lock, 0, SR_LOCK_WRITE, conn->cid, __func__);
+
+cleanup_change_unlock:
+    for (i = locked_count; i; --i) {
+        /* CHANGE SUB UNLOCK */
+        sr_rwunlock(&lock_mods[i - 1]->change_sub[session->ds].lock, SR_SHMEXT_SUB_LOCK_TIMEOUT, SR_LOCK_WRITE,
+                conn->cid, __func__);
+    }
+
+    /* if there are any modules, unlock them after the enabled events were handled and the subscriptions were added
+     * to avoid losing any changes */
+
+    /* MODULES UNLOCK */
+    sr_shmmod_modinfo_unlock(&mod_info);
+
+    sr_modinfo_erase(&mod_info);
+
+cleanup:
+    /* CONTEXT UNLOCK */
+    sr_lycc_unlock(conn, SR_LOCK_READ, 0, __func__);
+
+    free(ly_mods);
+    free(en_mods);
+    free(shm_mods);
+    free(lock_mods);
+    free(xpaths);
+    free(ids);
+    free(prios);
+    free(sub_opts);
+    return sr_api_ret(session, err_info);
+}
+
 API int
 sr_module_change_sub_get_info(sr_subscription_ctx_t *subscription, uint32_t sub_id, const char **module_name,
         sr_datastore_t *ds, const char **xpath, uint32_t *filtered_out)
 {
     sr_error_info_t *err_info = NULL;
     struct modsub_changesub_s *change_sub;
+    const char *mod_name;
+    sr_datastore_t sub_ds;
 
     SR_CHECK_ARG_APIRET(!subscription || !sub_id, NULL, err_info);
 
@@ -5114,18 +7509,27 @@ sr_module_change_sub_get_info(sr_subscription_ctx_t *subscription, uint32_t sub_
     }
 
     /* find the subscription in the subscription context */
-    change_sub = sr_subscr_change_sub_find(subscription, sub_id, module_name, ds);
+    change_sub = sr_subscr_change_sub_find(subscription, sub_id, &mod_name, &sub_ds);
     if (!change_sub) {
         sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, "Change subscription with ID \"%" PRIu32 "\" not found.", sub_id);
         goto cleanup_unlock;
     }
 
     /* fill parameters */
+    if (module_name) {
+        *module_name = mod_name;
+    }
+    if (ds) {
+        *ds = sub_ds;
+    }
     if (xpath) {
         *xpath = change_sub->xpath;
     }
     if (filtered_out) {
-        *filtered_out = ATOMIC_LOAD_RELAXED(change_sub->filtered_out);
+        /* change events are filtered by the originators */
+        if ((err_info = sr_shmext_change_sub_filtered_out(subscription->conn, mod_name, sub_ds, sub_id, filtered_out))) {
+            goto cleanup_unlock;
+        }
     }
 
 cleanup_unlock:
@@ -5174,10 +7578,14 @@ sr_module_change_sub_modify_xpath(sr_subscription_ctx_t *subscription, uint32_t
     /* update xpath in the subscription */
     free(change_sub->xpath);
     change_sub->xpath = NULL;
+    sr_xpath_filter_clear(&change_sub->filter);
     if (xpath) {
         change_sub->xpath = strdup(xpath);
         SR_CHECK_MEM_GOTO(!change_sub->xpath, err_info, cleanup_unlock);
     }
+    if ((err_info = sr_xpath_filter_compile(xpath, &change_sub->filter))) {
+        goto cleanup_unlock;
+    }
 
     /* find the module in SHM */
     shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(subscription->conn), module_name);
@@ -5202,7 +7610,8 @@ _sr_get_changes_iter(sr_session_ctx_t *session, const char *xpath, int dup, sr_c
 
     SR_CHECK_ARG_APIRET(!session || !SR_IS_EVENT_SESS(session) || !xpath || !iter, session, err_info);
 
-    if ((session->ev != SR_SUB_EV_ENABLED) && (session->ev != SR_SUB_EV_DONE) && !session->dt[session->ds].diff) {
+    if ((session->ev != SR_SUB_EV_ENABLED) && (session->ev != SR_SUB_EV_DONE) && !session->dt[session->ds].diff &&
+            !session->dt[session->ds].change_log) {
         sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Session without changes.");
         return sr_api_ret(session, err_info);
     }
@@ -5213,6 +7622,23 @@ _sr_get_changes_iter(sr_session_ctx_t *session, const char *xpath, int dup, sr_c
         return sr_api_ret(session, err_info);
     }
 
+    if (!dup && session->dt[session->ds].change_log && !session->dt[session->ds].diff) {
+        /* iterate over the change log directly, if possible */
+        if ((err_info = sr_change_log_iter_new(session->dt[session->ds].change_log, xpath, &(*iter)->log_iter))) {
+            goto error;
+        }
+        if ((*iter)->log_iter) {
+            (*iter)->xpath = strdup(xpath);
+            SR_CHECK_MEM_GOTO(!(*iter)->xpath, err_info, error);
+            return sr_api_ret(session, NULL);
+        }
+    }
+
+    /* the diff is needed */
+    if ((err_info = sr_change_log_session_diff(session))) {
+        goto error;
+    }
+
     if (session->dt[session->ds].diff) {
         if (dup) {
             if (lyd_dup_siblings(session->dt[session->ds].diff, NULL, LYD_DUP_RECURSIVE, &(*iter)->diff)) {
@@ -5224,6 +7650,11 @@ _sr_get_changes_iter(sr_session_ctx_t *session, const char *xpath, int dup, sr_c
             sr_errinfo_new_ly(&err_info, session->conn->ly_ctx, NULL);
             goto error;
         }
+
+        /* learn the operations of all the changes at once */
+        if ((err_info = sr_diff_set_opers((*iter)->set, &(*iter)->opers))) {
+            goto error;
+        }
     } else {
         if (ly_set_new(&(*iter)->set)) {
             SR_ERRINFO_MEM(&err_info);
@@ -5369,8 +7800,21 @@ sr_get_change_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_change_
 
     SR_CHECK_ARG_APIRET(!session || !iter || !operation || !old_value || !new_value, session, err_info);
 
+    if (iter->log_iter) {
+        /* get next change from the change log */
+        if ((err_info = sr_change_log_iter_next(iter->log_iter, operation, old_value, new_value))) {
+            return sr_api_ret(session, err_info);
+        }
+        if (!*old_value && !*new_value) {
+            /* no more changes */
+            return SR_ERR_NOT_FOUND;
+        }
+        ++iter->idx;
+        return sr_api_ret(session, NULL);
+    }
+
     /* get next change */
-    if ((err_info = sr_diff_set_getnext(iter->set, &iter->idx, &node, &op))) {
+    if ((err_info = sr_diff_set_getnext(iter->set, iter->opers, &iter->idx, &node, &op))) {
         return sr_api_ret(session, err_info);
     }
 
@@ -5428,29 +7872,72 @@ sr_get_change_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_change_
             return sr_api_ret(session, err_info);
         }
 
-        if (lyd_get_meta_value(meta)[0]) {
-            if (lysc_is_dup_inst_list(node->schema)) {
-                err_info = sr_change_ly2sr(node, NULL, lyd_get_meta_value(meta), old_value);
-            } else if (node->schema->nodetype == LYS_LEAFLIST) {
-                err_info = sr_change_ly2sr(node, lyd_get_meta_value(meta), NULL, old_value);
-            } else {
-                err_info = sr_change_ly2sr(node, NULL, lyd_get_meta_value(meta), old_value);
-            }
-            if (err_info) {
-                return sr_api_ret(session, err_info);
-            }
-        } else {
-            /* inserted as the first item */
-            *old_value = NULL;
-        }
-        if ((err_info = sr_change_ly2sr(node, NULL, NULL, new_value))) {
-            return sr_api_ret(session, err_info);
+        if (lyd_get_meta_value(meta)[0]) {
+            if (lysc_is_dup_inst_list(node->schema)) {
+                err_info = sr_change_ly2sr(node, NULL, lyd_get_meta_value(meta), old_value);
+            } else if (node->schema->nodetype == LYS_LEAFLIST) {
+                err_info = sr_change_ly2sr(node, lyd_get_meta_value(meta), NULL, old_value);
+            } else {
+                err_info = sr_change_ly2sr(node, NULL, lyd_get_meta_value(meta), old_value);
+            }
+            if (err_info) {
+                return sr_api_ret(session, err_info);
+            }
+        } else {
+            /* inserted as the first item */
+            *old_value = NULL;
+        }
+        if ((err_info = sr_change_ly2sr(node, NULL, NULL, new_value))) {
+            return sr_api_ret(session, err_info);
+        }
+        break;
+    }
+
+    *operation = op;
+    return sr_api_ret(session, NULL);
+}
+
+/**
+ * @brief Switch a change log iterator to iterate over the diff, which is built if needed.
+ *
+ * @param[in] session Event session of the iterator.
+ * @param[in] iter Change iterator using a change log.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_change_iter_log2set(sr_session_ctx_t *session, sr_change_iter_t *iter)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *node;
+    sr_change_oper_t op;
+    uint32_t count;
+
+    if ((err_info = sr_change_log_session_diff(session))) {
+        return err_info;
+    }
+
+    if (lyd_find_xpath(session->dt[session->ds].diff, iter->xpath, &iter->set)) {
+        sr_errinfo_new_ly(&err_info, session->conn->ly_ctx, NULL);
+        return err_info;
+    }
+    if ((err_info = sr_diff_set_opers(iter->set, &iter->opers))) {
+        return err_info;
+    }
+
+    /* skip the changes already returned from the change log */
+    count = iter->idx;
+    iter->idx = 0;
+    while (count--) {
+        if ((err_info = sr_diff_set_getnext(iter->set, iter->opers, &iter->idx, &node, &op))) {
+            return err_info;
         }
-        break;
     }
 
-    *operation = op;
-    return sr_api_ret(session, NULL);
+    sr_change_log_iter_free(iter->log_iter);
+    iter->log_iter = NULL;
+    free(iter->xpath);
+    iter->xpath = NULL;
+    return NULL;
 }
 
 API int
@@ -5472,8 +7959,12 @@ sr_get_change_tree_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_ch
         *prev_dflt = 0;
     }
 
+    if (iter->log_iter && (err_info = sr_change_iter_log2set(session, iter))) {
+        return sr_api_ret(session, err_info);
+    }
+
     /* get next change */
-    if ((err_info = sr_diff_set_getnext(iter->set, &iter->idx, (struct lyd_node **)node, operation))) {
+    if ((err_info = sr_diff_set_getnext(iter->set, iter->opers, &iter->idx, (struct lyd_node **)node, operation))) {
         return sr_api_ret(session, err_info);
     }
 
@@ -5543,6 +8034,9 @@ sr_free_change_iter(sr_change_iter_t *iter)
 
     lyd_free_all(iter->diff);
     ly_set_free(iter->set, NULL);
+    free(iter->opers);
+    sr_change_log_iter_free(iter->log_iter);
+    free(iter->xpath);
     free(iter);
 }
 
@@ -5576,6 +8070,11 @@ _sr_rpc_subscribe(sr_session_ctx_t *session, const char *xpath, sr_rpc_cb callba
 
     conn = session->conn;
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(conn, xpath, NULL))) {
+        return sr_api_ret(session, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(session, err_info);
@@ -5723,6 +8222,11 @@ sr_rpc_send(sr_session_ctx_t *session, const char *path, const sr_val_t *input,
     *output = NULL;
     *output_cnt = 0;
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(session->conn, path, NULL))) {
+        return sr_api_ret(session, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(session, err_info);
@@ -5860,28 +8364,33 @@ _sr_rpc_send_tree(sr_session_ctx_t *session, struct sr_mod_info_s *mod_info, con
         goto cleanup;
     }
 
-    /* collect all required modules for input validation */
-    if ((err_info = sr_shmmod_get_rpc_deps(SR_CONN_MOD_SHM(session->conn), path, 0, &shm_deps, &shm_dep_count))) {
-        goto cleanup;
-    }
-    if ((err_info = sr_shmmod_collect_deps(SR_CONN_MOD_SHM(session->conn), shm_deps, shm_dep_count, input, mod_info))) {
-        goto cleanup;
-    }
-    if ((err_info = sr_modinfo_consolidate(mod_info, 0, SR_LOCK_READ, SR_MI_NEW_DEPS | SR_MI_DATA_CACHE | SR_MI_PERM_NO,
-            session->sid, session->orig_name, session->orig_data, SR_OPER_CB_TIMEOUT, 0, 0))) {
-        goto cleanup;
-    }
+    if (!(session->conn->opts & SR_CONN_NO_OP_VALIDATE)) {
+        /* collect all required modules for input validation */
+        if ((err_info = sr_shmmod_get_rpc_deps(SR_CONN_MOD_SHM(session->conn), path, 0, &shm_deps, &shm_dep_count))) {
+            goto cleanup;
+        }
+        if ((err_info = sr_shmmod_collect_deps(SR_CONN_MOD_SHM(session->conn), shm_deps, shm_dep_count, input, NULL, 0,
+            mod_info))) {
+            goto cleanup;
+        }
 
-    /* validate the operation, must be valid only at the time of execution */
-    if ((err_info = sr_modinfo_op_validate(mod_info, input_op, 0))) {
-        goto cleanup;
-    }
+        /* no data are loaded nor modules locked if there are no dependencies */
+        if ((err_info = sr_modinfo_consolidate(mod_info, 0, SR_LOCK_READ, SR_MI_NEW_DEPS | SR_MI_DATA_CACHE | SR_MI_PERM_NO,
+                session->sid, session->orig_name, session->orig_data, SR_OPER_CB_TIMEOUT, 0, 0))) {
+            goto cleanup;
+        }
 
-    /* MODULES UNLOCK */
-    sr_shmmod_modinfo_unlock(mod_info);
+        /* validate the operation, must be valid only at the time of execution */
+        if ((err_info = sr_modinfo_op_validate(mod_info, input_op, 0))) {
+            goto cleanup;
+        }
 
-    sr_modinfo_erase(mod_info);
-    SR_MODINFO_INIT(*mod_info, session->conn, SR_DS_OPERATIONAL, SR_DS_RUNNING);
+        /* MODULES UNLOCK */
+        sr_shmmod_modinfo_unlock(mod_info);
+
+        sr_modinfo_erase(mod_info);
+        SR_MODINFO_INIT(*mod_info, session->conn, SR_DS_OPERATIONAL, SR_DS_RUNNING);
+    }
 
     if (!strcmp(path, SR_RPC_FACTORY_RESET_PATH)) {
         /* update the input as needed */
@@ -5925,7 +8434,8 @@ _sr_rpc_send_tree(sr_session_ctx_t *session, struct sr_mod_info_s *mod_info, con
     if ((err_info = sr_shmmod_get_rpc_deps(SR_CONN_MOD_SHM(session->conn), path, 1, &shm_deps, &shm_dep_count))) {
         goto cleanup;
     }
-    if ((err_info = sr_shmmod_collect_deps(SR_CONN_MOD_SHM(session->conn), shm_deps, shm_dep_count, input, mod_info))) {
+    if ((err_info = sr_shmmod_collect_deps(SR_CONN_MOD_SHM(session->conn), shm_deps, shm_dep_count, input, NULL, 0,
+            mod_info))) {
         goto cleanup;
     }
     if ((err_info = sr_modinfo_consolidate(mod_info, 0, SR_LOCK_READ, SR_MI_NEW_DEPS | SR_MI_DATA_CACHE | SR_MI_PERM_NO,
@@ -6050,135 +8560,376 @@ _sr_rpc_ext_send_tree(sr_session_ctx_t *session, const struct lyd_node *ext_pare
         goto cleanup;
     }
 
-    /* success */
-    goto cleanup;
+    /* success */
+    goto cleanup;
+
+cleanup_rpcsub_unlock:
+    /* RPC SUB READ UNLOCK */
+    sr_rwunlock(&shm_mod->rpc_ext_lock, SR_SHMEXT_SUB_LOCK_TIMEOUT, SR_LOCK_READ, session->conn->cid, __func__);
+
+cleanup:
+    if (cb_err_info) {
+        /* return callback error if some was generated */
+        sr_errinfo_merge(&err_info, cb_err_info);
+        sr_errinfo_new(&err_info, SR_ERR_CALLBACK_FAILED, "User callback failed.");
+    }
+    if (err_info) {
+        sr_release_data(*output);
+        *output = NULL;
+    }
+    return err_info;
+}
+
+/**
+ * @brief Send an RPC/action and wait for the result.
+ *
+ * @param[in] session Session to use.
+ * @param[in] input Input data tree, is validated.
+ * @param[in] timeout_ms RPC/action callback timeout in milliseconds.
+ * @param[out] output SR data with the output data tree.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_rpc_send_tree_op(sr_session_ctx_t *session, struct lyd_node *input, uint32_t timeout_ms, sr_data_t **output)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_mod_info_s mod_info;
+    struct lyd_node *input_top, *input_op, *ext_parent = NULL;
+    char *path = NULL, *str, *parent_path = NULL;
+    const struct lyd_node *denied_node;
+
+    for (input_top = input; input_top->parent; input_top = lyd_parent(input_top)) {}
+    SR_MODINFO_INIT(mod_info, session->conn, SR_DS_OPERATIONAL, SR_DS_RUNNING);
+
+    /* check input data tree */
+    input_op = NULL;
+    if (input->schema) {
+        switch (input->schema->nodetype) {
+        case LYS_ACTION:
+        case LYS_RPC:
+            input_op = input;
+            break;
+        case LYS_CONTAINER:
+        case LYS_LIST:
+            /* find the action (RPC in case of schema-mount) */
+            input_op = input;
+            if ((err_info = sr_ly_find_last_parent(&input_op, LYS_ACTION | LYS_RPC))) {
+                goto cleanup;
+            }
+            if (!(input_op->schema->nodetype & (LYS_ACTION | LYS_RPC))) {
+                input_op = NULL;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    if (!input_op) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Provided input is not a valid RPC or action invocation.");
+        goto cleanup;
+    }
+
+    /* check read perm */
+    if ((err_info = sr_perm_check(session->conn, lyd_owner_module(input_top), SR_DS_STARTUP, 0, NULL))) {
+        goto cleanup;
+    }
+
+    if (session->nacm_user) {
+        /* check NACM */
+        if ((err_info = sr_nacm_check_operation(session->nacm_user, input_top, &denied_node))) {
+            goto cleanup;
+        }
+
+        if (denied_node) {
+            /* access denied */
+            sr_errinfo_new_nacm(&err_info, "protocol", "access-denied", NULL, denied_node,
+                    "Executing the operation is denied because \"%s\" NACM authorization failed.", session->nacm_user);
+            goto cleanup;
+        }
+    }
+
+    /* get operation path (without predicates) */
+    str = lyd_path(input_op, LYD_PATH_STD, NULL, 0);
+    SR_CHECK_INT_GOTO(!str, err_info, cleanup);
+    err_info = sr_get_trim_predicates(str, &path);
+    free(str);
+    if (err_info) {
+        goto cleanup;
+    }
+
+    if ((input_top != input_op) && (!(session->conn->opts & SR_CONN_NO_OP_VALIDATE) ||
+            (LYD_CTX(input_top) != LYD_CTX(input_op)))) {
+        /* we need the OP parent to check it exists */
+        parent_path = lyd_path(lyd_parent(input_op), LYD_PATH_STD, NULL, 0);
+        SR_CHECK_MEM_GOTO(!parent_path, err_info, cleanup);
+        /* only reference to parent_path is stored, so it cannot be freed! */
+        if ((err_info = sr_modinfo_add(lyd_owner_module(input_top), parent_path, 0, 0, &mod_info))) {
+            goto cleanup;
+        }
+        if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_DATA_CACHE | SR_MI_PERM_NO,
+                session->sid, session->orig_name, session->orig_data, SR_OPER_CB_TIMEOUT, 0, 0))) {
+            goto cleanup;
+        }
+    }
+
+    if (LYD_CTX(input_top) != LYD_CTX(input_op)) {
+        /* different contexts if these are data of an extension (schema-mount) */
+        for (ext_parent = input_op; ext_parent && !(ext_parent->flags & LYD_EXT); ext_parent = lyd_parent(ext_parent)) {}
+        SR_CHECK_INT_GOTO(!ext_parent, err_info, cleanup);
+
+        err_info = _sr_rpc_ext_send_tree(session, ext_parent, &mod_info, path, input_top, input_op, timeout_ms, output);
+    } else {
+        err_info = _sr_rpc_send_tree(session, &mod_info, path, input_top, input_op, timeout_ms, output);
+    }
+
+cleanup:
+    /* MODULES UNLOCK */
+    sr_shmmod_modinfo_unlock(&mod_info);
+
+    free(parent_path);
+    free(path);
+    sr_modinfo_erase(&mod_info);
+    return err_info;
+}
+
+API int
+sr_rpc_send_tree(sr_session_ctx_t *session, struct lyd_node *input, uint32_t timeout_ms, sr_data_t **output)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *input_top;
+
+    SR_CHECK_ARG_APIRET(!session || !input || !output, session, err_info);
+
+    for (input_top = input; input_top->parent; input_top = lyd_parent(input_top)) {}
+    if (session->conn->ly_ctx != LYD_CTX(input_top)) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Data trees must be created using the session connection libyang context.");
+        return sr_api_ret(session, err_info);
+    }
+
+    if (!timeout_ms) {
+        timeout_ms = SR_RPC_CB_TIMEOUT;
+    }
+
+    err_info = sr_rpc_send_tree_op(session, input, timeout_ms, output);
+    return sr_api_ret(session, err_info);
+}
+
+/**
+ * @brief Asynchronous RPC/action worker thread, sends the queued requests.
+ *
+ * @param[in] arg Connection.
+ * @return NULL.
+ */
+static void *
+sr_rpc_async_thread(void *arg)
+{
+    sr_conn_ctx_t *conn = arg;
+    sr_error_info_t *err_info;
+    struct sr_rpc_async_req_s *req;
+    sr_data_t *output;
+
+    /* MUTEX LOCK */
+    pthread_mutex_lock(&conn->rpc_async.lock);
+
+    while (1) {
+        if (!conn->rpc_async.first) {
+            if (conn->rpc_async.quit) {
+                break;
+            }
+
+            /* COND WAIT */
+            sr_cond_wait(&conn->rpc_async.cond, &conn->rpc_async.lock);
+            continue;
+        }
+
+        /* dequeue the next request */
+        req = conn->rpc_async.first;
+        conn->rpc_async.first = req->next;
+        if (!conn->rpc_async.first) {
+            conn->rpc_async.last = NULL;
+        }
+
+        /* MUTEX UNLOCK */
+        pthread_mutex_unlock(&conn->rpc_async.lock);
+
+        /* send the RPC/action */
+        output = NULL;
+        err_info = sr_rpc_send_tree_op(req->session, req->input->tree, req->timeout_ms, &output);
+
+        /* report the result, the callback owns the output */
+        req->cb(req->session, req->request_id, err_info, output, req->private_data);
+        sr_errinfo_free(&err_info);
+        sr_release_data(req->input);
+
+        /* MUTEX LOCK */
+        pthread_mutex_lock(&conn->rpc_async.lock);
+
+        /* request finished */
+        --req->session->rpc_async_count;
+        sr_cond_broadcast(&conn->rpc_async.cond);
+        free(req);
+    }
+
+    /* MUTEX UNLOCK */
+    pthread_mutex_unlock(&conn->rpc_async.lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Wait for all the asynchronous RPC/action requests of a session to finish.
+ *
+ * @param[in] session Session to wait for.
+ */
+static void
+sr_rpc_async_session_wait(sr_session_ctx_t *session)
+{
+    sr_conn_ctx_t *conn = session->conn;
+
+    /* MUTEX LOCK */
+    pthread_mutex_lock(&conn->rpc_async.lock);
+
+    while (session->rpc_async_count) {
+        /* COND WAIT */
+        sr_cond_wait(&conn->rpc_async.cond, &conn->rpc_async.lock);
+    }
+
+    /* MUTEX UNLOCK */
+    pthread_mutex_unlock(&conn->rpc_async.lock);
+}
+
+/**
+ * @brief Stop all the asynchronous RPC/action workers of a connection, all the queued requests are sent.
+ *
+ * @param[in] conn Connection to use.
+ */
+static void
+sr_rpc_async_stop(sr_conn_ctx_t *conn)
+{
+    uint32_t i;
+
+    if (!conn->rpc_async.tids) {
+        return;
+    }
+
+    /* MUTEX LOCK */
+    pthread_mutex_lock(&conn->rpc_async.lock);
+
+    /* signal the workers to terminate */
+    conn->rpc_async.quit = 1;
+    sr_cond_broadcast(&conn->rpc_async.cond);
 
-cleanup_rpcsub_unlock:
-    /* RPC SUB READ UNLOCK */
-    sr_rwunlock(&shm_mod->rpc_ext_lock, SR_SHMEXT_SUB_LOCK_TIMEOUT, SR_LOCK_READ, session->conn->cid, __func__);
+    /* MUTEX UNLOCK */
+    pthread_mutex_unlock(&conn->rpc_async.lock);
 
-cleanup:
-    if (cb_err_info) {
-        /* return callback error if some was generated */
-        sr_errinfo_merge(&err_info, cb_err_info);
-        sr_errinfo_new(&err_info, SR_ERR_CALLBACK_FAILED, "User callback failed.");
-    }
-    if (err_info) {
-        sr_release_data(*output);
-        *output = NULL;
+    for (i = 0; i < conn->rpc_async.worker_count; ++i) {
+        pthread_join(conn->rpc_async.tids[i], NULL);
     }
-    return err_info;
+    assert(!conn->rpc_async.first);
+
+    free(conn->rpc_async.tids);
+    conn->rpc_async.tids = NULL;
+    conn->rpc_async.worker_count = 0;
+    conn->rpc_async.quit = 0;
 }
 
 API int
-sr_rpc_send_tree(sr_session_ctx_t *session, struct lyd_node *input, uint32_t timeout_ms, sr_data_t **output)
+sr_rpc_send_tree_async(sr_session_ctx_t *session, struct lyd_node *input, uint32_t timeout_ms, sr_rpc_async_cb callback,
+        void *private_data, uint32_t *request_id)
 {
     sr_error_info_t *err_info = NULL;
-    struct sr_mod_info_s mod_info;
-    struct lyd_node *input_top, *input_op, *ext_parent = NULL;
-    char *path = NULL, *str, *parent_path = NULL;
-    const struct lyd_node *denied_node;
+    sr_conn_ctx_t *conn;
+    struct sr_rpc_async_req_s *req = NULL;
+    struct lyd_node *input_top;
+    struct timespec timeout_ts;
+    int r;
 
-    SR_CHECK_ARG_APIRET(!session || !input || !output, session, err_info);
+    SR_CHECK_ARG_APIRET(!session || !input || !callback, session, err_info);
 
+    conn = session->conn;
     for (input_top = input; input_top->parent; input_top = lyd_parent(input_top)) {}
-    if (session->conn->ly_ctx != LYD_CTX(input_top)) {
+    if (conn->ly_ctx != LYD_CTX(input_top)) {
         sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Data trees must be created using the session connection libyang context.");
         return sr_api_ret(session, err_info);
     }
 
-    if (!timeout_ms) {
-        timeout_ms = SR_RPC_CB_TIMEOUT;
-    }
-    SR_MODINFO_INIT(mod_info, session->conn, SR_DS_OPERATIONAL, SR_DS_RUNNING);
+    /* prepare the request */
+    req = calloc(1, sizeof *req);
+    SR_CHECK_MEM_GOTO(!req, err_info, cleanup);
+    req->session = session;
+    req->timeout_ms = timeout_ms ? timeout_ms : SR_RPC_CB_TIMEOUT;
+    req->cb = callback;
+    req->private_data = private_data;
 
-    /* check input data tree */
-    input_op = NULL;
-    if (input->schema) {
-        switch (input->schema->nodetype) {
-        case LYS_ACTION:
-        case LYS_RPC:
-            input_op = input;
-            break;
-        case LYS_CONTAINER:
-        case LYS_LIST:
-            /* find the action (RPC in case of schema-mount) */
-            input_op = input;
-            if ((err_info = sr_ly_find_last_parent(&input_op, LYS_ACTION | LYS_RPC))) {
-                goto cleanup;
-            }
-            if (!(input_op->schema->nodetype & (LYS_ACTION | LYS_RPC))) {
-                input_op = NULL;
-            }
-            break;
-        default:
-            break;
-        }
-    }
-    if (!input_op) {
-        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Provided input is not a valid RPC or action invocation.");
+    /* CONTEXT LOCK */
+    if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
         goto cleanup;
     }
 
-    /* check read perm */
-    if ((err_info = sr_perm_check(session->conn, lyd_owner_module(input_top), SR_DS_STARTUP, 0, NULL))) {
+    /* copy the input, the context must not change until the request is sent */
+    if ((err_info = _sr_acquire_data(conn, NULL, &req->input))) {
         goto cleanup;
     }
-
-    if (session->nacm_user) {
-        /* check NACM */
-        if ((err_info = sr_nacm_check_operation(session->nacm_user, input_top, &denied_node))) {
-            goto cleanup;
-        }
-
-        if (denied_node) {
-            /* access denied */
-            sr_errinfo_new_nacm(&err_info, "protocol", "access-denied", NULL, denied_node,
-                    "Executing the operation is denied because \"%s\" NACM authorization failed.", session->nacm_user);
-            goto cleanup;
-        }
+    if (lyd_dup_single(input_top, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &req->input->tree)) {
+        sr_errinfo_new_ly(&err_info, conn->ly_ctx, NULL);
+        goto cleanup;
     }
 
-    /* get operation path (without predicates) */
-    str = lyd_path(input_op, LYD_PATH_STD, NULL, 0);
-    SR_CHECK_INT_GOTO(!str, err_info, cleanup);
-    err_info = sr_get_trim_predicates(str, &path);
-    free(str);
-    if (err_info) {
+    sr_timeouttime_get(&timeout_ts, SR_RPC_ASYNC_LOCK_TIMEOUT);
+
+    /* MUTEX LOCK */
+    if ((r = pthread_mutex_clocklock(&conn->rpc_async.lock, COMPAT_CLOCK_ID, &timeout_ts))) {
+        SR_ERRINFO_LOCK(&err_info, __func__, r);
         goto cleanup;
     }
 
-    if (input_top != input_op) {
-        /* we need the OP parent to check it exists */
-        parent_path = lyd_path(lyd_parent(input_op), LYD_PATH_STD, NULL, 0);
-        SR_CHECK_MEM_GOTO(!parent_path, err_info, cleanup);
-        /* only reference to parent_path is stored, so it cannot be freed! */
-        if ((err_info = sr_modinfo_add(lyd_owner_module(input_top), parent_path, 0, 0, &mod_info))) {
-            goto cleanup;
+    if (!conn->rpc_async.tids) {
+        /* start the workers */
+        conn->rpc_async.tids = calloc(SR_RPC_ASYNC_WORKER_COUNT, sizeof *conn->rpc_async.tids);
+        SR_CHECK_MEM_GOTO(!conn->rpc_async.tids, err_info, cleanup_unlock);
+        for (conn->rpc_async.worker_count = 0; conn->rpc_async.worker_count < SR_RPC_ASYNC_WORKER_COUNT;
+                ++conn->rpc_async.worker_count) {
+            if ((r = pthread_create(&conn->rpc_async.tids[conn->rpc_async.worker_count], NULL, sr_rpc_async_thread, conn))) {
+                sr_errinfo_new(&err_info, SR_ERR_SYS, "Creating a new thread failed (%s).", strerror(r));
+                break;
+            }
         }
-        if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_DATA_CACHE | SR_MI_PERM_NO,
-                session->sid, session->orig_name, session->orig_data, SR_OPER_CB_TIMEOUT, 0, 0))) {
-            goto cleanup;
+        if (!conn->rpc_async.worker_count) {
+            free(conn->rpc_async.tids);
+            conn->rpc_async.tids = NULL;
+            goto cleanup_unlock;
         }
-    }
 
-    if (LYD_CTX(input_top) != LYD_CTX(input_op)) {
-        /* different contexts if these are data of an extension (schema-mount) */
-        for (ext_parent = input_op; ext_parent && !(ext_parent->flags & LYD_EXT); ext_parent = lyd_parent(ext_parent)) {}
-        SR_CHECK_INT_GOTO(!ext_parent, err_info, cleanup);
+        /* some workers were started, enough to send the requests */
+        sr_errinfo_free(&err_info);
+    }
 
-        err_info = _sr_rpc_ext_send_tree(session, ext_parent, &mod_info, path, input_top, input_op, timeout_ms, output);
+    /* enqueue the request */
+    req->request_id = ++conn->rpc_async.request_id;
+    if (conn->rpc_async.last) {
+        conn->rpc_async.last->next = req;
     } else {
-        err_info = _sr_rpc_send_tree(session, &mod_info, path, input_top, input_op, timeout_ms, output);
+        conn->rpc_async.first = req;
     }
+    conn->rpc_async.last = req;
+    ++session->rpc_async_count;
+    if (request_id) {
+        *request_id = req->request_id;
+    }
+    req = NULL;
 
-cleanup:
-    /* MODULES UNLOCK */
-    sr_shmmod_modinfo_unlock(&mod_info);
+    /* wake up a worker */
+    sr_cond_broadcast(&conn->rpc_async.cond);
 
-    free(parent_path);
-    free(path);
-    sr_modinfo_erase(&mod_info);
+cleanup_unlock:
+    /* MUTEX UNLOCK */
+    pthread_mutex_unlock(&conn->rpc_async.lock);
+
+cleanup:
+    if (req) {
+        sr_release_data(req->input);
+        free(req);
+    }
     return sr_api_ret(session, err_info);
 }
 
@@ -6218,6 +8969,11 @@ _sr_notif_subscribe(sr_session_ctx_t *session, const char *mod_name, const char
             (!callback && !tree_callback) || !subscription, session, err_info);
     conn = session->conn;
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(conn, xpath, mod_name))) {
+        return sr_api_ret(session, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(session, err_info);
@@ -6285,7 +9041,7 @@ _sr_notif_subscribe(sr_session_ctx_t *session, const char *mod_name, const char
 
     if (start_time || stop_time) {
         /* notify subscription there are already some events (replay needs to be performed) or stop time needs to be checked */
-        if ((err_info = sr_shmsub_notify_evpipe((*subscription)->evpipe_num))) {
+        if ((err_info = sr_shmsub_notify_evpipe((*subscription)->evpipe_num, SR_EVPIPE_EV_ANY))) {
             goto error2;
         }
     }
@@ -6340,6 +9096,11 @@ sr_notif_send(sr_session_ctx_t *session, const char *path, const sr_val_t *value
 
     SR_CHECK_ARG_APIRET(!session || !path, session, err_info);
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(session->conn, path, NULL))) {
+        return sr_api_ret(session, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(session->conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(session, err_info);
@@ -6371,137 +9132,256 @@ cleanup:
     return ret ? ret : sr_api_ret(session, err_info);
 }
 
-API int
-sr_notif_send_tree(sr_session_ctx_t *session, struct lyd_node *notif, uint32_t timeout_ms, int wait)
+/**
+ * @brief Validate notifications to be sent, with all the data they depend on.
+ *
+ * @param[in] session Session to use.
+ * @param[in] notifs Array of notification data trees.
+ * @param[in] notif_tops Array of top-level nodes of @p notifs.
+ * @param[in] notif_count Count of @p notifs.
+ * @param[in,out] mod_info Empty mod info to use, is READ locked on success.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_notif_send_validate(sr_session_ctx_t *session, struct lyd_node **notifs, struct lyd_node **notif_tops,
+        uint32_t notif_count, struct sr_mod_info_s *mod_info)
 {
-    sr_error_info_t *err_info = NULL, *tmp_err = NULL;
-    struct sr_mod_info_s mod_info;
-    struct lyd_node *notif_top, *notif_op, *parent;
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *notif_op, *parent;
     sr_dep_t *shm_deps;
-    sr_mod_t *shm_mod;
-    struct timespec notif_ts;
     uint16_t shm_dep_count;
-    char *parent_path = NULL;
+    char *parent_path;
+    uint32_t i;
+    int has_parent = 0;
 
-    SR_CHECK_ARG_APIRET(!session || !notif, session, err_info);
+    for (i = 0; i < notif_count; ++i) {
+        notif_op = notifs[i];
+        if ((err_info = sr_ly_find_last_parent(&notif_op, LYS_NOTIF))) {
+            return err_info;
+        }
 
-    for (notif_top = notif; notif_top->parent; notif_top = lyd_parent(notif_top)) {}
-    if (session->conn->ly_ctx != LYD_CTX(notif_top)) {
-        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Data trees must be created using the session connection libyang context.");
-        return sr_api_ret(session, err_info);
+        if (notif_tops[i] != notif_op) {
+            /* we need the OP parent to check it exists */
+            parent_path = lyd_path(lyd_parent(notif_op), LYD_PATH_STD, NULL, 0);
+            SR_CHECK_MEM_RET(!parent_path, err_info);
+            err_info = sr_modinfo_add(lyd_owner_module(notif_tops[i]), parent_path, 1, 0, mod_info);
+            free(parent_path);
+            if (err_info) {
+                return err_info;
+            }
+            has_parent = 1;
+        }
     }
 
-    if (!timeout_ms) {
-        timeout_ms = SR_NOTIF_CB_TIMEOUT;
+    if (has_parent) {
+        /* load the OP parents of all the notifications at once */
+        if ((err_info = sr_modinfo_consolidate(mod_info, 0, SR_LOCK_READ, SR_MI_DATA_CACHE | SR_MI_PERM_NO,
+                session->sid, session->orig_name, session->orig_data, SR_OPER_CB_TIMEOUT, 0, 0))) {
+            return err_info;
+        }
     }
-    SR_MODINFO_INIT(mod_info, session->conn, SR_DS_OPERATIONAL, SR_DS_RUNNING);
 
-    /* remember when the notification was generated */
-    sr_realtime_get(&notif_ts);
+    /* collect all required modules for OP validation of all the notifications */
+    for (i = 0; i < notif_count; ++i) {
+        notif_op = notifs[i];
+        if ((err_info = sr_ly_find_last_parent(&notif_op, LYS_NOTIF))) {
+            return err_info;
+        }
+
+        if (LYD_CTX(notif_tops[i]) != LYD_CTX(notif_op)) {
+            /* different contexts if these are data of an extension (schema-mount) */
+            for (parent = notif_op; parent && !(parent->flags & LYD_EXT); parent = lyd_parent(parent)) {}
+            SR_CHECK_INT_RET(!parent, err_info);
 
-    /* check notif data tree */
-    notif_op = NULL;
-    if (notif->schema) {
-        switch (notif->schema->nodetype) {
-        case LYS_NOTIF:
-            notif_op = notif;
-            break;
-        case LYS_CONTAINER:
-        case LYS_LIST:
-            /* find the notification */
-            notif_op = notif;
-            if ((err_info = sr_ly_find_last_parent(&notif_op, LYS_NOTIF))) {
-                goto cleanup;
+            /* collect all mounted data and data mentioned in the parent-references */
+            if ((err_info = sr_modinfo_collect_ext_deps(lyd_parent(parent)->schema, mod_info))) {
+                return err_info;
             }
-            if (notif_op->schema->nodetype != LYS_NOTIF) {
-                notif_op = NULL;
+        } else {
+            if ((err_info = sr_shmmod_get_notif_deps(SR_CONN_MOD_SHM(session->conn), lyd_owner_module(notif_tops[i]),
+                    notif_op, &shm_deps, &shm_dep_count))) {
+                return err_info;
+            }
+            if ((err_info = sr_shmmod_collect_deps(SR_CONN_MOD_SHM(session->conn), shm_deps, shm_dep_count, notif_tops[i],
+                    NULL, 0, mod_info))) {
+                return err_info;
             }
-            break;
-        default:
-            break;
         }
     }
-    if (!notif_op) {
-        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Provided tree is not a valid notification invocation.");
-        goto cleanup;
-    }
 
-    /* check write/read perm */
-    shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(session->conn), lyd_owner_module(notif_top)->name);
-    SR_CHECK_INT_GOTO(!shm_mod, err_info, cleanup);
-    if ((err_info = sr_perm_check(session->conn, lyd_owner_module(notif_top), SR_DS_STARTUP, shm_mod->replay_supp, NULL))) {
-        goto cleanup;
+    /* no data are loaded nor modules locked if there are no dependencies */
+    if ((err_info = sr_modinfo_consolidate(mod_info, 0, SR_LOCK_READ, SR_MI_NEW_DEPS | SR_MI_DATA_CACHE | SR_MI_PERM_NO,
+            session->sid, session->orig_name, session->orig_data, SR_OPER_CB_TIMEOUT, 0, 0))) {
+        return err_info;
     }
 
-    if (notif_top != notif_op) {
-        /* we need the OP parent to check it exists */
-        parent_path = lyd_path(lyd_parent(notif_op), LYD_PATH_STD, NULL, 0);
-        SR_CHECK_MEM_GOTO(!parent_path, err_info, cleanup);
-        if ((err_info = sr_modinfo_add(lyd_owner_module(notif_top), parent_path, 0, 0, &mod_info))) {
-            goto cleanup;
+    /* validate the operations */
+    for (i = 0; i < notif_count; ++i) {
+        notif_op = notifs[i];
+        if ((err_info = sr_ly_find_last_parent(&notif_op, LYS_NOTIF))) {
+            return err_info;
         }
-        if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_DATA_CACHE | SR_MI_PERM_NO,
-                session->sid, session->orig_name, session->orig_data, SR_OPER_CB_TIMEOUT, 0, 0))) {
-            goto cleanup;
+        if ((err_info = sr_modinfo_op_validate(mod_info, notif_op, 0))) {
+            return err_info;
         }
     }
 
-    /* collect all required modules for OP validation */
-    if (LYD_CTX(notif_top) != LYD_CTX(notif_op)) {
-        /* different contexts if these are data of an extension (schema-mount) */
-        for (parent = notif_op; parent && !(parent->flags & LYD_EXT); parent = lyd_parent(parent)) {}
-        SR_CHECK_INT_GOTO(!parent, err_info, cleanup);
+    return NULL;
+}
+
+API int
+sr_notif_send_tree(sr_session_ctx_t *session, struct lyd_node *notif, uint32_t timeout_ms, int wait)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!session || !notif, session, err_info);
+
+    /* API function */
+    return sr_notif_send_batch(session, &notif, 1, timeout_ms, wait);
+}
 
-        /* collect all mounted data and data mentioned in the parent-references */
-        if ((err_info = sr_modinfo_collect_ext_deps(lyd_parent(parent)->schema, &mod_info))) {
+API int
+sr_notif_send_batch(sr_session_ctx_t *session, struct lyd_node **notifs, uint32_t notif_count, uint32_t timeout_ms,
+        int wait)
+{
+    sr_error_info_t *err_info = NULL, *tmp_err = NULL;
+    struct sr_mod_info_s mod_info;
+    struct lyd_node **notif_tops = NULL, **mod_notifs = NULL, *notif_op;
+    sr_mod_t *shm_mod;
+    struct timespec *notif_ts = NULL, *mod_notif_ts = NULL;
+    uint32_t i, j, mod_notif_count;
+
+    SR_CHECK_ARG_APIRET(!session || !notifs || !notif_count, session, err_info);
+    for (i = 0; i < notif_count; ++i) {
+        SR_CHECK_ARG_APIRET(!notifs[i], session, err_info);
+    }
+
+    if (!timeout_ms) {
+        timeout_ms = SR_NOTIF_CB_TIMEOUT;
+    }
+    SR_MODINFO_INIT(mod_info, session->conn, SR_DS_OPERATIONAL, SR_DS_RUNNING);
+
+    notif_tops = malloc(notif_count * sizeof *notif_tops);
+    notif_ts = malloc(notif_count * sizeof *notif_ts);
+    mod_notifs = malloc(notif_count * sizeof *mod_notifs);
+    mod_notif_ts = malloc(notif_count * sizeof *mod_notif_ts);
+    SR_CHECK_MEM_GOTO(!notif_tops || !notif_ts || !mod_notifs || !mod_notif_ts, err_info, cleanup);
+
+    for (i = 0; i < notif_count; ++i) {
+        for (notif_tops[i] = notifs[i]; notif_tops[i]->parent; notif_tops[i] = lyd_parent(notif_tops[i])) {}
+        if (session->conn->ly_ctx != LYD_CTX(notif_tops[i])) {
+            sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG,
+                    "Data trees must be created using the session connection libyang context.");
             goto cleanup;
         }
-    } else {
-        if ((err_info = sr_shmmod_get_notif_deps(SR_CONN_MOD_SHM(session->conn), lyd_owner_module(notif_top), notif_op,
-                &shm_deps, &shm_dep_count))) {
+
+        /* remember when the notification was generated */
+        sr_realtime_get(&notif_ts[i]);
+
+        /* check notif data tree */
+        notif_op = NULL;
+        if (notifs[i]->schema) {
+            switch (notifs[i]->schema->nodetype) {
+            case LYS_NOTIF:
+                notif_op = notifs[i];
+                break;
+            case LYS_CONTAINER:
+            case LYS_LIST:
+                /* find the notification */
+                notif_op = notifs[i];
+                if ((err_info = sr_ly_find_last_parent(&notif_op, LYS_NOTIF))) {
+                    goto cleanup;
+                }
+                if (notif_op->schema->nodetype != LYS_NOTIF) {
+                    notif_op = NULL;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        if (!notif_op) {
+            sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, "Provided tree is not a valid notification invocation.");
             goto cleanup;
         }
-        if ((err_info = sr_shmmod_collect_deps(SR_CONN_MOD_SHM(session->conn), shm_deps, shm_dep_count, notif_top, &mod_info))) {
+
+        /* check write/read perm */
+        shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(session->conn), lyd_owner_module(notif_tops[i])->name);
+        SR_CHECK_INT_GOTO(!shm_mod, err_info, cleanup);
+        if ((err_info = sr_perm_check(session->conn, lyd_owner_module(notif_tops[i]), SR_DS_STARTUP, shm_mod->replay_supp,
+                NULL))) {
             goto cleanup;
         }
     }
-    if ((err_info = sr_modinfo_consolidate(&mod_info, 0, SR_LOCK_READ, SR_MI_NEW_DEPS | SR_MI_DATA_CACHE | SR_MI_PERM_NO,
-            session->sid, session->orig_name, session->orig_data, SR_OPER_CB_TIMEOUT, 0, 0))) {
-        goto cleanup;
+
+    if (!(session->conn->opts & SR_CONN_NO_OP_VALIDATE)) {
+        /* validate the notifications */
+        if ((err_info = sr_notif_send_validate(session, notifs, notif_tops, notif_count, &mod_info))) {
+            goto cleanup;
+        }
+
+        /* MODULES UNLOCK */
+        sr_shmmod_modinfo_unlock(&mod_info);
     }
 
-    /* validate the operation */
-    if ((err_info = sr_modinfo_op_validate(&mod_info, notif_op, 0))) {
-        goto cleanup;
+    /* store the notifications for a replay, we continue on failure */
+    for (i = 0; i < notif_count; ++i) {
+        if ((tmp_err = sr_replay_store(session, notif_tops[i], notif_ts[i]))) {
+            sr_errinfo_merge(&err_info, tmp_err);
+            tmp_err = NULL;
+        }
     }
 
-    /* MODULES UNLOCK */
-    sr_shmmod_modinfo_unlock(&mod_info);
+    /* publish the notifications of each module at once */
+    for (i = 0; i < notif_count; ++i) {
+        for (j = 0; j < i; ++j) {
+            if (lyd_owner_module(notif_tops[j]) == lyd_owner_module(notif_tops[i])) {
+                break;
+            }
+        }
+        if (j < i) {
+            /* module already published */
+            continue;
+        }
 
-    /* store the notification for a replay, we continue on failure */
-    err_info = sr_replay_store(session, notif_top, notif_ts);
+        mod_notif_count = 0;
+        for (j = i; j < notif_count; ++j) {
+            if (lyd_owner_module(notif_tops[j]) == lyd_owner_module(notif_tops[i])) {
+                mod_notifs[mod_notif_count] = notif_tops[j];
+                mod_notif_ts[mod_notif_count] = notif_ts[j];
+                ++mod_notif_count;
+            }
+        }
 
-    /* NOTIF SUB READ LOCK */
-    if ((tmp_err = sr_rwlock(&shm_mod->notif_lock, SR_SHMEXT_SUB_LOCK_TIMEOUT, SR_LOCK_READ, session->conn->cid, __func__,
-            NULL, NULL))) {
-        goto cleanup;
-    }
+        shm_mod = sr_shmmod_find_module(SR_CONN_MOD_SHM(session->conn), lyd_owner_module(notif_tops[i])->name);
+        SR_CHECK_INT_GOTO(!shm_mod, tmp_err, cleanup);
 
-    /* publish notif in an event */
-    if ((tmp_err = sr_shmsub_notif_notify(session->conn, notif_top, notif_ts, session->orig_name, session->orig_data,
-            timeout_ms, wait))) {
-        goto cleanup_notifsub_unlock;
-    }
+        /* NOTIF SUB READ LOCK */
+        if ((tmp_err = sr_rwlock(&shm_mod->notif_lock, SR_SHMEXT_SUB_LOCK_TIMEOUT, SR_LOCK_READ, session->conn->cid,
+                __func__, NULL, NULL))) {
+            goto cleanup;
+        }
+
+        /* publish notifs in events */
+        tmp_err = sr_shmsub_notif_notify(session->conn, mod_notifs, mod_notif_ts, mod_notif_count, session->orig_name,
+                session->orig_data, timeout_ms, wait);
+
+        /* NOTIF SUB READ UNLOCK */
+        sr_rwunlock(&shm_mod->notif_lock, SR_SHMEXT_SUB_LOCK_TIMEOUT, SR_LOCK_READ, session->conn->cid, __func__);
 
-cleanup_notifsub_unlock:
-    /* NOTIF SUB READ UNLOCK */
-    sr_rwunlock(&shm_mod->notif_lock, SR_SHMEXT_SUB_LOCK_TIMEOUT, SR_LOCK_READ, session->conn->cid, __func__);
+        if (tmp_err) {
+            goto cleanup;
+        }
+    }
 
 cleanup:
     /* MODULES UNLOCK */
     sr_shmmod_modinfo_unlock(&mod_info);
 
-    free(parent_path);
+    free(notif_tops);
+    free(notif_ts);
+    free(mod_notifs);
+    free(mod_notif_ts);
     sr_modinfo_erase(&mod_info);
     if (tmp_err) {
         sr_errinfo_merge(&err_info, tmp_err);
@@ -6596,10 +9476,14 @@ sr_notif_sub_modify_xpath(sr_subscription_ctx_t *subscription, uint32_t sub_id,
     /* update xpath */
     free(notif_sub->xpath);
     notif_sub->xpath = NULL;
+    sr_xpath_filter_clear(&notif_sub->filter);
     if (xpath) {
         notif_sub->xpath = strdup(xpath);
         SR_CHECK_MEM_GOTO(!notif_sub->xpath, err_info, cleanup_unlock);
     }
+    if ((err_info = sr_xpath_filter_compile(xpath, &notif_sub->filter))) {
+        goto cleanup_unlock;
+    }
 
     /* create event session */
     if ((err_info = _sr_session_start(subscription->conn, SR_DS_OPERATIONAL, SR_SUB_EV_NOTIF, NULL, &ev_sess))) {
@@ -6675,7 +9559,7 @@ sr_notif_sub_modify_stop_time(sr_subscription_ctx_t *subscription, uint32_t sub_
     }
 
     /* generate a new event for the thread to wake up */
-    if ((err_info = sr_shmsub_notify_evpipe(subscription->evpipe_num))) {
+    if ((err_info = sr_shmsub_notify_evpipe(subscription->evpipe_num, SR_EVPIPE_EV_ANY))) {
         goto cleanup_unlock;
     }
 
@@ -6707,6 +9591,11 @@ sr_oper_get_subscribe(sr_session_ctx_t *session, const char *module_name, const
     /* only these options are relevant outside this function and will be stored */
     sub_opts = opts & SR_SUBSCR_OPER_MERGE;
 
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(conn, path, module_name))) {
+        return sr_api_ret(session, err_info);
+    }
+
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
         return sr_api_ret(session, err_info);
@@ -6819,7 +9708,12 @@ sr_oper_poll_subscribe(sr_session_ctx_t *session, const char *module_name, const
 
     conn = session->conn;
     /* only these options are relevant outside this function and will be stored */
-    sub_opts = opts & SR_SUBSCR_OPER_POLL_DIFF;
+    sub_opts = opts & (SR_SUBSCR_OPER_POLL_DIFF | SR_SUBSCR_OPER_POLL_SHARED);
+
+    /* load the modules into a lazy context */
+    if ((err_info = sr_lycc_lazy_load(conn, path, module_name))) {
+        return sr_api_ret(session, err_info);
+    }
 
     /* CONTEXT LOCK */
     if ((err_info = sr_lycc_lock(conn, SR_LOCK_READ, 0, __func__))) {
@@ -6894,7 +9788,7 @@ sr_oper_poll_subscribe(sr_session_ctx_t *session, const char *module_name, const
     }
 
     /* make sure the event handler updates its wake up period */
-    if ((err_info = sr_shmsub_notify_evpipe((*subscription)->evpipe_num))) {
+    if ((err_info = sr_shmsub_notify_evpipe((*subscription)->evpipe_num, SR_EVPIPE_EV_ANY))) {
         goto error4;
     }
 
@@ -104,6 +104,26 @@ sr_log_level_t sr_log_get_syslog(void);
  */
 void sr_log_set_cb(sr_log_cb log_callback);
 
+/**
+ * @brief Enables / disables asynchronous logging.
+ *
+ * When enabled, messages are only copied into a bounded in-process ring and a dedicated thread writes them
+ * to all the log outputs, including calling the logging callback. If the ring is full, the messages are dropped
+ * and the number of dropped messages is logged once there is space again. Disabling it writes all the queued
+ * messages first. The queued messages are also written on process exit.
+ *
+ * @param[in] enable Whether to enable or disable asynchronous logging.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_log_async(int enable);
+
+/**
+ * @brief Learn the number of messages dropped by asynchronous logging since it was last enabled.
+ *
+ * @return Number of dropped messages.
+ */
+uint32_t sr_log_async_dropped(void);
+
 /** @} logging */
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -121,6 +141,9 @@ void sr_log_set_cb(sr_log_cb log_callback);
  * @note Do not use `fork(2)` after creating a connection. Sysrepo internally stores the connection
  * ID of every connection. Forking will duplicate the connection and ID resulting in a mismatch.
  *
+ * @note If `SIGPIPE` has the default disposition, it is ignored by the process from the first connection on,
+ * sysrepo writes into event pipes whose readers may be gone.
+ *
  * @param[in] opts Connection options.
  * @param[out] conn Created connection.
  * @return Error code (::SR_ERR_OK on success).
@@ -201,6 +224,34 @@ uint32_t sr_get_content_id(sr_conn_ctx_t *conn);
  */
 int sr_get_plugins(sr_conn_ctx_t *conn, const char ***ds_plugins, const char ***ntf_plugins);
 
+/**
+ * @brief Get memory usage and fragmentation statistics of ext SHM, which stores all the subscriptions.
+ *
+ * @param[in] conn Connection to use.
+ * @param[out] stats Ext SHM statistics.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_get_ext_shm_stats(sr_conn_ctx_t *conn, sr_ext_shm_stats_t *stats);
+
+/**
+ * @brief Get memory usage of all the SHM segments, per module and per connection.
+ *
+ * Mapped memory of the connections is the size of main, mod, and ext SHM together with all the subscription
+ * SHM files they have subscriptions in.
+ *
+ * @param[in] conn Connection to use.
+ * @param[out] stats SHM statistics, free with ::sr_free_shm_stats().
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_get_shm_stats(sr_conn_ctx_t *conn, sr_shm_stats_t **stats);
+
+/**
+ * @brief Free SHM statistics.
+ *
+ * @param[in] stats SHM statistics to free.
+ */
+void sr_free_shm_stats(sr_shm_stats_t *stats);
+
 /**
  * @brief Get the sysrepo SUPERUSER UID.
  *
@@ -224,6 +275,21 @@ uid_t sr_get_su_uid(void);
  */
 int sr_discard_oper_changes(sr_conn_ctx_t *conn, sr_session_ctx_t *session, const char *xpath, uint32_t timeout_ms);
 
+/**
+ * @brief Fill the caches of a connection with the current data of modules so that the first requests for them
+ * do not have to load the data and wait for the cache locks. Can be called from any thread, for example right after
+ * the connection is created, while other requests are already being processed.
+ *
+ * Required READ access, modules without it are skipped if loading all the modules.
+ *
+ * @param[in] conn Connection to use, with the caches selected by @p opts enabled.
+ * @param[in] module_names Names of the modules to load, NULL for all the modules with data.
+ * @param[in] module_count Count of @p module_names.
+ * @param[in] opts Bitwise OR-ed ::sr_prefetch_flag_t selecting the caches to fill.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_conn_prefetch(sr_conn_ctx_t *conn, const char **module_names, uint32_t module_count, sr_prefetch_options_t opts);
+
 /**
  * @brief Start a new session.
  *
@@ -235,6 +301,20 @@ int sr_discard_oper_changes(sr_conn_ctx_t *conn, sr_session_ctx_t *session, cons
  */
 int sr_session_start(sr_conn_ctx_t *conn, const sr_datastore_t datastore, sr_session_ctx_t **session);
 
+/**
+ * @brief Reset a session into the state of a newly started one, without freeing and allocating it again. Useful for
+ * keeping a pool of sessions that are used for a single request each.
+ *
+ * Frees all the subscriptions created (only) by this session, stops notification buffering, releases any locks held,
+ * discards all the prepared changes, and clears the NACM user, originator, commit priority, and the last error.
+ * The session gets a new session ID. Its (system) user is kept.
+ *
+ * @param[in] session Session (not [DS](@ref sr_datastore_t)-specific) to reset, not a callback session.
+ * @param[in] datastore Datastore on which to operate.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_session_reset(sr_session_ctx_t *session, const sr_datastore_t datastore);
+
 /**
  * @brief Stop the session and releases resources tied to it.
  *
@@ -341,6 +421,23 @@ void sr_session_del_orig_data(sr_session_ctx_t *session);
  */
 int sr_session_get_orig_data(sr_session_ctx_t *session, uint32_t idx, uint32_t *size, const void **data);
 
+/**
+ * @brief Get hints of the request in an operational get callback (::sr_oper_get_items_cb) about the data that
+ * are actually needed. The provider may skip generating any other data, they would be thrown away.
+ *
+ * The hints are set only if the request XPath is a plain path with no predicates so that the data selected by it
+ * are exactly the instances the provider generates, the limit also only if no NACM filtering is performed.
+ *
+ * @param[in] session Implicit session provided in an operational get callback.
+ * @param[out] max_depth Optional maximum depth of the subtrees selected by the request XPath, 0 for unlimited.
+ * @param[out] limit Optional maximum number of the subtrees selected by the request XPath (such as list instances),
+ * 0 for unlimited. Requests currently always retrieve all the selected subtrees, even ::sr_get_data_iter().
+ * @param[out] opts Optional get oper data options of the request, namely any of the `SR_OPER_NO_*` flags.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_session_get_oper_hints(sr_session_ctx_t *session, uint32_t *max_depth, uint32_t *limit,
+        sr_get_oper_flag_t *opts);
+
 /**
  * @brief Retrieve information about the error that has occurred
  * during the last operation executed within provided session.
@@ -450,6 +547,18 @@ const char *sr_session_get_user(sr_session_ctx_t *session);
  */
 sr_conn_ctx_t *sr_session_get_connection(sr_session_ctx_t *session);
 
+/**
+ * @brief Set the priority of the changes applied by a session. When several commits wait for the same modules,
+ * the ones with the highest priority are admitted first, for example to let interactive operator changes precede
+ * bulk automation. Readers of the data are not affected. Commits of the same priority are admitted in no
+ * particular order.
+ *
+ * @param[in] session Session (not [DS](@ref sr_datastore_t)-specific) to change.
+ * @param[in] priority Commit priority from 0 (default) up to ::SR_COMMIT_PRIO_MAX.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_session_set_commit_priority(sr_session_ctx_t *session, uint32_t priority);
+
 /** @} connsess */
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -589,6 +698,24 @@ int sr_update_module(sr_conn_ctx_t *conn, const char *schema_path, const char *s
  */
 int sr_update_modules(sr_conn_ctx_t *conn, const char **schema_paths, const char *search_dirs);
 
+/**
+ * @brief Perform a set of module changes in a single context change.
+ *
+ * All the modules are installed, removed, updated, and their features changed together so that the context
+ * is compiled, data migrated, and the module SHM rebuilt only once instead of once per ::sr_install_modules2(),
+ * ::sr_remove_modules(), ::sr_update_modules(), and ::sr_enable_module_feature() call. Replay support changes
+ * are applied afterwards while the context is still locked. A module may only be the subject of one of the
+ * remove, update, or feature change.
+ *
+ * Required WRITE access.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] changes Set of the changes to perform.
+ * @param[in] search_dirs Optional search directories for import schemas, supports the format `<dir>[:<dir>]*`.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_change_modules(sr_conn_ctx_t *conn, const sr_module_change_set_t *changes, const char *search_dirs);
+
 /**
  * @brief Change module replay support.
  *
@@ -745,12 +872,29 @@ int sr_get_item(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms
  * @param[in] timeout_ms Operational callback timeout in milliseconds. If 0, default is used.
  * @param[in] opts Options overriding default get behaviour.
  * @param[out] values Array of requested nodes, if any, allocated dynamically (free using ::sr_free_values).
+ * With ::SR_GET_READ_ONLY, the array and all its strings are a single allocation.
  * @param[out] value_cnt Number of returned elements in the values array.
  * @return Error code (::SR_ERR_OK on success).
  */
 int sr_get_items(sr_session_ctx_t *session, const char *xpath, uint32_t timeout_ms, const sr_get_options_t opts,
         sr_val_t **values, size_t *value_cnt);
 
+/**
+ * @brief Check whether any data elements selected by the provided XPath exist.
+ *
+ * Cheaper alternative to ::sr_get_item or ::sr_get_items when only the existence of data is of interest.
+ * No values are created and no error is generated nor logged if there are none.
+ *
+ * Required READ access, but if the access check fails, the module data are simply ignored without an error.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in] xpath [XPath](@ref paths) of the data elements to check.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds. If 0, default is used.
+ * @param[in] opts Options overriding default get behaviour.
+ * @return Error code (::SR_ERR_OK if some data exist, ::SR_ERR_NOT_FOUND if no nodes match the XPath).
+ */
+int sr_item_exists(sr_session_ctx_t *session, const char *xpath, uint32_t timeout_ms, const sr_get_options_t opts);
+
 /**
  * @brief Acquire libyang data tree together with its context lock in a SR data structure.
  *
@@ -824,6 +968,72 @@ int sr_get_subtree(sr_session_ctx_t *session, const char *path, uint32_t timeout
 int sr_get_data(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, uint32_t timeout_ms,
         const sr_get_options_t opts, sr_data_t **data);
 
+/**
+ * @brief Retrieve data whose root nodes match the provided XPath printed in a format.
+ *
+ * Equivalent to ::sr_get_data followed by printing all the returned data trees. However, the data are not
+ * modified so they are retrieved as ::SR_GET_READ_ONLY and if they are shared with other read-only results,
+ * the printed data are shared as well so that repeated requests are not printed again until the data change.
+ *
+ * Required READ access, but if the access check fails, the module data are simply ignored without an error.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in] xpath [XPath](@ref paths) selecting root nodes of subtrees to be retrieved.
+ * @param[in] max_depth Maximum depth of the selected subtrees. 0 is unlimited, 1 will not return any
+ * descendant nodes. If a list should be returned, its keys are always returned as well.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds. If 0, default is used.
+ * @param[in] opts Options overriding default get behaviour.
+ * @param[in] format Format of the printed data, ::LYD_XML, ::LYD_JSON, or ::LYD_LYB.
+ * @param[in] print_opts libyang print options, all the data trees are always printed.
+ * @param[out] str Printed data, allocated dynamically (free using free()). NULL if no data found.
+ * @param[out] str_len Length of @p str, which may not be terminated for ::LYD_LYB.
+ * @return Error code (::SR_ERR_OK on success, ::SR_ERR_NOT_FOUND if xpath is invalid - no nodes will ever match it).
+ */
+int sr_get_data_serialized(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, uint32_t timeout_ms,
+        const sr_get_options_t opts, LYD_FORMAT format, uint32_t print_opts, char **str, size_t *str_len);
+
+/**
+ * @brief Create an iterator for retrieving data whose root nodes match the provided XPath in chunks.
+ * Data are represented as _libyang_ subtrees.
+ *
+ * Every chunk is the same as would be returned by ::sr_get_data() but includes at most @p chunk_size of
+ * the selected subtrees (such as instances of a large list) so only the data of a single chunk are
+ * duplicated at once. The data are retrieved and filtered only once, when creating the iterator, so all
+ * the chunks are consistent and any changes made meanwhile are not reflected. Similarly to ::sr_data_t,
+ * the iterator keeps the context locked until it is freed.
+ *
+ * @see ::sr_get_data_next for getting the chunks using this iterator.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to use, must exist while the iterator is used.
+ * @param[in] xpath [XPath](@ref paths) selecting root nodes of subtrees to be retrieved.
+ * @param[in] chunk_size Maximum number of selected subtrees returned in a single chunk, must not be 0.
+ * @param[in] max_depth Maximum depth of the selected subtrees. 0 is unlimited, 1 will not return any
+ * descendant nodes. If a list should be returned, its keys are always returned as well.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds. If 0, default is used.
+ * @param[in] opts Options overriding default get behaviour.
+ * @param[out] iter Iterator context that can be used to retrieve the chunks using ::sr_get_data_next calls.
+ * Allocated by the function, should be freed with ::sr_free_data_iter.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_get_data_iter(sr_session_ctx_t *session, const char *xpath, uint32_t chunk_size, uint32_t max_depth,
+        uint32_t timeout_ms, const sr_get_options_t opts, sr_data_iter_t **iter);
+
+/**
+ * @brief Return the next chunk of data from the provided iterator created by ::sr_get_data_iter call.
+ *
+ * @param[in,out] iter Iterator acquired with ::sr_get_data_iter call.
+ * @param[out] data SR data with connected top-level data trees of the next chunk of the requested data.
+ * @return Error code (::SR_ERR_OK on success, ::SR_ERR_NOT_FOUND on no more data).
+ */
+int sr_get_data_next(sr_data_iter_t *iter, sr_data_t **data);
+
+/**
+ * @brief Frees ::sr_data_iter_t iterator and all memory allocated within it.
+ *
+ * @param[in] iter Iterator to be freed.
+ */
+void sr_free_data_iter(sr_data_iter_t *iter);
+
 /**
  * @brief Retrieve a single value matching the provided XPath.
  * Data are represented as a single _libyang_ node.
@@ -989,6 +1199,59 @@ int sr_move_item(sr_session_ctx_t *session, const char *path, const sr_move_posi
  */
 int sr_edit_batch(sr_session_ctx_t *session, const struct lyd_node *edit, const char *default_operation);
 
+/**
+ * @brief Create an edit builder for efficiently creating large edits. Unlike ::sr_set_item_str(), no operations
+ * are set on the individual nodes and the nodes are not checked for conflicting operations so adding a node
+ * costs only creating it. The resulting edit is provided the same way as by ::sr_edit_batch().
+ *
+ * The connection context cannot change until the builder is applied or freed. For connections with
+ * ::SR_CONN_LAZY_CTX, the modules of the added nodes must already be loaded.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to use.
+ * @param[out] builder Created edit builder.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_edit_builder_new(sr_session_ctx_t *session, sr_edit_builder_t **builder);
+
+/**
+ * @brief Set the parent node of the nodes added to an edit builder. It is created if it does not exist.
+ *
+ * @param[in] builder Edit builder to use.
+ * @param[in] path [Path](@ref paths) identifying the parent, NULL for top-level nodes.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_edit_builder_set_parent(sr_edit_builder_t *builder, const char *path);
+
+/**
+ * @brief Add a node into an edit builder. Any missing parents are created as well, an existing leaf has
+ * its value updated.
+ *
+ * @param[in] builder Edit builder to use.
+ * @param[in] path [Path](@ref paths) identifying the node, relative to the parent set by
+ * ::sr_edit_builder_set_parent() if any.
+ * @param[in] value String representation of the value set, NULL for non-terminal nodes.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_edit_builder_add(sr_edit_builder_t *builder, const char *path, const char *value);
+
+/**
+ * @brief Provide the built edit to be applied and free the edit builder, behaves the same as ::sr_edit_batch().
+ * These changes are applied only after calling ::sr_apply_changes().
+ *
+ * @param[in] builder Edit builder to use, is freed even on error.
+ * @param[in] default_operation Default operation for all the nodes. Possible values are `merge`, `replace`,
+ * or `none` (see [NETCONF RFC](https://tools.ietf.org/html/rfc6241#page-39)).
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_edit_builder_apply(sr_edit_builder_t *builder, const char *default_operation);
+
+/**
+ * @brief Free an edit builder and the built edit without applying it.
+ *
+ * @param[in] builder Edit builder to free.
+ */
+void sr_edit_builder_free(sr_edit_builder_t *builder);
+
 /**
  * @brief Perform the validation a datastore and any changes made in the current session, but do not
  * apply nor discard them.
@@ -1020,6 +1283,69 @@ int sr_validate(sr_session_ctx_t *session, const char *module_name, uint32_t tim
  */
 int sr_apply_changes(sr_session_ctx_t *session, uint32_t timeout_ms);
 
+/**
+ * @brief Apply changes made in the current session asynchronously, coalesced with other changes of the session.
+ *
+ * The changes are moved from the session into its commit buffer and the function returns right away. All the changes
+ * buffered until the coalescing window elapses are applied together, by a session thread, in a single commit. So,
+ * each of the affected subscribers is notified and the datastore stored only once for the whole window. If the commit
+ * fails, all the coalesced changes are discarded and the error is returned by ::sr_apply_changes_wait() or reported
+ * to the callback set by ::sr_session_set_commit_cb().
+ *
+ * Changes of a different datastore are not coalesced with the buffered ones, which are committed first.
+ * Session originator and NACM user must not be changed while there are any buffered changes.
+ *
+ * Required WRITE access.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to apply changes of.
+ * @param[in] coalesce_ms Coalescing window in milliseconds, started by the first buffered changes. If 0, the changes
+ * are committed as soon as possible together with any other changes buffered meanwhile.
+ * @param[in] timeout_ms Change callback timeout in milliseconds. If 0, default is used. The longest timeout of
+ * all the coalesced changes is used for their commit.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_apply_changes_async(sr_session_ctx_t *session, uint32_t coalesce_ms, uint32_t timeout_ms);
+
+/**
+ * @brief Commit all the changes buffered by ::sr_apply_changes_async() right away and wait for them to be applied.
+ *
+ * @param[in] session Session to use.
+ * @return Error code of the first failed coalesced commit since the last call (::SR_ERR_OK on success).
+ */
+int sr_apply_changes_wait(sr_session_ctx_t *session);
+
+/**
+ * @brief Set a callback to be called after each commit of the changes applied by ::sr_apply_changes_async().
+ *
+ * Allows event-driven applications to learn about the result of the commits without waiting for them. The errors
+ * reported to the callback are not returned by ::sr_apply_changes_wait().
+ *
+ * @param[in] session Session to use.
+ * @param[in] callback Callback to call, NULL to unset it.
+ * @param[in] private_data Private context passed to the callback.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_session_set_commit_cb(sr_session_ctx_t *session, sr_commit_cb callback, void *private_data);
+
+/**
+ * @brief Update values of push operational leaves previously stored by this connection, directly in the stored data.
+ * Is performed directly on the session, ::sr_apply_changes() call is not required.
+ *
+ * Meant for frequently changing values, such as counters. The leaves must already be stored (with ::sr_set_item_str()
+ * and ::sr_apply_changes(), for example) and no other nodes are created. All the values are updated in a single
+ * operation, so each of the affected subscribers is notified and the data stored only once for all of them.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific - must be ::SR_DS_OPERATIONAL) to use.
+ * @param[in] paths Array of paths to the leaves to update.
+ * @param[in] values Array of the new values of the leaves at the same indices.
+ * @param[in] count Count of @p paths and @p values.
+ * @param[in] timeout_ms Change callback timeout in milliseconds. If 0, default is used.
+ * @return Error code (::SR_ERR_OK on success, ::SR_ERR_NOT_FOUND if some of the leaves is not stored by
+ * this connection).
+ */
+int sr_oper_push_delta(sr_session_ctx_t *session, const char **paths, const char **values, uint32_t count,
+        uint32_t timeout_ms);
+
 /**
  * @brief Learn whether there are any prepared non-applied changes in the session.
  *
@@ -1247,9 +1573,57 @@ int sr_subscription_thread_suspend(sr_subscription_ctx_t *subscription);
  */
 int sr_subscription_thread_resume(sr_subscription_ctx_t *subscription);
 
+/**
+ * @brief Set the number of worker threads of a subscription structure processing events of independent subscriptions
+ * in parallel. Change subscriptions of different modules, operational get subscriptions of different modules, and
+ * RPC/action subscriptions of different paths are independent and their callbacks may then be called concurrently.
+ * Events of a single module (RPC/action) are always processed in order by one thread at a time. These events are only
+ * handed to the workers by ::sr_subscription_process_events() (or the handler thread), which does not wait for them to
+ * be processed. Notifications and operational poll subscriptions are always processed by the calling thread.
+ *
+ * @param[in] subscription Subscription context to use.
+ * @param[in] worker_count Number of worker threads, 0 (default) to process all the events sequentially.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_subscription_set_workers(sr_subscription_ctx_t *subscription, uint32_t worker_count);
+
+/**
+ * @brief Set the number of worker threads of the shared event loop of a connection handling
+ * all the subscriptions created with ::SR_SUBSCR_SHARED_THREAD. Can be set only before the first
+ * such subscription is created, the default is 2.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] worker_count Number of worker threads, at least 1.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_set_shared_subscription_workers(sr_conn_ctx_t *conn, uint32_t worker_count);
+
+/**
+ * @brief Set CPU affinity, scheduling, stack size, and name of the threads of a kind that will be created
+ * by a connection. Threads already running are not affected.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] type Kind of the threads.
+ * @param[in] attr Thread attributes, copied. NULL to restore the defaults.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_conn_set_thread_attr(sr_conn_ctx_t *conn, sr_thread_type_t type, const sr_thread_attr_t *attr);
+
+/**
+ * @brief Change CPU affinity, scheduling, and name of the running handler thread and worker threads
+ * of a subscription structure. Stack size cannot be changed and is ignored.
+ *
+ * @param[in] subscription Subscription context with a handler thread, not using ::SR_SUBSCR_SHARED_THREAD.
+ * @param[in] attr Thread attributes to apply.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_subscription_set_thread_attr(sr_subscription_ctx_t *subscription, const sr_thread_attr_t *attr);
+
 /**
  * @brief Unsubscribe all the subscriptions in a subscription structure and free it.
  *
+ * Cannot be called from a callback of any subscription in @p subscription, ::SR_ERR_UNSUPPORTED is returned.
+ *
  * @note On ::SR_ERR_TIME_OUT the function should be retried and must eventually succeed.
  *
  * @param[in] subscription Subscription context to free.
@@ -1328,6 +1702,27 @@ int sr_module_change_subscribe(sr_session_ctx_t *session, const char *module_nam
         sr_module_change_cb callback, void *private_data, uint32_t priority, sr_subscr_options_t opts,
         sr_subscription_ctx_t **subscription);
 
+/**
+ * @brief Subscribe for changes made in many modules at once.
+ *
+ * Equivalent to calling ::sr_module_change_subscribe() for every subscription but the ext SHM is locked and
+ * extended only once for all of them and, with ::SR_SUBSCR_ENABLED, the current data of all the modules are
+ * loaded only once. Either all the subscriptions are added or none.
+ *
+ * Required WRITE access. If ::SR_SUBSCR_PASSIVE is set, required READ access.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in] subs Array of subscriptions to add.
+ * @param[in] sub_count Count of @p subs.
+ * @param[in] opts Options overriding default behavior of all the subscriptions, it is supposed to be
+ * a bitwise OR-ed value of any ::sr_subscr_flag_t flags.
+ * @param[in,out] subscription Subscription context, zeroed for first subscription, freed by ::sr_unsubscribe.
+ * @param[out] sub_ids Optional array of at least @p sub_count items to be filled with the IDs of the subscriptions.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_module_change_subscribe_batch(sr_session_ctx_t *session, const sr_module_change_sub_t *subs, uint32_t sub_count,
+        sr_subscr_options_t opts, sr_subscription_ctx_t **subscription, uint32_t *sub_ids);
+
 /**
  * @brief Get information about an existing change subscription.
  *
@@ -1523,6 +1918,29 @@ int sr_rpc_send(sr_session_ctx_t *session, const char *path, const sr_val_t *inp
  */
 int sr_rpc_send_tree(sr_session_ctx_t *session, struct lyd_node *input, uint32_t timeout_ms, sr_data_t **output);
 
+/**
+ * @brief Send an RPC/action asynchronously, without waiting for the result. Data are represented as _libyang_ subtrees.
+ *
+ * The input is copied and the request queued, it is sent by one of the connection worker threads and the result
+ * is reported to @p callback. Several requests, even of the same session, are sent in parallel so their results
+ * may be reported in a different order. Stopping the session waits for all its requests to finish so it must not be
+ * done from @p callback.
+ *
+ * Required READ access.
+ *
+ * @note RPC/action must be valid in (is validated against) the [operational datastore](@ref oper_ds) context.
+ *
+ * @param[in] session Session (not [DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in] input Input data tree in @p session connection _libyang_ context.
+ * @param[in] timeout_ms RPC/action callback timeout in milliseconds. If 0, default is used.
+ * @param[in] callback Callback to call with the result.
+ * @param[in] private_data Private context passed to the callback.
+ * @param[out] request_id Optional ID of the request, unique for the connection.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_rpc_send_tree_async(sr_session_ctx_t *session, struct lyd_node *input, uint32_t timeout_ms,
+        sr_rpc_async_cb callback, void *private_data, uint32_t *request_id);
+
 /** @} rpcsubs */
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1618,6 +2036,28 @@ int sr_notif_send(sr_session_ctx_t *session, const char *path, const sr_val_t *v
  */
 int sr_notif_send_tree(sr_session_ctx_t *session, struct lyd_node *notif, uint32_t timeout_ms, int wait);
 
+/**
+ * @brief Send several notifications at once. Data are represented as _libyang_ subtrees. All the notifications
+ * are validated together and the subscribers of each module are notified only once about all of them, which
+ * is considerably faster than sending them one by one. They are delivered to the standard notification callbacks.
+ *
+ * Required WRITE access. If the module does not support replay, required READ access.
+ *
+ * @note Notifications must be valid in (are validated against) the [operational datastore](@ref oper_ds) context.
+ *
+ * @param[in] session Session (not [DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in,out] notifs Array of notification data trees to send in @p session connection _libyang_ context,
+ * are validated. They may be notifications of several modules.
+ * @param[in] notif_count Count of @p notifs.
+ * @param[in] timeout_ms Notification callback timeout in milliseconds. If 0, default is used. Relevant only
+ * if @p wait is set.
+ * @param[in] wait Whether to wait until all (if any) notification callbacks were called (synchronous delivery)
+ * or just publish the notifications without waiting for their processing (asynchronous delivery).
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_notif_send_batch(sr_session_ctx_t *session, struct lyd_node **notifs, uint32_t notif_count, uint32_t timeout_ms,
+        int wait);
+
 /**
  * @brief Get information about an existing notification subscription.
  *
@@ -1705,7 +2145,9 @@ int sr_oper_get_subscribe(sr_session_ctx_t *session, const char *module_name, co
  * are used instead. Additionally, if @p opts include ::SR_SUBSCR_OPER_POLL_DIFF, any changes detected on cache data
  * refresh are reported to corresponding subscribers. For an operational get subscription, there can only be a
  * __single__ operational poll subscription with this flag. The first cache update is performed directly by this
- * function.
+ * function. Following updates are performed by the subscription shortly before @p valid_ms elapses so that readers
+ * always get valid cached data without waiting for the callback. With ::SR_SUBSCR_OPER_POLL_SHARED, the cached data
+ * are shared with all the connections so that a single callback call serves all the processes.
  *
  * Required READ access.
  *
@@ -1750,6 +2192,16 @@ int sr_oper_poll_subscribe(sr_session_ctx_t *session, const char *module_name, c
  */
 #define SRP_CLEANUP_CB  "sr_plugin_cleanup_cb"
 
+/**
+ * @brief Optional sysrepo-plugind plugin symbol with the plugins that must be initialized before this one.
+ *
+ * The symbol must be a NULL-terminated array of plugin names (`const char *sr_plugin_init_after[]`), with or without
+ * the file extension. Plugins that are not loaded are ignored. If any of the plugins fails to initialize, this plugin
+ * is not initialized either. Plugins without a dependency between them may be initialized concurrently, each with
+ * its own session.
+ */
+#define SRP_INIT_AFTER  "sr_plugin_init_after"
+
 /**
  * @brief Log a plugin error message with format arguments.
  *
@@ -105,7 +105,41 @@ typedef enum {
     SR_CONN_DEFAULT = 0x0,              /**< No special behaviour. */
     SR_CONN_CACHE_RUNNING = 0x1,        /**< Always cache running datastore data which makes mainly repeated retrieval
                                              of data much faster. Affects all sessions created on this connection. */
-    SR_CONN_CTX_SET_PRIV_PARSED = 0x2   /**< Use LY_CTX_SET_PRIV_PARSED option for the connection libyang context. */
+    SR_CONN_CTX_SET_PRIV_PARSED = 0x2,  /**< Use LY_CTX_SET_PRIV_PARSED option for the connection libyang context. */
+    SR_CONN_LAZY_CTX = 0x4,             /**< Load only the internal modules into the connection libyang context. Other
+                                             modules, with all the modules they depend on or that depend on them, are
+                                             loaded once a session of this connection references them in an XPath or
+                                             by name, functions working with all the modules load all of them. Changes
+                                             of the installed modules always use the full context. New modules cannot
+                                             be loaded while any session of the connection has prepared changes
+                                             because they would have to be recreated in the new context, the function
+                                             referencing the modules fails then. Reference all the modules before
+                                             preparing any changes, for example by reading their data. */
+    SR_CONN_CACHE_OPER_PUSH = 0x8,      /**< Cache the stored (pushed) operational data of all the connections with
+                                             their owners so that they are reloaded only after they change and data of
+                                             dead connections are dropped only once. Makes mainly repeated retrieval
+                                             of operational data much faster. */
+    SR_CONN_ASYNC_DONE = 0x10,          /**< Publish the ::SR_EV_DONE event of the changes applied on this connection
+                                             to all the subscribers of a module at once, regardless of their priority,
+                                             and do not wait for them to process it. Any following event of the module
+                                             is delivered only after all the subscribers have finished processing it. */
+    SR_CONN_NO_OP_VALIDATE = 0x20,      /**< Trust the notifications and RPC/action input sent on this connection and
+                                             do not validate them so that no data of the modules they depend on are
+                                             loaded and locked. They are sent exactly as created, without any default
+                                             values. RPCs/actions in schema-mount data are still validated. */
+    SR_CONN_CACHE_OPER_VIEW = 0x40,     /**< Cache the operational view of every module, its enabled running data merged
+                                             with the stored (pushed) operational data, until the running data, stored
+                                             operational data, or running change subscriptions of the module change.
+                                             Makes mainly repeated retrieval of mostly-static operational data much
+                                             faster, data of operational get subscriptions are still retrieved for
+                                             every request. */
+    SR_CONN_CHANGE_LOG = 0x80           /**< Publish the changes applied on this connection to the change subscribers
+                                             of conventional datastores as a compact change log instead of a diff data
+                                             tree. ::sr_get_change_next() iterates over it directly if all the changes
+                                             or all the changes of a module are selected, the diff is built by the
+                                             subscribers only if needed, such as for subscriptions with an XPath filter
+                                             or for ::sr_get_change_tree_next(). Diffs with opaque, anydata, or
+                                             duplicate-instance nodes are still published as a diff. */
 } sr_conn_flag_t;
 
 /**
@@ -114,6 +148,21 @@ typedef enum {
  */
 typedef uint32_t sr_conn_options_t;
 
+/**
+ * @brief Flags selecting the connection caches filled by ::sr_conn_prefetch call.
+ */
+typedef enum {
+    SR_PREFETCH_RUNNING = 0x1,      /**< Load the running data into the running data cache (::SR_CONN_CACHE_RUNNING). */
+    SR_PREFETCH_OPER = 0x2          /**< Load the stored (pushed) operational data and the operational views into
+                                         their caches (::SR_CONN_CACHE_OPER_PUSH, ::SR_CONN_CACHE_OPER_VIEW). Data of
+                                         operational get subscriptions are not retrieved. */
+} sr_prefetch_flag_t;
+
+/**
+ * @brief Options for ::sr_conn_prefetch call, it is supposed to be bitwise OR-ed value of any ::sr_prefetch_flag_t flags.
+ */
+typedef uint32_t sr_prefetch_options_t;
+
 /**
  * @brief [Datastores](@ref datastores) that sysrepo supports. To change which datastore a session operates on,
  * use ::sr_session_switch_ds.
@@ -183,6 +232,88 @@ typedef struct {
     mode_t perm;                    /**< Optional module data permissions. */
 } sr_install_mod_t;
 
+/**
+ * @brief Change of a feature of an installed module.
+ */
+typedef struct {
+    const char *module_name;        /**< Name of the installed module. */
+    const char *feature_name;       /**< Name of the feature to change. */
+    int enable;                     /**< Whether to enable or disable the feature. */
+} sr_feature_change_t;
+
+/**
+ * @brief Change of replay support of installed modules.
+ */
+typedef struct {
+    const char *module_name;        /**< Name of the installed module, NULL for all the modules. */
+    int enable;                     /**< Whether to enable or disable replay support. */
+} sr_replay_change_t;
+
+/**
+ * @brief Set of module changes to be performed at once, all the members are optional.
+ */
+typedef struct {
+    const sr_install_mod_t *install;        /**< Array of new modules to install. */
+    uint32_t install_count;                 /**< Count of @p install. */
+    const char **remove;                    /**< Array of names of modules to remove terminated by NULL. */
+    int force_remove;                       /**< Remove also all the modules depending on modules in @p remove. */
+    const char **update;                    /**< Array of paths to updated schemas terminated by NULL. */
+    const sr_feature_change_t *features;    /**< Array of feature changes, applied in order. */
+    uint32_t feature_count;                 /**< Count of @p features. */
+    const sr_replay_change_t *replay;       /**< Array of replay support changes, applied in order. */
+    uint32_t replay_count;                  /**< Count of @p replay. */
+} sr_module_change_set_t;
+
+/**
+ * @brief Ext SHM (subscriptions) memory usage and fragmentation statistics.
+ */
+typedef struct {
+    uint64_t size;              /**< Ext SHM size. */
+    uint64_t hole_size;         /**< Total size of all the unused memory holes. */
+    uint32_t hole_count;        /**< Count of unused memory holes. */
+    uint64_t largest_hole;      /**< Size of the largest unused memory hole. */
+} sr_ext_shm_stats_t;
+
+/**
+ * @brief SHM memory usage of a module.
+ */
+typedef struct {
+    char *name;                 /**< Module name. */
+    uint32_t sub_count;         /**< Count of all the subscriptions to the module. */
+    uint64_t ext_size;          /**< Size of ext SHM memory used by the subscriptions. */
+    uint32_t sub_shm_count;     /**< Count of subscription SHM files. */
+    uint64_t sub_shm_size;      /**< Total size of subscription SHM files. */
+    uint32_t sub_data_shm_count;    /**< Count of subscription data SHM files. */
+    uint64_t sub_data_shm_size; /**< Total size of subscription data SHM files. */
+} sr_mod_shm_stats_t;
+
+/**
+ * @brief SHM memory mapped by a connection.
+ */
+typedef struct {
+    sr_cid_t cid;               /**< Connection ID. */
+    uint32_t sub_count;         /**< Count of all the subscriptions of the connection. */
+    uint64_t mapped_size;       /**< Total size of mapped main, mod, ext, and subscription SHM. */
+} sr_conn_shm_stats_t;
+
+/**
+ * @brief Memory usage of all the SHM segments.
+ */
+typedef struct {
+    uint64_t main_size;         /**< Main SHM size. */
+    uint64_t mod_size;          /**< Mod SHM size. */
+    sr_ext_shm_stats_t ext;     /**< Ext SHM usage and fragmentation. */
+    uint32_t sub_shm_count;     /**< Count of all the subscription SHM files. */
+    uint64_t sub_shm_size;      /**< Total size of all the subscription SHM files. */
+    uint32_t sub_data_shm_count;    /**< Count of all the subscription data SHM files. */
+    uint64_t sub_data_shm_size; /**< Total size of all the subscription data SHM files. */
+
+    sr_mod_shm_stats_t *mods;   /**< Memory usage of every module. */
+    uint32_t mod_count;         /**< Count of @p mods. */
+    sr_conn_shm_stats_t *conns; /**< Mapped memory of this connection and every connection with subscriptions. */
+    uint32_t conn_count;        /**< Count of @p conns. */
+} sr_shm_stats_t;
+
 /** @} connsess */
 
 /**
@@ -197,7 +328,7 @@ typedef struct {
     /** Connection whose context was used for creating @p tree. */
     const sr_conn_ctx_t *conn;
 
-    /** Arbitrary libyang data, it can be modified */
+    /** Arbitrary libyang data, it can be modified unless retrieved with ::SR_GET_READ_ONLY */
     struct lyd_node *tree;
 } sr_data_t;
 
@@ -299,8 +430,11 @@ typedef enum {
     SR_OPER_NO_STORED = 0x08,        /**< Do not merge with stored operational data (push). */
     SR_OPER_WITH_ORIGIN = 0x10,      /**< Return data with their [origin attributes](@ref datastores). Nodes without
                                           one inherit the origin from parents. */
-    SR_OPER_NO_CACHED = 0x20         /**< Do not use cached oper data from operational poll subscriptions even if
+    SR_OPER_NO_CACHED = 0x20,        /**< Do not use cached oper data from operational poll subscriptions even if
                                           available. */
+    SR_OPER_SUBS_PARALLEL = 0x40     /**< Notify all the operational get subscriptions providing top-level data of
+                                          a module at once and wait for them together instead of one after another.
+                                          Their data are then merged in the order of the subscriptions. */
 } sr_get_oper_flag_t;
 
 #define SR_OPER_MASK 0xFFFF          /**< Mask for all get oper data flags. */
@@ -309,9 +443,15 @@ typedef enum {
  * @brief Flags used to override default data get behavior.
  */
 typedef enum {
-    SR_GET_NO_FILTER = 0x010000      /**< Do not apply the filter and return the whole "base" data which the filter
+    SR_GET_NO_FILTER = 0x010000,     /**< Do not apply the filter and return the whole "base" data which the filter
                                           would normally be applied on. The filter is used only when deciding what data
                                           to retrieve from subscribers and similar optimization cases. */
+    SR_GET_READ_ONLY = 0x020000      /**< The returned data will not be modified by the caller. They may then be
+                                          shared with other read-only results of the same request on a connection
+                                          with ::SR_CONN_CACHE_RUNNING, until the cached running data change.
+                                          Values returned by ::sr_get_items() are all stored in a single memory
+                                          block so they must not be modified using sr_val_set_* functions,
+                                          ::sr_free_values() frees the whole block. */
 } sr_get_flag_t;
 
 /**
@@ -349,6 +489,8 @@ typedef enum {
  */
 typedef uint32_t sr_edit_options_t;
 
+#define SR_COMMIT_PRIO_MAX 3        /**< Highest priority of the commits of a session, see ::sr_session_set_commit_priority. */
+
 /**
  * @brief Options for specifying move direction of ::sr_move_item call.
  */
@@ -359,6 +501,22 @@ typedef enum {
     SR_MOVE_LAST = 3       /**< Move the specified item to the position of the last child. */
 } sr_move_position_t;
 
+/**
+ * @brief Edit builder for creating large edits efficiently, created by ::sr_edit_builder_new().
+ */
+typedef struct sr_edit_builder_s sr_edit_builder_t;
+
+/**
+ * @brief Callback to be called when changes applied by ::sr_apply_changes_async() are committed.
+ *
+ * Called by the commit thread of the session so it should not block for long, it delays the next commit.
+ *
+ * @param[in] session Session whose changes were committed.
+ * @param[in] err_info Error information of the failed commit, NULL on success. Valid only in the callback.
+ * @param[in] private_data Private context opaque to sysrepo, as passed to ::sr_session_set_commit_cb call.
+ */
+typedef void (*sr_commit_cb)(sr_session_ctx_t *session, const sr_error_info_t *err_info, void *private_data);
+
 /** @} editdata */
 
 /**
@@ -438,7 +596,31 @@ typedef enum {
      * @brief On every data retrieval additionally compute diff with the previous data and report the changes to any
      * operational data module change subscriptions. Accepted only for ::sr_oper_poll_subscribe().
      */
-    SR_SUBSCR_OPER_POLL_DIFF = 0x80
+    SR_SUBSCR_OPER_POLL_DIFF = 0x80,
+
+    /**
+     * @brief Instead of a handler thread for every subscription structure, handle the events of the subscription
+     * structure by the shared event loop of the connection. Its worker threads process events of all
+     * the subscription structures created with this flag, the number of workers can be set by
+     * ::sr_set_shared_subscription_workers(). Accepted only when creating a new subscription structure and cannot
+     * be combined with ::SR_SUBSCR_NO_THREAD.
+     */
+    SR_SUBSCR_SHARED_THREAD = 0x100,
+
+    /**
+     * @brief Share the cached data system-wide so that they are used by all the connections, not only the one
+     * of the subscription. The data are also used instead of retrieving them again by all the other oper poll
+     * subscriptions with this flag, for the same path. Accepted only for ::sr_oper_poll_subscribe().
+     */
+    SR_SUBSCR_OPER_POLL_SHARED = 0x200,
+
+    /**
+     * @brief The subscriber is independent of the other subscribers of the module and can be notified about
+     * the changes together with them regardless of its priority. All the subscribers of a module with this flag form
+     * a parallel group that is notified at once, with the highest priority among them, instead of one priority after
+     * another. Accepted only for ::sr_module_change_subscribe() and cannot be combined with ::SR_SUBSCR_UPDATE.
+     */
+    SR_SUBSCR_PARALLEL = 0x400
 
 } sr_subscr_flag_t;
 
@@ -454,6 +636,28 @@ typedef struct sr_subscription_ctx_s sr_subscription_ctx_t;
  */
 typedef uint32_t sr_subscr_options_t;
 
+/**
+ * @brief Kind of the threads created by a connection, see ::sr_conn_set_thread_attr.
+ */
+typedef enum {
+    SR_THREAD_SUBSCR = 0,       /**< Subscription handler threads, shared event loop threads, and subscription
+                                     worker threads. */
+    SR_THREAD_NOTIF_BUF = 1     /**< Notification buffering threads (::sr_session_notif_buffer). */
+} sr_thread_type_t;
+
+/**
+ * @brief Placement and identification of sysrepo threads, any member left in its default value keeps
+ * the default behavior.
+ */
+typedef struct {
+    const int *cpus;            /**< CPUs the thread is allowed to run on, NULL for no restriction. */
+    uint32_t cpu_count;         /**< Count of @p cpus. */
+    int sched_policy;           /**< Scheduling policy (SCHED_OTHER, SCHED_FIFO, SCHED_RR, ...), -1 to inherit it. */
+    int sched_priority;         /**< Scheduling priority for @p sched_policy. */
+    size_t stack_size;          /**< Stack size of the thread, 0 for the default. */
+    const char *name;           /**< Thread name (truncated to 15 characters), NULL for none. */
+} sr_thread_attr_t;
+
 /** @} subs */
 
 /**
@@ -508,6 +712,11 @@ typedef enum {
  */
 typedef struct sr_change_iter_s sr_change_iter_t;
 
+/**
+ * @brief Iterator used for retrieval of data in chunks using ::sr_get_data_iter call.
+ */
+typedef struct sr_data_iter_s sr_data_iter_t;
+
 /**
  * @brief Callback to be called on the event of changing datastore content of the specified module.
  *
@@ -527,6 +736,18 @@ typedef struct sr_change_iter_s sr_change_iter_t;
 typedef int (*sr_module_change_cb)(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
         sr_event_t event, uint32_t request_id, void *private_data);
 
+/**
+ * @brief A single module change subscription of a batch, used in ::sr_module_change_subscribe_batch.
+ */
+typedef struct {
+    const char *module_name;        /**< Name of the module of interest for change notifications. */
+    const char *xpath;              /**< Optional XPath further filtering the changes. */
+    sr_module_change_cb callback;   /**< Callback to be called when the change in the datastore occurs. */
+    void *private_data;             /**< Private context passed to the callback function. */
+    uint32_t priority;              /**< Order in which the callbacks (within module) will be called, higher first. */
+    sr_subscr_options_t opts;       /**< Options of this subscription, OR-ed with the options of the batch. */
+} sr_module_change_sub_t;
+
 /** @} datasubs */
 
 /**
@@ -574,6 +795,21 @@ typedef int (*sr_rpc_cb)(sr_session_ctx_t *session, uint32_t sub_id, const char
 typedef int (*sr_rpc_tree_cb)(sr_session_ctx_t *session, uint32_t sub_id, const char *op_path, const struct lyd_node *input,
         sr_event_t event, uint32_t request_id, struct lyd_node *output, void *private_data);
 
+/**
+ * @brief Callback to be called with the result of an RPC/action sent by ::sr_rpc_send_tree_async().
+ *
+ * Called by a connection worker thread so it should not block for long, it delays other requests.
+ *
+ * @param[in] session Session that sent the RPC/action.
+ * @param[in] request_id Request ID, as returned by ::sr_rpc_send_tree_async().
+ * @param[in] err_info Error information of a failed RPC/action, NULL on success. Valid only in the callback.
+ * @param[in] output Output data, NULL on error. The callback takes ownership and must free them using
+ * ::sr_release_data().
+ * @param[in] private_data Private context opaque to sysrepo, as passed to ::sr_rpc_send_tree_async call.
+ */
+typedef void (*sr_rpc_async_cb)(sr_session_ctx_t *session, uint32_t request_id, const sr_error_info_t *err_info,
+        sr_data_t *output, void *private_data);
+
 /** @} rpcsubs */
 
 /**
@@ -39,6 +39,42 @@ static struct sr_nacm nacm;
 #define EMEM_CB sr_session_set_error_message(session, "Memory allocation failed (%s:%d)", __FILE__, __LINE__)
 #define EINT_CB sr_session_set_error_message(session, "Internal error (%s:%d)", __FILE__, __LINE__)
 
+/** maximum number of users with cached groups */
+#define SR_NACM_USER_GROUPS_MAX 64
+
+/**
+ * @brief Free groups of a user.
+ *
+ * @param[in] ugroups User groups to free.
+ */
+static void
+sr_nacm_user_groups_free(struct sr_nacm_user_groups *ugroups)
+{
+    uint32_t i;
+
+    free(ugroups->user);
+    for (i = 0; i < ugroups->group_count; ++i) {
+        free(ugroups->groups[i]);
+    }
+    free(ugroups->groups);
+}
+
+/**
+ * @brief Clear cached groups of all the users.
+ */
+static void
+sr_nacm_user_groups_clear(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < nacm.user_group_count; ++i) {
+        sr_nacm_user_groups_free(&nacm.user_groups[i]);
+    }
+    free(nacm.user_groups);
+    nacm.user_groups = NULL;
+    nacm.user_group_count = 0;
+}
+
 /* /ietf-netconf-acm:nacm */
 static int
 sr_nacm_nacm_params_cb(sr_session_ctx_t *session, uint32_t UNUSED(sub_id), const char *UNUSED(module_name), const char *xpath,
@@ -65,6 +101,9 @@ sr_nacm_nacm_params_cb(sr_session_ctx_t *session, uint32_t UNUSED(sub_id), const
     /* NACM LOCK */
     pthread_mutex_lock(&nacm.lock);
 
+    /* NACM configuration is changing */
+    ++nacm.gen;
+
     while ((rc = sr_get_change_tree_next(session, iter, &op, &node, NULL, NULL, NULL)) == SR_ERR_OK) {
         term = (struct lyd_node_term *)node;
         if (!strcmp(node->schema->name, "enable-nacm")) {
@@ -106,6 +145,9 @@ sr_nacm_nacm_params_cb(sr_session_ctx_t *session, uint32_t UNUSED(sub_id), const
                 } else {
                     nacm.enable_external_groups = 0;
                 }
+
+                /* system groups of users are (not) used now */
+                sr_nacm_user_groups_clear();
             }
         }
     }
@@ -269,6 +311,12 @@ sr_nacm_group_cb(sr_session_ctx_t *session, uint32_t UNUSED(sub_id), const char
     /* NACM LOCK */
     pthread_mutex_lock(&nacm.lock);
 
+    /* NACM configuration is changing */
+    ++nacm.gen;
+
+    /* groups are changing, cached groups of users are no longer valid */
+    sr_nacm_user_groups_clear();
+
     while ((rc = sr_get_change_tree_next(session, iter, &op, &node, NULL, NULL, NULL)) == SR_ERR_OK) {
         if (!strcmp(node->schema->name, "group")) {
             /* name must be present */
@@ -385,6 +433,170 @@ sr_nacm_group_cb(sr_session_ctx_t *session, uint32_t UNUSED(sub_id), const char
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Free compiled data target of a rule.
+ *
+ * @param[in] rule Rule to use.
+ */
+static void
+sr_nacm_rule_target_free(struct sr_nacm_rule *rule)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < rule->seg_count; ++i) {
+        free(rule->segs[i].mod_name);
+        free(rule->segs[i].name);
+        for (j = 0; j < rule->segs[i].pred_count; ++j) {
+            free(rule->segs[i].preds[j].key);
+            free(rule->segs[i].preds[j].value);
+        }
+        free(rule->segs[i].preds);
+    }
+    free(rule->segs);
+    rule->segs = NULL;
+    rule->seg_count = 0;
+}
+
+/**
+ * @brief Compile data target path of a rule so that nodes can be matched without generating their paths.
+ *
+ * Only paths of node names with optional key/leaf-list value predicates are compiled, matching of the rule
+ * falls back to comparing node paths otherwise.
+ *
+ * @param[in] rule Rule with the data target to compile.
+ */
+static void
+sr_nacm_rule_target_compile(struct sr_nacm_rule *rule)
+{
+    struct sr_nacm_rule_seg *seg;
+    struct sr_nacm_rule_pred *pred;
+    const char *ptr, *start, *colon;
+    char quot;
+    void *mem;
+
+    sr_nacm_rule_target_free(rule);
+
+    if ((rule->target_type != SR_NACM_TARGET_DATA) || !rule->target) {
+        return;
+    }
+
+    ptr = rule->target;
+    if (ptr[0] != '/') {
+        goto error;
+    }
+
+    while (ptr[0] == '/') {
+        ++ptr;
+
+        /* new node */
+        mem = realloc(rule->segs, (rule->seg_count + 1) * sizeof *rule->segs);
+        if (!mem) {
+            goto error;
+        }
+        rule->segs = mem;
+        seg = &rule->segs[rule->seg_count];
+        memset(seg, 0, sizeof *seg);
+        ++rule->seg_count;
+
+        /* [module:]name */
+        start = ptr;
+        colon = NULL;
+        while (ptr[0] && !strchr("/[]='\"$ ", ptr[0])) {
+            if (ptr[0] == ':') {
+                if (colon) {
+                    goto error;
+                }
+                colon = ptr;
+            }
+            ++ptr;
+        }
+        if (colon) {
+            if ((colon == start) || (colon + 1 == ptr)) {
+                goto error;
+            }
+            seg->mod_name = strndup(start, colon - start);
+            seg->name = strndup(colon + 1, ptr - (colon + 1));
+            if (!seg->mod_name || !seg->name) {
+                goto error;
+            }
+        } else {
+            if (ptr == start) {
+                goto error;
+            }
+            seg->name = strndup(start, ptr - start);
+            if (!seg->name) {
+                goto error;
+            }
+        }
+
+        /* predicates */
+        while (ptr[0] == '[') {
+            ++ptr;
+
+            mem = realloc(seg->preds, (seg->pred_count + 1) * sizeof *seg->preds);
+            if (!mem) {
+                goto error;
+            }
+            seg->preds = mem;
+            pred = &seg->preds[seg->pred_count];
+            memset(pred, 0, sizeof *pred);
+            ++seg->pred_count;
+
+            /* key name, without any prefix */
+            start = ptr;
+            while (ptr[0] && !strchr("/[]='\"$ ", ptr[0])) {
+                if (ptr[0] == ':') {
+                    start = ptr + 1;
+                }
+                ++ptr;
+            }
+            if ((ptr == start) || (ptr[0] != '=')) {
+                goto error;
+            }
+            pred->key = strndup(start, ptr - start);
+            if (!pred->key) {
+                goto error;
+            }
+            ++ptr;
+
+            /* value */
+            if (!strncmp(ptr, "$USER]", 6)) {
+                /* variable */
+                ptr += 5;
+            } else if ((ptr[0] == '\'') || (ptr[0] == '"')) {
+                quot = ptr[0];
+                start = ptr + 1;
+                ptr = strchr(start, quot);
+                if (!ptr) {
+                    goto error;
+                }
+                pred->value = strndup(start, ptr - start);
+                if (!pred->value) {
+                    goto error;
+                }
+                ++ptr;
+            } else {
+                /* positional or unknown predicate */
+                goto error;
+            }
+
+            if (ptr[0] != ']') {
+                goto error;
+            }
+            ++ptr;
+        }
+    }
+
+    if (ptr[0]) {
+        goto error;
+    }
+    return;
+
+error:
+    /* not compiled, node paths will be used for matching */
+    sr_nacm_rule_target_free(rule);
+}
+
 /**
  * @brief Remove all rules from a rule list.
  *
@@ -399,6 +611,7 @@ sr_nacm_remove_rules(struct sr_nacm_rule_list *list)
         free(rule->name);
         free(rule->module_name);
         free(rule->target);
+        sr_nacm_rule_target_free(rule);
         free(rule->comment);
         free(rule);
     }
@@ -570,6 +783,9 @@ sr_nacm_rule_list_cb(sr_session_ctx_t *session, uint32_t UNUSED(sub_id), const c
     /* NACM LOCK */
     pthread_mutex_lock(&nacm.lock);
 
+    /* NACM configuration is changing */
+    ++nacm.gen;
+
     while ((rc = sr_get_change_tree_next(session, iter, &op, &node, NULL, &prev_list, NULL)) == SR_ERR_OK) {
         if (!strcmp(node->schema->name, "rule-list")) {
             /* name must be present */
@@ -729,6 +945,9 @@ sr_nacm_rule_cb(sr_session_ctx_t *session, uint32_t UNUSED(sub_id), const char *
     /* NACM LOCK */
     pthread_mutex_lock(&nacm.lock);
 
+    /* NACM configuration is changing */
+    ++nacm.gen;
+
     while ((rc = sr_get_change_tree_next(session, iter, &op, &node, NULL, &prev_list, NULL)) == SR_ERR_OK) {
         if (!strcmp(node->schema->name, "rule")) {
             /* find parent rule list */
@@ -813,6 +1032,7 @@ sr_nacm_rule_cb(sr_session_ctx_t *session, uint32_t UNUSED(sub_id), const char *
                 free(rule->name);
                 free(rule->module_name);
                 free(rule->target);
+                sr_nacm_rule_target_free(rule);
                 free(rule->comment);
                 if (prev_rule) {
                     prev_rule->next = rule->next;
@@ -880,6 +1100,9 @@ sr_nacm_rule_cb(sr_session_ctx_t *session, uint32_t UNUSED(sub_id), const char *
                         rule->target_type = SR_NACM_TARGET_DATA;
                     }
                 }
+
+                /* compile any data target */
+                sr_nacm_rule_target_compile(rule);
             } else if (!strcmp(node->schema->name, "access-operations")) {
                 str = lyd_get_value(node);
                 rule->operations = 0;
@@ -1087,6 +1310,7 @@ sr_nacm_destroy(void)
         free(group->users);
     }
     free(nacm.groups);
+    sr_nacm_user_groups_clear();
 
     LY_LIST_FOR_SAFE(nacm.rule_lists, tmp, rule_list) {
         free(rule_list->name);
@@ -1104,6 +1328,7 @@ sr_nacm_destroy(void)
     nacm.denied_notifications = 0;
     nacm.denied_operations = 0;
     nacm.denied_data_writes = 0;
+    ++nacm.gen;
     pthread_mutex_destroy(&nacm.lock);
 
     nacm.initialized = 0;
@@ -1215,6 +1440,148 @@ sr_nacm_allowed_tree(const struct lysc_node *root, const char *user, int *allowe
     return NULL;
 }
 
+/**
+ * @brief Duplicate an array of groups.
+ *
+ * @param[in] groups Array of groups.
+ * @param[in] group_count Number of @p groups.
+ * @param[out] dup Duplicated array of groups.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_nacm_groups_dup(char **groups, uint32_t group_count, char ***dup)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+
+    *dup = NULL;
+    if (!group_count) {
+        return NULL;
+    }
+
+    *dup = calloc(group_count, sizeof **dup);
+    SR_CHECK_MEM_RET(!*dup, err_info);
+    for (i = 0; i < group_count; ++i) {
+        (*dup)[i] = strdup(groups[i]);
+        if (!(*dup)[i]) {
+            for ( ; i; --i) {
+                free((*dup)[i - 1]);
+            }
+            free(*dup);
+            *dup = NULL;
+            SR_ERRINFO_MEM(&err_info);
+            return err_info;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Get current monotonic time in seconds.
+ *
+ * @return Monotonic time.
+ */
+static time_t
+sr_nacm_user_groups_time(void)
+{
+    struct timespec ts = {0};
+
+    clock_gettime(COMPAT_CLOCK_ID, &ts);
+    return ts.tv_sec;
+}
+
+/**
+ * @brief Find valid cached groups of a user.
+ *
+ * @param[in] user User to find.
+ * @return Cached user groups, NULL if not found.
+ */
+static struct sr_nacm_user_groups *
+sr_nacm_user_groups_find(const char *user)
+{
+    uint32_t i;
+
+    for (i = 0; i < nacm.user_group_count; ++i) {
+        if (!strcmp(nacm.user_groups[i].user, user)) {
+            if (nacm.user_groups[i].expires <= sr_nacm_user_groups_time()) {
+                /* expired */
+                return NULL;
+            }
+            return &nacm.user_groups[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Store groups of a user into the cache. Failures are ignored, the groups are then simply not cached.
+ *
+ * @param[in] user User of the groups.
+ * @param[in] groups Sorted array of the user groups.
+ * @param[in] group_count Number of @p groups.
+ */
+static void
+sr_nacm_user_groups_store(const char *user, char **groups, uint32_t group_count)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_nacm_user_groups *ugroups = NULL;
+    time_t now;
+    uint32_t i;
+    void *mem;
+
+    now = sr_nacm_user_groups_time();
+
+    /* find the user or an expired entry to replace */
+    for (i = 0; i < nacm.user_group_count; ++i) {
+        if (!strcmp(nacm.user_groups[i].user, user) || (nacm.user_groups[i].expires <= now)) {
+            ugroups = &nacm.user_groups[i];
+            break;
+        }
+    }
+
+    if (!ugroups && (nacm.user_group_count == SR_NACM_USER_GROUPS_MAX)) {
+        /* replace the entry expiring first */
+        ugroups = &nacm.user_groups[0];
+        for (i = 1; i < nacm.user_group_count; ++i) {
+            if (nacm.user_groups[i].expires < ugroups->expires) {
+                ugroups = &nacm.user_groups[i];
+            }
+        }
+    }
+
+    if (ugroups) {
+        sr_nacm_user_groups_free(ugroups);
+    } else {
+        /* new entry */
+        mem = realloc(nacm.user_groups, (nacm.user_group_count + 1) * sizeof *nacm.user_groups);
+        if (!mem) {
+            return;
+        }
+        nacm.user_groups = mem;
+        ugroups = &nacm.user_groups[nacm.user_group_count];
+        ++nacm.user_group_count;
+    }
+    memset(ugroups, 0, sizeof *ugroups);
+
+    /* fill the entry */
+    ugroups->user = strdup(user);
+    if (!ugroups->user || (err_info = sr_nacm_groups_dup(groups, group_count, &ugroups->groups))) {
+        sr_errinfo_free(&err_info);
+
+        /* remove the entry */
+        free(ugroups->user);
+        --nacm.user_group_count;
+        if (ugroups < &nacm.user_groups[nacm.user_group_count]) {
+            *ugroups = nacm.user_groups[nacm.user_group_count];
+        }
+        return;
+    }
+    ugroups->group_count = group_count;
+    ugroups->expires = now + SR_NACM_GROUP_CACHE_TIMEOUT;
+}
+
 /**
  * @brief Collect all NACM groups for a user. If enabled, even system ones.
  *
@@ -1236,9 +1603,20 @@ sr_nacm_collect_groups(const char *user, char ***groups, uint32_t *group_count)
     int found;
     int gid_count = 0, ret;
 
+    struct sr_nacm_user_groups *ugroups;
+
     *groups = NULL;
     *group_count = 0;
 
+    if (SR_NACM_GROUP_CACHE_TIMEOUT && (ugroups = sr_nacm_user_groups_find(user))) {
+        /* use the cached groups */
+        if ((err_info = sr_nacm_groups_dup(ugroups->groups, ugroups->group_count, groups))) {
+            return err_info;
+        }
+        *group_count = ugroups->group_count;
+        return NULL;
+    }
+
     /* collect NACM groups */
     for (i = 0; i < nacm.group_count; ++i) {
         for (j = 0; j < nacm.groups[i].user_count; ++j) {
@@ -1303,6 +1681,11 @@ sr_nacm_collect_groups(const char *user, char ***groups, uint32_t *group_count)
         }
     }
 
+    if (SR_NACM_GROUP_CACHE_TIMEOUT) {
+        /* cache the groups */
+        sr_nacm_user_groups_store(user, *groups, *group_count);
+    }
+
 cleanup:
     free(gids);
     free(buf);
@@ -1383,6 +1766,120 @@ sr_nacm_allowed_path(const char *rule_target, const char *node_path, const char
     }
 }
 
+/**
+ * @brief Check NACM match of the predicates of a compiled rule target node and a data node.
+ *
+ * @param[in] seg Compiled rule target node with predicates.
+ * @param[in] node Data node.
+ * @param[in] user NACM user.
+ * @return 0 if does not match.
+ * @return 1 if the predicates match.
+ */
+static int
+sr_nacm_allowed_path_compiled_preds(const struct sr_nacm_rule_seg *seg, const struct lyd_node *node, const char *user)
+{
+    const struct lyd_node *key;
+    const char *value;
+    uint32_t i;
+
+    if (node->schema->nodetype == LYS_LEAFLIST) {
+        /* leaf-list value */
+        if ((seg->pred_count > 1) || strcmp(seg->preds[0].key, ".")) {
+            return 0;
+        }
+        value = seg->preds[0].value ? seg->preds[0].value : user;
+        return strcmp(value, lyd_get_value(node)) ? 0 : 1;
+    }
+
+    if ((node->schema->nodetype != LYS_LIST) || (node->schema->flags & LYS_KEYLESS)) {
+        return 0;
+    }
+
+    /* keys are always the first children in their order, the rule may have only some first of them */
+    key = lyd_child(node);
+    for (i = 0; i < seg->pred_count; ++i) {
+        if (!key || !key->schema || !(key->schema->flags & LYS_KEY) || strcmp(seg->preds[i].key, key->schema->name)) {
+            return 0;
+        }
+
+        value = seg->preds[i].value ? seg->preds[i].value : user;
+        if (strcmp(value, lyd_get_value(key))) {
+            return 0;
+        }
+
+        key = key->next;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Check NACM match of a data node and a compiled rule target, same as ::sr_nacm_allowed_path() but
+ * without generating the node path.
+ *
+ * @param[in] rule Rule with a compiled target.
+ * @param[in] node Data node.
+ * @param[in] user NACM user.
+ * @return -1 if the node cannot be matched this way.
+ * @return 0 if does not match.
+ * @return 1 if the rule path matches.
+ * @return 2 if the path is a partial match.
+ */
+static int
+sr_nacm_allowed_path_compiled(const struct sr_nacm_rule *rule, const struct lyd_node *node, const char *user)
+{
+    const struct sr_nacm_rule_seg *seg;
+    const struct lyd_node *iter, *parent;
+    uint32_t depth = 0, i;
+    int prefixed;
+
+    /* learn the node depth */
+    for (iter = node; iter; iter = lyd_parent(iter)) {
+        if (!iter->schema) {
+            /* opaque node */
+            return -1;
+        }
+        ++depth;
+    }
+
+    /* match all the ancestors from the node up, the nodes deeper than the rule target always match */
+    i = depth;
+    for (iter = node; iter; iter = parent) {
+        parent = lyd_parent(iter);
+        --i;
+        if (i >= rule->seg_count) {
+            continue;
+        }
+        seg = &rule->segs[i];
+
+        /* module name is in the path only for top-level nodes and nodes from a different module than their parent */
+        prefixed = !parent || (parent->schema->module != iter->schema->module);
+        if (seg->mod_name) {
+            if (!prefixed || strcmp(seg->mod_name, iter->schema->module->name)) {
+                return 0;
+            }
+        } else if (prefixed) {
+            return 0;
+        }
+
+        if (strcmp(seg->name, iter->schema->name)) {
+            return 0;
+        }
+
+        if (seg->pred_count && !sr_nacm_allowed_path_compiled_preds(seg, iter, user)) {
+            return 0;
+        }
+    }
+
+    if (depth < rule->seg_count) {
+        /* rule continues, it is a partial match */
+        return 2;
+    }
+
+    /* full or prefix (descendant) match */
+    return 1;
+}
+
 /**
  * @brief Check whether any group from a rule list matches one of the user groups.
  *
@@ -1460,7 +1957,7 @@ sr_nacm_allowed_node(const struct lyd_node *node, const char *node_path, const s
     sr_error_info_t *err_info = NULL;
     struct sr_nacm_rule_list *rlist;
     struct sr_nacm_rule *rule;
-    char *path;
+    char *path = NULL;
 
     *access = SR_NACM_ACCESS_DENY;
 
@@ -1533,12 +2030,22 @@ sr_nacm_allowed_node(const struct lyd_node *node, const char *node_path, const s
             case SR_NACM_TARGET_ANY:
                 if (rule->target) {
                     /* exact match or is a descendant (specified in RFC 8341 page 27) for full tree access */
-                    if (!node_path) {
-                        path = lyd_path(node, LYD_PATH_STD, NULL, 0);
-                        path_match = sr_nacm_allowed_path(rule->target, path, user);
-                        free(path);
-                    } else {
-                        path_match = sr_nacm_allowed_path(rule->target, node_path, user);
+                    path_match = -1;
+                    if (node && rule->segs) {
+                        /* compiled rule target, no need to generate the path */
+                        path_match = sr_nacm_allowed_path_compiled(rule, node, user);
+                    }
+                    if (path_match == -1) {
+                        if (!node_path) {
+                            /* generate the path once for all the rules */
+                            if (!path) {
+                                path = lyd_path(node, LYD_PATH_STD, NULL, 0);
+                                SR_CHECK_MEM_GOTO(!path, err_info, cleanup);
+                            }
+                            path_match = sr_nacm_allowed_path(rule->target, path, user);
+                        } else {
+                            path_match = sr_nacm_allowed_path(rule->target, node_path, user);
+                        }
                     }
 
                     if (!path_match) {
@@ -1622,32 +2129,29 @@ cleanup:
         /* node itself is allowed but a rule denies access to some descendants */
         *access = SR_NACM_ACCESS_PARTIAL_PERMIT;
     }
-    return NULL;
+    free(path);
+    return err_info;
 }
 
-sr_error_info_t *
-sr_nacm_check_operation(const char *nacm_user, const struct lyd_node *data, const struct lyd_node **denied_node)
+/**
+ * @brief Check whether an operation is allowed for a user with collected groups. NACM lock is expected to be held.
+ *
+ * @param[in] nacm_user NACM username to use.
+ * @param[in] data Top-level node of the operation.
+ * @param[in] groups Array of collected groups.
+ * @param[in] group_count Number of @p groups.
+ * @param[out] denied_node NULL if access allowed, otherwise the denied access data node.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_nacm_check_operation_groups(const char *nacm_user, const struct lyd_node *data, char **groups, uint32_t group_count,
+        const struct lyd_node **denied_node)
 {
     sr_error_info_t *err_info = NULL;
     const struct lyd_node *op = NULL;
-    char **groups = NULL;
-    uint32_t group_count = 0;
     int allowed = 0;
     enum sr_nacm_access access;
 
-    /* NACM LOCK */
-    pthread_mutex_lock(&nacm.lock);
-
-    /* check access for the whole data tree first */
-    err_info = sr_nacm_allowed_tree(data->schema, nacm_user, &allowed);
-    if (err_info || allowed) {
-        goto cleanup;
-    }
-
-    if ((err_info = sr_nacm_collect_groups(nacm_user, &groups, &group_count))) {
-        goto cleanup;
-    }
-
     op = data;
     while (op) {
         if (op->schema->nodetype & (LYS_RPC | LYS_ACTION | LYS_NOTIF)) {
@@ -1720,7 +2224,6 @@ sr_nacm_check_operation(const char *nacm_user, const struct lyd_node *data, cons
     allowed = 1;
 
 cleanup:
-    sr_nacm_free_groups(groups, group_count);
     if (allowed) {
         op = NULL;
     } else if (op) {
@@ -1731,10 +2234,40 @@ cleanup:
         }
     }
 
+    *denied_node = op;
+    return err_info;
+}
+
+sr_error_info_t *
+sr_nacm_check_operation(const char *nacm_user, const struct lyd_node *data, const struct lyd_node **denied_node)
+{
+    sr_error_info_t *err_info = NULL;
+    char **groups = NULL;
+    uint32_t group_count = 0;
+    int allowed = 0;
+
+    *denied_node = NULL;
+
+    /* NACM LOCK */
+    pthread_mutex_lock(&nacm.lock);
+
+    /* check access for the whole data tree first */
+    err_info = sr_nacm_allowed_tree(data->schema, nacm_user, &allowed);
+    if (err_info || allowed) {
+        goto cleanup;
+    }
+
+    if ((err_info = sr_nacm_collect_groups(nacm_user, &groups, &group_count))) {
+        goto cleanup;
+    }
+
+    err_info = sr_nacm_check_operation_groups(nacm_user, data, groups, group_count, denied_node);
+
+cleanup:
     /* NACM UNLOCK */
     pthread_mutex_unlock(&nacm.lock);
 
-    *denied_node = op;
+    sr_nacm_free_groups(groups, group_count);
     return err_info;
 }
 
@@ -1946,80 +2479,31 @@ cleanup:
 }
 
 /**
- * @brief Filter out any data for which the user does not have R access. Denied nodes are freed.
- *
- * According to https://tools.ietf.org/html/rfc8341#section-3.2.4
- * recovery session is allowed to access all nodes.
+ * @brief Filter out any edits of a push-change-update notification the user does not have R access to.
+ * NACM lock is expected to be held.
  *
  * @param[in] nacm_user NACM username to use.
- * @param[in,out] tree Data tree (ignoring siblings) to filter, is directly modified. If not top-level, all parents
- * are also checked.
+ * @param[in,out] notif Top-level node of the notification tree to filter.
+ * @param[in] groups Array of collected groups.
+ * @param[in] group_count Number of @p groups.
+ * @param[out] denied Whether all the edits were denied, @p notif was not modified in this case.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_nacm_check_data_read_filter(const char *nacm_user, struct lyd_node **tree)
-{
-    sr_error_info_t *err_info = NULL;
-    char **groups = NULL;
-    uint32_t group_count;
-    enum sr_nacm_access access;
-    int allowed;
-
-    assert(tree);
-
-    if (!*tree) {
-        /* nothing to do */
-        return NULL;
-    }
-
-    /* NACM LOCK */
-    pthread_mutex_lock(&nacm.lock);
-
-    if ((err_info = sr_nacm_collect_groups(nacm_user, &groups, &group_count))) {
-        goto cleanup;
-    }
-
-    if ((err_info = sr_nacm_allowed_tree((*tree)->schema, nacm_user, &allowed))) {
-        goto cleanup;
-    }
-
-    if (!allowed) {
-        /* filter out all denied nodes */
-        if ((err_info = sr_nacm_check_data_read_filter_r(tree, nacm_user, groups, group_count, &access, NULL))) {
-            goto cleanup;
-        }
-    }
-
-cleanup:
-    /* NACM UNLOCK */
-    pthread_mutex_unlock(&nacm.lock);
-
-    sr_nacm_free_groups(groups, group_count);
-    return err_info;
-}
-
-sr_error_info_t *
-sr_nacm_check_push_update_notif(const char *nacm_user, struct lyd_node *notif, const struct lyd_node **denied_node)
+sr_nacm_filter_push_update_notif(const char *nacm_user, struct lyd_node *notif, char **groups, uint32_t group_count,
+        int *denied)
 {
     sr_error_info_t *err_info = NULL;
     struct ly_set *set = NULL;
     struct lyd_node_any *ly_value;
     struct lyd_node *ly_target, *next, *iter;
     const struct lysc_node *snode;
-    uint32_t i, group_count = 0, removed = 0;
-    char **groups = NULL;
+    uint32_t i, removed = 0;
     enum sr_nacm_access access;
 
     assert(!strcmp(LYD_NAME(notif), "push-change-update"));
 
-    /* first check NACM just like for a standard notification */
-    if ((err_info = sr_nacm_check_operation(nacm_user, notif, denied_node)) || *denied_node) {
-        goto cleanup;
-    }
-
-    if ((err_info = sr_nacm_collect_groups(nacm_user, &groups, &group_count))) {
-        goto cleanup;
-    }
+    *denied = 0;
 
     /* collect all edits */
     if (lyd_find_xpath(notif, "/ietf-yang-push:push-change-update/datastore-changes/yang-patch/edit", &set)) {
@@ -2055,7 +2539,7 @@ sr_nacm_check_push_update_notif(const char *nacm_user, struct lyd_node *notif, c
 
             /* filter out any nested nodes */
             LY_LIST_FOR_SAFE(lyd_child(ly_value->value.tree), next, iter) {
-                if ((err_info = sr_nacm_check_data_read_filter(nacm_user, &iter))) {
+                if ((err_info = sr_nacm_check_data_read_filter_r(&iter, nacm_user, groups, group_count, &access, NULL))) {
                     goto cleanup;
                 }
             }
@@ -2067,7 +2551,7 @@ sr_nacm_check_push_update_notif(const char *nacm_user, struct lyd_node *notif, c
 
     if (removed == set->count) {
         /* interpret as if the whole notification was denied without changing it */
-        *denied_node = notif;
+        *denied = 1;
     } else {
         /* actually remove all the denied subtrees */
         for (i = 0; i < set->count; ++i) {
@@ -2076,11 +2560,184 @@ sr_nacm_check_push_update_notif(const char *nacm_user, struct lyd_node *notif, c
     }
 
 cleanup:
-    sr_nacm_free_groups(groups, group_count);
     ly_set_free(set, NULL);
     return err_info;
 }
 
+/**
+ * @brief Check whether any rule target uses the $USER variable so the NACM decisions depend on the user name
+ * and not only on the user groups. NACM lock is expected to be held.
+ *
+ * @return Whether a user-dependent rule exists.
+ */
+static int
+sr_nacm_rules_user_dependent(void)
+{
+    struct sr_nacm_rule_list *rlist;
+    struct sr_nacm_rule *rule;
+
+    for (rlist = nacm.rule_lists; rlist; rlist = rlist->next) {
+        for (rule = rlist->rules; rule; rule = rule->next) {
+            if ((rule->target_type == SR_NACM_TARGET_DATA) && strstr(rule->target, "$USER")) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Find a cached NACM notification decision.
+ *
+ * @param[in] cache Notification NACM cache.
+ * @param[in] nacm_user NACM username.
+ * @param[in] groups Sorted array of collected groups of @p nacm_user.
+ * @param[in] group_count Number of @p groups.
+ * @return Found cache entry, NULL if none.
+ */
+static struct sr_nacm_notif_cache_entry *
+sr_nacm_notif_cache_find(const struct sr_nacm_notif_cache *cache, const char *nacm_user, char **groups,
+        uint32_t group_count)
+{
+    struct sr_nacm_notif_cache_entry *entry;
+    uint32_t i, j;
+
+    for (i = 0; i < cache->entry_count; ++i) {
+        entry = &cache->entries[i];
+        if (entry->group_count != group_count) {
+            continue;
+        }
+        if (entry->user && strcmp(entry->user, nacm_user)) {
+            continue;
+        }
+
+        /* both arrays are sorted */
+        for (j = 0; j < group_count; ++j) {
+            if (strcmp(entry->groups[j], groups[j])) {
+                break;
+            }
+        }
+        if (j == group_count) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_nacm_check_notif(struct sr_nacm_notif_cache *cache, const char *nacm_user, const struct lyd_node *notif,
+        const struct lyd_node **nacm_notif)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_nacm_notif_cache_entry *entry;
+    const struct lyd_node *denied_node;
+    char **groups = NULL;
+    uint32_t group_count = 0;
+    int allowed = 0, denied;
+    void *mem;
+
+    *nacm_notif = NULL;
+
+    /* NACM LOCK */
+    pthread_mutex_lock(&nacm.lock);
+
+    /* check access for the whole notification first */
+    if ((err_info = sr_nacm_allowed_tree(notif->schema, nacm_user, &allowed))) {
+        goto cleanup;
+    } else if (allowed) {
+        *nacm_notif = notif;
+        goto cleanup;
+    }
+
+    if ((err_info = sr_nacm_collect_groups(nacm_user, &groups, &group_count))) {
+        goto cleanup;
+    }
+
+    if ((entry = sr_nacm_notif_cache_find(cache, nacm_user, groups, group_count))) {
+        /* reuse the decision made for another subscriber with the same groups */
+        if (entry->denied_op) {
+            ++nacm.denied_notifications;
+        } else if (!entry->denied) {
+            *nacm_notif = entry->notif ? entry->notif : notif;
+        }
+        goto cleanup;
+    }
+
+    if (!cache->entry_count) {
+        /* learn once per notification whether the user name matters */
+        cache->user_dep = sr_nacm_rules_user_dependent();
+    }
+
+    /* new cache entry */
+    mem = realloc(cache->entries, (cache->entry_count + 1) * sizeof *cache->entries);
+    SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+    cache->entries = mem;
+    entry = &cache->entries[cache->entry_count];
+    memset(entry, 0, sizeof *entry);
+    if (cache->user_dep) {
+        entry->user = strdup(nacm_user);
+        SR_CHECK_MEM_GOTO(!entry->user, err_info, cleanup);
+    }
+    entry->groups = groups;
+    entry->group_count = group_count;
+    groups = NULL;
+    group_count = 0;
+    ++cache->entry_count;
+
+    /* check NACM just like for a standard notification */
+    if ((err_info = sr_nacm_check_operation_groups(nacm_user, notif, entry->groups, entry->group_count, &denied_node))) {
+        goto cleanup;
+    }
+    if (denied_node) {
+        entry->denied = 1;
+        entry->denied_op = 1;
+        goto cleanup;
+    }
+
+    if (!strcmp(notif->schema->module->name, "ietf-yang-push") && !strcmp(LYD_NAME(notif), "push-change-update")) {
+        /* push-change-update notif is filtered specially, on a duplicate */
+        if (lyd_dup_single(notif, NULL, LYD_DUP_RECURSIVE, &entry->notif)) {
+            sr_errinfo_new_ly(&err_info, LYD_CTX(notif), NULL);
+            goto cleanup;
+        }
+        if ((err_info = sr_nacm_filter_push_update_notif(nacm_user, entry->notif, entry->groups, entry->group_count,
+                &denied))) {
+            goto cleanup;
+        }
+        if (denied) {
+            entry->denied = 1;
+            lyd_free_tree(entry->notif);
+            entry->notif = NULL;
+            goto cleanup;
+        }
+    }
+
+    *nacm_notif = entry->notif ? entry->notif : notif;
+
+cleanup:
+    /* NACM UNLOCK */
+    pthread_mutex_unlock(&nacm.lock);
+
+    sr_nacm_free_groups(groups, group_count);
+    return err_info;
+}
+
+void
+sr_nacm_notif_cache_clear(struct sr_nacm_notif_cache *cache)
+{
+    uint32_t i;
+
+    for (i = 0; i < cache->entry_count; ++i) {
+        sr_nacm_free_groups(cache->entries[i].groups, cache->entries[i].group_count);
+        free(cache->entries[i].user);
+        lyd_free_tree(cache->entries[i].notif);
+    }
+    free(cache->entries);
+    memset(cache, 0, sizeof *cache);
+}
+
 /**
  * @brief Check whether diff node siblings can be applied by a user, recursively with children.
  *
@@ -2205,6 +2862,22 @@ cleanup:
     return err_info;
 }
 
+uint32_t
+sr_nacm_get_gen(void)
+{
+    uint32_t gen;
+
+    /* NACM LOCK */
+    pthread_mutex_lock(&nacm.lock);
+
+    gen = nacm.gen;
+
+    /* NACM UNLOCK */
+    pthread_mutex_unlock(&nacm.lock);
+
+    return gen;
+}
+
 void
 sr_errinfo_new_nacm(sr_error_info_t **err_info, const char *error_type, const char *error_tag, const char *error_app_tag,
         const struct lyd_node *error_path_node, const char *error_message_fmt, ...)
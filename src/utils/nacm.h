@@ -19,6 +19,7 @@
 
 #include <pthread.h>
 #include <stdint.h>
+#include <time.h>
 
 #include <libyang/libyang.h>
 #include <sysrepo.h>
@@ -50,6 +51,7 @@ struct sr_nacm {
     char default_write_deny;        /**< Whether default NACM write action is "deny" (otherwise "permit"). */
     char default_exec_deny;         /**< Whether default NACM exec action is "deny" (otherwise "permit"). */
     char enable_external_groups;    /**< Whether external (system) groups are taken into consideration for NACM. */
+    uint32_t gen;                   /**< Generation of the NACM configuration, changed with any change of it. */
 
     uint32_t denied_operations;     /**< Counter of denied operations (RPC or action). */
     uint32_t denied_data_writes;    /**< Counter of denied data writes. */
@@ -84,12 +86,43 @@ struct sr_nacm {
             uint8_t operations;     /**< Rule operations associated with it. */
             char action_deny;       /**< Whether the rule action is "deny" (otherwise "permit"). */
             char *comment;          /**< Rule comment. */
+
+            /**
+             * @brief Compiled node of a rule data target path.
+             */
+            struct sr_nacm_rule_seg {
+                char *mod_name;     /**< Module name of the node, set only if in the path. */
+                char *name;         /**< Node name. */
+
+                /**
+                 * @brief Compiled predicate of a rule data target path node.
+                 */
+                struct sr_nacm_rule_pred {
+                    char *key;      /**< Key name, "." for a leaf-list value. */
+                    char *value;    /**< Key value, NULL for the $USER variable. */
+                } *preds;           /**< Array of predicates. */
+                uint32_t pred_count;    /**< Number of predicates. */
+            } *segs;                /**< Array of compiled @p target nodes, NULL if it is not a data path or it
+                                         could not be compiled. */
+            uint32_t seg_count;     /**< Number of @p segs. */
+
             struct sr_nacm_rule *next; /**< Pointer to the next rule. */
         } *rules;                   /**< List of rules in the rule list. */
 
         struct sr_nacm_rule_list *next;    /**< Pointer to the next rule list. */
     } *rule_lists;                  /**< List of all the rule lists. */
 
+    /**
+     * @brief Cached groups of a user.
+     */
+    struct sr_nacm_user_groups {
+        char *user;                 /**< User name. */
+        char **groups;              /**< Sorted array of all the groups of the user. */
+        uint32_t group_count;       /**< Number of groups. */
+        time_t expires;             /**< Monotonic time in seconds when the cached groups expire. */
+    } *user_groups;                 /**< Array of cached groups of users. */
+    uint32_t user_group_count;      /**< Number of users with cached groups. */
+
     pthread_mutex_t lock;           /**< Lock for accessing all the NACM members. */
 };
 
@@ -152,17 +185,44 @@ sr_error_info_t *sr_nacm_check_data_read_filter_dup(const char *nacm_user, const
         struct lyd_node **dup, int *denied);
 
 /**
- * @brief Check whether the notification is allowed for a user and filter out any edits the user
- * does not have R access to.
+ * @brief NACM decisions for a single notification shared by all the subscribers with the same groups.
+ * Zero-initialized structure is an empty cache.
+ */
+struct sr_nacm_notif_cache {
+    struct sr_nacm_notif_cache_entry {
+        char **groups;              /**< Sorted array of groups the decision was made for. */
+        uint32_t group_count;       /**< Number of groups. */
+        char *user;                 /**< User the decision was made for, set only if it depends on the user name. */
+        struct lyd_node *notif;     /**< Filtered notification duplicate, NULL if the original can be used. */
+        char denied;                /**< Whether the notification is denied. */
+        char denied_op;             /**< Whether the notification itself is denied, not only all its edits. */
+    } *entries;                     /**< Array of cached decisions. */
+    uint32_t entry_count;           /**< Number of @p entries. */
+    int user_dep;                   /**< Whether any rule uses the $USER variable, valid if @p entry_count is set. */
+};
+
+/**
+ * @brief Check whether the notification is allowed for a user. A push-change-update notification has also
+ * any edits the user does not have R access to filtered out.
+ *
+ * The decision is cached for the groups of the user and reused for any other users with the same groups.
  *
+ * @param[in] cache Cache of NACM decisions for @p notif, free with ::sr_nacm_notif_cache_clear().
  * @param[in] nacm_user NACM username to use.
- * @param[in,out] notif Top-level node of the notification tree to filter.
- * @param[out] denied_node NULL if access allowed, otherwise the denied access data node. If set, @p notif was
- * not modified.
+ * @param[in] notif Top-level node of the notification tree, is not modified.
+ * @param[out] nacm_notif Notification to use for @p nacm_user, either @p notif or its filtered duplicate stored
+ * in @p cache. NULL if the notification is denied.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_nacm_check_push_update_notif(const char *nacm_user, struct lyd_node *notif,
-        const struct lyd_node **denied_node);
+sr_error_info_t *sr_nacm_check_notif(struct sr_nacm_notif_cache *cache, const char *nacm_user,
+        const struct lyd_node *notif, const struct lyd_node **nacm_notif);
+
+/**
+ * @brief Free all the cached notification NACM decisions.
+ *
+ * @param[in] cache Cache to clear.
+ */
+void sr_nacm_notif_cache_clear(struct sr_nacm_notif_cache *cache);
 
 /**
  * @brief Check whether a diff (simplified edit-config tree) can be applied by a user.
@@ -178,6 +238,14 @@ sr_error_info_t *sr_nacm_check_push_update_notif(const char *nacm_user, struct l
  */
 sr_error_info_t *sr_nacm_check_diff(const char *nacm_user, const struct lyd_node *diff, const struct lyd_node **denied_node);
 
+/**
+ * @brief Get the current generation of the NACM configuration. Any results filtered by NACM with another generation
+ * may no longer be valid.
+ *
+ * @return NACM configuration generation.
+ */
+uint32_t sr_nacm_get_gen(void);
+
 /**
  * @brief Create a NETCONF error info structure for a NACM error.
  *
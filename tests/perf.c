@@ -16,8 +16,14 @@
 #define _GNU_SOURCE
 
 #include <assert.h>
+#include <errno.h>
+#include <getopt.h>
 #include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <sys/time.h>
 #include <time.h>
 
@@ -26,11 +32,29 @@
 #include "sysrepo.h"
 #include "config.h"
 #include "tests/tcommon.h"
+#include "utils/netconf_acm.h"
 
 #ifdef SR_HAVE_CALLGRIND
 # include <valgrind/callgrind.h>
 #endif
 
+/** maximum depth of the deep scenario data, number of the nested lists in perf-shapes */
+#define SCEN_DEPTH_MAX 8
+
+/** maximum width of the wide scenario data, number of the non-key leaves of the perf-shapes wide list */
+#define SCEN_WIDTH_MAX 16
+
+/** NACM user of the scenario tests */
+#define SCEN_NACM_USER "perf-user"
+
+/** approximate size of a single list instance of the churn test data in the datastore files */
+#define CHURN_INST_SIZE 128
+
+/** directory of the generated modules installed by the connect churn tests */
+#define CHURN_MOD_DIR TESTS_REPO_DIR "/test_repositories/sr_perf_modules"
+
+typedef int (*scen_create_cb)(const struct ly_ctx *ctx, uint32_t count, struct lyd_node **data);
+
 /**
  * @brief Test state structure.
  */
@@ -40,12 +64,19 @@ struct test_state {
     sr_subscription_ctx_t *sub;
     const struct lys_module *mod;
     uint32_t count;
+    struct timespec start_ts;
+    uint32_t cb_count;
+    scen_create_cb scen_create;     /**< Data generator of a scenario test. */
+    const char *scen_path;          /**< Path to read by a scenario test. */
+    int scen_nacm;                  /**< Whether NACM was initialized by a scenario test. */
 };
 
 typedef int (*setup_cb)(uint32_t count, struct test_state *state);
 
 typedef int (*test_cb)(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end);
 
+typedef void (*teardown_cb)(struct test_state *state);
+
 /**
  * @brief Single test structure.
  */
@@ -53,8 +84,61 @@ struct test {
     const char *name;
     setup_cb setup;
     test_cb test;
+    teardown_cb teardown;           /**< Optional teardown, the perf module data are removed if not set. */
+};
+
+/**
+ * @brief Parameters scaling the data of the scenario tests.
+ */
+static struct {
+    uint32_t depth;                 /**< Nesting depth of every deep list instance. */
+    uint32_t width;                 /**< Number of leaves of every wide list instance. */
+} scen = {4, 8};
+
+/**
+ * @brief Parameters scaling the connect, context change, and subscription churn tests.
+ */
+static struct {
+    uint32_t mod_count;             /**< Number of generated modules installed for the connect tests. */
+    uint32_t data_mb;               /**< Size of the existing data of the context change tests in MB. */
+    uint32_t sub_count;             /**< Number of subscriptions of the subscription tests. */
+} churn = {100, 1, 1000};
+
+/**
+ * @brief Contention test state structure, shared by all the threads.
+ */
+struct contention_state {
+    uint32_t count;             /**< Count of list instances, size of the testing data set. */
+    uint32_t ops;               /**< Number of operations performed by each thread. */
+    pthread_barrier_t barrier;  /**< Barrier for starting all the threads at once. */
+};
+
+/**
+ * @brief Contention test thread structure.
+ */
+struct contention_thread {
+    pthread_t tid;
+    struct contention_state *cstate;
+    int writer;                 /**< Whether the thread commits changes or reads data. */
+    uint32_t idx;               /**< Index of the thread among readers or writers. */
+    uint64_t *lat;              /**< Latencies of all the operations in usec. */
+    int ret;                    /**< SR ERR value of the thread. */
+};
+
+/**
+ * @brief Result of a single test with the durations of all its iterations.
+ */
+struct test_result {
+    char name[64];
+    uint64_t *samples;          /**< Duration of every iteration in usec. */
+    uint32_t sample_count;
+    uint64_t avg_usec;          /**< Average duration in usec. */
 };
 
+/** results of all the executed tests */
+static struct test_result *results;
+static uint32_t result_count;
+
 /**
  * @brief Get current time as timespec.
  *
@@ -141,18 +225,247 @@ create_list_inst(const struct lys_module *mod, uint32_t offset, uint32_t count,
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Create data tree with deeply nested list instances, each nested ::scen.depth levels.
+ *
+ * @param[in] ctx Context to use.
+ * @param[in] count Number of top-level list instances to create.
+ * @param[out] data Created data.
+ * @return SR ERR value.
+ */
+static int
+create_deep_inst(const struct ly_ctx *ctx, uint32_t count, struct lyd_node **data)
+{
+    uint32_t i, j;
+    char name[8], id_val[32], val[32];
+    struct lyd_node *parent, *list;
+
+    if (lyd_new_inner(NULL, ly_ctx_get_module_implemented(ctx, "perf-shapes"), "deep", 0, data)) {
+        return SR_ERR_LY;
+    }
+
+    for (i = 0; i < count; ++i) {
+        sprintf(id_val, "%" PRIu32, i);
+        parent = *data;
+        for (j = 1; j <= scen.depth; ++j) {
+            if ((j > 1) && lyd_new_inner(parent, NULL, "sub", 0, &parent)) {
+                return SR_ERR_LY;
+            }
+
+            sprintf(name, "l%" PRIu32, j);
+            sprintf(val, "v%" PRIu32 "-%" PRIu32, i, j);
+            if (lyd_new_list(parent, NULL, name, 0, &list, id_val)) {
+                return SR_ERR_LY;
+            }
+            if (lyd_new_term(list, NULL, "val", val, 0, NULL)) {
+                return SR_ERR_LY;
+            }
+            parent = list;
+        }
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Create data tree with wide list instances, each with ::scen.width leaves.
+ *
+ * @param[in] ctx Context to use.
+ * @param[in] count Number of list instances to create.
+ * @param[out] data Created data.
+ * @return SR ERR value.
+ */
+static int
+create_wide_inst(const struct ly_ctx *ctx, uint32_t count, struct lyd_node **data)
+{
+    uint32_t i, j;
+    char name[8], id_val[32], val[32];
+    struct lyd_node *list;
+
+    if (lyd_new_inner(NULL, ly_ctx_get_module_implemented(ctx, "perf-shapes"), "wide", 0, data)) {
+        return SR_ERR_LY;
+    }
+
+    for (i = 0; i < count; ++i) {
+        sprintf(id_val, "%" PRIu32, i);
+        if (lyd_new_list(*data, NULL, "item", 0, &list, id_val)) {
+            return SR_ERR_LY;
+        }
+        for (j = 1; j <= scen.width; ++j) {
+            sprintf(name, "l%" PRIu32, j);
+            sprintf(val, "v%" PRIu32 "-%" PRIu32, i, j);
+            if (lyd_new_term(list, NULL, name, val, 0, NULL)) {
+                return SR_ERR_LY;
+            }
+        }
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Create data tree with user-ordered list instances.
+ *
+ * @param[in] ctx Context to use.
+ * @param[in] count Number of list instances to create.
+ * @param[out] data Created data.
+ * @return SR ERR value.
+ */
+static int
+create_ordered_inst(const struct ly_ctx *ctx, uint32_t count, struct lyd_node **data)
+{
+    uint32_t i;
+    char id_val[32], val[32];
+    struct lyd_node *list;
+
+    if (lyd_new_inner(NULL, ly_ctx_get_module_implemented(ctx, "perf-shapes"), "ordered", 0, data)) {
+        return SR_ERR_LY;
+    }
+
+    for (i = 0; i < count; ++i) {
+        sprintf(id_val, "%" PRIu32, i);
+        sprintf(val, "v%" PRIu32, i);
+        if (lyd_new_list(*data, NULL, "item", 0, &list, id_val)) {
+            return SR_ERR_LY;
+        }
+        if (lyd_new_term(list, NULL, "val", val, 0, NULL)) {
+            return SR_ERR_LY;
+        }
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Create data tree with leafref targets and the same number of list instances referencing them
+ * from another module, each with a must constraint.
+ *
+ * @param[in] ctx Context to use.
+ * @param[in] count Number of targets and references to create.
+ * @param[out] data Created data.
+ * @return SR ERR value.
+ */
+static int
+create_leafref_inst(const struct ly_ctx *ctx, uint32_t count, struct lyd_node **data)
+{
+    uint32_t i;
+    char id_val[32], name_val[32];
+    struct lyd_node *refs, *list;
+
+    if (lyd_new_inner(NULL, ly_ctx_get_module_implemented(ctx, "perf-shapes"), "targets", 0, data)) {
+        return SR_ERR_LY;
+    }
+    if (lyd_new_inner(NULL, ly_ctx_get_module_implemented(ctx, "perf-ref"), "refs", 0, &refs)) {
+        return SR_ERR_LY;
+    }
+    if (lyd_insert_sibling(*data, refs, NULL)) {
+        return SR_ERR_LY;
+    }
+
+    for (i = 0; i < count; ++i) {
+        sprintf(id_val, "%" PRIu32, i);
+        sprintf(name_val, "t%" PRIu32, i);
+        if (lyd_new_list(*data, NULL, "target", 0, NULL, name_val)) {
+            return SR_ERR_LY;
+        }
+        if (lyd_new_list(refs, NULL, "ref", 0, &list, id_val)) {
+            return SR_ERR_LY;
+        }
+        if (lyd_new_term(list, NULL, "target", name_val, 0, NULL)) {
+            return SR_ERR_LY;
+        }
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Create perf-upd data tree of approximately ::churn.data_mb MB.
+ *
+ * @param[in] ctx Context to use.
+ * @param[out] data Created data.
+ * @return SR ERR value.
+ */
+static int
+create_churn_inst(const struct ly_ctx *ctx, struct lyd_node **data)
+{
+    uint32_t i, count;
+    char k_val[32], l_val[128];
+    struct lyd_node *list;
+
+    if (lyd_new_path(NULL, ctx, "/perf-upd:cont", NULL, 0, data)) {
+        return SR_ERR_LY;
+    }
+
+    count = (churn.data_mb * 1024 * 1024) / CHURN_INST_SIZE;
+    for (i = 0; i < count; ++i) {
+        sprintf(k_val, "%" PRIu32, i);
+        sprintf(l_val, "%0100" PRIu32, i);
+
+        if (lyd_new_list(*data, NULL, "lst", 0, &list, k_val)) {
+            return SR_ERR_LY;
+        }
+        if (lyd_new_term(list, NULL, "l", l_val, 0, NULL)) {
+            return SR_ERR_LY;
+        }
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Remember the result of a test.
+ *
+ * @param[in] name Name of the test.
+ * @param[in] samples Duration of every iteration in usec.
+ * @param[in] sample_count Count of @p samples.
+ * @return SR ERR value.
+ */
+static int
+result_add(const char *name, const uint64_t *samples, uint32_t sample_count)
+{
+    struct test_result *res;
+    uint64_t sum = 0;
+    uint32_t i;
+    void *mem;
+
+    mem = realloc(results, (result_count + 1) * sizeof *results);
+    if (!mem) {
+        return SR_ERR_NO_MEMORY;
+    }
+    results = mem;
+    res = &results[result_count];
+
+    res->samples = malloc(sample_count * sizeof *res->samples);
+    if (!res->samples) {
+        return SR_ERR_NO_MEMORY;
+    }
+    ++result_count;
+
+    snprintf(res->name, sizeof res->name, "%s", name);
+    memcpy(res->samples, samples, sample_count * sizeof *samples);
+    res->sample_count = sample_count;
+    for (i = 0; i < sample_count; ++i) {
+        sum += samples[i];
+    }
+    res->avg_usec = sample_count ? sum / sample_count : 0;
+
+    return SR_ERR_OK;
+}
+
 /**
  * @brief Execute a test.
  *
  * @param[in] setup Setup callback to call once.
  * @param[in] test Test callback.
+ * @param[in] teardown Optional teardown callback.
  * @param[in] name Name of the test.
  * @param[in] count Count of list instances, size of the testing data set.
  * @param[in] tries Number of (re)tries of the test to get more accurate measurements.
  * @return SR ERR value.
  */
 static int
-exec_test(setup_cb setup, test_cb test, const char *name, uint32_t count, uint32_t tries)
+exec_test(setup_cb setup, test_cb test, teardown_cb teardown, const char *name, uint32_t count, uint32_t tries)
 {
     int ret;
     struct timespec ts_start, ts_end;
@@ -160,7 +473,12 @@ exec_test(setup_cb setup, test_cb test, const char *name, uint32_t count, uint32
     const uint32_t name_fixed_len = 37;
     char str[name_fixed_len + 1];
     uint32_t i, printed;
-    uint64_t time_usec = 0;
+    uint64_t time_usec = 0, *samples;
+
+    samples = malloc(tries * sizeof *samples);
+    if (!samples) {
+        return SR_ERR_NO_MEMORY;
+    }
 
     /* print test start */
     printed = sprintf(str, "| %s ", name);
@@ -184,15 +502,25 @@ exec_test(setup_cb setup, test_cb test, const char *name, uint32_t count, uint32
         if ((ret = test(&state, &ts_start, &ts_end))) {
             return ret;
         }
-        time_usec += time_diff(&ts_start, &ts_end);
+        samples[i] = time_diff(&ts_start, &ts_end);
+        time_usec += samples[i];
     }
     time_usec /= tries;
+    ret = result_add(name, samples, tries);
+    free(samples);
+    if (ret) {
+        return ret;
+    }
 
     /* teardown */
-    sr_delete_item(state.sess, "/perf:cont", 0);
-    sr_apply_changes(state.sess, 0);
-    sr_unsubscribe(state.sub);
-    sr_release_context(state.conn);
+    if (teardown) {
+        teardown(&state);
+    } else {
+        sr_delete_item(state.sess, "/perf:cont", 0);
+        sr_apply_changes(state.sess, 0);
+        sr_unsubscribe(state.sub);
+        sr_release_context(state.conn);
+    }
     sr_disconnect(state.conn);
 
     /* print time */
@@ -300,6 +628,40 @@ oper_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, con
     return create_list_inst(state->mod, 0, state->count, parent);
 }
 
+static int
+rpc_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *op_path, const struct lyd_node *input,
+        sr_event_t event, uint32_t request_id, struct lyd_node *output, void *private_data)
+{
+    (void)session;
+    (void)sub_id;
+    (void)op_path;
+    (void)event;
+    (void)request_id;
+    (void)private_data;
+
+    if (!strcmp(LYD_NAME(input), "rpc1") && lyd_new_term(output, NULL, "l", "output", 1, NULL)) {
+        return SR_ERR_LY;
+    }
+
+    return SR_ERR_OK;
+}
+
+static void
+notif_cb(sr_session_ctx_t *session, uint32_t sub_id, const sr_ev_notif_type_t notif_type,
+        const struct lyd_node *notif, struct timespec *timestamp, void *private_data)
+{
+    struct test_state *state = private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)notif;
+    (void)timestamp;
+
+    if ((notif_type == SR_EV_NOTIF_REALTIME) || (notif_type == SR_EV_NOTIF_REPLAY)) {
+        ++state->cb_count;
+    }
+}
+
 /* TEST SETUP */
 static int
 setup_running(uint32_t count, struct test_state *state)
@@ -421,177 +783,1662 @@ setup_subscribe_oper(uint32_t count, struct test_state *state)
     return SR_ERR_OK;
 }
 
-/* TEST CB */
 static int
-test_get_tree(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+setup_subscribe_rpc(uint32_t count, struct test_state *state)
 {
     int r;
-    sr_data_t *data;
-    char path[64];
-
-    sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "' and k2='str%" PRIu32 "']/l", state->count / 2, state->count / 2);
 
-    TEST_START(ts_start);
-
-    if ((r = sr_get_data(state->sess, path, 0, 0, 0, &data))) {
+    if ((r = sr_connect(0, &state->conn))) {
         return r;
     }
-
-    TEST_END(ts_end);
-
-    sr_release_data(data);
+    if ((r = sr_session_start(state->conn, SR_DS_RUNNING, &state->sess))) {
+        return r;
+    }
+    if ((r = sr_rpc_subscribe_tree(state->sess, "/perf:rpc1", rpc_cb, NULL, 0, 0, &state->sub))) {
+        return r;
+    }
+    state->mod = ly_ctx_get_module_implemented(sr_acquire_context(state->conn), "perf");
+    state->count = count;
 
     return SR_ERR_OK;
 }
 
 static int
-test_get_item(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+setup_subscribe_action(uint32_t count, struct test_state *state)
 {
     int r;
-    sr_val_t *val;
-    char path[64];
-
-    sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "' and k2='str%" PRIu32 "']/l", state->count / 2, state->count / 2);
 
-    TEST_START(ts_start);
-
-    if ((r = sr_get_item(state->sess, path, 0, &val))) {
+    /* the action parent must exist */
+    if ((r = setup_running(count, state))) {
+        return r;
+    }
+    if ((r = sr_rpc_subscribe_tree(state->sess, "/perf:cont/lst/act", rpc_cb, NULL, 0, 0, &state->sub))) {
         return r;
     }
-
-    TEST_END(ts_end);
-
-    sr_free_val(val);
 
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Setup notification subscribers.
+ *
+ * @param[in] count Count of list instances, size of the testing data set.
+ * @param[in] state Test state.
+ * @param[in] sub_count Count of notification subscriptions.
+ * @return SR ERR value.
+ */
 static int
-test_get_tree_hash(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+setup_subscribe_notif(uint32_t count, struct test_state *state, uint32_t sub_count)
 {
     int r;
-    sr_data_t *data;
-    char path[64];
-
-    sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "'][k2='str%" PRIu32 "']/l", state->count / 2, state->count / 2);
-
-    TEST_START(ts_start);
+    uint32_t i;
 
-    if ((r = sr_get_data(state->sess, path, 0, 0, 0, &data))) {
+    if ((r = sr_connect(0, &state->conn))) {
         return r;
     }
-
-    TEST_END(ts_end);
-
-    sr_release_data(data);
+    if ((r = sr_set_module_replay_support(state->conn, "perf", 0))) {
+        return r;
+    }
+    if ((r = sr_session_start(state->conn, SR_DS_RUNNING, &state->sess))) {
+        return r;
+    }
+    for (i = 0; i < sub_count; ++i) {
+        if ((r = sr_notif_subscribe_tree(state->sess, "perf", NULL, NULL, NULL, notif_cb, state, 0, &state->sub))) {
+            return r;
+        }
+    }
+    state->mod = ly_ctx_get_module_implemented(sr_acquire_context(state->conn), "perf");
+    state->count = count;
 
     return SR_ERR_OK;
 }
 
 static int
-test_edit_item_create(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+setup_subscribe_notif1(uint32_t count, struct test_state *state)
 {
-    int r;
+    return setup_subscribe_notif(count, state, 1);
+}
+
+static int
+setup_subscribe_notif10(uint32_t count, struct test_state *state)
+{
+    return setup_subscribe_notif(count, state, 10);
+}
+
+static int
+setup_subscribe_notif100(uint32_t count, struct test_state *state)
+{
+    return setup_subscribe_notif(count, state, 100);
+}
+
+static int
+setup_notif_buffer(uint32_t count, struct test_state *state)
+{
+    int r;
+
+    if ((r = sr_connect(0, &state->conn))) {
+        return r;
+    }
+    if ((r = sr_set_module_replay_support(state->conn, "perf", 1))) {
+        return r;
+    }
+    if ((r = sr_session_start(state->conn, SR_DS_RUNNING, &state->sess))) {
+        return r;
+    }
+    if ((r = sr_session_notif_buffer(state->sess))) {
+        return r;
+    }
+    state->mod = ly_ctx_get_module_implemented(sr_acquire_context(state->conn), "perf");
+    state->count = count;
+
+    return SR_ERR_OK;
+}
+
+static int
+setup_notif_replay(uint32_t count, struct test_state *state)
+{
+    int r;
+    uint32_t i;
+    sr_session_ctx_t *sess;
+    struct lyd_node *notif;
+
+    if ((r = sr_connect(0, &state->conn))) {
+        return r;
+    }
+    if ((r = sr_set_module_replay_support(state->conn, "perf", 1))) {
+        return r;
+    }
+    if ((r = sr_session_start(state->conn, SR_DS_RUNNING, &state->sess))) {
+        return r;
+    }
+    state->mod = ly_ctx_get_module_implemented(sr_acquire_context(state->conn), "perf");
+    state->count = count;
+
+    /* replay only the notifications stored now */
+    clock_gettime(CLOCK_REALTIME, &state->start_ts);
+
+    /* store the notifications */
+    if ((r = sr_session_start(state->conn, SR_DS_RUNNING, &sess))) {
+        return r;
+    }
+    if ((r = sr_session_notif_buffer(sess))) {
+        return r;
+    }
+    if (lyd_new_path(NULL, sr_acquire_context(state->conn), "/perf:notif/l", "val", 0, &notif)) {
+        return SR_ERR_LY;
+    }
+    sr_release_context(state->conn);
+    for (i = 0; i < count; ++i) {
+        if ((r = sr_notif_send_tree(sess, notif, 0, 0))) {
+            return r;
+        }
+    }
+    lyd_free_tree(notif);
+
+    /* flush the buffer */
+    sr_session_stop(sess);
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Store scenario data into running.
+ *
+ * @param[in] state Test state.
+ * @param[in] create Scenario data generator.
+ * @return SR ERR value.
+ */
+static int
+setup_scen_store(struct test_state *state, scen_create_cb create)
+{
+    int r;
+    struct lyd_node *data;
+
+    r = create(sr_acquire_context(state->conn), state->count, &data);
+    sr_release_context(state->conn);
+    if (r) {
+        return r;
+    }
+    if ((r = sr_edit_batch(state->sess, data, "merge"))) {
+        return r;
+    }
+    lyd_free_siblings(data);
+
+    return sr_apply_changes(state->sess, state->count * 100);
+}
+
+/**
+ * @brief Prepare a scenario test, optionally storing its data into running.
+ *
+ * @param[in] count Size of the scenario data set.
+ * @param[in] state Test state.
+ * @param[in] create Scenario data generator.
+ * @param[in] path Path to read by the test.
+ * @param[in] store Whether to store the scenario data.
+ * @return SR ERR value.
+ */
+static int
+setup_scen(uint32_t count, struct test_state *state, scen_create_cb create, const char *path, int store)
+{
+    int r;
+
+    if ((r = sr_connect(0, &state->conn))) {
+        return r;
+    }
+    if ((r = sr_session_start(state->conn, SR_DS_RUNNING, &state->sess))) {
+        return r;
+    }
+    state->count = count;
+    state->scen_create = create;
+    state->scen_path = path;
+
+    if (store) {
+        return setup_scen_store(state, create);
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Prepare a scenario test with its data stored and read access of @ref SCEN_NACM_USER filtered by NACM.
+ *
+ * @param[in] count Size of the scenario data set.
+ * @param[in] state Test state.
+ * @param[in] create Scenario data generator.
+ * @param[in] path Path to read by the test.
+ * @return SR ERR value.
+ */
+static int
+setup_scen_nacm(uint32_t count, struct test_state *state, scen_create_cb create, const char *path)
+{
+    int r;
+    const char *nacm_xml;
+    struct lyd_node *nacm;
+
+    if ((r = setup_scen(count, state, create, path, 1))) {
+        return r;
+    }
+    if ((r = sr_nacm_init(state->sess, 0, &state->sub))) {
+        return r;
+    }
+    state->scen_nacm = 1;
+
+    /* deny some nodes to force rule evaluation of every node */
+    nacm_xml = "<nacm xmlns=\"urn:ietf:params:xml:ns:yang:ietf-netconf-acm\">"
+            "<enable-external-groups>false</enable-external-groups>"
+            "<groups><group><name>perf-group</name><user-name>" SCEN_NACM_USER "</user-name></group></groups>"
+            "<rule-list><name>perf-rules</name><group>perf-group</group>"
+            "<rule><name>deny-l1</name><module-name>perf-shapes</module-name>"
+            "<path xmlns:ps=\"urn:sysrepo:tests:perf-shapes\">/ps:wide/ps:item/ps:l1</path>"
+            "<access-operations>read</access-operations><action>deny</action></rule>"
+            "<rule><name>deny-deep-val</name><module-name>perf-shapes</module-name>"
+            "<path xmlns:ps=\"urn:sysrepo:tests:perf-shapes\">/ps:deep/ps:l1/ps:val</path>"
+            "<access-operations>read</access-operations><action>deny</action></rule>"
+            "</rule-list></nacm>";
+    r = lyd_parse_data_mem(sr_acquire_context(state->conn), nacm_xml, LYD_XML, LYD_PARSE_STRICT | LYD_PARSE_ONLY, 0,
+            &nacm);
+    sr_release_context(state->conn);
+    if (r) {
+        return SR_ERR_LY;
+    }
+    if ((r = sr_edit_batch(state->sess, nacm, "merge"))) {
+        return r;
+    }
+    lyd_free_siblings(nacm);
+    if ((r = sr_apply_changes(state->sess, 0))) {
+        return r;
+    }
+
+    return sr_nacm_set_user(state->sess, SCEN_NACM_USER);
+}
+
+static int
+setup_scen_deep_empty(uint32_t count, struct test_state *state)
+{
+    return setup_scen(count, state, create_deep_inst, "/perf-shapes:deep", 0);
+}
+
+static int
+setup_scen_deep_nacm(uint32_t count, struct test_state *state)
+{
+    return setup_scen_nacm(count, state, create_deep_inst, "/perf-shapes:deep");
+}
+
+static int
+setup_scen_wide_empty(uint32_t count, struct test_state *state)
+{
+    return setup_scen(count, state, create_wide_inst, "/perf-shapes:wide", 0);
+}
+
+static int
+setup_scen_wide_nacm(uint32_t count, struct test_state *state)
+{
+    return setup_scen_nacm(count, state, create_wide_inst, "/perf-shapes:wide");
+}
+
+static int
+setup_scen_leafref_empty(uint32_t count, struct test_state *state)
+{
+    return setup_scen(count, state, create_leafref_inst, "/perf-ref:refs", 0);
+}
+
+static int
+setup_scen_leafref(uint32_t count, struct test_state *state)
+{
+    return setup_scen(count, state, create_leafref_inst, "/perf-ref:refs", 1);
+}
+
+static int
+setup_scen_ordered_empty(uint32_t count, struct test_state *state)
+{
+    return setup_scen(count, state, create_ordered_inst, "/perf-shapes:ordered", 0);
+}
+
+static int
+setup_scen_ordered(uint32_t count, struct test_state *state)
+{
+    return setup_scen(count, state, create_ordered_inst, "/perf-shapes:ordered", 1);
+}
+
+static int
+setup_scen_ctx(uint32_t count, struct test_state *state)
+{
+    int r;
+
+    /* data of all the shapes revalidated on every context change */
+    if ((r = setup_scen(count, state, create_deep_inst, NULL, 1))) {
+        return r;
+    }
+    if ((r = setup_scen_store(state, create_wide_inst))) {
+        return r;
+    }
+    return setup_scen_store(state, create_leafref_inst);
+}
+
+/**
+ * @brief Generate the names or the schema file paths of all the churn test modules.
+ *
+ * @param[in] paths Whether to generate the schema file paths or the module names.
+ * @param[out] strs Generated NULL-terminated array.
+ * @return SR ERR value.
+ */
+static int
+churn_mod_strs(int paths, char ***strs)
+{
+    uint32_t i;
+    int r;
+
+    *strs = calloc(churn.mod_count + 1, sizeof **strs);
+    if (!*strs) {
+        return SR_ERR_NO_MEMORY;
+    }
+
+    for (i = 0; i < churn.mod_count; ++i) {
+        if (paths) {
+            r = asprintf(&(*strs)[i], "%s/perf-gen-%" PRIu32 ".yang", CHURN_MOD_DIR, i);
+        } else {
+            r = asprintf(&(*strs)[i], "perf-gen-%" PRIu32, i);
+        }
+        if (r == -1) {
+            (*strs)[i] = NULL;
+            return SR_ERR_NO_MEMORY;
+        }
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Free an array generated by ::churn_mod_strs().
+ *
+ * @param[in] strs Array to free.
+ */
+static void
+churn_mod_strs_free(char **strs)
+{
+    uint32_t i;
+
+    for (i = 0; strs && strs[i]; ++i) {
+        free(strs[i]);
+    }
+    free(strs);
+}
+
+/**
+ * @brief Remove all the generated churn test modules.
+ *
+ * @param[in] conn Connection to use.
+ * @return SR ERR value.
+ */
+static int
+churn_mods_remove(sr_conn_ctx_t *conn)
+{
+    char **names;
+    int r;
+
+    if ((r = churn_mod_strs(0, &names))) {
+        churn_mod_strs_free(names);
+        return r;
+    }
+    r = sr_remove_modules(conn, (const char **)names, 0);
+    churn_mod_strs_free(names);
+
+    return r;
+}
+
+/**
+ * @brief Store approximately ::churn.data_mb MB of perf-upd data into running and startup.
+ *
+ * @param[in] state Test state.
+ * @return SR ERR value.
+ */
+static int
+churn_data_store(struct test_state *state)
+{
+    int r;
+    struct lyd_node *data;
+
+    r = create_churn_inst(sr_acquire_context(state->conn), &data);
+    sr_release_context(state->conn);
+    if (r) {
+        return r;
+    }
+    if ((r = sr_edit_batch(state->sess, data, "merge"))) {
+        return r;
+    }
+    lyd_free_siblings(data);
+    if ((r = sr_apply_changes(state->sess, 0))) {
+        return r;
+    }
+
+    /* the data of both datastores are updated on a context change */
+    if ((r = sr_session_switch_ds(state->sess, SR_DS_STARTUP))) {
+        return r;
+    }
+    if ((r = sr_copy_config(state->sess, "perf-upd", SR_DS_RUNNING, 0))) {
+        return r;
+    }
+    return sr_session_switch_ds(state->sess, SR_DS_RUNNING);
+}
+
+static int
+setup_churn_connect(uint32_t count, struct test_state *state)
+{
+    int r;
+    uint32_t i;
+    char **paths;
+    FILE *f;
+
+    if ((r = sr_connect(0, &state->conn))) {
+        return r;
+    }
+    state->count = count;
+
+    /* generate the modules */
+    if ((mkdir(CHURN_MOD_DIR, 00777) == -1) && (errno != EEXIST)) {
+        return SR_ERR_SYS;
+    }
+    if ((r = churn_mod_strs(1, &paths))) {
+        goto cleanup;
+    }
+    for (i = 0; i < churn.mod_count; ++i) {
+        if (!(f = fopen(paths[i], "w"))) {
+            r = SR_ERR_SYS;
+            goto cleanup;
+        }
+        fprintf(f, "module perf-gen-%" PRIu32 " {\n    yang-version 1.1;\n    namespace \"urn:sysrepo:tests:perf-gen-%"
+                PRIu32 "\";\n    prefix pg;\n\n    container cont {\n        leaf l {\n            type string;\n"
+                "        }\n    }\n}\n", i, i);
+        fclose(f);
+    }
+
+    /* install them all at once, any left by an interrupted run are replaced */
+    r = sr_install_modules(state->conn, (const char **)paths, NULL, NULL);
+    if (r == SR_ERR_EXISTS) {
+        churn_mods_remove(state->conn);
+        r = sr_install_modules(state->conn, (const char **)paths, NULL, NULL);
+    }
+
+cleanup:
+    churn_mod_strs_free(paths);
+    return r;
+}
+
+static int
+setup_churn_sub(uint32_t count, struct test_state *state)
+{
+    int r;
+
+    if ((r = sr_connect(0, &state->conn))) {
+        return r;
+    }
+    if ((r = sr_session_start(state->conn, SR_DS_RUNNING, &state->sess))) {
+        return r;
+    }
+    state->count = count;
+
+    return SR_ERR_OK;
+}
+
+static int
+setup_churn_ctx(uint32_t count, struct test_state *state)
+{
+    int r;
+
+    if ((r = setup_churn_sub(count, state))) {
+        return r;
+    }
+
+    /* remove any modules left by an interrupted run */
+    sr_remove_module(state->conn, "perf-upd-aug", 0);
+    sr_remove_module(state->conn, "perf-upd", 0);
+
+    return SR_ERR_OK;
+}
+
+static int
+setup_churn_ctx_data(uint32_t count, struct test_state *state)
+{
+    int r;
+
+    if ((r = setup_churn_ctx(count, state))) {
+        return r;
+    }
+    if ((r = sr_install_module(state->conn, TESTS_SRC_DIR "/files/perf-upd.yang", TESTS_SRC_DIR "/files", NULL))) {
+        return r;
+    }
+    return churn_data_store(state);
+}
+
+/* TEST CB */
+static int
+test_get_tree(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    sr_data_t *data;
+    char path[64];
+
+    sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "' and k2='str%" PRIu32 "']/l", state->count / 2, state->count / 2);
+
+    TEST_START(ts_start);
+
+    if ((r = sr_get_data(state->sess, path, 0, 0, 0, &data))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    sr_release_data(data);
+
+    return SR_ERR_OK;
+}
+
+static int
+test_get_item(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    sr_val_t *val;
+    char path[64];
+
+    sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "' and k2='str%" PRIu32 "']/l", state->count / 2, state->count / 2);
+
+    TEST_START(ts_start);
+
+    if ((r = sr_get_item(state->sess, path, 0, &val))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    sr_free_val(val);
+
+    return SR_ERR_OK;
+}
+
+static int
+test_get_tree_hash(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    sr_data_t *data;
+    char path[64];
+
+    sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "'][k2='str%" PRIu32 "']/l", state->count / 2, state->count / 2);
+
+    TEST_START(ts_start);
+
+    if ((r = sr_get_data(state->sess, path, 0, 0, 0, &data))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    sr_release_data(data);
+
+    return SR_ERR_OK;
+}
+
+static int
+test_edit_item_create(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    struct lyd_node *data;
+
+    TEST_START(ts_start);
+
+    if ((r = create_list_inst(state->mod, 0, state->count, &data))) {
+        return r;
+    }
+
+    if ((r = sr_edit_batch(state->sess, data, "merge"))) {
+        return r;
+    }
+
+    if ((r = sr_apply_changes(state->sess, state->count * 100))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    lyd_free_siblings(data);
+
+    if ((r = sr_delete_item(state->sess, "/perf:cont/lst", 0))) {
+        return r;
+    }
+    if ((r = sr_apply_changes(state->sess, state->count * 100))) {
+        return r;
+    }
+
+    return SR_ERR_OK;
+}
+
+static int
+test_edit_batch_create(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    uint32_t i;
+    char path[64], l_val[32];
+
+    TEST_START(ts_start);
+
+    for (i = 0; i < state->count; ++i) {
+        sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "'][k2='str%" PRIu32 "']/l", i, i);
+        sprintf(l_val, "l%" PRIu32, i);
+        if ((r = sr_set_item_str(state->sess, path, l_val, NULL, 0))) {
+            return r;
+        }
+    }
+
+    if ((r = sr_apply_changes(state->sess, state->count * 100))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    if ((r = sr_delete_item(state->sess, "/perf:cont/lst", 0))) {
+        return r;
+    }
+    if ((r = sr_apply_changes(state->sess, state->count * 100))) {
+        return r;
+    }
+
+    return SR_ERR_OK;
+}
+
+static int
+test_oper_get_tree(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    sr_data_t *data;
+
+    sr_session_switch_ds(state->sess, SR_DS_OPERATIONAL);
+
+    TEST_START(ts_start);
+
+    if ((r = sr_get_data(state->sess, "/perf:cont", 0, 0, 0, &data))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    sr_release_data(data);
+    sr_session_switch_ds(state->sess, SR_DS_RUNNING);
+
+    return SR_ERR_OK;
+}
+
+/* TEST CONTENTION CB */
+static int
+contention_change_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    (void)session;
+    (void)sub_id;
+    (void)module_name;
+    (void)xpath;
+    (void)event;
+    (void)request_id;
+    (void)private_data;
+
+    return SR_ERR_OK;
+}
+
+static void *
+contention_thread(void *arg)
+{
+    struct contention_thread *th = arg;
+    struct contention_state *cstate = th->cstate;
+    sr_conn_ctx_t *conn = NULL;
+    sr_session_ctx_t *sess = NULL;
+    sr_data_t *data;
+    struct timespec ts_start, ts_end;
+    char path[96], l_val[32];
+    uint32_t i;
+    int r;
+
+    /* every thread uses its own connection */
+    if ((r = sr_connect(0, &conn))) {
+        goto cleanup;
+    }
+    if ((r = sr_session_start(conn, SR_DS_RUNNING, &sess))) {
+        goto cleanup;
+    }
+
+    if (th->writer) {
+        /* each writer changes its own list instance */
+        sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "'][k2='writer']/l", cstate->count + th->idx);
+    } else {
+        sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "' and k2='str%" PRIu32 "']/l", cstate->count / 2,
+                cstate->count / 2);
+    }
+
+cleanup:
+    th->ret = r;
+
+    /* start all the threads at once, even if some failed */
+    pthread_barrier_wait(&cstate->barrier);
+
+    for (i = 0; !th->ret && (i < cstate->ops); ++i) {
+        time_get(&ts_start);
+
+        if (th->writer) {
+            sprintf(l_val, "l%" PRIu32, i);
+            if ((r = sr_set_item_str(sess, path, l_val, NULL, 0))) {
+                th->ret = r;
+                break;
+            }
+            if ((r = sr_apply_changes(sess, 0))) {
+                th->ret = r;
+                break;
+            }
+        } else {
+            if ((r = sr_get_data(sess, path, 0, 0, 0, &data))) {
+                th->ret = r;
+                break;
+            }
+            sr_release_data(data);
+        }
+
+        time_get(&ts_end);
+        th->lat[i] = time_diff(&ts_start, &ts_end);
+    }
+
+    sr_disconnect(conn);
+    return NULL;
+}
+
+/**
+ * @brief Compare 2 latencies for sorting.
+ */
+static int
+contention_lat_cmp(const void *ptr1, const void *ptr2)
+{
+    uint64_t lat1 = *(uint64_t *)ptr1, lat2 = *(uint64_t *)ptr2;
+
+    return (lat1 > lat2) - (lat1 < lat2);
+}
+
+/**
+ * @brief Print results of operations of a single kind in a contention test.
+ *
+ * @param[in] name Name of the operations.
+ * @param[in] threads Contention test threads.
+ * @param[in] thread_count Count of @p threads.
+ * @param[in] writer Whether to print the results of writers or readers.
+ * @param[in] time_usec Length of the whole test in usec.
+ * @return SR ERR value.
+ */
+static int
+contention_print(const char *name, struct contention_thread *threads, uint32_t thread_count, int writer,
+        uint64_t time_usec)
+{
+    const uint32_t name_fixed_len = 37;
+    char str[name_fixed_len + 1];
+    uint64_t *lat;
+    uint32_t i, lat_count = 0, ops, printed;
+
+    ops = threads[0].cstate->ops;
+    lat = malloc(thread_count * ops * sizeof *lat);
+    if (!lat) {
+        return SR_ERR_NO_MEMORY;
+    }
+
+    /* merge the latencies of all the threads */
+    for (i = 0; i < thread_count; ++i) {
+        if (threads[i].writer == writer) {
+            memcpy(lat + lat_count, threads[i].lat, ops * sizeof *lat);
+            lat_count += ops;
+        }
+    }
+    if (!lat_count) {
+        free(lat);
+        return SR_ERR_OK;
+    }
+    qsort(lat, lat_count, sizeof *lat, contention_lat_cmp);
+    if (result_add(name, lat, lat_count)) {
+        free(lat);
+        return SR_ERR_NO_MEMORY;
+    }
+
+    printed = sprintf(str, "| %s ", name);
+    while (printed + 2 < name_fixed_len) {
+        printed += sprintf(str + printed, ".");
+    }
+    if (printed + 1 < name_fixed_len) {
+        printed += sprintf(str + printed, " ");
+    }
+    sprintf(str + printed, "|");
+    printf("%s %8" PRIu64 " op/s | p50 %8" PRIu64 " us | p99 %8" PRIu64 " us | p999 %8" PRIu64 " us |\n", str,
+            time_usec ? ((uint64_t)lat_count * 1000000) / time_usec : 0, lat[(lat_count - 1) / 2],
+            lat[((lat_count - 1) * 99) / 100], lat[((lat_count - 1) * 999) / 1000]);
+
+    free(lat);
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Execute a contention test of concurrent readers and writers with change subscribers.
+ *
+ * @param[in] count Count of list instances, size of the testing data set.
+ * @param[in] tries Number of (re)tries of the test, each thread performs 10 operations per try.
+ * @param[in] readers Number of reading threads.
+ * @param[in] writers Number of committing threads.
+ * @param[in] subscribers Number of change subscriptions, each on its own connection.
+ * @return SR ERR value.
+ */
+static int
+exec_contention_test(uint32_t count, uint32_t tries, uint32_t readers, uint32_t writers, uint32_t subscribers)
+{
+    int ret;
+    struct test_state state = {0};
+    struct contention_state cstate = {0};
+    struct contention_thread *threads = NULL;
+    sr_conn_ctx_t **sub_conns = NULL;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *sub = NULL;
+    struct timespec ts_start, ts_end;
+    uint32_t i, thread_count = readers + writers;
+    uint64_t time_usec;
+
+    printf("| contention: %" PRIu32 " readers, %" PRIu32 " writers, %" PRIu32 " subscribers\n", readers, writers,
+            subscribers);
+
+    /* setup running data */
+    if ((ret = setup_running(count, &state))) {
+        return ret;
+    }
+
+    /* subscribers, each on its own connection */
+    sub_conns = calloc(subscribers, sizeof *sub_conns);
+    threads = calloc(thread_count, sizeof *threads);
+    if ((subscribers && !sub_conns) || !threads) {
+        ret = SR_ERR_NO_MEMORY;
+        goto cleanup;
+    }
+    for (i = 0; i < subscribers; ++i) {
+        if ((ret = sr_connect(0, &sub_conns[i]))) {
+            goto cleanup;
+        }
+        if ((ret = sr_session_start(sub_conns[i], SR_DS_RUNNING, &sess))) {
+            goto cleanup;
+        }
+        sub = NULL;
+        if ((ret = sr_module_change_subscribe(sess, "perf", NULL, contention_change_cb, NULL, 0, 0, &sub))) {
+            goto cleanup;
+        }
+    }
+
+    cstate.count = count;
+    cstate.ops = tries * 10;
+    pthread_barrier_init(&cstate.barrier, NULL, thread_count + 1);
+
+    /* readers and writers */
+    for (i = 0; i < thread_count; ++i) {
+        threads[i].cstate = &cstate;
+        threads[i].writer = (i < writers) ? 1 : 0;
+        threads[i].idx = (i < writers) ? i : i - writers;
+        threads[i].lat = calloc(cstate.ops, sizeof *threads[i].lat);
+        if (!threads[i].lat) {
+            ret = SR_ERR_NO_MEMORY;
+            break;
+        }
+        if (pthread_create(&threads[i].tid, NULL, contention_thread, &threads[i])) {
+            ret = SR_ERR_SYS;
+            break;
+        }
+    }
+    if (ret) {
+        /* the barrier would never be passed */
+        fprintf(stderr, "Failed to create the contention test threads.\n");
+        exit(ret);
+    }
+
+    /* start */
+    pthread_barrier_wait(&cstate.barrier);
+    time_get(&ts_start);
+
+    for (i = 0; i < thread_count; ++i) {
+        pthread_join(threads[i].tid, NULL);
+        if (threads[i].ret && !ret) {
+            ret = threads[i].ret;
+        }
+    }
+    time_get(&ts_end);
+    pthread_barrier_destroy(&cstate.barrier);
+    if (ret) {
+        goto cleanup;
+    }
+    time_usec = time_diff(&ts_start, &ts_end);
+
+    /* print the results */
+    if ((ret = contention_print("get tree under load", threads, thread_count, 0, time_usec))) {
+        goto cleanup;
+    }
+    if ((ret = contention_print("commit under load", threads, thread_count, 1, time_usec))) {
+        goto cleanup;
+    }
+
+cleanup:
+    for (i = 0; threads && (i < thread_count); ++i) {
+        free(threads[i].lat);
+    }
+    free(threads);
+    for (i = 0; sub_conns && (i < subscribers); ++i) {
+        /* also unsubscribes */
+        sr_disconnect(sub_conns[i]);
+    }
+    free(sub_conns);
+
+    /* teardown */
+    sr_delete_item(state.sess, "/perf:cont", 0);
+    sr_apply_changes(state.sess, 0);
+    sr_release_context(state.conn);
+    sr_disconnect(state.conn);
+
+    return ret;
+}
+
+static int
+test_rpc_send(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    struct lyd_node *input;
+    sr_data_t *output;
+
+    if (lyd_new_path(NULL, state->mod->ctx, "/perf:rpc1/l", "input", 0, &input)) {
+        return SR_ERR_LY;
+    }
+
+    TEST_START(ts_start);
+
+    if ((r = sr_rpc_send_tree(state->sess, input, 0, &output))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    sr_release_data(output);
+    lyd_free_tree(input);
+
+    return SR_ERR_OK;
+}
+
+static int
+test_action_send(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    struct lyd_node *input;
+    sr_data_t *output;
+    char path[96];
+
+    sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "'][k2='str%" PRIu32 "']/act/l", state->count / 2, state->count / 2);
+    if (lyd_new_path(NULL, state->mod->ctx, path, "input", 0, &input)) {
+        return SR_ERR_LY;
+    }
+
+    TEST_START(ts_start);
+
+    if ((r = sr_rpc_send_tree(state->sess, input, 0, &output))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    sr_release_data(output);
+    lyd_free_all(input);
+
+    return SR_ERR_OK;
+}
+
+static int
+test_notif_send(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    struct lyd_node *notif;
+
+    if (lyd_new_path(NULL, state->mod->ctx, "/perf:notif/l", "val", 0, &notif)) {
+        return SR_ERR_LY;
+    }
+
+    TEST_START(ts_start);
+
+    /* wait for all the subscribers */
+    if ((r = sr_notif_send_tree(state->sess, notif, 0, 1))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    lyd_free_tree(notif);
+
+    return SR_ERR_OK;
+}
+
+static int
+test_notif_send_buffered(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    uint32_t i;
+    struct lyd_node *notif;
+
+    if (lyd_new_path(NULL, state->mod->ctx, "/perf:notif/l", "val", 0, &notif)) {
+        return SR_ERR_LY;
+    }
+
+    TEST_START(ts_start);
+
+    for (i = 0; i < state->count; ++i) {
+        if ((r = sr_notif_send_tree(state->sess, notif, 0, 0))) {
+            return r;
+        }
+    }
+
+    TEST_END(ts_end);
+
+    lyd_free_tree(notif);
+
+    return SR_ERR_OK;
+}
+
+static int
+test_notif_replay(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    sr_subscription_ctx_t *sub = NULL;
+
+    state->cb_count = 0;
+
+    TEST_START(ts_start);
+
+    /* subscribe and replay all the stored notifications */
+    if ((r = sr_notif_subscribe_tree(state->sess, "perf", NULL, &state->start_ts, NULL, notif_cb, state,
+            SR_SUBSCR_NO_THREAD, &sub))) {
+        return r;
+    }
+    if ((r = sr_subscription_process_events(sub, NULL, NULL))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    sr_unsubscribe(sub);
+    if (state->cb_count < state->count) {
+        return SR_ERR_INTERNAL;
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Remove all the scenario data from running.
+ *
+ * @param[in] state Test state.
+ * @return SR ERR value.
+ */
+static int
+scen_clear(struct test_state *state)
+{
+    const char *paths[] = {"/perf-ref:refs", "/perf-shapes:targets", "/perf-shapes:deep", "/perf-shapes:wide",
+            "/perf-shapes:ordered"};
+    uint32_t i;
+    int r;
+
+    for (i = 0; i < sizeof paths / sizeof *paths; ++i) {
+        if ((r = sr_delete_item(state->sess, paths[i], 0))) {
+            return r;
+        }
+    }
+
+    return sr_apply_changes(state->sess, state->count * 100);
+}
+
+static int
+test_scen_edit(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
     struct lyd_node *data;
 
+    r = state->scen_create(sr_acquire_context(state->conn), state->count, &data);
+    sr_release_context(state->conn);
+    if (r) {
+        return r;
+    }
+
+    TEST_START(ts_start);
+
+    if ((r = sr_edit_batch(state->sess, data, "merge"))) {
+        return r;
+    }
+
+    if ((r = sr_apply_changes(state->sess, state->count * 100))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    lyd_free_siblings(data);
+
+    return scen_clear(state);
+}
+
+static int
+test_scen_get(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    sr_data_t *data;
+
+    TEST_START(ts_start);
+
+    if ((r = sr_get_data(state->sess, state->scen_path, 0, 0, 0, &data))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    sr_release_data(data);
+
+    return SR_ERR_OK;
+}
+
+static int
+test_scen_validate(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    char path[64];
+
+    /* one more reference, all the others revalidated */
+    sprintf(path, "/perf-ref:refs/ref[id='%" PRIu32 "']/target", state->count);
+    if ((r = sr_set_item_str(state->sess, path, "t0", NULL, 0))) {
+        return r;
+    }
+
+    TEST_START(ts_start);
+
+    if ((r = sr_validate(state->sess, "perf-ref", state->count * 100))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    return sr_discard_changes(state->sess);
+}
+
+static int
+test_scen_move(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    char path[64];
+
+    sprintf(path, "/perf-shapes:ordered/item[id='%" PRIu32 "']", state->count - 1);
+
     TEST_START(ts_start);
 
-    if ((r = create_list_inst(state->mod, 0, state->count, &data))) {
+    if ((r = sr_move_item(state->sess, path, SR_MOVE_FIRST, NULL, NULL, NULL, 0))) {
+        return r;
+    }
+
+    if ((r = sr_apply_changes(state->sess, state->count * 100))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    /* restore the order */
+    if ((r = sr_move_item(state->sess, path, SR_MOVE_LAST, NULL, NULL, NULL, 0))) {
+        return r;
+    }
+    if ((r = sr_apply_changes(state->sess, state->count * 100))) {
         return r;
     }
 
-    if ((r = sr_edit_batch(state->sess, data, "merge"))) {
+    return SR_ERR_OK;
+}
+
+static int
+test_scen_ctx_change(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+
+    TEST_START(ts_start);
+
+    if ((r = sr_install_module(state->conn, TESTS_SRC_DIR "/files/perf-ctx.yang", TESTS_SRC_DIR "/files", NULL))) {
         return r;
     }
 
-    if ((r = sr_apply_changes(state->sess, state->count * 100))) {
+    if ((r = sr_remove_module(state->conn, "perf-ctx", 0))) {
         return r;
     }
 
     TEST_END(ts_end);
 
-    lyd_free_siblings(data);
+    return SR_ERR_OK;
+}
 
-    if ((r = sr_delete_item(state->sess, "/perf:cont/lst", 0))) {
+static void
+teardown_scen(struct test_state *state)
+{
+    if (state->scen_nacm) {
+        sr_nacm_set_user(state->sess, NULL);
+        sr_delete_item(state->sess, "/ietf-netconf-acm:nacm", 0);
+        sr_apply_changes(state->sess, 0);
+        sr_unsubscribe(state->sub);
+        sr_nacm_destroy();
+    }
+    scen_clear(state);
+}
+
+static int
+test_churn_connect(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    sr_conn_ctx_t *conn;
+
+    (void)state;
+
+    TEST_START(ts_start);
+
+    if ((r = sr_connect(0, &conn))) {
         return r;
     }
-    if ((r = sr_apply_changes(state->sess, state->count * 100))) {
+
+    TEST_END(ts_end);
+
+    sr_disconnect(conn);
+
+    return SR_ERR_OK;
+}
+
+static int
+test_churn_disconnect(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    sr_conn_ctx_t *conn;
+
+    (void)state;
+
+    if ((r = sr_connect(0, &conn))) {
         return r;
     }
 
+    TEST_START(ts_start);
+
+    sr_disconnect(conn);
+
+    TEST_END(ts_end);
+
     return SR_ERR_OK;
 }
 
 static int
-test_edit_batch_create(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+test_churn_install(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
 {
     int r;
-    uint32_t i;
-    char path[64], l_val[32];
 
     TEST_START(ts_start);
 
-    for (i = 0; i < state->count; ++i) {
-        sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "'][k2='str%" PRIu32 "']/l", i, i);
-        sprintf(l_val, "l%" PRIu32, i);
-        if ((r = sr_set_item_str(state->sess, path, l_val, NULL, 0))) {
-            return r;
-        }
+    /* the augment changes the schema of all the existing data */
+    if ((r = sr_install_module(state->conn, TESTS_SRC_DIR "/files/perf-upd-aug.yang", TESTS_SRC_DIR "/files", NULL))) {
+        return r;
     }
 
-    if ((r = sr_apply_changes(state->sess, state->count * 100))) {
+    TEST_END(ts_end);
+
+    return sr_remove_module(state->conn, "perf-upd-aug", 0);
+}
+
+static int
+test_churn_update(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+
+    /* install the previous revision with the data */
+    if ((r = sr_install_module(state->conn, TESTS_SRC_DIR "/files/perf-upd.yang", TESTS_SRC_DIR "/files", NULL))) {
+        return r;
+    }
+    if ((r = churn_data_store(state))) {
+        return r;
+    }
+
+    TEST_START(ts_start);
+
+    if ((r = sr_update_module(state->conn, TESTS_SRC_DIR "/files/perf-upd@2023-01-01.yang", TESTS_SRC_DIR "/files"))) {
         return r;
     }
 
     TEST_END(ts_end);
 
-    if ((r = sr_delete_item(state->sess, "/perf:cont/lst", 0))) {
+    return sr_remove_module(state->conn, "perf-upd", 0);
+}
+
+static int
+test_churn_feature(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+
+    TEST_START(ts_start);
+
+    if ((r = sr_enable_module_feature(state->conn, "perf-upd", "feat"))) {
         return r;
     }
-    if ((r = sr_apply_changes(state->sess, state->count * 100))) {
+
+    TEST_END(ts_end);
+
+    return sr_disable_module_feature(state->conn, "perf-upd", "feat");
+}
+
+/**
+ * @brief Subscribe ::churn.sub_count change subscriptions, each for a different list instance.
+ *
+ * @param[in] state Test state.
+ * @param[out] sub Subscription structure of all the subscriptions.
+ * @return SR ERR value.
+ */
+static int
+churn_subscribe(struct test_state *state, sr_subscription_ctx_t **sub)
+{
+    int r;
+    uint32_t i;
+    char path[64];
+
+    for (i = 0; i < churn.sub_count; ++i) {
+        sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "']", i);
+        if ((r = sr_module_change_subscribe(state->sess, "perf", path, change_item_cb, NULL, 0, 0, sub))) {
+            return r;
+        }
+    }
+
+    return SR_ERR_OK;
+}
+
+static int
+test_churn_subscribe(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    int r;
+    sr_subscription_ctx_t *sub = NULL;
+
+    TEST_START(ts_start);
+
+    if ((r = churn_subscribe(state, &sub))) {
         return r;
     }
 
+    TEST_END(ts_end);
+
+    sr_unsubscribe(sub);
+
     return SR_ERR_OK;
 }
 
 static int
-test_oper_get_tree(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+test_churn_unsubscribe(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
 {
     int r;
-    sr_data_t *data;
+    sr_subscription_ctx_t *sub = NULL;
 
-    sr_session_switch_ds(state->sess, SR_DS_OPERATIONAL);
+    if ((r = churn_subscribe(state, &sub))) {
+        return r;
+    }
 
     TEST_START(ts_start);
 
-    if ((r = sr_get_data(state->sess, "/perf:cont", 0, 0, 0, &data))) {
+    if ((r = sr_unsubscribe(sub))) {
         return r;
     }
 
     TEST_END(ts_end);
 
-    sr_release_data(data);
-    sr_session_switch_ds(state->sess, SR_DS_RUNNING);
-
     return SR_ERR_OK;
 }
 
+static void
+teardown_churn_connect(struct test_state *state)
+{
+    churn_mods_remove(state->conn);
+}
+
+static void
+teardown_churn_ctx(struct test_state *state)
+{
+    /* may have been removed by the test */
+    sr_remove_module(state->conn, "perf-upd", 0);
+}
+
+static void
+teardown_churn_sub(struct test_state *state)
+{
+    /* the subscriptions were freed by the test */
+    (void)state;
+}
+
 struct test tests[] = {
-    { "get tree", setup_running, test_get_tree },
-    { "get item", setup_running, test_get_item },
-    { "get tree hash", setup_running, test_get_tree_hash },
-    { "get tree hash cached", setup_running_cached, test_get_tree_hash },
-    { "edit item create", setup_subscribe_change_item, test_edit_item_create },
-    { "edit batch create", setup_subscribe_change_tree, test_edit_batch_create },
-    { "oper get tree", setup_subscribe_oper, test_oper_get_tree },
+    { "get tree", setup_running, test_get_tree, NULL },
+    { "get item", setup_running, test_get_item, NULL },
+    { "get tree hash", setup_running, test_get_tree_hash, NULL },
+    { "get tree hash cached", setup_running_cached, test_get_tree_hash, NULL },
+    { "edit item create", setup_subscribe_change_item, test_edit_item_create, NULL },
+    { "edit batch create", setup_subscribe_change_tree, test_edit_batch_create, NULL },
+    { "oper get tree", setup_subscribe_oper, test_oper_get_tree, NULL },
+    { "rpc send", setup_subscribe_rpc, test_rpc_send, NULL },
+    { "action send", setup_subscribe_action, test_action_send, NULL },
+    { "notif send 1 sub", setup_subscribe_notif1, test_notif_send, NULL },
+    { "notif send 10 subs", setup_subscribe_notif10, test_notif_send, NULL },
+    { "notif send 100 subs", setup_subscribe_notif100, test_notif_send, NULL },
+    { "notif send buffered", setup_notif_buffer, test_notif_send_buffered, NULL },
+    { "notif replay", setup_notif_replay, test_notif_replay, NULL },
+};
+
+struct test scen_tests[] = {
+    { "deep edit", setup_scen_deep_empty, test_scen_edit, teardown_scen },
+    { "deep get nacm", setup_scen_deep_nacm, test_scen_get, teardown_scen },
+    { "wide edit", setup_scen_wide_empty, test_scen_edit, teardown_scen },
+    { "wide get nacm", setup_scen_wide_nacm, test_scen_get, teardown_scen },
+    { "leafref edit", setup_scen_leafref_empty, test_scen_edit, teardown_scen },
+    { "leafref validate", setup_scen_leafref, test_scen_validate, teardown_scen },
+    { "user-ordered edit", setup_scen_ordered_empty, test_scen_edit, teardown_scen },
+    { "user-ordered move", setup_scen_ordered, test_scen_move, teardown_scen },
+    { "context change", setup_scen_ctx, test_scen_ctx_change, teardown_scen },
+};
+
+struct test churn_tests[] = {
+    { "connect", setup_churn_connect, test_churn_connect, teardown_churn_connect },
+    { "disconnect", setup_churn_connect, test_churn_disconnect, teardown_churn_connect },
+    { "install augment with data", setup_churn_ctx_data, test_churn_install, teardown_churn_ctx },
+    { "update module with data", setup_churn_ctx, test_churn_update, teardown_churn_ctx },
+    { "enable feature with data", setup_churn_ctx_data, test_churn_feature, teardown_churn_ctx },
+    { "subscribe changes", setup_churn_sub, test_churn_subscribe, teardown_churn_sub },
+    { "unsubscribe changes", setup_churn_sub, test_churn_unsubscribe, teardown_churn_sub },
 };
 
+/**
+ * @brief Print the results in JSON.
+ *
+ * @param[in] f File to print to.
+ * @param[in] conn Connection to use for learning the environment.
+ * @param[in] count Count of list instances, size of the testing data set.
+ * @param[in] tries Number of (re)tries of each test.
+ */
+static void
+results_print_json(FILE *f, sr_conn_ctx_t *conn, uint32_t count, uint32_t tries)
+{
+    const char **ds_plugins = NULL;
+    const char *shm_prefix;
+    uint32_t i, j;
+
+    shm_prefix = getenv("SYSREPO_SHM_PREFIX");
+    sr_get_plugins(conn, &ds_plugins, NULL);
+
+    fprintf(f, "{\n  \"environment\": {\n    \"shm_prefix\": \"%s\",\n    \"ds_plugins\": [", shm_prefix ? shm_prefix : "");
+    for (i = 0; ds_plugins && ds_plugins[i]; ++i) {
+        fprintf(f, "%s\"%s\"", i ? ", " : "", ds_plugins[i]);
+    }
+    fprintf(f, "],\n    \"count\": %" PRIu32 ",\n    \"tries\": %" PRIu32 "\n  },\n  \"results\": [\n", count, tries);
+    for (i = 0; i < result_count; ++i) {
+        fprintf(f, "    {\"name\": \"%s\", \"avg_usec\": %" PRIu64 ", \"samples_usec\": [", results[i].name,
+                results[i].avg_usec);
+        for (j = 0; j < results[i].sample_count; ++j) {
+            fprintf(f, "%s%" PRIu64, j ? ", " : "", results[i].samples[j]);
+        }
+        fprintf(f, "]}%s\n", (i + 1 < result_count) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+
+    free(ds_plugins);
+}
+
+/**
+ * @brief Print the results in CSV, as a single row for every sample. The environment is in "#" comments.
+ *
+ * @param[in] f File to print to.
+ * @param[in] conn Connection to use for learning the environment.
+ * @param[in] count Count of list instances, size of the testing data set.
+ * @param[in] tries Number of (re)tries of each test.
+ */
+static void
+results_print_csv(FILE *f, sr_conn_ctx_t *conn, uint32_t count, uint32_t tries)
+{
+    const char **ds_plugins = NULL;
+    const char *shm_prefix;
+    uint32_t i, j;
+
+    shm_prefix = getenv("SYSREPO_SHM_PREFIX");
+    sr_get_plugins(conn, &ds_plugins, NULL);
+
+    fprintf(f, "# shm_prefix=%s\n# ds_plugins=", shm_prefix ? shm_prefix : "");
+    for (i = 0; ds_plugins && ds_plugins[i]; ++i) {
+        fprintf(f, "%s%s", i ? ";" : "", ds_plugins[i]);
+    }
+    fprintf(f, "\n# count=%" PRIu32 "\n# tries=%" PRIu32 "\ntest,iteration,usec\n", count, tries);
+    for (i = 0; i < result_count; ++i) {
+        for (j = 0; j < results[i].sample_count; ++j) {
+            fprintf(f, "%s,%" PRIu32 ",%" PRIu64 "\n", results[i].name, j, results[i].samples[j]);
+        }
+    }
+
+    free(ds_plugins);
+}
+
+/**
+ * @brief Write the results into a file.
+ *
+ * @param[in] path Path of the file.
+ * @param[in] csv Whether to write CSV or JSON.
+ * @param[in] count Count of list instances, size of the testing data set.
+ * @param[in] tries Number of (re)tries of each test.
+ * @return SR ERR value.
+ */
 static int
-sysrepo_init(void)
+results_write(const char *path, int csv, uint32_t count, uint32_t tries)
 {
     int ret;
+    FILE *f;
+    sr_conn_ctx_t *conn;
+
+    if ((ret = sr_connect(0, &conn))) {
+        return ret;
+    }
+
+    f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "Failed to open \"%s\" (%s).\n", path, strerror(errno));
+        sr_disconnect(conn);
+        return SR_ERR_SYS;
+    }
+
+    if (csv) {
+        results_print_csv(f, conn, count, tries);
+    } else {
+        results_print_json(f, conn, count, tries);
+    }
+
+    fclose(f);
+    sr_disconnect(conn);
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Compare the results with a baseline CSV file written by a previous run.
+ *
+ * @param[in] path Path of the baseline file.
+ * @param[in] threshold Allowed slowdown in percent.
+ * @param[out] regressions Number of tests slower than the baseline by more than @p threshold.
+ * @return SR ERR value.
+ */
+static int
+results_compare(const char *path, uint32_t threshold, uint32_t *regressions)
+{
+    FILE *f;
+    char line[256], *ptr;
+    uint64_t *sums, usec;
+    uint32_t *counts, i;
+
+    *regressions = 0;
+
+    f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Failed to open \"%s\" (%s).\n", path, strerror(errno));
+        return SR_ERR_SYS;
+    }
+
+    sums = calloc(result_count, sizeof *sums);
+    counts = calloc(result_count, sizeof *counts);
+    if (!sums || !counts) {
+        fclose(f);
+        free(sums);
+        free(counts);
+        return SR_ERR_NO_MEMORY;
+    }
+
+    /* sum the baseline samples of the tests that were executed */
+    while (fgets(line, sizeof line, f)) {
+        if ((line[0] == '#') || !(ptr = strchr(line, ','))) {
+            continue;
+        }
+        *ptr = '\0';
+        for (i = 0; i < result_count; ++i) {
+            if (!strcmp(results[i].name, line)) {
+                break;
+            }
+        }
+        if ((i == result_count) || !(ptr = strchr(ptr + 1, ','))) {
+            continue;
+        }
+
+        usec = strtoull(ptr + 1, NULL, 10);
+        sums[i] += usec;
+        ++counts[i];
+    }
+    fclose(f);
+
+    printf("| baseline \"%s\", threshold %" PRIu32 " %%\n", path, threshold);
+    for (i = 0; i < result_count; ++i) {
+        if (!counts[i]) {
+            printf("| %s: no baseline\n", results[i].name);
+            continue;
+        }
+
+        usec = sums[i] / counts[i];
+        if (results[i].avg_usec * 100 > usec * (100 + threshold)) {
+            printf("| %s: REGRESSION %" PRIu64 " us, baseline %" PRIu64 " us\n", results[i].name, results[i].avg_usec,
+                    usec);
+            ++(*regressions);
+        }
+    }
+
+    free(sums);
+    free(counts);
+    return SR_ERR_OK;
+}
+
+static int
+sysrepo_init(void)
+{
+    int ret = SR_ERR_OK;
+    uint32_t i;
     sr_conn_ctx_t *conn;
+    const char *schema_paths[] = {
+        TESTS_SRC_DIR "/files/perf.yang",
+        TESTS_SRC_DIR "/files/perf-shapes.yang",
+        TESTS_SRC_DIR "/files/perf-ref.yang",
+    };
 
     /* setup env */
     if ((ret = setenv("SYSREPO_REPOSITORY_PATH", TESTS_REPO_DIR "/test_repositories/sr_perf", 1))) {
@@ -612,8 +2459,14 @@ sysrepo_init(void)
     /* disable logging */
     sr_log_stderr(SR_LL_NONE);
 
-    /* install module */
-    ret = sr_install_module(conn, TESTS_SRC_DIR "/files/perf.yang", NULL, NULL);
+    /* install modules */
+    for (i = 0; i < sizeof schema_paths / sizeof *schema_paths; ++i) {
+        ret = sr_install_module(conn, schema_paths[i], TESTS_SRC_DIR "/files", NULL);
+        if (ret && (ret != SR_ERR_EXISTS)) {
+            break;
+        }
+        ret = SR_ERR_OK;
+    }
 
     /* turn on logging */
     sr_log_stderr(SR_LL_WRN);
@@ -621,7 +2474,7 @@ sysrepo_init(void)
     /* disconnect */
     sr_disconnect(conn);
 
-    if (ret && (ret != SR_ERR_EXISTS)) {
+    if (ret) {
         return ret;
     }
 
@@ -631,14 +2484,110 @@ sysrepo_init(void)
     return SR_ERR_OK;
 }
 
+static void
+usage(const char *progname)
+{
+    fprintf(stderr, "Usage:\n%s [options] list-instance-count test-tries [readers writers subscribers]\n\n", progname);
+    fprintf(stderr, "  -j, --json=FILE       Write the results with all the samples into FILE as JSON.\n");
+    fprintf(stderr, "  -c, --csv=FILE        Write the results with all the samples into FILE as CSV.\n");
+    fprintf(stderr, "  -b, --baseline=FILE   Compare the results with a CSV file written by a previous run.\n");
+    fprintf(stderr, "  -t, --threshold=PCT   Allowed slowdown compared to the baseline in percent (default 10).\n");
+    fprintf(stderr, "  -s, --scenarios       Also run the scenario tests with deep, wide, leafref, and user-ordered data.\n");
+    fprintf(stderr, "  -d, --depth=N         Nesting depth of the deep scenario data (default 4, max %d).\n", SCEN_DEPTH_MAX);
+    fprintf(stderr, "  -w, --width=N         Leaves of every wide scenario list instance (default 8, max %d).\n",
+            SCEN_WIDTH_MAX);
+    fprintf(stderr, "  -x, --churn           Also run the connect, context change, and subscription churn tests.\n");
+    fprintf(stderr, "  -n, --modules=N       Modules installed for the connect churn tests (default 100).\n");
+    fprintf(stderr, "  -m, --data-size=MB    Existing data of the context change churn tests in MB (default 1).\n");
+    fprintf(stderr, "  -k, --subscriptions=K Subscriptions of the subscription churn tests (default 1000).\n\n");
+}
+
 int
 main(int argc, char **argv)
 {
-    int ret;
-    uint32_t i, count, tries;
+    int ret, opt, scenarios = 0, churns = 0;
+    uint32_t i, count, tries, readers = 4, writers = 2, subscribers = 2, threshold = 10, regressions = 0;
+    const char *json_path = NULL, *csv_path = NULL, *baseline_path = NULL;
+    struct option options[] = {
+        {"json", required_argument, NULL, 'j'},
+        {"csv", required_argument, NULL, 'c'},
+        {"baseline", required_argument, NULL, 'b'},
+        {"threshold", required_argument, NULL, 't'},
+        {"scenarios", no_argument, NULL, 's'},
+        {"depth", required_argument, NULL, 'd'},
+        {"width", required_argument, NULL, 'w'},
+        {"churn", no_argument, NULL, 'x'},
+        {"modules", required_argument, NULL, 'n'},
+        {"data-size", required_argument, NULL, 'm'},
+        {"subscriptions", required_argument, NULL, 'k'},
+        {NULL, 0, NULL, 0}
+    };
+
+    while ((opt = getopt_long(argc, argv, "j:c:b:t:sd:w:xn:m:k:", options, NULL)) != -1) {
+        switch (opt) {
+        case 'j':
+            json_path = optarg;
+            break;
+        case 'c':
+            csv_path = optarg;
+            break;
+        case 'b':
+            baseline_path = optarg;
+            break;
+        case 't':
+            threshold = atoi(optarg);
+            break;
+        case 's':
+            scenarios = 1;
+            break;
+        case 'd':
+            scen.depth = atoi(optarg);
+            if (!scen.depth || (scen.depth > SCEN_DEPTH_MAX)) {
+                fprintf(stderr, "Invalid depth \"%s\".\n", optarg);
+                return SR_ERR_INVAL_ARG;
+            }
+            break;
+        case 'w':
+            scen.width = atoi(optarg);
+            if (!scen.width || (scen.width > SCEN_WIDTH_MAX)) {
+                fprintf(stderr, "Invalid width \"%s\".\n", optarg);
+                return SR_ERR_INVAL_ARG;
+            }
+            break;
+        case 'x':
+            churns = 1;
+            break;
+        case 'n':
+            churn.mod_count = atoi(optarg);
+            if (!churn.mod_count) {
+                fprintf(stderr, "Invalid module count \"%s\".\n", optarg);
+                return SR_ERR_INVAL_ARG;
+            }
+            break;
+        case 'm':
+            churn.data_mb = atoi(optarg);
+            if (!churn.data_mb) {
+                fprintf(stderr, "Invalid data size \"%s\".\n", optarg);
+                return SR_ERR_INVAL_ARG;
+            }
+            break;
+        case 'k':
+            churn.sub_count = atoi(optarg);
+            if (!churn.sub_count) {
+                fprintf(stderr, "Invalid subscription count \"%s\".\n", optarg);
+                return SR_ERR_INVAL_ARG;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return SR_ERR_INVAL_ARG;
+        }
+    }
+    argc -= optind - 1;
+    argv += optind - 1;
 
     if (argc < 3) {
-        fprintf(stderr, "Usage:\n%s list-instance-count test-tries\n\n", argv[0]);
+        usage(argv[0]);
         return SR_ERR_INVAL_ARG;
     }
 
@@ -654,6 +2603,20 @@ main(int argc, char **argv)
         return SR_ERR_INVAL_ARG;
     }
 
+    if (argc > 3) {
+        if (argc < 6) {
+            fprintf(stderr, "Readers, writers, and subscribers must all be set.\n");
+            return SR_ERR_INVAL_ARG;
+        }
+        readers = atoi(argv[3]);
+        writers = atoi(argv[4]);
+        subscribers = atoi(argv[5]);
+        if (!readers && !writers) {
+            fprintf(stderr, "There must be some readers or writers.\n");
+            return SR_ERR_INVAL_ARG;
+        }
+    }
+
     printf("\nsr_perf:\n\tdata set size: %" PRIu32 "\n\teach test executed: %" PRIu32 " %s\n\n", count, tries,
             (tries > 1) ? "times" : "time");
 
@@ -664,11 +2627,58 @@ main(int argc, char **argv)
 
     /* tests */
     for (i = 0; i < (sizeof tests / sizeof(struct test)); ++i) {
-        if ((ret = exec_test(tests[i].setup, tests[i].test, tests[i].name, count, tries))) {
+        if ((ret = exec_test(tests[i].setup, tests[i].test, tests[i].teardown, tests[i].name, count, tries))) {
             return ret;
         }
     }
+
+    /* scenario tests */
+    if (scenarios) {
+        printf("\n\tscenario depth: %" PRIu32 "\n\tscenario width: %" PRIu32 "\n\n", scen.depth, scen.width);
+        for (i = 0; i < (sizeof scen_tests / sizeof(struct test)); ++i) {
+            if ((ret = exec_test(scen_tests[i].setup, scen_tests[i].test, scen_tests[i].teardown, scen_tests[i].name,
+                    count, tries))) {
+                return ret;
+            }
+        }
+    }
+
+    /* churn tests */
+    if (churns) {
+        printf("\n\tinstalled modules: %" PRIu32 "\n\texisting data: %" PRIu32 " MB\n\tsubscriptions: %" PRIu32 "\n\n",
+                churn.mod_count, churn.data_mb, churn.sub_count);
+        for (i = 0; i < (sizeof churn_tests / sizeof(struct test)); ++i) {
+            if ((ret = exec_test(churn_tests[i].setup, churn_tests[i].test, churn_tests[i].teardown, churn_tests[i].name,
+                    count, tries))) {
+                return ret;
+            }
+        }
+    }
+
+    /* contention tests */
+    if ((ret = exec_contention_test(count, tries, readers, writers, subscribers))) {
+        return ret;
+    }
     printf("\n");
 
-    return SR_ERR_OK;
+    /* machine-readable results */
+    if (json_path && (ret = results_write(json_path, 0, count, tries))) {
+        return ret;
+    }
+    if (csv_path && (ret = results_write(csv_path, 1, count, tries))) {
+        return ret;
+    }
+    if (baseline_path) {
+        if ((ret = results_compare(baseline_path, threshold, &regressions))) {
+            return ret;
+        }
+        printf("\n");
+    }
+
+    for (i = 0; i < result_count; ++i) {
+        free(results[i].samples);
+    }
+    free(results);
+
+    return regressions ? 1 : SR_ERR_OK;
 }
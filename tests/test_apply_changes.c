@@ -5345,6 +5345,258 @@ test_change_done_xpath(void **state)
     pthread_join(tid[1], NULL);
 }
 
+/* TEST */
+static int
+module_change_filter_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)request_id;
+
+    assert_string_equal(module_name, "test");
+    assert_string_equal(xpath, "/test:cont");
+    assert_true((event == SR_EV_CHANGE) || (event == SR_EV_DONE));
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static void
+test_change_filter(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *subscr = NULL;
+    uint32_t sub_id, filtered_out;
+    int ret, count;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "test", "/test:cont", module_change_filter_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    sub_id = sr_subscription_get_last_sub_id(subscr);
+
+    /* change outside of the filter, the subscriber is not notified at all */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "10", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* both "change" and "done" events filtered out */
+    ret = sr_module_change_sub_get_info(subscr, sub_id, NULL, NULL, NULL, &filtered_out);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(filtered_out, 2);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 0);
+
+    /* change matching the filter */
+    ret = sr_set_item_str(sess, "/test:cont/ll2", "1", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    count = 0;
+    while ((ATOMIC_LOAD_RELAXED(st->cb_called) < 2) && (count < 1500)) {
+        usleep(10000);
+        ++count;
+    }
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+
+    ret = sr_module_change_sub_get_info(subscr, sub_id, NULL, NULL, NULL, &filtered_out);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(filtered_out, 2);
+
+    sr_unsubscribe(subscr);
+
+    /* cleanup */
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_delete_item(sess, "/test:cont", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+}
+
+/* TEST */
+static int
+module_change_parallel_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)xpath;
+    (void)request_id;
+
+    assert_string_equal(module_name, "test");
+    assert_true((event == SR_EV_CHANGE) || (event == SR_EV_DONE));
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static int
+module_change_parallel_regular_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name,
+        const char *xpath, sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)xpath;
+    (void)request_id;
+
+    assert_string_equal(module_name, "test");
+
+    /* the whole parallel group was notified first regardless of the priorities of its members */
+    switch (ATOMIC_LOAD_RELAXED(st->cb_called2)) {
+    case 0:
+        assert_int_equal(event, SR_EV_CHANGE);
+        assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+        break;
+    case 1:
+        assert_int_equal(event, SR_EV_DONE);
+        assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 4);
+        break;
+    default:
+        fail();
+    }
+
+    ATOMIC_INC_RELAXED(st->cb_called2);
+    return SR_ERR_OK;
+}
+
+static void
+test_change_parallel(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *subscr = NULL;
+    int ret, count;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* update subscriptions cannot be parallel */
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_change_parallel_cb, st, 0,
+            SR_SUBSCR_UPDATE | SR_SUBSCR_PARALLEL, &subscr);
+    assert_int_equal(ret, SR_ERR_INVAL_ARG);
+
+    /* parallel group with priorities 5 and 1 and a regular subscription with priority 3 */
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_change_parallel_cb, st, 5, SR_SUBSCR_PARALLEL, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_change_parallel_regular_cb, st, 3, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_change_parallel_cb, st, 1, SR_SUBSCR_PARALLEL, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_set_item_str(sess, "/test:test-leaf", "10", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    count = 0;
+    while ((ATOMIC_LOAD_RELAXED(st->cb_called2) < 2) && (count < 1500)) {
+        usleep(10000);
+        ++count;
+    }
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 4);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called2), 2);
+
+    sr_unsubscribe(subscr);
+
+    /* cleanup */
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+}
+
+/* TEST */
+static int
+module_change_async_done_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)xpath;
+    (void)request_id;
+
+    assert_string_equal(module_name, "test");
+
+    if (event == SR_EV_CHANGE) {
+        /* "done" of the previous changes was always processed first */
+        assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), ATOMIC_LOAD_RELAXED(st->cb_called2));
+        ATOMIC_INC_RELAXED(st->cb_called);
+    } else {
+        assert_int_equal(event, SR_EV_DONE);
+
+        /* slow consumer */
+        usleep(300000);
+        ATOMIC_INC_RELAXED(st->cb_called2);
+    }
+
+    return SR_ERR_OK;
+}
+
+static void
+test_change_async_done(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess, *sess2;
+    sr_subscription_ctx_t *subscr = NULL;
+    int ret, count;
+
+    ret = sr_connect(SR_CONN_ASYNC_DONE, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess2);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess2, "test", NULL, module_change_async_done_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_set_item_str(sess, "/test:test-leaf", "10", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the changes were applied without waiting for "done" */
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 1);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called2), 0);
+
+    /* next changes are delivered only after "done" was processed */
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+
+    count = 0;
+    while ((ATOMIC_LOAD_RELAXED(st->cb_called2) < 2) && (count < 1500)) {
+        usleep(10000);
+        ++count;
+    }
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called2), 2);
+
+    sr_unsubscribe(subscr);
+    sr_session_stop(sess2);
+    sr_session_stop(sess);
+    sr_disconnect(conn);
+}
+
 /* TEST */
 static int
 module_change_unlocked_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
@@ -6948,6 +7200,482 @@ test_mult_update(void **state)
     sr_session_stop(sess);
 }
 
+/* TEST */
+static int
+module_coalesce_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    sr_change_oper_t op;
+    sr_change_iter_t *iter;
+    const struct lyd_node *node;
+    int ret, count = 0;
+
+    (void)sub_id;
+    (void)xpath;
+    (void)request_id;
+
+    assert_string_equal(module_name, "test");
+
+    if (event == SR_EV_CHANGE) {
+        /* all the coalesced changes are in a single event */
+        ret = sr_get_changes_iter(session, "/test:*//.", &iter);
+        assert_int_equal(ret, SR_ERR_OK);
+        while (!sr_get_change_tree_next(session, iter, &op, &node, NULL, NULL, NULL)) {
+            assert_int_equal(op, SR_OP_CREATED);
+            assert_string_equal(node->schema->name, "ll1");
+            ++count;
+        }
+        sr_free_change_iter(iter);
+        assert_int_equal(count, 3);
+    }
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static void
+test_coalesce(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_session_ctx_t *sess;
+    sr_data_t *data;
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_coalesce_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* buffer several changes, all in a single window */
+    ret = sr_set_item_str(sess, "/test:ll1", "1", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes_async(sess, 10000, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(sr_has_changes(sess), 0);
+
+    ret = sr_set_item_str(sess, "/test:ll1", "2", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess, "/test:ll1", "3", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes_async(sess, 10000, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* nothing was committed yet */
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 0);
+
+    /* commit them now */
+    ret = sr_apply_changes_wait(sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* change and done events */
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+
+    ret = sr_get_data(sess, "/test:ll1", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data);
+    assert_string_equal(lyd_get_value(data->tree), "1");
+    assert_string_equal(lyd_get_value(data->tree->next), "2");
+    assert_string_equal(lyd_get_value(data->tree->next->next), "3");
+    sr_release_data(data);
+
+    /* a failed coalesced commit */
+    ret = sr_set_item_str(sess, "/test:ll1", "1", NULL, SR_EDIT_STRICT);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes_async(sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes_wait(sess);
+    assert_int_equal(ret, SR_ERR_EXISTS);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+
+    sr_unsubscribe(subscr);
+
+    /* cleanup */
+    ret = sr_delete_item(sess, "/test:ll1[.='1']", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_delete_item(sess, "/test:ll1[.='2']", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_delete_item(sess, "/test:ll1[.='3']", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+}
+
+/* TEST */
+static void
+commit_cb(sr_session_ctx_t *session, const sr_error_info_t *err_info, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+
+    if (ATOMIC_LOAD_RELAXED(st->cb_called) == 0) {
+        assert_null(err_info);
+    } else {
+        assert_non_null(err_info);
+        assert_int_equal(err_info->err[0].err_code, SR_ERR_EXISTS);
+    }
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    pthread_barrier_wait(&st->barrier);
+}
+
+static void
+test_commit_cb(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_session_ctx_t *sess;
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_session_set_commit_cb(sess, commit_cb, st);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* successful commit */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "10", NULL, SR_EDIT_STRICT);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes_async(sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    pthread_barrier_wait(&st->barrier);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 1);
+
+    /* failed commit */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "10", NULL, SR_EDIT_STRICT);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes_async(sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    pthread_barrier_wait(&st->barrier);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+
+    /* the error was reported to the callback */
+    ret = sr_apply_changes_wait(sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* cleanup */
+    ret = sr_session_set_commit_cb(sess, NULL, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+}
+
+/* TEST */
+static int
+module_change_batch_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)xpath;
+    (void)event;
+    (void)request_id;
+
+    if (!strcmp(module_name, "test")) {
+        ATOMIC_INC_RELAXED(st->cb_called);
+    } else {
+        assert_string_equal(module_name, "ietf-interfaces");
+        ATOMIC_INC_RELAXED(st->cb_called2);
+    }
+
+    return SR_ERR_OK;
+}
+
+static void
+test_change_batch(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_module_change_sub_t subs[3] = {
+        {"test", NULL, module_change_batch_cb, st, 0, 0},
+        {"test", "/test:test-leaf", module_change_batch_cb, st, 1, 0},
+        {"ietf-interfaces", NULL, module_change_batch_cb, st, 0, SR_SUBSCR_ENABLED}
+    };
+    const char *xpath;
+    uint32_t sub_ids[3];
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* unknown module, nothing is subscribed */
+    subs[1].module_name = "no-module";
+    ret = sr_module_change_subscribe_batch(sess, subs, 3, 0, &subscr, sub_ids);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+    assert_null(subscr);
+    subs[1].module_name = "test";
+
+    /* subscribe, enabled event only for ietf-interfaces */
+    ret = sr_module_change_subscribe_batch(sess, subs, 3, 0, &subscr, sub_ids);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 0);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called2), 2);
+    assert_int_not_equal(sub_ids[0], sub_ids[1]);
+    assert_int_not_equal(sub_ids[1], sub_ids[2]);
+
+    ret = sr_module_change_sub_get_info(subscr, sub_ids[1], NULL, NULL, &xpath, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(xpath, "/test:test-leaf");
+
+    /* both "test" subscriptions get change and done events */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "10", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 4);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called2), 2);
+
+    /* cleanup */
+    sr_unsubscribe(subscr);
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+}
+
+/* TEST */
+struct commit_prio_arg {
+    struct state *st;
+    const char *value;
+    uint32_t prio;
+};
+
+static int
+module_commit_prio_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    sr_val_t *val;
+    int ret;
+
+    (void)sub_id;
+    (void)module_name;
+    (void)xpath;
+    (void)request_id;
+
+    if (event != SR_EV_CHANGE) {
+        return SR_ERR_OK;
+    }
+
+    ret = sr_get_item(session, "/test:test-leaf", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    if (val->data.uint8_val == 1) {
+        /* keep the module locked while the other commits start waiting */
+        sleep(1);
+    } else if (!ATOMIC_LOAD_RELAXED(st->cb_called2)) {
+        /* remember the first admitted waiting commit */
+        ATOMIC_STORE_RELAXED(st->cb_called2, val->data.uint8_val);
+    }
+    sr_free_val(val);
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static void *
+apply_commit_prio_thread(void *arg)
+{
+    struct commit_prio_arg *cp_arg = (struct commit_prio_arg *)arg;
+    sr_session_ctx_t *sess;
+    int ret;
+
+    ret = sr_session_start(cp_arg->st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_set_commit_priority(sess, cp_arg->prio);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_set_item_str(sess, "/test:test-leaf", cp_arg->value, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+    return NULL;
+}
+
+static void
+test_commit_prio(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *subscr = NULL;
+    struct commit_prio_arg args[3] = {
+        {st, "1", 0},
+        {st, "2", 0},
+        {st, "3", SR_COMMIT_PRIO_MAX}
+    };
+    pthread_t tid[3];
+    int ret, i;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* invalid priority */
+    ret = sr_session_set_commit_priority(sess, SR_COMMIT_PRIO_MAX + 1);
+    assert_int_equal(ret, SR_ERR_INVAL_ARG);
+
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_commit_prio_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the first commit blocks the module, then a low-priority and a high-priority commit wait for it */
+    for (i = 0; i < 3; ++i) {
+        pthread_create(&tid[i], NULL, apply_commit_prio_thread, &args[i]);
+        usleep(200000);
+    }
+    for (i = 0; i < 3; ++i) {
+        pthread_join(tid[i], NULL);
+    }
+
+    /* the high-priority commit was admitted first */
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 3);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called2), 3);
+
+    /* cleanup */
+    sr_unsubscribe(subscr);
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+}
+
+/* TEST */
+static int
+module_change_log_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    sr_change_iter_t *iter;
+    sr_change_oper_t op;
+    sr_val_t *old_val, *new_val;
+    const struct lyd_node *node;
+    const char *prev_val, *prev_list;
+    int ret, prev_dflt, modified;
+
+    (void)sub_id;
+    (void)module_name;
+    (void)xpath;
+    (void)request_id;
+
+    modified = ATOMIC_LOAD_RELAXED(st->cb_called) > 1;
+
+    if (event == SR_EV_CHANGE) {
+        /* changes read directly from the change log */
+        ret = sr_get_changes_iter(session, "/test:*//.", &iter);
+        assert_int_equal(ret, SR_ERR_OK);
+
+        ret = sr_get_change_next(session, iter, &op, &old_val, &new_val);
+        assert_int_equal(ret, SR_ERR_OK);
+        if (modified) {
+            assert_int_equal(op, SR_OP_MODIFIED);
+            assert_non_null(old_val);
+            assert_string_equal(old_val->xpath, "/test:test-leaf");
+            assert_int_equal(old_val->type, SR_UINT8_T);
+            assert_int_equal(old_val->data.uint8_val, 1);
+        } else {
+            assert_int_equal(op, SR_OP_CREATED);
+            assert_null(old_val);
+        }
+        assert_non_null(new_val);
+        assert_string_equal(new_val->xpath, "/test:test-leaf");
+        assert_int_equal(new_val->type, SR_UINT8_T);
+        assert_int_equal(new_val->data.uint8_val, modified ? 2 : 1);
+        sr_free_val(old_val);
+        sr_free_val(new_val);
+
+        ret = sr_get_change_next(session, iter, &op, &old_val, &new_val);
+        assert_int_equal(ret, SR_ERR_NOT_FOUND);
+        sr_free_change_iter(iter);
+
+        /* the diff is built for a specific XPath */
+        ret = sr_get_changes_iter(session, "/test:test-leaf", &iter);
+        assert_int_equal(ret, SR_ERR_OK);
+        ret = sr_get_change_tree_next(session, iter, &op, &node, &prev_val, &prev_list, &prev_dflt);
+        assert_int_equal(ret, SR_ERR_OK);
+        assert_int_equal(op, modified ? SR_OP_MODIFIED : SR_OP_CREATED);
+        assert_string_equal(lyd_get_value(node), modified ? "2" : "1");
+        if (modified) {
+            assert_string_equal(prev_val, "1");
+        }
+        ret = sr_get_change_tree_next(session, iter, &op, &node, &prev_val, &prev_list, &prev_dflt);
+        assert_int_equal(ret, SR_ERR_NOT_FOUND);
+        sr_free_change_iter(iter);
+    } else if (event == SR_EV_DONE) {
+        /* the change log iterator switches to the diff */
+        ret = sr_get_changes_iter(session, "/test:*//.", &iter);
+        assert_int_equal(ret, SR_ERR_OK);
+        ret = sr_get_change_tree_next(session, iter, &op, &node, &prev_val, &prev_list, &prev_dflt);
+        assert_int_equal(ret, SR_ERR_OK);
+        assert_string_equal(LYD_NAME(node), "test-leaf");
+        assert_string_equal(lyd_get_value(node), modified ? "2" : "1");
+        ret = sr_get_change_tree_next(session, iter, &op, &node, &prev_val, &prev_list, &prev_dflt);
+        assert_int_equal(ret, SR_ERR_NOT_FOUND);
+        sr_free_change_iter(iter);
+    } else {
+        fail();
+    }
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static void
+test_change_log(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *subscr = NULL;
+    int ret;
+
+    /* changes applied on this connection are published as a change log */
+    ret = sr_connect(SR_CONN_CHANGE_LOG, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_change_log_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* create */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "1", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+
+    /* modify */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "2", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 4);
+
+    /* cleanup */
+    sr_unsubscribe(subscr);
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+    sr_disconnect(conn);
+}
+
 /* MAIN */
 int
 main(void)
@@ -6968,6 +7696,9 @@ main(void)
         cmocka_unit_test_setup_teardown(test_change_dflt_create, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_change_done_when, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_change_done_xpath, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_change_filter, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_change_parallel, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_change_async_done, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_change_unlocked, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_change_timeout, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_done_timeout, setup_f, teardown_f),
@@ -6977,6 +7708,11 @@ main(void)
         cmocka_unit_test_setup_teardown(test_change_schema_mount, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_write_starve, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_mult_update, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_coalesce, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_commit_cb, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_change_batch, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_commit_prio, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_change_log, setup_f, teardown_f),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
@@ -31,6 +31,7 @@
 struct state {
     sr_conn_ctx_t *conn;
     sr_session_ctx_t *sess;
+    int cb_called;
 };
 
 static int
@@ -478,6 +479,110 @@ test_reset_session_stop(void **state)
     assert_int_equal(ret, SR_ERR_OK);
 }
 
+static int
+module_change_running_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    sr_session_ctx_t *sess;
+    int ret;
+
+    (void)session;
+    (void)sub_id;
+    (void)module_name;
+    (void)xpath;
+    (void)request_id;
+
+    if (event != SR_EV_CHANGE) {
+        return SR_ERR_OK;
+    }
+    ++st->cb_called;
+
+    /* change running after the candidate changes were made but before they are stored */
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess, "/test:l1[k='key0']/v", "2", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_session_stop(sess);
+
+    return SR_ERR_OK;
+}
+
+static void
+test_running_change(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_val_t *val;
+    char xpath[32];
+    int ret, i;
+
+    /* store running data large enough for the candidate changes to be journaled */
+    for (i = 0; i < 50; ++i) {
+        sprintf(xpath, "/test:l1[k='key%d']/v", i);
+        ret = sr_set_item_str(st->sess, xpath, "1", NULL, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* running is changed while the candidate changes are being applied */
+    ret = sr_session_switch_ds(st->sess, SR_DS_CANDIDATE);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_module_change_subscribe(st->sess, "test", NULL, module_change_running_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    st->cb_called = 0;
+    ret = sr_set_item_str(st->sess, "/test:test-leaf", "1", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(st->cb_called, 1);
+    sr_unsubscribe(subscr);
+
+    /* candidate includes exactly the changes made on the previous running data, even after reconnecting */
+    ret = sr_connect(0, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_CANDIDATE, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_item(sess, "/test:test-leaf", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 1);
+    sr_free_val(val);
+    ret = sr_get_item(sess, "/test:l1[k='key0']/v", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 1);
+    sr_free_val(val);
+    ret = sr_get_item(sess, "/test:l1[k='key49']/v", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 1);
+    sr_free_val(val);
+    sr_disconnect(conn);
+
+    /* running keeps its own change */
+    ret = sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_item(st->sess, "/test:l1[k='key0']/v", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 2);
+    sr_free_val(val);
+    ret = sr_get_item(st->sess, "/test:test-leaf", 0, &val);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+
+    /* cleanup */
+    ret = sr_session_switch_ds(st->sess, SR_DS_CANDIDATE);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_copy_config(st->sess, "test", SR_DS_RUNNING, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_replace_config(st->sess, "test", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
 int
 main(void)
 {
@@ -487,6 +592,7 @@ main(void)
         cmocka_unit_test(test_when),
         cmocka_unit_test(test_reset_unlock),
         cmocka_unit_test(test_reset_session_stop),
+        cmocka_unit_test(test_running_change),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
@@ -493,6 +493,54 @@ test_move(void **state)
     sr_release_data(data);
 }
 
+static void
+test_move_bulk(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_val_t *values;
+    size_t value_cnt;
+    char buf[8];
+    int ret, i;
+
+    /* append many instances in a single edit */
+    for (i = 0; i < 200; ++i) {
+        sprintf(buf, "%d", i);
+        ret = sr_set_item_str(st->sess, "/test:ll1", buf, NULL, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* move some of them and append others, all in one edit */
+    ret = sr_move_item(st->sess, "/test:ll1[.='199']", SR_MOVE_FIRST, NULL, NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/test:ll1", "200", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_move_item(st->sess, "/test:ll1[.='0']", SR_MOVE_LAST, NULL, NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/test:ll1", "201", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_move_item(st->sess, "/test:ll1[.='202']", SR_MOVE_AFTER, NULL, "199", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* check the order */
+    ret = sr_get_items(st->sess, "/test:ll1", 0, 0, &values, &value_cnt);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(value_cnt, 203);
+    assert_int_equal(values[0].data.int16_val, 199);
+    assert_int_equal(values[1].data.int16_val, 202);
+    for (i = 1; i < 199; ++i) {
+        assert_int_equal(values[i + 1].data.int16_val, i);
+    }
+    assert_int_equal(values[200].data.int16_val, 200);
+    assert_int_equal(values[201].data.int16_val, 0);
+    assert_int_equal(values[202].data.int16_val, 201);
+
+    sr_free_values(values, value_cnt);
+}
+
 static void
 test_replace(void **state)
 {
@@ -625,6 +673,77 @@ test_replace_userord(void **state)
     free(str);
 }
 
+static void
+test_edit_builder(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_edit_builder_t *builder;
+    sr_data_t *data;
+    char path[64];
+    int ret, i;
+
+    ret = sr_edit_builder_new(st->sess, &builder);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* add interfaces relative to their parent */
+    ret = sr_edit_builder_set_parent(builder, "/ietf-interfaces:interfaces");
+    assert_int_equal(ret, SR_ERR_OK);
+    for (i = 0; i < 50; ++i) {
+        sprintf(path, "interface[name='eth%d']/type", i);
+        ret = sr_edit_builder_add(builder, path, "iana-if-type:ethernetCsmacd");
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+
+    /* invalid path */
+    ret = sr_edit_builder_add(builder, "interface[name='eth0']/no", "val");
+    assert_int_equal(ret, SR_ERR_LY);
+
+    /* parent of an existing node, a value is updated */
+    ret = sr_edit_builder_set_parent(builder, "/ietf-interfaces:interfaces/interface[name='eth0']");
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_edit_builder_add(builder, "enabled", "true");
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_edit_builder_add(builder, "enabled", "false");
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* top-level node */
+    ret = sr_edit_builder_set_parent(builder, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_edit_builder_add(builder, "/test:test-leaf", "5");
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* use the edit */
+    ret = sr_edit_builder_apply(builder, "merge");
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* check the data */
+    ret = sr_get_node(st->sess, "/ietf-interfaces:interfaces/interface[name='eth0']/enabled", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "false");
+    sr_release_data(data);
+
+    ret = sr_get_data(st->sess, "/ietf-interfaces:interfaces/interface[name='eth49']", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data);
+    sr_release_data(data);
+
+    /* cleanup */
+    ret = sr_delete_item(st->sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* freed without use */
+    ret = sr_edit_builder_new(st->sess, &builder);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_edit_builder_add(builder, "/test:test-leaf", "6");
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_edit_builder_free(builder);
+    assert_false(sr_has_changes(st->sess));
+}
+
 static void
 test_isolate(void **state)
 {
@@ -1416,8 +1535,10 @@ main(void)
         cmocka_unit_test_teardown(test_create2, clear_interfaces),
         cmocka_unit_test_teardown(test_create_np_cont, clear_interfaces),
         cmocka_unit_test_teardown(test_move, clear_test),
+        cmocka_unit_test_teardown(test_move_bulk, clear_test),
         cmocka_unit_test_teardown(test_replace, clear_interfaces),
         cmocka_unit_test_teardown(test_replace_userord, clear_test),
+        cmocka_unit_test_teardown(test_edit_builder, clear_interfaces),
         cmocka_unit_test_teardown(test_isolate, clear_interfaces),
         cmocka_unit_test(test_purge),
         cmocka_unit_test(test_top_op),
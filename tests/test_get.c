@@ -19,6 +19,7 @@
 #include <pthread.h>
 #include <setjmp.h>
 #include <stdarg.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
@@ -152,6 +153,159 @@ test_cached_datastore(void **state)
     assert_int_equal(ret, SR_ERR_OK);
 }
 
+/* TEST */
+static void
+test_cached_pending_edit(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_t *data;
+    int ret;
+
+    /* pending edit of one module */
+    ret = sr_set_item_str(st->csess, "/simple:ac1/acl1[acs1='pending']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the edit is applied on the data of the module */
+    ret = sr_get_data(st->csess, "/simple:ac1/acl1", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data);
+    assert_string_equal(lyd_get_value(lyd_child(lyd_child(data->tree))), "pending");
+    sr_release_data(data);
+
+    /* other modules are read directly from the cache */
+    ret = sr_get_data(st->csess, "/defaults:dflt2", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data);
+    assert_string_equal(lyd_get_value(data->tree), "I exist!");
+    sr_release_data(data);
+
+    /* the cache itself is not changed */
+    ret = sr_discard_changes(st->csess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_data(st->csess, "/simple:ac1/acl1", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_null(data);
+}
+
+/* TEST */
+static void
+test_cached_read_only(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_t *data1, *data2;
+    int ret;
+
+    ret = sr_set_item_str(st->sess, "/simple:ac1/acl1[acs1='ro1']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the same read-only result is shared */
+    ret = sr_get_data(st->csess, "/simple:ac1/acl1", 0, 0, SR_GET_READ_ONLY, &data1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data1);
+    ret = sr_get_data(st->csess, "/simple:ac1/acl1", 0, 0, SR_GET_READ_ONLY, &data2);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_ptr_equal(data1, data2);
+    sr_release_data(data2);
+
+    /* a different request is not shared */
+    ret = sr_get_data(st->csess, "/simple:ac1/acl1", 1, 0, SR_GET_READ_ONLY, &data2);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_ptr_not_equal(data1, data2);
+    sr_release_data(data2);
+
+    /* neither is a standard result */
+    ret = sr_get_data(st->csess, "/simple:ac1/acl1", 0, 0, 0, &data2);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_ptr_not_equal(data1, data2);
+    sr_release_data(data2);
+    sr_release_data(data1);
+
+    /* change the data, a new result is created */
+    ret = sr_set_item_str(st->sess, "/simple:ac1/acl1[acs1='ro2']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_data(st->csess, "/simple:ac1/acl1", 0, 0, SR_GET_READ_ONLY, &data1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data1);
+    assert_string_equal(lyd_get_value(lyd_child(lyd_child(data1->tree)->prev)), "ro2");
+    sr_release_data(data1);
+
+    /* cleanup */
+    ret = sr_delete_item(st->sess, "/simple:ac1", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
+/* TEST */
+static void
+test_cached_serialized(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_t *data;
+    char *str1, *str2, *str3;
+    size_t len1, len2;
+    int ret;
+
+    ret = sr_set_item_str(st->sess, "/simple:ac1/acl1[acs1='ser1']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* no data */
+    ret = sr_get_data_serialized(st->csess, "/simple:ac1/acl1[acs1='none']", 0, 0, 0, LYD_JSON, 0, &str1, &len1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_null(str1);
+    assert_int_equal(len1, 0);
+
+    /* the same as printing the data */
+    ret = sr_get_data_serialized(st->csess, "/simple:ac1/acl1", 0, 0, 0, LYD_JSON, LYD_PRINT_SHRINK, &str1, &len1);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_data(st->csess, "/simple:ac1/acl1", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = lyd_print_mem(&str3, data->tree, LYD_JSON, LYD_PRINT_WITHSIBLINGS | LYD_PRINT_SHRINK);
+    assert_int_equal(ret, 0);
+    sr_release_data(data);
+    assert_string_equal(str1, str3);
+    assert_int_equal(len1, strlen(str3));
+    free(str3);
+
+    /* printed again from the shared result */
+    ret = sr_get_data_serialized(st->csess, "/simple:ac1/acl1", 0, 0, 0, LYD_JSON, LYD_PRINT_SHRINK, &str2, &len2);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(str1, str2);
+    assert_int_equal(len1, len2);
+    free(str2);
+
+    /* other print options */
+    ret = sr_get_data_serialized(st->csess, "/simple:ac1/acl1", 0, 0, 0, LYD_JSON, 0, &str2, &len2);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_not_equal(str1, str2);
+    free(str2);
+    free(str1);
+
+    /* change the data, the result is printed again */
+    ret = sr_set_item_str(st->sess, "/simple:ac1/acl1[acs1='ser2']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_data_serialized(st->csess, "/simple:ac1/acl1", 0, 0, 0, LYD_XML, LYD_PRINT_SHRINK, &str1, &len1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(strstr(str1, "ser2"));
+    free(str1);
+
+    /* cleanup */
+    ret = sr_delete_item(st->sess, "/simple:ac1", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
 /* TEST */
 static void *
 cached_thread1(void *arg)
@@ -275,6 +429,51 @@ test_enable_cached_get(void **state)
     sr_unsubscribe(sub);
 }
 
+/* TEST */
+static void
+test_prefetch(void **state)
+{
+    struct state *st = (struct state *)*state;
+    const char *mod_names[] = {"simple", "defaults"}, *unknown[] = {"no-module"};
+    sr_data_t *data;
+    int ret;
+
+    /* invalid */
+    ret = sr_conn_prefetch(st->conn, NULL, 0, SR_PREFETCH_RUNNING);
+    assert_int_equal(ret, SR_ERR_INVAL_ARG);
+    ret = sr_conn_prefetch(st->cconn, NULL, 0, SR_PREFETCH_OPER);
+    assert_int_equal(ret, SR_ERR_INVAL_ARG);
+    ret = sr_conn_prefetch(st->cconn, unknown, 1, SR_PREFETCH_RUNNING);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+
+    /* all the modules */
+    ret = sr_conn_prefetch(st->cconn, NULL, 0, SR_PREFETCH_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* change the data on another connection */
+    ret = sr_set_item_str(st->sess, "/simple:ac1/acl1[acs1='prefetched']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* selected modules */
+    ret = sr_conn_prefetch(st->cconn, mod_names, 2, SR_PREFETCH_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* current data are read from the cache */
+    ret = sr_get_data(st->csess, "/simple:ac1/acl1", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data);
+    assert_string_equal(lyd_get_value(lyd_child(lyd_child(data->tree))), "prefetched");
+    sr_release_data(data);
+
+    /* cleanup */
+    ret = sr_delete_item(st->sess, "/simple:ac1", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
 /* TEST */
 static void
 test_no_read_access(void **state)
@@ -555,6 +754,196 @@ test_key(void **state)
     sr_apply_changes(st->sess, 0);
 }
 
+/* TEST */
+static void
+test_item_exists(void **state)
+{
+    struct state *st = (struct state *)*state;
+    const sr_error_info_t *err_info;
+    int ret;
+
+    /* set a list */
+    ret = sr_set_item_str(st->sess, "/defaults:l1[k='val']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* existing data */
+    ret = sr_item_exists(st->sess, "/defaults:l1[k='val']", 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_item_exists(st->sess, "/defaults:l1/k", 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* non-existing data, no error */
+    ret = sr_item_exists(st->sess, "/defaults:l1[k='val2']", 0, 0);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+    ret = sr_session_get_error(st->sess, &err_info);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_null(err_info);
+
+    /* invalid path */
+    ret = sr_item_exists(st->sess, "/defaults:l1[", 0, 0);
+    assert_int_not_equal(ret, SR_ERR_OK);
+    assert_int_not_equal(ret, SR_ERR_NOT_FOUND);
+
+    /* cleanup */
+    sr_delete_item(st->sess, "/defaults:l1", 0);
+    sr_apply_changes(st->sess, 0);
+}
+
+/* TEST */
+static void
+test_big_list(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_t *data;
+    sr_val_t *vals, *ro_vals;
+    size_t val_count, ro_val_count;
+    char *str1, xpath[64];
+    const char *str2;
+    int ret, i;
+
+    /* set a list with enough instances for the datastore file to be indexed */
+    for (i = 0; i < 300; ++i) {
+        sprintf(xpath, "/defaults:l1[k='val%d']", i);
+        ret = sr_set_item_str(st->sess, xpath, NULL, NULL, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    ret = sr_set_item_str(st->sess, "/defaults:l2[k='key']/c1/lf1", "val", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read a single instance */
+    ret = sr_get_data(st->sess, "/defaults:l1[k='val42']/k", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = lyd_print_mem(&str1, data->tree, LYD_XML, LYD_PRINT_WITHSIBLINGS | LYD_PRINT_SHRINK);
+    assert_int_equal(ret, 0);
+    sr_release_data(data);
+
+    str2 =
+    "<l1 xmlns=\"urn:defaults\">"
+        "<k>val42</k>"
+    "</l1>";
+
+    assert_string_equal(str1, str2);
+    free(str1);
+
+    /* read a non-existing instance */
+    ret = sr_get_data(st->sess, "/defaults:l1[k='val300']", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_null(data);
+
+    /* read another list */
+    ret = sr_get_data(st->sess, "/defaults:l2[k='key']/c1/lf1", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = lyd_print_mem(&str1, data->tree, LYD_XML, LYD_PRINT_WITHSIBLINGS | LYD_PRINT_SHRINK);
+    assert_int_equal(ret, 0);
+    sr_release_data(data);
+
+    str2 =
+    "<l2 xmlns=\"urn:defaults\">"
+        "<k>key</k>"
+        "<c1><lf1>val</lf1></c1>"
+    "</l2>";
+
+    assert_string_equal(str1, str2);
+    free(str1);
+
+    /* read all the instances */
+    ret = sr_get_items(st->sess, "/defaults:l1/k", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 300);
+
+    /* read all the instances into a single block */
+    ret = sr_get_items(st->sess, "/defaults:l1/k", 0, SR_GET_READ_ONLY, &ro_vals, &ro_val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ro_val_count, val_count);
+    for (i = 0; i < 300; ++i) {
+        assert_string_equal(ro_vals[i].xpath, vals[i].xpath);
+        assert_int_equal(ro_vals[i].type, SR_STRING_T);
+        assert_string_equal(ro_vals[i].data.string_val, vals[i].data.string_val);
+        assert_int_equal(ro_vals[i].dflt, vals[i].dflt);
+    }
+    sr_free_values(ro_vals, ro_val_count);
+    sr_free_values(vals, val_count);
+
+    /* cleanup */
+    sr_delete_item(st->sess, "/defaults:l1", 0);
+    sr_delete_item(st->sess, "/defaults:l2", 0);
+    sr_apply_changes(st->sess, 0);
+}
+
+/* TEST */
+static void
+test_data_iter(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_iter_t *iter;
+    sr_data_t *data;
+    struct lyd_node *node;
+    char xpath[64];
+    int ret, i, count, total = 0;
+
+    /* set some list instances */
+    for (i = 0; i < 25; ++i) {
+        sprintf(xpath, "/defaults:l1[k='val%d']", i);
+        ret = sr_set_item_str(st->sess, xpath, NULL, NULL, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* invalid chunk size */
+    ret = sr_get_data_iter(st->sess, "/defaults:l1", 0, 0, 0, 0, &iter);
+    assert_int_equal(ret, SR_ERR_INVAL_ARG);
+
+    /* read them in chunks */
+    ret = sr_get_data_iter(st->sess, "/defaults:l1", 10, 0, 0, 0, &iter);
+    assert_int_equal(ret, SR_ERR_OK);
+    for (i = 0; i < 3; ++i) {
+        ret = sr_get_data_next(iter, &data);
+        assert_int_equal(ret, SR_ERR_OK);
+
+        count = 0;
+        LY_LIST_FOR(data->tree, node) {
+            assert_string_equal(LYD_NAME(node), "l1");
+            ++count;
+        }
+        assert_int_equal(count, (i < 2) ? 10 : 5);
+        total += count;
+        sr_release_data(data);
+
+        if (!i) {
+            /* the iterated data are not affected by changes */
+            ret = sr_delete_item(st->sess, "/defaults:l1[k='val24']", 0);
+            assert_int_equal(ret, SR_ERR_OK);
+            ret = sr_apply_changes(st->sess, 0);
+            assert_int_equal(ret, SR_ERR_OK);
+        }
+    }
+    assert_int_equal(total, 25);
+
+    /* no more data */
+    ret = sr_get_data_next(iter, &data);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+    assert_null(data);
+    sr_free_data_iter(iter);
+
+    /* no data at all */
+    ret = sr_get_data_iter(st->sess, "/defaults:l2", 10, 0, 0, 0, &iter);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_data_next(iter, &data);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+    sr_free_data_iter(iter);
+
+    /* cleanup */
+    sr_delete_item(st->sess, "/defaults:l1", 0);
+    sr_apply_changes(st->sess, 0);
+}
+
 /* TEST */
 static void
 test_factory_default(void **state)
@@ -632,13 +1021,20 @@ main(void)
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_invalid),
         cmocka_unit_test(test_cached_datastore),
+        cmocka_unit_test(test_cached_pending_edit),
+        cmocka_unit_test(test_cached_read_only),
+        cmocka_unit_test(test_cached_serialized),
         cmocka_unit_test(test_cached_thread),
         cmocka_unit_test(test_enable_cached_get),
+        cmocka_unit_test(test_prefetch),
         cmocka_unit_test(test_no_read_access),
         cmocka_unit_test(test_no_read_access),
         cmocka_unit_test(test_explicit_default),
         cmocka_unit_test(test_union),
         cmocka_unit_test(test_key),
+        cmocka_unit_test(test_item_exists),
+        cmocka_unit_test(test_big_list),
+        cmocka_unit_test(test_data_iter),
         cmocka_unit_test(test_factory_default),
     };
 
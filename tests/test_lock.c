@@ -292,6 +292,52 @@ test_session_stop_unlock(void **state)
     sr_session_stop(sess2);
 }
 
+/* TEST */
+static void
+test_session_reset(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_session_ctx_t *sess1, *sess2;
+    uint32_t sid;
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess1);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess2);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* lock a module and prepare some changes */
+    ret = sr_lock(sess1, "test", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess1, "/test:test-leaf", "5", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    sid = sr_session_get_id(sess1);
+
+    /* reset the session */
+    ret = sr_session_reset(sess1, SR_DS_STARTUP);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_not_equal(sr_session_get_id(sess1), sid);
+    assert_int_equal(sr_session_get_ds(sess1), SR_DS_STARTUP);
+    ret = sr_session_switch_ds(sess1, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_false(sr_has_changes(sess1));
+
+    /* the lock was released */
+    ret = sr_lock(sess2, "test", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_unlock(sess2, "test");
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the session can be used again */
+    ret = sr_lock(sess1, "test", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_reset(sess1, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess1);
+    sr_session_stop(sess2);
+}
+
 /* TEST */
 static void
 test_get_lock(void **state)
@@ -442,6 +488,7 @@ main(void)
         cmocka_unit_test(test_one_session),
         cmocka_unit_test(test_multi_session),
         cmocka_unit_test(test_session_stop_unlock),
+        cmocka_unit_test(test_session_reset),
         cmocka_unit_test(test_get_lock),
         cmocka_unit_test(test_timeout),
     };
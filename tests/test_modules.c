@@ -17,12 +17,15 @@
 #define _GNU_SOURCE
 
 #include <ctype.h>
+#include <errno.h>
 #include <grp.h>
 #include <pwd.h>
 #include <setjmp.h>
 #include <stdarg.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include <cmocka.h>
@@ -146,6 +149,7 @@ test_install_module(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>sub-mod-types</imports>"
     "</module>"
     );
 
@@ -196,6 +200,8 @@ test_data_deps(void **state)
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
         "<inverse-deps>refs</inverse-deps>"
+        "<imports>ietf-inet-types</imports>"
+        "<imports>ietf-netconf-acm</imports>"
         "<rpc><path xmlns:t=\"urn:test\">/t:r1</path></rpc>"
         "<rpc><path xmlns:t=\"urn:test\">/t:r2</path></rpc>"
     "</module>"
@@ -211,6 +217,7 @@ test_data_deps(void **state)
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
         "<replay-support>00000000000000000000000000000000000</replay-support>"
+        "<imports>ietf-yang-types</imports>"
     "</module>"
     );
     cmp_int_data(st->conn, "iana-if-type",
@@ -223,6 +230,7 @@ test_data_deps(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>ietf-interfaces</imports>"
     "</module>"
     );
     cmp_int_data(st->conn, "refs",
@@ -248,6 +256,7 @@ test_data_deps(void **state)
                 "<source-path xmlns:r=\"urn:refs\">/r:inst-id</source-path>"
             "</inst-id>"
         "</deps>"
+        "<imports>test</imports>"
     "</module>"
     );
 
@@ -299,6 +308,7 @@ test_op_deps(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>ops-ref</imports>"
         "<rpc>"
             "<path xmlns:o=\"urn:ops\">/o:cont/o:list1/o:cont2/o:act1</path>"
             "<out>"
@@ -364,6 +374,7 @@ test_op_deps(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>ops-ref</imports>"
         "<rpc>"
             "<path xmlns:o=\"urn:ops\">/o:cont/o:list1/o:cont2/o:act1</path>"
             "<out>"
@@ -473,6 +484,8 @@ test_inv_deps(void **state)
             "</xpath>"
         "</deps>"
         "<inverse-deps>ietf-interfaces</inverse-deps>"
+        "<imports>ietf-yang-types</imports>"
+        "<imports>ietf-interfaces</imports>"
         "<rpc>"
             "<path xmlns:rt=\"urn:ietf:params:xml:ns:yang:ietf-routing\">/rt:fib-route</path>"
             "<in>"
@@ -512,6 +525,7 @@ test_inv_deps(void **state)
             "</xpath>"
         "</deps>"
         "<inverse-deps>ietf-routing</inverse-deps>"
+        "<imports>ietf-yang-types</imports>"
     "</module>"
     );
 
@@ -529,6 +543,7 @@ test_inv_deps(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>ietf-yang-types</imports>"
     "</module>"
     );
 
@@ -583,6 +598,7 @@ test_remove_imp_module(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>simple</imports>"
     "</module>"
     );
 
@@ -635,6 +651,85 @@ test_update_module(void **state)
     assert_int_equal(ret, SR_ERR_OK);
 }
 
+static void
+test_change_set(void **state)
+{
+    struct state *st = (struct state *)*state;
+    const struct ly_ctx *ly_ctx;
+    const struct lys_module *ly_mod;
+    const char *en_feats[] = {"feat1", NULL};
+    const char *upd_paths[] = {TESTS_SRC_DIR "/files/rev@1970-01-01.yang", NULL};
+    const char *rem_names[] = {"simple", NULL};
+    const char *rem_all[] = {"rev-ref", "rev", "features", "test", NULL};
+    sr_install_mod_t inst = {0};
+    sr_feature_change_t feats[2];
+    sr_replay_change_t replay = {.module_name = "rev", .enable = 1};
+    sr_module_change_set_t changes;
+    int ret;
+
+    /* install the initial modules */
+    ret = sr_install_module(st->conn, TESTS_SRC_DIR "/files/rev.yang", TESTS_SRC_DIR "/files", NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_install_module(st->conn, TESTS_SRC_DIR "/files/rev-ref.yang", TESTS_SRC_DIR "/files", NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_install_module(st->conn, TESTS_SRC_DIR "/files/simple.yang", TESTS_SRC_DIR "/files", NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* install, remove, update, and enable replay at once */
+    inst.schema_path = TESTS_SRC_DIR "/files/features.yang";
+    inst.features = en_feats;
+    memset(&changes, 0, sizeof changes);
+    changes.install = &inst;
+    changes.install_count = 1;
+    changes.remove = rem_names;
+    changes.update = upd_paths;
+    changes.replay = &replay;
+    changes.replay_count = 1;
+    ret = sr_change_modules(st->conn, &changes, TESTS_SRC_DIR "/files");
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ly_ctx = sr_acquire_context(st->conn);
+    ly_mod = ly_ctx_get_module_implemented(ly_ctx, "rev");
+    assert_non_null(ly_mod);
+    assert_string_equal(ly_mod->revision, "1970-01-01");
+    assert_null(ly_ctx_get_module_implemented(ly_ctx, "simple"));
+    ly_mod = ly_ctx_get_module_implemented(ly_ctx, "features");
+    assert_non_null(ly_mod);
+    assert_int_equal(lys_feature_value(ly_mod, "feat1"), LY_SUCCESS);
+    assert_int_equal(lys_feature_value(ly_mod, "feat2"), LY_ENOT);
+    sr_release_context(st->conn);
+
+    /* change several features of a module at once */
+    feats[0].module_name = "features";
+    feats[0].feature_name = "feat2";
+    feats[0].enable = 1;
+    feats[1].module_name = "features";
+    feats[1].feature_name = "feat1";
+    feats[1].enable = 0;
+    memset(&changes, 0, sizeof changes);
+    changes.features = feats;
+    changes.feature_count = 2;
+    ret = sr_change_modules(st->conn, &changes, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ly_ctx = sr_acquire_context(st->conn);
+    ly_mod = ly_ctx_get_module_implemented(ly_ctx, "features");
+    assert_int_equal(lys_feature_value(ly_mod, "feat1"), LY_ENOT);
+    assert_int_equal(lys_feature_value(ly_mod, "feat2"), LY_SUCCESS);
+    sr_release_context(st->conn);
+
+    /* a module cannot be removed and have its features changed */
+    changes.remove = rem_all;
+    ret = sr_change_modules(st->conn, &changes, NULL);
+    assert_int_equal(ret, SR_ERR_INVAL_ARG);
+
+    /* cleanup, all at once */
+    memset(&changes, 0, sizeof changes);
+    changes.remove = rem_all;
+    ret = sr_change_modules(st->conn, &changes, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
 static void
 test_change_feature(void **state)
 {
@@ -664,6 +759,7 @@ test_change_feature(void **state)
                 "<target-module>test</target-module>"
             "</lref>"
         "</deps>"
+        "<imports>test</imports>"
     "</module>"
     );
     cmp_int_data(st->conn, "test",
@@ -676,6 +772,8 @@ test_change_feature(void **state)
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
         "<inverse-deps>features</inverse-deps>"
+        "<imports>ietf-inet-types</imports>"
+        "<imports>ietf-netconf-acm</imports>"
         "<rpc><path xmlns:t=\"urn:test\">/t:r1</path></rpc>"
         "<rpc><path xmlns:t=\"urn:test\">/t:r2</path></rpc>"
     "</module>"
@@ -705,6 +803,7 @@ test_change_feature(void **state)
                 "<target-module>test</target-module>"
             "</lref>"
         "</deps>"
+        "<imports>test</imports>"
     "</module>"
     );
 
@@ -745,6 +844,7 @@ test_change_feature(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>test</imports>"
     "</module>"
     );
 
@@ -758,6 +858,8 @@ test_change_feature(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>ietf-inet-types</imports>"
+        "<imports>ietf-netconf-acm</imports>"
         "<rpc><path xmlns:t=\"urn:test\">/t:r1</path></rpc>"
         "<rpc><path xmlns:t=\"urn:test\">/t:r2</path></rpc>"
     "</module>"
@@ -819,6 +921,8 @@ test_replay_support(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>ietf-inet-types</imports>"
+        "<imports>ietf-netconf-acm</imports>"
         "<rpc><path xmlns:t=\"urn:test\">/t:r1</path></rpc>"
         "<rpc><path xmlns:t=\"urn:test\">/t:r2</path></rpc>"
     "</module>"
@@ -834,6 +938,7 @@ test_replay_support(void **state)
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
         "<replay-support>00000000000000000000000000000000000</replay-support>"
+        "<imports>ietf-yang-types</imports>"
     "</module>"
     );
     cmp_int_data(st->conn, "iana-if-type",
@@ -846,6 +951,7 @@ test_replay_support(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>ietf-interfaces</imports>"
     "</module>"
     );
     cmp_int_data(st->conn, "simple",
@@ -875,6 +981,8 @@ test_replay_support(void **state)
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
         "<replay-support>00000000000000000000000000000000000</replay-support>"
+        "<imports>ietf-inet-types</imports>"
+        "<imports>ietf-netconf-acm</imports>"
         "<rpc><path xmlns:t=\"urn:test\">/t:r1</path></rpc>"
         "<rpc><path xmlns:t=\"urn:test\">/t:r2</path></rpc>"
     "</module>"
@@ -890,6 +998,7 @@ test_replay_support(void **state)
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
         "<replay-support>00000000000000000000000000000000000</replay-support>"
+        "<imports>ietf-yang-types</imports>"
     "</module>"
     );
     cmp_int_data(st->conn, "iana-if-type",
@@ -903,6 +1012,7 @@ test_replay_support(void **state)
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
         "<replay-support>00000000000000000000000000000000000</replay-support>"
+        "<imports>ietf-interfaces</imports>"
     "</module>"
     );
     cmp_int_data(st->conn, "simple",
@@ -931,6 +1041,8 @@ test_replay_support(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>ietf-inet-types</imports>"
+        "<imports>ietf-netconf-acm</imports>"
         "<rpc><path xmlns:t=\"urn:test\">/t:r1</path></rpc>"
         "<rpc><path xmlns:t=\"urn:test\">/t:r2</path></rpc>"
     "</module>"
@@ -945,6 +1057,7 @@ test_replay_support(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>ietf-yang-types</imports>"
     "</module>"
     );
     cmp_int_data(st->conn, "iana-if-type",
@@ -957,6 +1070,7 @@ test_replay_support(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>ietf-interfaces</imports>"
     "</module>"
     );
     cmp_int_data(st->conn, "simple",
@@ -1004,6 +1118,7 @@ test_foreign_aug(void **state)
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
         "<inverse-deps>aug-trg</inverse-deps>"
+        "<imports>aug-trg</imports>"
     "</module>"
     );
 
@@ -1056,6 +1171,7 @@ test_foreign_aug(void **state)
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
         "<inverse-deps>aug-trg</inverse-deps>"
+        "<imports>aug-trg</imports>"
     "</module>"
     );
 
@@ -1180,6 +1296,7 @@ test_startup_data_foreign_identityref(void **state)
                 "<expression xmlns:t1=\"http://www.example.net/t1\" xmlns:tt=\"http://www.example.net/t-types\">t1:layer-protocol-name='tt:desc'</expression>"
             "</xpath>"
         "</deps>"
+        "<imports>t-types</imports>"
     "</module>"
     );
     cmp_int_data(st->conn, "t2",
@@ -1191,6 +1308,8 @@ test_startup_data_foreign_identityref(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>t-types</imports>"
+        "<imports>t1</imports>"
     "</module>"
     );
 
@@ -1395,6 +1514,7 @@ test_feature_deps(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>feature-deps2</imports>"
     "</module>"
     );
     cmp_int_data(st->conn, "feature-deps2",
@@ -1434,6 +1554,7 @@ test_feature_deps(void **state)
         "<plugin><datastore>ds:operational</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>fd:factory-default</datastore><name>JSON DS file</name></plugin>"
         "<plugin><datastore>sr:notification</datastore><name>JSON notif</name></plugin>"
+        "<imports>feature-deps2</imports>"
     "</module>"
     );
     cmp_int_data(st->conn, "feature-deps2",
@@ -1552,6 +1673,235 @@ test_update_data_no_write_perm(void **state)
     assert_int_equal(ret, SR_ERR_OK);
 }
 
+static void
+test_shm_ds_plugin(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_session_ctx_t *sess;
+    sr_data_t *data;
+    sr_val_t *val;
+    sr_module_ds_t module_ds = {{NULL, "LYB DS shm", "LYB DS shm", "LYB DS shm", NULL, NULL}};
+    int ret;
+
+    /* install the module with volatile datastores in SHM */
+    ret = sr_install_module2(st->conn, TESTS_SRC_DIR "/files/test.yang", TESTS_SRC_DIR "/files", NULL, &module_ds,
+            NULL, NULL, 0, NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* store running data */
+    ret = sr_set_item_str(sess, "/test:l1[k='a']/v", "1", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* change candidate */
+    ret = sr_session_switch_ds(sess, SR_DS_CANDIDATE);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess, "/test:test-leaf", "5", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_item(sess, "/test:test-leaf", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 5);
+    sr_free_val(val);
+    ret = sr_get_item(sess, "/test:l1[k='a']/v", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 1);
+    sr_free_val(val);
+
+    /* commit candidate into running and running into startup */
+    ret = sr_session_switch_ds(sess, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_copy_config(sess, "test", SR_DS_CANDIDATE, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_switch_ds(sess, SR_DS_STARTUP);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_copy_config(sess, "test", SR_DS_RUNNING, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* startup data are stored in the JSON file */
+    ret = sr_get_item(sess, "/test:test-leaf", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 5);
+    sr_free_val(val);
+    ret = sr_get_item(sess, "/test:l1[k='a']/v", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 1);
+    sr_free_val(val);
+
+    /* reset running to startup */
+    ret = sr_session_switch_ds(sess, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_delete_item(sess, "/test:l1", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_copy_config(sess, "test", SR_DS_STARTUP, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_data(sess, "/test:l1", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data);
+    sr_release_data(data);
+
+    sr_session_stop(sess);
+
+    ret = sr_remove_module(st->conn, "test", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
+
+static void
+test_json_ds_journal(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_session_ctx_t *sess;
+    sr_val_t *val;
+    struct stat jst, dst;
+    const char *prefix;
+    char *jpath, *dpath, *jdata, xpath[32], value[8];
+    uint64_t hdr_val[3];
+    size_t jsize;
+    FILE *f;
+    int ret, i, journaled, compacted;
+
+    if (!SR_JSON_DS_JOURNAL_SIZE) {
+        /* running changes are not journaled */
+        skip();
+    }
+
+    ret = sr_install_module(st->conn, TESTS_SRC_DIR "/files/test.yang", TESTS_SRC_DIR "/files", NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    prefix = getenv("SYSREPO_SHM_PREFIX");
+    ret = asprintf(&jpath, "%s/%s_test.running.journal", SR_SHM_DIR, prefix ? prefix : "sr");
+    assert_int_not_equal(ret, -1);
+    ret = asprintf(&dpath, "%s/%s_test.running", SR_SHM_DIR, prefix ? prefix : "sr");
+    assert_int_not_equal(ret, -1);
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* store some data in full */
+    for (i = 0; i < 50; ++i) {
+        sprintf(xpath, "/test:l1[k='key%d']/v", i);
+        ret = sr_set_item_str(sess, xpath, "1", NULL, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* a small change is appended to the journal */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "1", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(stat(jpath, &jst), 0);
+
+    /* keep the journal */
+    jsize = jst.st_size;
+    jdata = malloc(jsize);
+    assert_non_null(jdata);
+    f = fopen(jpath, "r");
+    assert_non_null(f);
+    assert_int_equal(fread(jdata, 1, jsize, f), jsize);
+    fclose(f);
+
+    /* the change is replayed after reconnecting */
+    sr_session_stop(sess);
+    sr_disconnect(st->conn);
+    ret = sr_connect(0, &st->conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_item(sess, "/test:test-leaf", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 1);
+    sr_free_val(val);
+
+    /* an incomplete last record of an interrupted append is ignored */
+    f = fopen(jpath, "a");
+    assert_non_null(f);
+    assert_int_equal(fwrite("\x40\x00\x00\x00{\"test:", 1, 11, f), 11);
+    fclose(f);
+    ret = sr_get_item(sess, "/test:test-leaf", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 1);
+    sr_free_val(val);
+
+    /* the next change compacts the journal instead */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "2", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(stat(jpath, &jst), -1);
+    assert_int_equal(errno, ENOENT);
+    ret = sr_get_item(sess, "/test:test-leaf", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 2);
+    sr_free_val(val);
+
+    /* a journal of previous data is ignored even with the size and modification time of the current data */
+    assert_int_equal(stat(dpath, &dst), 0);
+    hdr_val[0] = dst.st_size;
+    hdr_val[1] = dst.st_mtim.tv_sec;
+    hdr_val[2] = dst.st_mtim.tv_nsec;
+    memcpy(jdata + 8, hdr_val, sizeof hdr_val);
+    f = fopen(jpath, "w");
+    assert_non_null(f);
+    assert_int_equal(fwrite(jdata, 1, jsize, f), jsize);
+    fclose(f);
+    ret = sr_get_item(sess, "/test:test-leaf", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 2);
+    sr_free_val(val);
+    assert_int_equal(unlink(jpath), 0);
+    free(jdata);
+
+    /* keep appending changes until the journal is compacted */
+    journaled = 0;
+    compacted = 0;
+    for (i = 3; (i < 100) && !compacted; ++i) {
+        sprintf(value, "%d", i);
+        ret = sr_set_item_str(sess, "/test:test-leaf", value, NULL, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+        ret = sr_apply_changes(sess, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+
+        if (!stat(jpath, &jst)) {
+            journaled = 1;
+        } else if (journaled) {
+            compacted = 1;
+        }
+    }
+    assert_true(compacted);
+
+    /* no change was lost */
+    sr_session_stop(sess);
+    sr_disconnect(st->conn);
+    ret = sr_connect(0, &st->conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_item(sess, "/test:test-leaf", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, i - 1);
+    sr_free_val(val);
+    ret = sr_get_item(sess, "/test:l1[k='key49']/v", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 1);
+    sr_free_val(val);
+
+    sr_session_stop(sess);
+    free(jpath);
+    free(dpath);
+
+    ret = sr_remove_module(st->conn, "test", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
 int
 main(void)
 {
@@ -1564,6 +1914,7 @@ main(void)
         cmocka_unit_test_setup_teardown(test_remove_imp_module, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_update_module, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_change_feature, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_change_set, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_replay_support, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_foreign_aug, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_empty_invalid, setup_f, teardown_f),
@@ -1574,6 +1925,8 @@ main(void)
         cmocka_unit_test_setup_teardown(test_feature_deps2, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_update_data_deviation, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_update_data_no_write_perm, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_shm_ds_plugin, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_json_ds_journal, setup_f, teardown_f),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
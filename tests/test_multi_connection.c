@@ -16,9 +16,11 @@
 
 #define _GNU_SOURCE
 
+#include <inttypes.h>
 #include <pthread.h>
 #include <setjmp.h>
 #include <stdarg.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -189,15 +191,368 @@ test_new(void **state)
     pthread_barrier_destroy(&st->barrier);
 }
 
+static void
+test_lazy_ctx(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess;
+    const struct ly_ctx *ly_ctx;
+    sr_data_t *subtree;
+    int ret;
+
+    ret = sr_set_item_str(st->sess1, "/ietf-interfaces:interfaces/interface[name='ethL']/type",
+            "iana-if-type:ethernetCsmacd", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess1, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_connect(SR_CONN_LAZY_CTX, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* only internal modules */
+    ly_ctx = sr_acquire_context(conn);
+    assert_null(ly_ctx_get_module_implemented(ly_ctx, "ietf-interfaces"));
+    assert_null(ly_ctx_get_module_implemented(ly_ctx, "test"));
+    assert_non_null(ly_ctx_get_module_implemented(ly_ctx, "sysrepo-monitoring"));
+    sr_release_context(conn);
+
+    /* module loaded on demand, with the module importing it */
+    ret = sr_get_subtree(sess, "/ietf-interfaces:interfaces/interface[name='ethL']", 0, &subtree);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(subtree);
+    assert_string_equal(lyd_get_value(lyd_child(subtree->tree)), "ethL");
+    sr_release_data(subtree);
+
+    ly_ctx = sr_acquire_context(conn);
+    assert_non_null(ly_ctx_get_module_implemented(ly_ctx, "ietf-interfaces"));
+    assert_non_null(ly_ctx_get_module_implemented(ly_ctx, "iana-if-type"));
+    assert_null(ly_ctx_get_module_implemented(ly_ctx, "test"));
+    sr_release_context(conn);
+
+    /* another module cannot be loaded with prepared changes */
+    ret = sr_delete_item(sess, "/ietf-interfaces:interfaces/interface[name='ethL']", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess, "/test:test-leaf", "2", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OPERATION_FAILED);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_set_item_str(sess, "/test:test-leaf", "2", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_discard_changes(sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_disconnect(conn);
+}
+
+static void
+test_lazy_ctx_api(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess;
+    const struct ly_ctx *ly_ctx;
+    sr_data_t *node;
+    int ret;
+
+    ret = sr_set_item_str(st->sess1, "/test:test-leaf", "3", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess1, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_connect(SR_CONN_LAZY_CTX, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* module loaded by a path */
+    ret = sr_get_node(sess, "/test:test-leaf", 0, &node);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(node->tree), "3");
+    sr_release_data(node);
+
+    /* module loaded by name */
+    ret = sr_lock(sess, "ietf-interfaces", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_unlock(sess, "ietf-interfaces");
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ly_ctx = sr_acquire_context(conn);
+    assert_non_null(ly_ctx_get_module_implemented(ly_ctx, "test"));
+    assert_non_null(ly_ctx_get_module_implemented(ly_ctx, "ietf-interfaces"));
+    sr_release_context(conn);
+
+    sr_disconnect(conn);
+
+    ret = sr_delete_item(st->sess1, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess1, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
+static void
+test_lazy_ctx_submodule(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess;
+    const struct ly_ctx *ly_ctx;
+    sr_data_t *subtree;
+    int ret;
+
+    /* module augmenting test only from its submodule */
+    ret = sr_install_module(st->conn1, TESTS_SRC_DIR "/files/sub-aug.yang", TESTS_SRC_DIR "/files", NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess1, "/test:cont/sub-aug:sub-aug-leaf", "val", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess1, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_connect(SR_CONN_LAZY_CTX, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the importing module is loaded with the augmented one */
+    ret = sr_get_subtree(sess, "/test:cont", 0, &subtree);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(subtree);
+    assert_string_equal(LYD_NAME(lyd_child(subtree->tree)), "sub-aug-leaf");
+    assert_string_equal(lyd_get_value(lyd_child(subtree->tree)), "val");
+    sr_release_data(subtree);
+
+    ly_ctx = sr_acquire_context(conn);
+    assert_non_null(ly_ctx_get_module_implemented(ly_ctx, "test"));
+    assert_non_null(ly_ctx_get_module_implemented(ly_ctx, "sub-aug"));
+    assert_null(ly_ctx_get_module_implemented(ly_ctx, "ietf-interfaces"));
+    sr_release_context(conn);
+
+    sr_disconnect(conn);
+
+    ret = sr_delete_item(st->sess1, "/test:cont", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess1, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_remove_module(st->conn1, "sub-aug", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
+static int
+dummy_change_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        sr_event_t event, uint32_t request_id, void *private_data)
+{
+    (void)session;
+    (void)sub_id;
+    (void)module_name;
+    (void)xpath;
+    (void)event;
+    (void)request_id;
+    (void)private_data;
+
+    return SR_ERR_OK;
+}
+
+static void
+test_ext_shm_stats(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr[8] = {NULL};
+    sr_ext_shm_stats_t stats;
+    char xpath[64];
+    uint32_t i, hole_count;
+    int ret;
+
+    /* subscribe with several connections so that the subscriptions are interleaved */
+    for (i = 0; i < 8; ++i) {
+        sprintf(xpath, "/ietf-interfaces:interfaces/interface[name='eth%" PRIu32 "']", i);
+        ret = sr_module_change_subscribe((i % 2) ? st->sess2 : st->sess1, "ietf-interfaces", xpath, dummy_change_cb,
+                NULL, 0, 0, &subscr[i]);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+
+    ret = sr_get_ext_shm_stats(st->conn1, &stats);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_true(stats.size > stats.hole_size);
+    assert_true(stats.largest_hole <= stats.hole_size);
+
+    /* unsubscribe one connection, memory holes are created */
+    for (i = 0; i < 8; i += 2) {
+        sr_unsubscribe(subscr[i]);
+        subscr[i] = NULL;
+    }
+
+    ret = sr_get_ext_shm_stats(st->conn3, &stats);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_not_equal(stats.hole_count, 0);
+    assert_true(stats.size > stats.hole_size);
+    assert_true(stats.largest_hole <= stats.hole_size);
+    hole_count = stats.hole_count;
+
+    /* unsubscribe the rest, adjacent holes are merged */
+    for (i = 1; i < 8; i += 2) {
+        sr_unsubscribe(subscr[i]);
+    }
+
+    ret = sr_get_ext_shm_stats(st->conn1, &stats);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_true(stats.hole_count <= hole_count);
+    assert_true(stats.largest_hole <= stats.hole_size);
+}
+
+static void
+test_shm_stats(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_shm_stats_t *stats;
+    const sr_mod_shm_stats_t *mod = NULL;
+    uint32_t i, sub_count = 0;
+    int ret;
+
+    /* 2 subscriptions of the second connection */
+    ret = sr_module_change_subscribe(st->sess2, "ietf-interfaces", NULL, dummy_change_cb, NULL, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_module_change_subscribe(st->sess2, "ietf-interfaces", "/ietf-interfaces:interfaces/interface", dummy_change_cb,
+            NULL, 1, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_shm_stats(st->conn1, &stats);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_not_equal(stats->main_size, 0);
+    assert_int_not_equal(stats->mod_size, 0);
+    assert_int_not_equal(stats->ext.size, 0);
+    assert_int_not_equal(stats->sub_shm_count, 0);
+
+    /* module subscriptions and their sub SHM */
+    for (i = 0; i < stats->mod_count; ++i) {
+        if (!strcmp(stats->mods[i].name, "ietf-interfaces")) {
+            mod = &stats->mods[i];
+        }
+    }
+    assert_non_null(mod);
+    assert_int_equal(mod->sub_count, 2);
+    assert_int_not_equal(mod->ext_size, 0);
+    assert_int_not_equal(mod->sub_shm_count, 0);
+
+    /* the connections, the first one without subscriptions maps only the main SHMs */
+    assert_int_equal(stats->conns[0].sub_count, 0);
+    assert_int_equal(stats->conns[0].mapped_size, stats->main_size + stats->mod_size + stats->ext.size);
+    for (i = 1; i < stats->conn_count; ++i) {
+        sub_count += stats->conns[i].sub_count;
+        assert_true(stats->conns[i].mapped_size > stats->conns[0].mapped_size);
+    }
+    assert_int_equal(sub_count, 2);
+    sr_free_shm_stats(stats);
+
+    sr_unsubscribe(subscr);
+}
+
+static void
+test_lock_stats(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_t *data;
+    struct lyd_node *node;
+    int ret;
+
+    /* write-lock the module data twice */
+    ret = sr_set_item_str(st->sess1, "/ietf-interfaces:interfaces/interface[name='ethS']/type",
+            "iana-if-type:ethernetCsmacd", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess1, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_delete_item(st->sess2, "/ietf-interfaces:interfaces", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess2, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read the statistics */
+    ret = sr_session_switch_ds(st->sess3, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_data(st->sess3, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/lock-stats", 0, 0,
+            0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_switch_ds(st->sess3, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = lyd_find_path(data->tree, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/"
+            "lock-stats[name='data-lock/running']/mode[name='write']/acquired", 0, &node);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_true(strtoull(lyd_get_value(node), NULL, 10) >= 2);
+    ret = lyd_find_path(data->tree, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/"
+            "lock-stats[name='data-lock/running']/mode[name='read']/acquired", 0, &node);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_true(strtoull(lyd_get_value(node), NULL, 10) >= 2);
+    ret = lyd_find_path(data->tree, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/"
+            "lock-stats[name='change-sub-lock/running']", 0, NULL);
+    assert_int_equal(ret, LY_SUCCESS);
+
+    sr_release_data(data);
+}
+
+static void
+test_ds_stats(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_t *data;
+    struct lyd_node *node;
+    int ret;
+
+    /* store running data */
+    ret = sr_set_item_str(st->sess1, "/ietf-interfaces:interfaces/interface[name='ethD']/type",
+            "iana-if-type:ethernetCsmacd", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess1, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read the statistics */
+    ret = sr_session_switch_ds(st->sess3, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_data(st->sess3, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/datastore", 0, 0,
+            0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_switch_ds(st->sess3, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = lyd_find_path(data->tree, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/"
+            "datastore[name='ietf-datastores:running']/plugin", 0, &node);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_string_equal(lyd_get_value(node), "JSON DS file");
+    ret = lyd_find_path(data->tree, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/"
+            "datastore[name='ietf-datastores:running']/store-time/count", 0, &node);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_true(strtoull(lyd_get_value(node), NULL, 10) >= 1);
+
+    sr_release_data(data);
+
+    /* cleanup */
+    ret = sr_delete_item(st->sess1, "/ietf-interfaces:interfaces", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess1, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
 int
 main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_teardown(test_create1, clear_interfaces),
         cmocka_unit_test(test_new),
+        cmocka_unit_test_teardown(test_lazy_ctx, clear_interfaces),
+        cmocka_unit_test(test_lazy_ctx_api),
+        cmocka_unit_test(test_lazy_ctx_submodule),
+        cmocka_unit_test(test_ext_shm_stats),
+        cmocka_unit_test(test_shm_stats),
+        cmocka_unit_test(test_lock_stats),
+        cmocka_unit_test(test_ds_stats),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
+    setenv("SYSREPO_LOCK_STATS", "1", 1);
+    setenv("SYSREPO_DS_STATS", "1", 1);
     test_log_init();
     return cmocka_run_group_tests(tests, setup_f, teardown_f);
 }
@@ -41,6 +41,9 @@ setup_f(void **state)
     struct state *st;
     const char *schema_paths[] = {
         TESTS_SRC_DIR "/files/test.yang",
+        TESTS_SRC_DIR "/files/ops-ref.yang",
+        TESTS_SRC_DIR "/files/ops.yang",
+        TESTS_SRC_DIR "/files/nacm-targets.yang",
         NULL
     };
 
@@ -71,6 +74,9 @@ teardown_f(void **state)
 {
     struct state *st = (struct state *)*state;
     const char *module_names[] = {
+        "nacm-targets",
+        "ops",
+        "ops-ref",
         "test",
         NULL
     };
@@ -333,6 +339,55 @@ test_read(void **state)
     assert_null(data);
 }
 
+static void
+test_read_shared(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess;
+    sr_data_t *data;
+    char *str;
+    int ret;
+
+    /* connection sharing read-only results */
+    ret = sr_connect(SR_CONN_CACHE_RUNNING, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_nacm_set_user(sess, "test-user");
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read data, shared */
+    ret = sr_get_data(sess, "/test:cont", 0, 0, SR_GET_READ_ONLY, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = lyd_print_mem(&str, data->tree, LYD_XML, LYD_PRINT_WITHSIBLINGS);
+    assert_int_equal(ret, LY_SUCCESS);
+    sr_release_data(data);
+    assert_string_equal(str,
+            "<cont xmlns=\"urn:test\">\n"
+            "  <l2>\n"
+            "    <k>k1</k>\n"
+            "  </l2>\n"
+            "</cont>\n");
+    free(str);
+
+    /* revoke the rule */
+    ret = sr_nacm_set_user(st->sess, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_delete_item(st->sess, "/ietf-netconf-acm:nacm/rule-list[name='rule1']/rule[name='allow-key']", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read no data, the shared result is not valid anymore */
+    ret = sr_get_data(sess, "/test:cont", 0, 0, SR_GET_READ_ONLY, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_null(data);
+
+    sr_disconnect(conn);
+}
+
 /* TEST */
 static int
 setup_filter_denied_nacm(void **state)
@@ -814,16 +869,378 @@ test_read_var(void **state)
     free(str);
 }
 
+/* TEST */
+static int
+setup_read_compiled_nacm(void **state)
+{
+    struct state *st = (struct state *)*state;
+    const struct ly_ctx *ctx;
+    const char *data;
+    struct lyd_node *edit;
+
+    /* set NACM and some data */
+    data = "<nacm xmlns=\"urn:ietf:params:xml:ns:yang:ietf-netconf-acm\">\n"
+            "  <read-default>deny</read-default>\n"
+            "  <enable-external-groups>false</enable-external-groups>\n"
+            "  <groups>\n"
+            "    <group>\n"
+            "      <name>test-group</name>\n"
+            "      <user-name>test-user</user-name>\n"
+            "    </group>\n"
+            "  </groups>\n"
+            "  <rule-list>\n"
+            "    <name>rule1</name>\n"
+            "    <group>test-group</group>\n"
+            "    <rule>\n"
+            "      <name>allow-all-keys</name>\n"
+            "      <module-name>nacm-targets</module-name>\n"
+            "      <path xmlns:nt=\"urn:nacm-targets\">/nt:cont/nt:l[nt:k1='a'][nt:k2='b']</path>\n"
+            "      <access-operations>read</access-operations>\n"
+            "      <action>permit</action>\n"
+            "    </rule>\n"
+            "    <rule>\n"
+            "      <name>allow-first-key</name>\n"
+            "      <module-name>nacm-targets</module-name>\n"
+            "      <path xmlns:nt=\"urn:nacm-targets\">/nt:cont/nt:l[nt:k1='c']</path>\n"
+            "      <access-operations>read</access-operations>\n"
+            "      <action>permit</action>\n"
+            "    </rule>\n"
+            "    <rule>\n"
+            "      <name>allow-user-key</name>\n"
+            "      <module-name>nacm-targets</module-name>\n"
+            "      <path xmlns:nt=\"urn:nacm-targets\">/nt:cont/nt:l[nt:k1=$USER]</path>\n"
+            "      <access-operations>read</access-operations>\n"
+            "      <action>permit</action>\n"
+            "    </rule>\n"
+            "    <rule>\n"
+            "      <name>allow-ll-value</name>\n"
+            "      <module-name>nacm-targets</module-name>\n"
+            "      <path xmlns:nt=\"urn:nacm-targets\">/nt:cont/nt:ll[.='x']</path>\n"
+            "      <access-operations>read</access-operations>\n"
+            "      <action>permit</action>\n"
+            "    </rule>\n"
+            "    <rule>\n"
+            "      <name>allow-parent-module</name>\n"
+            "      <module-name>*</module-name>\n"
+            "      <path xmlns:t=\"urn:test\">/t:cont/t:server</path>\n"
+            "      <access-operations>read</access-operations>\n"
+            "      <action>permit</action>\n"
+            "    </rule>\n"
+            "    <rule>\n"
+            "      <name>allow-position</name>\n"
+            "      <module-name>nacm-targets</module-name>\n"
+            "      <path xmlns:nt=\"urn:nacm-targets\">/nt:cont/nt:kl[2]</path>\n"
+            "      <access-operations>read</access-operations>\n"
+            "      <action>permit</action>\n"
+            "    </rule>\n"
+            "  </rule-list>\n"
+            "</nacm>\n"
+            "<cont xmlns=\"urn:nacm-targets\">\n"
+            "  <l>\n"
+            "    <k1>a</k1>\n"
+            "    <k2>b</k2>\n"
+            "    <v>1</v>\n"
+            "  </l>\n"
+            "  <l>\n"
+            "    <k1>a</k1>\n"
+            "    <k2>c</k2>\n"
+            "    <v>2</v>\n"
+            "  </l>\n"
+            "  <l>\n"
+            "    <k1>c</k1>\n"
+            "    <k2>x</k2>\n"
+            "    <v>3</v>\n"
+            "  </l>\n"
+            "  <l>\n"
+            "    <k1>c</k1>\n"
+            "    <k2>y</k2>\n"
+            "    <v>4</v>\n"
+            "  </l>\n"
+            "  <l>\n"
+            "    <k1>test-user</k1>\n"
+            "    <k2>z</k2>\n"
+            "    <v>5</v>\n"
+            "  </l>\n"
+            "  <l>\n"
+            "    <k1>d</k1>\n"
+            "    <k2>e</k2>\n"
+            "    <v>6</v>\n"
+            "  </l>\n"
+            "  <ll>x</ll>\n"
+            "  <ll>y</ll>\n"
+            "</cont>\n"
+            "<cont xmlns=\"urn:test\">\n"
+            "  <server>srv1</server>\n"
+            "  <server xmlns=\"urn:nacm-targets\">srv2</server>\n"
+            "</cont>\n";
+    ctx = sr_acquire_context(st->conn);
+    if (lyd_parse_data_mem(ctx, data, LYD_XML, LYD_PARSE_STRICT | LYD_PARSE_ONLY, 0, &edit)) {
+        return 1;
+    }
+    if (sr_edit_batch(st->sess, edit, "merge")) {
+        return 1;
+    }
+    lyd_free_siblings(edit);
+    sr_release_context(st->conn);
+    if (sr_apply_changes(st->sess, 0)) {
+        return 1;
+    }
+
+    /* set some state data */
+    if (sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL)) {
+        return 1;
+    }
+    if (sr_set_item_str(st->sess, "/nacm-targets:cont/kl[1]/v", "one", NULL, 0)) {
+        return 1;
+    }
+    if (sr_set_item_str(st->sess, "/nacm-targets:cont/kl[2]/v", "two", NULL, 0)) {
+        return 1;
+    }
+    if (sr_apply_changes(st->sess, 0)) {
+        return 1;
+    }
+    if (sr_session_switch_ds(st->sess, SR_DS_RUNNING)) {
+        return 1;
+    }
+
+    /* set user */
+    if (sr_nacm_set_user(st->sess, "test-user")) {
+        return 1;
+    }
+
+    return 0;
+}
+
+static int
+teardown_read_compiled_nacm(void **state)
+{
+    struct state *st = (struct state *)*state;
+
+    /* clear state data */
+    if (sr_discard_oper_changes(st->conn, st->sess, NULL, 0)) {
+        return 1;
+    }
+
+    /* clear config data */
+    if (sr_delete_item(st->sess, "/nacm-targets:cont", 0)) {
+        return 1;
+    }
+
+    return teardown_nacm(state);
+}
+
+static void
+test_read_compiled(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_t *data;
+    char *str;
+    int ret;
+
+    /* all keys, first key only, $USER key, and a leaf-list value */
+    ret = sr_get_data(st->sess, "/nacm-targets:*", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = lyd_print_mem(&str, data->tree, LYD_XML, LYD_PRINT_WITHSIBLINGS);
+    assert_int_equal(ret, LY_SUCCESS);
+    sr_release_data(data);
+    assert_string_equal(str,
+            "<cont xmlns=\"urn:nacm-targets\">\n"
+            "  <l>\n"
+            "    <k1>a</k1>\n"
+            "    <k2>b</k2>\n"
+            "    <v>1</v>\n"
+            "  </l>\n"
+            "  <l>\n"
+            "    <k1>c</k1>\n"
+            "    <k2>x</k2>\n"
+            "    <v>3</v>\n"
+            "  </l>\n"
+            "  <l>\n"
+            "    <k1>c</k1>\n"
+            "    <k2>y</k2>\n"
+            "    <v>4</v>\n"
+            "  </l>\n"
+            "  <l>\n"
+            "    <k1>test-user</k1>\n"
+            "    <k2>z</k2>\n"
+            "    <v>5</v>\n"
+            "  </l>\n"
+            "  <ll>x</ll>\n"
+            "</cont>\n");
+    free(str);
+
+    /* unprefixed node must be from the module of its parent, not an augment with the same name */
+    ret = sr_get_data(st->sess, "/test:cont", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = lyd_print_mem(&str, data->tree, LYD_XML, LYD_PRINT_WITHSIBLINGS);
+    assert_int_equal(ret, LY_SUCCESS);
+    sr_release_data(data);
+    assert_string_equal(str,
+            "<cont xmlns=\"urn:test\">\n"
+            "  <server>srv1</server>\n"
+            "</cont>\n");
+    free(str);
+
+    /* positional predicate is not compiled, the node path is compared instead */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_data(st->sess, "/nacm-targets:cont/kl", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = lyd_print_mem(&str, data->tree, LYD_XML, LYD_PRINT_WITHSIBLINGS);
+    assert_int_equal(ret, LY_SUCCESS);
+    sr_release_data(data);
+    assert_string_equal(str,
+            "<cont xmlns=\"urn:nacm-targets\">\n"
+            "  <kl>\n"
+            "    <v>two</v>\n"
+            "  </kl>\n"
+            "</cont>\n");
+    free(str);
+}
+
+/* TEST */
+static int
+setup_notif_nacm(void **state)
+{
+    struct state *st = (struct state *)*state;
+    const struct ly_ctx *ctx;
+    const char *data;
+    struct lyd_node *edit;
+
+    /* set NACM */
+    data = "<nacm xmlns=\"urn:ietf:params:xml:ns:yang:ietf-netconf-acm\">\n"
+            "  <read-default>deny</read-default>\n"
+            "  <enable-external-groups>false</enable-external-groups>\n"
+            "  <groups>\n"
+            "    <group>\n"
+            "      <name>test-group</name>\n"
+            "      <user-name>test-user</user-name>\n"
+            "      <user-name>test-user2</user-name>\n"
+            "    </group>\n"
+            "  </groups>\n"
+            "  <rule-list>\n"
+            "    <name>rule1</name>\n"
+            "    <group>test-group</group>\n"
+            "    <rule>\n"
+            "      <name>allow-notif4</name>\n"
+            "      <module-name>ops</module-name>\n"
+            "      <notification-name>notif4</notification-name>\n"
+            "      <access-operations>read</access-operations>\n"
+            "      <action>permit</action>\n"
+            "    </rule>\n"
+            "  </rule-list>\n"
+            "</nacm>\n";
+    ctx = sr_acquire_context(st->conn);
+    if (lyd_parse_data_mem(ctx, data, LYD_XML, LYD_PARSE_STRICT | LYD_PARSE_ONLY, 0, &edit)) {
+        return 1;
+    }
+    if (sr_edit_batch(st->sess, edit, "merge")) {
+        return 1;
+    }
+    lyd_free_siblings(edit);
+    sr_release_context(st->conn);
+    if (sr_apply_changes(st->sess, 0)) {
+        return 1;
+    }
+
+    return 0;
+}
+
+static void
+notif_count_cb(sr_session_ctx_t *session, uint32_t sub_id, const sr_ev_notif_type_t notif_type,
+        const struct lyd_node *notif, struct timespec *timestamp, void *private_data)
+{
+    int *count = private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)timestamp;
+
+    if (notif_type == SR_EV_NOTIF_TERMINATED) {
+        /* ignore */
+        return;
+    }
+
+    assert_int_equal(notif_type, SR_EV_NOTIF_REALTIME);
+    assert_string_equal(LYD_NAME(notif), "notif4");
+    ++(*count);
+}
+
+static void
+test_notif(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_session_ctx_t *sess[3];
+    sr_subscription_ctx_t *sub = NULL;
+    const char *users[] = {"test-user", "test-user2", "other-user"};
+    const char *module_name, *xpath;
+    struct timespec start, stop;
+    struct lyd_node *notif;
+    uint32_t i, sub_id[3], filtered_out;
+    int count[3] = {0}, ret;
+
+    /* subscribe with users in the same group and a user without any groups */
+    for (i = 0; i < 3; ++i) {
+        ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess[i]);
+        assert_int_equal(ret, SR_ERR_OK);
+        ret = sr_nacm_set_user(sess[i], users[i]);
+        assert_int_equal(ret, SR_ERR_OK);
+
+        ret = sr_notif_subscribe_tree(sess[i], "ops", "/ops:notif4", NULL, NULL, notif_count_cb, &count[i],
+                SR_SUBSCR_NO_THREAD, &sub);
+        assert_int_equal(ret, SR_ERR_OK);
+        sub_id[i] = sr_subscription_get_last_sub_id(sub);
+    }
+
+    /* send 2 notifications */
+    ret = lyd_new_path(NULL, sr_session_acquire_context(st->sess), "/ops:notif4/l", "val", 0, &notif);
+    assert_int_equal(ret, LY_SUCCESS);
+    ret = sr_notif_send_tree(st->sess, notif, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_notif_send_tree(st->sess, notif, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    lyd_free_tree(notif);
+    sr_session_release_context(st->sess);
+
+    /* process them, the users in the group receive them */
+    ret = sr_subscription_process_events(sub, NULL, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(count[0], 2);
+    assert_int_equal(count[1], 2);
+    assert_int_equal(count[2], 0);
+
+    /* the other user had them filtered out */
+    ret = sr_notif_sub_get_info(sub, sub_id[2], &module_name, &xpath, &start, &stop, &filtered_out);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(filtered_out, 2);
+    ret = sr_notif_sub_get_info(sub, sub_id[0], &module_name, &xpath, &start, &stop, &filtered_out);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(filtered_out, 0);
+
+    sr_unsubscribe(sub);
+    for (i = 0; i < 3; ++i) {
+        sr_session_stop(sess[i]);
+    }
+}
+
 int
 main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_setup_teardown(test_basic, setup_basic_nacm, teardown_nacm),
         cmocka_unit_test_setup_teardown(test_read, setup_read_nacm, teardown_nacm),
+        cmocka_unit_test_setup_teardown(test_read_shared, setup_read_nacm, teardown_nacm),
         cmocka_unit_test_setup_teardown(test_filter_denied, setup_filter_denied_nacm, teardown_nacm),
         cmocka_unit_test_setup_teardown(test_write, setup_write_nacm, teardown_nacm),
         cmocka_unit_test_setup_teardown(test_exec, setup_exec_nacm, teardown_nacm),
         cmocka_unit_test_setup_teardown(test_read_var, setup_read_var_nacm, teardown_nacm),
+        cmocka_unit_test_setup_teardown(test_read_compiled, setup_read_compiled_nacm, teardown_read_compiled_nacm),
+        cmocka_unit_test_setup_teardown(test_notif, setup_notif_nacm, teardown_nacm),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
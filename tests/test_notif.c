@@ -152,18 +152,33 @@ clear_ops(void **state)
     return 0;
 }
 
-static int
-clear_ops_notif(void **state)
+static void
+remove_ops_notif_files(void)
 {
     char *cmd, *path;
 
-    (void)state;
-
     test_path_notif_dir(&path);
     assert_return_code(asprintf(&cmd, "rm -rf %s/ops.notif*", path), 0);
     free(path);
     assert_return_code(system(cmd), errno);
     free(cmd);
+}
+
+static int
+clear_ops_notif(void **state)
+{
+    const char *prefix;
+    char *path;
+
+    (void)state;
+
+    remove_ops_notif_files();
+
+    /* the replay ring would still include the most recent notifications */
+    prefix = getenv(SR_SHM_PREFIX_ENV);
+    assert_return_code(asprintf(&path, "%s/%sreplay_ops", SR_SHM_DIR, prefix ? prefix : SR_SHM_PREFIX_DEFAULT), 0);
+    unlink(path);
+    free(path);
 
     return 0;
 }
@@ -982,6 +997,148 @@ test_no_replay(void **state)
     sr_unsubscribe(subscr);
 }
 
+/* TEST */
+static void
+notif_replay_ring_cb(sr_session_ctx_t *session, uint32_t sub_id, const sr_ev_notif_type_t notif_type,
+        const struct lyd_node *notif, struct timespec *timestamp, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    char buf[8];
+
+    (void)session;
+    (void)sub_id;
+    (void)timestamp;
+
+    if (notif_type == SR_EV_NOTIF_TERMINATED) {
+        /* ignore */
+        return;
+    }
+
+    if (ATOMIC_LOAD_RELAXED(st->cb_called) < 3) {
+        assert_int_equal(notif_type, SR_EV_NOTIF_REPLAY);
+        assert_non_null(notif);
+        sprintf(buf, "%d", (int)ATOMIC_LOAD_RELAXED(st->cb_called));
+        assert_string_equal(lyd_get_value(lyd_child(notif)), buf);
+    } else if (ATOMIC_LOAD_RELAXED(st->cb_called) == 3) {
+        assert_int_equal(notif_type, SR_EV_NOTIF_REPLAY_COMPLETE);
+        assert_null(notif);
+    } else {
+        fail();
+    }
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+}
+
+static void
+test_replay_ring(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    struct lyd_node *notif;
+    struct timespec start;
+    char buf[8];
+    int i, ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+
+    /* the replay ring is created by the first stored notification, which is not kept in it */
+    assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, st->ly_ctx, "/ops:notif4/l", "first", 0, &notif));
+    assert_int_equal(SR_ERR_OK, sr_notif_send_tree(st->sess, notif, 0, 0));
+    lyd_free_tree(notif);
+    usleep(1000);
+    clock_gettime(CLOCK_REALTIME, &start);
+
+    /* store several notifications for replay */
+    for (i = 0; i < 3; ++i) {
+        sprintf(buf, "%d", i);
+        assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, st->ly_ctx, "/ops:notif4/l", buf, 0, &notif));
+        assert_int_equal(SR_ERR_OK, sr_notif_send_tree(st->sess, notif, 0, 0));
+        lyd_free_tree(notif);
+    }
+
+    /* remove the stored notifications, the most recent ones are replayed from the replay ring */
+    remove_ops_notif_files();
+
+    ret = sr_notif_subscribe_tree(st->sess, "ops", NULL, &start, NULL, notif_replay_ring_cb, st, SR_SUBSCR_NO_THREAD,
+            &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_subscription_process_events(subscr, NULL, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 4);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST */
+static void
+notif_replay_merged_cb(sr_session_ctx_t *session, uint32_t sub_id, const sr_ev_notif_type_t notif_type,
+        const struct lyd_node *notif, struct timespec *timestamp, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    char buf[8];
+
+    (void)session;
+    (void)sub_id;
+    (void)timestamp;
+
+    if (notif_type == SR_EV_NOTIF_TERMINATED) {
+        /* ignore */
+        return;
+    }
+
+    if (ATOMIC_LOAD_RELAXED(st->cb_called) < 4) {
+        /* notifications of both subscriptions are replayed merged in order */
+        assert_int_equal(notif_type, SR_EV_NOTIF_REPLAY);
+        assert_non_null(notif);
+        sprintf(buf, "%d", (int)ATOMIC_LOAD_RELAXED(st->cb_called));
+        assert_string_equal(lyd_get_value(lyd_child(notif)), buf);
+    } else if (ATOMIC_LOAD_RELAXED(st->cb_called) < 6) {
+        assert_int_equal(notif_type, SR_EV_NOTIF_REPLAY_COMPLETE);
+        assert_null(notif);
+    } else {
+        fail();
+    }
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+}
+
+static void
+test_replay_merged(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    struct lyd_node *notif;
+    struct timespec start;
+    char buf[8];
+    int i, ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+    clock_gettime(CLOCK_REALTIME, &start);
+
+    /* store several notifications for replay */
+    for (i = 0; i < 4; ++i) {
+        sprintf(buf, "%d", i);
+        assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, st->ly_ctx, "/ops:notif4/l", buf, 0, &notif));
+        assert_int_equal(SR_ERR_OK, sr_notif_send_tree(st->sess, notif, 0, 0));
+        lyd_free_tree(notif);
+    }
+
+    /* subscribe for replay of every other notification twice */
+    ret = sr_notif_subscribe_tree(st->sess, "ops", "/ops:notif4[l='0' or l='2']", &start, NULL, notif_replay_merged_cb,
+            st, SR_SUBSCR_NO_THREAD, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_notif_subscribe_tree(st->sess, "ops", "/ops:notif4[l='1' or l='3']", &start, NULL, notif_replay_merged_cb,
+            st, SR_SUBSCR_NO_THREAD, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* both replays are performed together */
+    ret = sr_subscription_process_events(subscr, NULL, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 6);
+
+    sr_unsubscribe(subscr);
+}
+
 /* TEST */
 static void
 notif_config_change_cb(sr_session_ctx_t *session, uint32_t sub_id, const sr_ev_notif_type_t notif_type,
@@ -1555,6 +1712,247 @@ test_wait(void **state)
     sr_unsubscribe(subscr);
 }
 
+/* TEST */
+static void
+notif_ring_cb(sr_session_ctx_t *session, uint32_t sub_id, const sr_ev_notif_type_t notif_type,
+        const struct lyd_node *notif, struct timespec *timestamp, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    char buf[8];
+
+    (void)session;
+    (void)sub_id;
+    (void)timestamp;
+
+    if (notif_type == SR_EV_NOTIF_TERMINATED) {
+        /* ignore */
+        return;
+    }
+
+    /* notifications are delivered in the order they were sent */
+    assert_int_equal(notif_type, SR_EV_NOTIF_REALTIME);
+    sprintf(buf, "%d", (int)ATOMIC_LOAD_RELAXED(st->cb_called));
+    assert_string_equal(lyd_get_value(lyd_child(notif)), buf);
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+}
+
+static void
+test_ring(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    struct lyd_node *notif;
+    char buf[8];
+    int i, ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+
+    /* subscribe */
+    ret = sr_notif_subscribe_tree(st->sess, "ops", NULL, NULL, NULL, notif_ring_cb, st, SR_SUBSCR_NO_THREAD, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* send several notifications without processing them */
+    for (i = 0; i < 5; ++i) {
+        sprintf(buf, "%d", i);
+        assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, st->ly_ctx, "/ops:notif4/l", buf, 0, &notif));
+        assert_int_equal(SR_ERR_OK, sr_notif_send_tree(st->sess, notif, 0, 0));
+        lyd_free_tree(notif);
+    }
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 0);
+
+    /* process all of them at once */
+    ret = sr_subscription_process_events(subscr, NULL, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 5);
+
+    /* nothing more to process */
+    ret = sr_subscription_process_events(subscr, NULL, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 5);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST */
+static void
+test_batch(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    struct lyd_node *notifs[3];
+    char buf[8];
+    int i, ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+
+    /* subscribe */
+    ret = sr_notif_subscribe_tree(st->sess, "ops", NULL, NULL, NULL, notif_ring_cb, st, SR_SUBSCR_NO_THREAD, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* create the notifications */
+    for (i = 0; i < 3; ++i) {
+        sprintf(buf, "%d", i);
+        assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, st->ly_ctx, "/ops:notif4/l", buf, 0, &notifs[i]));
+    }
+
+    /* invalid arguments */
+    ret = sr_notif_send_batch(st->sess, notifs, 0, 0, 0);
+    assert_int_equal(ret, SR_ERR_INVAL_ARG);
+
+    /* send them all at once */
+    ret = sr_notif_send_batch(st->sess, notifs, 3, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    for (i = 0; i < 3; ++i) {
+        lyd_free_tree(notifs[i]);
+    }
+
+    /* process them */
+    ret = sr_subscription_process_events(subscr, NULL, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 3);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST */
+static void
+test_no_validate(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess;
+    sr_val_t input[2];
+    int ret;
+
+    input[0].xpath = "/ops:notif3/list2[k='k']/k";
+    input[0].type = SR_STRING_T;
+    input[0].data.string_val = "k";
+    input[0].dflt = 0;
+    input[1].xpath = "/ops:notif3/list2[k='k']/l14";
+    input[1].type = SR_STRING_T;
+    input[1].data.string_val = "l1-val";
+    input[1].dflt = 0;
+
+    /* invalid notification */
+    ret = sr_notif_send(st->sess, "/ops:notif3", input, 2, 0, 0);
+    assert_int_equal(ret, SR_ERR_VALIDATION_FAILED);
+
+    /* trusted connection does not validate it */
+    ret = sr_connect(SR_CONN_NO_OP_VALIDATE, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_notif_send(sess, "/ops:notif3", input, 2, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_disconnect(conn);
+}
+
+/* TEST */
+static void
+test_shared_thread(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr1 = NULL, *subscr2 = NULL;
+    int i, ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+
+    /* cannot be combined with no thread */
+    ret = sr_notif_subscribe(st->sess, "ops", NULL, NULL, NULL, notif_wait_cb, st,
+            SR_SUBSCR_NO_THREAD | SR_SUBSCR_SHARED_THREAD, &subscr1);
+    assert_int_equal(ret, SR_ERR_INVAL_ARG);
+
+    /* subscribe twice, both handled by the shared event loop */
+    ret = sr_set_shared_subscription_workers(st->conn, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_notif_subscribe(st->sess, "ops", NULL, NULL, NULL, notif_wait_cb, st, SR_SUBSCR_SHARED_THREAD, &subscr1);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_notif_subscribe(st->sess, "ops", NULL, NULL, NULL, notif_wait_cb, st, SR_SUBSCR_SHARED_THREAD, &subscr2);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the event loop is running now */
+    ret = sr_set_shared_subscription_workers(st->conn, 2);
+    assert_int_equal(ret, SR_ERR_OPERATION_FAILED);
+
+    /* send a notif 5x */
+    for (i = 0; i < 5; ++i) {
+        ret = sr_notif_send(st->sess, "/ops:notif4", NULL, 0, 0, 1);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 10);
+
+    /* suspend one while the other one is unsubscribed, resume it */
+    ret = sr_subscription_thread_suspend(subscr1);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_unsubscribe(subscr2);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_subscription_thread_resume(subscr1);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_notif_send(st->sess, "/ops:notif4", NULL, 0, 0, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 11);
+
+    sr_unsubscribe(subscr1);
+}
+
+/* TEST */
+struct self_unsub {
+    sr_subscription_ctx_t *subscr;
+    int ret;
+};
+
+static void
+notif_self_unsub_cb(sr_session_ctx_t *session, uint32_t sub_id, const sr_ev_notif_type_t notif_type, const char *xpath,
+        const sr_val_t *values, const size_t values_cnt, struct timespec *timestamp, void *private_data)
+{
+    struct self_unsub *su = (struct self_unsub *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)xpath;
+    (void)values;
+    (void)values_cnt;
+    (void)timestamp;
+
+    if (notif_type == SR_EV_NOTIF_TERMINATED) {
+        /* ignore */
+        return;
+    }
+
+    /* try to unsubscribe from the callback */
+    su->ret = sr_unsubscribe(su->subscr);
+}
+
+static void
+test_shared_thread_self_unsub(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct self_unsub su = {0};
+    int ret;
+
+    ret = sr_notif_subscribe(st->sess, "ops", NULL, NULL, NULL, notif_self_unsub_cb, &su, SR_SUBSCR_SHARED_THREAD,
+            &su.subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the callback cannot free the subscription it is processing */
+    ret = sr_notif_send(st->sess, "/ops:notif4", NULL, 0, 0, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(su.ret, SR_ERR_UNSUPPORTED);
+
+    /* the subscription still works */
+    su.ret = SR_ERR_OK;
+    ret = sr_notif_send(st->sess, "/ops:notif4", NULL, 0, 0, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(su.ret, SR_ERR_UNSUPPORTED);
+
+    ret = sr_unsubscribe(su.subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
 /* TEST */
 static void
 notif_schema_mount_cb(sr_session_ctx_t *session, uint32_t sub_id, const sr_ev_notif_type_t notif_type,
@@ -1724,12 +2122,19 @@ main(void)
         cmocka_unit_test_setup_teardown(test_replay_simple, clear_ops_notif, clear_ops),
         cmocka_unit_test_setup(test_replay_interval, create_ops_notif),
         cmocka_unit_test_setup_teardown(test_no_replay, clear_ops_notif, clear_ops),
+        cmocka_unit_test_setup_teardown(test_replay_ring, clear_ops_notif, clear_ops_notif),
+        cmocka_unit_test_setup_teardown(test_replay_merged, clear_ops_notif, clear_ops_notif),
         cmocka_unit_test_teardown(test_notif_config_change, clear_ops),
         cmocka_unit_test(test_notif_buffer),
         cmocka_unit_test(test_suspend),
         cmocka_unit_test(test_params),
         cmocka_unit_test(test_dup_inst),
         cmocka_unit_test(test_wait),
+        cmocka_unit_test(test_ring),
+        cmocka_unit_test(test_batch),
+        cmocka_unit_test(test_no_validate),
+        cmocka_unit_test(test_shared_thread),
+        cmocka_unit_test(test_shared_thread_self_unsub),
         cmocka_unit_test(test_schema_mount),
     };
 
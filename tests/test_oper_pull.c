@@ -292,6 +292,64 @@ test_yang_lib(void **state)
     sr_unsubscribe(subscr);
 }
 
+/* TEST */
+static void
+test_yang_lib_cache(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_t *data;
+    sr_val_t *val;
+    char *content_id;
+    int ret;
+
+#if SR_YANGLIB_REVISION == 2019 - 01 - 04
+    const char *cid_xpath = "/ietf-yang-library:yang-library/content-id";
+    const char *mod_xpath = "/ietf-yang-library:yang-library/module-set/module[name='simple']";
+#else
+    const char *cid_xpath = "/ietf-yang-library:modules-state/module-set-id";
+    const char *mod_xpath = "/ietf-yang-library:modules-state/module[name='simple'][revision='']";
+#endif
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* generate and cache the data */
+    ret = sr_get_item(st->sess, cid_xpath, 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    content_id = strdup(val->data.string_val);
+    sr_free_val(val);
+
+    /* read the cached data */
+    ret = sr_get_item(st->sess, cid_xpath, 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(val->data.string_val, content_id);
+    sr_free_val(val);
+
+    ret = sr_get_data(st->sess, mod_xpath, 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_null(data);
+
+    /* context change, the data must be generated again */
+    ret = sr_install_module(st->conn, TESTS_SRC_DIR "/files/simple.yang", NULL, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_item(st->sess, cid_xpath, 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_not_equal(val->data.string_val, content_id);
+    sr_free_val(val);
+
+    ret = sr_get_data(st->sess, mod_xpath, 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data);
+    sr_release_data(data);
+
+    /* cleanup */
+    free(content_id);
+    ret = sr_remove_module(st->conn, "simple", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+}
+
 /* TEST */
 static int
 dummy_oper_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
@@ -957,6 +1015,158 @@ test_sr_mon(void **state)
     free(str2);
 }
 
+/* TEST */
+static void
+test_sr_mon_commit_stats(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_data_t *data;
+    struct lyd_node *node;
+    struct ly_set *set;
+    int ret;
+
+    ret = sr_module_change_subscribe(st->sess, "ietf-interfaces", NULL, dummy_change_cb, NULL, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* apply some changes */
+    ret = sr_set_item_str(st->sess, "/ietf-interfaces:interfaces/interface[name='eth1']/type", "iana-if-type:ethernetCsmacd",
+            NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_unsubscribe(subscr);
+
+    /* read the statistics */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_data(st->sess, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/commit-phase", 0, 0,
+            0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+
+    /* all the phases were measured */
+    ret = lyd_find_xpath(data->tree, "/sysrepo-monitoring:sysrepo-state/module/commit-phase", &set);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_int_equal(set->count, 6);
+    ly_set_free(set, NULL);
+
+    /* store phase performed once with a full histogram */
+    ret = lyd_find_path(data->tree, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/"
+            "commit-phase[name='store']/count", 0, &node);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_string_equal(lyd_get_value(node), "1");
+    ret = lyd_find_xpath(data->tree, "/sysrepo-monitoring:sysrepo-state/module/commit-phase[name='store']/bucket", &set);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_int_equal(set->count, 7);
+    assert_string_equal(lyd_get_value(lyd_child(set->dnodes[6])), "infinity");
+    ly_set_free(set, NULL);
+    ret = lyd_find_xpath(data->tree, "/sysrepo-monitoring:sysrepo-state/module/commit-phase[name='store']/"
+            "bucket[count='1']", &set);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_int_equal(set->count, 1);
+    ly_set_free(set, NULL);
+
+    sr_release_data(data);
+}
+
+static void
+test_sr_mon_sub_stats(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_data_t *data;
+    struct lyd_node *node;
+    int ret;
+
+    ret = sr_module_change_subscribe(st->sess, "ietf-interfaces", NULL, dummy_change_cb, NULL, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* no events processed yet, no statistics */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_data(st->sess, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/subscriptions", 0, 0,
+            0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = lyd_find_path(data->tree, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/subscriptions/"
+            "change-sub/callback-time", 0, &node);
+    assert_int_equal(ret, LY_ENOTFOUND);
+    sr_release_data(data);
+
+    /* apply some changes */
+    sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+    ret = sr_set_item_str(st->sess, "/ietf-interfaces:interfaces/interface[name='eth1']/type", "iana-if-type:ethernetCsmacd",
+            NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read the statistics */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_data(st->sess, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/subscriptions", 0, 0,
+            0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+
+    /* the change event was processed and measured */
+    ret = lyd_find_path(data->tree, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/subscriptions/"
+            "change-sub/callback-time/count", 0, &node);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_true(atoi(lyd_get_value(node)) >= 1);
+    ret = lyd_find_path(data->tree, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/subscriptions/"
+            "change-sub/queue-time/count", 0, &node);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_true(atoi(lyd_get_value(node)) >= 1);
+
+    sr_release_data(data);
+    sr_unsubscribe(subscr);
+}
+
+static void
+test_sr_mon_scoped(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_data_t *data;
+    struct lyd_node *node;
+    struct ly_set *set;
+    int ret;
+
+    ret = sr_module_change_subscribe(st->sess, "ietf-interfaces", NULL, dummy_change_cb, NULL, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* only the subscriptions of a module are generated */
+    ret = sr_get_data(st->sess, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/subscriptions", 0, 0,
+            0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = lyd_find_path(data->tree, "/sysrepo-monitoring:sysrepo-state/module[name='ietf-interfaces']/subscriptions/"
+            "change-sub", 0, &node);
+    assert_int_equal(ret, LY_SUCCESS);
+    ret = lyd_find_xpath(data->tree, "/sysrepo-monitoring:sysrepo-state/module/datastore", &set);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_int_equal(set->count, 0);
+    ly_set_free(set, NULL);
+    sr_release_data(data);
+
+    /* subtrees referenced only in a predicate are generated, too */
+    ret = sr_get_data(st->sess, "/sysrepo-monitoring:sysrepo-state/module[subscriptions/change-sub]/name", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+    ret = lyd_find_xpath(data->tree, "/sysrepo-monitoring:sysrepo-state/module", &set);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_int_equal(set->count, 1);
+    assert_string_equal(lyd_get_value(lyd_child(set->dnodes[0])), "ietf-interfaces");
+    ly_set_free(set, NULL);
+    sr_release_data(data);
+
+    sr_unsubscribe(subscr);
+}
+
 /* TEST */
 static int
 enabled_change_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath, sr_event_t event,
@@ -3190,6 +3400,298 @@ test_same_xpath_fail(void **state)
     sr_unsubscribe(subscr5);
 }
 
+/* TEST */
+static int
+diff_xpath_parallel_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    const struct ly_ctx *ly_ctx;
+
+    (void)sub_id;
+    (void)module_name;
+    (void)request_xpath;
+    (void)request_id;
+
+    /* wait for the other subscriber so that we assure getting data is parallel */
+    pthread_barrier_wait(&st->barrier2);
+
+    ly_ctx = sr_acquire_context(sr_session_get_connection(session));
+
+    if (!strcmp(xpath, "/ietf-interfaces:interfaces")) {
+        assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, ly_ctx,
+                "/ietf-interfaces:interfaces/interface[name='eth1']/type", "iana-if-type:ethernetCsmacd", 0, parent));
+    } else {
+        assert_string_equal(xpath, "/ietf-interfaces:interfaces-state");
+        assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, ly_ctx,
+                "/ietf-interfaces:interfaces-state/interface[name='eth2']/type", "iana-if-type:ethernetCsmacd", 0, parent));
+        assert_int_equal(LY_SUCCESS, lyd_new_path(*parent, NULL,
+                "/ietf-interfaces:interfaces-state/interface[name='eth2']/oper-status", "up", 0, NULL));
+    }
+
+    sr_release_context(sr_session_get_connection(session));
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static void
+test_diff_xpath_parallel(void **state)
+{
+    struct state *st = (struct state *)*state;
+    int ret;
+    sr_data_t *data;
+    struct lyd_node *node;
+    sr_subscription_ctx_t *subscr1 = NULL, *subscr2 = NULL;
+
+    /* subscribe as config data provider */
+    ret = sr_oper_get_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces", diff_xpath_parallel_cb,
+            st, 0, &subscr1);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* subscribe as state data provider */
+    ret = sr_oper_get_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state",
+            diff_xpath_parallel_cb, st, 0, &subscr2);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* try to read them back from operational DS */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read all data from operational, both callbacks must be called at once */
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+    ret = sr_get_data(st->sess, "/ietf-interfaces:*", 0, 0, SR_OPER_SUBS_PARALLEL, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+
+    /* data of both the subscribers are merged */
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data->tree, "/ietf-interfaces:interfaces/interface[name='eth1']", 0,
+            &node));
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data->tree, "/ietf-interfaces:interfaces-state/interface[name='eth2']/"
+            "oper-status", 0, &node));
+    assert_string_equal(lyd_get_value(node), "up");
+
+    sr_release_data(data);
+
+    sr_unsubscribe(subscr1);
+    sr_unsubscribe(subscr2);
+}
+
+/* TEST */
+static int
+instance_parallel_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)module_name;
+    (void)request_xpath;
+    (void)request_id;
+
+    /* wait for the other subscriber so that we assure getting data is parallel */
+    pthread_barrier_wait(&st->barrier2);
+
+    assert_non_null(*parent);
+    if (!strcmp(xpath, "/ietf-interfaces:interfaces/interface[name='eth1']/description")) {
+        assert_int_equal(LY_SUCCESS, lyd_new_path(*parent, NULL, "description", "port 1", 0, NULL));
+    } else {
+        assert_string_equal(xpath, "/ietf-interfaces:interfaces/interface[name='eth2']/description");
+        assert_int_equal(LY_SUCCESS, lyd_new_path(*parent, NULL, "description", "port 2", 0, NULL));
+    }
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static void
+test_instance_parallel(void **state)
+{
+    struct state *st = (struct state *)*state;
+    int ret;
+    sr_data_t *data;
+    struct lyd_node *node;
+    sr_subscription_ctx_t *subscr1 = NULL, *subscr2 = NULL, *subscr3 = NULL;
+
+    /* set some configuration data */
+    ret = sr_set_item_str(st->sess, "/ietf-interfaces:interfaces/interface[name='eth1']/type",
+            "iana-if-type:ethernetCsmacd", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/ietf-interfaces:interfaces/interface[name='eth2']/type",
+            "iana-if-type:ethernetCsmacd", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* subscribe to all configuration data just to enable them */
+    ret = sr_module_change_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces", dummy_change_cb, NULL,
+            0, 0, &subscr1);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* subscribe as providers of nested data of single list instances, in separate threads */
+    ret = sr_oper_get_subscribe(st->sess, "ietf-interfaces",
+            "/ietf-interfaces:interfaces/interface[name='eth1']/description", instance_parallel_cb, st, 0, &subscr2);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_oper_get_subscribe(st->sess, "ietf-interfaces",
+            "/ietf-interfaces:interfaces/interface[name='eth2']/description", instance_parallel_cb, st, 0, &subscr3);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read all data from operational, both callbacks must be called at once */
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+    ret = sr_get_data(st->sess, "/ietf-interfaces:*", 0, 0, SR_OPER_SUBS_PARALLEL, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+
+    /* data of both the subscribers are merged */
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data->tree, "/ietf-interfaces:interfaces/interface[name='eth1']/"
+            "description", 0, &node));
+    assert_string_equal(lyd_get_value(node), "port 1");
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data->tree, "/ietf-interfaces:interfaces/interface[name='eth2']/"
+            "description", 0, &node));
+    assert_string_equal(lyd_get_value(node), "port 2");
+    sr_release_data(data);
+
+    sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+    sr_unsubscribe(subscr1);
+    sr_unsubscribe(subscr2);
+    sr_unsubscribe(subscr3);
+}
+
+/* TEST */
+static uint32_t hints_max_depth, hints_limit;
+static sr_get_oper_flag_t hints_opts;
+
+static int
+hints_oper_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
+        const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = private_data;
+    const struct ly_ctx *ly_ctx;
+    char path[128];
+    int ret, i, count;
+
+    (void)sub_id;
+    (void)module_name;
+    (void)xpath;
+    (void)request_xpath;
+    (void)request_id;
+
+    /* remember the hints */
+    ret = sr_session_get_oper_hints(session, &hints_max_depth, &hints_limit, &hints_opts);
+    if (ret) {
+        return ret;
+    }
+
+    /* generate only as many interfaces as needed */
+    count = (hints_limit && (hints_limit < 5)) ? (int)hints_limit : 5;
+
+    ly_ctx = sr_acquire_context(sr_session_get_connection(session));
+    for (i = 0; i < count; ++i) {
+        sprintf(path, "/ietf-interfaces:interfaces-state/interface[name='eth%d']/type", i);
+        lyd_new_path(*parent, ly_ctx, path, "iana-if-type:ethernetCsmacd", 0, *parent ? NULL : parent);
+        sprintf(path, "/ietf-interfaces:interfaces-state/interface[name='eth%d']/oper-status", i);
+        lyd_new_path(*parent, NULL, path, "up", 0, NULL);
+    }
+    sr_release_context(sr_session_get_connection(session));
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static void
+test_hints(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_data_iter_t *iter;
+    sr_data_t *data;
+    struct lyd_node *node;
+    int ret, count;
+
+    ret = sr_oper_get_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state", hints_oper_cb,
+            st, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* depth and options */
+    ret = sr_get_data(st->sess, "/ietf-interfaces:interfaces-state/interface", 1, 0, SR_OPER_NO_STORED, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(hints_max_depth, 1);
+    assert_int_equal(hints_limit, 0);
+    assert_true(hints_opts & SR_OPER_NO_STORED);
+    count = 0;
+    LY_LIST_FOR(lyd_child(data->tree), node) {
+        ++count;
+    }
+    assert_int_equal(count, 5);
+    sr_release_data(data);
+
+    /* no limit for the chunks, all the data are retrieved only once */
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+    ret = sr_get_data_iter(st->sess, "/ietf-interfaces:interfaces-state/interface", 2, 0, 0, 0, &iter);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 1);
+    assert_int_equal(hints_max_depth, 0);
+    assert_int_equal(hints_limit, 0);
+
+    ret = sr_get_data_next(iter, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data->tree, "/ietf-interfaces:interfaces-state/interface[name='eth1']",
+            0, &node));
+    sr_release_data(data);
+
+    ret = sr_get_data_next(iter, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data->tree, "/ietf-interfaces:interfaces-state/interface[name='eth3']",
+            0, &node));
+    assert_int_equal(LY_ENOTFOUND, lyd_find_path(data->tree, "/ietf-interfaces:interfaces-state/interface[name='eth1']",
+            0, &node));
+    sr_release_data(data);
+
+    ret = sr_get_data_next(iter, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data->tree, "/ietf-interfaces:interfaces-state/interface[name='eth4']",
+            0, &node));
+    sr_release_data(data);
+
+    ret = sr_get_data_next(iter, &data);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 1);
+    sr_free_data_iter(iter);
+
+    /* no limit with a predicate, the provider would skip the data the predicate selects */
+    ret = sr_get_data_iter(st->sess, "/ietf-interfaces:interfaces-state/interface[name!='eth0']", 2, 0, 0, 0, &iter);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(hints_max_depth, 0);
+    assert_int_equal(hints_limit, 0);
+
+    ret = sr_get_data_next(iter, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data->tree, "/ietf-interfaces:interfaces-state/interface[name='eth1']",
+            0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data->tree, "/ietf-interfaces:interfaces-state/interface[name='eth2']",
+            0, &node));
+    sr_release_data(data);
+
+    ret = sr_get_data_next(iter, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data->tree, "/ietf-interfaces:interfaces-state/interface[name='eth4']",
+            0, &node));
+    sr_release_data(data);
+
+    ret = sr_get_data_next(iter, &data);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+    sr_free_data_iter(iter);
+
+    sr_unsubscribe(subscr);
+}
+
 /* TEST */
 static int
 cache_oper_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
@@ -3412,6 +3914,69 @@ test_cache_no_sub(void **state)
     assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 1);
 }
 
+/* TEST */
+static void
+test_cache_shared(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_t *data;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *subscr1 = NULL, *subscr2 = NULL, *subscr3 = NULL;
+    struct lyd_node *node;
+    int ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+
+    /* subscribe as state data provider */
+    ret = sr_oper_get_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state", cache_oper_cb,
+            st, 0, &subscr1);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* subscribe for shared oper poll */
+    ret = sr_oper_poll_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state", 3000,
+            SR_SUBSCR_OPER_POLL_SHARED, &subscr2);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 1);
+
+    /* read the data using another connection without any oper poll subscription */
+    ret = sr_connect(0, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_data(sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(lyd_find_path(data->tree, "interface[name='eth5']/oper-status", 0, &node), LY_SUCCESS);
+    assert_string_equal(lyd_get_value(node), "testing");
+    sr_release_data(data);
+
+    /* another shared oper poll subscription uses the data as well */
+    ret = sr_oper_poll_subscribe(sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state", 3000,
+            SR_SUBSCR_OPER_POLL_SHARED, &subscr3);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the data were retrieved only once */
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 1);
+
+    sr_unsubscribe(subscr3);
+    sr_disconnect(conn);
+
+    /* no shared data after unsubscribing */
+    sr_unsubscribe(subscr2);
+    ret = sr_connect(0, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_data(sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_release_data(data);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+
+    sr_disconnect(conn);
+    sr_unsubscribe(subscr1);
+}
+
 /* TEST */
 static int
 cache_diff_oper_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath,
@@ -3691,7 +4256,11 @@ main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_yang_lib),
+        cmocka_unit_test(test_yang_lib_cache),
         cmocka_unit_test(test_sr_mon),
+        cmocka_unit_test_teardown(test_sr_mon_commit_stats, clear_up),
+        cmocka_unit_test_teardown(test_sr_mon_sub_stats, clear_up),
+        cmocka_unit_test(test_sr_mon_scoped),
         cmocka_unit_test_teardown(test_enabled_partial, clear_up),
         cmocka_unit_test_teardown(test_simple, clear_up),
         cmocka_unit_test_teardown(test_fail, clear_up),
@@ -3713,8 +4282,12 @@ main(void)
         cmocka_unit_test_teardown(test_same_xpath, clear_up),
         cmocka_unit_test_teardown(test_same_xpath_parallel, clear_up),
         cmocka_unit_test_teardown(test_same_xpath_fail, clear_up),
+        cmocka_unit_test_teardown(test_diff_xpath_parallel, clear_up),
+        cmocka_unit_test_teardown(test_instance_parallel, clear_up),
+        cmocka_unit_test_teardown(test_hints, clear_up),
         cmocka_unit_test_teardown(test_cache, clear_up),
         cmocka_unit_test_teardown(test_cache_no_sub, clear_up),
+        cmocka_unit_test_teardown(test_cache_shared, clear_up),
         cmocka_unit_test_teardown(test_cache_diff, clear_up),
     };
 
@@ -2293,6 +2293,256 @@ test_change_cb(void **state)
     sr_unsubscribe(subscr);
 }
 
+/* TEST */
+static void
+test_cache(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_t *data;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess, *sess2;
+    struct lyd_node *node;
+    int ret;
+
+    /* create another connection caching the stored operational data */
+    ret = sr_connect(SR_CONN_CACHE_OPER_PUSH, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* set some operational data using a third connection */
+    ret = sr_session_start(st->conn, SR_DS_OPERATIONAL, &sess2);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess2, "/ietf-interfaces:interfaces-state/interface[name='eth1']/type",
+            "iana-if-type:ethernetCsmacd", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess2, "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed", "1024", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess2, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read the data twice, the second time from the cache */
+    ret = sr_get_node(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "1024");
+    sr_release_data(data);
+    ret = sr_get_node(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "1024");
+    sr_release_data(data);
+
+    /* change the data, the cache must be refreshed */
+    ret = sr_set_item_str(sess2, "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed", "2048", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess2, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_node(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "2048");
+    sr_release_data(data);
+
+    /* discard the data */
+    ret = sr_discard_oper_changes(st->conn, sess2, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_data(sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_true(data->tree->flags & LYD_DEFAULT);
+    assert_int_equal(lyd_find_path(data->tree, "interface[name='eth1']", 0, &node), LY_ENOTFOUND);
+    sr_release_data(data);
+
+    sr_session_stop(sess2);
+    sr_disconnect(conn);
+}
+
+/* TEST */
+static void
+test_view(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_t *data;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess, *sess2;
+    sr_subscription_ctx_t *subscr = NULL;
+    int ret;
+
+    /* create another connection caching the operational views */
+    ret = sr_connect(SR_CONN_CACHE_OPER_VIEW, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* enable running data and set some */
+    ret = sr_module_change_subscribe(st->sess, "ietf-interfaces", NULL, dummy_change_cb, NULL, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/ietf-interfaces:interfaces/interface[name='eth1']/type",
+            "iana-if-type:ethernetCsmacd", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/ietf-interfaces:interfaces/interface[name='eth1']/description", "descr1", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* store some operational data */
+    ret = sr_session_start(st->conn, SR_DS_OPERATIONAL, &sess2);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess2, "/ietf-interfaces:interfaces-state/interface[name='eth1']/type",
+            "iana-if-type:ethernetCsmacd", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess2, "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed", "1024", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess2, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read the data twice, the second time from the view */
+    ret = sr_get_node(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "1024");
+    sr_release_data(data);
+    ret = sr_get_node(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "1024");
+    sr_release_data(data);
+
+    /* change the stored data, the view must be refreshed */
+    ret = sr_set_item_str(sess2, "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed", "2048", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess2, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_node(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "2048");
+    sr_release_data(data);
+
+    /* change the running data, the view must be refreshed */
+    ret = sr_get_node(sess, "/ietf-interfaces:interfaces/interface[name='eth1']/description", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "descr1");
+    sr_release_data(data);
+
+    ret = sr_set_item_str(st->sess, "/ietf-interfaces:interfaces/interface[name='eth1']/description", "descr2", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_node(sess, "/ietf-interfaces:interfaces/interface[name='eth1']/description", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "descr2");
+    sr_release_data(data);
+
+    /* disable the running data, the view must be refreshed */
+    sr_unsubscribe(subscr);
+
+    ret = sr_get_node(sess, "/ietf-interfaces:interfaces/interface[name='eth1']/description", 0, &data);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+    ret = sr_get_node(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "2048");
+    sr_release_data(data);
+
+    sr_session_stop(sess2);
+    sr_disconnect(conn);
+}
+
+static int
+delta_change_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *module_name, const char *xpath, sr_event_t event,
+        uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)module_name;
+    (void)xpath;
+    (void)event;
+    (void)request_id;
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+    return SR_ERR_OK;
+}
+
+static void
+test_delta(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_data_t *data;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess, *sess2;
+    sr_subscription_ctx_t *subscr = NULL;
+    const char *paths[2], *values[2];
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* store some operational data */
+    ret = sr_set_item_str(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/type",
+            "iana-if-type:ethernetCsmacd", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed", "1024", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/oper-status", "down", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* subscribe to operational data changes */
+    ret = sr_module_change_subscribe(sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state", delta_change_cb,
+            st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* update both the values, subscribers are notified once */
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+    paths[0] = "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed";
+    values[0] = "2048";
+    paths[1] = "/ietf-interfaces:interfaces-state/interface[name='eth1']/oper-status";
+    values[1] = "up";
+    ret = sr_oper_push_delta(sess, paths, values, 2, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+
+    ret = sr_get_node(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "2048");
+    sr_release_data(data);
+    ret = sr_get_node(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/oper-status", 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(lyd_get_value(data->tree), "up");
+    sr_release_data(data);
+
+    /* same values, no changes */
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+    ret = sr_oper_push_delta(sess, paths, values, 2, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 0);
+
+    /* leaf not stored */
+    paths[0] = "/ietf-interfaces:interfaces-state/interface[name='eth1']/phys-address";
+    values[0] = "01:23:45:67:89:ab";
+    ret = sr_oper_push_delta(sess, paths, values, 1, 0);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+
+    /* leaf stored by another connection */
+    paths[0] = "/ietf-interfaces:interfaces-state/interface[name='eth1']/speed";
+    values[0] = "4096";
+    ret = sr_connect(0, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_OPERATIONAL, &sess2);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_oper_push_delta(sess2, paths, values, 1, 0);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+    sr_disconnect(conn);
+
+    /* not operational datastore */
+    ret = sr_oper_push_delta(st->sess, paths, values, 1, 0);
+    assert_int_equal(ret, SR_ERR_INVAL_ARG);
+
+    sr_unsubscribe(subscr);
+    sr_session_stop(sess);
+}
+
 int
 main(void)
 {
@@ -2313,6 +2563,9 @@ main(void)
         cmocka_unit_test_teardown(test_diff_merge_userord, clear_up),
         cmocka_unit_test_teardown(test_schema_mount, clear_up),
         cmocka_unit_test_teardown(test_change_cb, clear_up),
+        cmocka_unit_test_teardown(test_cache, clear_up),
+        cmocka_unit_test_teardown(test_view, clear_up),
+        cmocka_unit_test_teardown(test_delta, clear_up),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
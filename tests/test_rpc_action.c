@@ -1309,6 +1309,281 @@ test_rpc_shelve(void **state)
     pthread_join(tid[1], NULL);
 }
 
+/* TEST */
+static int
+rpc_workers_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *xpath, const sr_val_t *input, const size_t input_cnt,
+        sr_event_t event, uint32_t request_id, sr_val_t **output, size_t *output_cnt, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    int count;
+
+    (void)session;
+    (void)sub_id;
+    (void)input;
+    (void)input_cnt;
+    (void)event;
+    (void)request_id;
+    (void)output;
+    (void)output_cnt;
+
+    if (!strcmp(xpath, "/ops:rpc1")) {
+        ATOMIC_INC_RELAXED(st->cb_called);
+
+        /* block until the other RPC is handled in parallel */
+        count = 0;
+        while ((ATOMIC_LOAD_RELAXED(st->cb_called) < 2) && (count < 1500)) {
+            usleep(10000);
+            ++count;
+        }
+        if (ATOMIC_LOAD_RELAXED(st->cb_called) < 2) {
+            return SR_ERR_OPERATION_FAILED;
+        }
+    } else {
+        assert_string_equal(xpath, "/ops:rpc2");
+        ATOMIC_INC_RELAXED(st->cb_called);
+    }
+
+    return SR_ERR_OK;
+}
+
+static void *
+send_rpc1_workers_thread(void *arg)
+{
+    struct state *st = (struct state *)arg;
+    sr_session_ctx_t *sess;
+    sr_val_t *output;
+    size_t output_count;
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_rpc_send(sess, "/ops:rpc1", NULL, 0, 0, &output, &output_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_free_values(output, output_count);
+
+    sr_session_stop(sess);
+    return NULL;
+}
+
+static void
+test_workers(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_val_t *output;
+    size_t output_count;
+    pthread_t tid;
+    int count, ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+
+    /* subscribe to both RPCs and process them in parallel */
+    ret = sr_rpc_subscribe(st->sess, "/ops:rpc1", rpc_workers_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_rpc_subscribe(st->sess, "/ops:rpc2", rpc_workers_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_subscription_set_workers(subscr, 2);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* send the first RPC, wait until its callback is called */
+    pthread_create(&tid, NULL, send_rpc1_workers_thread, st);
+    count = 0;
+    while ((ATOMIC_LOAD_RELAXED(st->cb_called) < 1) && (count < 1500)) {
+        usleep(10000);
+        ++count;
+    }
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 1);
+
+    /* send the second RPC while the first one is still being handled */
+    ret = sr_rpc_send(st->sess, "/ops:rpc2", NULL, 0, 0, &output, &output_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_free_values(output, output_count);
+
+    pthread_join(tid, NULL);
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 2);
+
+    /* back to sequential processing */
+    ret = sr_subscription_set_workers(subscr, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST */
+static int
+rpc_thread_attr_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *xpath, const sr_val_t *input,
+        const size_t input_cnt, sr_event_t event, uint32_t request_id, sr_val_t **output, size_t *output_cnt,
+        void *private_data)
+{
+    char *name = private_data;
+
+    (void)session;
+    (void)sub_id;
+    (void)xpath;
+    (void)input;
+    (void)input_cnt;
+    (void)event;
+    (void)request_id;
+    (void)output;
+    (void)output_cnt;
+
+    /* learn the name of the handler thread */
+#ifdef SR_HAVE_PTHREAD_SETNAME_NP
+    pthread_getname_np(pthread_self(), name, 16);
+#else
+    strcpy(name, "none");
+#endif
+
+    return SR_ERR_OK;
+}
+
+static void
+test_thread_attr(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    sr_thread_attr_t attr = {0};
+    sr_val_t *output;
+    size_t output_count;
+    int cpu = 0, ret;
+    char name[16];
+
+    /* invalid type */
+    ret = sr_conn_set_thread_attr(st->conn, SR_THREAD_NOTIF_BUF + 1, &attr);
+    assert_int_equal(ret, SR_ERR_INVAL_ARG);
+
+    /* attributes of the next subscription threads */
+#ifdef SR_HAVE_PTHREAD_SETAFFINITY_NP
+    attr.cpus = &cpu;
+    attr.cpu_count = 1;
+#else
+    (void)cpu;
+#endif
+    attr.sched_policy = -1;
+    attr.stack_size = 256 * 1024;
+    attr.name = "sr-rpc-handler-thread";
+    ret = sr_conn_set_thread_attr(st->conn, SR_THREAD_SUBSCR, &attr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_rpc_subscribe(st->sess, "/ops:rpc1", rpc_thread_attr_cb, name, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* defaults for any other threads */
+    ret = sr_conn_set_thread_attr(st->conn, SR_THREAD_SUBSCR, NULL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_rpc_send(st->sess, "/ops:rpc1", NULL, 0, 0, &output, &output_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_free_values(output, output_count);
+#ifdef SR_HAVE_PTHREAD_SETNAME_NP
+    assert_string_equal(name, "sr-rpc-handler-");
+#endif
+
+    /* rename the running thread */
+    memset(&attr, 0, sizeof attr);
+    attr.sched_policy = -1;
+    attr.name = "sr-rpc";
+    ret = sr_subscription_set_thread_attr(subscr, &attr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_rpc_send(st->sess, "/ops:rpc1", NULL, 0, 0, &output, &output_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_free_values(output, output_count);
+#ifdef SR_HAVE_PTHREAD_SETNAME_NP
+    assert_string_equal(name, "sr-rpc");
+#endif
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST */
+static int
+rpc_async_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *xpath, const sr_val_t *input, const size_t input_cnt,
+        sr_event_t event, uint32_t request_id, sr_val_t **output, size_t *output_cnt, void *private_data)
+{
+    (void)session;
+    (void)sub_id;
+    (void)input;
+    (void)input_cnt;
+    (void)event;
+    (void)request_id;
+    (void)output;
+    (void)output_cnt;
+    (void)private_data;
+
+    if (!strcmp(xpath, "/ops:rpc2")) {
+        return SR_ERR_UNAUTHORIZED;
+    }
+    return SR_ERR_OK;
+}
+
+static void
+rpc_async_result_cb(sr_session_ctx_t *session, uint32_t request_id, const sr_error_info_t *err_info, sr_data_t *output,
+        void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    assert_ptr_equal(session, st->sess);
+    assert_int_not_equal(request_id, 0);
+
+    if (output) {
+        /* rpc1 */
+        assert_null(err_info);
+        assert_string_equal(LYD_NAME(output->tree), "rpc1");
+        sr_release_data(output);
+    } else {
+        /* rpc2 */
+        assert_non_null(err_info);
+        assert_int_equal(err_info->err[0].err_code, SR_ERR_UNAUTHORIZED);
+    }
+
+    ATOMIC_INC_RELAXED(st->cb_called);
+}
+
+static void
+test_rpc_async(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    struct lyd_node *input;
+    uint32_t request_id[3];
+    int count, ret;
+
+    ATOMIC_STORE_RELAXED(st->cb_called, 0);
+
+    ret = sr_rpc_subscribe(st->sess, "/ops:rpc1", rpc_async_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_rpc_subscribe(st->sess, "/ops:rpc2", rpc_async_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* send several RPCs without waiting */
+    assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, st->ly_ctx, "/ops:rpc1", NULL, 0, &input));
+    ret = sr_rpc_send_tree_async(st->sess, input, 0, rpc_async_result_cb, st, &request_id[0]);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_rpc_send_tree_async(st->sess, input, 0, rpc_async_result_cb, st, &request_id[1]);
+    assert_int_equal(ret, SR_ERR_OK);
+    lyd_free_all(input);
+
+    assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, st->ly_ctx, "/ops:rpc2", NULL, 0, &input));
+    ret = sr_rpc_send_tree_async(st->sess, input, 0, rpc_async_result_cb, st, &request_id[2]);
+    assert_int_equal(ret, SR_ERR_OK);
+    lyd_free_all(input);
+
+    assert_int_not_equal(request_id[0], request_id[1]);
+    assert_int_not_equal(request_id[1], request_id[2]);
+
+    /* wait for all the results */
+    count = 0;
+    while ((ATOMIC_LOAD_RELAXED(st->cb_called) < 3) && (count < 1500)) {
+        usleep(10000);
+        ++count;
+    }
+    assert_int_equal(ATOMIC_LOAD_RELAXED(st->cb_called), 3);
+
+    sr_unsubscribe(subscr);
+}
+
 /* TEST */
 static int
 rpc_dummy_cb(sr_session_ctx_t *session, uint32_t sub_id, const char *xpath, const sr_val_t *input, const size_t input_cnt,
@@ -1868,6 +2143,9 @@ main(void)
         cmocka_unit_test(test_action_deps),
         cmocka_unit_test_teardown(test_action_change_config, clear_ops),
         cmocka_unit_test(test_rpc_shelve),
+        cmocka_unit_test(test_workers),
+        cmocka_unit_test(test_thread_attr),
+        cmocka_unit_test(test_rpc_async),
         cmocka_unit_test(test_input_parameters),
         cmocka_unit_test_teardown(test_rpc_action_with_no_thread, clear_ops),
         cmocka_unit_test(test_rpc_oper),